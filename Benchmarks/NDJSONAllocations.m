@@ -0,0 +1,319 @@
+/*
+	NDJSONAllocations.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+//	Allocation regression check, counts the heap allocations made while parsing each corpus in each mode and prints
+//	them per MB of input as one JSON object per line, exits with 1 if any measurement is over its budget.
+//
+//	usage:	ndjson-allocations [-b budgets.plist] [-w budgets.plist [-g margin]] [-m mode,...] [-t input,...] corpus ...
+//
+//	the budgets property list maps a mode name to a dictionary of corpus file names, or * for any corpus, each with
+//	the maximum allocationsPerMB and bytesPerMB. -w writes the budgets for the corpora measured, the most measured
+//	over the inputs plus margin percent, 10 by default.
+//
+//	malloc, calloc, realloc and free are interposed so every allocation is counted, objects, CoreFoundation buffers
+//	and the parsers own buffers alike, this needs glibc.
+//
+
+#import <Foundation/Foundation.h>
+#import "NDJSONBenchmarkSupport.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__GLIBC__)
+
+#pragma mark - interposed allocator
+
+extern void * __libc_malloc( size_t aSize );
+extern void * __libc_calloc( size_t aCount, size_t aSize );
+extern void * __libc_realloc( void * aPointer, size_t aSize );
+extern void __libc_free( void * aPointer );
+
+static volatile int					kCounting = 0;
+static unsigned long long			kAllocationCount = 0,
+									kAllocationBytes = 0;
+
+static inline void NDJSONAllocationsCount( size_t aSize )
+{
+	if( kCounting )
+	{
+		__atomic_fetch_add( &kAllocationCount, 1, __ATOMIC_RELAXED );
+		__atomic_fetch_add( &kAllocationBytes, aSize, __ATOMIC_RELAXED );
+	}
+}
+
+void * malloc( size_t aSize )
+{
+	NDJSONAllocationsCount( aSize );
+	return __libc_malloc( aSize );
+}
+
+void * calloc( size_t aCount, size_t aSize )
+{
+	NDJSONAllocationsCount( aCount*aSize );
+	return __libc_calloc( aCount, aSize );
+}
+
+/*
+	a realloc counts as an allocation of the new size, growing a buffer is what the budgets are meant to catch
+ */
+void * realloc( void * aPointer, size_t aSize )
+{
+	NDJSONAllocationsCount( aSize );
+	return __libc_realloc( aPointer, aSize );
+}
+
+void free( void * aPointer )
+{
+	__libc_free( aPointer );
+}
+
+#pragma mark - budgets
+
+static NSDictionary * NDJSONAllocationsBudget( NSDictionary * aBudgets, enum NDJSONBenchmarkMode aMode, BenchCorpus * aCorpus )
+{
+	NSDictionary	* theModeBudgets = [aBudgets objectForKey:[NSString stringWithUTF8String:kModeNames[aMode]]],
+					* theResult = [theModeBudgets objectForKey:[aCorpus->path lastPathComponent]];
+	if( theResult == nil )
+		theResult = [theModeBudgets objectForKey:@"*"];
+	return theResult;
+}
+
+/*
+	keeps the most allocations and bytes per MB measured for the mode and corpus, over every input
+ */
+static void NDJSONAllocationsRecord( NSMutableDictionary * aMeasured, enum NDJSONBenchmarkMode aMode, BenchCorpus * aCorpus, double anAllocationsPerMB, double aBytesPerMB )
+{
+	NSString			* theModeName = [NSString stringWithUTF8String:kModeNames[aMode]],
+						* theCorpusName = [aCorpus->path lastPathComponent];
+	NSMutableDictionary	* theModeMeasured = [aMeasured objectForKey:theModeName];
+	NSDictionary		* thePrevious = nil;
+	if( theModeMeasured == nil )
+	{
+		theModeMeasured = [NSMutableDictionary dictionary];
+		[aMeasured setObject:theModeMeasured forKey:theModeName];
+	}
+	thePrevious = [theModeMeasured objectForKey:theCorpusName];
+	[theModeMeasured setObject:[NSDictionary dictionaryWithObjectsAndKeys:
+									[NSNumber numberWithDouble:MAX(anAllocationsPerMB,[[thePrevious objectForKey:@"allocationsPerMB"] doubleValue])], @"allocationsPerMB",
+									[NSNumber numberWithDouble:MAX(aBytesPerMB,[[thePrevious objectForKey:@"bytesPerMB"] doubleValue])], @"bytesPerMB",
+									nil]
+						forKey:theCorpusName];
+}
+
+/*
+	the measurements plus aMargin percent, rounded up to whole numbers
+ */
+static NSDictionary * NDJSONAllocationsBudgetsWithMargin( NSDictionary * aMeasured, double aMargin )
+{
+	NSMutableDictionary		* theResult = [NSMutableDictionary dictionaryWithCapacity:aMeasured.count];
+	for( NSString * theModeName in aMeasured )
+	{
+		NSDictionary			* theModeMeasured = [aMeasured objectForKey:theModeName];
+		NSMutableDictionary		* theModeBudgets = [NSMutableDictionary dictionaryWithCapacity:theModeMeasured.count];
+		for( NSString * theCorpusName in theModeMeasured )
+		{
+			NSDictionary	* theMeasured = [theModeMeasured objectForKey:theCorpusName];
+			[theModeBudgets setObject:[NSDictionary dictionaryWithObjectsAndKeys:
+										[NSNumber numberWithUnsignedLongLong:(unsigned long long)ceil([[theMeasured objectForKey:@"allocationsPerMB"] doubleValue]*(100.0+aMargin)/100.0)], @"allocationsPerMB",
+										[NSNumber numberWithUnsignedLongLong:(unsigned long long)ceil([[theMeasured objectForKey:@"bytesPerMB"] doubleValue]*(100.0+aMargin)/100.0)], @"bytesPerMB",
+										nil]
+							forKey:theCorpusName];
+		}
+		[theResult setObject:theModeBudgets forKey:theModeName];
+	}
+	return theResult;
+}
+
+#pragma mark - running
+
+/*
+	returns NO if the corpus could not be parsed or the allocations are over budget, successful measurements are
+	recorded in aMeasured if it is not nil
+ */
+static BOOL NDJSONAllocationsRun( enum NDJSONBenchmarkMode aMode, enum NDJSONBenchmarkInput anInput, BenchCorpus * aCorpus, NSDictionary * aBudgets, NSMutableDictionary * aMeasured )
+{
+	BOOL				theSuccess = YES,
+						theWithinBudget = YES;
+	double				theMegabytes = (double)aCorpus->data.length/1.0e6,
+						theAllocationsPerMB = 0.0,
+						theBytesPerMB = 0.0;
+	NSDictionary		* theBudget = NDJSONAllocationsBudget( aBudgets, aMode, aCorpus );
+
+	if( (aMode == NDJSONBenchmarkModeCustom || aMode == NDJSONBenchmarkModeCustomKeyTables) && aCorpus->rootClass == Nil )
+		return YES;									// no custom classes for this corpus
+
+	@autoreleasepool
+	{
+		theSuccess = NDJSONBenchmarkRunOnce( aMode, anInput, aCorpus );		// warm up, class caches etc. are not counted
+	}
+	if( theSuccess )
+	{
+		kAllocationCount = 0;
+		kAllocationBytes = 0;
+		@autoreleasepool
+		{
+			kCounting = 1;
+			theSuccess = NDJSONBenchmarkRunOnce( aMode, anInput, aCorpus );
+			kCounting = 0;
+		}
+		if( theMegabytes > 0.0 )
+		{
+			theAllocationsPerMB = (double)kAllocationCount/theMegabytes;
+			theBytesPerMB = (double)kAllocationBytes/theMegabytes;
+		}
+		if( theSuccess && aMeasured != nil )
+			NDJSONAllocationsRecord( aMeasured, aMode, aCorpus, theAllocationsPerMB, theBytesPerMB );
+		if( theBudget != nil )
+		{
+			NSNumber	* theMaximumAllocations = [theBudget objectForKey:@"allocationsPerMB"],
+						* theMaximumBytes = [theBudget objectForKey:@"bytesPerMB"];
+			if( theMaximumAllocations != nil && theAllocationsPerMB > [theMaximumAllocations doubleValue] )
+				theWithinBudget = NO;
+			if( theMaximumBytes != nil && theBytesPerMB > [theMaximumBytes doubleValue] )
+				theWithinBudget = NO;
+		}
+	}
+
+	printf( "{\"corpus\":\"%s\",\"mode\":\"%s\",\"input\":\"%s\",\"ok\":%s,\"bytes\":%lu",
+			[[aCorpus->path lastPathComponent] UTF8String], kModeNames[aMode], kInputNames[anInput], theSuccess ? "true" : "false",
+			(unsigned long)aCorpus->data.length );
+	if( theSuccess )
+	{
+		printf( ",\"allocations\":%llu,\"allocated_bytes\":%llu,\"allocations_per_mb\":%.1f,\"bytes_per_mb\":%.1f",
+				kAllocationCount, kAllocationBytes, theAllocationsPerMB, theBytesPerMB );
+		if( theBudget != nil )
+		{
+			printf( ",\"budget_allocations_per_mb\":%.1f,\"budget_bytes_per_mb\":%.1f,\"within_budget\":%s",
+					[[theBudget objectForKey:@"allocationsPerMB"] doubleValue], [[theBudget objectForKey:@"bytesPerMB"] doubleValue], theWithinBudget ? "true" : "false" );
+		}
+	}
+	printf( "}\n" );
+	fflush( stdout );
+
+	if( !theWithinBudget )
+		fprintf( stderr, "%s %s %s is over its allocation budget\n", [[aCorpus->path lastPathComponent] UTF8String], kModeNames[aMode], kInputNames[anInput] );
+	return theSuccess && theWithinBudget;
+}
+
+#pragma mark - main
+
+int main( int argc, const char * argv[] )
+{
+	int				theResult = 0;
+	@autoreleasepool
+	{
+		NSDictionary		* theBudgets = nil;
+		NSMutableDictionary	* theMeasured = nil;
+		const char			* theWritePath = NULL;
+		double				theMargin = 10.0;
+		unsigned int		theModes = (1u<<NDJSONBenchmarkModeCount)-1,
+							theInputs = 1u<<NDJSONBenchmarkInputData;
+		int					i = 1;
+
+		for( ; i < argc && argv[i][0] == '-'; i++ )
+		{
+			if( strcmp( argv[i], "-b" ) == 0 && i+1 < argc )
+			{
+				const char		* thePath = argv[++i];
+				theBudgets = [NSDictionary dictionaryWithContentsOfFile:[NSString stringWithUTF8String:thePath]];
+				if( theBudgets == nil )
+				{
+					fprintf( stderr, "failed to read budgets %s\n", thePath );
+					return 1;
+				}
+			}
+			else if( strcmp( argv[i], "-w" ) == 0 && i+1 < argc )
+			{
+				theWritePath = argv[++i];
+				theMeasured = [NSMutableDictionary dictionary];
+			}
+			else if( strcmp( argv[i], "-g" ) == 0 && i+1 < argc )
+			{
+				char		* theEnd = NULL;
+				theMargin = strtod( argv[++i], &theEnd );
+				if( theEnd == argv[i] || *theEnd != '\0' || theMargin < 0.0 )
+				{
+					fprintf( stderr, "invalid margin %s\n", argv[i] );
+					return 1;
+				}
+			}
+			else if( strcmp( argv[i], "-m" ) == 0 && i+1 < argc )
+				theModes = NDJSONBenchmarkParseNames( argv[++i], kModeNames, NDJSONBenchmarkModeCount );
+			else if( strcmp( argv[i], "-t" ) == 0 && i+1 < argc )
+				theInputs = NDJSONBenchmarkParseNames( argv[++i], kInputNames, NDJSONBenchmarkInputCount );
+			else
+				break;
+		}
+
+		if( i >= argc )
+		{
+			fprintf( stderr, "usage: %s [-b budgets.plist] [-w budgets.plist [-g margin]] [-m parser,plist,plist-presized,custom,custom-key-tables] [-t string,data,file,stream,function,block] corpus ...\n", argv[0] );
+			return 1;
+		}
+
+		for( ; i < argc; i++ )
+		{
+			BenchCorpus		* theCorpus = [[BenchCorpus alloc] initWithPath:[NSString stringWithUTF8String:argv[i]]];
+			if( theCorpus == nil )
+			{
+				fprintf( stderr, "failed to read %s\n", argv[i] );
+				theResult = 1;
+				continue;
+			}
+			for( unsigned int theMode = 0; theMode < NDJSONBenchmarkModeCount; theMode++ )
+			{
+				if( theModes & (1u<<theMode) )
+				{
+					for( unsigned int theInput = 0; theInput < NDJSONBenchmarkInputCount; theInput++ )
+					{
+						if( (theInputs & (1u<<theInput)) && !NDJSONAllocationsRun( (enum NDJSONBenchmarkMode)theMode, (enum NDJSONBenchmarkInput)theInput, theCorpus, theBudgets, theMeasured ) )
+							theResult = 1;
+					}
+				}
+			}
+			[theCorpus release];
+		}
+
+		if( theWritePath != NULL && ![NDJSONAllocationsBudgetsWithMargin( theMeasured, theMargin ) writeToFile:[NSString stringWithUTF8String:theWritePath] atomically:YES] )
+		{
+			fprintf( stderr, "failed to write budgets %s\n", theWritePath );
+			theResult = 1;
+		}
+	}
+	return theResult;
+}
+
+#else
+
+int main( int argc, const char * argv[] )
+{
+	fprintf( stderr, "%s needs glibc to interpose the allocator\n", argv[0] );
+	return 1;
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*
+	NDJSONBenchmark.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+//	Command line throughput benchmark, prints one JSON object per line for every corpus, mode and input type measured.
+//
+//	usage:	ndjson-benchmark [-i iterations] [-m mode,...] [-t input,...] corpus ...
+//			ndjson-benchmark -g path count
+//
+//	modes are parser, plist, plist-presized, custom and custom-key-tables, inputs are string, data, file, stream, function and block.
+//	corpora with the extension jsonl or ndjson are parsed as JSON Lines, -g generates a synthetic JSON Lines corpus.
+//
+
+#import <Foundation/Foundation.h>
+#import "NDJSONBenchmarkSupport.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const NSUInteger		kDefaultIterations = 10;
+
+#pragma mark - running
+
+static double NDJSONBenchmarkTime( clockid_t aClock )
+{
+	struct timespec		theTime;
+	clock_gettime( aClock, &theTime );
+	return (double)theTime.tv_sec + (double)theTime.tv_nsec*1.0e-9;
+}
+
+static void NDJSONBenchmarkRun( enum NDJSONBenchmarkMode aMode, enum NDJSONBenchmarkInput anInput, BenchCorpus * aCorpus, NSUInteger anIterations )
+{
+	BOOL		theSuccess = YES;
+	double		theWallTime = 0.0,
+				theCPUTime = 0.0;
+
+	if( (aMode == NDJSONBenchmarkModeCustom || aMode == NDJSONBenchmarkModeCustomKeyTables) && aCorpus->rootClass == Nil )
+		return;									// no custom classes for this corpus
+
+	@autoreleasepool
+	{
+		theSuccess = NDJSONBenchmarkRunOnce( aMode, anInput, aCorpus );		// warm up, class caches etc.
+	}
+	if( theSuccess )
+	{
+		double		theWallStart = NDJSONBenchmarkTime( CLOCK_MONOTONIC ),
+					theCPUStart = NDJSONBenchmarkTime( CLOCK_PROCESS_CPUTIME_ID );
+		for( NSUInteger i = 0; i < anIterations && theSuccess; i++ )
+		{
+			@autoreleasepool
+			{
+				theSuccess = NDJSONBenchmarkRunOnce( aMode, anInput, aCorpus );
+			}
+		}
+		theWallTime = NDJSONBenchmarkTime( CLOCK_MONOTONIC ) - theWallStart;
+		theCPUTime = NDJSONBenchmarkTime( CLOCK_PROCESS_CPUTIME_ID ) - theCPUStart;
+	}
+
+	printf( "{\"corpus\":\"%s\",\"mode\":\"%s\",\"input\":\"%s\",\"ok\":%s,\"bytes\":%lu,\"documents\":%lu,\"iterations\":%lu",
+			[[aCorpus->path lastPathComponent] UTF8String], kModeNames[aMode], kInputNames[anInput], theSuccess ? "true" : "false",
+			(unsigned long)aCorpus->data.length, (unsigned long)aCorpus->documentCount, (unsigned long)anIterations );
+	if( theSuccess && theWallTime > 0.0 )
+	{
+		printf( ",\"seconds\":%.6f,\"cpu_seconds\":%.6f,\"mb_per_second\":%.3f,\"documents_per_second\":%.3f",
+				theWallTime, theCPUTime,
+				(double)aCorpus->data.length*(double)anIterations/theWallTime/1.0e6,
+				(double)aCorpus->documentCount*(double)anIterations/theWallTime );
+	}
+	printf( "}\n" );
+	fflush( stdout );
+}
+
+#pragma mark - synthetic JSON Lines corpus
+
+static BOOL NDJSONBenchmarkGenerateJSONLines( const char * aPath, unsigned long aCount )
+{
+	static const char	* const kWords[] = { "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel", "india", "juliett", "kilo", "lima" };
+	const unsigned long	kWordCount = sizeof(kWords)/sizeof(*kWords);
+	FILE				* theFile = fopen( aPath, "w" );
+	if( theFile == NULL )
+		return NO;
+	srandom( 42 );								// the same corpus every time
+	for( unsigned long i = 0; i < aCount; i++ )
+	{
+		const char		* theFirst = kWords[random()%kWordCount],
+						* theSecond = kWords[random()%kWordCount];
+		fprintf( theFile, "{\"id\":%lu,\"name\":\"%s %s\",\"email\":\"%s.%s%lu@example.com\",\"score\":%.4f,\"active\":%s,\"tags\":[\"%s\",\"%s\"],\"address\":{\"street\":\"%ld %s Street\",\"city\":\"%s\"}}\n",
+				i, theFirst, theSecond, theFirst, theSecond, i, (double)random()/(double)RAND_MAX*100.0, random()&1 ? "true" : "false",
+				kWords[random()%kWordCount], kWords[random()%kWordCount], random()%1000, theSecond, theFirst );
+	}
+	fclose( theFile );
+	return YES;
+}
+
+#pragma mark - main
+
+int main( int argc, const char * argv[] )
+{
+	int				theResult = 0;
+	@autoreleasepool
+	{
+		NSUInteger		theIterations = kDefaultIterations;
+		unsigned int	theModes = (1u<<NDJSONBenchmarkModeCount)-1,
+						theInputs = (1u<<NDJSONBenchmarkInputCount)-1;
+		int				i = 1;
+
+		for( ; i < argc && argv[i][0] == '-'; i++ )
+		{
+			if( strcmp( argv[i], "-g" ) == 0 && i+2 < argc )
+				return NDJSONBenchmarkGenerateJSONLines( argv[i+1], strtoul( argv[i+2], NULL, 10 ) ) ? 0 : 1;
+			else if( strcmp( argv[i], "-i" ) == 0 && i+1 < argc )
+				theIterations = strtoul( argv[++i], NULL, 10 );
+			else if( strcmp( argv[i], "-m" ) == 0 && i+1 < argc )
+				theModes = NDJSONBenchmarkParseNames( argv[++i], kModeNames, NDJSONBenchmarkModeCount );
+			else if( strcmp( argv[i], "-t" ) == 0 && i+1 < argc )
+				theInputs = NDJSONBenchmarkParseNames( argv[++i], kInputNames, NDJSONBenchmarkInputCount );
+			else
+				break;
+		}
+
+		if( i >= argc )
+		{
+			fprintf( stderr, "usage: %s [-i iterations] [-m parser,plist,plist-presized,custom,custom-key-tables] [-t string,data,file,stream,function,block] corpus ...\n"
+							 "       %s -g path count\n", argv[0], argv[0] );
+			return 1;
+		}
+
+		for( ; i < argc; i++ )
+		{
+			BenchCorpus		* theCorpus = [[BenchCorpus alloc] initWithPath:[NSString stringWithUTF8String:argv[i]]];
+			if( theCorpus == nil )
+			{
+				fprintf( stderr, "failed to read %s\n", argv[i] );
+				theResult = 1;
+				continue;
+			}
+			for( unsigned int theMode = 0; theMode < NDJSONBenchmarkModeCount; theMode++ )
+			{
+				if( theModes & (1u<<theMode) )
+				{
+					for( unsigned int theInput = 0; theInput < NDJSONBenchmarkInputCount; theInput++ )
+					{
+						if( theInputs & (1u<<theInput) )
+							NDJSONBenchmarkRun( (enum NDJSONBenchmarkMode)theMode, (enum NDJSONBenchmarkInput)theInput, theCorpus, theIterations );
+					}
+				}
+			}
+			[theCorpus release];
+		}
+	}
+	return theResult;
+}
+
@@ -0,0 +1,79 @@
+/*
+	NDJSONBenchmarkSupport.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+//	Corpora, modes and input types shared by the command line benchmark tools.
+//
+
+#import <Foundation/Foundation.h>
+
+@class		NDJSONShapeProfile;
+
+enum NDJSONBenchmarkMode
+{
+	NDJSONBenchmarkModeParser,
+	NDJSONBenchmarkModePropertyList,
+	NDJSONBenchmarkModePropertyListPresized,
+	NDJSONBenchmarkModeCustom,
+	NDJSONBenchmarkModeCustomKeyTables,
+	NDJSONBenchmarkModeCount
+};
+
+enum NDJSONBenchmarkInput
+{
+	NDJSONBenchmarkInputString,
+	NDJSONBenchmarkInputData,
+	NDJSONBenchmarkInputFile,
+	NDJSONBenchmarkInputStream,
+	NDJSONBenchmarkInputFunction,
+	NDJSONBenchmarkInputBlock,
+	NDJSONBenchmarkInputCount
+};
+
+extern const char	* const kModeNames[];
+extern const char	* const kInputNames[];
+
+@interface BenchCorpus : NSObject
+{
+@public
+	NSString		* path;
+	NSData			* data;
+	NSString		* string;
+	Class			rootClass;
+	NSUInteger		documentCount;
+	BOOL			JSONLines;
+	NDJSONShapeProfile	* shapeProfile;			// kept from run to run by the plist-presized mode
+}
+- (id)initWithPath:(NSString *)path;
+@end
+
+/*
+	parse the corpus once with the mode and input, returns NO if it could not be parsed
+ */
+extern BOOL NDJSONBenchmarkRunOnce( enum NDJSONBenchmarkMode mode, enum NDJSONBenchmarkInput input, BenchCorpus * corpus );
+/*
+	comma separated names to a bit mask of their indexes
+ */
+extern unsigned int NDJSONBenchmarkParseNames( const char * list, const char * const * names, unsigned int count );
@@ -0,0 +1,356 @@
+/*
+	NDJSONBenchmarkSupport.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import "NDJSONBenchmarkSupport.h"
+#import <objc/runtime.h>
+#import "NDJSONParser.h"
+#import "NDJSONDeserializer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const NSUInteger		kChunkSize = 4096;			// size of the pieces the function and block inputs supply
+
+const char	* const kModeNames[] = { "parser", "plist", "plist-presized", "custom", "custom-key-tables" };
+const char	* const kInputNames[] = { "string", "data", "file", "stream", "function", "block" };
+
+struct NDJSONBenchmarkChunks
+{
+	const uint8_t		* bytes;
+	NSUInteger			length,
+						position;
+};
+
+#pragma mark - custom classes for the standard corpora
+
+/*
+	releases all of its object instance variables so the custom classes don't each need a dealloc
+ */
+@interface BenchObject : NSObject
+@end
+
+@implementation BenchObject
+- (void)dealloc
+{
+	for( Class theClass = [self class]; theClass != [BenchObject class]; theClass = class_getSuperclass(theClass) )
+	{
+		unsigned int	theCount = 0;
+		Ivar			* theIvars = class_copyIvarList( theClass, &theCount );
+		for( unsigned int i = 0; i < theCount; i++ )
+		{
+			const char		* theType = ivar_getTypeEncoding( theIvars[i] );
+			if( theType != NULL && theType[0] == '@' )
+				[object_getIvar( self, theIvars[i] ) release];
+		}
+		free( theIvars );
+	}
+	[super dealloc];
+}
+@end
+
+@interface BenchUser : BenchObject
+@property(retain,nonatomic)		NSString		* name;
+@property(retain,nonatomic)		NSString		* screenName;
+@property(retain,nonatomic)		NSString		* location;
+@property(retain,nonatomic)		NSNumber		* followersCount;
+@property(retain,nonatomic)		NSNumber		* friendsCount;
+@end
+
+@interface BenchStatus : BenchObject
+@property(retain,nonatomic)		NSString		* idStr;
+@property(retain,nonatomic)		NSString		* text;
+@property(retain,nonatomic)		NSString		* createdAt;
+@property(retain,nonatomic)		NSNumber		* retweetCount;
+@property(retain,nonatomic)		NSNumber		* favoriteCount;
+@property(retain,nonatomic)		BenchUser		* user;
+@end
+
+@interface BenchTwitter : BenchObject
+@property(retain,nonatomic)		NSArray			* statuses;
+@end
+
+@interface BenchPrice : BenchObject
+@property(retain,nonatomic)		NSNumber		* amount;
+@property(retain,nonatomic)		NSNumber		* audienceSubCategoryId;
+@property(retain,nonatomic)		NSNumber		* seatCategoryId;
+@end
+
+@interface BenchPerformance : BenchObject
+@property(retain,nonatomic)		NSNumber		* eventId;
+@property(retain,nonatomic)		NSNumber		* start;
+@property(retain,nonatomic)		NSString		* venueCode;
+@property(retain,nonatomic)		NSArray			* prices;
+@end
+
+@interface BenchCITMCatalog : BenchObject
+@property(retain,nonatomic)		NSDictionary	* areaNames;
+@property(retain,nonatomic)		NSDictionary	* events;
+@property(retain,nonatomic)		NSArray			* performances;
+@end
+
+@interface BenchGeometry : BenchObject
+@property(retain,nonatomic)		NSString		* type;
+@property(retain,nonatomic)		NSArray			* coordinates;
+@end
+
+@interface BenchFeature : BenchObject
+@property(retain,nonatomic)		NSString		* type;
+@property(retain,nonatomic)		NSDictionary	* properties;
+@property(retain,nonatomic)		BenchGeometry	* geometry;
+@end
+
+@interface BenchFeatureCollection : BenchObject
+@property(retain,nonatomic)		NSString		* type;
+@property(retain,nonatomic)		NSArray			* features;
+@end
+
+@interface BenchRecord : BenchObject
+@property(retain,nonatomic)		NSNumber		* identifier;
+@property(retain,nonatomic)		NSString		* name;
+@property(retain,nonatomic)		NSString		* email;
+@property(retain,nonatomic)		NSNumber		* score;
+@property(retain,nonatomic)		NSNumber		* active;
+@property(retain,nonatomic)		NSArray			* tags;
+@end
+
+@implementation BenchUser
+@synthesize		name, screenName, location, followersCount, friendsCount;
+NDJSONPropertyNamesForKeys( @"screenName", @"screen_name", @"followersCount", @"followers_count", @"friendsCount", @"friends_count" );
+@end
+
+@implementation BenchStatus
+@synthesize		idStr, text, createdAt, retweetCount, favoriteCount, user;
+NDJSONPropertyNamesForKeys( @"idStr", @"id_str", @"createdAt", @"created_at", @"retweetCount", @"retweet_count", @"favoriteCount", @"favorite_count" );
+NDJSONClassesForPropertyNames( [BenchUser class], @"user" );
+@end
+
+@implementation BenchTwitter
+@synthesize		statuses;
+NDJSONCollectionClassesForPropertyNames( [BenchStatus class], @"statuses" );
+@end
+
+@implementation BenchPrice
+@synthesize		amount, audienceSubCategoryId, seatCategoryId;
+@end
+
+@implementation BenchPerformance
+@synthesize		eventId, start, venueCode, prices;
+NDJSONCollectionClassesForPropertyNames( [BenchPrice class], @"prices" );
+@end
+
+@implementation BenchCITMCatalog
+@synthesize		areaNames, events, performances;
+NDJSONCollectionClassesForPropertyNames( [BenchPerformance class], @"performances" );
+@end
+
+@implementation BenchGeometry
+@synthesize		type, coordinates;
+@end
+
+@implementation BenchFeature
+@synthesize		type, properties, geometry;
+NDJSONClassesForPropertyNames( [BenchGeometry class], @"geometry" );
+@end
+
+@implementation BenchFeatureCollection
+@synthesize		type, features;
+NDJSONCollectionClassesForPropertyNames( [BenchFeature class], @"features" );
+@end
+
+@implementation BenchRecord
+@synthesize		identifier, name, email, score, active, tags;
+NDJSONPropertyNamesForKeys( @"identifier", @"id" );
+@end
+
+#pragma mark - corpus
+
+@implementation BenchCorpus
+
+/*
+	the custom classes are chosen from the name of the standard corpora, there are none for other files
+ */
+- (id)initWithPath:(NSString *)aPath
+{
+	if( (self = [super init]) != nil )
+	{
+		NSString		* theName = [[aPath lastPathComponent] stringByDeletingPathExtension];
+		NSString		* theExtension = [[aPath pathExtension] lowercaseString];
+		path = [aPath copy];
+		data = [[NSData alloc] initWithContentsOfFile:aPath];
+		if( data == nil )
+		{
+			[self release];
+			return nil;
+		}
+		string = [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+		JSONLines = [theExtension isEqualToString:@"jsonl"] || [theExtension isEqualToString:@"ndjson"];
+		documentCount = 1;
+		if( JSONLines )
+		{
+			const uint8_t	* theBytes = data.bytes;
+			documentCount = 0;
+			for( NSUInteger i = 0, theLength = data.length; i < theLength; i++ )
+			{
+				if( theBytes[i] == '\n' && (i == 0 || theBytes[i-1] != '\n') )
+					documentCount++;
+			}
+			if( data.length > 0 && theBytes[data.length-1] != '\n' )
+				documentCount++;
+			rootClass = [BenchRecord class];
+		}
+		else if( [theName isEqualToString:@"twitter"] )
+			rootClass = [BenchTwitter class];
+		else if( [theName isEqualToString:@"citm_catalog"] )
+			rootClass = [BenchCITMCatalog class];
+		else if( [theName isEqualToString:@"canada"] )
+			rootClass = [BenchFeatureCollection class];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[path release];
+	[data release];
+	[string release];
+	[super dealloc];
+}
+
+@end
+
+#pragma mark - running
+
+static NSInteger NDJSONBenchmarkReadChunk( uint8_t ** aBuffer, void * aContext )
+{
+	struct NDJSONBenchmarkChunks	* theChunks = (struct NDJSONBenchmarkChunks*)aContext;
+	NSUInteger						theLength = MIN( kChunkSize, theChunks->length-theChunks->position );
+	*aBuffer = (uint8_t*)theChunks->bytes+theChunks->position;
+	theChunks->position += theLength;
+	return (NSInteger)theLength;
+}
+
+static NDJSONParser * NDJSONBenchmarkNewParser( enum NDJSONBenchmarkInput anInput, BenchCorpus * aCorpus, struct NDJSONBenchmarkChunks * aChunks )
+{
+	NDJSONParser		* theResult = nil;
+	aChunks->bytes = aCorpus->data.bytes;
+	aChunks->length = aCorpus->data.length;
+	aChunks->position = 0;
+	switch( anInput )
+	{
+	case NDJSONBenchmarkInputString:
+		if( aCorpus->string != nil )
+			theResult = [[NDJSONParser alloc] initWithJSONString:aCorpus->string];
+		break;
+	case NDJSONBenchmarkInputData:
+		theResult = [[NDJSONParser alloc] initWithJSONData:aCorpus->data encoding:NSUTF8StringEncoding];
+		break;
+	case NDJSONBenchmarkInputFile:
+		theResult = [[NDJSONParser alloc] initWithContentsOfFile:aCorpus->path encoding:NSUTF8StringEncoding];
+		break;
+	case NDJSONBenchmarkInputStream:
+		theResult = [[NDJSONParser alloc] initWithInputStream:[NSInputStream inputStreamWithData:aCorpus->data] encoding:NSUTF8StringEncoding];
+		break;
+	case NDJSONBenchmarkInputFunction:
+		theResult = [[NDJSONParser alloc] initWithSourceFunction:NDJSONBenchmarkReadChunk context:aChunks encoding:NSUTF8StringEncoding];
+		break;
+	case NDJSONBenchmarkInputBlock:
+		theResult = [[NDJSONParser alloc] initWithSourceBlock:^NSInteger(uint8_t ** aBuffer) { return NDJSONBenchmarkReadChunk( aBuffer, aChunks ); } encoding:NSUTF8StringEncoding];
+		break;
+	default:
+		break;
+	}
+	return theResult;
+}
+
+BOOL NDJSONBenchmarkRunOnce( enum NDJSONBenchmarkMode aMode, enum NDJSONBenchmarkInput anInput, BenchCorpus * aCorpus )
+{
+	BOOL							theResult = NO;
+	struct NDJSONBenchmarkChunks	theChunks;
+	NDJSONParser					* theParser = NDJSONBenchmarkNewParser( anInput, aCorpus, &theChunks );
+	NDJSONOptionFlags				theOptions = aCorpus->JSONLines ? NDJSONOptionJSONLines : NDJSONOptionNone;
+
+	if( theParser != nil )
+	{
+		NSError					* theError = nil;
+		NDJSONDeserializer		* theDeserializer = nil;
+		switch( aMode )
+		{
+		case NDJSONBenchmarkModeParser:
+			theResult = [theParser parseWithOptions:theOptions];
+			break;
+		case NDJSONBenchmarkModePropertyList:
+			theDeserializer = [[NDJSONDeserializer alloc] init];
+			break;
+		case NDJSONBenchmarkModePropertyListPresized:
+			if( aCorpus->shapeProfile == nil )
+				aCorpus->shapeProfile = [[NDJSONShapeProfile alloc] init];
+			theDeserializer = [[NDJSONDeserializer alloc] init];
+			theDeserializer.shapeProfile = aCorpus->shapeProfile;
+			theOptions |= NDJSONOptionPresizeContainers;
+			break;
+		case NDJSONBenchmarkModeCustom:
+		case NDJSONBenchmarkModeCustomKeyTables:
+			theDeserializer = aCorpus->JSONLines
+								? [[NDJSONDeserializer alloc] initWithRootClass:aCorpus->rootClass rootCollectionClass:[NSMutableArray class]]
+								: [[NDJSONDeserializer alloc] initWithRootClass:aCorpus->rootClass];
+			theOptions |= NDJSONOptionIgnoreUnknownProperties;
+			if( aMode == NDJSONBenchmarkModeCustomKeyTables )
+				theOptions |= NDJSONOptionUseKeyTables;
+			break;
+		default:
+			break;
+		}
+		if( theDeserializer != nil )
+		{
+			theResult = [theDeserializer objectForJSON:theParser options:theOptions error:&theError] != nil && theError == nil;
+			[theDeserializer release];
+		}
+		[theParser release];
+	}
+	return theResult;
+}
+
+#pragma mark - arguments
+
+unsigned int NDJSONBenchmarkParseNames( const char * aList, const char * const * aNames, unsigned int aCount )
+{
+	unsigned int	theResult = 0;
+	char			* theList = strdup( aList ),
+					* theState = NULL;
+	for( char * theName = strtok_r( theList, ",", &theState ); theName != NULL; theName = strtok_r( NULL, ",", &theState ) )
+	{
+		unsigned int	i = 0;
+		while( i < aCount && strcmp( theName, aNames[i] ) != 0 )
+			i++;
+		if( i < aCount )
+			theResult |= 1u<<i;
+		else
+			fprintf( stderr, "unknown name %s\n", theName );
+	}
+	free( theList );
+	return theResult;
+}
+
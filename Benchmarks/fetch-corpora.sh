@@ -0,0 +1,26 @@
+#!/bin/sh
+#
+#	fetch-corpora.sh
+#	NDJSON Benchmarks
+#
+#	Downloads the standard JSON benchmark corpora into corpora/ and, if the benchmark tool has been built,
+#	generates the synthetic JSON Lines corpus.
+#
+
+CORPORA_URL=https://raw.githubusercontent.com/simdjson/simdjson/master/jsonexamples
+DIR=$(dirname "$0")/corpora
+TOOL=$(dirname "$0")/obj/ndjson-benchmark
+
+mkdir -p "$DIR" || exit 1
+for NAME in twitter citm_catalog canada
+do
+	if [ ! -f "$DIR/$NAME.json" ]
+	then
+		curl -fsSL -o "$DIR/$NAME.json" "$CORPORA_URL/$NAME.json" || exit 1
+	fi
+done
+
+if [ -x "$TOOL" ] && [ ! -f "$DIR/synthetic.jsonl" ]
+then
+	"$TOOL" -g "$DIR/synthetic.jsonl" 200000 || exit 1
+fi
@@ -23,6 +23,14 @@
 	THE SOFTWARE.
  */
 
+#import "NDJSONColumnarTable.h"
 #import "NDJSONDeserializer.h"
+#import "NDJSONIndex.h"
+#import "NDJSONMulticastDelegate.h"
 #import "NDJSONParser.h"
+#import "NDJSONPipelinedParser.h"
+#import "NDJSONQuery.h"
 #import "NDJSONRequest.h"
+#import "NDJSONSchemaValidator.h"
+#import "NDJSONStructDecoder.h"
+#import "NDJSONTapeParser.h"
@@ -0,0 +1,119 @@
+/*
+	NDJSONColumnarTable.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "NDJSONParser.h"
+
+typedef enum
+{
+	NDJSONColumnNull,					// every value is null or missing
+	NDJSONColumnBool,					// BOOL values, one byte each
+	NDJSONColumnInteger,				// int64_t values
+	NDJSONColumnFloat,					// double values
+	NDJSONColumnString					// uint32_t index of each value in the dictionary of the column
+}		NDJSONColumnType;
+
+@class NDJSONColumn;
+
+/**
+	A table of the rows of an array of flat JSON objects, such as metrics, trades or log events, stored as one column per key rather than a dictionary per row. Each column is a single contiguous buffer of native values with a validity bitmap for rows whose value is null or missing, string columns are dictionary encoded so each distinct string is stored once. Tables are built directly from the events of an NDJSONParser by NDJSONColumnarTableBuilder without creating an object for each row.
+
+	The type of a column is the type of its first value that is not null, a float in an integer column converts the column to floats and an integer in a float column is stored as a float. Values of any other type, including nested arrays and objects, are treated as null and hasMixedTypes is set for their column.
+ */
+@interface NDJSONColumnarTable : NSObject
+
+/**
+	build a table with a new NDJSONColumnarTableBuilder, see -[NDJSONColumnarTableBuilder initWithPath:].
+ */
++ (NDJSONColumnarTable *)tableForJSONParser:(NDJSONParser *)parser path:(NSString *)path options:(NDJSONOptionFlags)options error:(NSError **)error;
+
+@property(readonly,nonatomic)	NSUInteger		rowCount;
+/**
+	the columns in the order their keys were first seen.
+ */
+@property(readonly,nonatomic)	NSArray			* columns;
+@property(readonly,nonatomic)	NSArray			* columnNames;
+
+- (NDJSONColumn *)columnForName:(NSString *)name;
+
+@end
+
+/**
+	A column of an NDJSONColumnarTable, with a value for every row of the table.
+ */
+@interface NDJSONColumn : NSObject
+
+@property(readonly,nonatomic)	NSString			* name;
+@property(readonly,nonatomic)	NDJSONColumnType	type;
+@property(readonly,nonatomic)	NSUInteger			count;
+/**
+	the values of the rows as a contiguous buffer of BOOL, int64_t, double or uint32_t dictionary indexes depending on type, the buffer the values were written into while parsing is not copied. The value of a row that is not valid is zero, for a column of type NDJSONColumnNull the data is empty.
+ */
+@property(readonly,nonatomic)	NSData				* values;
+/**
+	validity bitmap, bit i%8 of byte i/8 is set if row i has a value, the least significant bit first as with Apache Arrow.
+ */
+@property(readonly,nonatomic)	NSData				* validity;
+@property(readonly,nonatomic)	NSUInteger			nullCount;
+/**
+	the distinct strings of a string column, in the order they were first seen, nil for other types.
+ */
+@property(readonly,nonatomic)	NSArray				* dictionary;
+/**
+	whether some values were not of the type of the column and so are treated as null.
+ */
+@property(readonly,nonatomic)	BOOL				hasMixedTypes;
+
+- (BOOL)isValidAtRow:(NSUInteger)row;
+/**
+	the value of row as an NSNumber or NSString, or NSNull if the row is not valid.
+ */
+- (id)objectAtRow:(NSUInteger)row;
+
+@end
+
+/**
+	NDJSONColumnarTableBuilder builds an NDJSONColumnarTable as the delegate of an NDJSONParser. Values that are not in the rows of the table are skipped without being parsed.
+ */
+@interface NDJSONColumnarTableBuilder : NSObject <NDJSONParserDelegate>
+
+/**
+	initialize with the JSON Pointer (RFC 6901) to the array whose elements are the rows, nil or an empty string for the root array. With NDJSONOptionJSONLines the root array is the records, a root object that is not in an array is a single row. Elements that are not objects are ignored.
+ */
+- (id)initWithPath:(NSString *)path;
+
+@property(readonly,nonatomic)	NSString				* path;
+/**
+	the table for the last document parsed.
+ */
+@property(readonly,nonatomic)	NDJSONColumnarTable		* table;
+
+/**
+	parse the input of parser with the given options and return the table, returns nil if the JSON could not be parsed or path is not an array.
+ */
+- (NDJSONColumnarTable *)tableForJSONParser:(NDJSONParser *)parser options:(NDJSONOptionFlags)options error:(NSError **)error;
+
+@end
@@ -0,0 +1,710 @@
+/*
+	NDJSONColumnarTable.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import "NDJSONColumnarTable.h"
+
+/*
+	Each column is built in a pair of buffers, the values and the validity bitmap, that grow together as rows are added,
+	rows without a value for the column are left as zero in both. When the document ends the buffers are handed to the
+	NSData of the columns without being copied.
+ */
+
+static const NSUInteger		kMinimumColumnCapacity = 64;
+
+static NSError * NDJSONColumnarError( NSString * aDescription )
+{
+	return [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONBadFormatError userInfo:[NSDictionary dictionaryWithObject:aDescription forKey:NSLocalizedDescriptionKey]];
+}
+
+static NSUInteger NDJSONColumnElementSize( NDJSONColumnType aType )
+{
+	switch( aType )
+	{
+	case NDJSONColumnBool:
+		return sizeof(BOOL);
+	case NDJSONColumnInteger:
+		return sizeof(int64_t);
+	case NDJSONColumnFloat:
+		return sizeof(double);
+	case NDJSONColumnString:
+		return sizeof(uint32_t);
+	default:
+		return 0;
+	}
+}
+
+#pragma mark - NDJSONColumn
+
+@interface NDJSONColumn ()
+{
+	NSString			* _name;
+	NDJSONColumnType	_type;
+	NSUInteger			_count,
+						_nullCount;
+	NSData				* _values,
+						* _validity;
+	NSArray				* _dictionary;
+	BOOL				_hasMixedTypes;
+}
+- (id)initWithName:(NSString *)name type:(NDJSONColumnType)type count:(NSUInteger)count values:(NSData *)values validity:(NSData *)validity nullCount:(NSUInteger)nullCount dictionary:(NSArray *)dictionary hasMixedTypes:(BOOL)hasMixedTypes;
+@end
+
+@implementation NDJSONColumn
+
+@synthesize		name = _name,
+				type = _type,
+				count = _count,
+				values = _values,
+				validity = _validity,
+				nullCount = _nullCount,
+				dictionary = _dictionary,
+				hasMixedTypes = _hasMixedTypes;
+
+#pragma mark - creation and destruction
+
+- (id)initWithName:(NSString *)aName type:(NDJSONColumnType)aType count:(NSUInteger)aCount values:(NSData *)aValues validity:(NSData *)aValidity nullCount:(NSUInteger)aNullCount dictionary:(NSArray *)aDictionary hasMixedTypes:(BOOL)aHasMixedTypes
+{
+	if( (self = [super init]) != nil )
+	{
+		_name = [aName copy];
+		_type = aType;
+		_count = aCount;
+		_values = [aValues retain];
+		_validity = [aValidity retain];
+		_nullCount = aNullCount;
+		_dictionary = [aDictionary retain];
+		_hasMixedTypes = aHasMixedTypes;
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[_name release];
+	[_values release];
+	[_validity release];
+	[_dictionary release];
+	[super dealloc];
+}
+
+#pragma mark - values
+
+- (BOOL)isValidAtRow:(NSUInteger)aRow
+{
+	NSParameterAssert( aRow < _count );
+	return (((const uint8_t *)_validity.bytes)[aRow>>3] & (1<<(aRow&7))) != 0;
+}
+
+- (id)objectAtRow:(NSUInteger)aRow
+{
+	id		theResult = nil;
+	if( ![self isValidAtRow:aRow] )
+		theResult = [NSNull null];
+	else switch( _type )
+	{
+	case NDJSONColumnBool:
+		theResult = [NSNumber numberWithBool:((const BOOL *)_values.bytes)[aRow]];
+		break;
+	case NDJSONColumnInteger:
+		theResult = [NSNumber numberWithLongLong:((const int64_t *)_values.bytes)[aRow]];
+		break;
+	case NDJSONColumnFloat:
+		theResult = [NSNumber numberWithDouble:((const double *)_values.bytes)[aRow]];
+		break;
+	case NDJSONColumnString:
+		theResult = [_dictionary objectAtIndex:((const uint32_t *)_values.bytes)[aRow]];
+		break;
+	default:
+		theResult = [NSNull null];
+		break;
+	}
+	return theResult;
+}
+
+#pragma mark - NSObject overridden methods
+
+- (NSString *)description { return [NSString stringWithFormat:@"%@ %@ (%lu rows, %lu null)", [super description], _name, (unsigned long)_count, (unsigned long)_nullCount]; }
+
+@end
+
+#pragma mark - NDJSONColumnarTable
+
+@interface NDJSONColumnarTable ()
+{
+	NSUInteger			_rowCount;
+	NSArray				* _columns;
+	NSDictionary		* _columnsForNames;
+}
+- (id)initWithRowCount:(NSUInteger)rowCount columns:(NSArray *)columns;
+@end
+
+@implementation NDJSONColumnarTable
+
+@synthesize		rowCount = _rowCount,
+				columns = _columns;
+
+- (NSArray *)columnNames { return [_columns valueForKey:@"name"]; }
+
+#pragma mark - creation and destruction
+
++ (NDJSONColumnarTable *)tableForJSONParser:(NDJSONParser *)aParser path:(NSString *)aPath options:(NDJSONOptionFlags)anOptions error:(NSError **)anError
+{
+	NDJSONColumnarTableBuilder	* theBuilder = [[NDJSONColumnarTableBuilder alloc] initWithPath:aPath];
+	NDJSONColumnarTable			* theResult = [[theBuilder tableForJSONParser:aParser options:anOptions error:anError] retain];
+	[theBuilder release];
+	return [theResult autorelease];
+}
+
+- (id)initWithRowCount:(NSUInteger)aRowCount columns:(NSArray *)aColumns
+{
+	if( (self = [super init]) != nil )
+	{
+		NSMutableDictionary		* theColumnsForNames = [[NSMutableDictionary alloc] initWithCapacity:aColumns.count];
+		for( NDJSONColumn * theColumn in aColumns )
+			[theColumnsForNames setObject:theColumn forKey:theColumn.name];
+		_rowCount = aRowCount;
+		_columns = [aColumns copy];
+		_columnsForNames = theColumnsForNames;
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[_columns release];
+	[_columnsForNames release];
+	[super dealloc];
+}
+
+- (NDJSONColumn *)columnForName:(NSString *)aName { return [_columnsForNames objectForKey:aName]; }
+
+#pragma mark - NSObject overridden methods
+
+- (NSString *)description { return [NSString stringWithFormat:@"%@ %lu rows %@", [super description], (unsigned long)_rowCount, self.columnNames]; }
+
+@end
+
+#pragma mark - NDJSONColumnarTableBuilder
+
+enum NDJSONColumnarRole
+{
+	NDJSONColumnarOnPath,				// a container on the path to the table
+	NDJSONColumnarTableArray,			// the array whose elements are the rows
+	NDJSONColumnarRow,
+	NDJSONColumnarIgnored
+};
+
+struct NDJSONColumnarLevel
+{
+	enum NDJSONColumnarRole		role;
+	BOOL						isArray;
+	NSUInteger					index;				// of the next element of an array
+};
+
+struct NDJSONColumnBuilder
+{
+	NSString					* name;
+	NDJSONColumnType			type;
+	uint8_t						* values,
+								* validity;
+	NSUInteger					capacity,			// rows the buffers have room for
+								validCount;
+	CFMutableDictionaryRef		stringIndexes;		// string to its index in strings
+	NSMutableArray				* strings;
+	BOOL						hasMixedTypes;
+};
+
+@interface NDJSONColumnarTableBuilder ()
+{
+	NSString						* _path;
+	NSArray							* _components;
+	NSUInteger						* _componentIndexes;	// array index each component matches, NSNotFound if none
+	NDJSONColumnarTable				* _table;
+	NSError							* _error;
+	struct NDJSONColumnarLevel		* _levels;
+	NSUInteger						_levelCount,
+									_levelSize;
+	struct NDJSONColumnBuilder		* _columns;
+	NSUInteger						_columnCount,
+									_columnSize;
+	CFMutableDictionaryRef			_columnIndexes;			// key to index of its column
+	NSUInteger						* _rowKeyColumns;		// column of each key of the last row, in order
+	NSUInteger						_rowKeyColumnSize,
+									_rowKeyPosition,
+									_rowCount,
+									_currentColumn;			// column of the value of the current key, NSNotFound if not in a row
+	BOOL							_keyMatches,
+									_foundTable;
+}
+@end
+
+@implementation NDJSONColumnarTableBuilder
+
+@synthesize		path = _path,
+				table = _table;
+
+#pragma mark - creation and destruction
+
+/*
+	the unescaped components of a JSON Pointer, nil if it is not one
+ */
+static NSArray * NDJSONColumnarPathComponents( NSString * aPath )
+{
+	NSMutableArray		* theResult = [NSMutableArray array];
+	if( aPath.length == 0 )
+		return theResult;
+	if( ![aPath hasPrefix:@"/"] )
+		return nil;
+	for( NSString * theComponent in [[aPath substringFromIndex:1] componentsSeparatedByString:@"/"] )
+		[theResult addObject:[[theComponent stringByReplacingOccurrencesOfString:@"~1" withString:@"/"] stringByReplacingOccurrencesOfString:@"~0" withString:@"~"]];
+	return theResult;
+}
+
+- (id)initWithPath:(NSString *)aPath
+{
+	if( (self = [super init]) != nil )
+	{
+		NSArray		* theComponents = NDJSONColumnarPathComponents( aPath );
+		if( theComponents == nil )
+		{
+			[self release];
+			return nil;
+		}
+		_path = [aPath copy];
+		_components = [theComponents retain];
+		_componentIndexes = malloc( (theComponents.count > 0 ? theComponents.count : 1)*sizeof(NSUInteger) );
+		for( NSUInteger i = 0; i < theComponents.count; i++ )
+		{
+			NSString	* theComponent = [theComponents objectAtIndex:i];
+			BOOL		theIsIndex = theComponent.length > 0 && [theComponent rangeOfCharacterFromSet:[[NSCharacterSet decimalDigitCharacterSet] invertedSet]].location == NSNotFound;
+			_componentIndexes[i] = theIsIndex ? (NSUInteger)[theComponent longLongValue] : NSNotFound;
+		}
+		_currentColumn = NSNotFound;
+	}
+	return self;
+}
+
+static void NDJSONColumnarFreeColumns( NDJSONColumnarTableBuilder * self )
+{
+	for( NSUInteger i = 0; i < self->_columnCount; i++ )
+	{
+		struct NDJSONColumnBuilder	* theColumn = &self->_columns[i];
+		[theColumn->name release];
+		free( theColumn->values );
+		free( theColumn->validity );
+		if( theColumn->stringIndexes != NULL )
+			CFRelease( theColumn->stringIndexes );
+		[theColumn->strings release];
+	}
+	self->_columnCount = 0;
+	if( self->_columnIndexes != NULL )
+		CFDictionaryRemoveAllValues( self->_columnIndexes );
+}
+
+- (void)dealloc
+{
+	NDJSONColumnarFreeColumns( self );
+	if( _columnIndexes != NULL )
+		CFRelease( _columnIndexes );
+	free( _columns );
+	free( _levels );
+	free( _rowKeyColumns );
+	free( _componentIndexes );
+	[_path release];
+	[_components release];
+	[_table release];
+	[_error release];
+	[super dealloc];
+}
+
+- (NDJSONColumnarTable *)tableForJSONParser:(NDJSONParser *)aParser options:(NDJSONOptionFlags)anOptions error:(NSError **)anError
+{
+	NDJSONColumnarTable		* theResult = nil;
+	id						theOriginalDelegate = aParser.delegate;
+	aParser.delegate = self;
+	if( [aParser parseWithOptions:anOptions] && _error == nil && _foundTable )
+		theResult = _table;
+	else if( anError != NULL )
+	{
+		if( _error != nil )
+			*anError = [[_error retain] autorelease];
+		else
+			*anError = NDJSONColumnarError( _foundTable ? @"JSON could not be parsed" : [NSString stringWithFormat:@"no array at %@", _path.length > 0 ? _path : @"the root"] );
+	}
+	aParser.delegate = theOriginalDelegate;
+	return theResult;
+}
+
+#pragma mark - columns
+
+static BOOL NDJSONColumnarReserveRows( struct NDJSONColumnBuilder * aColumn, NSUInteger aRowCount )
+{
+	if( aRowCount > aColumn->capacity )
+	{
+		NSUInteger		theCapacity = aColumn->capacity > 0 ? aColumn->capacity : kMinimumColumnCapacity,
+						theElementSize = NDJSONColumnElementSize( aColumn->type );
+		uint8_t			* theValidity = NULL;
+		while( theCapacity < aRowCount )
+			theCapacity <<= 1;
+		if( (theValidity = realloc( aColumn->validity, (theCapacity+7)>>3 )) == NULL )
+			return NO;
+		memset( theValidity+((aColumn->capacity+7)>>3), 0, ((theCapacity+7)>>3)-((aColumn->capacity+7)>>3) );
+		aColumn->validity = theValidity;
+		if( theElementSize > 0 )
+		{
+			uint8_t		* theValues = realloc( aColumn->values, theCapacity*theElementSize );
+			if( theValues == NULL )
+				return NO;
+			memset( theValues+aColumn->capacity*theElementSize, 0, (theCapacity-aColumn->capacity)*theElementSize );
+			aColumn->values = theValues;
+		}
+		aColumn->capacity = theCapacity;
+	}
+	return YES;
+}
+
+/*
+	the first value that is not null decides the type of the column, integers already in the column are converted if a float is found
+ */
+static BOOL NDJSONColumnarSetType( struct NDJSONColumnBuilder * aColumn, NDJSONColumnType aType )
+{
+	BOOL		theResult = YES;
+	if( aColumn->type == NDJSONColumnNull )
+	{
+		if( (aColumn->values = calloc( aColumn->capacity, NDJSONColumnElementSize( aType ) )) == NULL )
+			theResult = NO;
+		else
+			aColumn->type = aType;
+	}
+	else if( aColumn->type == NDJSONColumnInteger && aType == NDJSONColumnFloat )
+	{
+		int64_t		* theIntegers = (int64_t *)aColumn->values;
+		double		* theReals = (double *)aColumn->values;
+		for( NSUInteger i = 0; i < aColumn->capacity; i++ )
+			theReals[i] = (double)theIntegers[i];
+		aColumn->type = NDJSONColumnFloat;
+	}
+	else if( aColumn->type != aType && !(aColumn->type == NDJSONColumnFloat && aType == NDJSONColumnInteger) )
+		theResult = NO;
+	return theResult;
+}
+
+/*
+	the column of the current key with room for the current row and without a value for it, NULL if there is no current key
+ */
+static struct NDJSONColumnBuilder * NDJSONColumnarColumnForValue( NDJSONColumnarTableBuilder * self )
+{
+	struct NDJSONColumnBuilder	* theResult = NULL;
+	NSUInteger					theRow = self->_rowCount-1;
+	uint8_t						theBit = (uint8_t)(1<<(theRow&7));
+	if( self->_currentColumn == NSNotFound )
+		return NULL;
+	theResult = &self->_columns[self->_currentColumn];
+	self->_currentColumn = NSNotFound;
+	if( !NDJSONColumnarReserveRows( theResult, theRow+1 ) )
+	{
+		if( self->_error == nil )
+			self->_error = [NDJSONColumnarError( @"Memory failure" ) retain];
+		return NULL;
+	}
+	if( theResult->validity[theRow>>3] & theBit )			// a key repeated within the row, the last value is used
+	{
+		NSUInteger		theElementSize = NDJSONColumnElementSize( theResult->type );
+		theResult->validity[theRow>>3] &= (uint8_t)~theBit;
+		theResult->validCount--;
+		if( theElementSize > 0 )							// a null or a value of another type leaves the slot as for any null
+			memset( theResult->values+theRow*theElementSize, 0, theElementSize );
+	}
+	return theResult;
+}
+
+static void NDJSONColumnarSetValue( NDJSONColumnarTableBuilder * self, NDJSONColumnType aType, int64_t anInteger, double aReal, NSString * aString )
+{
+	struct NDJSONColumnBuilder	* theColumn = NDJSONColumnarColumnForValue( self );
+	NSUInteger					theRow = self->_rowCount-1;
+	if( theColumn == NULL || aType == NDJSONColumnNull )
+		return;
+	if( !NDJSONColumnarSetType( theColumn, aType ) )
+	{
+		theColumn->hasMixedTypes = YES;
+		return;
+	}
+	switch( theColumn->type )
+	{
+	case NDJSONColumnBool:
+		((BOOL *)theColumn->values)[theRow] = anInteger != 0;
+		break;
+	case NDJSONColumnInteger:
+		((int64_t *)theColumn->values)[theRow] = anInteger;
+		break;
+	case NDJSONColumnFloat:
+		((double *)theColumn->values)[theRow] = aType == NDJSONColumnInteger ? (double)anInteger : aReal;
+		break;
+	case NDJSONColumnString:
+	{
+		const void		* theIndex = NULL;
+		if( theColumn->stringIndexes == NULL )
+		{
+			theColumn->stringIndexes = CFDictionaryCreateMutable( kCFAllocatorDefault, 0, &kCFTypeDictionaryKeyCallBacks, NULL );
+			theColumn->strings = [[NSMutableArray alloc] init];
+		}
+		if( !CFDictionaryGetValueIfPresent( theColumn->stringIndexes, aString, &theIndex ) )
+		{
+			NSString	* theString = [aString copy];
+			theIndex = (const void *)(uintptr_t)theColumn->strings.count;
+			CFDictionarySetValue( theColumn->stringIndexes, theString, theIndex );
+			[theColumn->strings addObject:theString];
+			[theString release];
+		}
+		((uint32_t *)theColumn->values)[theRow] = (uint32_t)(uintptr_t)theIndex;
+		break;
+	}
+	default:
+		break;
+	}
+	theColumn->validity[theRow>>3] |= (uint8_t)(1<<(theRow&7));
+	theColumn->validCount++;
+}
+
+/*
+	the column for a key of the current row, rows usually have the same keys in the same order so the column of the key
+	in the same position of the last row is tried first
+ */
+static NSUInteger NDJSONColumnarColumnForKey( NDJSONColumnarTableBuilder * self, NSString * aKey )
+{
+	NSUInteger		thePosition = self->_rowKeyPosition++,
+					theResult = NSNotFound;
+	const void		* theIndex = NULL;
+	if( thePosition < self->_rowKeyColumnSize && self->_rowKeyColumns[thePosition] < self->_columnCount )
+	{
+		NSString	* theName = self->_columns[self->_rowKeyColumns[thePosition]].name;
+		if( theName == aKey || [theName isEqualToString:aKey] )
+			return self->_rowKeyColumns[thePosition];
+	}
+	if( self->_columnIndexes == NULL )
+		self->_columnIndexes = CFDictionaryCreateMutable( kCFAllocatorDefault, 0, &kCFTypeDictionaryKeyCallBacks, NULL );
+	if( CFDictionaryGetValueIfPresent( self->_columnIndexes, aKey, &theIndex ) )
+		theResult = (NSUInteger)(uintptr_t)theIndex;
+	else
+	{
+		if( self->_columnCount >= self->_columnSize )
+		{
+			self->_columnSize = self->_columnSize > 0 ? self->_columnSize*2 : 16;
+			self->_columns = realloc( self->_columns, self->_columnSize*sizeof(*self->_columns) );
+			NSCAssert( self->_columns != NULL, @"Memory failure" );
+		}
+		theResult = self->_columnCount++;
+		memset( &self->_columns[theResult], 0, sizeof(self->_columns[theResult]) );
+		self->_columns[theResult].name = [aKey copy];
+		CFDictionarySetValue( self->_columnIndexes, self->_columns[theResult].name, (const void *)(uintptr_t)theResult );
+	}
+	if( thePosition >= self->_rowKeyColumnSize )
+	{
+		NSUInteger		theSize = self->_rowKeyColumnSize > 0 ? self->_rowKeyColumnSize*2 : 16;
+		self->_rowKeyColumns = realloc( self->_rowKeyColumns, theSize*sizeof(NSUInteger) );
+		NSCAssert( self->_rowKeyColumns != NULL, @"Memory failure" );
+		for( NSUInteger i = self->_rowKeyColumnSize; i < theSize; i++ )
+			self->_rowKeyColumns[i] = NSNotFound;
+		self->_rowKeyColumnSize = theSize;
+	}
+	self->_rowKeyColumns[thePosition] = theResult;
+	return theResult;
+}
+
+#pragma mark - structure
+
+/*
+	what the value starting now is, from its parent
+ */
+static enum NDJSONColumnarRole NDJSONColumnarRoleForNewValue( NDJSONColumnarTableBuilder * self, BOOL anIsArray )
+{
+	enum NDJSONColumnarRole		theResult = NDJSONColumnarIgnored;
+	NSUInteger					theDepth = self->_levelCount,
+								thePathLength = self->_components.count;
+	if( theDepth == 0 )
+	{
+		if( thePathLength > 0 )
+			theResult = NDJSONColumnarOnPath;
+		else
+			theResult = anIsArray ? NDJSONColumnarTableArray : NDJSONColumnarRow;
+	}
+	else
+	{
+		struct NDJSONColumnarLevel	* theParent = &self->_levels[theDepth-1];
+		BOOL						theMatches = NO;
+		NSUInteger					theIndex = theParent->isArray ? theParent->index++ : NSNotFound;
+		switch( theParent->role )
+		{
+		case NDJSONColumnarOnPath:
+			theMatches = theParent->isArray ? self->_componentIndexes[theDepth-1] == theIndex : self->_keyMatches;
+			if( theMatches )
+				theResult = theDepth < thePathLength ? NDJSONColumnarOnPath : (anIsArray ? NDJSONColumnarTableArray : NDJSONColumnarIgnored);
+			break;
+		case NDJSONColumnarTableArray:
+			theResult = anIsArray ? NDJSONColumnarIgnored : NDJSONColumnarRow;
+			break;
+		default:
+			break;
+		}
+	}
+	return theResult;
+}
+
+static void NDJSONColumnarStartContainer( NDJSONColumnarTableBuilder * self, BOOL anIsArray )
+{
+	enum NDJSONColumnarRole		theRole = NDJSONColumnarRoleForNewValue( self, anIsArray );
+	if( self->_levelCount > 0 && self->_levels[self->_levelCount-1].role == NDJSONColumnarRow )
+	{
+		struct NDJSONColumnBuilder	* theColumn = NDJSONColumnarColumnForValue( self );
+		if( theColumn != NULL )
+			theColumn->hasMixedTypes = YES;				// nested values are not columns
+	}
+	if( theRole == NDJSONColumnarTableArray )
+		self->_foundTable = YES;
+	else if( theRole == NDJSONColumnarRow )
+	{
+		self->_foundTable = YES;
+		self->_rowCount++;
+		self->_rowKeyPosition = 0;
+	}
+	if( self->_levelCount >= self->_levelSize )
+	{
+		self->_levelSize = self->_levelSize > 0 ? self->_levelSize*2 : 16;
+		self->_levels = realloc( self->_levels, self->_levelSize*sizeof(*self->_levels) );
+		NSCAssert( self->_levels != NULL, @"Memory failure" );
+	}
+	self->_levels[self->_levelCount].role = theRole;
+	self->_levels[self->_levelCount].isArray = anIsArray;
+	self->_levels[self->_levelCount].index = 0;
+	self->_levelCount++;
+}
+
+static void NDJSONColumnarFoundScalar( NDJSONColumnarTableBuilder * self, NDJSONColumnType aType, int64_t anInteger, double aReal, NSString * aString )
+{
+	if( self->_levelCount > 0 )
+	{
+		struct NDJSONColumnarLevel	* theParent = &self->_levels[self->_levelCount-1];
+		if( theParent->role == NDJSONColumnarRow )
+			NDJSONColumnarSetValue( self, aType, anInteger, aReal, aString );
+		else if( theParent->isArray )
+			theParent->index++;
+	}
+}
+
+#pragma mark - NDJSONParserDelegate methods
+
+- (void)jsonParserDidStartDocument:(NDJSONParser *)aJSON
+{
+	NDJSONColumnarFreeColumns( self );
+	_levelCount = 0;
+	_rowCount = 0;
+	_rowKeyPosition = 0;
+	for( NSUInteger i = 0; i < _rowKeyColumnSize; i++ )
+		_rowKeyColumns[i] = NSNotFound;
+	_currentColumn = NSNotFound;
+	_foundTable = NO;
+	[_table release], _table = nil;
+	[_error release], _error = nil;
+}
+
+- (void)jsonParserDidEndDocument:(NDJSONParser *)aJSON
+{
+	NSMutableArray		* theColumns = [[NSMutableArray alloc] initWithCapacity:_columnCount];
+	for( NSUInteger i = 0; i < _columnCount && _error == nil; i++ )
+	{
+		struct NDJSONColumnBuilder	* theBuilder = &_columns[i];
+		NSUInteger					theElementSize = NDJSONColumnElementSize( theBuilder->type );
+		NSData						* theValues = nil,
+									* theValidity = nil;
+		NDJSONColumn				* theColumn = nil;
+		if( !NDJSONColumnarReserveRows( theBuilder, _rowCount ) )
+		{
+			_error = [NDJSONColumnarError( @"Memory failure" ) retain];
+			break;
+		}
+		if( theElementSize > 0 && theBuilder->values != NULL )
+			theValues = [[NSData alloc] initWithBytesNoCopy:theBuilder->values length:_rowCount*theElementSize freeWhenDone:YES];
+		else
+		{
+			free( theBuilder->values );
+			theValues = [[NSData alloc] init];
+		}
+		if( theBuilder->validity != NULL )
+			theValidity = [[NSData alloc] initWithBytesNoCopy:theBuilder->validity length:(_rowCount+7)>>3 freeWhenDone:YES];
+		else
+			theValidity = [[NSData alloc] init];
+		theBuilder->values = NULL;						// the buffers now belong to the NSData
+		theBuilder->validity = NULL;
+		theColumn = [[NDJSONColumn alloc] initWithName:theBuilder->name type:theBuilder->type count:_rowCount values:theValues validity:theValidity nullCount:_rowCount-theBuilder->validCount dictionary:theBuilder->type == NDJSONColumnString ? theBuilder->strings : nil hasMixedTypes:theBuilder->hasMixedTypes];
+		[theColumns addObject:theColumn];
+		[theColumn release];
+		[theValues release];
+		[theValidity release];
+	}
+	if( _error == nil )
+		_table = [[NDJSONColumnarTable alloc] initWithRowCount:_rowCount columns:theColumns];
+	[theColumns release];
+	NDJSONColumnarFreeColumns( self );
+}
+
+- (void)jsonParserDidStartArray:(NDJSONParser *)aJSON { NDJSONColumnarStartContainer( self, YES ); }
+- (void)jsonParserDidEndArray:(NDJSONParser *)aJSON { if( _levelCount > 0 ) _levelCount--; }
+- (void)jsonParserDidStartObject:(NDJSONParser *)aJSON { NDJSONColumnarStartContainer( self, NO ); }
+- (void)jsonParserDidEndObject:(NDJSONParser *)aJSON { if( _levelCount > 0 ) _levelCount--; }
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundKey:(NSString *)aValue
+{
+	struct NDJSONColumnarLevel	* theParent = _levelCount > 0 ? &_levels[_levelCount-1] : NULL;
+	_currentColumn = NSNotFound;
+	_keyMatches = NO;
+	if( theParent != NULL && theParent->role == NDJSONColumnarRow )
+		_currentColumn = NDJSONColumnarColumnForKey( self, aValue );
+	else if( theParent != NULL && theParent->role == NDJSONColumnarOnPath )
+		_keyMatches = [[_components objectAtIndex:_levelCount-1] isEqualToString:aValue];
+}
+
+/*
+	only the path to the table and the values of the rows need to be parsed
+ */
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldSkipValueForKey:(NSString *)aKey
+{
+	enum NDJSONColumnarRole		theRole = _levelCount > 0 ? _levels[_levelCount-1].role : NDJSONColumnarIgnored;
+	return theRole == NDJSONColumnarIgnored || (theRole == NDJSONColumnarOnPath && !_keyMatches);
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundString:(NSString *)aValue { NDJSONColumnarFoundScalar( self, NDJSONColumnString, 0, 0.0, aValue ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundInteger:(NSInteger)aValue { NDJSONColumnarFoundScalar( self, NDJSONColumnInteger, aValue, 0.0, nil ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundFloat:(double)aValue { NDJSONColumnarFoundScalar( self, NDJSONColumnFloat, 0, aValue, nil ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundBool:(BOOL)aValue { NDJSONColumnarFoundScalar( self, NDJSONColumnBool, aValue, 0.0, nil ); }
+- (void)jsonParserFoundNULL:(NDJSONParser *)aJSON { NDJSONColumnarFoundScalar( self, NDJSONColumnNull, 0, 0.0, nil ); }
+
+- (void)jsonParser:(NDJSONParser *)aJSON error:(NSError *)anError
+{
+	if( _error == nil )
+		_error = [anError retain];
+}
+
+@end
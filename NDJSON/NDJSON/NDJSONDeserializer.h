@@ -27,6 +27,10 @@
 #import <Foundation/Foundation.h>
 #import "NDJSONParser.h"
 
+@class		NDJSONSchemaValidator,
+			NDJSONDeserializerConfiguration,
+			NDJSONShapeProfile;
+
 extern NSString		* const NDJSONBadCollectionClassException;
 extern NSString		* const NDJSONUnrecongnisedPropertyNameException;
 
@@ -50,7 +54,7 @@ enum {
  */
 	NDJSONOptionConvertRemoveIsAdjective = 1<<18,
 /**
-	If a parsed JSON primative doesn't match the destination property type, this option tell NDJSONDeserializer to attempt to convert it.
+	If a parsed JSON primative doesn't match the destination property type, this option tell NDJSONDeserializer to attempt to convert it. NSDate properties are converted from strings and numbers as given by NDJSONDateFormat. Strings for NSData properties are base64 decoded by the parser straight into the NSData, unless the class implements a set<Property>ByConvertingString: method.
  */
 	NDJSONOptionCovertPrimitiveJSONTypes = 1<<19,
 /**
@@ -61,6 +65,18 @@ enum {
 	If this flag is set, when an none array is generated from the JSON but the recieving property expects an NSArray, NSSet, NSOrderedSet, then the generated object is wrapped in the expected type.
  */
 	NDJSONOptionConvertToArrayTypeIfRequired = 1<<21,
+/**
+	If this flag is set, when generating custom classes a table of the keys each class can accept is built and given to NDJSONParser, so known keys are matched directly from the JSON bytes to their property name without creating a new NSString or converting the key each time.
+ */
+	NDJSONOptionUseKeyTables = 1<<22,
+/**
+	If this flag is set, decoders generated with ndjson-codegen and registered with NDJSONRegisterGeneratedDecoder are not used, custom classes are always generated by querying the Objective-C runtime.
+ */
+	NDJSONOptionDontUseGeneratedDecoders = 1<<23,
+/**
+	If this flag is set, the number of elements of each array and dictionary created is recorded by its key path in the shapeProfile of the deserializer, and new arrays and dictionaries are created with the capacity of earlier ones at the same key path, instead of growing as their elements are added. Only containers of classes that implement both initWithCapacity: and count are presized.
+ */
+	NDJSONOptionPresizeContainers = 1<<24,
 
 /**
 	All options excluding the options used to deal with problematic JSON, NDJSONOptionIgnoreUnknownProperties, NDJSONOptionConvertToArrayTypeIfRequired
@@ -94,6 +110,26 @@ enum {
 */
 @property(assign,nonatomic)		id<NDJSONDeserializerDelegate>		delegate;
 
+/**
+	Statistics given to the parser for each call to objectForJSON:options:error:, the time the parser spends in delegate methods is the time spent building the result. Only collected if NDJSON is compiled with NDJSONCollectStatistics defined.
+ */
+@property(retain,nonatomic)		NDJSONParseStatistics				* statistics;
+
+/**
+	Validates each document against its schema as it is deserialized, by default the first violation aborts parsing and objectForJSON:options:error: returns nil with the NDJSONSchemaErrorDomain error. The default is nil.
+ */
+@property(retain,nonatomic)		NDJSONSchemaValidator				* schemaValidator;
+
+/**
+	The shared configuration the deserializer was created with, nil if it was not created with initWithConfiguration:
+ */
+@property(readonly,nonatomic)	NDJSONDeserializerConfiguration		* configuration;
+
+/**
+	The container sizes learnt with NDJSONOptionPresizeContainers, kept between documents so each document is created with the sizes seen in the ones before it. Initially the shapeProfile of the configuration, otherwise a new profile is created the first time NDJSONOptionPresizeContainers is used, a profile can be set to share it with other deserializers.
+ */
+@property(retain,nonatomic)		NDJSONShapeProfile					* shapeProfile;
+
 /**
  Resulting error
  */
@@ -113,6 +149,11 @@ enum {
  */
 - (id)initWithRootClass:(Class)rootClass rootCollectionClass:(Class)rootCollectionClass initialParent:(id)parent;
 
+/**
+	initalize with the root classes of a shared configuration, the tables built for each class are kept by the configuration and shared with every other deserializer created with it, so creating a deserializer for each parse or thread is cheap.
+ */
+- (id)initWithConfiguration:(NDJSONDeserializerConfiguration *)configuration;
+
 /**
 	return the root object generted from the parsers output.
  */
@@ -129,6 +170,60 @@ enum {
 
 @end
 
+/**
+	NDJSONDeserializerConfiguration holds what stays the same from parse to parse, the root classes and options, and caches the key tables NDJSONDeserializer builds for each class. A NDJSONDeserializer has to keep the state of the document it is parsing and so can only be used by one thread at a time, a configuration is immutable and can be shared by any number of threads, each creating its own deserializer with -deserializer.
+ */
+@interface NDJSONDeserializerConfiguration : NSObject <NSCopying>
+
++ (NDJSONDeserializerConfiguration *)configurationWithRootClass:(Class)rootClass rootCollectionClass:(Class)rootCollectionClass options:(NDJSONOptionFlags)options;
+/**
+	rootClass and rootCollectionClass are used as by -[NDJSONDeserializer initWithRootClass:rootCollectionClass:], a rootClass of Nil generates property list objects.
+ */
+- (id)initWithRootClass:(Class)rootClass rootCollectionClass:(Class)rootCollectionClass options:(NDJSONOptionFlags)options;
+
+@property(readonly,nonatomic)	Class				rootClass;
+@property(readonly,nonatomic)	Class				rootCollectionClass;
+/**
+	the options used by objectForJSONData:encoding:error: and objectsForJSONDataArray:encoding:errors:
+ */
+@property(readonly,nonatomic)	NDJSONOptionFlags	options;
+/**
+	the profile given to every deserializer created with the configuration, nil unless options includes NDJSONOptionPresizeContainers.
+ */
+@property(readonly,nonatomic)	NDJSONShapeProfile	* shapeProfile;
+
+/**
+	returns a new deserializer sharing the configurations class tables.
+ */
+- (NDJSONDeserializer *)deserializer;
+
+/**
+	decode a single JSON document with a new deserializer.
+ */
+- (id)objectForJSONData:(NSData *)data encoding:(NSStringEncoding)encoding error:(NSError **)error;
+/**
+	decode each NSData of dataArray as a separate JSON document, the documents are decoded concurrently on as many threads as there are active processors. The result contains the object for each document in the same order as dataArray, with NSNull for the documents that could not be decoded. If errors is not NULL it is set to an array of the same length with the error for each document that failed and NSNull for the ones that did not.
+ */
+- (NSArray *)objectsForJSONDataArray:(NSArray *)dataArray encoding:(NSStringEncoding)encoding errors:(NSArray **)errors;
+
+@end
+
+/**
+	NDJSONShapeProfile keeps the number of elements of the arrays and dictionaries created by NDJSONDeserializer, by their key path, as a running average weighted to the most recent. Documents of the same kind have containers of about the same size at the same key path, so the average is the capacity to create the next one with. Key paths are kept by their hash in a table of fixed size, two paths with the same slot in the table replace each others size, which only means a container that is created too big or too small. Updates are not locked, a profile can be shared by deserializers on different threads at the cost of some counts being lost.
+ */
+@interface NDJSONShapeProfile : NSObject
+
+/**
+	the capacity expected for the container at keyPath, the keys from the root value, with NSNull for the elements of an array, an empty keyPath is the root value. Returns 0 if no container has been recorded for keyPath.
+ */
+- (NSUInteger)expectedCountForKeyPath:(NSArray *)keyPath;
+/**
+	forget every recorded size, should not be used while a deserializer is using the profile.
+ */
+- (void)removeAllCounts;
+
+@end
+
 /**
  The NDJSONDeserializerDelegate protocol defines the optional methods implemented by delegates of NSURLConnection objects.
  
@@ -142,6 +237,27 @@ enum {
 - (id)jsonDeserializer:(NDJSONDeserializer *)jsonDeserializer objectForClass:(Class)aClass propertName:(NSString *)property;
 @end
 
+/**
+	How NSDate properties are converted from JSON values with NDJSONOptionCovertPrimitiveJSONTypes, a class can give the formats for each of its properties with dateFormatsForPropertyNamesWithJSONDeserializer:, otherwise NDJSONDateFormatDefault is used. Values the formats do not accept, and strings for properties with a set<Property>ByConvertingString: method, are converted as before.
+ */
+typedef NS_OPTIONS(NSUInteger, NDJSONDateFormat)
+{
+	NDJSONDateFormatNone = 0,
+/**
+	RFC 3339 strings and the common ISO 8601 variations of them, a date YYYY-MM-DD, optionally followed by T or a space and the time hh:mm with optional seconds and fraction, and an offset Z, ±hh:mm, ±hhmm or ±hh, a date time without an offset is UTC.
+ */
+	NDJSONDateFormatISO8601 = 1<<0,
+/**
+	numbers of seconds since 1970-01-01 00:00:00 UTC
+ */
+	NDJSONDateFormatEpochSeconds = 1<<1,
+/**
+	numbers of milliseconds since 1970-01-01 00:00:00 UTC, takes precedence over NDJSONDateFormatEpochSeconds
+ */
+	NDJSONDateFormatEpochMilliseconds = 1<<2,
+	NDJSONDateFormatDefault = NDJSONDateFormatISO8601|NDJSONDateFormatEpochSeconds
+};
+
 /**
 	NSObject+NDJSONDeserializer is an informal protocol for methods that objects which can be generated from parsing can implement to control how parsing of child onjects and arrays.
 	*NDJSONDeserializer* can determine the class types for properties at runtime, but the methods of NSObject+NDJSONDeserializer can be used to override this behavor or help in situations where the type information is not available, for exmaple the class types used for the elements in a JSON array or if the type is *id*.
@@ -171,6 +287,11 @@ enum {
  */
 + (NSDictionary *)propertyNamesWithJSONDeserializer:(NDJSONDeserializer *)aDeserializer;
 
+/**
+	return a dictionary of NSNumbers of NDJSONDateFormat for NSDate property names, properties not in the dictionary use NDJSONDateFormatDefault.
+ */
++ (NSDictionary *)dateFormatsForPropertyNamesWithJSONDeserializer:(NDJSONDeserializer *)aDeserializer;
+
 /*
 	return the property name for the objects index, this property will be set for obejcts added to collections.
  */
@@ -242,6 +363,16 @@ enum {
 	return kNamesForKeys; \
 }
 
+/**
+ implements the class method `+[NSObject dateFormatsForPropertyNamesWithJSONDeserializer:]` returning a dictionary with the supplied arguemnts.
+ */
+#define NDJSONDateFormatsForPropertyNames(...) \
++ (NSDictionary *)dateFormatsForPropertyNamesWithJSONDeserializer:(NDJSONDeserializer *)aParser { \
+	static NSDictionary     * kDateFormatsForPropertyName = nil; \
+	if( kDateFormatsForPropertyName == nil ) kDateFormatsForPropertyName = [[NSDictionary alloc] initWithObjectsAndKeys:__VA_ARGS__, nil]; \
+	return kDateFormatsForPropertyName; \
+}
+
 /**
  implements the class method `+[NSObject indexPropertyNameWithJSONDeserializer:]` returning the string upplied arguemnts.
  */
@@ -256,6 +387,33 @@ enum {
 + (NSString *)parentPropertyNameWithJSONDeserializer:(NDJSONDeserializer *)aParser { return _SELECTOR_NAME_; }
 
 
+/**
+	A decoder for one model class generated ahead of time by the ndjson-codegen tool, the answers NDJSONDeserializer would otherwise get from the Objective-C runtime and the NSObject+NDJSONDeserializer methods for the class are compiled in. Each known key is matched with a switch on its bytes, values are stored by sending the setter directly instead of using key value coding, and the classes to create for properties are fixed.
+
+	Generated decoders register themselves when they are loaded and are used by NDJSONDeserializer for instances of exactly that class, unless the options include NDJSONOptionDontUseGeneratedDecoders or the key conversion options differ from keyOptions. Anything a decoder can not answer, an unknown key or a value of an unexpected type, falls back to the runtime.
+ */
+struct NDJSONGeneratedDecoder
+{
+	NSUInteger					count;
+	NSString * const			* keys;									// JSON key of each property index
+	NSString * const			* propertyNames;
+	const BOOL					* skipValues;
+	NSUInteger					keyOptions;								// NDJSONOptionConvertKeysToMedialCapitals and NDJSONOptionConvertRemoveIsAdjective as generated
+	NSUInteger					(*indexForKey)( const char * key, NSUInteger length );
+	BOOL						(*setValue)( id object, NSUInteger index, id value );		// NO if value is not of the type the property expects
+	Class						(*classForIndex)( NSUInteger index );					// Nil to ask the runtime
+	Class						(*collectionClassForIndex)( NSUInteger index );			// Nil to ask the runtime
+};
+
+/**
+	register a generated decoder for a class, decoder must remain valid, generated code calls this from +load.
+ */
+void NDJSONRegisterGeneratedDecoder( Class modelClass, const struct NDJSONGeneratedDecoder * decoder );
+/**
+	returns the decoder registered for modelClass or NULL.
+ */
+const struct NDJSONGeneratedDecoder * NDJSONGeneratedDecoderForClass( Class modelClass );
+
 /*
  Private subclass of NDJSONDeserializer used for subclassing by NDJSONCoreDataDeserializer
  */
@@ -268,3 +426,8 @@ enum {
  */
 void NDJSONPushContainerForJSONDeserializer( NDJSONDeserializer * self, id container, BOOL isObject );
 
+/*
+ Private function used by ndjson-codegen to convert keys to property names as NDJSONDeserializer does
+ */
+NSString * NDJSONStringByConvertingPropertyName( NSString * string, BOOL removeIs, BOOL convertToCamelCase );
+
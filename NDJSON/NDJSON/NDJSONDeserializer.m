@@ -25,14 +25,20 @@
  */
 
 #import "NDJSONDeserializer.h"
+#import "NDJSONSchemaValidator.h"
+#import "NDJSONMulticastDelegate.h"
 #import <objc/runtime.h> 
+#include <pthread.h>
 
 struct NDContainerStackStruct
 {
 	NSString	* propertyName;
 	NSString	* key;
+	NSUInteger	propertyIndex;
 	id			container;
-	BOOL		isObject;
+	uint64_t	pathHash;				// hash of the key path of the container, when presizing containers
+	BOOL		isObject,
+				recordCount;			// the number of elements of container is recorded in the shape profile
 };
 
 struct NDClassesDesc
@@ -106,6 +112,27 @@ static Class NDMutableClassForClass( Class aClass )
 
 void NDJSONPushContainerForJSONDeserializer( NDJSONDeserializer * self, id container, BOOL isObject );
 static id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * self );
+static NSUInteger NDJSONExpectedCountForNextContainer( NDJSONDeserializer * self, BOOL aRecordCount );
+static void NDJSONReleaseContainerStack( NDJSONDeserializer * self );
+
+/*
+	key table for a class, with the property name and whether to skip the value, for each key
+ */
+@interface NDJSONPropertyKeyTable : NDJSONKeyTable
+{
+	NSArray									* _propertyNames;
+	BOOL									* _skipValue;
+	const struct NDJSONGeneratedDecoder		* _decoder;
+}
+- (id)initWithKeys:(NSArray *)keys propertyNames:(NSArray *)propertyNames skipValues:(const BOOL *)skipValues;
+/*
+	the key indexes are the property indexes of decoder
+ */
+- (id)initWithGeneratedDecoder:(const struct NDJSONGeneratedDecoder *)decoder;
+@property(readonly,nonatomic)	const struct NDJSONGeneratedDecoder		* decoder;
+- (NSString *)propertyNameAtIndex:(NSUInteger)index;
+- (BOOL)shouldSkipValueAtIndex:(NSUInteger)index;
+@end
 
 @interface NDJSONDeserializer ()
 {
@@ -117,6 +144,7 @@ static id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * sel
 		struct NDContainerStackStruct			* bytes;
 	}										_containerStack;
 	NSString								* _currentProperty;
+	NSUInteger								_currentPropertyIndex;				// index of _currentProperty in a generated decoder
 	NSString								* _currentKey;
 	struct
 	{
@@ -126,6 +154,8 @@ static id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * sel
 		int										convertPrimativeJSONTypes					: 1;
 		int										dontSendAwakeFromDeserializationMessages	: 1;
 		int										convertToArrayTypeIfRequired				: 1;
+		int										useKeyTables								: 1;
+		int										presizeContainers							: 1;
 	}										_options;
 	id										_result;
 	__weak id<NDJSONDeserializerDelegate>	_delegate;
@@ -140,6 +170,7 @@ static id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * sel
 												shouldSkipValueForKey,
 												foundKey,
 												foundString,
+												foundData,
 												foundNumber,
 												foundInteger,
 												foundFloat,
@@ -149,6 +180,16 @@ static id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * sel
 												objectForClass;
 	}										_delegateMethod;
 	NSError									* _error;
+	NDJSONParseStatistics					* _statistics;
+	NDJSONSchemaValidator					* _schemaValidator;
+	NDJSONDeserializerConfiguration			* _configuration;
+	NDJSONShapeProfile						* _shapeProfile;
+	NSMutableDictionary						* _dataPropertyNamesForClasses;		// NSData properties base64 decoded by the parser for each class
+	struct
+	{
+		uint64_t								pathHash;
+		BOOL									recordCount;
+	}										_nextContainer;						// set before a container is created for NDJSONPushContainerForJSONDeserializer
 }
 
 @property(readonly,nonatomic)			id			currentContainer;
@@ -165,6 +206,12 @@ static id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * sel
 	Class				rootClass,
 						rootCollectionClass;
 	NSMutableArray		* _objectThatRespondToAwakeFromDeserialization;
+	NSMutableDictionary	* _keyTablesForClasses;
+	NSUInteger			_keyTablesOptions;
+	BOOL				_sharesKeyTables;
+	NSUInteger			_generatedDecoderKeyOptions;
+	Class				_decoderClass;						// the last class looked up and its decoder
+	const struct NDJSONGeneratedDecoder	* _decoder;
 }
 
 - (struct NDClassesDesc)classForPropertyName:(NSString *)name parentClass:(Class)class;
@@ -172,12 +219,78 @@ static id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * sel
 
 @end
 
+/*
+	the key tables are built by whichever thread first needs them and then shared, NDJSONPropertyKeyTable is immutable once created
+ */
+@interface NDJSONDeserializerConfiguration ()
+{
+	Class					_rootClass,
+							_rootCollectionClass;
+	NDJSONOptionFlags		_options;
+	pthread_mutex_t			_keyTablesLock;
+	CFMutableDictionaryRef	_keyTablesForClasses;
+	NDJSONShapeProfile		* _shapeProfile;
+}
+@end
+
+static NDJSONPropertyKeyTable * NDJSONSharedKeyTableForClass( NDJSONDeserializerConfiguration * aConfiguration, NDJSONCustomDeserializer * aDeserializer, Class aClass );
+
+/*
+	each entry is the top 40 bits of the hash of a key path, with the top bit set so an entry is never 0, and the average count times 16 in the bottom 24 bits
+ */
+#define kShapeProfileSize			4096
+static const NSUInteger		kShapeMaximumCount = (1<<20)-1;
+static const uint64_t		kShapeRootPathHash = 0xcbf29ce484222325ULL,
+							kShapeArrayElementHash = 0x9e3779b97f4a7c15ULL;
+
+@interface NDJSONShapeProfile ()
+{
+@public
+	uint64_t		* _entries;
+}
+@end
+
+static inline uint64_t NDJSONShapePathHash( uint64_t aParentHash, NSString * aKey )
+{
+	uint64_t	theHash = aParentHash * 0x100000001b3ULL ^ (aKey != nil ? (uint64_t)[aKey hash] : kShapeArrayElementHash);
+	theHash ^= theHash >> 33;
+	theHash *= 0xff51afd7ed558ccdULL;
+	return theHash ^ (theHash >> 33);
+}
+
+static inline uint64_t NDJSONShapeTag( uint64_t aPathHash ) { return (aPathHash >> 24) | (1ULL << 39); }
+
+static NSUInteger NDJSONShapeProfileExpectedCount( NDJSONShapeProfile * self, uint64_t aPathHash )
+{
+	uint64_t	theEntry = __atomic_load_n( &self->_entries[aPathHash&(kShapeProfileSize-1)], __ATOMIC_RELAXED );
+	return (theEntry >> 24) == NDJSONShapeTag(aPathHash) ? (NSUInteger)((theEntry&0xFFFFFF)+15)/16 : 0;
+}
+
+/*
+	the average moves a quarter of the way to each new count
+ */
+static void NDJSONShapeProfileRecordCount( NDJSONShapeProfile * self, uint64_t aPathHash, NSUInteger aCount )
+{
+	uint64_t	* theEntryPtr = &self->_entries[aPathHash&(kShapeProfileSize-1)],
+				theEntry = __atomic_load_n( theEntryPtr, __ATOMIC_RELAXED ),
+				theTag = NDJSONShapeTag(aPathHash);
+	int64_t		theAverage = (int64_t)MIN(aCount, kShapeMaximumCount)*16;
+	if( (theEntry >> 24) == theTag )
+		theAverage = (int64_t)(theEntry&0xFFFFFF) + (theAverage - (int64_t)(theEntry&0xFFFFFF))/4;
+	if( (theTag << 24 | (uint64_t)theAverage) != theEntry )			// don't dirty a cache line shared with other threads for nothing
+		__atomic_store_n( theEntryPtr, theTag << 24 | (uint64_t)theAverage, __ATOMIC_RELAXED );
+}
+
 #pragma mark - NDJSONDeserializer implementation
 @implementation NDJSONDeserializer
 
 @synthesize			delegate = _delegate,
 					currentProperty = _currentProperty,
-					error = _error;
+					error = _error,
+					statistics = _statistics,
+					schemaValidator = _schemaValidator,
+					configuration = _configuration,
+					shapeProfile = _shapeProfile;
 
 #pragma mark - manually implemented properties
 
@@ -186,6 +299,12 @@ static id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * sel
 
 - (NSManagedObjectContext *)managedObjectContext { return nil; }
 
+- (void)setCurrentProperty:(NSString *)aProperty
+{
+	[_currentProperty release], _currentProperty = [aProperty copy];
+	_currentPropertyIndex = NSNotFound;
+}
+
 - (void)setDelegate:(id<NDJSONDeserializerDelegate>)aDelegate
 {
 	_delegate = aDelegate;
@@ -205,17 +324,33 @@ static id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * sel
 	return [[NDJSONCustomDeserializer alloc] initWithRootClass:aRootClass rootCollectionClass:aRootCollectionClass initialParent:aParent];
 }
 
-- (void)dealloc
+- (id)initWithConfiguration:(NDJSONDeserializerConfiguration *)aConfiguration
 {
-	for( NSUInteger i = 0; i < _containerStack.count; i++ )
+	NSParameterAssert( aConfiguration != nil );
+	if( aConfiguration.rootClass != Nil )
 	{
-		[_containerStack.bytes[i].propertyName release];
-		[_containerStack.bytes[i].key release];
-		[_containerStack.bytes[i].container release];
+		[self release];
+		return [[NDJSONCustomDeserializer alloc] initWithConfiguration:aConfiguration];
 	}
+	if( (self = [super init]) != nil )
+	{
+		_configuration = [aConfiguration retain];
+		_shapeProfile = [aConfiguration.shapeProfile retain];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	NDJSONReleaseContainerStack( self );
 	[_currentProperty release];
 	[_currentKey release];
 	[_result autorelease];
+	[_statistics release];
+	[_schemaValidator release];
+	[_configuration release];
+	[_shapeProfile release];
+	[_dataPropertyNamesForClasses release];
 	free(_containerStack.bytes);
 	[super dealloc];
 }
@@ -223,60 +358,68 @@ static id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * sel
 #pragma mark - parsing methods
 - (id)objectForJSON:(NDJSONParser *)aJSON options:(NDJSONOptionFlags)anOptions error:(NSError **)anError
 {
-	id		theResult = nil;
-	id		theOriginalDelegate = aJSON.delegate;
+	id						theResult = nil;
+	id						theOriginalDelegate = aJSON.delegate;
+	id						theParserDelegate = _schemaValidator != nil ? (id)_schemaValidator : (id)self;
+	NDJSONParseStatistics	* theOriginalStatistics = aJSON.statistics;
 	NSAssert( aJSON != nil, @"nil JSON parser" );
-	aJSON.delegate = self;
+	_schemaValidator.delegate = self;
+	if( [theOriginalDelegate isKindOfClass:[NDJSONMulticastDelegate class]] && [theOriginalDelegate containsDelegate:theParserDelegate] )
+		theParserDelegate = theOriginalDelegate;			// the other delegates are sent the same events
+	if( theOriginalDelegate != theParserDelegate )
+		aJSON.delegate = theParserDelegate;
+	if( _statistics != nil )
+		aJSON.statistics = _statistics;
 	_options.ignoreUnknownPropertyName = anOptions&NDJSONOptionIgnoreUnknownProperties ? YES : NO;
 	_options.convertKeysToMedialCapital = anOptions&NDJSONOptionConvertKeysToMedialCapitals ? YES : NO;
 	_options.removeIsAdjective = anOptions&NDJSONOptionConvertRemoveIsAdjective ? YES : NO;
 	_options.convertPrimativeJSONTypes = anOptions&NDJSONOptionCovertPrimitiveJSONTypes ? YES : NO;
 	_options.dontSendAwakeFromDeserializationMessages = anOptions&NDJSONOptionDontSendAwakeFromDeserializationMessages ? YES : NO;
 	_options.convertToArrayTypeIfRequired = anOptions&NDJSONOptionConvertToArrayTypeIfRequired ? YES : NO;
+	_options.useKeyTables = anOptions&NDJSONOptionUseKeyTables ? YES : NO;
+	_options.presizeContainers = anOptions&NDJSONOptionPresizeContainers ? YES : NO;
+	if( _options.presizeContainers && _shapeProfile == nil )
+		_shapeProfile = [[NDJSONShapeProfile alloc] init];
 	if( [aJSON parseWithOptions:anOptions] )
 		theResult = _result;
 	else if( anError != NULL )
 		*anError = self.error;
-	aJSON.delegate = theOriginalDelegate;
+	if( theOriginalDelegate != theParserDelegate )
+		aJSON.delegate = theOriginalDelegate;
+	aJSON.statistics = theOriginalStatistics;
 	return theResult;
 }
 
 #pragma mark - NDJSONParserDelegate methods
 - (void)jsonParserDidStartDocument:(NDJSONParser *)aJSON
 {
-	_containerStack.size = 256;
-	_containerStack.count = 0;
-	if( _containerStack.bytes != NULL )
-		free( _containerStack.bytes );
-	_containerStack.bytes = calloc(_containerStack.size,sizeof(struct NDContainerStackStruct));
-	NSAssert( _containerStack.bytes != NULL, @"Malloc failure" );
+	if( _containerStack.bytes == NULL )				// kept between documents
+	{
+		_containerStack.size = 256;
+		_containerStack.bytes = calloc(_containerStack.size,sizeof(struct NDContainerStackStruct));
+		NSAssert( _containerStack.bytes != NULL, @"Malloc failure" );
+	}
+	NDJSONReleaseContainerStack( self );				// left over if the last document was not ended
 	[_currentProperty release], _currentProperty = nil;
 	[_currentKey release], _currentKey = nil;
 	[_result autorelease], _result = nil;
+	self.error = nil;
 	if( _delegateMethod.didStartDocument != NULL )
 		_delegateMethod.didStartDocument( _delegate, @selector(jsonParserDidStartDocument:), self );
 }
 - (void)jsonParserDidEndDocument:(NDJSONParser *)aJSON
 {
-	for( NSUInteger i = 0; i < _containerStack.count; i++ )
-	{
-		[_containerStack.bytes[i].propertyName release];
-		[_containerStack.bytes[i].key release];
-		[_containerStack.bytes[i].container release];
-	}
-	_containerStack.count = 0;
+	NDJSONReleaseContainerStack( self );
 	[_currentProperty release], _currentProperty = nil;
 	[_currentKey release], _currentKey = nil;
-	if( _containerStack.bytes != NULL )
-		free(_containerStack.bytes);
-	_containerStack.bytes = NULL;
 	if( _delegateMethod.didEndDocument != NULL )
 		_delegateMethod.didEndDocument( _delegate, @selector(jsonParserDidEndDocument:), self );
 }
 
 - (void)jsonParserDidStartArray:(NDJSONParser *)aJSON
 {
-	NSMutableArray		* theArrayRep = [[NSMutableArray alloc] init];
+	NSUInteger			theCapacity = NDJSONExpectedCountForNextContainer( self, YES );
+	NSMutableArray		* theArrayRep = theCapacity > 0 ? [[NSMutableArray alloc] initWithCapacity:theCapacity] : [[NSMutableArray alloc] init];
 	if( self->_delegateMethod.didStartArray != NULL )
 		self->_delegateMethod.didStartArray( self->_delegate, @selector(jsonParserDidStartArray:), self );
 	NDJSONPushContainerForJSONDeserializer( self, theArrayRep, NO );
@@ -294,7 +437,8 @@ static id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * sel
 
 - (void)jsonParserDidStartObject:(NDJSONParser *)aJSON
 {
-	id			theObjectRep = theObjectRep = [[NSMutableDictionary alloc] init];
+	NSUInteger	theCapacity = NDJSONExpectedCountForNextContainer( self, YES );
+	id			theObjectRep = theCapacity > 0 ? [[NSMutableDictionary alloc] initWithCapacity:theCapacity] : [[NSMutableDictionary alloc] init];
 
 	if( self->_delegateMethod.didStartObject != NULL )
 		self->_delegateMethod.didStartObject( self->_delegate, @selector(jsonParserDidStartObject:), self );
@@ -311,7 +455,7 @@ static id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * sel
 	[self addValue:theObject type:NDJSONValueObject];
 }
 
-static NSString * NDJSONStringByConvertingPropertyName( NSString * aString, BOOL aRemoveIs, BOOL aConvertToCamelCase )
+NSString * NDJSONStringByConvertingPropertyName( NSString * aString, BOOL aRemoveIs, BOOL aConvertToCamelCase )
 {
 	NSString	* theResult = aString;
 	NSUInteger	theBufferLen = aString.length;
@@ -363,18 +507,25 @@ static NSString * NDJSONStringByConvertingPropertyName( NSString * aString, BOOL
 - (void)jsonParser:(NDJSONParser *)aJSON foundKey:(NSString *)aValue
 {
 	NSParameterAssert( _containerStack.count == 0 || _containerStack.bytes[_containerStack.count-1].isObject );
-	NSString	* thePropertyName = NDJSONStringByConvertingPropertyName( aValue, _options.removeIsAdjective != 0, _options.convertKeysToMedialCapital != 0 );
-	id			theCurrentContainer = self.currentContainer;
+	NSString	* thePropertyName = nil;
+	NSUInteger	theKeyIndex = _options.useKeyTables ? aJSON.currentKeyIndex : NSNotFound;
 	if( self->_delegateMethod.foundKey != NULL )
 		self->_delegateMethod.foundKey( self->_delegate, @selector(jsonParser:foundKey:), self, aValue );
-	/*
-	 Do we need to map the property name to a different name
-	 */
-	if( [[theCurrentContainer class] respondsToSelector:@selector(propertyNamesWithJSONDeserializer:)] )
+	if( theKeyIndex != NSNotFound )				// key tables are only supplied by us
+		thePropertyName = [(NDJSONPropertyKeyTable*)aJSON.currentKeyTable propertyNameAtIndex:theKeyIndex];
+	else
 	{
-		NSString	* theNewPropertyName = [[[theCurrentContainer class] propertyNamesWithJSONDeserializer:self] objectForKey:aValue];
-		if( theNewPropertyName != nil )
-			thePropertyName = theNewPropertyName;
+		id			theCurrentContainer = self.currentContainer;
+		thePropertyName = NDJSONStringByConvertingPropertyName( aValue, _options.removeIsAdjective != 0, _options.convertKeysToMedialCapital != 0 );
+		/*
+		 Do we need to map the property name to a different name
+		 */
+		if( [[theCurrentContainer class] respondsToSelector:@selector(propertyNamesWithJSONDeserializer:)] )
+		{
+			NSString	* theNewPropertyName = [[[theCurrentContainer class] propertyNamesWithJSONDeserializer:self] objectForKey:aValue];
+			if( theNewPropertyName != nil )
+				thePropertyName = theNewPropertyName;
+		}
 	}
 	[_currentProperty release], _currentProperty = [thePropertyName retain];
 	[_currentKey release], _currentKey = [aValue retain];
@@ -461,6 +612,9 @@ static NSString * NDJSONStringByConvertingPropertyName( NSString * aString, BOOL
 	_delegateMethod.foundString = [theDelegate respondsToSelector:@selector(jsonParser:foundString:)]
 										? [theDelegate methodForSelector:@selector(jsonParser:foundString:)]
 										: NULL;
+	_delegateMethod.foundData = [theDelegate respondsToSelector:@selector(jsonParser:foundData:)]
+										? [theDelegate methodForSelector:@selector(jsonParser:foundData:)]
+										: NULL;
 	_delegateMethod.foundNumber = [theDelegate respondsToSelector:@selector(jsonParser:foundNumber:)]
 										? [theDelegate methodForSelector:@selector(jsonParser:foundNumber:)]
 										: NULL;
@@ -513,6 +667,31 @@ static NSString * NDJSONStringByConvertingPropertyName( NSString * aString, BOOL
 	return theResult;
 }
 
+/*
+	whether containers of the class can be created with a recorded capacity, they are created with initWithCapacity: and recorded with count
+ */
+static BOOL NDJSONClassCanBePresized( Class aClass )
+{
+	return [aClass instancesRespondToSelector:@selector(initWithCapacity:)] && [aClass instancesRespondToSelector:@selector(count)];
+}
+
+/*
+	the capacity recorded for the key path of the container about to be created, 0 if unknown or not presizing containers, aRecordCount is whether the class of the container responds to initWithCapacity: and count
+ */
+static NSUInteger NDJSONExpectedCountForNextContainer( NDJSONDeserializer * self, BOOL aRecordCount )
+{
+	NSUInteger		theResult = 0;
+	if( self->_options.presizeContainers )
+	{
+		NSUInteger		theDepth = self->_containerStack.count;
+		self->_nextContainer.pathHash = theDepth > 0 ? NDJSONShapePathHash( self->_containerStack.bytes[theDepth-1].pathHash, self->_currentKey ) : kShapeRootPathHash;
+		self->_nextContainer.recordCount = aRecordCount;
+		if( aRecordCount )
+			theResult = NDJSONShapeProfileExpectedCount( self->_shapeProfile, self->_nextContainer.pathHash );
+	}
+	return theResult;
+}
+
 void NDJSONPushContainerForJSONDeserializer( NDJSONDeserializer * self, id aContainer, BOOL anIsObject )
 {
 	NSCParameterAssert( aContainer != nil );
@@ -521,16 +700,21 @@ void NDJSONPushContainerForJSONDeserializer( NDJSONDeserializer * self, id aCont
 	{
 		void		* theBytes = NULL;
 		self->_containerStack.size *= 2;
-		theBytes = realloc(self->_containerStack.bytes, self->_containerStack.size);
+		theBytes = realloc(self->_containerStack.bytes, self->_containerStack.size*sizeof(struct NDContainerStackStruct));
 		NSCAssert( theBytes != NULL, @"Memory failure" );
 		self->_containerStack.bytes = theBytes;
 	}
 	self->_containerStack.bytes[self->_containerStack.count].container = [aContainer retain];
 	self->_containerStack.bytes[self->_containerStack.count].propertyName = self->_currentProperty;
 	self->_containerStack.bytes[self->_containerStack.count].key = self->_currentKey;
+	self->_containerStack.bytes[self->_containerStack.count].propertyIndex = self->_currentPropertyIndex;
 	self->_currentProperty = nil;
 	self->_currentKey = nil;
 	self->_containerStack.bytes[self->_containerStack.count].isObject = anIsObject;
+	self->_containerStack.bytes[self->_containerStack.count].pathHash = self->_nextContainer.pathHash;
+	self->_containerStack.bytes[self->_containerStack.count].recordCount = self->_nextContainer.recordCount;
+	self->_nextContainer.pathHash = 0;
+	self->_nextContainer.recordCount = NO;
 	self->_containerStack.count++;
 }
 
@@ -555,6 +739,20 @@ void NDJSONPushContainerForJSONDeserializer( NDJSONDeserializer * self, id aCont
 		_result = [aValue retain];
 }
 
+/*
+	releases the containers of an unfinished document, the stack buffer is kept
+ */
+void NDJSONReleaseContainerStack( NDJSONDeserializer * self )
+{
+	for( NSUInteger i = 0; i < self->_containerStack.count; i++ )
+	{
+		[self->_containerStack.bytes[i].propertyName release];
+		[self->_containerStack.bytes[i].key release];
+		[self->_containerStack.bytes[i].container release];
+	}
+	self->_containerStack.count = 0;
+}
+
 id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * self )
 {
 	id		theResult = nil;
@@ -565,7 +763,10 @@ id NDJSONPopCurrentContainerForJSONDeserializer( NDJSONDeserializer * self )
 		[self->_currentKey release], self->_currentKey = nil;;
 		self->_currentProperty = self->_containerStack.bytes[self->_containerStack.count].propertyName;
 		self->_currentKey = self->_containerStack.bytes[self->_containerStack.count].key;
+		self->_currentPropertyIndex = self->_containerStack.bytes[self->_containerStack.count].propertyIndex;
 		theResult = [self->_containerStack.bytes[self->_containerStack.count].container autorelease];
+		if( self->_containerStack.bytes[self->_containerStack.count].recordCount )
+			NDJSONShapeProfileRecordCount( self->_shapeProfile, self->_containerStack.bytes[self->_containerStack.count].pathHash, [theResult count] );
 	}
 	return theResult;
 }
@@ -655,16 +856,178 @@ static SEL NDJSONInstanceInitSelectorForType( NDJSONValueType aType )
 	return theResult;
 }
 
-static BOOL NDJSONSetValueByConvertingPrimativeType( id aContainer, id aValue, NSString * aPropertyName, NDJSONValueType aSourceType )
+/*
+	hand written RFC 3339/ISO 8601 parsing, the offset is folded into the time interval so no NSTimeZone, NSCalendar or
+	NSDateFormatter is involved, see NDJSONDateFormatISO8601 for the accepted forms
+ */
+static BOOL NDJSONScanDigits( const uint8_t ** aPos, const uint8_t * anEnd, NSUInteger aCount, NSInteger * aValue )
+{
+	NSInteger		theValue = 0;
+	if( (NSUInteger)(anEnd - *aPos) < aCount )
+		return NO;
+	for( NSUInteger i = 0; i < aCount; i++ )
+	{
+		uint8_t		theChar = (*aPos)[i];
+		if( theChar < '0' || theChar > '9' )
+			return NO;
+		theValue = theValue*10 + (theChar-'0');
+	}
+	*aPos += aCount;
+	*aValue = theValue;
+	return YES;
+}
+
+static BOOL NDJSONScanCharacter( const uint8_t ** aPos, const uint8_t * anEnd, uint8_t aChar )
+{
+	BOOL	theResult = *aPos < anEnd && **aPos == aChar;
+	if( theResult )
+		(*aPos)++;
+	return theResult;
+}
+
+/*
+	days since 1970-01-01 in the proleptic Gregorian calendar
+ */
+static NSInteger NDJSONDaysSinceEpoch( NSInteger aYear, NSInteger aMonth, NSInteger aDay )
+{
+	NSInteger		theYear = aMonth <= 2 ? aYear - 1 : aYear,
+					theEra = (theYear >= 0 ? theYear : theYear-399) / 400,
+					theYearOfEra = theYear - theEra*400,
+					theDayOfYear = (153*(aMonth > 2 ? aMonth-3 : aMonth+9) + 2)/5 + aDay-1,
+					theDayOfEra = theYearOfEra*365 + theYearOfEra/4 - theYearOfEra/100 + theDayOfYear;
+	return theEra*146097 + theDayOfEra - 719468;
+}
+
+static NSInteger NDJSONDaysInMonth( NSInteger aYear, NSInteger aMonth )
+{
+	static const uint8_t	kDaysInMonth[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	BOOL					theIsLeapYear = (aYear%4 == 0 && aYear%100 != 0) || aYear%400 == 0;
+	return kDaysInMonth[aMonth-1] + (aMonth == 2 && theIsLeapYear ? 1 : 0);
+}
+
+static NSDate * NDJSONDateFromISO8601Bytes( const uint8_t * aBytes, NSUInteger aLength )
+{
+	const uint8_t		* thePos = aBytes,
+						* theEnd = aBytes + aLength;
+	NSInteger			theYear = 0,
+						theMonth = 0,
+						theDay = 0,
+						theHour = 0,
+						theMinute = 0,
+						theSecond = 0,
+						theOffset = 0;
+	NSTimeInterval		theFraction = 0.0;
+
+	if( !NDJSONScanDigits( &thePos, theEnd, 4, &theYear ) || !NDJSONScanCharacter( &thePos, theEnd, '-' )
+		|| !NDJSONScanDigits( &thePos, theEnd, 2, &theMonth ) || !NDJSONScanCharacter( &thePos, theEnd, '-' )
+		|| !NDJSONScanDigits( &thePos, theEnd, 2, &theDay ) )
+		return nil;
+	if( theMonth < 1 || theMonth > 12 || theDay < 1 || theDay > NDJSONDaysInMonth( theYear, theMonth ) )
+		return nil;
+
+	if( NDJSONScanCharacter( &thePos, theEnd, 'T' ) || NDJSONScanCharacter( &thePos, theEnd, 't' ) || NDJSONScanCharacter( &thePos, theEnd, ' ' ) )
+	{
+		if( !NDJSONScanDigits( &thePos, theEnd, 2, &theHour ) || !NDJSONScanCharacter( &thePos, theEnd, ':' )
+			|| !NDJSONScanDigits( &thePos, theEnd, 2, &theMinute ) )
+			return nil;
+		if( NDJSONScanCharacter( &thePos, theEnd, ':' ) )
+		{
+			if( !NDJSONScanDigits( &thePos, theEnd, 2, &theSecond ) )
+				return nil;
+			if( NDJSONScanCharacter( &thePos, theEnd, '.' ) || NDJSONScanCharacter( &thePos, theEnd, ',' ) )
+			{
+				NSTimeInterval		theScale = 0.1;
+				if( thePos == theEnd || *thePos < '0' || *thePos > '9' )
+					return nil;
+				for( ; thePos < theEnd && *thePos >= '0' && *thePos <= '9'; thePos++, theScale *= 0.1 )
+					theFraction += (*thePos-'0') * theScale;
+			}
+		}
+		if( theMinute > 59 || theSecond > 60 || theHour > 24 || (theHour == 24 && (theMinute != 0 || theSecond != 0 || theFraction != 0.0)) )
+			return nil;
+
+		if( NDJSONScanCharacter( &thePos, theEnd, 'Z' ) || NDJSONScanCharacter( &thePos, theEnd, 'z' ) )
+			theOffset = 0;
+		else if( thePos < theEnd && (*thePos == '+' || *thePos == '-') )
+		{
+			NSInteger		theSign = *thePos++ == '-' ? -1 : 1,
+							theOffsetHours = 0,
+							theOffsetMinutes = 0;
+			if( !NDJSONScanDigits( &thePos, theEnd, 2, &theOffsetHours ) )
+				return nil;
+			if( NDJSONScanCharacter( &thePos, theEnd, ':' ) || thePos < theEnd )
+			{
+				if( !NDJSONScanDigits( &thePos, theEnd, 2, &theOffsetMinutes ) )
+					return nil;
+			}
+			if( theOffsetHours > 23 || theOffsetMinutes > 59 )
+				return nil;
+			theOffset = theSign * (theOffsetHours*3600 + theOffsetMinutes*60);
+		}
+	}
+	if( thePos != theEnd )
+		return nil;
+
+	return [NSDate dateWithTimeIntervalSince1970:(NSTimeInterval)(NDJSONDaysSinceEpoch( theYear, theMonth, theDay )*86400 + theHour*3600 + theMinute*60 + theSecond - theOffset) + theFraction];
+}
+
+static NSDate * NDJSONDateFromISO8601String( NSString * aString )
+{
+	NSUInteger		theLength = 0;
+	uint8_t			theBuffer[64];
+	NSRange			theRemainingRange = {0,0};
+	const char		* theBytes = CFStringGetCStringPtr( (CFStringRef)aString, kCFStringEncodingUTF8 );
+	if( theBytes != NULL )
+		theLength = strlen( theBytes );
+	else if( [aString getBytes:theBuffer maxLength:sizeof(theBuffer) usedLength:&theLength encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, aString.length) remainingRange:&theRemainingRange] && theRemainingRange.length == 0 )
+		theBytes = (const char *)theBuffer;
+	return theBytes != NULL ? NDJSONDateFromISO8601Bytes( (const uint8_t *)theBytes, theLength ) : nil;
+}
+
+/*
+	the date for a JSON string or number in one of the formats the class of aContainer gives for the property, or nil
+ */
+static NSDate * NDJSONDateByConvertingValue( NDJSONDeserializer * aDeserializer, id aContainer, id aValue, NSString * aPropertyName, NDJSONValueType aSourceType )
+{
+	NSDate				* theResult = nil;
+	NDJSONDateFormat	theFormat = NDJSONDateFormatDefault;
+	Class				theClass = [aContainer class];
+	if( [theClass respondsToSelector:@selector(dateFormatsForPropertyNamesWithJSONDeserializer:)] )
+	{
+		NSNumber	* theFormatNumber = [[theClass dateFormatsForPropertyNamesWithJSONDeserializer:aDeserializer] objectForKey:aPropertyName];
+		if( theFormatNumber != nil )
+			theFormat = theFormatNumber.unsignedIntegerValue;
+	}
+	switch( aSourceType )
+	{
+	case NDJSONValueString:
+		if( theFormat & NDJSONDateFormatISO8601 )
+			theResult = NDJSONDateFromISO8601String( aValue );
+		break;
+	case NDJSONValueInteger:
+	case NDJSONValueFloat:
+		if( theFormat & NDJSONDateFormatEpochMilliseconds )
+			theResult = [NSDate dateWithTimeIntervalSince1970:[aValue doubleValue]/1000.0];
+		else if( theFormat & NDJSONDateFormatEpochSeconds )
+			theResult = [NSDate dateWithTimeIntervalSince1970:[aValue doubleValue]];
+		break;
+	default:
+		break;
+	}
+	return theResult;
+}
+
+static BOOL NDJSONSetValueByConvertingPrimativeType( NDJSONDeserializer * aDeserializer, id aContainer, id aValue, NSString * aPropertyName, NDJSONValueType aSourceType )
 {
 	BOOL				theResult = NO;
 	objc_property_t		theProperty = class_getProperty([aContainer class], [aPropertyName UTF8String]);
 	if( theProperty != NULL )
 	{
 		const char			* thePropertyAttributes = property_getAttributes(theProperty);
-		char				theClassName[kMaximumClassNameLength];
+		char				theClassName[kMaximumClassNameLength] = "";
 		NDJSONValueType		theTargetType = NDJSONGetTypeNameFromPropertyAttributes( theClassName, sizeof(theClassName)/sizeof(*theClassName), thePropertyAttributes );
 		Class				theTargetClass = Nil;
+		NSDate				* theDate = nil;
 		if( NDJSONParserValueEquivelentObjectTypes(theTargetType, aSourceType) || (NDJSONParserValueIsNSNumberType(aSourceType) && [(theTargetClass = objc_getClass(theClassName)) isSubclassOfClass:[NSNumber class]]) )
 		{
 			[aContainer setValue:aValue forKey:aPropertyName];
@@ -676,6 +1039,11 @@ static BOOL NDJSONSetValueByConvertingPrimativeType( id aContainer, id aValue, N
 			{
 				[aContainer performSelector:theSelector withObject:aValue];
 			}
+			else if( theTargetType == NDJSONValueObject && [(theTargetClass = objc_getClass(theClassName)) isSubclassOfClass:[NSDate class]]
+					&& (theDate = NDJSONDateByConvertingValue( aDeserializer, aContainer, aValue, aPropertyName, aSourceType )) != nil )
+			{
+				[aContainer setValue:theDate forKey:aPropertyName];
+			}
 			else if( NDJSONParserValueIsPrimativeType(theTargetType) )
 			{
 				switch (theTargetType)
@@ -737,7 +1105,7 @@ static BOOL NDJSONSetValueByConvertingPrimativeType( id aContainer, id aValue, N
 			{
 				if( _options.convertPrimativeJSONTypes && NDJSONParserValueIsPrimativeType(aType) )
 				{
-					if( !NDJSONSetValueByConvertingPrimativeType( theCurrentContainer, aValue, _currentProperty, aType ) )
+					if( !NDJSONSetValueByConvertingPrimativeType( self, theCurrentContainer, aValue, _currentProperty, aType ) )
 						[theCurrentContainer setValue:aValue forKey:_currentProperty];
 				}
 				else
@@ -766,6 +1134,94 @@ static BOOL NDJSONSetValueByConvertingPrimativeType( id aContainer, id aValue, N
 		_result = [aValue retain];
 }
 
+/*
+	the NSData properties of aClass, except those the class converts from strings itself with set<Property>ByConvertingString:
+ */
+static NSSet * NDJSONDataPropertyNamesForClass( NDJSONDeserializer * self, Class aClass )
+{
+	NSSet		* theResult = [self->_dataPropertyNamesForClasses objectForKey:aClass];
+	if( theResult == nil )
+	{
+		NSMutableSet	* thePropertyNames = [[NSMutableSet alloc] init];
+		for( Class theClass = aClass; theClass != Nil && theClass != [NSObject class]; theClass = class_getSuperclass(theClass) )
+		{
+			unsigned int		theCount = 0;
+			objc_property_t		* theProperties = class_copyPropertyList( theClass, &theCount );
+			for( unsigned int i = 0; i < theCount; i++ )
+			{
+				char		theClassName[kMaximumClassNameLength] = "";
+				if( NDJSONGetTypeNameFromPropertyAttributes( theClassName, sizeof(theClassName)/sizeof(*theClassName), property_getAttributes(theProperties[i]) ) == NDJSONValueObject
+					&& [objc_getClass(theClassName) isSubclassOfClass:[NSData class]] )
+				{
+					NSString	* thePropertyName = [NSString stringWithUTF8String:property_getName(theProperties[i])];
+					if( ![aClass instancesRespondToSelector:NDJSONConversionSelectorForPropertyAndType( thePropertyName, NDJSONValueString )] )
+						[thePropertyNames addObject:thePropertyName];
+				}
+			}
+			free( theProperties );
+		}
+		if( self->_dataPropertyNamesForClasses == nil )
+			self->_dataPropertyNamesForClasses = [[NSMutableDictionary alloc] init];
+		[self->_dataPropertyNamesForClasses setObject:thePropertyNames forKey:(id<NSCopying>)aClass];
+		theResult = thePropertyNames;
+		[thePropertyNames release];
+	}
+	return theResult;
+}
+
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldDecodeBase64ValueForKey:(NSString *)aKey
+{
+	return _options.convertPrimativeJSONTypes && _currentProperty != nil
+			&& [NDJSONDataPropertyNamesForClass( self, [self.currentContainer class] ) containsObject:_currentProperty];
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundData:(NSData *)aValue
+{
+	[self addValue:aValue type:NDJSONValueObject];
+	if( self->_delegateMethod.foundData != NULL )
+		self->_delegateMethod.foundData( self->_delegate, @selector(jsonParser:foundData:), self, aValue );
+	[_currentProperty release], _currentProperty = nil;
+}
+
+@end
+
+@implementation NDJSONPropertyKeyTable
+
+@synthesize		decoder = _decoder;
+
+- (id)initWithKeys:(NSArray *)aKeys propertyNames:(NSArray *)aPropertyNames skipValues:(const BOOL *)aSkipValues
+{
+	NSParameterAssert( aKeys.count == aPropertyNames.count );
+	if( (self = [super initWithKeys:aKeys]) != nil )
+	{
+		_propertyNames = [aPropertyNames copy];
+		_skipValue = malloc( aKeys.count > 0 ? aKeys.count*sizeof(BOOL) : 1 );
+		memcpy( _skipValue, aSkipValues, aKeys.count*sizeof(BOOL) );
+	}
+	return self;
+}
+
+- (id)initWithGeneratedDecoder:(const struct NDJSONGeneratedDecoder *)aDecoder
+{
+	NSArray		* theKeys = [[NSArray alloc] initWithObjects:aDecoder->keys count:aDecoder->count],
+				* thePropertyNames = [[NSArray alloc] initWithObjects:aDecoder->propertyNames count:aDecoder->count];
+	if( (self = [self initWithKeys:theKeys propertyNames:thePropertyNames skipValues:aDecoder->skipValues]) != nil )
+		_decoder = aDecoder;
+	[thePropertyNames release];
+	[theKeys release];
+	return self;
+}
+
+- (void)dealloc
+{
+	[_propertyNames release];
+	free(_skipValue);
+	[super dealloc];
+}
+
+- (NSString *)propertyNameAtIndex:(NSUInteger)anIndex { return [_propertyNames objectAtIndex:anIndex]; }
+- (BOOL)shouldSkipValueAtIndex:(NSUInteger)anIndex { return _skipValue[anIndex]; }
+
 @end
 
 @implementation NDJSONCustomDeserializer
@@ -780,19 +1236,95 @@ static BOOL NDJSONSetValueByConvertingPrimativeType( id aContainer, id aValue, N
 	{
 		rootClass = aRootClass;
 		rootCollectionClass = aRootCollectionClass;
+		_currentPropertyIndex = NSNotFound;
 		if( aParent != nil )
 			NDJSONPushContainerForJSONDeserializer( self, aParent, YES );
 	}
 	return self;
 }
 
+- (id)initWithConfiguration:(NDJSONDeserializerConfiguration *)aConfiguration
+{
+	if( (self = [self initWithRootClass:aConfiguration.rootClass rootCollectionClass:aConfiguration.rootCollectionClass initialParent:nil]) != nil )
+	{
+		_configuration = [aConfiguration retain];
+		_shapeProfile = [aConfiguration.shapeProfile retain];
+	}
+	return self;
+}
+
 - (void)dealloc
 {
 	[rootClass release];
 	[rootCollectionClass release];
+	[_keyTablesForClasses release];
 	[super dealloc];
 }
 
+- (id)objectForJSON:(NDJSONParser *)aJSON options:(NDJSONOptionFlags)anOptions error:(NSError **)anError
+{
+	NSUInteger		theKeyTableOptions = anOptions & (NDJSONOptionConvertKeysToMedialCapitals|NDJSONOptionConvertRemoveIsAdjective|NDJSONOptionDontUseGeneratedDecoders);
+	if( theKeyTableOptions != _keyTablesOptions )			// property names in the tables depend on these options
+	{
+		[_keyTablesForClasses removeAllObjects];
+		_keyTablesOptions = theKeyTableOptions;
+	}
+	_sharesKeyTables = _configuration != nil && (_configuration.options & (NDJSONOptionConvertKeysToMedialCapitals|NDJSONOptionConvertRemoveIsAdjective|NDJSONOptionDontUseGeneratedDecoders)) == theKeyTableOptions;
+	_generatedDecoderKeyOptions = anOptions&NDJSONOptionDontUseGeneratedDecoders ? NSNotFound : anOptions&(NDJSONOptionConvertKeysToMedialCapitals|NDJSONOptionConvertRemoveIsAdjective);
+	_decoderClass = Nil;
+	_decoder = NULL;
+	return [super objectForJSON:aJSON options:anOptions error:anError];
+}
+
+/*
+	the generated decoder for instances of aClass, if there is one and it was generated with the key options being used
+ */
+static const struct NDJSONGeneratedDecoder * NDJSONDecoderForClass( NDJSONCustomDeserializer * self, Class aClass )
+{
+	if( aClass != self->_decoderClass )
+	{
+		const struct NDJSONGeneratedDecoder	* theDecoder = self->_generatedDecoderKeyOptions != NSNotFound ? NDJSONGeneratedDecoderForClass( aClass ) : NULL;
+		self->_decoder = theDecoder != NULL && theDecoder->keyOptions == self->_generatedDecoderKeyOptions ? theDecoder : NULL;
+		self->_decoderClass = aClass;
+	}
+	return self->_decoder;
+}
+
+static NSUInteger NDJSONGeneratedIndexForKey( const struct NDJSONGeneratedDecoder * aDecoder, NSString * aKey )
+{
+	NSUInteger		theResult = NSNotFound,
+					theLength = 0;
+	char			theBuffer[256];
+	NSRange			theRemainingRange = {0,0};
+	const char		* theBytes = CFStringGetCStringPtr( (CFStringRef)aKey, kCFStringEncodingUTF8 );
+	if( theBytes != NULL )
+		theLength = strlen( theBytes );
+	else if( [aKey getBytes:theBuffer maxLength:sizeof(theBuffer) usedLength:&theLength encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, aKey.length) remainingRange:&theRemainingRange] && theRemainingRange.length == 0 )
+		theBytes = theBuffer;
+	if( theBytes != NULL )
+		theResult = aDecoder->indexForKey( theBytes, theLength );
+	return theResult;
+}
+
+/*
+	the generated decoder index of a property name given by currentContainerPropertyName
+ */
+static NSUInteger NDJSONCurrentPropertyIndexForName( NDJSONCustomDeserializer * self, NSString * aName )
+{
+	NSUInteger		theResult = NSNotFound;
+	if( aName != nil && aName == self->_currentProperty )
+		theResult = self->_currentPropertyIndex;
+	else if( aName != nil && self->_containerStack.count > 0 && aName == self->_containerStack.bytes[self->_containerStack.count-1].propertyName )
+		theResult = self->_containerStack.bytes[self->_containerStack.count-1].propertyIndex;
+	return theResult;
+}
+
+- (void)jsonParserDidStartDocument:(NDJSONParser *)aJSON
+{
+	[_objectThatRespondToAwakeFromDeserialization release], _objectThatRespondToAwakeFromDeserialization = nil;	// left by a document that failed
+	[super jsonParserDidStartDocument:aJSON];
+}
+
 - (void)jsonParserDidEndDocument:(NDJSONParser *)aJSON
 {
 	[super jsonParserDidEndDocument:aJSON];
@@ -818,7 +1350,8 @@ static BOOL NDJSONSetValueByConvertingPrimativeType( id aContainer, id aValue, N
 		@throw theException;
 	}
 
-	id		theArrayRep = [[theClassesDes.actual alloc] init];
+	NSUInteger	theCapacity = NDJSONExpectedCountForNextContainer( self, _options.presizeContainers && NDJSONClassCanBePresized( theClassesDes.actual ) );
+	id			theArrayRep = theCapacity > 0 ? [[theClassesDes.actual alloc] initWithCapacity:theCapacity] : [[theClassesDes.actual alloc] init];
 
 	if( !_options.dontSendAwakeFromDeserializationMessages && [theArrayRep respondsToSelector:@selector(awakeFromDeserializationWithJSONDeserializer:)] )
 	{
@@ -841,7 +1374,12 @@ static BOOL NDJSONSetValueByConvertingPrimativeType( id aContainer, id aValue, N
 		theObjectRep = [_delegateMethod.objectForClass( self.delegate, @selector(jsonDeserializer:objectForClass:propertName:), self, theClassDesc.actual, self.currentContainerPropertyName) retain];
 
 	if( theObjectRep == nil )
-		theObjectRep = [[theClassDesc.actual alloc] init];
+	{
+		NSUInteger		theCapacity = NDJSONExpectedCountForNextContainer( self, _options.presizeContainers && NDJSONClassCanBePresized( theClassDesc.actual ) );
+		theObjectRep = theCapacity > 0 ? [[theClassDesc.actual alloc] initWithCapacity:theCapacity] : [[theClassDesc.actual alloc] init];
+	}
+	else
+		NDJSONExpectedCountForNextContainer( self, NO );
 
 	if( [[theObjectRep class] respondsToSelector:@selector(parentPropertyNameWithJSONDeserializer:)] )
 		[theObjectRep setValue:self.currentObject forKey:[[theObjectRep class] parentPropertyNameWithJSONDeserializer:self]];
@@ -866,11 +1404,139 @@ static BOOL NDJSONSetValueByConvertingPrimativeType( id aContainer, id aValue, N
 	[theObjectRep release];
 }
 
+- (void)jsonParser:(NDJSONParser *)aJSON foundKey:(NSString *)aValue
+{
+	const struct NDJSONGeneratedDecoder	* theDecoder = NDJSONDecoderForClass( self, [self.currentContainer class] );
+	NSUInteger							theIndex = NSNotFound;
+	if( theDecoder != NULL )
+	{
+		if( _options.useKeyTables && ((NDJSONPropertyKeyTable*)aJSON.currentKeyTable).decoder == theDecoder )
+			theIndex = aJSON.currentKeyIndex;				// the key table indexes are the decoders
+		else
+			theIndex = NDJSONGeneratedIndexForKey( theDecoder, aValue );
+	}
+	if( theIndex != NSNotFound )
+	{
+		if( _delegateMethod.foundKey != NULL )
+			_delegateMethod.foundKey( _delegate, @selector(jsonParser:foundKey:), self, aValue );
+		[_currentProperty release], _currentProperty = [theDecoder->propertyNames[theIndex] retain];
+		[_currentKey release], _currentKey = [aValue retain];
+	}
+	else
+		[super jsonParser:aJSON foundKey:aValue];
+	_currentPropertyIndex = theIndex;
+}
+
+- (void)addValue:(id)aValue type:(NDJSONValueType)aType
+{
+	id										theCurrentContainer = self.currentContainer;
+	const struct NDJSONGeneratedDecoder		* theDecoder = _currentProperty != nil && _currentPropertyIndex != NSNotFound
+														? NDJSONDecoderForClass( self, [theCurrentContainer class] )
+														: NULL;
+	if( theDecoder == NULL || !theDecoder->setValue( theCurrentContainer, _currentPropertyIndex, aValue ) )
+		[super addValue:aValue type:aType];
+}
+
+/*
+	every key the class is known to accept, its properties and the keys it names in the NSObject+NDJSONDeserializer methods, or the keys of its generated decoder
+ */
+static NDJSONPropertyKeyTable * NDJSONNewKeyTableForClass( NDJSONCustomDeserializer * self, Class aClass )
+{
+	NSMutableOrderedSet	* theKeys = [[NSMutableOrderedSet alloc] init];
+	NSDictionary		* thePropertyNames = nil;
+	NSSet				* theIgnoreSet = nil,
+						* theConsiderSet = nil;
+	NSMutableArray		* thePropertyNamesForKeys = nil;
+	BOOL				* theSkipValues = NULL;
+	NDJSONPropertyKeyTable	* theResult = nil;
+	const struct NDJSONGeneratedDecoder	* theDecoder = NDJSONDecoderForClass( self, aClass );
+
+	if( theDecoder != NULL )
+		theResult = [[NDJSONPropertyKeyTable alloc] initWithGeneratedDecoder:theDecoder];
+	else
+	{
+		for( Class theClass = aClass; theClass != Nil && theClass != [NSObject class]; theClass = class_getSuperclass(theClass) )
+		{
+			unsigned int		theCount = 0;
+			objc_property_t		* theProperties = class_copyPropertyList( theClass, &theCount );
+			for( unsigned int i = 0; i < theCount; i++ )
+				[theKeys addObject:[NSString stringWithUTF8String:property_getName(theProperties[i])]];
+			free( theProperties );
+		}
+		if( [aClass respondsToSelector:@selector(propertyNamesWithJSONDeserializer:)] )
+		{
+			thePropertyNames = [aClass propertyNamesWithJSONDeserializer:self];
+			[theKeys addObjectsFromArray:[thePropertyNames allKeys]];
+		}
+		if( [aClass respondsToSelector:@selector(keysIgnoreSetWithJSONDeserializer:)] )
+		{
+			theIgnoreSet = [aClass keysIgnoreSetWithJSONDeserializer:self];
+			[theKeys addObjectsFromArray:[theIgnoreSet allObjects]];
+		}
+		else if( [aClass respondsToSelector:@selector(keysConsiderSetWithJSONDeserializer:)] )
+		{
+			theConsiderSet = [aClass keysConsiderSetWithJSONDeserializer:self];
+			[theKeys addObjectsFromArray:[theConsiderSet allObjects]];
+		}
+
+		thePropertyNamesForKeys = [[NSMutableArray alloc] initWithCapacity:theKeys.count];
+		theSkipValues = malloc( theKeys.count > 0 ? theKeys.count*sizeof(BOOL) : 1 );
+		for( NSUInteger i = 0; i < theKeys.count; i++ )
+		{
+			NSString	* theKey = [theKeys objectAtIndex:i],
+						* thePropertyName = [thePropertyNames objectForKey:theKey];
+			if( thePropertyName == nil )
+				thePropertyName = NDJSONStringByConvertingPropertyName( theKey, self->_options.removeIsAdjective != 0, self->_options.convertKeysToMedialCapital != 0 );
+			[thePropertyNamesForKeys addObject:thePropertyName];
+			if( theIgnoreSet != nil )
+				theSkipValues[i] = [theIgnoreSet containsObject:theKey];
+			else if( theConsiderSet != nil )
+				theSkipValues[i] = ![theConsiderSet containsObject:theKey];
+			else
+				theSkipValues[i] = NO;
+		}
+		theResult = [[NDJSONPropertyKeyTable alloc] initWithKeys:[theKeys array] propertyNames:thePropertyNamesForKeys skipValues:theSkipValues];
+		free( theSkipValues );
+		[thePropertyNamesForKeys release];
+		[theKeys release];
+	}
+	return theResult;
+}
+
+- (NDJSONKeyTable *)jsonParserKeyTableForCurrentObject:(NDJSONParser *)aParser
+{
+	NDJSONPropertyKeyTable	* theResult = nil;
+	if( _options.useKeyTables )
+	{
+		Class		theClass = [self.currentObject class];
+		if( theClass != Nil && ![theClass isSubclassOfClass:[NSDictionary class]] )
+		{
+			if( _sharesKeyTables )
+				theResult = NDJSONSharedKeyTableForClass( _configuration, self, theClass );
+			else if( (theResult = [_keyTablesForClasses objectForKey:theClass]) == nil )
+			{
+				theResult = NDJSONNewKeyTableForClass( self, theClass );
+				if( _keyTablesForClasses == nil )
+					_keyTablesForClasses = [[NSMutableDictionary alloc] init];
+				[_keyTablesForClasses setObject:theResult forKey:(id<NSCopying>)theClass];
+				[theResult release];
+			}
+		}
+	}
+	return theResult;
+}
+
 - (BOOL)jsonParser:(NDJSONParser *)parser shouldSkipValueForKey:(NSString *)aKey
 {
 	BOOL		theResult = NO;
 	Class		theClass = [self.currentObject class];
-	if( [theClass respondsToSelector:@selector(keysIgnoreSetWithJSONDeserializer:)] )
+	NSUInteger	theKeyIndex = _options.useKeyTables ? parser.currentKeyIndex : NSNotFound;
+	const struct NDJSONGeneratedDecoder	* theDecoder = NULL;
+	if( theKeyIndex != NSNotFound )
+		theResult = [(NDJSONPropertyKeyTable*)parser.currentKeyTable shouldSkipValueAtIndex:theKeyIndex];
+	else if( _currentPropertyIndex != NSNotFound && (theDecoder = NDJSONDecoderForClass( self, theClass )) != NULL )
+		theResult = theDecoder->skipValues[_currentPropertyIndex];
+	else if( [theClass respondsToSelector:@selector(keysIgnoreSetWithJSONDeserializer:)] )
 		theResult = [[theClass keysIgnoreSetWithJSONDeserializer:self] containsObject:_currentKey];
 	else if( [theClass respondsToSelector:@selector(keysConsiderSetWithJSONDeserializer:)] )
 		theResult = ![[theClass keysConsiderSetWithJSONDeserializer:self] containsObject:_currentKey];
@@ -894,7 +1560,11 @@ static BOOL NDJSONSetValueByConvertingPrimativeType( id aContainer, id aValue, N
 		}
 		else
 		{
-			if( [aClass respondsToSelector:@selector(classesForPropertyNamesWithJSONDeserializer:)] )
+			NSUInteger								theIndex = _options.convertToArrayTypeIfRequired ? NSNotFound : NDJSONCurrentPropertyIndexForName( self, aName );
+			const struct NDJSONGeneratedDecoder		* theDecoder = theIndex != NSNotFound ? NDJSONDecoderForClass( self, aClass ) : NULL;
+			if( theDecoder != NULL && (theClassesDes.actual = theDecoder->classForIndex( theIndex )) != Nil )
+				theClassesDes.expected = theClassesDes.actual;
+			else if( [aClass respondsToSelector:@selector(classesForPropertyNamesWithJSONDeserializer:)] )
 				theClassesDes.actual = [[aClass classesForPropertyNamesWithJSONDeserializer:self] objectForKey:aName];
 			if( theClassesDes.actual == Nil || _options.convertToArrayTypeIfRequired )
 			{
@@ -940,7 +1610,11 @@ static BOOL NDJSONSetValueByConvertingPrimativeType( id aContainer, id aValue, N
 		}
 		else
 		{
-			if( [aClass respondsToSelector:@selector(collectionClassesForPropertyNamesWithJSONDeserializer:)] )
+			NSUInteger								theIndex = _options.convertToArrayTypeIfRequired ? NSNotFound : NDJSONCurrentPropertyIndexForName( self, aName );
+			const struct NDJSONGeneratedDecoder		* theDecoder = theIndex != NSNotFound ? NDJSONDecoderForClass( self, aClass ) : NULL;
+			if( theDecoder != NULL && (theClassesDes.actual = theDecoder->collectionClassForIndex( theIndex )) != Nil )
+				theClassesDes.expected = theClassesDes.actual;
+			else if( [aClass respondsToSelector:@selector(collectionClassesForPropertyNamesWithJSONDeserializer:)] )
 				theClassesDes.actual = [[aClass collectionClassesForPropertyNamesWithJSONDeserializer:self] objectForKey:aName];
 			if( theClassesDes.actual == Nil || _options.convertToArrayTypeIfRequired )
 			{
@@ -975,3 +1649,229 @@ static BOOL NDJSONSetValueByConvertingPrimativeType( id aContainer, id aValue, N
 }
 
 @end
+
+@implementation NDJSONDeserializerConfiguration
+
+@synthesize		rootClass = _rootClass,
+				rootCollectionClass = _rootCollectionClass,
+				options = _options,
+				shapeProfile = _shapeProfile;
+
+#pragma mark - creation and destruction
++ (NDJSONDeserializerConfiguration *)configurationWithRootClass:(Class)aRootClass rootCollectionClass:(Class)aRootCollectionClass options:(NDJSONOptionFlags)anOptions
+{
+	return [[[self alloc] initWithRootClass:aRootClass rootCollectionClass:aRootCollectionClass options:anOptions] autorelease];
+}
+
+- (id)initWithRootClass:(Class)aRootClass rootCollectionClass:(Class)aRootCollectionClass options:(NDJSONOptionFlags)anOptions
+{
+	if( (self = [super init]) != nil )
+	{
+		_rootClass = aRootClass;
+		_rootCollectionClass = aRootCollectionClass;
+		_options = anOptions;
+		pthread_mutex_init( &_keyTablesLock, NULL );
+		if( anOptions&NDJSONOptionPresizeContainers )
+			_shapeProfile = [[NDJSONShapeProfile alloc] init];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	if( _keyTablesForClasses != NULL )
+		CFRelease( _keyTablesForClasses );
+	pthread_mutex_destroy( &_keyTablesLock );
+	[_shapeProfile release];
+	[super dealloc];
+}
+
+- (id)copyWithZone:(NSZone *)aZone { return [self retain]; }
+
+- (NDJSONDeserializer *)deserializer { return [[[NDJSONDeserializer alloc] initWithConfiguration:self] autorelease]; }
+
+#pragma mark - parsing methods
+- (id)objectForJSONData:(NSData *)aData encoding:(NSStringEncoding)anEncoding error:(NSError **)anError
+{
+	NDJSONParser		* theJSON = [[NDJSONParser alloc] initWithJSONData:aData encoding:anEncoding];
+	NDJSONDeserializer	* theDeserializer = [[NDJSONDeserializer alloc] initWithConfiguration:self];
+	NSError				* theError = nil;
+	id					theResult = [[[theDeserializer objectForJSON:theJSON options:_options error:&theError] retain] autorelease];
+	[[theError retain] autorelease];
+	[theDeserializer release];
+	[theJSON release];
+	if( anError != NULL )
+		*anError = theError;
+	return theResult;
+}
+
+static NSError * NDJSONErrorForException( NSException * anException )
+{
+	NSMutableDictionary		* theUserInfo = [NSMutableDictionary dictionaryWithDictionary:anException.userInfo];
+	if( anException.reason != nil )
+		[theUserInfo setObject:anException.reason forKey:NSLocalizedDescriptionKey];
+	return [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONGeneralError userInfo:theUserInfo];
+}
+
+/*
+	each worker decodes the next document not yet taken by another worker, reusing its parser and deserializer, the results are stored by index so they are returned in the same order as the data
+ */
+- (NSArray *)objectsForJSONDataArray:(NSArray *)aDataArray encoding:(NSStringEncoding)anEncoding errors:(NSArray **)anErrors
+{
+	NSUInteger			theCount = aDataArray.count,
+						theWorkerCount = MIN( [[NSProcessInfo processInfo] activeProcessorCount], theCount );
+	id					* theDatas = malloc( (theCount > 0 ? theCount : 1)*sizeof(id) ),
+						* theObjects = calloc( theCount > 0 ? theCount : 1, sizeof(id) ),
+						* theErrors = calloc( theCount > 0 ? theCount : 1, sizeof(id) );
+	long				theNextIndex = 0,
+						* theNextIndexPtr = &theNextIndex;
+	NDJSONOptionFlags	theOptions = _options;
+	NSArray				* theResult = nil;
+
+	NSAssert( theDatas != NULL && theObjects != NULL && theErrors != NULL, @"Malloc failure" );
+	[aDataArray getObjects:theDatas range:NSMakeRange(0, theCount)];
+	dispatch_apply( theWorkerCount, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t aWorker)
+	{
+		@autoreleasepool
+		{
+			NDJSONParser		* theJSON = nil;
+			NDJSONDeserializer	* theDeserializer = nil;
+			for( NSUInteger i = (NSUInteger)__sync_fetch_and_add( theNextIndexPtr, 1 ); i < theCount; i = (NSUInteger)__sync_fetch_and_add( theNextIndexPtr, 1 ) )
+			{
+				@autoreleasepool
+				{
+					NSError		* theError = nil;
+					if( theJSON == nil )
+					{
+						theJSON = [[NDJSONParser alloc] init];
+						theDeserializer = [[NDJSONDeserializer alloc] initWithConfiguration:self];
+					}
+					[theJSON setJSONData:theDatas[i] encoding:anEncoding];
+					@try
+					{
+						theObjects[i] = [[theDeserializer objectForJSON:theJSON options:theOptions error:&theError] retain];
+					}
+					@catch( NSException * anException )
+					{
+						theError = NDJSONErrorForException( anException );
+						[theDeserializer release], theDeserializer = nil;			// state of both is unknown after an exception
+						[theJSON release], theJSON = nil;
+					}
+					theErrors[i] = [theError retain];
+				}
+			}
+			[theDeserializer release];
+			[theJSON release];
+		}
+	});
+
+	for( NSUInteger i = 0; i < theCount; i++ )
+	{
+		if( theObjects[i] == nil )
+			theObjects[i] = [[NSNull null] retain];
+		if( theErrors[i] == nil )
+			theErrors[i] = [[NSNull null] retain];
+	}
+	theResult = [NSArray arrayWithObjects:theObjects count:theCount];
+	if( anErrors != NULL )
+		*anErrors = [NSArray arrayWithObjects:theErrors count:theCount];
+	for( NSUInteger i = 0; i < theCount; i++ )
+	{
+		[theObjects[i] release];
+		[theErrors[i] release];
+	}
+	free( theErrors );
+	free( theObjects );
+	free( theDatas );
+	return theResult;
+}
+
+/*
+	built outside of the lock, the classes may send +initialize or build their tables with the NSObject+NDJSONDeserializer methods, if two threads build the same table the first one stored wins
+ */
+static NDJSONPropertyKeyTable * NDJSONSharedKeyTableForClass( NDJSONDeserializerConfiguration * aConfiguration, NDJSONCustomDeserializer * aDeserializer, Class aClass )
+{
+	NDJSONPropertyKeyTable		* theResult = nil;
+	pthread_mutex_lock( &aConfiguration->_keyTablesLock );
+	if( aConfiguration->_keyTablesForClasses != NULL )
+		theResult = (NDJSONPropertyKeyTable *)CFDictionaryGetValue( aConfiguration->_keyTablesForClasses, (const void *)aClass );
+	pthread_mutex_unlock( &aConfiguration->_keyTablesLock );
+
+	if( theResult == nil )
+	{
+		NDJSONPropertyKeyTable	* theNewTable = NDJSONNewKeyTableForClass( aDeserializer, aClass );
+		pthread_mutex_lock( &aConfiguration->_keyTablesLock );
+		if( aConfiguration->_keyTablesForClasses == NULL )
+			aConfiguration->_keyTablesForClasses = CFDictionaryCreateMutable( kCFAllocatorDefault, 0, NULL, &kCFTypeDictionaryValueCallBacks );
+		theResult = (NDJSONPropertyKeyTable *)CFDictionaryGetValue( aConfiguration->_keyTablesForClasses, (const void *)aClass );
+		if( theResult == nil )
+		{
+			CFDictionarySetValue( aConfiguration->_keyTablesForClasses, (const void *)aClass, (const void *)theNewTable );
+			theResult = theNewTable;
+		}
+		pthread_mutex_unlock( &aConfiguration->_keyTablesLock );
+		[theNewTable release];
+	}
+	return theResult;
+}
+
+@end
+
+#pragma mark - NDJSONShapeProfile implementation
+@implementation NDJSONShapeProfile
+
+- (id)init
+{
+	if( (self = [super init]) != nil )
+	{
+		_entries = calloc( kShapeProfileSize, sizeof(uint64_t) );
+		NSAssert( _entries != NULL, @"Malloc failure" );
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	free( _entries );
+	[super dealloc];
+}
+
+- (NSUInteger)expectedCountForKeyPath:(NSArray *)aKeyPath
+{
+	uint64_t	theHash = kShapeRootPathHash;
+	for( id theKey in aKeyPath )
+		theHash = NDJSONShapePathHash( theHash, [theKey isKindOfClass:[NSString class]] ? theKey : nil );
+	return NDJSONShapeProfileExpectedCount( self, theHash );
+}
+
+- (void)removeAllCounts { memset( _entries, 0, kShapeProfileSize*sizeof(uint64_t) ); }
+
+@end
+
+#pragma mark - generated decoders
+
+static pthread_mutex_t			kGeneratedDecodersLock = PTHREAD_MUTEX_INITIALIZER;
+static CFMutableDictionaryRef	kGeneratedDecoders = NULL;
+
+void NDJSONRegisterGeneratedDecoder( Class aClass, const struct NDJSONGeneratedDecoder * aDecoder )
+{
+	NSCParameterAssert( aClass != Nil && aDecoder != NULL );
+	pthread_mutex_lock( &kGeneratedDecodersLock );
+	if( kGeneratedDecoders == NULL )
+		kGeneratedDecoders = CFDictionaryCreateMutable( kCFAllocatorDefault, 0, NULL, NULL );
+	CFDictionarySetValue( kGeneratedDecoders, (const void *)aClass, (const void *)aDecoder );
+	pthread_mutex_unlock( &kGeneratedDecodersLock );
+}
+
+const struct NDJSONGeneratedDecoder * NDJSONGeneratedDecoderForClass( Class aClass )
+{
+	const struct NDJSONGeneratedDecoder		* theResult = NULL;
+	if( aClass != Nil )
+	{
+		pthread_mutex_lock( &kGeneratedDecodersLock );
+		if( kGeneratedDecoders != NULL )
+			theResult = (const struct NDJSONGeneratedDecoder *)CFDictionaryGetValue( kGeneratedDecoders, (const void *)aClass );
+		pthread_mutex_unlock( &kGeneratedDecodersLock );
+	}
+	return theResult;
+}
@@ -0,0 +1,98 @@
+/*
+	NDJSONIndex.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "NDJSONParser.h"
+
+/**
+	The byte offset of every record of a JSON Lines file, or of every element of a JSON file whose root value is an array, and optionally the value of a key path within each record. A record is read by giving its offset to -[NDJSONParser initWithContentsOfFile:offset:encoding:] so the file does not have to be parsed up to it.
+
+	Indexes are created with NDJSONIndexer and can be saved as a sidecar file next to the JSON file, the size and modification date of the JSON file are saved with the index so a stale index can be detected.
+ */
+@interface NDJSONIndex : NSObject
+
++ (NDJSONIndex *)indexWithContentsOfFile:(NSString *)path error:(NSError **)error;
+/**
+	initialize with the bytes of an index file, returns nil if data is not an index.
+ */
+- (id)initWithData:(NSData *)data error:(NSError **)error;
+
+/**
+	number of records
+ */
+@property(readonly,nonatomic)	NSUInteger			count;
+/**
+	the key path of the values indexed, nil if none were
+ */
+@property(readonly,nonatomic)	NSString			* keyPath;
+/**
+	the options the JSON was parsed with
+ */
+@property(readonly,nonatomic)	NDJSONOptionFlags	options;
+
+- (unsigned long long)offsetOfRecordAtIndex:(NSUInteger)index;
+/**
+	the value of keyPath in the record as a string, numbers are indexed by their stringValue, nil if the record did not have a string or number for keyPath.
+ */
+- (NSString *)keyValueOfRecordAtIndex:(NSUInteger)index;
+/**
+	index of the first record with the given value for keyPath, value can be a string or number, returns NSNotFound if there is no such record. A table of the values is built the first time this is called.
+ */
+- (NSUInteger)indexOfRecordWithKeyValue:(id)value;
+
+/**
+	Whether the index was created from the JSON file at path, the size and modification date of the file are compared.
+ */
+- (BOOL)isCurrentForContentsOfFile:(NSString *)path;
+
+- (NSData *)dataRepresentation;
+- (BOOL)writeToFile:(NSString *)path error:(NSError **)error;
+
+@end
+
+/**
+	NDJSONIndexer builds an NDJSONIndex in a single pass, as the delegate of an NDJSONParser. Values that are not on the key path are skipped without being parsed.
+ */
+@interface NDJSONIndexer : NSObject <NDJSONParserDelegate>
+
+/**
+	index the JSON file at path, the size and modification date of the file are recorded in the index.
+ */
++ (NDJSONIndex *)indexForContentsOfFile:(NSString *)path encoding:(NSStringEncoding)encoding options:(NDJSONOptionFlags)options keyPath:(NSString *)keyPath error:(NSError **)error;
+
+/**
+	keyPath is a period separated list of object keys within each record, or nil to only record offsets.
+ */
+- (id)initWithKeyPath:(NSString *)keyPath;
+
+@property(readonly,nonatomic)	NSString			* keyPath;
+
+/**
+	parse the input of parser with the given options and return an index of its records, the root value must be an array unless options includes NDJSONOptionJSONLines.
+ */
+- (NDJSONIndex *)indexForJSONParser:(NDJSONParser *)parser options:(NDJSONOptionFlags)options error:(NSError **)error;
+
+@end
@@ -0,0 +1,452 @@
+/*
+	NDJSONIndex.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import "NDJSONIndex.h"
+
+/*
+	An index is a header followed by the offset of each record, then if there is a key path the offset of each records
+	key value within the key values, the UTF-8 key path and the key values, each a 32 bit length followed by UTF-8 bytes.
+ */
+
+static const uint32_t		kNDJSONIndexMagic = 0x4E444A49;			// NDJI
+static const uint16_t		kNDJSONIndexVersion = 1;
+static const uint64_t		kNDJSONIndexNoKeyValue = UINT64_MAX;
+
+struct NDJSONIndexHeader
+{
+	uint32_t		magic;
+	uint16_t		version;
+	uint16_t		options;
+	uint64_t		sourceSize;
+	int64_t			sourceModificationTime;			// microseconds since 1970
+	uint64_t		count;
+	uint64_t		keyPathLength;
+	uint64_t		keyValuesLength;
+};
+
+static NSError * NDJSONIndexError( NSString * aDescription )
+{
+	return [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONBadFormatError userInfo:[NSDictionary dictionaryWithObject:aDescription forKey:NSLocalizedDescriptionKey]];
+}
+
+static BOOL NDJSONIndexSourceAttributes( NSString * aPath, uint64_t * aSize, int64_t * aModificationTime, NSError ** anError )
+{
+	NSDictionary	* theAttributes = [[NSFileManager defaultManager] attributesOfItemAtPath:aPath error:anError];
+	if( theAttributes == nil )
+		return NO;
+	*aSize = [theAttributes fileSize];
+	*aModificationTime = (int64_t)llround( [[theAttributes fileModificationDate] timeIntervalSince1970]*1.0e6 );
+	return YES;
+}
+
+static NSString * NDJSONIndexKeyValueString( id aValue )
+{
+	if( [aValue isKindOfClass:[NSString class]] )
+		return aValue;
+	else if( [aValue isKindOfClass:[NSNumber class]] )
+		return [aValue stringValue];
+	return nil;
+}
+
+#pragma mark - NDJSONIndex
+
+@interface NDJSONIndex ()
+{
+	NSData							* _data;
+	const struct NDJSONIndexHeader	* _header;
+	const uint64_t					* _offsets;
+	const uint64_t					* _keyValueOffsets;
+	const uint8_t					* _keyValues;
+	NSString						* _keyPath;
+	NSMutableDictionary				* _indexForKeyValue;
+}
+
+- (id)initWithOffsets:(NSData *)offsets keyValues:(NSArray *)keyValues keyPath:(NSString *)keyPath options:(NDJSONOptionFlags)options sourceSize:(uint64_t)size modificationTime:(int64_t)modificationTime;
+
+@end
+
+@implementation NDJSONIndex
+
+@synthesize		keyPath = _keyPath;
+
+- (NSUInteger)count { return (NSUInteger)_header->count; }
+- (NDJSONOptionFlags)options { return _header->options; }
+
+#pragma mark - creation and destruction
+
++ (NDJSONIndex *)indexWithContentsOfFile:(NSString *)aPath error:(NSError **)anError
+{
+	NDJSONIndex		* theResult = nil;
+	NSData			* theData = [[NSData alloc] initWithContentsOfFile:aPath options:NSDataReadingMappedIfSafe error:anError];
+	if( theData != nil )
+		theResult = [[[self alloc] initWithData:theData error:anError] autorelease];
+	[theData release];
+	return theResult;
+}
+
+- (id)initWithData:(NSData *)aData error:(NSError **)anError
+{
+	if( (self = [super init]) != nil )
+	{
+		const struct NDJSONIndexHeader	* theHeader = (const struct NDJSONIndexHeader *)aData.bytes;
+		NSUInteger						theLength = aData.length,
+										theTables = 0;
+		if( theLength >= sizeof(*theHeader) )
+			theTables = theHeader->keyPathLength > 0 ? 2 : 1;
+		if( theTables == 0 || theHeader->magic != kNDJSONIndexMagic || theHeader->version != kNDJSONIndexVersion
+			|| theHeader->count > (theLength-sizeof(*theHeader))/(theTables*sizeof(uint64_t))
+			|| theHeader->keyPathLength > theLength-sizeof(*theHeader)-theHeader->count*theTables*sizeof(uint64_t)
+			|| theHeader->keyValuesLength != theLength-sizeof(*theHeader)-theHeader->count*theTables*sizeof(uint64_t)-theHeader->keyPathLength )
+		{
+			if( anError != NULL )
+				*anError = NDJSONIndexError( @"not a JSON index" );
+			[self release];
+			return nil;
+		}
+		_data = [aData retain];
+		_header = theHeader;
+		_offsets = (const uint64_t *)(theHeader+1);
+		if( theHeader->keyPathLength > 0 )
+		{
+			_keyValueOffsets = _offsets+theHeader->count;
+			_keyPath = [[NSString alloc] initWithBytes:_keyValueOffsets+theHeader->count length:(NSUInteger)theHeader->keyPathLength encoding:NSUTF8StringEncoding];
+			_keyValues = (const uint8_t *)(_keyValueOffsets+theHeader->count)+theHeader->keyPathLength;
+		}
+	}
+	return self;
+}
+
+- (id)initWithOffsets:(NSData *)anOffsets keyValues:(NSArray *)aKeyValues keyPath:(NSString *)aKeyPath options:(NDJSONOptionFlags)anOptions sourceSize:(uint64_t)aSize modificationTime:(int64_t)aModificationTime
+{
+	struct NDJSONIndexHeader	theHeader;
+	NSMutableData				* theData = [[NSMutableData alloc] initWithCapacity:sizeof(theHeader)+anOffsets.length*2];
+	NSData						* theKeyPath = [aKeyPath dataUsingEncoding:NSUTF8StringEncoding];
+	NSMutableData				* theKeyValues = nil;
+
+	memset( &theHeader, 0, sizeof(theHeader) );
+	theHeader.magic = kNDJSONIndexMagic;
+	theHeader.version = kNDJSONIndexVersion;
+	theHeader.options = (uint16_t)anOptions;
+	theHeader.sourceSize = aSize;
+	theHeader.sourceModificationTime = aModificationTime;
+	theHeader.count = anOffsets.length/sizeof(uint64_t);
+	theHeader.keyPathLength = theKeyPath.length;
+	[theData appendBytes:&theHeader length:sizeof(theHeader)];
+	[theData appendData:anOffsets];
+	if( theKeyPath.length > 0 )
+	{
+		theKeyValues = [[NSMutableData alloc] init];
+		for( id theValue in aKeyValues )
+		{
+			uint64_t		theOffset = kNDJSONIndexNoKeyValue;
+			if( theValue != [NSNull null] )
+			{
+				NSData		* theBytes = [theValue dataUsingEncoding:NSUTF8StringEncoding];
+				uint32_t	theLength = (uint32_t)theBytes.length;
+				theOffset = theKeyValues.length;
+				[theKeyValues appendBytes:&theLength length:sizeof(theLength)];
+				[theKeyValues appendData:theBytes];
+			}
+			[theData appendBytes:&theOffset length:sizeof(theOffset)];
+		}
+		[theData appendData:theKeyPath];
+		[theData appendData:theKeyValues];
+		((struct NDJSONIndexHeader *)theData.mutableBytes)->keyValuesLength = theKeyValues.length;
+		[theKeyValues release];
+	}
+	self = [self initWithData:theData error:NULL];
+	[theData release];
+	return self;
+}
+
+- (void)dealloc
+{
+	[_data release];
+	[_keyPath release];
+	[_indexForKeyValue release];
+	[super dealloc];
+}
+
+#pragma mark - records
+
+- (unsigned long long)offsetOfRecordAtIndex:(NSUInteger)anIndex
+{
+	NSParameterAssert( anIndex < _header->count );
+	return _offsets[anIndex];
+}
+
+- (NSString *)keyValueOfRecordAtIndex:(NSUInteger)anIndex
+{
+	NSString		* theResult = nil;
+	NSParameterAssert( anIndex < _header->count );
+	if( _keyValueOffsets != NULL && _keyValueOffsets[anIndex] != kNDJSONIndexNoKeyValue )
+	{
+		uint64_t		theOffset = _keyValueOffsets[anIndex];
+		uint32_t		theLength = 0;
+		if( theOffset <= _header->keyValuesLength && _header->keyValuesLength-theOffset >= sizeof(theLength) )
+		{
+			memcpy( &theLength, _keyValues+theOffset, sizeof(theLength) );
+			if( theLength <= _header->keyValuesLength-theOffset-sizeof(theLength) )
+				theResult = [[[NSString alloc] initWithBytes:_keyValues+theOffset+sizeof(theLength) length:theLength encoding:NSUTF8StringEncoding] autorelease];
+		}
+	}
+	return theResult;
+}
+
+- (NSUInteger)indexOfRecordWithKeyValue:(id)aValue
+{
+	NSNumber		* theResult = nil;
+	if( _keyValueOffsets == NULL )
+		return NSNotFound;
+	if( _indexForKeyValue == nil )
+	{
+		_indexForKeyValue = [[NSMutableDictionary alloc] initWithCapacity:(NSUInteger)_header->count];
+		for( NSUInteger i = 0, theCount = (NSUInteger)_header->count; i < theCount; i++ )
+		{
+			NSString	* theKeyValue = [self keyValueOfRecordAtIndex:i];
+			if( theKeyValue != nil && [_indexForKeyValue objectForKey:theKeyValue] == nil )
+				[_indexForKeyValue setObject:[NSNumber numberWithUnsignedInteger:i] forKey:theKeyValue];
+		}
+	}
+	theResult = [_indexForKeyValue objectForKey:NDJSONIndexKeyValueString(aValue)];
+	return theResult != nil ? [theResult unsignedIntegerValue] : NSNotFound;
+}
+
+#pragma mark - files
+
+- (BOOL)isCurrentForContentsOfFile:(NSString *)aPath
+{
+	uint64_t		theSize = 0;
+	int64_t			theModificationTime = 0;
+	return NDJSONIndexSourceAttributes( aPath, &theSize, &theModificationTime, NULL )
+			&& _header->sourceSize == theSize
+			&& _header->sourceModificationTime == theModificationTime;
+}
+
+- (NSData *)dataRepresentation { return _data; }
+
+- (BOOL)writeToFile:(NSString *)aPath error:(NSError **)anError
+{
+	return [_data writeToFile:aPath options:NSDataWritingAtomic error:anError];
+}
+
+@end
+
+#pragma mark - NDJSONIndexer
+
+@interface NDJSONIndexer ()
+{
+	NSString				* _keyPath;
+	NSArray					* _keyPathComponents;
+	NSMutableData			* _offsets;
+	NSMutableArray			* _keyValues;
+	NSMutableArray			* _path;					// keys from the record to the current value, NSNull for array elements
+	NSUInteger				_depth;
+	NSError					* _error;
+}
+
+- (BOOL)parseJSONParser:(NDJSONParser *)parser options:(NDJSONOptionFlags)options error:(NSError **)error;
+- (NDJSONIndex *)indexWithOptions:(NDJSONOptionFlags)options sourceSize:(uint64_t)size modificationTime:(int64_t)modificationTime;
+
+@end
+
+@implementation NDJSONIndexer
+
+@synthesize		keyPath = _keyPath;
+
++ (NDJSONIndex *)indexForContentsOfFile:(NSString *)aPath encoding:(NSStringEncoding)anEncoding options:(NDJSONOptionFlags)anOptions keyPath:(NSString *)aKeyPath error:(NSError **)anError
+{
+	NDJSONIndex		* theResult = nil;
+	uint64_t		theSize = 0;
+	int64_t			theModificationTime = 0;
+	if( NDJSONIndexSourceAttributes( aPath, &theSize, &theModificationTime, anError ) )
+	{
+		NDJSONParser	* theParser = [[NDJSONParser alloc] initWithContentsOfFile:aPath encoding:anEncoding];
+		NDJSONIndexer	* theIndexer = [[self alloc] initWithKeyPath:aKeyPath];
+		if( theParser != nil && [theIndexer parseJSONParser:theParser options:anOptions error:anError] )
+			theResult = [theIndexer indexWithOptions:anOptions sourceSize:theSize modificationTime:theModificationTime];
+		[theIndexer release];
+		[theParser release];
+	}
+	return theResult;
+}
+
+- (id)initWithKeyPath:(NSString *)aKeyPath
+{
+	if( (self = [super init]) != nil )
+	{
+		if( aKeyPath.length > 0 )
+		{
+			_keyPath = [aKeyPath copy];
+			_keyPathComponents = [[aKeyPath componentsSeparatedByString:@"."] retain];
+		}
+		_offsets = [[NSMutableData alloc] init];
+		_keyValues = [[NSMutableArray alloc] init];
+		_path = [[NSMutableArray alloc] init];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[_keyPath release];
+	[_keyPathComponents release];
+	[_offsets release];
+	[_keyValues release];
+	[_path release];
+	[_error release];
+	[super dealloc];
+}
+
+- (BOOL)parseJSONParser:(NDJSONParser *)aParser options:(NDJSONOptionFlags)anOptions error:(NSError **)anError
+{
+	BOOL		theResult = NO;
+	id			theOriginalDelegate = aParser.delegate;
+	aParser.delegate = self;
+	theResult = [aParser parseWithOptions:anOptions] && _error == nil;
+	if( !theResult && anError != NULL )
+		*anError = _error != nil ? [[_error retain] autorelease] : NDJSONIndexError( @"JSON could not be parsed" );
+	aParser.delegate = theOriginalDelegate;
+	return theResult;
+}
+
+- (NDJSONIndex *)indexWithOptions:(NDJSONOptionFlags)anOptions sourceSize:(uint64_t)aSize modificationTime:(int64_t)aModificationTime
+{
+	return [[[NDJSONIndex alloc] initWithOffsets:_offsets keyValues:_keyValues keyPath:_keyPath options:anOptions sourceSize:aSize modificationTime:aModificationTime] autorelease];
+}
+
+- (NDJSONIndex *)indexForJSONParser:(NDJSONParser *)aParser options:(NDJSONOptionFlags)anOptions error:(NSError **)anError
+{
+	return [self parseJSONParser:aParser options:anOptions error:anError] ? [self indexWithOptions:anOptions sourceSize:0 modificationTime:0] : nil;
+}
+
+#pragma mark - recording
+
+static void NDJSONIndexerFoundError( NDJSONIndexer * self, NDJSONParser * aParser, NSString * aDescription )
+{
+	if( self->_error == nil )
+		self->_error = [NDJSONIndexError( aDescription ) retain];
+	[aParser abortParsing];
+}
+
+/*
+	a value is starting, records are the values in the root array
+ */
+static void NDJSONIndexerStartValue( NDJSONIndexer * self, NDJSONParser * aParser )
+{
+	if( self->_depth == 0 )
+		NDJSONIndexerFoundError( self, aParser, @"the root value is not an array" );
+	else if( self->_depth == 1 )
+	{
+		uint64_t		theOffset = aParser.valueByteOffset;
+		[self->_offsets appendBytes:&theOffset length:sizeof(theOffset)];
+		if( self->_keyPathComponents != nil )
+			[self->_keyValues addObject:[NSNull null]];
+	}
+}
+
+static void NDJSONIndexerFoundScalar( NDJSONIndexer * self, NDJSONParser * aParser, id aValue )
+{
+	NDJSONIndexerStartValue( self, aParser );
+	if( self->_depth > 1 && self->_keyPathComponents != nil && [self->_keyValues lastObject] == [NSNull null] && [self->_path isEqualToArray:self->_keyPathComponents] )
+	{
+		NSString	* theValue = NDJSONIndexKeyValueString( aValue );
+		if( theValue != nil )
+			[self->_keyValues replaceObjectAtIndex:self->_keyValues.count-1 withObject:theValue];
+	}
+}
+
+static void NDJSONIndexerStartContainer( NDJSONIndexer * self, NDJSONParser * aParser )
+{
+	NDJSONIndexerStartValue( self, aParser );
+	[self->_path addObject:[NSNull null]];
+	self->_depth++;
+}
+
+static void NDJSONIndexerEndContainer( NDJSONIndexer * self )
+{
+	self->_depth--;
+	if( self->_depth > 0 )
+		[self->_path removeLastObject];
+}
+
+#pragma mark - NDJSONParserDelegate methods
+
+- (void)jsonParserDidStartDocument:(NDJSONParser *)aJSON
+{
+	[_offsets setLength:0];
+	[_keyValues removeAllObjects];
+	[_path removeAllObjects];
+	[_error release], _error = nil;
+	_depth = 0;
+}
+
+- (void)jsonParserDidStartArray:(NDJSONParser *)aJSON
+{
+	if( _depth == 0 )
+		_depth = 1;
+	else
+		NDJSONIndexerStartContainer( self, aJSON );
+}
+
+- (void)jsonParserDidEndArray:(NDJSONParser *)aJSON { NDJSONIndexerEndContainer( self ); }
+- (void)jsonParserDidStartObject:(NDJSONParser *)aJSON { NDJSONIndexerStartContainer( self, aJSON ); }
+- (void)jsonParserDidEndObject:(NDJSONParser *)aJSON { NDJSONIndexerEndContainer( self ); }
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundKey:(NSString *)aValue
+{
+	[_path replaceObjectAtIndex:_path.count-1 withObject:aValue];
+}
+
+/*
+	only values on the key path need to be parsed
+ */
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldSkipValueForKey:(NSString *)aKey
+{
+	NSUInteger		theCount = _path.count;
+	if( theCount > _keyPathComponents.count )
+		return YES;
+	for( NSUInteger i = 0; i < theCount; i++ )
+	{
+		if( ![[_path objectAtIndex:i] isEqual:[_keyPathComponents objectAtIndex:i]] )
+			return YES;
+	}
+	return NO;
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundString:(NSString *)aValue { NDJSONIndexerFoundScalar( self, aJSON, aValue ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundInteger:(NSInteger)aValue { NDJSONIndexerFoundScalar( self, aJSON, [NSNumber numberWithInteger:aValue] ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundFloat:(double)aValue { NDJSONIndexerFoundScalar( self, aJSON, [NSNumber numberWithDouble:aValue] ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundBool:(BOOL)aValue { NDJSONIndexerFoundScalar( self, aJSON, nil ); }
+- (void)jsonParserFoundNULL:(NDJSONParser *)aJSON { NDJSONIndexerFoundScalar( self, aJSON, nil ); }
+
+- (void)jsonParser:(NDJSONParser *)aJSON error:(NSError *)anError
+{
+	if( _error == nil )
+		_error = [anError retain];
+}
+
+@end
@@ -0,0 +1,49 @@
+/*
+	NDJSONMulticastDelegate.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "NDJSONParser.h"
+
+/**
+	NDJSONMulticastDelegate sends the events of an NDJSONParser to several delegates so one parse can feed several consumers, for example an NDJSONDeserializer and a delegate collecting metrics. The delegates receive the events in the order they are given, with the parser as the parser argument.
+
+	Each delegate can skip values with jsonParser:shouldSkipValueForKey:, a value is only skipped by the parser if every delegate asks to skip it, otherwise it is parsed and the delegates that asked to skip it do not receive any of its events. Key tables from jsonParserKeyTableForCurrentObject: are only used if a single delegate supplies them. Delegates that take strings as bytes with jsonParser:foundStringBytes:length: are sent the bytes, the others are sent a string. A base64 value is only decoded with jsonParser:shouldDecodeBase64ValueForKey: if every delegate it is sent to asks for it, they are then all sent the data with jsonParser:foundData:.
+
+	To deserialize with other delegates, set a multicast delegate containing the NDJSONDeserializer as the parsers delegate before calling -[NDJSONDeserializer objectForJSON:options:error:], the deserializer then leaves it in place.
+ */
+@interface NDJSONMulticastDelegate : NSObject <NDJSONParserDelegate>
+
++ (NDJSONMulticastDelegate *)multicastDelegateWithDelegates:(NSArray *)delegates;
+/**
+	initialize with an array of objects implementing NDJSONParserDelegate, the delegates are retained.
+ */
+- (id)initWithDelegates:(NSArray *)delegates;
+
+@property(readonly,nonatomic)	NSArray		* delegates;
+
+- (BOOL)containsDelegate:(id<NDJSONParserDelegate>)delegate;
+
+@end
@@ -0,0 +1,396 @@
+/*
+	NDJSONMulticastDelegate.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import "NDJSONMulticastDelegate.h"
+#import "NDJSONParserPrivate.h"
+
+/*
+	a delegate with the methods it implements, skipDepth is the depth of the containers the delegate is skipping within, skipNextValue is set when the delegate asked to skip a value the parser is not skipping
+ */
+struct NDJSONMulticastEntry
+{
+	id								delegate;
+	struct NDJSONDelegateMethods	method;
+	NSUInteger						skipDepth;
+	BOOL							skipNextValue;
+};
+
+enum NDJSONMulticastEvent
+{
+	NDJSONMulticastKeyEvent,
+	NDJSONMulticastValueEvent,
+	NDJSONMulticastStartContainerEvent,
+	NDJSONMulticastEndContainerEvent
+};
+
+@interface NDJSONMulticastDelegate ()
+{
+	NSArray							* _delegates;
+	NSUInteger						_count;
+	struct NDJSONMulticastEntry		* _entries;
+	struct NDJSONMulticastEntry		* _keyTableEntry;			// the only delegate that supplies key tables
+}
+- (void)setUpRespondsTo;
+@end
+
+@implementation NDJSONMulticastDelegate
+
+@synthesize		delegates = _delegates;
+
+#pragma mark - creation and destruction
+
++ (NDJSONMulticastDelegate *)multicastDelegateWithDelegates:(NSArray *)aDelegates
+{
+	return [[[self alloc] initWithDelegates:aDelegates] autorelease];
+}
+
+- (id)initWithDelegates:(NSArray *)aDelegates
+{
+	NSParameterAssert( aDelegates != nil );
+	if( (self = [super init]) != nil )
+	{
+		_delegates = [aDelegates copy];
+		_count = _delegates.count;
+		_entries = calloc( _count > 0 ? _count : 1, sizeof(struct NDJSONMulticastEntry) );
+		NSAssert( _entries != NULL, @"Malloc failure" );
+		[self setUpRespondsTo];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	free( _entries );
+	[_delegates release];
+	[super dealloc];
+}
+
+- (BOOL)containsDelegate:(id<NDJSONParserDelegate>)aDelegate { return [_delegates indexOfObjectIdenticalTo:aDelegate] != NSNotFound; }
+
+#pragma mark - event dispatch
+
+/*
+	whether a delegate is sent the event, and tracks the containers within values it asked to skip
+ */
+static BOOL NDJSONMulticastShouldSend( struct NDJSONMulticastEntry * anEntry, enum NDJSONMulticastEvent anEvent )
+{
+	BOOL		theResult = NO;
+	if( anEntry->skipDepth > 0 )
+	{
+		if( anEvent == NDJSONMulticastStartContainerEvent )
+			anEntry->skipDepth++;
+		else if( anEvent == NDJSONMulticastEndContainerEvent )
+			anEntry->skipDepth--;
+	}
+	else if( anEntry->skipNextValue && anEvent != NDJSONMulticastKeyEvent )
+	{
+		anEntry->skipNextValue = NO;
+		if( anEvent == NDJSONMulticastStartContainerEvent )
+			anEntry->skipDepth = 1;
+	}
+	else
+		theResult = YES;
+	return theResult;
+}
+
+#pragma mark - NDJSONParserDelegate methods
+
+- (void)jsonParserDidStartDocument:(NDJSONParser *)aJSON
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		theEntry->skipDepth = 0;
+		theEntry->skipNextValue = NO;
+		if( theEntry->method.didStartDocument != NULL )
+			((NDVoidMethodIMP)theEntry->method.didStartDocument)( theEntry->delegate, @selector(jsonParserDidStartDocument:), aJSON );
+	}
+}
+
+- (void)jsonParserDidEndDocument:(NDJSONParser *)aJSON
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( theEntry->method.didEndDocument != NULL )
+			((NDVoidMethodIMP)theEntry->method.didEndDocument)( theEntry->delegate, @selector(jsonParserDidEndDocument:), aJSON );
+	}
+}
+
+- (void)jsonParserDidStartArray:(NDJSONParser *)aJSON
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastStartContainerEvent ) && theEntry->method.didStartArray != NULL )
+			((NDVoidMethodIMP)theEntry->method.didStartArray)( theEntry->delegate, @selector(jsonParserDidStartArray:), aJSON );
+	}
+}
+
+- (void)jsonParserDidEndArray:(NDJSONParser *)aJSON
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastEndContainerEvent ) && theEntry->method.didEndArray != NULL )
+			((NDVoidMethodIMP)theEntry->method.didEndArray)( theEntry->delegate, @selector(jsonParserDidEndArray:), aJSON );
+	}
+}
+
+- (void)jsonParserDidStartObject:(NDJSONParser *)aJSON
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastStartContainerEvent ) && theEntry->method.didStartObject != NULL )
+			((NDVoidMethodIMP)theEntry->method.didStartObject)( theEntry->delegate, @selector(jsonParserDidStartObject:), aJSON );
+	}
+}
+
+- (void)jsonParserDidEndObject:(NDJSONParser *)aJSON
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastEndContainerEvent ) && theEntry->method.didEndObject != NULL )
+			((NDVoidMethodIMP)theEntry->method.didEndObject)( theEntry->delegate, @selector(jsonParserDidEndObject:), aJSON );
+	}
+}
+
+- (NDJSONKeyTable *)jsonParserKeyTableForCurrentObject:(NDJSONParser *)aJSON
+{
+	return _keyTableEntry != NULL && _keyTableEntry->skipDepth == 0
+			? ((NDKeyTableMethodIMP)_keyTableEntry->method.keyTableForCurrentObject)( _keyTableEntry->delegate, @selector(jsonParserKeyTableForCurrentObject:), aJSON )
+			: nil;
+}
+
+/*
+	delegates already skipping the value containing the key agree to skip it
+ */
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldSkipValueForKey:(NSString *)aKey
+{
+	BOOL		theResult = YES;
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( theEntry->skipDepth == 0 )
+		{
+			theEntry->skipNextValue = theEntry->method.shouldSkipValueForKey != NULL
+						&& ((NDReturnBoolMethodIMP)theEntry->method.shouldSkipValueForKey)( theEntry->delegate, @selector(jsonParser:shouldSkipValueForKey:), aJSON, aKey );
+			if( !theEntry->skipNextValue )
+				theResult = NO;
+		}
+	}
+	if( theResult )										// the parser skips the value so no events for it will be sent
+	{
+		for( NSUInteger i = 0; i < _count; i++ )
+			_entries[i].skipNextValue = NO;
+	}
+	return theResult;
+}
+
+/*
+	the value is only decoded if every delegate that is sent it asks for it to be decoded, otherwise they are all sent the string
+ */
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldDecodeBase64ValueForKey:(NSString *)aKey
+{
+	BOOL		theResult = NO;
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( theEntry->skipDepth == 0 && !theEntry->skipNextValue )
+		{
+			if( theEntry->method.shouldDecodeBase64ValueForKey == NULL || theEntry->method.foundData == NULL
+				|| !((NDReturnBoolMethodIMP)theEntry->method.shouldDecodeBase64ValueForKey)( theEntry->delegate, @selector(jsonParser:shouldDecodeBase64ValueForKey:), aJSON, aKey ) )
+				return NO;
+			theResult = YES;
+		}
+	}
+	return theResult;
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundKey:(NSString *)aValue
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastKeyEvent ) && theEntry->method.foundKey != NULL )
+			((NDObjectMethodIMP)theEntry->method.foundKey)( theEntry->delegate, @selector(jsonParser:foundKey:), aJSON, aValue );
+	}
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundString:(NSString *)aValue
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastValueEvent ) && theEntry->method.foundString != NULL )
+			((NDObjectMethodIMP)theEntry->method.foundString)( theEntry->delegate, @selector(jsonParser:foundString:), aJSON, aValue );
+	}
+}
+
+/*
+	the parser sends the bytes of strings instead of strings because some of the delegates take bytes, the others are sent
+	a string created once for all of them
+ */
+- (void)jsonParser:(NDJSONParser *)aJSON foundStringBytes:(const uint8_t *)aBytes length:(NSUInteger)aLength
+{
+	NSString		* theValue = nil;
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastValueEvent ) )
+		{
+			if( theEntry->method.foundStringBytes != NULL )
+				((NDBytesMethodIMP)theEntry->method.foundStringBytes)( theEntry->delegate, @selector(jsonParser:foundStringBytes:length:), aJSON, aBytes, aLength );
+			else if( theEntry->method.foundString != NULL )
+			{
+				if( theValue == nil )
+					theValue = [[NSString alloc] initWithBytes:aBytes length:aLength encoding:NSUTF8StringEncoding];
+				((NDObjectMethodIMP)theEntry->method.foundString)( theEntry->delegate, @selector(jsonParser:foundString:), aJSON, theValue );
+			}
+		}
+	}
+	[theValue release];
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundData:(NSData *)aValue
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastValueEvent ) && theEntry->method.foundData != NULL )
+			((NDObjectMethodIMP)theEntry->method.foundData)( theEntry->delegate, @selector(jsonParser:foundData:), aJSON, aValue );
+	}
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundInteger:(NSInteger)aValue
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastValueEvent ) )
+		{
+			if( theEntry->method.foundNumber != NULL )
+				((NDObjectMethodIMP)theEntry->method.foundNumber)( theEntry->delegate, @selector(jsonParser:foundNumber:), aJSON, [NSNumber numberWithInteger:aValue] );
+			else if( theEntry->method.foundInteger != NULL )
+				((NDIntegerMethodIMP)theEntry->method.foundInteger)( theEntry->delegate, @selector(jsonParser:foundInteger:), aJSON, aValue );
+		}
+	}
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundUnsignedInteger:(unsigned long long)aValue
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastValueEvent ) )
+		{
+			if( theEntry->method.foundNumber != NULL )
+				((NDObjectMethodIMP)theEntry->method.foundNumber)( theEntry->delegate, @selector(jsonParser:foundNumber:), aJSON, [NSNumber numberWithUnsignedLongLong:aValue] );
+			else if( theEntry->method.foundUnsignedInteger != NULL )
+				((NDUnsignedIntegerMethodIMP)theEntry->method.foundUnsignedInteger)( theEntry->delegate, @selector(jsonParser:foundUnsignedInteger:), aJSON, aValue );
+			else if( theEntry->method.foundFloat != NULL )
+				((NDFloatMethodIMP)theEntry->method.foundFloat)( theEntry->delegate, @selector(jsonParser:foundFloat:), aJSON, (double)aValue );
+		}
+	}
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundFloat:(double)aValue
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastValueEvent ) )
+		{
+			if( theEntry->method.foundNumber != NULL )
+				((NDObjectMethodIMP)theEntry->method.foundNumber)( theEntry->delegate, @selector(jsonParser:foundNumber:), aJSON, [NSNumber numberWithDouble:aValue] );
+			else if( theEntry->method.foundFloat != NULL )
+				((NDFloatMethodIMP)theEntry->method.foundFloat)( theEntry->delegate, @selector(jsonParser:foundFloat:), aJSON, aValue );
+		}
+	}
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundBool:(BOOL)aValue
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastValueEvent ) )
+		{
+			if( theEntry->method.foundNumber != NULL )
+				((NDObjectMethodIMP)theEntry->method.foundNumber)( theEntry->delegate, @selector(jsonParser:foundNumber:), aJSON, [NSNumber numberWithBool:aValue] );
+			else if( theEntry->method.foundBool != NULL )
+				((NDBoolMethodIMP)theEntry->method.foundBool)( theEntry->delegate, @selector(jsonParser:foundBool:), aJSON, aValue );
+		}
+	}
+}
+
+- (void)jsonParserFoundNULL:(NDJSONParser *)aJSON
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( NDJSONMulticastShouldSend( theEntry, NDJSONMulticastValueEvent ) && theEntry->method.foundNULL != NULL )
+			((NDVoidMethodIMP)theEntry->method.foundNULL)( theEntry->delegate, @selector(jsonParserFoundNULL:), aJSON );
+	}
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON error:(NSError *)anError
+{
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		if( theEntry->method.foundError != NULL )
+			((NDObjectMethodIMP)theEntry->method.foundError)( theEntry->delegate, @selector(jsonParser:error:), aJSON, anError );
+	}
+}
+
+#pragma mark - private
+
+/*
+	the delegates can not change so their methods are looked up once
+ */
+- (void)setUpRespondsTo
+{
+	NSUInteger		theKeyTableCount = 0;
+	for( NSUInteger i = 0; i < _count; i++ )
+	{
+		struct NDJSONMulticastEntry		* theEntry = &_entries[i];
+		NSObject						* theDelegate = [_delegates objectAtIndex:i];
+		theEntry->delegate = theDelegate;
+		NDJSONGetDelegateMethods( &theEntry->method, theDelegate );
+		if( theEntry->method.keyTableForCurrentObject != NULL )
+		{
+			_keyTableEntry = theEntry;
+			theKeyTableCount++;
+		}
+	}
+	if( theKeyTableCount != 1 )				// the delegates would read each others key indexes
+		_keyTableEntry = NULL;
+}
+
+@end
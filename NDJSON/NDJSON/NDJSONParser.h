@@ -31,6 +31,8 @@ extern NSString			* const kNDJSONNoInputSourceExpection;
 //#define NDJSONSupportUTF8Only
 //#define NDJSONDebug
 //#define NDJSONPrintStream
+//#define NDJSONCollectStatistics
+//#define NDJSONUSDTProbes
 
 typedef enum
 {
@@ -53,7 +55,10 @@ typedef enum
 	NDJSONTrailingGarbageError,
 	NDJSONMemoryErrorError,
 	NDJSONPrematureEndError,
-	NDJSONBadNumberError
+	NDJSONBadNumberError,
+	NDJSONBadBase64Error,
+	NDJSONTypeMismatchError,
+	NDJSONInflateError
 }		NDJSONErrorCode;
 
 typedef NSInteger (*NDJSONDataStreamProc)(uint8_t ** aBuffer, void * aContext );
@@ -71,11 +76,17 @@ typedef NS_OPTIONS(NSUInteger, NDJSONOptionFlags)
 	 - control characters are allowed in strings (including quoted keys)
  */
 	NDJSONOptionStrict = 1<<0,
+/**
+	the source is a sequence of JSON values separated by white space, as in JSON Lines, the values are reported as the elements of a single top level array.
+ */
+	NDJSONOptionJSONLines = 1<<1,
 };
 
 extern NSString	* const NDJSONErrorDomain;
 
 @protocol		NDJSONParserDelegate;
+@class			NDJSONKeyTable,
+				NDJSONParseStatistics;
 
 /**
  Instances of this class parse JSON documents in an event-driven manner. An NDJSONParser notifies its delegate about the JSON items (objects, arrays, strings, integers, floats, booleans and nulls) that it encounters as it processes an JSON document. It does not itself do anything with those parsed items except report them. It also reports parsing errors. NDJSONParser does not need to have the entire source JSON document in memory.
@@ -92,6 +103,15 @@ extern NSString	* const NDJSONErrorDomain;
  */
 @property(readonly,nonatomic)	NSString			* currentKey;
 
+/**
+	If the current key was found in the key table supplied by the delegate for the current object, the index of the key within the table, otherwise NSNotFound.
+ */
+@property(readonly,nonatomic)	NSUInteger			currentKeyIndex;
+/**
+	The key table supplied by the delegate for the object containing the current key, or nil.
+ */
+@property(readonly,nonatomic)	NDJSONKeyTable		* currentKeyTable;
+
 /**
  Returns the line number of the JSON document being processed by the receiver.
  */
@@ -99,6 +119,29 @@ extern NSString	* const NDJSONErrorDomain;
 
 @property(readonly,nonatomic)	NSUInteger			columnNumber;
 
+/**
+	The offset in bytes from the start of the input of the first character of the value being parsed, for containers this is the offset of the value that started the current event. Offsets into compressed input are offsets into the inflated bytes. Used with initWithContentsOfFile:offset:encoding: to return to a value without parsing what comes before it.
+ */
+@property(readonly,nonatomic)	unsigned long long	valueByteOffset;
+
+/**
+	Whether the input was found to be gzip or zlib compressed, compressed input is detected from its first bytes and inflated as it is parsed.
+ */
+@property(readonly,nonatomic,getter=isCompressed)	BOOL	compressed;
+/**
+	CPU time spent by the last call to parseWithOptions: reading and inflating compressed input.
+ */
+@property(readonly,nonatomic)	NSTimeInterval		inflateTime;
+/**
+	CPU time spent by the last call to parseWithOptions: excluding inflateTime, this includes the time spent in the delegate. Only measured for compressed input, from when inflating starts, unless NDJSON is compiled with NDJSONCollectStatistics defined, otherwise 0.
+ */
+@property(readonly,nonatomic)	NSTimeInterval		parseTime;
+
+/**
+	Counters updated while parsing, only collected if NDJSON is compiled with NDJSONCollectStatistics defined, otherwise setting this has no effect. The default is nil.
+ */
+@property(retain,nonatomic)		NDJSONParseStatistics	* statistics;
+
 /**
  set a JSON string to parse
  */
@@ -108,9 +151,17 @@ extern NSString	* const NDJSONErrorDomain;
  */
 - (id)initWithJSONData:(NSData *)data encoding:(NSStringEncoding)encoding;
 /**
-	set a JSON file to parse specified using a string path
+	set a JSON file to parse specified using a string path, the file may be gzip compressed
  */
 - (id)initWithContentsOfFile:(NSString *)path encoding:(NSStringEncoding)encoding;
+/**
+	set JSON data to parse a single value from starting at offset, offset is usually a valueByteOffset reported when the data was parsed before. Only the value is parsed, anything after it is ignored.
+ */
+- (id)initWithJSONData:(NSData *)data offset:(NSUInteger)offset encoding:(NSStringEncoding)encoding;
+/**
+	set a JSON file to parse a single value from starting at offset, the file is memory mapped so the bytes before offset are never read.
+ */
+- (id)initWithContentsOfFile:(NSString *)path offset:(unsigned long long)offset encoding:(NSStringEncoding)encoding;
 /**
 	set a JSON file to parse specified using a file URL
  */
@@ -127,6 +178,47 @@ extern NSString	* const NDJSONErrorDomain;
 	set a function for supplying the data stream
  */
 - (id)initWithSourceBlock:(NDJSONDataStreamBlock)block encoding:(NSStringEncoding)anEncoding;
+
+/**
+	Discards the current input and the state of the last parse so the receiver can be given another input, the delegate, statistics and the receivers buffers are kept. Each input is parsed once, the set methods below reset the receiver so they can be used to parse many small documents without creating a new parser for each.
+ */
+- (void)reset;
+/**
+	set a JSON string to parse, returns NO if the strings characters can not be accessed directly
+ */
+- (BOOL)setJSONString:(NSString *)string;
+/**
+	set JSON data to parse
+ */
+- (void)setJSONData:(NSData *)data encoding:(NSStringEncoding)encoding;
+/**
+	set a JSON file to parse specified using a string path, returns NO if the file can not be opened
+ */
+- (BOOL)setContentsOfFile:(NSString *)path encoding:(NSStringEncoding)encoding;
+/**
+	set JSON data to parse a single value from starting at offset
+ */
+- (void)setJSONData:(NSData *)data offset:(NSUInteger)offset encoding:(NSStringEncoding)encoding;
+/**
+	set a JSON file to parse a single value from starting at offset, returns NO if the file can not be mapped or is shorter than offset
+ */
+- (BOOL)setContentsOfFile:(NSString *)path offset:(unsigned long long)offset encoding:(NSStringEncoding)encoding;
+/**
+	set a JSON file to parse specified using a file URL, returns NO if the URL can not be opened
+ */
+- (BOOL)setContentsOfURL:(NSURL *)url encoding:(NSStringEncoding)encoding;
+/**
+	set an input stream to parse
+ */
+- (void)setInputStream:(NSInputStream *)stream encoding:(NSStringEncoding)encoding;
+/**
+	set a function for supplying the data stream
+ */
+- (void)setSourceFunction:(NDJSONDataStreamProc)function context:(void*)context encoding:(NSStringEncoding)encoding;
+/**
+	set a block for supplying the data stream
+ */
+- (void)setSourceBlock:(NDJSONDataStreamBlock)block encoding:(NSStringEncoding)encoding;
 /**
 	parses the JSON source set up by one other the set methods, setJSONString:error:, setContentsOfFile:error:, setContentsOfURL:error, setURLRequest:error:
 	Important: This method does not return until parsing is complete, this method can be called within another thread as long as you do not change the reciever until after the method has finished.
@@ -134,7 +226,7 @@ extern NSString	* const NDJSONErrorDomain;
 - (BOOL)parseWithOptions:(NDJSONOptionFlags)options;
 
 /**
- Stops the parser object.
+ Stops the parser object, parseWithOptions: then returns NO.
  */
 - (void)abortParsing;
 
@@ -170,10 +262,22 @@ extern NSString	* const NDJSONErrorDomain;
 	Sent by a parser object to its delegate when it encounters an the of a JSON object. 
  */
 - (void)jsonParserDidEndObject:(NDJSONParser *)parser;
+/**
+	Sent by a parser object to its delegate after jsonParserDidStartObject: to give the delegate a chance to supply the set of keys it expects for the object. Keys found in the table are reported using the tables own strings, no NSString is created for them, and their index is available from currentKeyIndex. Only used for 8 bit encodings.
+ */
+- (NDJSONKeyTable *)jsonParserKeyTableForCurrentObject:(NDJSONParser *)parser;
 /**
 	Sent by a parser object to its delegate to give the delegate a chance to tell the parser to skip parsing the value for the current key.
  */
 - (BOOL)jsonParser:(NDJSONParser *)parser shouldSkipValueForKey:(NSString *)key;
+/**
+	Sent by a parser object to its delegate when it encounters a key that is not in the key table the delegate supplied with jsonParserKeyTableForCurrentObject:. If the delegate returns YES the value for the key is skipped without creating an NSString for the key, and jsonParser:foundKey: and jsonParser:shouldSkipValueForKey: are not sent for it. Only sent when the source is UTF-8, ASCII or NonLossyASCII, or an NSString whose characters are all ASCII, otherwise keys not in the table are reported as usual.
+ */
+- (BOOL)jsonParser:(NDJSONParser *)parser shouldSkipValueForKeyNotInKeyTable:(NDJSONKeyTable *)keyTable;
+/**
+	Sent by a parser object to its delegate after jsonParser:shouldSkipValueForKey: to ask whether the value for the current key is base64 encoded binary data. If the delegate returns YES and the value is a string it is decoded straight from the input into an NSData, no NSString is created, and reported with jsonParser:foundData: instead of jsonParser:foundString:. Both the standard and URL safe alphabets are accepted, padding is optional and white space is ignored. Only sent if the delegate implements jsonParser:foundData:.
+ */
+- (BOOL)jsonParser:(NDJSONParser *)parser shouldDecodeBase64ValueForKey:(NSString *)key;
 /**
 	Sent by a parser object to its delegate when it encounters a JSON key in the JSON source.
  */
@@ -182,6 +286,14 @@ extern NSString	* const NDJSONErrorDomain;
 	Sent by a parser object to its delegate when it encounters a JSON string in the JSON source.
  */
 - (void)jsonParser:(NDJSONParser *)parser foundString:(NSString *)aValue;
+/**
+	Sent by a parser object to its delegate instead of jsonParser:foundString: when it encounters a JSON string, with the unescaped bytes of the string, no NSString is created. The bytes are UTF-8 and only valid for the duration of the call. Only sent when the source is UTF-8, ASCII or NonLossyASCII, or an NSString whose characters are all ASCII, otherwise strings are still reported with jsonParser:foundString:.
+ */
+- (void)jsonParser:(NDJSONParser *)parser foundStringBytes:(const uint8_t *)bytes length:(NSUInteger)length;
+/**
+	Sent by a parser object to its delegate when it decodes a base64 string the delegate asked for with jsonParser:shouldDecodeBase64ValueForKey:.
+ */
+- (void)jsonParser:(NDJSONParser *)parser foundData:(NSData *)data;
 /**
 	 Sent by a parser object to its delegate when it encounters a JSON number or boolean in the JSON source.
  */
@@ -191,6 +303,10 @@ extern NSString	* const NDJSONErrorDomain;
 	An integer is a number in JSON which does not contain a decimal place
  */
 - (void)jsonParser:(NDJSONParser *)parser foundInteger:(NSInteger)aValue;
+/**
+	Sent by a parser object to its delegate instead of jsonParser:foundInteger: when it encounters a JSON integer number too large for a long long that fits in an unsigned long long, the value is exact. Delegates that do not implement it are sent jsonParser:foundFloat: instead.
+ */
+- (void)jsonParser:(NDJSONParser *)parser foundUnsignedInteger:(unsigned long long)aValue;
 /**
 	Sent by a parser object to its delegate when it encounters a JSON float number in the JSON source.
 	An float is a number in JSON which contains a decimal place
@@ -211,6 +327,129 @@ extern NSString	* const NDJSONErrorDomain;
 
 @end
 
+/**
+	An immutable table of object keys used by NDJSONParser to match the raw UTF-8 bytes of keys without creating an NSString for them.
+ */
+@interface NDJSONKeyTable : NSObject
+
+/**
+	initialize with an array of key strings, the index of each key is its index within the array.
+ */
+- (id)initWithKeys:(NSArray *)keys;
+
+@property(readonly,nonatomic)	NSArray			* keys;
+@property(readonly,nonatomic)	NSUInteger		count;
+
+- (NSString *)keyAtIndex:(NSUInteger)index;
+/**
+	returns the index of the key with the given UTF-8 bytes or NSNotFound.
+ */
+- (NSUInteger)indexForKeyBytes:(const uint8_t *)bytes length:(NSUInteger)length;
+
+@end
+
+typedef enum
+{
+	NDJSONTokenNone,					// the end of the input, or an error
+	NDJSONTokenStartObject,
+	NDJSONTokenEndObject,
+	NDJSONTokenStartArray,
+	NDJSONTokenEndArray,
+	NDJSONTokenKey,
+	NDJSONTokenString,
+	NDJSONTokenNumber,					// only returned by peekTokenType, whether a number is an integer or a float is not known until it is read
+	NDJSONTokenInteger,
+	NDJSONTokenFloat,
+	NDJSONTokenBool,
+	NDJSONTokenNull
+}		NDJSONTokenType;
+
+/**
+	NDJSONReader reads JSON a token at a time as its caller asks for them, rather than pushing events to a delegate, so a hand written decoder can keep its state in its own code. It reads any of the inputs of NDJSONParser, refilling from streams as it goes, no objects are created for keys or strings, their bytes are only valid until the next token is read. Values that are not wanted are skipped with the same scanner the parser uses to skip values.
+
+	A typical decoder calls enterObject then loops on nextKeyBytes:, reading or skipping the value for each key, and likewise enterArray then loops on nextElement. With NDJSONOptionJSONLines each record is read as a separate root value. The delegate of a reader is used internally and should not be set.
+ */
+@interface NDJSONReader : NDJSONParser
+
+/**
+	start reading the input set with one of the set methods, returns NO if no input is set.
+ */
+- (BOOL)startWithOptions:(NDJSONOptionFlags)options;
+/**
+	finish reading before the end of the input, closing any stream, done by the set methods and reset as well.
+ */
+- (void)finish;
+
+/**
+	the first error found, once there is an error nextToken returns NDJSONTokenNone.
+ */
+@property(readonly,nonatomic)	NSError				* error;
+/**
+	the number of objects and arrays the reader is within.
+ */
+@property(readonly,nonatomic)	NSUInteger			depth;
+
+/**
+	read the next token, its value is available from the properties below.
+ */
+- (NDJSONTokenType)nextToken;
+/**
+	the type of the next token without reading it.
+ */
+- (NDJSONTokenType)peekTokenType;
+
+@property(readonly,nonatomic)	int64_t				integerValue;
+/**
+	the value of a float token, or of an integer token as a double.
+ */
+@property(readonly,nonatomic)	double				floatValue;
+@property(readonly,nonatomic)	BOOL				boolValue;
+/**
+	the unescaped bytes of a key or string token in the character encoding of the input, valid until the next token is read.
+ */
+@property(readonly,nonatomic)	const uint8_t		* stringBytes;
+@property(readonly,nonatomic)	NSUInteger			stringLength;
+
+/**
+	read the next value if it is an integer, returns NO without reading it if it is not a number, a number with a fraction or exponent is read and NO returned.
+ */
+- (BOOL)readInt64:(int64_t *)value;
+/**
+	read the next value if it is a number.
+ */
+- (BOOL)readDouble:(double *)value;
+/**
+	read the next value if it is a boolean.
+ */
+- (BOOL)readBool:(BOOL *)value;
+/**
+	read the next value if it is a string, returns its bytes or NULL if it is not a string.
+ */
+- (const uint8_t *)readStringBytes:(NSUInteger *)length;
+/**
+	skip the next value, including any object or array it starts, if the next token is a key then the key and its value are skipped. Returns NO if there is no value to skip, at the end of an object or array.
+ */
+- (BOOL)skipValue;
+
+/**
+	read the start of an object, returns NO without reading anything if the next value is not an object.
+ */
+- (BOOL)enterObject;
+/**
+	read the next key of the object entered, returns NULL at the end of the object, having read the end. The value of each key must be read or skipped before the next key.
+ */
+- (const uint8_t *)nextKeyBytes:(NSUInteger *)length;
+/**
+	read the start of an array, returns NO without reading anything if the next value is not an array.
+ */
+- (BOOL)enterArray;
+/**
+	returns YES if there is another element in the array entered, NO at the end of the array, having read the end. Each element must be read or skipped before the next call.
+ */
+- (BOOL)nextElement;
+
+@end
+
 /*
  Private functions
  */
@@ -218,3 +457,67 @@ BOOL NDJSONParserValueIsPrimativeType( NDJSONValueType type );
 BOOL NDJSONParserValueIsNSNumberType( NDJSONValueType type );
 BOOL NDJSONParserValueEquivelentObjectTypes( NDJSONValueType typeA, NDJSONValueType typeB );
 
+/**
+	Counters for where the time and work of parsing goes, set an instance as the statistics of an NDJSONParser or NDJSONDeserializer to collect them. Counters are accumulated across parses until reset.
+
+	The counters are only collected if NDJSON is compiled with NDJSONCollectStatistics defined, without it the code for them is not compiled in at all. Likewise defining NDJSONUSDTProbes on Linux adds the static tracepoints ndjson:document__start, ndjson:document__end, ndjson:record__start, ndjson:record__end, ndjson:refill__start and ndjson:refill__end for perf and bpftrace.
+ */
+@interface NDJSONParseStatistics : NSObject
+
+/**
+	bytes handed to the scanner, after inflating compressed input
+ */
+@property(readonly,nonatomic)	NSUInteger			bytesConsumed;
+/**
+	number of times the input buffer was refilled from the source
+ */
+@property(readonly,nonatomic)	NSUInteger			refillCount;
+/**
+	wall clock time spent waiting for the source to refill the buffer, including inflating
+ */
+@property(readonly,nonatomic)	NSTimeInterval		sourceTime;
+@property(readonly,nonatomic)	NSUInteger			objectCount;
+@property(readonly,nonatomic)	NSUInteger			arrayCount;
+@property(readonly,nonatomic)	NSUInteger			keyCount;
+@property(readonly,nonatomic)	NSUInteger			stringCount;
+@property(readonly,nonatomic)	NSUInteger			integerCount;
+@property(readonly,nonatomic)	NSUInteger			floatCount;
+@property(readonly,nonatomic)	NSUInteger			booleanCount;
+@property(readonly,nonatomic)	NSUInteger			nullCount;
+/**
+	deepest nesting of objects and arrays
+ */
+@property(readonly,nonatomic)	NSUInteger			maximumDepth;
+/**
+	NSStrings created for keys and string values, keys matched with a key table create none
+ */
+@property(readonly,nonatomic)	NSUInteger			stringsCreated;
+@property(readonly,nonatomic)	NSUInteger			stringBytesCopied;
+/**
+	keys the delegate returned YES for from jsonParser:shouldSkipValueForKey:
+ */
+@property(readonly,nonatomic)	NSUInteger			skippedKeyCount;
+/**
+	documents parsed, with NDJSONOptionJSONLines every record is a document
+ */
+@property(readonly,nonatomic)	NSUInteger			documentCount;
+/**
+	wall clock time spent in parseWithOptions:
+ */
+@property(readonly,nonatomic)	NSTimeInterval		totalTime;
+/**
+	wall clock time spent in the delegate methods
+ */
+@property(readonly,nonatomic)	NSTimeInterval		delegateTime;
+/**
+	totalTime excluding delegateTime and sourceTime
+ */
+@property(readonly,nonatomic)	NSTimeInterval		scannerTime;
+
+- (void)reset;
+/**
+	all counters keyed by their property names, for logging
+ */
+- (NSDictionary *)dictionaryRepresentation;
+
+@end
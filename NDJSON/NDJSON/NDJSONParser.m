@@ -29,11 +29,16 @@
 
 #import <Foundation/Foundation.h>
 #import "NDJSONParser.h"
+#import "NDJSONParserPrivate.h"
+#import <objc/runtime.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
 #include <string.h>
 #include <ctype.h>
+#include <time.h>
+#include <zlib.h>
+#include <pthread.h>
 
 NSString			* const kNDJSONNoInputSourceExpection = @"NDJSONNoInputSource";
 
@@ -43,6 +48,65 @@ NSString			* const kNDJSONNoInputSourceExpection = @"NDJSONNoInputSource";
 #define NDJSONLog(...)
 #endif
 
+/*
+	everything to do with NDJSONParseStatistics compiles to nothing unless NDJSONCollectStatistics is defined
+ */
+struct NDJSONParseCounters
+{
+	NSUInteger			bytesConsumed,
+						refillCount,
+						objectCount,
+						arrayCount,
+						keyCount,
+						stringCount,
+						integerCount,
+						floatCount,
+						booleanCount,
+						nullCount,
+						depth,
+						maximumDepth,
+						stringsCreated,
+						stringBytesCopied,
+						skippedKeyCount,
+						documentCount;
+	NSTimeInterval		sourceTime,
+						delegateTime,
+						totalTime;
+};
+
+#ifdef NDJSONCollectStatistics
+static NSTimeInterval NDJSONMonotonicTime( void )
+{
+	struct timespec		theTime;
+	clock_gettime( CLOCK_MONOTONIC, &theTime );
+	return (NSTimeInterval)theTime.tv_sec + (NSTimeInterval)theTime.tv_nsec*1.0e-9;
+}
+#define NDJSONStatisticsAdd(_FIELD_,_VALUE_)		do { if( self->_statisticsCounters != NULL ) self->_statisticsCounters->_FIELD_ += (_VALUE_); } while(0)
+#define NDJSONStatisticsCount(_FIELD_)				NDJSONStatisticsAdd(_FIELD_,1)
+#define NDJSONStatisticsEnterContainer(_FIELD_)		do { if( self->_statisticsCounters != NULL ) { self->_statisticsCounters->_FIELD_++; if( ++self->_statisticsCounters->depth > self->_statisticsCounters->maximumDepth ) self->_statisticsCounters->maximumDepth = self->_statisticsCounters->depth; } } while(0)
+#define NDJSONStatisticsLeaveContainer()			do { if( self->_statisticsCounters != NULL ) self->_statisticsCounters->depth--; } while(0)
+#define NDJSONStatisticsStartTime(_VAR_)			NSTimeInterval _VAR_ = self->_statisticsCounters != NULL ? NDJSONMonotonicTime() : 0.0
+#define NDJSONStatisticsAddTime(_FIELD_,_VAR_)		do { if( self->_statisticsCounters != NULL ) self->_statisticsCounters->_FIELD_ += NDJSONMonotonicTime() - _VAR_; } while(0)
+#define NDJSONTimedDelegateCall(...)				do { NDJSONStatisticsStartTime(theDelegateStartTime); __VA_ARGS__; NDJSONStatisticsAddTime(delegateTime,theDelegateStartTime); } while(0)
+#else
+#define NDJSONStatisticsAdd(_FIELD_,_VALUE_)
+#define NDJSONStatisticsCount(_FIELD_)
+#define NDJSONStatisticsEnterContainer(_FIELD_)
+#define NDJSONStatisticsLeaveContainer()
+#define NDJSONStatisticsStartTime(_VAR_)
+#define NDJSONStatisticsAddTime(_FIELD_,_VAR_)
+#define NDJSONTimedDelegateCall(...)				__VA_ARGS__
+#endif
+
+#if defined(NDJSONUSDTProbes) && defined(__linux__)
+#include <sys/sdt.h>
+#define NDJSONProbe1(_NAME_,_ARG1_)					DTRACE_PROBE1(ndjson,_NAME_,_ARG1_)
+#define NDJSONProbe2(_NAME_,_ARG1_,_ARG2_)			DTRACE_PROBE2(ndjson,_NAME_,_ARG1_,_ARG2_)
+#else
+#define NDJSONProbe1(_NAME_,_ARG1_)
+#define NDJSONProbe2(_NAME_,_ARG1_,_ARG2_)
+#endif
+
 #ifndef NDJSONSupportUTF8Only
 static uint16_t		k16BitLittleEndianBOM = 0xFEFF,
 					k16BitBigEndianBOM = 0xFFFE;
@@ -144,13 +208,23 @@ struct NDBytesBuffer
 					capacity;
 };
 
-typedef BOOL (*NDReturnBoolMethodIMP)( id, SEL, id, ...);
+enum NDJSONNumberKind
+{
+	kNDJSONNumberBad,
+	kNDJSONNumberInteger,
+	kNDJSONNumberUnsigned,						// an integer above LLONG_MAX that fits in an unsigned long long
+	kNDJSONNumberFloat
+};
 
 static const NSUInteger		kBufferSize = 2048;
+static const NSUInteger		kInflateBufferSize = 1<<16;
+static const NSUInteger		kMaximumInflateInputLength = 1<<30;			// z_stream lengths are only uInt
 
 NSString	* const NDJSONErrorDomain = @"NDJSONError";
 
 static const struct NDBytesBuffer	NDBytesBufferInit = {NULL,0,0};
+static BOOL extendsBytesOfLen( struct NDBytesBuffer * aBuffer, NSUInteger aLen );
+static BOOL appendByteSequence( struct NDBytesBuffer * aBuffer, const void * aBytes, NSUInteger aLength );
 static BOOL appendBytes( struct NDBytesBuffer * aBuffer, uint32_t aBytes, enum NDJSONCharacterWordSize aWordSize );
 static BOOL appendCharacter( struct NDBytesBuffer * aBuffer, unsigned int aValue, enum NDJSONCharacterWordSize aWordSize );
 //static BOOL truncateByte( struct NDBytesBuffer * aBuffer, uint32_t aBytes );
@@ -165,26 +239,37 @@ static NSString * const kErrorCodeStrings[] =
 	@"TrailingGarbage",
 	@"Memory",
 	@"PrematureEnd",
-	@"BadNumber"
+	@"BadNumber",
+	@"BadBase64",
+	@"TypeMismatch",
+	@"Inflate"
 };
 
+static void releaseSource( NDJSONParser * self );
 static BOOL parseInputData( NDJSONParser * self );
 static BOOL parseInputStream( NDJSONParser * self );
 static BOOL parseInputFunctionOrBlock( NDJSONParser * self );
 static BOOL parseURLRequest( NDJSONParser * self );
 
+static BOOL parseJSONDocument( NDJSONParser * self );
 static BOOL parseJSONUnknown( NDJSONParser * self );
 static BOOL parseJSONObject( NDJSONParser * self );
 static BOOL parseJSONArray( NDJSONParser * self );
-static BOOL parseJSONKey( NDJSONParser * self );
+static BOOL parseJSONKey( NDJSONParser * self, NDJSONKeyTable * aKeyTable, BOOL * aSkipValue );
 static BOOL parseJSONString( NDJSONParser * self );
 static BOOL parseJSONText( NDJSONParser * self, struct NDBytesBuffer * valueBuffer, BOOL aIsKey, BOOL aIsQuotesTerminated );
+static BOOL parseJSONBase64String( NDJSONParser * self );
 static BOOL parseJSONNumber( NDJSONParser * self );
+static enum NDJSONNumberKind scanJSONNumber( NDJSONParser * self, long long * anInteger, unsigned long long * anUnsigned, double * aFloat );
 static BOOL parseJSONTrue( NDJSONParser * self );
 static BOOL parseJSONFalse( NDJSONParser * self );
 static BOOL parseJSONNull( NDJSONParser * self );
-static BOOL skipNextValue( NDJSONParser * self );
+static BOOL skipNextValue( NDJSONParser * self, BOOL aIsRootValue );
 static void foundError( NDJSONParser * self, NDJSONErrorCode aCode );
+static NSTimeInterval NDJSONThreadCPUTime( void );
+static BOOL startInflating( NDJSONParser * self, uint8_t * aBytes, NSUInteger aLength );
+static NSUInteger inflateBytes( NDJSONParser * self, NSUInteger anOffset );
+static void endInflating( NDJSONParser * self );
 
 #ifdef NDJSONSupportUTF8Only
 static BOOL NDJSONIs8BitWordSizeForNSStringEncoding( NSStringEncoding anEncoding )
@@ -213,11 +298,16 @@ static BOOL NDJSONIs8BitWordSizeForNSStringEncoding( NSStringEncoding anEncoding
 	}
 }
 #else
-static BOOL NDJSONGetCharacterWordSizeAndEndianFromNSStringEncoding( enum NDJSONCharacterWordSize * aWordSize, enum NDJSONCharacterEndian * anEndian, NSStringEncoding anEncoding )
+/*
+	isUTF8 is set for the encodings whose bytes are also UTF-8, only the strings of these can be passed to the delegate as bytes
+ */
+static BOOL NDJSONGetCharacterWordSizeAndEndianFromNSStringEncoding( enum NDJSONCharacterWordSize * aWordSize, enum NDJSONCharacterEndian * anEndian, BOOL * anIsUTF8, NSStringEncoding anEncoding )
 {
 	BOOL		theResult = YES;
 	NSCParameterAssert( aWordSize != NULL );
 	NSCParameterAssert( anEndian != NULL );
+	NSCParameterAssert( anIsUTF8 != NULL );
+	*anIsUTF8 = anEncoding == NSUTF8StringEncoding || anEncoding == NSASCIIStringEncoding || anEncoding == NSNonLossyASCIIStringEncoding;
 	switch( anEncoding )
 	{
 	case NSASCIIStringEncoding:
@@ -268,6 +358,18 @@ static BOOL NDJSONGetCharacterWordSizeAndEndianFromNSStringEncoding( enum NDJSON
 	return theResult;
 }
 
+static BOOL NDJSONIsASCIIBytes( const uint8_t * aBytes, NSUInteger aLength )
+{
+	if( aBytes == NULL )
+		return NO;
+	for( NSUInteger i = 0; i < aLength; i++ )
+	{
+		if( aBytes[i] >= 0x80 )
+			return NO;
+	}
+	return YES;
+}
+
 #endif
 
 enum JSONInputType
@@ -286,6 +388,8 @@ enum JSONInputType
 	id<NDJSONParserDelegate>		__weak _delegate;
 	NSUInteger						_position,
 									_numberOfBytes;
+	unsigned long long				_bytesBefore,				// input bytes before the current buffer
+									_valueByteOffset;
 	NSUInteger						_lineNumber,
 									_columnNumber;
 	uint8_t							* _inputBytes;
@@ -295,7 +399,8 @@ enum JSONInputType
 		uint16_t						* word16;
 		uint32_t						* word32;
 	}								_bytes;
-	BOOL							_ownsBytes;
+	uint8_t							* _streamBuffer;			// kept between inputs
+	struct NDBytesBuffer			_scratchBuffer;				// for keys and strings, kept between inputs
 #ifdef DEBUG
 	uint8_t							_charactersHistory[kNDJSONCharacterHistorySize];
 	NSUInteger						_charactersHistoryLength;
@@ -305,6 +410,7 @@ enum JSONInputType
 	{
 		enum NDJSONCharacterWordSize	wordSize;
 		enum NDJSONCharacterEndian		endian;
+		BOOL							isUTF8;
 	}								_character;
 #endif
 	uint32_t						_backUpByte;
@@ -312,10 +418,13 @@ enum JSONInputType
 									_alreadyParsing,
 									_complete,
 									_abort;
-	BOOL							_useBackUpByte;
+	BOOL							_useBackUpByte,
+									_decodeBase64Value,			// the delegate asked for the next value to be decoded as base64
+									_singleValue;				// input starts at an offset, parse one value
 	struct
 	{
 		int								strictJSONOnly		: 1;
+		int								JSONLines			: 1;
 	}								_options;
 	enum JSONInputType				_inputType;
 	union
@@ -328,25 +437,35 @@ enum JSONInputType
 			void						* context;
 		};
 	}								_source;
+	struct
+	{
+		z_stream						stream;
+		uint8_t							* input;				// the stream buffer for stream input
+		uint8_t							* output;				// kept between inputs
+		NSUInteger						inputLength;			// data input not yet given to the z_stream
+		BOOL							checked,
+										compressed,
+										active,
+										finished;
+		int								status;					// zlib status that stopped inflating corrupt input
+		NSTimeInterval					time;
+	}								_inflate;
+	NSTimeInterval					_parseTime;
+	NSTimeInterval					_parseStartTime;		// 0 until timing starts, uncompressed input is only timed with NDJSONCollectStatistics
+	NDJSONParseStatistics			* _statistics;
+#ifdef NDJSONCollectStatistics
+	struct NDJSONParseCounters		* _statisticsCounters;		// NULL when not collecting
+#endif
 	NSString						* __strong _currentKey;
+	NSUInteger						_currentKeyIndex;
+	NDJSONKeyTable					* __weak _currentKeyTable;
+	Class							_delegateClass;				// class _delegateMethod was set up for
+	struct NDJSONDelegateMethods	_delegateMethod;
 	struct
 	{
-		IMP								didStartDocument,
-										didEndDocument,
-										didStartArray,
-										didEndArray,
-										didStartObject,
-										didEndObject,
-										shouldSkipValueForKey,
-										foundKey,
-										foundString,
-										foundNumber,
-										foundInteger,
-										foundFloat,
-										foundBool,
-										foundNULL,
-										foundError;
-	}								_delegateMethod;
+		Class							delegateClass;				// the delegate before the current one, swapped back in without the lock
+		struct NDJSONDelegateMethods	delegateMethod;
+	}								_previous;
 }
 
 - (void)setUpRespondsTo;
@@ -356,12 +475,28 @@ enum JSONInputType
 
 @end
 
+@interface NDJSONParseStatistics ()
+{
+@package
+	struct NDJSONParseCounters		_counters;
+}
+
+@end
+
 @implementation NDJSONParser
 
 @synthesize		delegate = _delegate,
 				currentKey = _currentKey,
+				currentKeyIndex = _currentKeyIndex,
+				currentKeyTable = _currentKeyTable,
+				valueByteOffset = _valueByteOffset,
 				lineNumber = _lineNumber,
-				columnNumber = _columnNumber;
+				columnNumber = _columnNumber,
+				parseTime = _parseTime,
+				statistics = _statistics;
+
+- (BOOL)isCompressed { return _inflate.compressed; }
+- (NSTimeInterval)inflateTime { return _inflate.time; }
 
 #pragma mark - manually implemented properties
 
@@ -375,8 +510,12 @@ enum JSONInputType
 
 - (void)dealloc
 {
-	if( _ownsBytes == YES )
-		free( _bytes.word8 );
+	endInflating( self );
+	releaseSource( self );
+	[_statistics release];
+	free( _streamBuffer );
+	freeByte( &_scratchBuffer );
+	free( _inflate.output );
 	[super dealloc];
 }
 
@@ -400,94 +539,56 @@ enum JSONInputType
 		_bytes.word16 = NULL;
 		_bytes.word32 = NULL;
 		_currentKey = nil;
+		_currentKeyIndex = NSNotFound;
+		_currentKeyTable = nil;
+		memset( &_inflate, 0, sizeof(_inflate) );
+		_parseTime = 0.0;
+		_statistics = nil;
+#ifdef DEBUG
 		memset( _charactersHistory, 0, sizeof(_charactersHistory) );
 		_charactersHistoryLength = 0;
+#endif
 	}
 	return self;
 }
 
-#pragma mark - parsing methods
 - (id)initWithJSONString:(NSString *)aString
 {
-	NSAssert( aString != nil, @"nil input JSON string" );
-#ifdef NDJSONSupportUTF8Only
-	return [self initWithJSONData:[aString dataUsingEncoding:NSUTF8StringEncoding] encoding:NSUTF8StringEncoding];
-#else
-	if( (self = [self init]) != nil )
+	if( (self = [self init]) != nil && ![self setJSONString:aString] )
 	{
-		CFStringEncoding		theStringEncoding = CFStringGetFastestEncoding( (CFStringRef)aString );
-		switch( theStringEncoding )
-		{
-		case kCFStringEncodingMacRoman:
-		case kCFStringEncodingWindowsLatin1:
-		case kCFStringEncodingISOLatin1:
-		case kCFStringEncodingNextStepLatin:
-		case kCFStringEncodingASCII:
-		case kCFStringEncodingUTF8:
-		case kCFStringEncodingNonLossyASCII:
-			_bytes.word8 = _inputBytes = (uint8_t*)CFStringGetCStringPtr((CFStringRef)aString, theStringEncoding);
-			_ownsBytes = NO;
-			_numberOfBytes = aString.length;
-			_character.wordSize = kNDJONCharacterWord8;
-			_character.endian = kNDJSONLittleEndian;
-			break;
-		case kCFStringEncodingUnicode:
-	//	case kCFStringEncodingUTF16:
-		case kCFStringEncodingUTF16LE:
-		case kCFStringEncodingUTF16BE:
-			_bytes.word8 = _inputBytes = (uint8_t*)CFStringGetCharactersPtr((CFStringRef)aString);
-			_ownsBytes = NO;
-			_numberOfBytes = aString.length<<1;
-			_character.wordSize = kNDJSONCharacterWord16;
-			_character.endian = kNDJSONLittleEndian;
-			break;
-		case kCFStringEncodingUTF32:
-		case kCFStringEncodingUTF32BE:
-		case kCFStringEncodingUTF32LE:
-			break;
-		}
-
-		if( _bytes.word8 != NULL )
-		{
-			_source.object = [aString retain];
-			_inputType = kJSONStringInputType;
-		}
-		else
-		{
-			[self release];
-			self = nil;
-		}
+		[self release];
+		self = nil;
 	}
 	return self;
-#endif
 }
 
 - (id)initWithJSONData:(NSData *)aData encoding:(NSStringEncoding)anEncoding
 {
-	NSAssert( aData != nil, @"nil input JSON data" );
 	if( (self = [self init]) != nil )
+		[self setJSONData:aData encoding:anEncoding];
+	return self;
+}
+
+- (id)initWithContentsOfFile:(NSString *)aPath encoding:(NSStringEncoding)anEncoding
+{
+	if( (self = [self init]) != nil && ![self setContentsOfFile:aPath encoding:anEncoding] )
 	{
-		_numberOfBytes = aData.length;
-		_ownsBytes = NO;
-		_bytes.word8 = _inputBytes = (uint8_t*)[aData bytes];
-		_source.object = [aData retain];
-		_inputType = kJSONDataInputType;
-#ifdef NDJSONSupportUTF8Only
-		NSAssert( NDJSONIs8BitWordSizeForNSStringEncoding(anEncoding), @"with NDJSONSupportUTF8Only set only 8bit character encodings are supported" );
-#else
-		NDJSONGetCharacterWordSizeAndEndianFromNSStringEncoding( &_character.wordSize, &_character.endian, anEncoding );
-#endif
+		[self release];
+		self = nil;
 	}
 	return self;
 }
 
-- (id)initWithContentsOfFile:(NSString *)aPath encoding:(NSStringEncoding)anEncoding
+- (id)initWithJSONData:(NSData *)aData offset:(NSUInteger)anOffset encoding:(NSStringEncoding)anEncoding
 {
-	NSAssert( aPath != nil, @"nil input JSON path" );
-	NSInputStream		* theInputStream = [NSInputStream inputStreamWithFileAtPath:aPath];
-	if( theInputStream != nil )
-		self = [self initWithInputStream:theInputStream encoding:anEncoding];
-	else
+	if( (self = [self init]) != nil )
+		[self setJSONData:aData offset:anOffset encoding:anEncoding];
+	return self;
+}
+
+- (id)initWithContentsOfFile:(NSString *)aPath offset:(unsigned long long)anOffset encoding:(NSStringEncoding)anEncoding
+{
+	if( (self = [self init]) != nil && ![self setContentsOfFile:aPath offset:anOffset encoding:anEncoding] )
 	{
 		[self release];
 		self = nil;
@@ -497,11 +598,7 @@ enum JSONInputType
 
 - (id)initWithContentsOfURL:(NSURL *)aURL encoding:(NSStringEncoding)anEncoding
 {
-	NSAssert( aURL != nil, @"nil input JSON file url" );
-	NSInputStream		* theInputStream = [NSInputStream inputStreamWithURL:aURL];
-	if( theInputStream != nil )
-		self = [self initWithInputStream:theInputStream encoding:anEncoding];
-	else
+	if( (self = [self init]) != nil && ![self setContentsOfURL:aURL encoding:anEncoding] )
 	{
 		[self release];
 		self = nil;
@@ -511,64 +608,245 @@ enum JSONInputType
 
 - (id)initWithInputStream:(NSInputStream *)aStream encoding:(NSStringEncoding)anEncoding
 {
-	NSAssert( aStream != nil, @"nil input stream" );
 	if( (self = [self init]) != nil )
+		[self setInputStream:aStream encoding:anEncoding];
+	return self;
+}
+
+- (id)initWithSourceFunction:(NDJSONDataStreamProc)aFunction context:(void*)aContext encoding:(NSStringEncoding)anEncoding
+{
+	if( (self = [self init]) != nil )
+		[self setSourceFunction:aFunction context:aContext encoding:anEncoding];
+	return self;
+}
+
+- (id)initWithSourceBlock:(NDJSONDataStreamBlock)aBlock encoding:(NSStringEncoding)anEncoding
+{
+	if( (self = [self init]) != nil )
+		[self setSourceBlock:aBlock encoding:anEncoding];
+	return self;
+}
+
+#pragma mark - input
+
+- (void)reset
+{
+	NSAssert( !_alreadyParsing, @"can't reset a parser while it is parsing" );
+	endInflating( self );
+	releaseSource( self );
+	_position = 0;
+	_numberOfBytes = 0;
+	_bytesBefore = 0;
+	_valueByteOffset = 0;
+	_lineNumber = 0;
+	_columnNumber = 0;
+	_complete = NO;
+	_abort = NO;
+	_useBackUpByte = NO;
+	_decodeBase64Value = NO;
+	_singleValue = NO;
+	_hasSkippedValueForCurrentKey = NO;
+	_inputBytes = NULL;
+	_bytes.word8 = NULL;
+	self.currentKey = nil;
+	_currentKeyIndex = NSNotFound;
+	_currentKeyTable = nil;
+	_inflate.input = NULL;
+	_inflate.inputLength = 0;
+	_inflate.checked = NO;
+	_inflate.compressed = NO;
+	_inflate.finished = NO;
+	_inflate.time = 0.0;
+	_parseTime = 0.0;
+#ifdef DEBUG
+	_charactersHistoryLength = 0;
+#endif
+}
+
+- (BOOL)setJSONString:(NSString *)aString
+{
+	NSAssert( aString != nil, @"nil input JSON string" );
+#ifdef NDJSONSupportUTF8Only
+	[self setJSONData:[aString dataUsingEncoding:NSUTF8StringEncoding] encoding:NSUTF8StringEncoding];
+	return YES;
+#else
+	CFStringEncoding		theStringEncoding = CFStringGetFastestEncoding( (CFStringRef)aString );
+	[self reset];
+	switch( theStringEncoding )
+	{
+	case kCFStringEncodingMacRoman:
+	case kCFStringEncodingWindowsLatin1:
+	case kCFStringEncodingISOLatin1:
+	case kCFStringEncodingNextStepLatin:
+	case kCFStringEncodingASCII:
+	case kCFStringEncodingUTF8:
+	case kCFStringEncodingNonLossyASCII:
+		_bytes.word8 = _inputBytes = (uint8_t*)CFStringGetCStringPtr((CFStringRef)aString, theStringEncoding);
+		_numberOfBytes = aString.length;
+		_character.wordSize = kNDJONCharacterWord8;
+		_character.endian = kNDJSONLittleEndian;
+		_character.isUTF8 = theStringEncoding == kCFStringEncodingUTF8 || theStringEncoding == kCFStringEncodingASCII || theStringEncoding == kCFStringEncodingNonLossyASCII || NDJSONIsASCIIBytes( _bytes.word8, _numberOfBytes );
+		break;
+	case kCFStringEncodingUnicode:
+//	case kCFStringEncodingUTF16:
+	case kCFStringEncodingUTF16LE:
+	case kCFStringEncodingUTF16BE:
+		_bytes.word8 = _inputBytes = (uint8_t*)CFStringGetCharactersPtr((CFStringRef)aString);
+		_numberOfBytes = aString.length<<1;
+		_character.wordSize = kNDJSONCharacterWord16;
+		_character.endian = kNDJSONLittleEndian;
+		_character.isUTF8 = NO;
+		break;
+	case kCFStringEncodingUTF32:
+	case kCFStringEncodingUTF32BE:
+	case kCFStringEncodingUTF32LE:
+		break;
+	}
+
+	if( _bytes.word8 != NULL )
 	{
-		_bytes.word8 = _inputBytes = malloc(kBufferSize);
-		_ownsBytes = YES;
-		_source.object = [aStream retain];
-		_inputType = kJSONStreamInputType;
+		_source.object = [aString retain];
+		_inputType = kJSONStringInputType;
+	}
+	else
+		_numberOfBytes = 0;
+	return _bytes.word8 != NULL;
+#endif
+}
+
+- (void)setJSONData:(NSData *)aData encoding:(NSStringEncoding)anEncoding
+{
+	NSAssert( aData != nil, @"nil input JSON data" );
+	[self reset];
+	_numberOfBytes = aData.length;
+	_bytes.word8 = _inputBytes = (uint8_t*)[aData bytes];
+	_source.object = [aData retain];
+	_inputType = kJSONDataInputType;
 #ifdef NDJSONSupportUTF8Only
-		NSAssert( NDJSONIs8BitWordSizeForNSStringEncoding(anEncoding), @"with NDJSONSupportUTF8Only set only 8bit character encodings are supported" );
+	NSAssert( NDJSONIs8BitWordSizeForNSStringEncoding(anEncoding), @"with NDJSONSupportUTF8Only set only 8bit character encodings are supported" );
 #else
-		NDJSONGetCharacterWordSizeAndEndianFromNSStringEncoding( &_character.wordSize, &_character.endian, anEncoding );
+	NDJSONGetCharacterWordSizeAndEndianFromNSStringEncoding( &_character.wordSize, &_character.endian, &_character.isUTF8, anEncoding );
+#endif
+}
+
+- (BOOL)setContentsOfFile:(NSString *)aPath encoding:(NSStringEncoding)anEncoding
+{
+	NSAssert( aPath != nil, @"nil input JSON path" );
+	NSInputStream		* theInputStream = [NSInputStream inputStreamWithFileAtPath:aPath];
+	if( theInputStream != nil )
+		[self setInputStream:theInputStream encoding:anEncoding];
+	else
+		[self reset];
+	return theInputStream != nil;
+}
+
+- (void)setJSONData:(NSData *)aData offset:(NSUInteger)anOffset encoding:(NSStringEncoding)anEncoding
+{
+	NSAssert( anOffset <= aData.length, @"offset beyond the end of the JSON data" );
+	[self setJSONData:aData encoding:anEncoding];
+#ifndef NDJSONSupportUTF8Only
+	NSAssert( (anOffset&((1<<_character.wordSize)-1)) == 0, @"offset is not at a character boundary" );
+#endif
+	_bytes.word8 = _inputBytes = _inputBytes+anOffset;
+	_numberOfBytes -= anOffset;
+	_bytesBefore = anOffset;
+	_singleValue = YES;
+}
+
+/*
+	the file is memory mapped so only the pages from the offset on that are needed for the value are read
+ */
+- (BOOL)setContentsOfFile:(NSString *)aPath offset:(unsigned long long)anOffset encoding:(NSStringEncoding)anEncoding
+{
+	NSAssert( aPath != nil, @"nil input JSON path" );
+	NSData		* theData = [[NSData alloc] initWithContentsOfFile:aPath options:NSDataReadingMappedIfSafe error:NULL];
+	BOOL		theResult = theData != nil && anOffset <= theData.length;
+	if( theResult )
+		[self setJSONData:theData offset:(NSUInteger)anOffset encoding:anEncoding];
+	else
+		[self reset];
+	[theData release];
+	return theResult;
+}
+
+- (BOOL)setContentsOfURL:(NSURL *)aURL encoding:(NSStringEncoding)anEncoding
+{
+	NSAssert( aURL != nil, @"nil input JSON file url" );
+	NSInputStream		* theInputStream = [NSInputStream inputStreamWithURL:aURL];
+	if( theInputStream != nil )
+		[self setInputStream:theInputStream encoding:anEncoding];
+	else
+		[self reset];
+	return theInputStream != nil;
+}
+
+- (void)setInputStream:(NSInputStream *)aStream encoding:(NSStringEncoding)anEncoding
+{
+	NSAssert( aStream != nil, @"nil input stream" );
+	[self reset];
+	if( _streamBuffer == NULL )
+		_streamBuffer = malloc(kBufferSize);
+	_bytes.word8 = _inputBytes = _streamBuffer;
+	_source.object = [aStream retain];
+	_inputType = kJSONStreamInputType;
+#ifdef NDJSONSupportUTF8Only
+	NSAssert( NDJSONIs8BitWordSizeForNSStringEncoding(anEncoding), @"with NDJSONSupportUTF8Only set only 8bit character encodings are supported" );
+#else
+	NDJSONGetCharacterWordSizeAndEndianFromNSStringEncoding( &_character.wordSize, &_character.endian, &_character.isUTF8, anEncoding );
 #endif
-	}
-	return self;
 }
 
-- (id)initWithSourceFunction:(NDJSONDataStreamProc)aFunction context:(void*)aContext encoding:(NSStringEncoding)anEncoding;
+- (void)setSourceFunction:(NDJSONDataStreamProc)aFunction context:(void*)aContext encoding:(NSStringEncoding)anEncoding
 {
 	NSAssert( aFunction != NULL, @"NULL function" );
-	if( (self = [self init]) != nil )
-	{
-		_source.function = aFunction;
-		_source.context = aContext;
-		_inputType = kJSONStreamFunctionType;
-	#ifdef NDJSONSupportUTF8Only
-		NSAssert( NDJSONIs8BitWordSizeForNSStringEncoding(anEncoding), @"with NDJSONSupportUTF8Only set only 8bit character encodings are supported" );
-	#else
-		NDJSONGetCharacterWordSizeAndEndianFromNSStringEncoding( &_character.wordSize, &_character.endian, anEncoding );
-	#endif
-	}
-	return self;
+	[self reset];
+	_source.function = aFunction;
+	_source.context = aContext;
+	_inputType = kJSONStreamFunctionType;
+#ifdef NDJSONSupportUTF8Only
+	NSAssert( NDJSONIs8BitWordSizeForNSStringEncoding(anEncoding), @"with NDJSONSupportUTF8Only set only 8bit character encodings are supported" );
+#else
+	NDJSONGetCharacterWordSizeAndEndianFromNSStringEncoding( &_character.wordSize, &_character.endian, &_character.isUTF8, anEncoding );
+#endif
 }
 
-- (id)initWithSourceBlock:(NDJSONDataStreamBlock)aBlock encoding:(NSStringEncoding)anEncoding;
+- (void)setSourceBlock:(NDJSONDataStreamBlock)aBlock encoding:(NSStringEncoding)anEncoding
 {
 	NSAssert( aBlock != NULL, @"NULL function" );
-	if( (self = [self init]) != nil )
-	{
-		_source.block = [aBlock copy];
-		_inputType = kJSONStreamBlockType;
+	[self reset];
+	_source.block = [aBlock copy];
+	_inputType = kJSONStreamBlockType;
 #ifdef NDJSONSupportUTF8Only
-		NSAssert( NDJSONIs8BitWordSizeForNSStringEncoding(anEncoding), @"with NDJSONSupportUTF8Only set only 8bit character encodings are supported" );
+	NSAssert( NDJSONIs8BitWordSizeForNSStringEncoding(anEncoding), @"with NDJSONSupportUTF8Only set only 8bit character encodings are supported" );
 #else
-		NDJSONGetCharacterWordSizeAndEndianFromNSStringEncoding( &_character.wordSize, &_character.endian, anEncoding );
+	NDJSONGetCharacterWordSizeAndEndianFromNSStringEncoding( &_character.wordSize, &_character.endian, &_character.isUTF8, anEncoding );
 #endif
-	}
-	return self;
 }
 
+#pragma mark - parsing methods
+
 - (BOOL)parseWithOptions:(NDJSONOptionFlags)anOptions
 {
-	BOOL		theResult = NO;
-	BOOL		theAlreadyParsing = _alreadyParsing;
+	BOOL			theResult = NO;
+	BOOL			theAlreadyParsing = _alreadyParsing;
+	NDJSONStatisticsStartTime(theWallStartTime);
 
 	_alreadyParsing = YES;
+	if( !theAlreadyParsing )
+	{
+		_inflate.time = 0.0;
+		_parseTime = 0.0;
+		_parseStartTime = 0.0;
+#ifdef NDJSONCollectStatistics
+		_parseStartTime = NDJSONThreadCPUTime();
+		_statisticsCounters = _statistics != nil ? &_statistics->_counters : NULL;
+#endif
+	}
+	NDJSONProbe1( document__start, (void*)self );
 	_options.strictJSONOnly = (anOptions&NDJSONOptionStrict) != 0;
+	_options.JSONLines = (anOptions&NDJSONOptionJSONLines) != 0;
 	if( _delegateMethod.didStartDocument != NULL )
-		_delegateMethod.didStartDocument( _delegate, @selector(jsonParserDidStartDocument:), self );
+		NDJSONTimedDelegateCall( _delegateMethod.didStartDocument( _delegate, @selector(jsonParserDidStartDocument:), self ) );
 
 	switch( _inputType )
 	{
@@ -591,69 +869,181 @@ enum JSONInputType
 		break;
 	}
 
+	if( _abort )
+		theResult = NO;
 	if( _delegateMethod.didEndDocument != NULL )
-		_delegateMethod.didEndDocument( _delegate, @selector(jsonParserDidEndDocument:), self );
+		NDJSONTimedDelegateCall( _delegateMethod.didEndDocument( _delegate, @selector(jsonParserDidEndDocument:), self ) );
+
+	if( !theAlreadyParsing )
+	{
+		endInflating( self );
+		if( _parseStartTime != 0.0 )
+			_parseTime = NDJSONThreadCPUTime() - _parseStartTime - _inflate.time;
+		NDJSONStatisticsAdd( totalTime, NDJSONMonotonicTime() - theWallStartTime );
+	}
+	NDJSONProbe2( document__end, (void*)self, (int)theResult );
 
 	if( theAlreadyParsing )
 		_hasSkippedValueForCurrentKey = YES;
 	_alreadyParsing = theAlreadyParsing;
 
 	self.currentKey = nil;
+	_currentKeyIndex = NSNotFound;
+	_currentKeyTable = nil;
 	return theResult;
 }
 
 /*
- do this once so we don't waste time sending the same message to get the same answer
- Could ad code to look up the IMPs for the messages, and the use NULL values for them to determine whether to send the call
+	delegates are usually instances of a few classes, so the methods for a class are looked up once and shared by every parser,
+	classes that implement respondsToSelector: themselves, proxies for example, are looked up every time the delegate is set
  */
-- (void)setUpRespondsTo
+static pthread_mutex_t				kDelegateMethodsLock = PTHREAD_MUTEX_INITIALIZER;
+static CFMutableDictionaryRef		kDelegateMethodsForClass = NULL;
+
+void NDJSONGetDelegateMethods( struct NDJSONDelegateMethods * aMethods, NSObject * aDelegate )
 {
-	NSObject		* theDelegate = self.delegate;
-	_delegateMethod.didStartDocument = [theDelegate respondsToSelector:@selector(jsonParserDidStartDocument:)]
-										? [theDelegate methodForSelector:@selector(jsonParserDidStartDocument:)]
+	aMethods->didStartDocument = [aDelegate respondsToSelector:@selector(jsonParserDidStartDocument:)]
+										? [aDelegate methodForSelector:@selector(jsonParserDidStartDocument:)]
+										: NULL;
+	aMethods->didEndDocument = [aDelegate respondsToSelector:@selector(jsonParserDidEndDocument:)]
+										? [aDelegate methodForSelector:@selector(jsonParserDidEndDocument:)]
+										: NULL;
+	aMethods->didStartArray = [aDelegate respondsToSelector:@selector(jsonParserDidStartArray:)]
+										? [aDelegate methodForSelector:@selector(jsonParserDidStartArray:)]
+										: NULL;
+	aMethods->didEndArray = [aDelegate respondsToSelector:@selector(jsonParserDidEndArray:)]
+										? [aDelegate methodForSelector:@selector(jsonParserDidEndArray:)]
 										: NULL;
-	_delegateMethod.didEndDocument = [theDelegate respondsToSelector:@selector(jsonParserDidEndDocument:)]
-										? [theDelegate methodForSelector:@selector(jsonParserDidEndDocument:)]
+	aMethods->didStartObject = [aDelegate respondsToSelector:@selector(jsonParserDidStartObject:)]
+										? [aDelegate methodForSelector:@selector(jsonParserDidStartObject:)]
 										: NULL;
-	_delegateMethod.didStartArray = [theDelegate respondsToSelector:@selector(jsonParserDidStartArray:)]
-										? [theDelegate methodForSelector:@selector(jsonParserDidStartArray:)]
+	aMethods->didEndObject = [aDelegate respondsToSelector:@selector(jsonParserDidEndObject:)]
+										? [aDelegate methodForSelector:@selector(jsonParserDidEndObject:)]
 										: NULL;
-	_delegateMethod.didEndArray = [theDelegate respondsToSelector:@selector(jsonParserDidEndArray:)]
-										? [theDelegate methodForSelector:@selector(jsonParserDidEndArray:)]
+	aMethods->keyTableForCurrentObject = [aDelegate respondsToSelector:@selector(jsonParserKeyTableForCurrentObject:)]
+										? [aDelegate methodForSelector:@selector(jsonParserKeyTableForCurrentObject:)]
 										: NULL;
-	_delegateMethod.didStartObject = [theDelegate respondsToSelector:@selector(jsonParserDidStartObject:)]
-										? [theDelegate methodForSelector:@selector(jsonParserDidStartObject:)]
+	aMethods->shouldSkipValueForKey = [aDelegate respondsToSelector:@selector(jsonParser:shouldSkipValueForKey:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:shouldSkipValueForKey:)]
 										: NULL;
-	_delegateMethod.didEndObject = [theDelegate respondsToSelector:@selector(jsonParserDidEndObject:)]
-										? [theDelegate methodForSelector:@selector(jsonParserDidEndObject:)]
+	aMethods->shouldSkipValueForKeyNotInKeyTable = [aDelegate respondsToSelector:@selector(jsonParser:shouldSkipValueForKeyNotInKeyTable:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:shouldSkipValueForKeyNotInKeyTable:)]
 										: NULL;
-	_delegateMethod.shouldSkipValueForKey = [theDelegate respondsToSelector:@selector(jsonParser:shouldSkipValueForKey:)]
-										? [theDelegate methodForSelector:@selector(jsonParser:shouldSkipValueForKey:)]
+	aMethods->shouldDecodeBase64ValueForKey = [aDelegate respondsToSelector:@selector(jsonParser:shouldDecodeBase64ValueForKey:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:shouldDecodeBase64ValueForKey:)]
 										: NULL;
-	_delegateMethod.foundKey = [theDelegate respondsToSelector:@selector(jsonParser:foundKey:)]
-										? [theDelegate methodForSelector:@selector(jsonParser:foundKey:)]
+	aMethods->foundKey = [aDelegate respondsToSelector:@selector(jsonParser:foundKey:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:foundKey:)]
 										: NULL;
-	_delegateMethod.foundString = [theDelegate respondsToSelector:@selector(jsonParser:foundString:)]
-										? [theDelegate methodForSelector:@selector(jsonParser:foundString:)]
+	aMethods->foundString = [aDelegate respondsToSelector:@selector(jsonParser:foundString:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:foundString:)]
 										: NULL;
-	_delegateMethod.foundNumber = [theDelegate respondsToSelector:@selector(jsonParser:foundNumber:)]
-										? [theDelegate methodForSelector:@selector(jsonParser:foundNumber:)]
+	aMethods->foundStringBytes = [aDelegate respondsToSelector:@selector(jsonParser:foundStringBytes:length:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:foundStringBytes:length:)]
 										: NULL;
-	_delegateMethod.foundInteger = [theDelegate respondsToSelector:@selector(jsonParser:foundInteger:)]
-										? [theDelegate methodForSelector:@selector(jsonParser:foundInteger:)]
+	aMethods->foundData = [aDelegate respondsToSelector:@selector(jsonParser:foundData:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:foundData:)]
 										: NULL;
-	_delegateMethod.foundFloat = [theDelegate respondsToSelector:@selector(jsonParser:foundFloat:)]
-										? [theDelegate methodForSelector:@selector(jsonParser:foundFloat:)]
+	aMethods->foundNumber = [aDelegate respondsToSelector:@selector(jsonParser:foundNumber:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:foundNumber:)]
 										: NULL;
-	_delegateMethod.foundBool = [theDelegate respondsToSelector:@selector(jsonParser:foundBool:)]
-										? [theDelegate methodForSelector:@selector(jsonParser:foundBool:)]
+	aMethods->foundInteger = [aDelegate respondsToSelector:@selector(jsonParser:foundInteger:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:foundInteger:)]
 										: NULL;
-	_delegateMethod.foundNULL = [theDelegate respondsToSelector:@selector(jsonParserFoundNULL:)]
-										? [theDelegate methodForSelector:@selector(jsonParserFoundNULL:)]
+	aMethods->foundUnsignedInteger = [aDelegate respondsToSelector:@selector(jsonParser:foundUnsignedInteger:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:foundUnsignedInteger:)]
 										: NULL;
-	_delegateMethod.foundError = [theDelegate respondsToSelector:@selector(jsonParser:error:)]
-										? [theDelegate methodForSelector:@selector(jsonParser:error:)]
+	aMethods->foundFloat = [aDelegate respondsToSelector:@selector(jsonParser:foundFloat:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:foundFloat:)]
 										: NULL;
+	aMethods->foundBool = [aDelegate respondsToSelector:@selector(jsonParser:foundBool:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:foundBool:)]
+										: NULL;
+	aMethods->foundNULL = [aDelegate respondsToSelector:@selector(jsonParserFoundNULL:)]
+										? [aDelegate methodForSelector:@selector(jsonParserFoundNULL:)]
+										: NULL;
+	aMethods->foundError = [aDelegate respondsToSelector:@selector(jsonParser:error:)]
+										? [aDelegate methodForSelector:@selector(jsonParser:error:)]
+										: NULL;
+}
+
+static BOOL NDJSONDelegateMethodsCanBeCachedForClass( Class aClass )
+{
+	static IMP		kRespondsToSelector = NULL;
+	if( kRespondsToSelector == NULL )
+		kRespondsToSelector = class_getMethodImplementation( [NSObject class], @selector(respondsToSelector:) );
+	return class_getMethodImplementation( aClass, @selector(respondsToSelector:) ) == kRespondsToSelector;
+}
+
+/*
+	the methods of a cachable delegate are kept when it is replaced, NDJSONDeserializer sets itself as the delegate and
+	restores the previous one for every document, so that swaps two tables instead of taking the lock each time
+ */
+static void keepPreviousDelegateMethods( NDJSONParser * self )
+{
+	if( self->_delegateClass != Nil )
+	{
+		self->_previous.delegateClass = self->_delegateClass;
+		self->_previous.delegateMethod = self->_delegateMethod;
+	}
+}
+
+- (void)setUpRespondsTo
+{
+	NSObject		* theDelegate = self.delegate;
+	Class			theClass = object_getClass( theDelegate );
+	if( theClass == Nil )
+	{
+		keepPreviousDelegateMethods( self );
+		memset( &_delegateMethod, 0, sizeof(_delegateMethod) );
+		_delegateClass = Nil;
+	}
+	else if( theClass != _delegateClass && theClass == _previous.delegateClass )
+	{
+		struct NDJSONDelegateMethods	theMethods = _delegateMethod;
+		Class							theSwappedClass = _delegateClass;
+		_delegateMethod = _previous.delegateMethod;
+		_delegateClass = theClass;
+		_previous.delegateMethod = theMethods;
+		_previous.delegateClass = theSwappedClass;
+	}
+	else if( theClass != _delegateClass )
+	{
+		keepPreviousDelegateMethods( self );
+		if( NDJSONDelegateMethodsCanBeCachedForClass( theClass ) )
+		{
+			struct NDJSONDelegateMethods	* theMethods = NULL;
+			pthread_mutex_lock( &kDelegateMethodsLock );
+			if( kDelegateMethodsForClass != NULL )
+				theMethods = (struct NDJSONDelegateMethods *)CFDictionaryGetValue( kDelegateMethodsForClass, (const void *)theClass );
+			pthread_mutex_unlock( &kDelegateMethodsLock );
+
+			if( theMethods == NULL )
+			{
+				struct NDJSONDelegateMethods	* theNewMethods = malloc(sizeof(struct NDJSONDelegateMethods));
+				NDJSONGetDelegateMethods( theNewMethods, theDelegate );			// outside the lock, respondsToSelector: may send +initialize
+				pthread_mutex_lock( &kDelegateMethodsLock );
+				if( kDelegateMethodsForClass == NULL )
+					kDelegateMethodsForClass = CFDictionaryCreateMutable( kCFAllocatorDefault, 0, NULL, NULL );
+				theMethods = (struct NDJSONDelegateMethods *)CFDictionaryGetValue( kDelegateMethodsForClass, (const void *)theClass );
+				if( theMethods == NULL )
+				{
+					CFDictionarySetValue( kDelegateMethodsForClass, (const void *)theClass, theNewMethods );
+					theMethods = theNewMethods;
+				}
+				else
+					free( theNewMethods );
+				pthread_mutex_unlock( &kDelegateMethodsLock );
+			}
+			_delegateMethod = *theMethods;
+			_delegateClass = theClass;
+		}
+		else
+		{
+			NDJSONGetDelegateMethods( &_delegateMethod, theDelegate );
+			_delegateClass = Nil;
+		}
+	}
 }
 
 - (void)abortParsing { _complete = _abort = YES; }
@@ -739,24 +1129,161 @@ static uint32_t convertedBytes( NDJSONParser * self )
 	return theResult;
 }
 
-static uint32_t currentChar( NDJSONParser * self )
+NSTimeInterval NDJSONThreadCPUTime( void )
 {
-	uint32_t	theResult = '\0';
-#ifdef NDJSONSupportUTF8Only
-	if( self->_position >= self->_numberOfBytes && !self->_abort )
+	struct timespec		theTime;
+	clock_gettime( CLOCK_THREAD_CPUTIME_ID, &theTime );
+	return (NSTimeInterval)theTime.tv_sec + (NSTimeInterval)theTime.tv_nsec*1.0e-9;
+}
+
+/*
+	gzip magic number or a zlib header with a 32K window, neither can be the start of a JSON document
+ */
+static BOOL isCompressedBytes( const uint8_t * aBytes, NSUInteger aLength )
+{
+	return aLength >= 2 && ((aBytes[0] == 0x1f && aBytes[1] == 0x8b) || (aBytes[0] == 0x78 && (aBytes[1]&0x20) == 0 && ((aBytes[0]<<8)|aBytes[1])%31 == 0));
+}
+
+/*
+	next compressed bytes from the source, data input is handed over in pieces because z_stream lengths are only 32 bit
+ */
+static NSInteger readCompressedBytes( NDJSONParser * self, uint8_t ** aBytes )
+{
+	NSInteger		theResult = 0;
+	switch( self->_inputType )
 	{
-#else
-	if( self->_position >= self->_numberOfBytes>>self->_character.wordSize && !self->_abort )
+	case kJSONDataInputType:
+		theResult = (NSInteger)MIN( self->_inflate.inputLength, kMaximumInflateInputLength );
+		*aBytes = self->_inflate.input;
+		self->_inflate.input += theResult;
+		self->_inflate.inputLength -= (NSUInteger)theResult;
+		break;
+	case kJSONStreamInputType:
+		*aBytes = self->_inflate.input;
+		theResult = [self->_source.object read:self->_inflate.input maxLength:kBufferSize];
+		break;
+	case kJSONStreamFunctionType:
+		theResult = self->_source.function(aBytes, self->_source.context);
+		break;
+	case kJSONStreamBlockType:
+		theResult = self->_source.block(aBytes);
+		break;
+	default:
+		break;
+	}
+	return theResult;
+}
+
+/*
+	the parser reads from a buffer of inflated bytes from now on, the compressed bytes read so far are given to the z_stream
+ */
+BOOL startInflating( NDJSONParser * self, uint8_t * aBytes, NSUInteger aLength )
+{
+	BOOL		theResult = NO;
+	memset( &self->_inflate.stream, 0, sizeof(self->_inflate.stream) );
+	self->_inflate.stream.next_in = aBytes;
+	self->_inflate.stream.avail_in = (uInt)aLength;
+	if( inflateInit2( &self->_inflate.stream, MAX_WBITS+32 ) == Z_OK )			// +32 detects gzip or zlib headers
 	{
-		/*
-			if numberOfBytes was not a multiple of character word size then we need to copy the partial word
-			to the begining of the buffer and append the next block onto the end, to comple the last character.
+		if( self->_inputType == kJSONStreamInputType )
+			self->_inflate.input = self->_inputBytes;			// keep reading compressed bytes into the stream buffer
+		if( self->_inflate.output == NULL )
+			self->_inflate.output = malloc(kInflateBufferSize);
+		self->_bytes.word8 = self->_inputBytes = self->_inflate.output;
+		self->_inflate.compressed = YES;
+		self->_inflate.active = YES;
+		self->_inflate.finished = NO;
+		self->_inflate.status = Z_OK;
+		if( self->_parseStartTime == 0.0 )
+			self->_parseStartTime = NDJSONThreadCPUTime();
+		theResult = YES;
+	}
+	return theResult;
+}
+
+/*
+	inflate into the parsers buffer after any partial character that has been moved to the start of it, returns the number of bytes in the buffer
+ */
+NSUInteger inflateBytes( NDJSONParser * self, NSUInteger anOffset )
+{
+	z_stream			* theStream = &self->_inflate.stream;
+	NSTimeInterval		theStartTime = NDJSONThreadCPUTime();
+
+	theStream->next_out = self->_inputBytes+anOffset;
+	theStream->avail_out = (uInt)(kInflateBufferSize-anOffset);
+	while( theStream->avail_out == kInflateBufferSize-anOffset && !self->_inflate.finished && !self->_abort )
+	{
+		int			theStatus;
+		if( theStream->avail_in == 0 )
+		{
+			uint8_t		* theBytes = NULL;
+			NSInteger	theLength = readCompressedBytes( self, &theBytes );
+			if( theLength <= 0 )
+			{
+				self->_inflate.finished = YES;
+				break;
+			}
+			theStream->next_in = theBytes;
+			theStream->avail_in = (uInt)theLength;
+		}
+		theStatus = inflate( theStream, Z_NO_FLUSH );
+		if( theStatus == Z_STREAM_END )
+			inflateReset( theStream );					// concatenated gzip members, as appended JSON Lines archives are
+		else if( theStatus != Z_OK && theStatus != Z_BUF_ERROR )
+		{
+			self->_inflate.status = theStatus;			// corrupt input, must not look like the end of the last JSON line
+			self->_inflate.finished = YES;
+			foundError( self, NDJSONInflateError );
+			self->_complete = self->_abort = YES;
+		}
+	}
+	self->_inflate.time += NDJSONThreadCPUTime() - theStartTime;
+	return kInflateBufferSize - theStream->avail_out;
+}
+
+void endInflating( NDJSONParser * self )
+{
+	if( self->_inflate.active )
+	{
+		inflateEnd( &self->_inflate.stream );
+		self->_inflate.input = NULL;
+		self->_inflate.active = NO;
+	}
+}
+
+static uint32_t currentChar( NDJSONParser * self )
+{
+	uint32_t	theResult = '\0';
+#ifdef NDJSONSupportUTF8Only
+	if( self->_position >= self->_numberOfBytes && !self->_abort )
+	{
+#else
+	if( self->_position >= self->_numberOfBytes>>self->_character.wordSize && !self->_abort )
+	{
+		/*
+			if numberOfBytes was not a multiple of character word size then we need to copy the partial word
+			to the begining of the buffer and append the next block onto the end, to comple the last character.
 		 */
 		NSUInteger		theRemainingLen = self->_numberOfBytes&((1<<self->_character.wordSize)-1);
 		if( theRemainingLen > 0 )
 			memcpy(self->_inputBytes, self->_inputBytes+self->_numberOfBytes-theRemainingLen, theRemainingLen );
 #endif
-		switch (self->_inputType)
+#ifdef NDJSONSupportUTF8Only
+		self->_bytesBefore += self->_numberOfBytes;
+#else
+		self->_bytesBefore += self->_numberOfBytes-theRemainingLen;
+#endif
+		NDJSONStatisticsStartTime(theRefillStartTime);
+		NDJSONProbe1( refill__start, (void*)self );
+		if( self->_inflate.active )
+		{
+#ifdef NDJSONSupportUTF8Only
+			self->_numberOfBytes = inflateBytes( self, 0 );
+#else
+			self->_numberOfBytes = inflateBytes( self, theRemainingLen );
+#endif
+		}
+		else switch (self->_inputType)
 		{
 		case kJSONStreamInputType:
 #ifdef NDJSONSupportUTF8Only
@@ -787,6 +1314,16 @@ static uint32_t currentChar( NDJSONParser * self )
 			self->_complete = YES;
 			break;
 		}
+		if( !self->_inflate.checked )
+		{
+			self->_inflate.checked = YES;
+			if( isCompressedBytes( self->_inputBytes, self->_numberOfBytes ) && startInflating( self, self->_inputBytes, self->_numberOfBytes ) )
+				self->_numberOfBytes = inflateBytes( self, 0 );
+		}
+		NDJSONProbe2( refill__end, (void*)self, (unsigned long)self->_numberOfBytes );
+		NDJSONStatisticsAddTime( sourceTime, theRefillStartTime );
+		NDJSONStatisticsCount( refillCount );
+		NDJSONStatisticsAdd( bytesConsumed, self->_numberOfBytes );
 		if( self->_numberOfBytes > 0 )
 			self->_position = 0;
 		else
@@ -910,13 +1447,54 @@ static void backUp( NDJSONParser * self )
 	self->_useBackUpByte = YES;
 }
 
-BOOL parseInputData( NDJSONParser * self )
+/*
+	an input is parsed once, the parser can be given another input with one of the set methods
+ */
+void releaseSource( NDJSONParser * self )
+{
+	switch( self->_inputType )
+	{
+	case kJSONDataInputType:
+	case kJSONStringInputType:
+		if( !self->_inflate.active )
+			self->_bytes.word8 = self->_inputBytes = NULL;			// the bytes belong to the source
+		[self->_source.object release];
+		break;
+	case kJSONStreamInputType:
+	case kJSONURLRequestType:
+		[self->_source.object release];
+		break;
+	case kJSONStreamBlockType:
+		[self->_source.block release];
+		break;
+	default:
+		break;
+	}
+	memset( &self->_source, 0, sizeof(self->_source) );
+	self->_inputType = kJSONNoInputType;
+}
+
+static void startInputData( NDJSONParser * self )
 {
-	BOOL		theResult = NO;
 	NSCParameterAssert( self->_bytes.word8 != NULL );
 	NSCParameterAssert( self->_source.object != nil );
-	theResult = parseJSONUnknown( self );
-	[self->_source.object release], self->_source.object = nil;
+	if( self->_inputType == kJSONDataInputType && isCompressedBytes( self->_bytes.word8, self->_numberOfBytes ) )
+	{
+		self->_inflate.input = self->_bytes.word8;			// the data is kept until parsing is complete
+		self->_inflate.inputLength = self->_numberOfBytes;
+		if( startInflating( self, NULL, 0 ) )
+			self->_numberOfBytes = 0;
+	}
+	self->_inflate.checked = YES;
+	NDJSONStatisticsAdd( bytesConsumed, self->_numberOfBytes );
+}
+
+BOOL parseInputData( NDJSONParser * self )
+{
+	BOOL		theResult = NO;
+	startInputData( self );
+	theResult = parseJSONDocument( self );
+	releaseSource( self );
 	return theResult;
 }
 
@@ -925,8 +1503,9 @@ BOOL parseInputStream( NDJSONParser * self )
 	BOOL		theResult = NO;
 	NSCParameterAssert( self->_source.object != nil );
 	[self->_source.object open];
-	theResult = parseJSONUnknown( self );
-	[self->_source.object close], [self->_source.object release], self->_source.object = nil;
+	theResult = parseJSONDocument( self );
+	[self->_source.object close];
+	releaseSource( self );
 	return theResult;
 }
 
@@ -934,7 +1513,8 @@ BOOL parseInputFunctionOrBlock( NDJSONParser * self )
 {
 	BOOL		theResult = NO;
 	NSCParameterAssert( self->_source.block != nil || self->_source.function != nil );
-	theResult = parseJSONUnknown( self );
+	theResult = parseJSONDocument( self );
+	releaseSource( self );
 	return theResult;
 }
 	
@@ -946,18 +1526,57 @@ BOOL parseURLRequest( NDJSONParser * self )
 		self->_options.strictJSONOnly = NO;
 		if( self->_source.object != nil )
 			[self->_source.object open];
-		theResult = parseJSONUnknown( self );
+		theResult = parseJSONDocument( self );
 		[self->_source.object close];
 		self.currentKey = nil;
 	}
-	[self->_source.object release], self->_source.object = nil;
+	releaseSource( self );
 	return theResult;
 }
 
-BOOL parseJSONUnknown( NDJSONParser * self )
+/*
+	with the JSON Lines option the document is a sequence of values which are reported as the elements of an array
+	input set with an offset is a single value, whatever follows it is not looked at
+ */
+BOOL parseJSONDocument( NDJSONParser * self )
 {
 	BOOL		theResult = YES;
-	switch( NDJSONNextCharIgnoreWhiteSpace( self ) )
+	if( !self->_options.JSONLines || self->_singleValue )
+	{
+		NDJSONStatisticsCount( documentCount );
+		theResult = parseJSONUnknown( self );
+	}
+	else
+	{
+		if( self->_delegateMethod.didStartArray != NULL )
+			NDJSONTimedDelegateCall( self->_delegateMethod.didStartArray( self->_delegate, @selector(jsonParserDidStartArray:), self ) );
+		while( theResult && !self->_abort && NDJSONNextCharIgnoreWhiteSpace( self ) != '\0' )
+		{
+			backUp( self );
+			NDJSONStatisticsCount( documentCount );
+			NDJSONProbe1( record__start, (unsigned long)self->_lineNumber );
+			theResult = parseJSONUnknown( self );
+			NDJSONProbe1( record__end, (unsigned long)self->_lineNumber );
+		}
+		if( theResult && self->_delegateMethod.didEndArray != NULL )
+			NDJSONTimedDelegateCall( self->_delegateMethod.didEndArray( self->_delegate, @selector(jsonParserDidEndArray:), self ) );
+	}
+	return theResult;
+}
+
+BOOL parseJSONUnknown( NDJSONParser * self )
+{
+	BOOL		theResult = YES,
+				theDecodeBase64 = self->_decodeBase64Value;
+	uint32_t	theChar = NDJSONNextCharIgnoreWhiteSpace( self );
+	self->_decodeBase64Value = NO;
+	if( self->_position > 0 )				// the character just read
+#ifdef NDJSONSupportUTF8Only
+		self->_valueByteOffset = self->_bytesBefore + self->_position-1;
+#else
+		self->_valueByteOffset = self->_bytesBefore + ((self->_position-1)<<self->_character.wordSize);
+#endif
+	switch( theChar )
 	{
 	case '{':
 		theResult = parseJSONObject( self );
@@ -966,7 +1585,7 @@ BOOL parseJSONUnknown( NDJSONParser * self )
 		theResult = parseJSONArray( self );
 		break;
 	case '"':
-		theResult = parseJSONString( self );
+		theResult = theDecodeBase64 ? parseJSONBase64String( self ) : parseJSONString( self );
 		break;
 	case '0' ... '9':
 	case '-':
@@ -996,8 +1615,9 @@ BOOL parseJSONArray( NDJSONParser * self )
 	BOOL				theResult = YES;
 	BOOL				theEnd = NO;
 	NSUInteger			theCount = 0;
+	NDJSONStatisticsEnterContainer( arrayCount );
 	if( self->_delegateMethod.didStartArray != NULL )
-		self->_delegateMethod.didStartArray( self->_delegate, @selector(jsonParserDidStartArray:), self );
+		NDJSONTimedDelegateCall( self->_delegateMethod.didStartArray( self->_delegate, @selector(jsonParserDidStartArray:), self ) );
 	
 	if( NDJSONNextCharIgnoreWhiteSpace(self) == ']' )
 		theEnd = YES;
@@ -1032,9 +1652,10 @@ BOOL parseJSONArray( NDJSONParser * self )
 	if( theEnd )
 	{
 		if( self->_delegateMethod.didEndArray != NULL )
-			self->_delegateMethod.didEndArray( self->_delegate, @selector(jsonParserDidEndArray:), self );
+			NDJSONTimedDelegateCall( self->_delegateMethod.didEndArray( self->_delegate, @selector(jsonParserDidEndArray:), self ) );
 	}
 errorOut:
+	NDJSONStatisticsLeaveContainer();
 	return theResult;
 }
 
@@ -1043,33 +1664,47 @@ BOOL parseJSONObject( NDJSONParser * self )
 	BOOL				theResult = YES;
 	BOOL				theEnd = NO;
 	NSUInteger			theCount = 0;
+	NDJSONKeyTable		* theKeyTable = nil;
 	
+	NDJSONStatisticsEnterContainer( objectCount );
 	if( self->_delegateMethod.didStartObject != NULL )
-		self->_delegateMethod.didStartObject( self->_delegate, @selector(jsonParserDidStartObject:), self );
+		NDJSONTimedDelegateCall( self->_delegateMethod.didStartObject( self->_delegate, @selector(jsonParserDidStartObject:), self ) );
+	if( self->_delegateMethod.keyTableForCurrentObject != NULL )
+		NDJSONTimedDelegateCall( theKeyTable = self->_delegateMethod.keyTableForCurrentObject( self->_delegate, @selector(jsonParserKeyTableForCurrentObject:), self ) );
 	
 	if( NDJSONNextCharIgnoreWhiteSpace(self) == '}' )
 		theEnd = YES;
 	else
 		backUp(self);
 	
-	while( !theEnd )
+	while( !theEnd && theResult )
 	{
-		if( (theResult = parseJSONKey(self)) )
+		BOOL	theSkipValueForKeyNotInKeyTable = NO;
+		if( (theResult = parseJSONKey(self, theKeyTable, &theSkipValueForKeyNotInKeyTable)) )
 		{
 			if( (NDJSONNextCharIgnoreWhiteSpace(self) == ':') == YES )
 			{
 				BOOL	theSkipParsingValueForCurrentKey = NO;
 
-				if( self->_delegateMethod.foundKey != NULL )
-					self->_delegateMethod.foundKey( self->_delegate, @selector(jsonParser:foundKey:), self, self.currentKey );
+				if( theSkipValueForKeyNotInKeyTable )
+					theSkipParsingValueForCurrentKey = YES;
+				else if( self->_delegateMethod.foundKey != NULL )
+					NDJSONTimedDelegateCall( self->_delegateMethod.foundKey( self->_delegate, @selector(jsonParser:foundKey:), self, self.currentKey ) );
 
-				if( self->_delegateMethod.shouldSkipValueForKey != NULL )
-					theSkipParsingValueForCurrentKey = ((NDReturnBoolMethodIMP)self->_delegateMethod.shouldSkipValueForKey)( self->_delegate, @selector(jsonParser:shouldSkipValueForKey:), self, self.currentKey	);
+				if( !theSkipValueForKeyNotInKeyTable && self->_delegateMethod.shouldSkipValueForKey != NULL )
+					NDJSONTimedDelegateCall( theSkipParsingValueForCurrentKey = ((NDReturnBoolMethodIMP)self->_delegateMethod.shouldSkipValueForKey)( self->_delegate, @selector(jsonParser:shouldSkipValueForKey:), self, self.currentKey	) );
 
 				if( theSkipParsingValueForCurrentKey )
-					theResult = skipNextValue(self);
+				{
+					NDJSONStatisticsCount( skippedKeyCount );
+					theResult = skipNextValue( self, NO );
+				}
 				else if( !self->_hasSkippedValueForCurrentKey )
+				{
+					if( self->_delegateMethod.shouldDecodeBase64ValueForKey != NULL && self->_delegateMethod.foundData != NULL )
+						NDJSONTimedDelegateCall( self->_decodeBase64Value = ((NDReturnBoolMethodIMP)self->_delegateMethod.shouldDecodeBase64ValueForKey)( self->_delegate, @selector(jsonParser:shouldDecodeBase64ValueForKey:), self, self.currentKey ) );
 					theResult = parseJSONUnknown( self );
+				}
 				else
 				{
 					self->_hasSkippedValueForCurrentKey = NO;
@@ -1097,6 +1732,7 @@ BOOL parseJSONObject( NDJSONParser * self )
 						break;
 					default:
 						foundError( self, NDJSONBadFormatError );
+						theResult = NO;
 						break;
 					}
 				}
@@ -1104,7 +1740,10 @@ BOOL parseJSONObject( NDJSONParser * self )
 					foundError( self, NDJSONBadFormatError );
 			}
 			else
+			{
 				foundError( self, NDJSONBadFormatError );
+				theResult = NO;
+			}
 		}
 		else
 			foundError( self, NDJSONBadFormatError );
@@ -1112,59 +1751,141 @@ BOOL parseJSONObject( NDJSONParser * self )
 	if( theEnd )
 	{
 		if( self->_delegateMethod.didEndObject != NULL )
-			self->_delegateMethod.didEndObject( self->_delegate, @selector(jsonParserDidEndObject:), self );
+			NDJSONTimedDelegateCall( self->_delegateMethod.didEndObject( self->_delegate, @selector(jsonParserDidEndObject:), self ) );
 	}
-	
+	NDJSONStatisticsLeaveContainer();
 	return theResult;
 }
 
-BOOL parseJSONKey( NDJSONParser * self )
+static NSUInteger NDJSONKeyTableIndexForBytes( NDJSONKeyTable * aKeyTable, const uint8_t * aBytes, NSUInteger aLength );
+static NSString * NDJSONKeyTableKeyAtIndex( NDJSONKeyTable * aKeyTable, NSUInteger anIndex );
+
+/*
+	keys and strings are unescaped into a buffer kept by the parser, it only grows so after the first few tokens no
+	memory is allocated for them
+ */
+static struct NDBytesBuffer * NDJSONScratchBuffer( NDJSONParser * self )
+{
+	self->_scratchBuffer.length = 0;
+	return &self->_scratchBuffer;
+}
+
+/*
+	aSkipValue is set if the key is not in the key table and the delegate has said the values of such keys are skipped,
+	the key is then not reported and no NSString is created for it
+ */
+BOOL parseJSONKey( NDJSONParser * self, NDJSONKeyTable * aKeyTable, BOOL * aSkipValue )
 {
-	struct NDBytesBuffer	theBuffer = NDBytesBufferInit;
+	struct NDBytesBuffer	* theBuffer = NDJSONScratchBuffer( self );
 	BOOL					theResult = YES;
 	if( NDJSONNextCharIgnoreWhiteSpace(self) == '"' )
-		theResult = parseJSONText( self, &theBuffer, YES, YES );
+		theResult = parseJSONText( self, theBuffer, YES, YES );
 	else if( !self->_options.strictJSONOnly )				// keys don't have to be quoted
 	{
 		backUp(self);
-		theResult = parseJSONText( self, &theBuffer, YES, NO );
+		theResult = parseJSONText( self, theBuffer, YES, NO );
 	}
 	else
 		foundError( self, NDJSONBadFormatError );
 	if( theResult != NO )
 	{
+		NSUInteger		theKeyIndex = NSNotFound;
+#ifdef NDJSONSupportUTF8Only
+		if( aKeyTable != nil )
+#else
+		if( aKeyTable != nil && self->_character.wordSize == kNDJONCharacterWord8 )
+#endif
+			theKeyIndex = NDJSONKeyTableIndexForBytes( aKeyTable, theBuffer->bytes, theBuffer->length );
+
+		NDJSONStatisticsCount( keyCount );
+		self->_currentKeyTable = aKeyTable;
+		self->_currentKeyIndex = theKeyIndex;
+		*aSkipValue = NO;
+		if( theKeyIndex != NSNotFound )
+			self.currentKey = NDJSONKeyTableKeyAtIndex( aKeyTable, theKeyIndex );
+#ifdef NDJSONSupportUTF8Only
+		else if( aKeyTable != nil && self->_delegateMethod.shouldSkipValueForKeyNotInKeyTable != NULL )
+#else
+		else if( aKeyTable != nil && self->_character.isUTF8 && self->_delegateMethod.shouldSkipValueForKeyNotInKeyTable != NULL )
+#endif
+			NDJSONTimedDelegateCall( *aSkipValue = ((NDReturnBoolMethodIMP)self->_delegateMethod.shouldSkipValueForKeyNotInKeyTable)( self->_delegate, @selector(jsonParser:shouldSkipValueForKeyNotInKeyTable:), self, aKeyTable ) );
+		if( *aSkipValue )
+			self.currentKey = nil;
+		else if( theKeyIndex == NSNotFound )
+		{
 #ifdef NDJSONSupportUTF8Only
-		self.currentKey = [[NSString alloc] initWithBytes:theBuffer.bytes length:theBuffer.length encoding:NSUTF8StringEncoding];
+			NSString	* theKey = [[NSString alloc] initWithBytes:theBuffer->bytes length:theBuffer->length encoding:NSUTF8StringEncoding];
 #else
-		self.currentKey = [[NSString alloc] initWithBytes:theBuffer.bytes length:theBuffer.length encoding:kNSStringEncodingFromCharacterWordSize[self->_character.wordSize]];
+			NSString	* theKey = [[NSString alloc] initWithBytes:theBuffer->bytes length:theBuffer->length encoding:kNSStringEncodingFromCharacterWordSize[self->_character.wordSize]];
 #endif
+			NDJSONStatisticsCount( stringsCreated );
+			NDJSONStatisticsAdd( stringBytesCopied, theBuffer->length );
+			self.currentKey = theKey;
+			[theKey release];
+		}
 
 		NDJSONLog( @"Found key: '%@'", self.currentKey );
 	}
-	freeByte( &theBuffer );
-
 	return theResult;
 }
 
 BOOL parseJSONString( NDJSONParser * self )
 {
-	struct NDBytesBuffer	theBuffer = NDBytesBufferInit;
-	BOOL					theResult = parseJSONText( self, &theBuffer, NO, YES );
-	if( theResult != NO )
+	struct NDBytesBuffer	* theBuffer = NDJSONScratchBuffer( self );
+	BOOL					theResult = parseJSONText( self, theBuffer, NO, YES );
+#ifdef NDJSONSupportUTF8Only
+	if( theResult != NO && self->_delegateMethod.foundStringBytes != NULL )
+#else
+	if( theResult != NO && self->_delegateMethod.foundStringBytes != NULL && self->_character.isUTF8 )
+#endif
+	{
+		NDJSONStatisticsCount( stringCount );
+		NDJSONTimedDelegateCall( ((NDBytesMethodIMP)self->_delegateMethod.foundStringBytes)( self->_delegate, @selector(jsonParser:foundStringBytes:length:), self, theBuffer->bytes, theBuffer->length ) );
+	}
+	else if( theResult != NO )
 	{
 #ifdef NDJSONSupportUTF8Only
-		NSString	* theValue = [[NSString alloc] initWithBytes:theBuffer.bytes length:theBuffer.length encoding:NSUTF8StringEncoding];
+		NSString	* theValue = [[NSString alloc] initWithBytes:theBuffer->bytes length:theBuffer->length encoding:NSUTF8StringEncoding];
 #else
-		NSString	* theValue = [[NSString alloc] initWithBytes:theBuffer.bytes length:theBuffer.length encoding:kNSStringEncodingFromCharacterWordSize[self->_character.wordSize]];
+		NSString	* theValue = [[NSString alloc] initWithBytes:theBuffer->bytes length:theBuffer->length encoding:kNSStringEncodingFromCharacterWordSize[self->_character.wordSize]];
 #endif
+		NDJSONStatisticsCount( stringCount );
+		NDJSONStatisticsCount( stringsCreated );
+		NDJSONStatisticsAdd( stringBytesCopied, theBuffer->length );
 		if( self->_delegateMethod.foundString != NULL )
-			self->_delegateMethod.foundString( self->_delegate, @selector(jsonParser:foundString:), self, theValue );
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundString( self->_delegate, @selector(jsonParser:foundString:), self, theValue ) );
 		[theValue release];
 	}
-	freeByte( &theBuffer );
 	return theResult;
 }
 
+/*
+	appends the plain 8 bit characters that follow in the current input buffer in one step, stopping at anything
+	parseJSONText has to look at itself, the characters are not added to the debug history so it is not used then
+ */
+static void appendCharacterRun( NDJSONParser * self, struct NDBytesBuffer * aBuffer, BOOL aIsQuotesTerminated )
+{
+#if !defined(DEBUG) && !defined(NDJSONPrintStream)
+	const uint8_t	* theBytes = self->_bytes.word8+self->_position;
+	NSUInteger		theAvailable = self->_position < self->_numberOfBytes ? self->_numberOfBytes-self->_position : 0,
+					theLength = 0;
+	if( self->_useBackUpByte || self->_complete )
+		return;
+	while( theLength < theAvailable )
+	{
+		uint8_t		theByte = theBytes[theLength];
+		if( theByte < ' ' || theByte == '"' || theByte == '\\' || theByte == ':' || (theByte == ' ' && !aIsQuotesTerminated) )
+			break;
+		theLength++;
+	}
+	if( theLength > 0 && appendByteSequence( aBuffer, theBytes, theLength ) )
+	{
+		self->_position += theLength;
+		self->_columnNumber += theLength;
+	}
+#endif
+}
+
 BOOL parseJSONText( NDJSONParser * self, struct NDBytesBuffer * aValueBuffer, BOOL aIsKey, BOOL aIsQuotesTerminated )
 {
 	BOOL					theResult = YES,
@@ -1254,8 +1975,19 @@ BOOL parseJSONText( NDJSONParser * self, struct NDBytesBuffer * aValueBuffer, BO
 			else if( !appendBytes( aValueBuffer, theChar, theWordSize ) )
 				foundError( self, NDJSONMemoryErrorError );
 			break;
-		case '\t': case '\n': case '\v': case '\f': case '\r': case ' ':
-			if( self->_options.strictJSONOnly )
+		case ' ':
+			if( aIsQuotesTerminated )
+			{
+				if( !appendBytes( aValueBuffer, theChar, theWordSize ) )
+					foundError( self, NDJSONMemoryErrorError );
+			}
+			else if( self->_options.strictJSONOnly )
+				foundError( self, NDJSONBadFormatError );
+			else
+				theEnd = YES;
+			break;
+		case '\t': case '\n': case '\v': case '\f': case '\r':
+			if( self->_options.strictJSONOnly )				// control characters have to be escaped in strict JSON
 				foundError( self, NDJSONBadFormatError );
 			else if( !aIsQuotesTerminated )
 				theEnd = YES;
@@ -1265,6 +1997,8 @@ BOOL parseJSONText( NDJSONParser * self, struct NDBytesBuffer * aValueBuffer, BO
 		default:
 			if( !appendBytes( aValueBuffer, theChar, theWordSize ) )
 				foundError( self, NDJSONMemoryErrorError );
+			else if( theWordSize == kNDJONCharacterWord8 )
+				appendCharacterRun( self, aValueBuffer, aIsQuotesTerminated );
 			break;
 		}
 	}
@@ -1273,125 +2007,442 @@ BOOL parseJSONText( NDJSONParser * self, struct NDBytesBuffer * aValueBuffer, BO
 	return theResult;
 }
 
-BOOL parseJSONNumber( NDJSONParser * self )
+/*
+	value of each base64 character, the standard and the URL safe alphabets, kBase64NotAlphabet for every other character
+ */
+enum { kBase64NotAlphabet = 0x80 };
+static const uint8_t		kBase64DecodeTable[256] =
 {
-	BOOL			theNegative = NO;
-	BOOL			theEnd = NO,
-					theResult = YES;
-	long long		theIntegerValue = 0,
-					theDecimalValue = 0,
-					theExponentValue = 0;
-	int				theDecimalPlaces = 1;
-	
-	if( NDJSONNextChar(self) == '-' )
-		theNegative = YES;
-	else
-		backUp(self);
-	
-	while( !theEnd && theResult )
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x3e, 0x80, 0x3e, 0x80, 0x3f,
+	0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3a, 0x3b, 0x3c, 0x3d, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e,
+	0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x80, 0x80, 0x80, 0x80, 0x3f,
+	0x80, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+	0x29, 0x2a, 0x2b, 0x2c, 0x2d, 0x2e, 0x2f, 0x30, 0x31, 0x32, 0x33, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+	0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80
+};
+
+/*
+	decode aQuantumCount groups of 4 characters into 3 bytes each, all the characters are checked before any
+	are decoded so nothing is written if the block contains a character that is not in the alphabet
+ */
+static inline BOOL decodeBase64Block( uint8_t * anOutput, const uint8_t * anInput, NSUInteger aQuantumCount )
+{
+	uint32_t		theNotAlphabet = 0;
+	for( NSUInteger i = 0; i < aQuantumCount*4; i++ )
+		theNotAlphabet |= kBase64DecodeTable[anInput[i]];
+	if( theNotAlphabet & kBase64NotAlphabet )
+		return NO;
+	for( NSUInteger i = 0; i < aQuantumCount; i++, anInput += 4, anOutput += 3 )
 	{
-		uint32_t		theChar = NDJSONNextChar(self);
-		switch( theChar )
-		{
-		case '\0':
-			theEnd = YES;
-			break;
-		case '0'...'9':
-			if( theDecimalPlaces <= 0 )
-			{
-				theDecimalPlaces--;
-				theDecimalValue = theDecimalValue * 10 + (theChar - '0');
-			}
-			else
-				theIntegerValue = theIntegerValue * 10 + (theChar - '0');
-			break;
-		case 'e':
-		case 'E':
+		uint32_t	theBits = (uint32_t)kBase64DecodeTable[anInput[0]]<<18 | (uint32_t)kBase64DecodeTable[anInput[1]]<<12
+							| (uint32_t)kBase64DecodeTable[anInput[2]]<<6 | (uint32_t)kBase64DecodeTable[anInput[3]];
+		anOutput[0] = (uint8_t)(theBits>>16);
+		anOutput[1] = (uint8_t)(theBits>>8);
+		anOutput[2] = (uint8_t)theBits;
+	}
+	return YES;
+}
+
+NSData * NDJSONCreateDataFromBase64Bytes( const uint8_t * aBytes, NSUInteger aLength )
+{
+	uint8_t			* theBytes = malloc( aLength/4*3+3 );
+	NSUInteger		theLength = 0,
+					theQuantumLength = 0,
+					thePaddingLength = 0;
+	uint32_t		theQuantum = 0;
+	BOOL			theValid = theBytes != NULL;
+	for( NSUInteger i = 0; i < aLength && theValid; i++ )
+	{
+		uint8_t		theChar = aBytes[i];
+		if( kBase64DecodeTable[theChar] != kBase64NotAlphabet && thePaddingLength == 0 )
 		{
-			BOOL		theExponentNegative = 0;
-			theChar = NDJSONNextChar(self);
-			if( theChar == '+' || theChar == '-' )
-				theExponentNegative = (theChar == '-');
-			else if( theChar >= '0' && theChar <= '9' )
-				theExponentValue = (theChar - '0');
-			else
-			{
-				theEnd = YES;
-				foundError( self, NDJSONBadNumberError );
-			}
-			
-			while( !theEnd && theResult )
+			theQuantum = theQuantum<<6 | kBase64DecodeTable[theChar];
+			if( ++theQuantumLength == 4 )
 			{
-				theChar = NDJSONNextChar(self);
-				switch( theChar )
-				{
-//				case '\0':
-//					theEnd = YES;
-//					break;
-				case '0'...'9':
-					theExponentValue = theExponentValue * 10 + (theChar - '0');
-					break;
-				default:
-					theEnd = YES;
-					break;
-				}
+				theBytes[theLength++] = (uint8_t)(theQuantum>>16);
+				theBytes[theLength++] = (uint8_t)(theQuantum>>8);
+				theBytes[theLength++] = (uint8_t)theQuantum;
+				theQuantum = 0;
+				theQuantumLength = 0;
 			}
-			if( theExponentNegative )
-				theExponentValue = -theExponentValue;
-			break;
-		}
-		case '.':
-			if( theDecimalPlaces > 0 )
-				theDecimalPlaces = 0;
-			else
-				theEnd = YES;
-			break;
-		default:
-			theEnd = YES;
-			break;
 		}
+		else if( theChar == '=' && theQuantumLength >= 2 && theQuantumLength+thePaddingLength < 4 )
+			thePaddingLength++;
+		else if( !isspace((int)theChar) )
+			theValid = NO;
 	}
-	
-	if( theDecimalPlaces < 0 || theExponentValue != 0 )
+	if( theQuantumLength == 1 )
+		theValid = NO;
+	else if( theQuantumLength == 2 )
+		theBytes[theLength++] = (uint8_t)(theQuantum>>4);
+	else if( theQuantumLength == 3 )
 	{
-		double	theValue = ((double)theIntegerValue) + ((double)theDecimalValue)*pow(10.0,theDecimalPlaces);
-		if( theExponentValue != 0 )
-			theValue *= pow(10,theExponentValue);
-		if( theNegative )
-			theValue = -theValue;
-		if( self->_delegateMethod.foundNumber != NULL )
-			self->_delegateMethod.foundNumber( self->_delegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithDouble:theValue] );
-		else if( self->_delegateMethod.foundFloat != NULL )
-			self->_delegateMethod.foundFloat( self->_delegate, @selector(jsonParser:foundFloat:), self, theValue );
+		theBytes[theLength++] = (uint8_t)(theQuantum>>10);
+		theBytes[theLength++] = (uint8_t)(theQuantum>>2);
 	}
-	else if( theDecimalPlaces > 0 )
+	if( !theValid )
 	{
-		if( theNegative )
-			theIntegerValue = -theIntegerValue;
-		if( self->_delegateMethod.foundNumber != NULL )
-			self->_delegateMethod.foundNumber( self->_delegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithLongLong:theIntegerValue] );
-		else if( self->_delegateMethod.foundInteger != NULL )
-			self->_delegateMethod.foundInteger( self->_delegate, @selector(jsonParser:foundInteger:), self, theIntegerValue );
+		free( theBytes );
+		return nil;
 	}
-	else
-		foundError(self, NDJSONBadNumberError );
-	
-	if( theResult )
-		backUp( self );
-	return theResult;
+	return [[NSData alloc] initWithBytesNoCopy:theBytes length:theLength freeWhenDone:YES];
 }
 
-BOOL parseJSONTrue( NDJSONParser * self )
+static inline BOOL reserveBytesOfLen( struct NDBytesBuffer * aBuffer, NSUInteger aLen )
 {
-	BOOL		theResult = YES;
-	uint32_t	theChar;
-	if( (theChar = NDJSONNextChar(self)) == 'r' && (theChar = NDJSONNextChar(self)) == 'u' && (theChar = NDJSONNextChar(self)) == 'e' )
-	{
-		if( self->_delegateMethod.foundNumber != NULL )
-			self->_delegateMethod.foundNumber( self->_delegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithBool:YES] );
-		else if( self->_delegateMethod.foundBool != NULL )
-			self->_delegateMethod.foundBool( self->_delegate, @selector(jsonParser:foundBool:), self, YES );
-	}
+	return aBuffer->length + aLen < aBuffer->capacity || extendsBytesOfLen( aBuffer, aLen );
+}
+
+/*
+	the string is decoded straight from the input buffer into the bytes of the NSData, runs of the alphabet are decoded 16
+	characters at a time, anything else, padding, escapes, white space, characters wider than 8 bits and the end of the
+	buffer, goes through NDJSONNextChar one character at a time, which refills the buffer for strings that span refills
+ */
+BOOL parseJSONBase64String( NDJSONParser * self )
+{
+	struct NDBytesBuffer	theBuffer = NDBytesBufferInit;
+	BOOL					theResult = YES,
+							theEnd = NO,
+							theValid = YES;
+	uint32_t				theQuantum = 0;
+	NSUInteger				theQuantumLength = 0,
+							thePaddingLength = 0;
+#ifdef NDJSONSupportUTF8Only
+	const BOOL				theIsWord8 = YES;
+#else
+	const BOOL				theIsWord8 = self->_character.wordSize == kNDJONCharacterWord8;
+#endif
+
+	while( theResult && !theEnd )
+	{
+		if( theIsWord8 && theValid && theQuantumLength == 0 && thePaddingLength == 0 && !self->_useBackUpByte && self->_position < self->_numberOfBytes )
+		{
+			const uint8_t	* theStart = self->_bytes.word8 + self->_position,
+							* theLimit = self->_bytes.word8 + self->_numberOfBytes,
+							* theQuote = memchr( theStart, '"', (size_t)(theLimit-theStart) ),
+							* thePos = theStart;
+			if( theQuote != NULL )
+				theLimit = theQuote;
+			if( reserveBytesOfLen( &theBuffer, (NSUInteger)(theLimit-theStart)/4*3 ) )
+			{
+				uint8_t		* theOutput = theBuffer.bytes + theBuffer.length;
+				while( theLimit-thePos >= 16 && decodeBase64Block( theOutput, thePos, 4 ) )
+					thePos += 16, theOutput += 12;
+				while( theLimit-thePos >= 4 && decodeBase64Block( theOutput, thePos, 1 ) )
+					thePos += 4, theOutput += 3;
+				theBuffer.length = (NSUInteger)(theOutput - theBuffer.bytes);
+				self->_position += (NSUInteger)(thePos-theStart);
+				self->_columnNumber += (NSUInteger)(thePos-theStart);
+			}
+			else
+			{
+				foundError( self, NDJSONMemoryErrorError );
+				theResult = NO;
+				break;
+			}
+		}
+
+		uint32_t	theChar = NDJSONNextChar(self);
+		BOOL		theIsEscaped = NO;
+		if( theChar == '\\' )
+		{
+			theIsEscaped = YES;
+			switch( (theChar = NDJSONNextChar(self)) )
+			{
+			case '\0':
+			case '/':
+				break;
+			case 'n':
+				theChar = '\n';
+				break;
+			case 'r':
+				theChar = '\r';
+				break;
+			case 't':
+				theChar = '\t';
+				break;
+			case 'u':
+			{
+				uint32_t		theCharacterValue = 0;
+				for( int i = 0; i < 4 && theCharacterValue != UINT32_MAX; i++ )
+				{
+					uint32_t		theDigitValue = integerForHexidecimalDigit( NDJSONNextChar(self) );
+					theCharacterValue = theDigitValue <= 0xF ? (theCharacterValue << 4) + theDigitValue : UINT32_MAX;
+				}
+				theChar = theCharacterValue != UINT32_MAX ? theCharacterValue : '\\';
+				break;
+			}
+			default:
+				theChar = '\\';
+				break;
+			}
+		}
+
+		if( theChar == '\0' && !theIsEscaped )
+			theResult = NO;
+		else if( theChar == '"' && !theIsEscaped )
+			theEnd = YES;
+		else if( theChar < 256 && kBase64DecodeTable[theChar] != kBase64NotAlphabet && thePaddingLength == 0 )
+		{
+			theQuantum = theQuantum<<6 | kBase64DecodeTable[theChar];
+			if( ++theQuantumLength == 4 )
+			{
+				if( !reserveBytesOfLen( &theBuffer, 3 ) )
+				{
+					foundError( self, NDJSONMemoryErrorError );
+					theResult = NO;
+				}
+				else
+				{
+					theBuffer.bytes[theBuffer.length++] = (uint8_t)(theQuantum>>16);
+					theBuffer.bytes[theBuffer.length++] = (uint8_t)(theQuantum>>8);
+					theBuffer.bytes[theBuffer.length++] = (uint8_t)theQuantum;
+				}
+				theQuantum = 0;
+				theQuantumLength = 0;
+			}
+		}
+		else if( theChar == '=' && theQuantumLength >= 2 && theQuantumLength+thePaddingLength < 4 )
+			thePaddingLength++;
+		else if( (theChar > 255 || !isspace((int)theChar)) && theValid )
+		{
+			foundError( self, NDJSONBadBase64Error );
+			theValid = NO;
+		}
+	}
+
+	if( theEnd && theValid )
+	{
+		if( theQuantumLength == 1 )
+			foundError( self, NDJSONBadBase64Error );
+		else if( theQuantumLength > 1 && !reserveBytesOfLen( &theBuffer, 2 ) )
+			foundError( self, NDJSONMemoryErrorError );
+		else
+		{
+			if( theQuantumLength == 2 )
+				theBuffer.bytes[theBuffer.length++] = (uint8_t)(theQuantum>>4);
+			else if( theQuantumLength == 3 )
+			{
+				theBuffer.bytes[theBuffer.length++] = (uint8_t)(theQuantum>>10);
+				theBuffer.bytes[theBuffer.length++] = (uint8_t)(theQuantum>>2);
+			}
+
+			NSData		* theValue = nil;
+			if( theBuffer.length > 0 )
+			{
+				uint8_t		* theBytes = theBuffer.length < theBuffer.capacity ? realloc( theBuffer.bytes, theBuffer.length ) : NULL;
+				if( theBytes != NULL )
+					theBuffer.bytes = theBytes;
+				theValue = [[NSData alloc] initWithBytesNoCopy:theBuffer.bytes length:theBuffer.length freeWhenDone:YES];
+				theBuffer = NDBytesBufferInit;			// the bytes now belong to theValue
+			}
+			else
+				theValue = [[NSData alloc] init];
+			NDJSONStatisticsCount( stringCount );
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundData( self->_delegate, @selector(jsonParser:foundData:), self, theValue ) );
+			[theValue release];
+		}
+	}
+	else if( !theEnd )
+		foundError( self, NDJSONBadFormatError );
+	freeByte( &theBuffer );
+	return theResult;
+}
+
+/*
+	reads a number leaving the character after it to be read next, the value is in anInteger, anUnsigned or aFloat depending on
+	the kind returned, integers are scanned as an unsigned long long so those above LLONG_MAX are exact, only integers too large
+	for an unsigned long long, or negative ones too large for a long long, are returned as floats
+ */
+enum NDJSONNumberKind scanJSONNumber( NDJSONParser * self, long long * anInteger, unsigned long long * anUnsigned, double * aFloat )
+{
+	enum NDJSONNumberKind	theKind = kNDJSONNumberBad;
+	BOOL			theNegative = NO;
+	BOOL			theEnd = NO,
+					theResult = YES,
+					theIntegerOverflow = NO;
+	unsigned long long	theIntegerValue = 0;
+	long long		theDecimalValue = 0,
+					theExponentValue = 0;
+	double			theLargeIntegerValue = 0.0;
+	int				theDecimalPlaces = 1;
+	
+	if( NDJSONNextChar(self) == '-' )
+		theNegative = YES;
+	else
+		backUp(self);
+	
+	while( !theEnd && theResult )
+	{
+		uint32_t		theChar = NDJSONNextChar(self);
+		switch( theChar )
+		{
+		case '\0':
+			theEnd = YES;
+			break;
+		case '0'...'9':
+			if( theDecimalPlaces <= 0 )
+			{
+				theDecimalPlaces--;
+				theDecimalValue = theDecimalValue * 10 + (theChar - '0');
+			}
+			else if( !theIntegerOverflow && (theIntegerValue < ULLONG_MAX/10 || (theIntegerValue == ULLONG_MAX/10 && theChar - '0' <= ULLONG_MAX%10)) )
+				theIntegerValue = theIntegerValue * 10 + (theChar - '0');
+			else
+			{
+				if( !theIntegerOverflow )
+				{
+					theLargeIntegerValue = (double)theIntegerValue;
+					theIntegerOverflow = YES;
+				}
+				theLargeIntegerValue = theLargeIntegerValue * 10.0 + (double)(theChar - '0');
+			}
+			break;
+		case 'e':
+		case 'E':
+		{
+			BOOL		theExponentNegative = 0;
+			theChar = NDJSONNextChar(self);
+			if( theChar == '+' || theChar == '-' )
+				theExponentNegative = (theChar == '-');
+			else if( theChar >= '0' && theChar <= '9' )
+				theExponentValue = (theChar - '0');
+			else
+			{
+				theEnd = YES;
+				foundError( self, NDJSONBadNumberError );
+			}
+			
+			while( !theEnd && theResult )
+			{
+				theChar = NDJSONNextChar(self);
+				switch( theChar )
+				{
+//				case '\0':
+//					theEnd = YES;
+//					break;
+				case '0'...'9':
+					theExponentValue = theExponentValue * 10 + (theChar - '0');
+					break;
+				default:
+					theEnd = YES;
+					break;
+				}
+			}
+			if( theExponentNegative )
+				theExponentValue = -theExponentValue;
+			break;
+		}
+		case '.':
+			if( theDecimalPlaces > 0 )
+				theDecimalPlaces = 0;
+			else
+				theEnd = YES;
+			break;
+		default:
+			theEnd = YES;
+			break;
+		}
+	}
+	
+	if( theDecimalPlaces < 0 || theExponentValue != 0 || theIntegerOverflow )
+	{
+		double	theValue = (theIntegerOverflow ? theLargeIntegerValue : (double)theIntegerValue) + ((double)theDecimalValue)*pow(10.0,theDecimalPlaces);
+		if( theExponentValue != 0 )
+			theValue *= pow(10,theExponentValue);
+		if( theNegative )
+			theValue = -theValue;
+		*aFloat = theValue;
+		theKind = kNDJSONNumberFloat;
+	}
+	else if( theDecimalPlaces > 0 )
+	{
+		if( theIntegerValue <= (unsigned long long)LLONG_MAX )
+		{
+			*anInteger = theNegative ? -(long long)theIntegerValue : (long long)theIntegerValue;
+			theKind = kNDJSONNumberInteger;
+		}
+		else if( theNegative && theIntegerValue == (unsigned long long)LLONG_MAX+1 )
+		{
+			*anInteger = LLONG_MIN;
+			theKind = kNDJSONNumberInteger;
+		}
+		else if( !theNegative )
+		{
+			*anUnsigned = theIntegerValue;
+			theKind = kNDJSONNumberUnsigned;
+		}
+		else
+		{
+			*aFloat = -(double)theIntegerValue;
+			theKind = kNDJSONNumberFloat;
+		}
+	}
+	
+	if( theResult )
+		backUp( self );
+	return theKind;
+}
+
+BOOL parseJSONNumber( NDJSONParser * self )
+{
+	long long			theIntegerValue = 0;
+	unsigned long long	theUnsignedValue = 0;
+	double				theFloatValue = 0.0;
+	switch( scanJSONNumber( self, &theIntegerValue, &theUnsignedValue, &theFloatValue ) )
+	{
+	case kNDJSONNumberFloat:
+		NDJSONStatisticsCount( floatCount );
+		if( self->_delegateMethod.foundNumber != NULL )
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundNumber( self->_delegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithDouble:theFloatValue] ) );
+		else if( self->_delegateMethod.foundFloat != NULL )
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundFloat( self->_delegate, @selector(jsonParser:foundFloat:), self, theFloatValue ) );
+		break;
+	case kNDJSONNumberInteger:
+		NDJSONStatisticsCount( integerCount );
+		if( self->_delegateMethod.foundNumber != NULL )
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundNumber( self->_delegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithLongLong:theIntegerValue] ) );
+		else if( self->_delegateMethod.foundInteger != NULL )
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundInteger( self->_delegate, @selector(jsonParser:foundInteger:), self, theIntegerValue ) );
+		break;
+	case kNDJSONNumberUnsigned:
+		NDJSONStatisticsCount( integerCount );
+		if( self->_delegateMethod.foundNumber != NULL )
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundNumber( self->_delegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithUnsignedLongLong:theUnsignedValue] ) );
+		else if( self->_delegateMethod.foundUnsignedInteger != NULL )
+			NDJSONTimedDelegateCall( ((NDUnsignedIntegerMethodIMP)self->_delegateMethod.foundUnsignedInteger)( self->_delegate, @selector(jsonParser:foundUnsignedInteger:), self, theUnsignedValue ) );
+		else if( self->_delegateMethod.foundFloat != NULL )
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundFloat( self->_delegate, @selector(jsonParser:foundFloat:), self, (double)theUnsignedValue ) );
+		break;
+	default:
+		foundError(self, NDJSONBadNumberError );
+		break;
+	}
+	return YES;
+}
+
+BOOL parseJSONTrue( NDJSONParser * self )
+{
+	BOOL		theResult = YES;
+	uint32_t	theChar;
+	if( (theChar = NDJSONNextChar(self)) == 'r' && (theChar = NDJSONNextChar(self)) == 'u' && (theChar = NDJSONNextChar(self)) == 'e' )
+	{
+		NDJSONStatisticsCount( booleanCount );
+		if( self->_delegateMethod.foundNumber != NULL )
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundNumber( self->_delegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithBool:YES] ) );
+		else if( self->_delegateMethod.foundBool != NULL )
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundBool( self->_delegate, @selector(jsonParser:foundBool:), self, YES ) );
+	}
 	else if( theChar == '\0' )
 		theResult = NO;
 	else
@@ -1405,10 +2456,11 @@ BOOL parseJSONFalse( NDJSONParser * self )
 	uint32_t	theChar;
 	if( (theChar = NDJSONNextChar(self)) == 'a' && (theChar = NDJSONNextChar(self)) == 'l' && (theChar = NDJSONNextChar(self)) == 's' && (theChar = NDJSONNextChar(self)) == 'e' )
 	{
+		NDJSONStatisticsCount( booleanCount );
 		if( self->_delegateMethod.foundNumber != NULL )
-			self->_delegateMethod.foundNumber( self->_delegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithBool:NO] );
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundNumber( self->_delegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithBool:NO] ) );
 		else if( self->_delegateMethod.foundBool != NULL )
-			self->_delegateMethod.foundBool( self->_delegate, @selector(jsonParser:foundBool:), self, NO );
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundBool( self->_delegate, @selector(jsonParser:foundBool:), self, NO ) );
 	}
 	else if( theChar == '\0' )
 		theResult = NO;
@@ -1423,8 +2475,9 @@ BOOL parseJSONNull( NDJSONParser * self )
 	uint32_t	theChar;
 	if( (theChar = NDJSONNextChar(self)) == 'u' && (theChar = NDJSONNextChar(self)) == 'l' && (theChar = NDJSONNextChar(self)) == 'l' )
 	{
+		NDJSONStatisticsCount( nullCount );
 		if( self->_delegateMethod.foundNULL != NULL )
-			self->_delegateMethod.foundNULL( self->_delegate, @selector(jsonParserFoundNULL:), self );
+			NDJSONTimedDelegateCall( self->_delegateMethod.foundNULL( self->_delegate, @selector(jsonParserFoundNULL:), self ) );
 	}
 	else if( theChar == '\0' )
 		theResult = NO;
@@ -1433,7 +2486,11 @@ BOOL parseJSONNull( NDJSONParser * self )
 	return theResult;
 }
 
-BOOL skipNextValue( NDJSONParser * self )
+/*
+	skips to the comma or end of container after the value, a root value of JSON Lines is followed by the next record
+	instead so skipping ends with the end of its object or array
+ */
+BOOL skipNextValue( NDJSONParser * self, BOOL aIsRootValue )
 {
 	NSUInteger		theBracesDepth = 0,
 					theBracketsDepth = 0;
@@ -1450,7 +2507,10 @@ BOOL skipNextValue( NDJSONParser * self )
 			break;
 		case '}':
 			if( theBracesDepth > 0 )
+			{
 				theBracesDepth--;
+				theEnd = aIsRootValue && theBracesDepth == 0 && theBracketsDepth == 0;
+			}
 			else
 			{
 				backUp(self);
@@ -1462,7 +2522,10 @@ BOOL skipNextValue( NDJSONParser * self )
 			break;
 		case ']':
 			if( theBracketsDepth > 0 )
+			{
 				theBracketsDepth--;
+				theEnd = aIsRootValue && theBracesDepth == 0 && theBracketsDepth == 0;
+			}
 			else
 			{
 				backUp(self);
@@ -1499,6 +2562,8 @@ BOOL skipNextValue( NDJSONParser * self )
 
 void foundError( NDJSONParser * self, NDJSONErrorCode aCode )
 {
+	if( self->_abort )			// whatever aborted parsing has already reported why
+		return;
 	NSMutableDictionary		* theUserInfo = [[NSMutableDictionary alloc] initWithObjectsAndKeys:kErrorCodeStrings[aCode],NSLocalizedDescriptionKey, nil];
 	NSString				* theString = nil;
 	NSString				* theHistoryString = nil;
@@ -1534,10 +2599,20 @@ void foundError( NDJSONParser * self, NDJSONErrorCode aCode )
 	case NDJSONPrematureEndError:
 		theString = [[NSString alloc] initWithFormat:@"Premature End of data at pos %lu, %@", (unsigned long)self->_position, theHistoryString];
 		break;
+	case NDJSONBadBase64Error:
+		theString = [[NSString alloc] initWithFormat:@"Bad base64 data at pos %lu, %@", (unsigned long)(self->_position > 0 ? self->_position-1 : self->_position), theHistoryString];
+		break;
+	case NDJSONBadNumberError:
+		theString = [[NSString alloc] initWithFormat:@"Bad number at pos %lu, %@", (unsigned long)self->_position, theHistoryString];
+		break;
+	case NDJSONInflateError:
+		theString = [[NSString alloc] initWithFormat:@"Corrupt compressed input, zlib error %d %s after %llu inflated bytes", self->_inflate.status, self->_inflate.stream.msg != NULL ? self->_inflate.stream.msg : "", self->_bytesBefore];
+		break;
 	}
-	[theUserInfo setObject:theString forKey:NSLocalizedFailureReasonErrorKey];
+	if( theString != nil )
+		[theUserInfo setObject:theString forKey:NSLocalizedFailureReasonErrorKey];
 	if( self->_delegateMethod.foundError != NULL )
-		self->_delegateMethod.foundError( self->_delegate, @selector(jsonParser:error:), self, [NSError errorWithDomain:NDJSONErrorDomain code:aCode userInfo:theUserInfo] );
+		NDJSONTimedDelegateCall( self->_delegateMethod.foundError( self->_delegate, @selector(jsonParser:error:), self, [NSError errorWithDomain:NDJSONErrorDomain code:aCode userInfo:theUserInfo] ) );
 	[theUserInfo release];
 #ifndef NDJSON_SUPPRESS_ALL_LOGING
 	NSLog( @"NDJSON: Error, code:%u reason: %@", aCode, theString );
@@ -1547,6 +2622,615 @@ void foundError( NDJSONParser * self, NDJSONErrorCode aCode )
 
 @end
 
+#pragma mark - NDJSONParseStatistics
+
+@implementation NDJSONParseStatistics
+
+- (NSUInteger)bytesConsumed { return _counters.bytesConsumed; }
+- (NSUInteger)refillCount { return _counters.refillCount; }
+- (NSTimeInterval)sourceTime { return _counters.sourceTime; }
+- (NSUInteger)objectCount { return _counters.objectCount; }
+- (NSUInteger)arrayCount { return _counters.arrayCount; }
+- (NSUInteger)keyCount { return _counters.keyCount; }
+- (NSUInteger)stringCount { return _counters.stringCount; }
+- (NSUInteger)integerCount { return _counters.integerCount; }
+- (NSUInteger)floatCount { return _counters.floatCount; }
+- (NSUInteger)booleanCount { return _counters.booleanCount; }
+- (NSUInteger)nullCount { return _counters.nullCount; }
+- (NSUInteger)maximumDepth { return _counters.maximumDepth; }
+- (NSUInteger)stringsCreated { return _counters.stringsCreated; }
+- (NSUInteger)stringBytesCopied { return _counters.stringBytesCopied; }
+- (NSUInteger)skippedKeyCount { return _counters.skippedKeyCount; }
+- (NSUInteger)documentCount { return _counters.documentCount; }
+- (NSTimeInterval)totalTime { return _counters.totalTime; }
+- (NSTimeInterval)delegateTime { return _counters.delegateTime; }
+- (NSTimeInterval)scannerTime { return _counters.totalTime - _counters.delegateTime - _counters.sourceTime; }
+
+- (void)reset { memset( &_counters, 0, sizeof(_counters) ); }
+
+- (NSDictionary *)dictionaryRepresentation
+{
+	NSMutableDictionary		* theResult = [NSMutableDictionary dictionary];
+	for( NSString * theKey in [NSArray arrayWithObjects:@"bytesConsumed", @"refillCount", @"sourceTime", @"objectCount", @"arrayCount", @"keyCount", @"stringCount", @"integerCount", @"floatCount", @"booleanCount", @"nullCount", @"maximumDepth", @"stringsCreated", @"stringBytesCopied", @"skippedKeyCount", @"documentCount", @"totalTime", @"delegateTime", @"scannerTime", nil] )
+		[theResult setObject:[self valueForKey:theKey] forKey:theKey];
+	return theResult;
+}
+
+- (NSString *)description { return [NSString stringWithFormat:@"%@ %@", [super description], [self dictionaryRepresentation]]; }
+
+@end
+
+#pragma mark - NDJSONKeyTable
+
+struct NDJSONKeyTableSlot
+{
+	const uint8_t		* bytes;
+	NSUInteger			length,
+						index;
+	uint32_t			hash;
+};
+
+@interface NDJSONKeyTable ()
+{
+	NSArray						* _keys;
+	struct NDJSONKeyTableSlot	* _slots;
+	NSUInteger					_slotMask;
+	uint8_t						* _keyBytes;
+}
+
+@end
+
+/*
+	FNV-1a, keys are short so something simple is fine
+ */
+static uint32_t NDJSONKeyTableHash( const uint8_t * aBytes, NSUInteger aLength )
+{
+	uint32_t		theResult = 2166136261u;
+	for( NSUInteger i = 0; i < aLength; i++ )
+		theResult = (theResult ^ aBytes[i]) * 16777619u;
+	return theResult;
+}
+
+@implementation NDJSONKeyTable
+
+@synthesize		keys = _keys;
+
+- (NSUInteger)count { return _keys.count; }
+
+- (id)initWithKeys:(NSArray *)aKeys
+{
+	NSParameterAssert( aKeys != nil );
+	if( (self = [super init]) != nil )
+	{
+		NSUInteger		theSlotCount = 8,
+						theBytesLength = 0,
+						theOffset = 0;
+		_keys = [aKeys copy];
+		while( theSlotCount < _keys.count*2 )
+			theSlotCount <<= 1;
+		_slotMask = theSlotCount-1;
+		_slots = malloc(theSlotCount*sizeof(struct NDJSONKeyTableSlot));
+		for( NSUInteger i = 0; i < theSlotCount; i++ )
+			_slots[i].index = NSNotFound;
+
+		for( NSString * theKey in _keys )
+			theBytesLength += [theKey lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+		_keyBytes = malloc(theBytesLength > 0 ? theBytesLength : 1);
+
+		for( NSUInteger theIndex = 0; theIndex < _keys.count; theIndex++ )
+		{
+			NSString		* theKey = [_keys objectAtIndex:theIndex];
+			NSUInteger		theLength = [theKey lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+			uint8_t			* theBytes = _keyBytes+theOffset;
+			uint32_t		theHash;
+			[theKey getBytes:theBytes maxLength:theLength usedLength:NULL encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, theKey.length) remainingRange:NULL];
+			theHash = NDJSONKeyTableHash( theBytes, theLength );
+			if( NDJSONKeyTableIndexForBytes( self, theBytes, theLength ) == NSNotFound )		// first key wins for duplicates
+			{
+				NSUInteger		theSlot = theHash & _slotMask;
+				while( _slots[theSlot].index != NSNotFound )
+					theSlot = (theSlot+1) & _slotMask;
+				_slots[theSlot].bytes = theBytes;
+				_slots[theSlot].length = theLength;
+				_slots[theSlot].index = theIndex;
+				_slots[theSlot].hash = theHash;
+			}
+			theOffset += theLength;
+		}
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[_keys release];
+	free(_slots);
+	free(_keyBytes);
+	[super dealloc];
+}
+
+- (NSString *)keyAtIndex:(NSUInteger)anIndex { return [_keys objectAtIndex:anIndex]; }
+- (NSUInteger)indexForKeyBytes:(const uint8_t *)aBytes length:(NSUInteger)aLength { return NDJSONKeyTableIndexForBytes( self, aBytes, aLength ); }
+
+NSUInteger NDJSONKeyTableIndexForBytes( NDJSONKeyTable * aKeyTable, const uint8_t * aBytes, NSUInteger aLength )
+{
+	uint32_t		theHash = NDJSONKeyTableHash( aBytes, aLength );
+	NSUInteger		theSlot = theHash & aKeyTable->_slotMask;
+	while( aKeyTable->_slots[theSlot].index != NSNotFound )
+	{
+		struct NDJSONKeyTableSlot	* theEntry = &aKeyTable->_slots[theSlot];
+		if( theEntry->hash == theHash && theEntry->length == aLength && memcmp( theEntry->bytes, aBytes, aLength ) == 0 )
+			return theEntry->index;
+		theSlot = (theSlot+1) & aKeyTable->_slotMask;
+	}
+	return NSNotFound;
+}
+
+NSString * NDJSONKeyTableKeyAtIndex( NDJSONKeyTable * aKeyTable, NSUInteger anIndex ) { return [aKeyTable->_keys objectAtIndex:anIndex]; }
+
+@end
+
+#pragma mark - NDJSONReader
+
+/*
+	what is expected next within the root and each open container
+ */
+enum NDJSONReaderState
+{
+	kNDJSONReaderRootValue,
+	kNDJSONReaderRootNext,
+	kNDJSONReaderObjectStart,
+	kNDJSONReaderObjectKey,
+	kNDJSONReaderObjectValue,
+	kNDJSONReaderObjectNext,
+	kNDJSONReaderArrayStart,
+	kNDJSONReaderArrayValue,
+	kNDJSONReaderArrayNext
+};
+
+@interface NDJSONReader () <NDJSONParserDelegate>
+{
+	uint8_t							* _states;					// the root then each open container
+	NSUInteger						_depth,
+									_statesSize;
+	int64_t							_integerValue;
+	double							_floatValue;
+	BOOL							_boolValue,
+									_started;
+	NSError							* _error;
+}
+
+@end
+
+@implementation NDJSONReader
+
+@synthesize		error = _error,
+				depth = _depth,
+				integerValue = _integerValue,
+				floatValue = _floatValue,
+				boolValue = _boolValue;
+
+- (const uint8_t *)stringBytes { return _scratchBuffer.bytes; }
+- (NSUInteger)stringLength { return _scratchBuffer.length; }
+
+- (void)dealloc
+{
+	[self finish];
+	free( _states );
+	[_error release];
+	[super dealloc];
+}
+
+- (void)reset
+{
+	[self finish];
+	[super reset];
+}
+
+- (BOOL)startWithOptions:(NDJSONOptionFlags)anOptions
+{
+	[self finish];
+	self.delegate = self;
+	_options.strictJSONOnly = (anOptions&NDJSONOptionStrict) != 0;
+	_options.JSONLines = (anOptions&NDJSONOptionJSONLines) != 0;
+#ifdef NDJSONCollectStatistics
+	_statisticsCounters = _statistics != nil ? &_statistics->_counters : NULL;
+#endif
+	switch( _inputType )
+	{
+	case kJSONDataInputType:
+	case kJSONStringInputType:
+		startInputData( self );
+		break;
+	case kJSONStreamInputType:
+	case kJSONURLRequestType:
+		[_source.object open];
+		break;
+	case kJSONStreamFunctionType:
+	case kJSONStreamBlockType:
+		break;
+	default:
+		return NO;
+	}
+	if( _states == NULL )
+	{
+		_statesSize = 16;
+		_states = malloc( _statesSize );
+	}
+	_depth = 0;
+	_states[0] = kNDJSONReaderRootValue;
+	[_error release], _error = nil;
+	_started = YES;
+	return YES;
+}
+
+- (void)finish
+{
+	if( _started )
+	{
+		_started = NO;
+		if( _inputType == kJSONStreamInputType || _inputType == kJSONURLRequestType )
+			[_source.object close];
+		endInflating( self );
+		releaseSource( self );
+	}
+}
+
+static NDJSONTokenType NDJSONReaderFail( NDJSONReader * self, NDJSONErrorCode aCode )
+{
+	foundError( self, aCode );
+	return NDJSONTokenNone;
+}
+
+/*
+	reads the first character of the next token, commas and the end of each root value of JSON Lines are read as
+	well, anIsKey is set if the character starts a key
+ */
+static uint32_t NDJSONReaderTokenChar( NDJSONReader * self, BOOL * anIsKey )
+{
+	*anIsKey = NO;
+	if( !self->_started || self->_error != nil )
+		return '\0';
+	for( ;; )
+	{
+		uint8_t		* theState = &self->_states[self->_depth];
+		uint32_t	theChar = '\0';
+		if( *theState == kNDJSONReaderRootNext && (!self->_options.JSONLines || self->_singleValue) )
+			return '\0';							// whatever follows a single root value is not looked at
+		theChar = NDJSONNextCharIgnoreWhiteSpace( self );
+		switch( *theState )
+		{
+		case kNDJSONReaderRootNext:
+			if( theChar != '\0' )
+				*theState = kNDJSONReaderRootValue;
+			return theChar;
+		case kNDJSONReaderObjectStart:
+			if( theChar == '}' )
+				return theChar;
+			*theState = kNDJSONReaderObjectKey;
+			*anIsKey = YES;
+			return theChar;
+		case kNDJSONReaderObjectKey:
+			*anIsKey = theChar != '\0';
+			return theChar;
+		case kNDJSONReaderArrayStart:
+			if( theChar != ']' )
+				*theState = kNDJSONReaderArrayValue;
+			return theChar;
+		case kNDJSONReaderObjectNext:
+		case kNDJSONReaderArrayNext:
+			if( theChar != ',' )
+				return theChar;
+			if( !self->_options.strictJSONOnly )		// allow trailing comma
+			{
+				uint32_t	theNextChar = NDJSONNextCharIgnoreWhiteSpace( self );
+				if( theNextChar == (*theState == kNDJSONReaderObjectNext ? '}' : ']') )
+					return theNextChar;
+				backUp( self );
+			}
+			*theState = *theState == kNDJSONReaderObjectNext ? kNDJSONReaderObjectKey : kNDJSONReaderArrayValue;
+			break;
+		default:
+			return theChar;
+		}
+	}
+}
+
+/*
+	the value about to be read is followed by a comma or the end of its container
+ */
+static BOOL NDJSONReaderStartValue( NDJSONReader * self )
+{
+	uint8_t		* theState = &self->_states[self->_depth];
+	switch( *theState )
+	{
+	case kNDJSONReaderRootValue:
+		*theState = kNDJSONReaderRootNext;
+		return YES;
+	case kNDJSONReaderObjectValue:
+		*theState = kNDJSONReaderObjectNext;
+		return YES;
+	case kNDJSONReaderArrayValue:
+		*theState = kNDJSONReaderArrayNext;
+		return YES;
+	default:
+		return NO;
+	}
+}
+
+static BOOL NDJSONReaderPush( NDJSONReader * self, enum NDJSONReaderState aState )
+{
+	if( self->_depth+1 >= self->_statesSize )
+	{
+		uint8_t		* theStates = realloc( self->_states, self->_statesSize<<1 );
+		if( theStates == NULL )
+			return NO;
+		self->_states = theStates;
+		self->_statesSize <<= 1;
+	}
+	self->_states[++self->_depth] = (uint8_t)aState;
+	return YES;
+}
+
+static BOOL NDJSONReaderLiteral( NDJSONReader * self, const char * aRemaining )
+{
+	for( ; *aRemaining != '\0'; aRemaining++ )
+	{
+		if( NDJSONNextChar( self ) != (uint32_t)*aRemaining )
+			return NO;
+	}
+	return YES;
+}
+
+- (NDJSONTokenType)nextToken
+{
+	BOOL					theIsKey = NO;
+	uint32_t				theChar = NDJSONReaderTokenChar( self, &theIsKey );
+	uint8_t					theState = _started ? _states[_depth] : kNDJSONReaderRootNext;
+	struct NDBytesBuffer	* theBuffer = NDJSONScratchBuffer( self );
+	if( theIsKey )
+	{
+		BOOL		theResult = NO;
+		if( theChar == '"' )
+			theResult = parseJSONText( self, theBuffer, YES, YES );
+		else if( !_options.strictJSONOnly && theChar != '}' )			// keys don't have to be quoted
+		{
+			backUp( self );
+			theResult = parseJSONText( self, theBuffer, YES, NO );
+		}
+		if( !theResult || _error != nil || NDJSONNextCharIgnoreWhiteSpace( self ) != ':' )
+			return NDJSONReaderFail( self, NDJSONBadFormatError );
+		_states[_depth] = kNDJSONReaderObjectValue;
+		return NDJSONTokenKey;
+	}
+
+	switch( theChar )
+	{
+	case '\0':
+		return _depth > 0 && _error == nil ? NDJSONReaderFail( self, NDJSONPrematureEndError ) : NDJSONTokenNone;
+	case '}':
+		if( theState != kNDJSONReaderObjectStart && theState != kNDJSONReaderObjectNext )
+			return NDJSONReaderFail( self, NDJSONBadFormatError );
+		_depth--;
+		return NDJSONTokenEndObject;
+	case ']':
+		if( theState != kNDJSONReaderArrayStart && theState != kNDJSONReaderArrayNext )
+			return NDJSONReaderFail( self, NDJSONBadFormatError );
+		_depth--;
+		return NDJSONTokenEndArray;
+	}
+
+	if( !NDJSONReaderStartValue( self ) )									// a comma is missing
+		return NDJSONReaderFail( self, NDJSONBadFormatError );
+	switch( theChar )
+	{
+	case '{':
+		return NDJSONReaderPush( self, kNDJSONReaderObjectStart ) ? NDJSONTokenStartObject : NDJSONReaderFail( self, NDJSONMemoryErrorError );
+	case '[':
+		return NDJSONReaderPush( self, kNDJSONReaderArrayStart ) ? NDJSONTokenStartArray : NDJSONReaderFail( self, NDJSONMemoryErrorError );
+	case '"':
+		if( !parseJSONText( self, theBuffer, NO, YES ) || _error != nil )
+			return NDJSONReaderFail( self, NDJSONPrematureEndError );
+		NDJSONStatisticsCount( stringCount );
+		return NDJSONTokenString;
+	case '0' ... '9':
+	case '-':
+	{
+		long long			theIntegerValue = 0;
+		unsigned long long	theUnsignedValue = 0;
+		backUp( self );
+		switch( scanJSONNumber( self, &theIntegerValue, &theUnsignedValue, &_floatValue ) )
+		{
+		case kNDJSONNumberInteger:
+			NDJSONStatisticsCount( integerCount );
+			_integerValue = theIntegerValue;
+			_floatValue = (double)theIntegerValue;
+			return NDJSONTokenInteger;
+		case kNDJSONNumberUnsigned:							// too large for integerValue
+			NDJSONStatisticsCount( integerCount );
+			_floatValue = (double)theUnsignedValue;
+			return NDJSONTokenFloat;
+		case kNDJSONNumberFloat:
+			NDJSONStatisticsCount( floatCount );
+			return NDJSONTokenFloat;
+		default:
+			return NDJSONReaderFail( self, NDJSONBadNumberError );
+		}
+	}
+	case 't':
+	case 'f':
+		if( !NDJSONReaderLiteral( self, theChar == 't' ? "rue" : "alse" ) )
+			return NDJSONReaderFail( self, NDJSONBadTokenError );
+		NDJSONStatisticsCount( booleanCount );
+		_boolValue = theChar == 't';
+		return NDJSONTokenBool;
+	case 'n':
+		if( !NDJSONReaderLiteral( self, "ull" ) )
+			return NDJSONReaderFail( self, NDJSONBadTokenError );
+		NDJSONStatisticsCount( nullCount );
+		return NDJSONTokenNull;
+	default:
+		return NDJSONReaderFail( self, NDJSONBadFormatError );
+	}
+}
+
+- (NDJSONTokenType)peekTokenType
+{
+	BOOL		theIsKey = NO;
+	uint32_t	theChar = NDJSONReaderTokenChar( self, &theIsKey );
+	uint8_t		theState = _states != NULL ? _states[_depth] : kNDJSONReaderRootNext;
+	if( theChar == '\0' )
+		return NDJSONTokenNone;
+	backUp( self );
+	if( theIsKey )
+		return NDJSONTokenKey;
+	switch( theChar )
+	{
+	case '}':
+		return NDJSONTokenEndObject;
+	case ']':
+		return NDJSONTokenEndArray;
+	}
+	if( theState == kNDJSONReaderObjectNext || theState == kNDJSONReaderArrayNext )
+		return NDJSONTokenNone;											// a comma is missing, nextToken reports it
+	switch( theChar )
+	{
+	case '{':
+		return NDJSONTokenStartObject;
+	case '[':
+		return NDJSONTokenStartArray;
+	case '"':
+		return NDJSONTokenString;
+	case '0' ... '9':
+	case '-':
+		return NDJSONTokenNumber;
+	case 't':
+	case 'f':
+		return NDJSONTokenBool;
+	case 'n':
+		return NDJSONTokenNull;
+	default:
+		return NDJSONTokenNone;
+	}
+}
+
+- (BOOL)readInt64:(int64_t *)aValue
+{
+	if( [self peekTokenType] != NDJSONTokenNumber || [self nextToken] != NDJSONTokenInteger )
+		return NO;
+	*aValue = _integerValue;
+	return YES;
+}
+
+- (BOOL)readDouble:(double *)aValue
+{
+	if( [self peekTokenType] != NDJSONTokenNumber || [self nextToken] == NDJSONTokenNone )
+		return NO;
+	*aValue = _floatValue;
+	return YES;
+}
+
+- (BOOL)readBool:(BOOL *)aValue
+{
+	if( [self peekTokenType] != NDJSONTokenBool || [self nextToken] != NDJSONTokenBool )
+		return NO;
+	*aValue = _boolValue;
+	return YES;
+}
+
+- (const uint8_t *)readStringBytes:(NSUInteger *)aLength
+{
+	if( [self peekTokenType] != NDJSONTokenString || [self nextToken] != NDJSONTokenString )
+		return NULL;
+	*aLength = _scratchBuffer.length;
+	return _scratchBuffer.bytes != NULL ? _scratchBuffer.bytes : (const uint8_t *)"";
+}
+
+- (BOOL)skipValue
+{
+	NDJSONTokenType		theType = [self peekTokenType];
+	if( theType == NDJSONTokenKey )
+	{
+		[self nextToken];
+		theType = [self peekTokenType];
+	}
+	switch( theType )
+	{
+	case NDJSONTokenNone:
+	case NDJSONTokenKey:
+	case NDJSONTokenEndObject:
+	case NDJSONTokenEndArray:
+		return NO;
+	case NDJSONTokenStartObject:
+	case NDJSONTokenStartArray:
+		break;
+	default:
+		if( _depth == 0 )						// the skipper would run on into the next JSON Lines record
+			return [self nextToken] != NDJSONTokenNone;
+		break;
+	}
+	NDJSONReaderStartValue( self );
+	if( !skipNextValue( self, _depth == 0 ) )
+	{
+		NDJSONReaderFail( self, NDJSONPrematureEndError );
+		return NO;
+	}
+	return YES;
+}
+
+- (BOOL)enterObject
+{
+	return [self peekTokenType] == NDJSONTokenStartObject && [self nextToken] == NDJSONTokenStartObject;
+}
+
+- (const uint8_t *)nextKeyBytes:(NSUInteger *)aLength
+{
+	switch( [self peekTokenType] )
+	{
+	case NDJSONTokenEndObject:
+		[self nextToken];
+		return NULL;
+	case NDJSONTokenKey:
+		if( [self nextToken] != NDJSONTokenKey )
+			return NULL;
+		*aLength = _scratchBuffer.length;
+		return _scratchBuffer.bytes != NULL ? _scratchBuffer.bytes : (const uint8_t *)"";
+	default:
+		return NULL;
+	}
+}
+
+- (BOOL)enterArray
+{
+	return [self peekTokenType] == NDJSONTokenStartArray && [self nextToken] == NDJSONTokenStartArray;
+}
+
+- (BOOL)nextElement
+{
+	switch( [self peekTokenType] )
+	{
+	case NDJSONTokenEndArray:
+		[self nextToken];
+		return NO;
+	case NDJSONTokenNone:
+	case NDJSONTokenKey:
+	case NDJSONTokenEndObject:
+		return NO;
+	default:
+		return YES;
+	}
+}
+
+#pragma mark - NDJSONParserDelegate methods
+
+- (void)jsonParser:(NDJSONParser *)aParser error:(NSError *)anError
+{
+	if( _error == nil )
+		_error = [anError retain];
+}
+
+@end
+
 static BOOL extendsBytesOfLen( struct NDBytesBuffer * aBuffer, NSUInteger aLen )
 {
 	BOOL			theResult = YES;
@@ -1566,6 +3250,18 @@ static BOOL extendsBytesOfLen( struct NDBytesBuffer * aBuffer, NSUInteger aLen )
 	return theResult;
 }
 
+/*
+	the buffer is grown at most once for the whole sequence
+ */
+static BOOL appendByteSequence( struct NDBytesBuffer * aBuffer, const void * aBytes, NSUInteger aLength )
+{
+	if( aBuffer->length + aLength >= aBuffer->capacity && !extendsBytesOfLen( aBuffer, aLength ) )
+		return NO;
+	memcpy( aBuffer->bytes+aBuffer->length, aBytes, aLength );
+	aBuffer->length += aLength;
+	return YES;
+}
+
 BOOL appendBytes( struct NDBytesBuffer * aBuffer, uint32_t aByte, enum NDJSONCharacterWordSize aWordSize )
 {
 	BOOL	theResult = YES;
@@ -1581,7 +3277,7 @@ BOOL appendBytes( struct NDBytesBuffer * aBuffer, uint32_t aByte, enum NDJSONCha
 	if( theResult )
 	{
 #ifdef NDJSONSupportUTF8Only
-		aBuffer->_bytes[aBuffer->length] = (uint8_t)aByte;
+		aBuffer->bytes[aBuffer->length] = (uint8_t)aByte;
 		aBuffer->length++;
 #else
 		memcpy( aBuffer->bytes+aBuffer->length, &aByte, 1<<aWordSize );
@@ -1591,68 +3287,39 @@ BOOL appendBytes( struct NDBytesBuffer * aBuffer, uint32_t aByte, enum NDJSONCha
 	return theResult;
 }
 
+/*
+	the encoded character is built on the stack then appended in one step
+ */
 BOOL appendCharacter( struct NDBytesBuffer * aBuffer, uint32_t aValue, enum NDJSONCharacterWordSize aWordSize )
 {
 	switch (aWordSize)
 	{
 	case kNDJONCharacterWord8:
-		if( aValue > 0x3ffffff )				// 1111110x	10xxxxxx	10xxxxxx	10xxxxxx	10xxxxxx	10xxxxxx
-		{
-			if( !appendBytes( aBuffer, ((aValue>>31) & 0xf) | 0xfc, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, ((aValue>>30) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, ((aValue>>24) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, ((aValue>>18) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, ((aValue>>12) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, ((aValue>>6) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
-		}
-		else if( aValue > 0x1fffff )			// 111110xx	10xxxxxx	10xxxxxx	10xxxxxx	10xxxxxx
-		{
-			if( !appendBytes( aBuffer, ((aValue>>24) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, ((aValue>>18) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, ((aValue>>12) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, ((aValue>>6) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
-		}
-		else if( aValue > 0xffff )				// 11110xxx	10xxxxxx	10xxxxxx	10xxxxxx
+	{
+		uint8_t		theBytes[4];
+		NSUInteger	theLength = 0;
+		if( aValue > 0xffff )					// 11110xxx	10xxxxxx	10xxxxxx	10xxxxxx
 		{
-			if( !appendBytes( aBuffer, ((aValue>>18) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, ((aValue>>12) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, ((aValue>>6) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
+			theBytes[theLength++] = ((aValue>>18) & 0x7) | 0xf0;
+			theBytes[theLength++] = ((aValue>>12) & 0x3f) | 0x80;
+			theBytes[theLength++] = ((aValue>>6) & 0x3f) | 0x80;
+			theBytes[theLength++] = (aValue & 0x3f) | 0x80;
 		}
 		else if( aValue > 0x7ff )				// 1110xxxx	10xxxxxx	10xxxxxx
 		{
-			if( !appendBytes( aBuffer, ((aValue>>12) & 0xf) | 0xE0, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, ((aValue>>6) & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, (aValue & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
+			theBytes[theLength++] = ((aValue>>12) & 0xf) | 0xe0;
+			theBytes[theLength++] = ((aValue>>6) & 0x3f) | 0x80;
+			theBytes[theLength++] = (aValue & 0x3f) | 0x80;
 		}
 		else if( aValue > 0x7f )				// 110xxxxx	10xxxxxx
 		{
-			if( !appendBytes( aBuffer, ((aValue>>6) & 0x1f) | 0xc0, kNDJONCharacterWord8 ) )
-				return NO;
-			if( !appendBytes( aBuffer, (aValue & 0x3f) | 0x80, kNDJONCharacterWord8 ) )
-				return NO;
+			theBytes[theLength++] = ((aValue>>6) & 0x1f) | 0xc0;
+			theBytes[theLength++] = (aValue & 0x3f) | 0x80;
 		}
 		else									// 0xxxxxxx
-		{
-			if( !appendBytes( aBuffer, aValue & 0x7f, kNDJONCharacterWord8 ) )
-				return NO;
-		}
-		break;
+			theBytes[theLength++] = aValue & 0x7f;
+		return appendByteSequence( aBuffer, theBytes, theLength );
+	}
 	case kNDJSONCharacterWord16:
 		if( aValue > 0x10ffff || (aValue >= 0Xd800 && aValue <= 0xdfff) )
 		{
@@ -1661,20 +3328,13 @@ BOOL appendCharacter( struct NDBytesBuffer * aBuffer, uint32_t aValue, enum NDJS
 		}
 		else if( aValue > 0xffff )
 		{
-			if( !appendBytes( aBuffer, (uint16_t)((aValue-0x10000)>>10)+0xd800, kNDJSONCharacterWord16 )
-				   && !appendBytes( aBuffer, (uint16_t)((aValue-0x10000)&0x3ff)+0xdc00, kNDJSONCharacterWord16 ) )
-				return NO;
+			uint16_t	theUnits[2] = { (uint16_t)(((aValue-0x10000)>>10)+0xd800), (uint16_t)(((aValue-0x10000)&0x3ff)+0xdc00) };
+			return appendByteSequence( aBuffer, theUnits, sizeof(theUnits) );
 		}
 		else
-		{
-			if( !appendBytes( aBuffer, aValue & 0xffff, kNDJSONCharacterWord16 ) )
-				return NO;
-		}
-		break;
+			return appendBytes( aBuffer, aValue & 0xffff, kNDJSONCharacterWord16 );
 	case kNDJSONCharacterWord32:
-		if( !appendBytes( aBuffer, aValue, kNDJSONCharacterWord32 ) )
-			return NO;
-		break;
+		return appendBytes( aBuffer, aValue, kNDJSONCharacterWord32 );
 	}
 	return YES;
 }
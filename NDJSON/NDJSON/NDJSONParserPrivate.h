@@ -0,0 +1,83 @@
+/*
+	NDJSONParserPrivate.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "NDJSONParser.h"
+
+/*
+	Private to NDJSON, used by the classes that stand in for an NDJSONParser or sit between a parser and its delegate,
+	NDJSONSchemaValidator, NDJSONMulticastDelegate, NDJSONTapeParser and NDJSONPipelinedParser, so they look up and call
+	the delegate methods the same way NDJSONParser does.
+ */
+
+typedef void (*NDVoidMethodIMP)( id, SEL, id );
+typedef void (*NDObjectMethodIMP)( id, SEL, id, id );
+typedef void (*NDIntegerMethodIMP)( id, SEL, id, NSInteger );
+typedef void (*NDUnsignedIntegerMethodIMP)( id, SEL, id, unsigned long long );
+typedef void (*NDFloatMethodIMP)( id, SEL, id, double );
+typedef void (*NDBoolMethodIMP)( id, SEL, id, BOOL );
+typedef void (*NDBytesMethodIMP)( id, SEL, id, const uint8_t *, NSUInteger );
+typedef NDJSONKeyTable * (*NDKeyTableMethodIMP)( id, SEL, id );
+typedef BOOL (*NDReturnBoolMethodIMP)( id, SEL, id, id );
+
+/*
+	the implementations of the NDJSONParserDelegate methods, NULL for the methods the delegate does not respond to
+ */
+struct NDJSONDelegateMethods
+{
+	IMP								didStartDocument,
+									didEndDocument,
+									didStartArray,
+									didEndArray,
+									didStartObject,
+									didEndObject,
+									keyTableForCurrentObject,
+									shouldSkipValueForKey,
+									shouldSkipValueForKeyNotInKeyTable,
+									shouldDecodeBase64ValueForKey,
+									foundKey,
+									foundString,
+									foundStringBytes,
+									foundData,
+									foundNumber,
+									foundInteger,
+									foundUnsignedInteger,
+									foundFloat,
+									foundBool,
+									foundNULL,
+									foundError;
+};
+
+/*
+	decodes base64 the way the parser decodes a value the delegate asked for with jsonParser:shouldDecodeBase64ValueForKey:,
+	returns a retained NSData or nil if the bytes are not base64
+ */
+NSData * NDJSONCreateDataFromBase64Bytes( const uint8_t * bytes, NSUInteger length );
+
+/*
+	fills in methods for the delegate, a nil delegate gets all NULL
+ */
+void NDJSONGetDelegateMethods( struct NDJSONDelegateMethods * methods, NSObject * delegate );
@@ -0,0 +1,55 @@
+/*
+	NDJSONPipelinedParser.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "NDJSONParser.h"
+
+/**
+	NDJSONPipelinedParser splits parsing over two threads, the JSON is scanned by another NDJSONParser on a second thread while the delegate is sent the events on the thread parseWithOptions: was called on. The scanning thread writes each event as a compact record into a fixed size ring, which the delegate thread reads from, neither thread takes a lock unless it has to wait because the ring is full or empty, so the scanner can not get ahead by more than the capacity of the ring and the delegate never waits on a scanner that has already produced records. Given to -[NDJSONDeserializer objectForJSON:options:error:] the cost of creating objects overlaps the cost of scanning so a single large document uses two cores.
+
+	The scanning thread can not ask the delegate whether to skip a value, values for keys in skippedKeys are skipped by the scanner without being parsed. jsonParser:shouldSkipValueForKey: is still sent to the delegate and the records of values it skips are dropped before they reach the delegate. Likewise the scanner does not know which values are for NSData properties so base64 strings are reported as strings.
+
+	The delegate must not use the scanning parser while parseWithOptions: is running. jsonParserDidEndDocument: is sent even when parsing fails or is aborted, as it is by NDJSONParser. If the delegate throws an exception the scanning thread is stopped and the records left in the ring are released before the exception is passed on.
+ */
+@interface NDJSONPipelinedParser : NDJSONParser
+
+/**
+	initialize with the parser that scans the JSON, with a ring of 4096 records.
+ */
+- (id)initWithJSONParser:(NDJSONParser *)parser;
+/**
+	initialize with the parser that scans the JSON and the number of records the ring holds, rounded up to a power of two of at least 64.
+ */
+- (id)initWithJSONParser:(NDJSONParser *)parser capacity:(NSUInteger)capacity;
+
+@property(readonly,nonatomic)	NDJSONParser	* scanningParser;
+@property(readonly,nonatomic)	NSUInteger		capacity;
+/**
+	keys whose values are skipped by the scanning thread at any depth, the delegate is not sent the key or the value.
+ */
+@property(copy,nonatomic)		NSSet			* skippedKeys;
+
+@end
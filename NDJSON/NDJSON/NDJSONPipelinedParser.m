@@ -0,0 +1,550 @@
+/*
+	NDJSONPipelinedParser.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import "NDJSONPipelinedParser.h"
+#import "NDJSONParserPrivate.h"
+
+/*
+	The ring is a single producer single consumer queue, the scanning thread only writes head and the delegate thread only
+	writes tail, each on its own cache line. Both positions only increase, a record is at position&mask. Positions are
+	published every kNDJSONPipelineBatch records rather than for every record so the two threads are not continually
+	pulling the cache lines back and forth, a thread that finds the ring full or empty publishes its own position first
+	so the other thread can always make progress.
+
+	A thread that has to wait spins for a while and then sets its waiting flag and sleeps on its semaphore, the other
+	thread signals the semaphore if the flag is set after it publishes a new position.
+ */
+
+enum { kNDJSONPipelineDefaultCapacity = 4096, kNDJSONPipelineMinimumCapacity = 64, kNDJSONPipelineBatch = 32, kNDJSONPipelineSpinCount = 1024 };
+
+enum NDJSONPipelineTag
+{
+	kNDJSONPipelineArrayStart = '[',
+	kNDJSONPipelineArrayEnd = ']',
+	kNDJSONPipelineObjectStart = '{',
+	kNDJSONPipelineObjectEnd = '}',
+	kNDJSONPipelineKey = 'k',
+	kNDJSONPipelineString = 's',
+	kNDJSONPipelineInteger = 'i',
+	kNDJSONPipelineFloat = 'd',
+	kNDJSONPipelineBool = 'b',
+	kNDJSONPipelineNull = 'n',
+	kNDJSONPipelineError = 'e',
+	kNDJSONPipelineEnd = 'x'					// last record, integer is the result of parsing
+};
+
+struct NDJSONPipelineRecord
+{
+	enum NDJSONPipelineTag		tag;
+	union
+	{
+		NSInteger					integer;
+		double						real;
+		id							object;		// retained by the scanning thread and released by the delegate thread
+	}							value;
+};
+
+struct NDJSONPipelineRing
+{
+	struct NDJSONPipelineRecord	* records;
+	NSUInteger					mask;
+	dispatch_semaphore_t		spaceAvailable,
+								recordsAvailable;
+	NSUInteger					head __attribute__((aligned(64)));
+	NSUInteger					producerWaiting;
+	NSUInteger					tail __attribute__((aligned(64)));
+	NSUInteger					consumerWaiting;
+	BOOL						abandoned __attribute__((aligned(64)));		// the delegate thread has aborted parsing
+};
+
+static void NDJSONPipelinePublish( NSUInteger * aPosition, NSUInteger aValue, NSUInteger * aWaiting, dispatch_semaphore_t aSemaphore )
+{
+	__atomic_store_n( aPosition, aValue, __ATOMIC_SEQ_CST );
+	if( __atomic_load_n( aWaiting, __ATOMIC_SEQ_CST ) != 0 && __atomic_exchange_n( aWaiting, 0, __ATOMIC_SEQ_CST ) != 0 )
+		dispatch_semaphore_signal( aSemaphore );
+}
+
+/*
+	waits until the other thread publishes a position other than aValue, returns the new position
+ */
+static NSUInteger NDJSONPipelineWait( NSUInteger * aPosition, NSUInteger aValue, NSUInteger * aWaiting, dispatch_semaphore_t aSemaphore )
+{
+	NSUInteger		theResult = aValue;
+	for( NSUInteger i = 0; i < kNDJSONPipelineSpinCount && theResult == aValue; i++ )
+		theResult = __atomic_load_n( aPosition, __ATOMIC_ACQUIRE );
+	if( theResult == aValue )
+	{
+		__atomic_store_n( aWaiting, 1, __ATOMIC_SEQ_CST );
+		if( (theResult = __atomic_load_n( aPosition, __ATOMIC_SEQ_CST )) == aValue )
+		{
+			dispatch_semaphore_wait( aSemaphore, DISPATCH_TIME_FOREVER );
+			theResult = __atomic_load_n( aPosition, __ATOMIC_ACQUIRE );
+		}
+		else if( __atomic_exchange_n( aWaiting, 0, __ATOMIC_SEQ_CST ) == 0 )
+			dispatch_semaphore_wait( aSemaphore, DISPATCH_TIME_FOREVER );		// the other thread has already signalled, take it so it does not wake a later wait
+	}
+	return theResult;
+}
+
+#pragma mark - NDJSONPipelineWriter
+
+/*
+	writes the events of the scanning parser into the ring
+ */
+@interface NDJSONPipelineWriter : NSObject <NDJSONParserDelegate>
+{
+@package
+	struct NDJSONPipelineRing	* _ring;
+	NDJSONParser				* _parser;
+	NSSet						* _skippedKeys;
+	NSUInteger					_head,
+								_publishedHead,
+								_tail;					// last tail read, the ring may have more space
+}
+
+- (id)initWithRing:(struct NDJSONPipelineRing *)ring parser:(NDJSONParser *)parser skippedKeys:(NSSet *)skippedKeys;
+
+@end
+
+@implementation NDJSONPipelineWriter
+
+- (id)initWithRing:(struct NDJSONPipelineRing *)aRing parser:(NDJSONParser *)aParser skippedKeys:(NSSet *)aSkippedKeys
+{
+	if( (self = [super init]) != nil )
+	{
+		_ring = aRing;
+		_parser = aParser;
+		_skippedKeys = [aSkippedKeys retain];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[_skippedKeys release];
+	[super dealloc];
+}
+
+static void NDJSONPipelineWriterPublish( NDJSONPipelineWriter * self )
+{
+	if( self->_head != self->_publishedHead )
+	{
+		NDJSONPipelinePublish( &self->_ring->head, self->_head, &self->_ring->consumerWaiting, self->_ring->recordsAvailable );
+		self->_publishedHead = self->_head;
+	}
+}
+
+static void NDJSONPipelineWriterAppend( NDJSONPipelineWriter * self, enum NDJSONPipelineTag aTag, id anObject, NSInteger anInteger, double aReal )
+{
+	struct NDJSONPipelineRing	* theRing = self->_ring;
+	struct NDJSONPipelineRecord	* theRecord = NULL;
+	if( __atomic_load_n( &theRing->abandoned, __ATOMIC_RELAXED ) && aTag != kNDJSONPipelineEnd )
+	{
+		[self->_parser abortParsing];
+		return;
+	}
+	while( self->_head - self->_tail > theRing->mask )
+	{
+		self->_tail = __atomic_load_n( &theRing->tail, __ATOMIC_ACQUIRE );
+		if( self->_head - self->_tail > theRing->mask )
+		{
+			NDJSONPipelineWriterPublish( self );
+			self->_tail = NDJSONPipelineWait( &theRing->tail, self->_tail, &theRing->producerWaiting, theRing->spaceAvailable );
+		}
+	}
+	theRecord = &theRing->records[self->_head&theRing->mask];
+	theRecord->tag = aTag;
+	if( anObject != nil )
+		theRecord->value.object = [anObject retain];
+	else if( aTag == kNDJSONPipelineFloat )
+		theRecord->value.real = aReal;
+	else
+		theRecord->value.integer = anInteger;
+	self->_head++;
+	if( self->_head-self->_publishedHead >= kNDJSONPipelineBatch || aTag == kNDJSONPipelineEnd )
+		NDJSONPipelineWriterPublish( self );
+}
+
+#pragma mark - NDJSONParserDelegate methods
+
+- (void)jsonParserDidStartArray:(NDJSONParser *)aJSON { NDJSONPipelineWriterAppend( self, kNDJSONPipelineArrayStart, nil, 0, 0.0 ); }
+- (void)jsonParserDidEndArray:(NDJSONParser *)aJSON { NDJSONPipelineWriterAppend( self, kNDJSONPipelineArrayEnd, nil, 0, 0.0 ); }
+- (void)jsonParserDidStartObject:(NDJSONParser *)aJSON { NDJSONPipelineWriterAppend( self, kNDJSONPipelineObjectStart, nil, 0, 0.0 ); }
+- (void)jsonParserDidEndObject:(NDJSONParser *)aJSON { NDJSONPipelineWriterAppend( self, kNDJSONPipelineObjectEnd, nil, 0, 0.0 ); }
+/*
+	the key is only written once it is known the value is not skipped
+ */
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldSkipValueForKey:(NSString *)aKey
+{
+	BOOL		theResult = _skippedKeys != nil && [_skippedKeys containsObject:aKey];
+	if( !theResult )
+		NDJSONPipelineWriterAppend( self, kNDJSONPipelineKey, aKey, 0, 0.0 );
+	return theResult;
+}
+- (void)jsonParser:(NDJSONParser *)aJSON foundString:(NSString *)aValue { NDJSONPipelineWriterAppend( self, kNDJSONPipelineString, aValue, 0, 0.0 ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundInteger:(NSInteger)aValue { NDJSONPipelineWriterAppend( self, kNDJSONPipelineInteger, nil, aValue, 0.0 ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundFloat:(double)aValue { NDJSONPipelineWriterAppend( self, kNDJSONPipelineFloat, nil, 0, aValue ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundBool:(BOOL)aValue { NDJSONPipelineWriterAppend( self, kNDJSONPipelineBool, nil, aValue, 0.0 ); }
+- (void)jsonParserFoundNULL:(NDJSONParser *)aJSON { NDJSONPipelineWriterAppend( self, kNDJSONPipelineNull, nil, 0, 0.0 ); }
+- (void)jsonParser:(NDJSONParser *)aJSON error:(NSError *)anError { NDJSONPipelineWriterAppend( self, kNDJSONPipelineError, anError, 0, 0.0 ); }
+
+@end
+
+#pragma mark - NDJSONPipelinedParser
+
+@interface NDJSONPipelinedParser ()
+{
+	NDJSONParser					* _scanningParser;
+	NSSet							* _skippedKeys;
+	struct NDJSONPipelineRing		_ring;
+	NSUInteger						_pipelineTail,
+									_pipelinePublishedTail,
+									_pipelineHead;				// last head read, the ring may have more records
+	NSString						* _pipelineCurrentKey;
+	id								_pipelineRecordObject;		// object of the record being replayed, released if the delegate throws
+	NSUInteger						_pipelineCurrentKeyIndex;
+	NDJSONKeyTable					* _pipelineCurrentKeyTable;
+	BOOL							_pipelineAbort;
+	struct
+	{
+		NSUInteger						size,
+										count;
+		NDJSONKeyTable					** bytes;				// key table of each open object, nil for arrays
+	}								_keyTables;
+	struct NDJSONDelegateMethods	_delegateMethod;
+}
+
+- (void)setUpPipelineRespondsTo;
+
+@end
+
+@implementation NDJSONPipelinedParser
+
+@synthesize		scanningParser = _scanningParser,
+				skippedKeys = _skippedKeys;
+
+- (NSUInteger)capacity { return _ring.mask+1; }
+- (NSString *)currentKey { return _pipelineCurrentKey; }
+- (NSUInteger)currentKeyIndex { return _pipelineCurrentKeyIndex; }
+- (NDJSONKeyTable *)currentKeyTable { return _pipelineCurrentKeyTable; }
+
+#pragma mark - creation and destruction
+
+- (id)initWithJSONParser:(NDJSONParser *)aParser
+{
+	return [self initWithJSONParser:aParser capacity:kNDJSONPipelineDefaultCapacity];
+}
+
+- (id)initWithJSONParser:(NDJSONParser *)aParser capacity:(NSUInteger)aCapacity
+{
+	NSParameterAssert( aParser != nil );
+	if( (self = [super init]) != nil )
+	{
+		NSUInteger		theCapacity = kNDJSONPipelineMinimumCapacity;
+		while( theCapacity < aCapacity )
+			theCapacity <<= 1;
+		_ring.records = malloc( theCapacity*sizeof(struct NDJSONPipelineRecord) );
+		if( _ring.records == NULL )
+		{
+			[self release];
+			return nil;
+		}
+		_ring.mask = theCapacity-1;
+		_ring.spaceAvailable = dispatch_semaphore_create( 0 );
+		_ring.recordsAvailable = dispatch_semaphore_create( 0 );
+		_scanningParser = [aParser retain];
+		_pipelineCurrentKeyIndex = NSNotFound;
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[_scanningParser release];
+	[_skippedKeys release];
+	[_pipelineCurrentKey release];
+	free( _ring.records );
+	if( _ring.spaceAvailable != NULL )
+		dispatch_release( _ring.spaceAvailable );
+	if( _ring.recordsAvailable != NULL )
+		dispatch_release( _ring.recordsAvailable );
+	free( _keyTables.bytes );
+	[super dealloc];
+}
+
+#pragma mark - replaying
+
+static struct NDJSONPipelineRecord NDJSONPipelineNextRecord( NDJSONPipelinedParser * self )
+{
+	struct NDJSONPipelineRing	* theRing = &self->_ring;
+	struct NDJSONPipelineRecord	theResult;
+	while( self->_pipelineTail == self->_pipelineHead )
+	{
+		self->_pipelineHead = __atomic_load_n( &theRing->head, __ATOMIC_ACQUIRE );
+		if( self->_pipelineTail == self->_pipelineHead )
+		{
+			if( self->_pipelineTail != self->_pipelinePublishedTail )
+			{
+				NDJSONPipelinePublish( &theRing->tail, self->_pipelineTail, &theRing->producerWaiting, theRing->spaceAvailable );
+				self->_pipelinePublishedTail = self->_pipelineTail;
+			}
+			self->_pipelineHead = NDJSONPipelineWait( &theRing->head, self->_pipelineHead, &theRing->consumerWaiting, theRing->recordsAvailable );
+		}
+	}
+	theResult = theRing->records[self->_pipelineTail&theRing->mask];
+	self->_pipelineTail++;
+	if( self->_pipelineTail-self->_pipelinePublishedTail >= kNDJSONPipelineBatch )
+	{
+		NDJSONPipelinePublish( &theRing->tail, self->_pipelineTail, &theRing->producerWaiting, theRing->spaceAvailable );
+		self->_pipelinePublishedTail = self->_pipelineTail;
+	}
+	return theResult;
+}
+
+static BOOL NDJSONPipelineRecordHasObject( enum NDJSONPipelineTag aTag )
+{
+	return aTag == kNDJSONPipelineKey || aTag == kNDJSONPipelineString || aTag == kNDJSONPipelineError;
+}
+
+static void NDJSONPipelinePushKeyTable( NDJSONPipelinedParser * self, NDJSONKeyTable * aKeyTable )
+{
+	if( self->_keyTables.count >= self->_keyTables.size )
+	{
+		self->_keyTables.size = self->_keyTables.size > 0 ? self->_keyTables.size*2 : 64;
+		self->_keyTables.bytes = realloc( self->_keyTables.bytes, self->_keyTables.size*sizeof(NDJSONKeyTable*) );
+		NSCAssert( self->_keyTables.bytes != NULL, @"Memory failure" );
+	}
+	self->_keyTables.bytes[self->_keyTables.count++] = aKeyTable;
+}
+
+static void NDJSONPipelineSetCurrentKey( NDJSONPipelinedParser * self, NSString * aKey, NSUInteger anIndex, NDJSONKeyTable * aKeyTable )
+{
+	if( aKey != self->_pipelineCurrentKey )
+	{
+		[self->_pipelineCurrentKey release];
+		self->_pipelineCurrentKey = [aKey retain];
+	}
+	self->_pipelineCurrentKeyIndex = anIndex;
+	self->_pipelineCurrentKeyTable = aKeyTable;
+}
+
+/*
+	reads records until the end record, every record is read even after the delegate aborts so the scanning thread is
+	never left waiting for space and every object is released, if the delegate throws parseWithOptions: calls this again
+	with _pipelineAbort set to drain the ring
+ */
+static BOOL NDJSONPipelineReplay( NDJSONPipelinedParser * self )
+{
+	BOOL				theResult = NO,
+						theEnd = NO,
+						theSkipValue = NO;
+	NSUInteger			theSkipDepth = 0,
+						theBatchRemaining = 0;
+	id					theDelegate = nil;
+	while( !theEnd )
+	{
+		struct NDJSONPipelineRecord	theRecord = NDJSONPipelineNextRecord( self );
+		if( NDJSONPipelineRecordHasObject( theRecord.tag ) )
+			self->_pipelineRecordObject = theRecord.value.object;
+		if( theBatchRemaining-- == 0 )				// the delegate property is read once a batch instead of for every event
+		{
+			theDelegate = self.delegate;
+			theBatchRemaining = kNDJSONPipelineBatch-1;
+		}
+		if( theRecord.tag == kNDJSONPipelineEnd )
+		{
+			theResult = theRecord.value.integer != 0;
+			theEnd = YES;
+		}
+		else if( self->_pipelineAbort || ((theSkipValue || theSkipDepth > 0) && theRecord.tag != kNDJSONPipelineError) )
+		{
+			if( theRecord.tag == kNDJSONPipelineArrayStart || theRecord.tag == kNDJSONPipelineObjectStart )
+				theSkipDepth++;
+			else if( (theRecord.tag == kNDJSONPipelineArrayEnd || theRecord.tag == kNDJSONPipelineObjectEnd) && theSkipDepth > 0 )
+				theSkipDepth--;
+			theSkipValue = NO;
+		}
+		else switch( theRecord.tag )
+		{
+		case kNDJSONPipelineArrayStart:
+			NDJSONPipelinePushKeyTable( self, nil );
+			if( self->_delegateMethod.didStartArray != NULL )
+				((NDVoidMethodIMP)self->_delegateMethod.didStartArray)( theDelegate, @selector(jsonParserDidStartArray:), self );
+			break;
+		case kNDJSONPipelineArrayEnd:
+			if( self->_keyTables.count > 0 )
+				self->_keyTables.count--;
+			if( self->_delegateMethod.didEndArray != NULL )
+				((NDVoidMethodIMP)self->_delegateMethod.didEndArray)( theDelegate, @selector(jsonParserDidEndArray:), self );
+			break;
+		case kNDJSONPipelineObjectStart:
+		{
+			NDJSONKeyTable		* theKeyTable = nil;
+			if( self->_delegateMethod.didStartObject != NULL )
+				((NDVoidMethodIMP)self->_delegateMethod.didStartObject)( theDelegate, @selector(jsonParserDidStartObject:), self );
+			if( self->_delegateMethod.keyTableForCurrentObject != NULL )
+				theKeyTable = ((NDKeyTableMethodIMP)self->_delegateMethod.keyTableForCurrentObject)( theDelegate, @selector(jsonParserKeyTableForCurrentObject:), self );
+			NDJSONPipelinePushKeyTable( self, theKeyTable );
+			break;
+		}
+		case kNDJSONPipelineObjectEnd:
+			if( self->_keyTables.count > 0 )
+				self->_keyTables.count--;
+			if( self->_delegateMethod.didEndObject != NULL )
+				((NDVoidMethodIMP)self->_delegateMethod.didEndObject)( theDelegate, @selector(jsonParserDidEndObject:), self );
+			break;
+		case kNDJSONPipelineKey:
+		{
+			NDJSONKeyTable		* theKeyTable = self->_keyTables.count > 0 ? self->_keyTables.bytes[self->_keyTables.count-1] : nil;
+			NSUInteger			theKeyIndex = NSNotFound;
+			if( theKeyTable != nil )
+			{
+				const char		* theBytes = [theRecord.value.object UTF8String];
+				theKeyIndex = [theKeyTable indexForKeyBytes:(const uint8_t *)theBytes length:strlen(theBytes)];
+			}
+			if( theKeyIndex != NSNotFound )
+				NDJSONPipelineSetCurrentKey( self, [theKeyTable keyAtIndex:theKeyIndex], theKeyIndex, theKeyTable );
+			else
+				NDJSONPipelineSetCurrentKey( self, theRecord.value.object, NSNotFound, theKeyTable );
+			if( self->_delegateMethod.foundKey != NULL )
+				((NDObjectMethodIMP)self->_delegateMethod.foundKey)( theDelegate, @selector(jsonParser:foundKey:), self, self->_pipelineCurrentKey );
+			if( self->_delegateMethod.shouldSkipValueForKey != NULL )
+				theSkipValue = ((NDReturnBoolMethodIMP)self->_delegateMethod.shouldSkipValueForKey)( theDelegate, @selector(jsonParser:shouldSkipValueForKey:), self, self->_pipelineCurrentKey );
+			break;
+		}
+		case kNDJSONPipelineString:
+			if( self->_delegateMethod.foundString != NULL )
+				((NDObjectMethodIMP)self->_delegateMethod.foundString)( theDelegate, @selector(jsonParser:foundString:), self, theRecord.value.object );
+			break;
+		case kNDJSONPipelineInteger:
+			if( self->_delegateMethod.foundNumber != NULL )
+				((NDObjectMethodIMP)self->_delegateMethod.foundNumber)( theDelegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithInteger:theRecord.value.integer] );
+			else if( self->_delegateMethod.foundInteger != NULL )
+				((NDIntegerMethodIMP)self->_delegateMethod.foundInteger)( theDelegate, @selector(jsonParser:foundInteger:), self, theRecord.value.integer );
+			break;
+		case kNDJSONPipelineFloat:
+			if( self->_delegateMethod.foundNumber != NULL )
+				((NDObjectMethodIMP)self->_delegateMethod.foundNumber)( theDelegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithDouble:theRecord.value.real] );
+			else if( self->_delegateMethod.foundFloat != NULL )
+				((NDFloatMethodIMP)self->_delegateMethod.foundFloat)( theDelegate, @selector(jsonParser:foundFloat:), self, theRecord.value.real );
+			break;
+		case kNDJSONPipelineBool:
+			if( self->_delegateMethod.foundNumber != NULL )
+				((NDObjectMethodIMP)self->_delegateMethod.foundNumber)( theDelegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithBool:theRecord.value.integer != 0] );
+			else if( self->_delegateMethod.foundBool != NULL )
+				((NDBoolMethodIMP)self->_delegateMethod.foundBool)( theDelegate, @selector(jsonParser:foundBool:), self, theRecord.value.integer != 0 );
+			break;
+		case kNDJSONPipelineNull:
+			if( self->_delegateMethod.foundNULL != NULL )
+				((NDVoidMethodIMP)self->_delegateMethod.foundNULL)( theDelegate, @selector(jsonParserFoundNULL:), self );
+			break;
+		case kNDJSONPipelineError:
+			if( self->_delegateMethod.foundError != NULL )
+				((NDObjectMethodIMP)self->_delegateMethod.foundError)( theDelegate, @selector(jsonParser:error:), self, theRecord.value.object );
+			break;
+		case kNDJSONPipelineEnd:
+			break;
+		}
+		if( NDJSONPipelineRecordHasObject( theRecord.tag ) )
+		{
+			self->_pipelineRecordObject = nil;
+			[theRecord.value.object release];
+		}
+	}
+	return theResult;
+}
+
+- (BOOL)parseWithOptions:(NDJSONOptionFlags)anOptions
+{
+	BOOL					theResult = NO,
+							theReplayed = NO;
+	NDJSONParser			* theScanningParser = _scanningParser;
+	id						theOriginalDelegate = theScanningParser.delegate;
+	NDJSONParseStatistics	* theOriginalStatistics = theScanningParser.statistics;
+	NDJSONPipelineWriter	* theWriter = [[NDJSONPipelineWriter alloc] initWithRing:&_ring parser:theScanningParser skippedKeys:_skippedKeys];
+	dispatch_group_t		theScanning = dispatch_group_create();
+
+	[self setUpPipelineRespondsTo];
+	_ring.head = _ring.tail = 0;
+	_ring.producerWaiting = _ring.consumerWaiting = 0;
+	_ring.abandoned = NO;
+	_pipelineTail = _pipelinePublishedTail = _pipelineHead = 0;
+	_pipelineAbort = NO;
+	_keyTables.count = 0;
+	theScanningParser.delegate = theWriter;
+	if( self.statistics != nil )
+		theScanningParser.statistics = self.statistics;
+
+	dispatch_group_async( theScanning, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+		@autoreleasepool
+		{
+			BOOL		theScanned = [theScanningParser parseWithOptions:anOptions];
+			NDJSONPipelineWriterAppend( theWriter, kNDJSONPipelineEnd, nil, theScanned, 0.0 );
+		}
+	});
+
+	@try
+	{
+		if( _delegateMethod.didStartDocument != NULL )
+			((NDVoidMethodIMP)_delegateMethod.didStartDocument)( self.delegate, @selector(jsonParserDidStartDocument:), self );
+		theResult = NDJSONPipelineReplay( self ) && !_pipelineAbort;
+		theReplayed = YES;
+		if( _delegateMethod.didEndDocument != NULL )
+			((NDVoidMethodIMP)_delegateMethod.didEndDocument)( self.delegate, @selector(jsonParserDidEndDocument:), self );
+	}
+	@finally
+	{
+		if( !theReplayed )			// the delegate threw, stop the scanning thread and release what is left in the ring
+		{
+			[_pipelineRecordObject release];
+			_pipelineRecordObject = nil;
+			_pipelineAbort = YES;
+			__atomic_store_n( &_ring.abandoned, YES, __ATOMIC_RELAXED );
+			NDJSONPipelineReplay( self );
+		}
+		dispatch_group_wait( theScanning, DISPATCH_TIME_FOREVER );
+		dispatch_release( theScanning );
+		theScanningParser.delegate = theOriginalDelegate;
+		theScanningParser.statistics = theOriginalStatistics;
+		[theWriter release];
+		NDJSONPipelineSetCurrentKey( self, nil, NSNotFound, nil );
+	}
+	return theResult;
+}
+
+- (void)abortParsing
+{
+	_pipelineAbort = YES;
+	__atomic_store_n( &_ring.abandoned, YES, __ATOMIC_RELAXED );
+	[super abortParsing];
+}
+
+- (void)setUpPipelineRespondsTo
+{
+	NDJSONGetDelegateMethods( &_delegateMethod, self.delegate );
+}
+
+@end
@@ -0,0 +1,80 @@
+/*
+	NDJSONQuery.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "NDJSONParser.h"
+
+/**
+	Aggregates computed over the records of a JSON Lines file, or the elements of a JSON file whose root value is an array, a root value that is not an array is a single record. Queries are compiled from a string such as
+
+		count(*), sum(/items/*/price), distinct(/customer/id) where /items/*/currency == "EUR"
+
+	The aggregate functions are count, sum, min, max, avg and distinct, each applied to a path within the records, count(*) counts the records. A path is a JSON Pointer (RFC 6901) where the component * matches every element of an array or member of an object, a component can also be given as a quoted string. count and distinct ignore nulls, sum, min, max and avg only use numbers. distinct is estimated with a HyperLogLog sketch, it is exact for a few distinct values and within about 1% for many.
+
+	The optional where clause is one or more comparisons joined with and, of the values on a path with a string, number, true, false or null, using ==, !=, <, <=, > or >=. A comparison is true if any value on its path satisfies it. Comparisons apply to the part of the record their path shares with the path of the aggregate, in the example above the price of each item is only added if the currency of the same item is "EUR", whereas a comparison of /currency would apply to the whole record.
+
+	Queries are immutable and can be shared between evaluators and threads.
+ */
+@interface NDJSONQuery : NSObject
+
++ (NDJSONQuery *)queryWithString:(NSString *)string error:(NSError **)error;
+/**
+	compile a query, returns nil with an error in NDJSONErrorDomain if string is not a valid query.
+ */
+- (id)initWithString:(NSString *)string error:(NSError **)error;
+
+@property(readonly,nonatomic)	NSString		* string;
+/**
+	number of aggregates, and so results
+ */
+@property(readonly,nonatomic)	NSUInteger		count;
+
+/**
+	evaluate the query with a new NDJSONQueryEvaluator.
+ */
+- (NSArray *)resultsForJSONParser:(NDJSONParser *)parser options:(NDJSONOptionFlags)options error:(NSError **)error;
+
+@end
+
+/**
+	NDJSONQueryEvaluator evaluates an NDJSONQuery in a single pass, as the delegate of an NDJSONParser, without creating objects for the records. Every value that is not on a path of the query is skipped without being parsed, and the memory used does not depend on the size of the input.
+ */
+@interface NDJSONQueryEvaluator : NSObject <NDJSONParserDelegate>
+
+- (id)initWithQuery:(NDJSONQuery *)query;
+
+@property(readonly,nonatomic)	NDJSONQuery		* query;
+/**
+	the result of each aggregate for the last document parsed, a number, or NSNull for the min, max or avg of no values.
+ */
+@property(readonly,nonatomic)	NSArray			* results;
+
+/**
+	parse the input of parser with the given options and return the results.
+ */
+- (NSArray *)resultsForJSONParser:(NDJSONParser *)parser options:(NDJSONOptionFlags)options error:(NSError **)error;
+
+@end
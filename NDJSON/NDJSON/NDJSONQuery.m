@@ -0,0 +1,1162 @@
+/*
+	NDJSONQuery.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import "NDJSONQuery.h"
+#import "NDJSONQueryPrivate.h"
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+
+/*
+	Every path of a query, the aggregates followed by the conditions, is a slot. As the records are parsed each open
+	container keeps a mask of the slots whose path matches it, so a key is only compared with the paths that can still
+	match and values that match none are skipped.
+ */
+
+static const NSUInteger		kMaximumSlotCount = 64;
+static const unsigned int	kDistinctRegisterBits = 14;
+
+enum NDJSONQueryFunction
+{
+	NDJSONQueryFunctionCount,
+	NDJSONQueryFunctionSum,
+	NDJSONQueryFunctionMin,
+	NDJSONQueryFunctionMax,
+	NDJSONQueryFunctionAvg,
+	NDJSONQueryFunctionDistinct
+};
+
+static NSString * const		kFunctionNames[] = { @"count", @"sum", @"min", @"max", @"avg", @"distinct" };
+
+/*
+	what the path of the same index is for
+ */
+struct NDJSONQuerySlot
+{
+	BOOL						isCondition;
+	NSUInteger					owner;					// index of the aggregate or condition
+};
+
+struct NDJSONQueryAggregate
+{
+	enum NDJSONQueryFunction	function;
+	NSUInteger					slot,
+								scopeLength;			// depth of the part of the record the conditions apply to, NSNotFound if there are none
+};
+
+struct NDJSONQueryCondition
+{
+	NSUInteger					slot;
+	struct NDJSONQueryPredicate	predicate;
+};
+
+static NSError * NDJSONQueryError( NSString * aDescription )
+{
+	return [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONBadFormatError userInfo:[NSDictionary dictionaryWithObject:aDescription forKey:NSLocalizedDescriptionKey]];
+}
+
+#pragma mark - NDJSONQuery
+
+@interface NDJSONQuery ()
+{
+@public
+	NSString						* _string;
+	struct NDJSONQueryPath			* _paths;
+	struct NDJSONQuerySlot			* _slots;
+	NSUInteger						_slotCount;
+	struct NDJSONQueryAggregate		* _aggregates;
+	NSUInteger						_aggregateCount;
+	struct NDJSONQueryCondition		* _conditions;
+	NSUInteger						_conditionCount;
+}
+@end
+
+/*
+	recursive descent over the characters of the query string
+ */
+struct NDJSONQueryScanner
+{
+	const unichar		* characters;
+	NSUInteger			length,
+						position;
+	NSString			* error;
+};
+
+/*
+	the characters of aString are copied into a buffer that is freed with NDJSONQueryScannerFree
+ */
+static void NDJSONQueryScannerInit( struct NDJSONQueryScanner * aScanner, NSString * aString )
+{
+	unichar		* theCharacters = malloc( (aString.length+1)*sizeof(unichar) );
+	[aString getCharacters:theCharacters range:NSMakeRange(0, aString.length)];
+	aScanner->characters = theCharacters;
+	aScanner->length = aString.length;
+	aScanner->position = 0;
+	aScanner->error = nil;
+}
+
+static void NDJSONQueryScannerFree( struct NDJSONQueryScanner * aScanner ) { free( (unichar *)aScanner->characters ); }
+
+static unichar NDJSONQueryPeek( struct NDJSONQueryScanner * aScanner )
+{
+	while( aScanner->position < aScanner->length && (aScanner->characters[aScanner->position] == ' ' || aScanner->characters[aScanner->position] == '\t' || aScanner->characters[aScanner->position] == '\n' || aScanner->characters[aScanner->position] == '\r') )
+		aScanner->position++;
+	return aScanner->position < aScanner->length ? aScanner->characters[aScanner->position] : 0;
+}
+
+static BOOL NDJSONQueryFail( struct NDJSONQueryScanner * aScanner, NSString * aDescription )
+{
+	if( aScanner->error == nil )
+		aScanner->error = [NSString stringWithFormat:@"%@ at %lu", aDescription, (unsigned long)aScanner->position];
+	return NO;
+}
+
+static BOOL NDJSONQueryScanCharacter( struct NDJSONQueryScanner * aScanner, unichar aCharacter )
+{
+	if( NDJSONQueryPeek( aScanner ) != aCharacter )
+		return NO;
+	aScanner->position++;
+	return YES;
+}
+
+static BOOL NDJSONQueryExpectCharacter( struct NDJSONQueryScanner * aScanner, unichar aCharacter )
+{
+	return NDJSONQueryScanCharacter( aScanner, aCharacter ) || NDJSONQueryFail( aScanner, [NSString stringWithFormat:@"expected '%C'", aCharacter] );
+}
+
+static NSString * NDJSONQueryScanWord( struct NDJSONQueryScanner * aScanner )
+{
+	unichar			theCharacter = NDJSONQueryPeek( aScanner );
+	NSUInteger		theStart = aScanner->position;
+	while( (theCharacter >= 'a' && theCharacter <= 'z') || (theCharacter >= 'A' && theCharacter <= 'Z') )
+	{
+		aScanner->position++;
+		theCharacter = aScanner->position < aScanner->length ? aScanner->characters[aScanner->position] : 0;
+	}
+	return aScanner->position > theStart ? [[NSString stringWithCharacters:aScanner->characters+theStart length:aScanner->position-theStart] lowercaseString] : nil;
+}
+
+/*
+	the word is only consumed if it is aKeyword
+ */
+static BOOL NDJSONQueryScanKeyword( struct NDJSONQueryScanner * aScanner, NSString * aKeyword )
+{
+	NSUInteger		theStart = aScanner->position;
+	if( [NDJSONQueryScanWord( aScanner ) isEqualToString:aKeyword] )
+		return YES;
+	aScanner->position = theStart;
+	return NO;
+}
+
+static NSString * NDJSONQueryScanQuotedString( struct NDJSONQueryScanner * aScanner )
+{
+	NSMutableString		* theResult = [NSMutableString string];
+	if( !NDJSONQueryExpectCharacter( aScanner, '"' ) )
+		return nil;
+	while( aScanner->position < aScanner->length && aScanner->characters[aScanner->position] != '"' )
+	{
+		unichar		theCharacter = aScanner->characters[aScanner->position++];
+		if( theCharacter == '\\' && aScanner->position < aScanner->length )
+		{
+			theCharacter = aScanner->characters[aScanner->position++];
+			if( theCharacter == 'n' )
+				theCharacter = '\n';
+			else if( theCharacter == 't' )
+				theCharacter = '\t';
+			else if( theCharacter == 'r' )
+				theCharacter = '\r';
+		}
+		[theResult appendFormat:@"%C", theCharacter];
+	}
+	if( !NDJSONQueryExpectCharacter( aScanner, '"' ) )
+		return nil;
+	return theResult;
+}
+
+/*
+	a JSON Pointer with * components, returns nil for a malformed path
+ */
+static NSArray * NDJSONQueryScanPath( struct NDJSONQueryScanner * aScanner )
+{
+	NSMutableArray		* theResult = [NSMutableArray array];
+	if( NDJSONQueryPeek( aScanner ) != '/' )
+	{
+		NDJSONQueryFail( aScanner, @"expected a path" );
+		return nil;
+	}
+	while( aScanner->position < aScanner->length && aScanner->characters[aScanner->position] == '/' )
+	{
+		aScanner->position++;
+		if( aScanner->position < aScanner->length && aScanner->characters[aScanner->position] == '"' )
+		{
+			NSString	* theComponent = NDJSONQueryScanQuotedString( aScanner );
+			if( theComponent == nil )
+				return nil;
+			[theResult addObject:theComponent];
+		}
+		else
+		{
+			NSMutableString		* theComponent = [NSMutableString string];
+			while( aScanner->position < aScanner->length )
+			{
+				unichar		theCharacter = aScanner->characters[aScanner->position];
+				if( theCharacter == '/' || theCharacter == ' ' || theCharacter == '\t' || theCharacter == '\n' || theCharacter == '\r' || theCharacter == ')' || theCharacter == ','
+					|| theCharacter == '=' || theCharacter == '!' || theCharacter == '<' || theCharacter == '>' )
+				{
+					break;
+				}
+				if( theCharacter == '~' && aScanner->position+1 < aScanner->length && (aScanner->characters[aScanner->position+1] == '0' || aScanner->characters[aScanner->position+1] == '1') )
+				{
+					theCharacter = aScanner->characters[aScanner->position+1] == '0' ? '~' : '/';
+					aScanner->position++;
+				}
+				[theComponent appendFormat:@"%C", theCharacter];
+				aScanner->position++;
+			}
+			if( [theComponent isEqualToString:@"*"] )
+				[theResult addObject:[NSNull null]];
+			else
+				[theResult addObject:theComponent];
+		}
+	}
+	return theResult;
+}
+
+static BOOL NDJSONQueryScanLiteral( struct NDJSONQueryScanner * aScanner, struct NDJSONQueryValue * aValue )
+{
+	unichar		theCharacter = NDJSONQueryPeek( aScanner );
+	memset( aValue, 0, sizeof(*aValue) );
+	if( theCharacter == '"' )
+	{
+		aValue->type = NDJSONQueryValueString;
+		aValue->string = [NDJSONQueryScanQuotedString( aScanner ) retain];
+		return aValue->string != nil;
+	}
+	else if( theCharacter == '-' || (theCharacter >= '0' && theCharacter <= '9') )
+	{
+		char		theNumber[64];
+		NSUInteger	theLength = 0;
+		BOOL		theIsFloat = NO;
+		while( aScanner->position < aScanner->length && theLength < sizeof(theNumber)-1 )
+		{
+			theCharacter = aScanner->characters[aScanner->position];
+			if( theCharacter == '.' || theCharacter == 'e' || theCharacter == 'E' )
+				theIsFloat = YES;
+			else if( !(theCharacter >= '0' && theCharacter <= '9') && theCharacter != '-' && theCharacter != '+' )
+				break;
+			theNumber[theLength++] = (char)theCharacter;
+			aScanner->position++;
+		}
+		theNumber[theLength] = '\0';
+		errno = 0;
+		if( !theIsFloat )
+		{
+			aValue->type = NDJSONQueryValueInteger;
+			aValue->integer = strtoll( theNumber, NULL, 10 );
+		}
+		if( theIsFloat || errno == ERANGE )
+		{
+			aValue->type = NDJSONQueryValueFloat;
+			aValue->real = strtod( theNumber, NULL );
+		}
+		return YES;
+	}
+	else
+	{
+		NSString	* theWord = NDJSONQueryScanWord( aScanner );
+		if( [theWord isEqualToString:@"true"] || [theWord isEqualToString:@"false"] )
+		{
+			aValue->type = NDJSONQueryValueBool;
+			aValue->boolean = [theWord isEqualToString:@"true"];
+			return YES;
+		}
+		else if( [theWord isEqualToString:@"null"] )
+		{
+			aValue->type = NDJSONQueryValueNull;
+			return YES;
+		}
+	}
+	return NDJSONQueryFail( aScanner, @"expected a string, number, true, false or null" );
+}
+
+static BOOL NDJSONQueryScanOperator( struct NDJSONQueryScanner * aScanner, enum NDJSONQueryOperator * anOperator )
+{
+	unichar		theCharacter = NDJSONQueryPeek( aScanner );
+	if( theCharacter == '=' || theCharacter == '!' || theCharacter == '<' || theCharacter == '>' )
+	{
+		BOOL	theOrEqual = NO;
+		aScanner->position++;
+		theOrEqual = aScanner->position < aScanner->length && aScanner->characters[aScanner->position] == '=';
+		if( theOrEqual )
+			aScanner->position++;
+		switch( theCharacter )
+		{
+		case '=':
+			*anOperator = NDJSONQueryOperatorEqual;
+			return theOrEqual || NDJSONQueryFail( aScanner, @"expected '=='" );
+		case '!':
+			*anOperator = NDJSONQueryOperatorNotEqual;
+			return theOrEqual || NDJSONQueryFail( aScanner, @"expected '!='" );
+		case '<':
+			*anOperator = theOrEqual ? NDJSONQueryOperatorLessOrEqual : NDJSONQueryOperatorLess;
+			return YES;
+		default:
+			*anOperator = theOrEqual ? NDJSONQueryOperatorGreaterOrEqual : NDJSONQueryOperatorGreater;
+			return YES;
+		}
+	}
+	return NDJSONQueryFail( aScanner, @"expected a comparison" );
+}
+
+#pragma mark - paths and predicates
+
+static void NDJSONQueryInitPath( struct NDJSONQueryPath * aPath, NSArray * aComponents )
+{
+	aPath->length = aComponents.count;
+	aPath->components = [aComponents copy];
+	aPath->keys = calloc( aPath->length+1, sizeof(NSString*) );
+	aPath->indexes = calloc( aPath->length+1, sizeof(NSUInteger) );
+	for( NSUInteger i = 0; i < aPath->length; i++ )
+	{
+		id			theComponent = [aPath->components objectAtIndex:i];
+		NSUInteger	theIndex = NSNotFound;
+		if( theComponent != [NSNull null] )
+		{
+			NSUInteger	theLength = [theComponent length];
+			aPath->keys[i] = theComponent;
+			if( theLength > 0 && theLength < 19 && ([theComponent characterAtIndex:0] != '0' || theLength == 1) && [theComponent rangeOfCharacterFromSet:[[NSCharacterSet decimalDigitCharacterSet] invertedSet]].location == NSNotFound )
+				theIndex = (NSUInteger)[theComponent longLongValue];
+		}
+		aPath->indexes[i] = theIndex;
+	}
+}
+
+void NDJSONQueryReleasePath( struct NDJSONQueryPath * aPath )
+{
+	[aPath->components release], aPath->components = nil;
+	free( aPath->keys ), aPath->keys = NULL;
+	free( aPath->indexes ), aPath->indexes = NULL;
+	aPath->length = 0;
+}
+
+void NDJSONQueryReleasePredicate( struct NDJSONQueryPredicate * aPredicate ) { [aPredicate->value.string release], aPredicate->value.string = nil; }
+
+BOOL NDJSONQueryCompilePath( struct NDJSONQueryPath * aPath, NSString * aString, NSUInteger * anEnd, NSString ** anError )
+{
+	struct NDJSONQueryScanner	theScanner;
+	NSArray						* theComponents = nil;
+	NDJSONQueryScannerInit( &theScanner, aString );
+	if( (theComponents = NDJSONQueryScanPath( &theScanner )) != nil )
+	{
+		NDJSONQueryInitPath( aPath, theComponents );
+		if( anEnd != NULL )
+			*anEnd = theScanner.position;
+	}
+	else if( anError != NULL )
+		*anError = theScanner.error;
+	NDJSONQueryScannerFree( &theScanner );
+	return theComponents != nil;
+}
+
+BOOL NDJSONQueryCompilePredicate( struct NDJSONQueryPath * aPath, struct NDJSONQueryPredicate * aPredicate, NSString * aString, NSString ** anError )
+{
+	struct NDJSONQueryScanner	theScanner;
+	NSArray						* theComponents = nil;
+	BOOL						theResult = NO;
+	NDJSONQueryScannerInit( &theScanner, aString );
+	memset( aPredicate, 0, sizeof(*aPredicate) );
+	if( (theComponents = NDJSONQueryScanPath( &theScanner )) != nil && NDJSONQueryScanOperator( &theScanner, &aPredicate->comparison ) && NDJSONQueryScanLiteral( &theScanner, &aPredicate->value ) )
+		theResult = NDJSONQueryPeek( &theScanner ) == 0 || NDJSONQueryFail( &theScanner, @"expected the end of the comparison" );
+	if( theResult )
+		NDJSONQueryInitPath( aPath, theComponents );
+	else
+	{
+		NDJSONQueryReleasePredicate( aPredicate );
+		if( anError != NULL )
+			*anError = theScanner.error;
+	}
+	NDJSONQueryScannerFree( &theScanner );
+	return theResult;
+}
+
+uint64_t NDJSONQueryChildMask( const struct NDJSONQueryPath * aPaths, uint64_t aMask, NSUInteger aDepth, NSString * aKey, NSUInteger anIndex )
+{
+	uint64_t		theResult = 0;
+	for( uint64_t theBits = aMask; theBits != 0; theBits &= theBits-1 )
+	{
+		unsigned int					i = (unsigned int)__builtin_ctzll( theBits );
+		const struct NDJSONQueryPath	* thePath = &aPaths[i];
+		if( thePath->length > aDepth && (thePath->keys[aDepth] == nil || (aKey != nil ? [aKey isEqualToString:thePath->keys[aDepth]] : thePath->indexes[aDepth] == anIndex)) )
+			theResult |= 1ULL<<i;
+	}
+	return theResult;
+}
+
+uint64_t NDJSONQueryEndMask( const struct NDJSONQueryPath * aPaths, uint64_t aMask, NSUInteger aLength )
+{
+	uint64_t		theResult = 0;
+	for( uint64_t theBits = aMask; theBits != 0; theBits &= theBits-1 )
+	{
+		unsigned int	i = (unsigned int)__builtin_ctzll( theBits );
+		if( aPaths[i].length == aLength )
+			theResult |= 1ULL<<i;
+	}
+	return theResult;
+}
+
+@implementation NDJSONQuery
+
+@synthesize		string = _string;
+
+- (NSUInteger)count { return _aggregateCount; }
+
+#pragma mark - creation and destruction
+
++ (NDJSONQuery *)queryWithString:(NSString *)aString error:(NSError **)anError
+{
+	return [[[self alloc] initWithString:aString error:anError] autorelease];
+}
+
+static NSUInteger NDJSONQueryAddSlot( NDJSONQuery * self, NSArray * aComponents, BOOL anIsCondition, NSUInteger anOwner, struct NDJSONQueryScanner * aScanner )
+{
+	if( self->_slotCount >= kMaximumSlotCount )
+	{
+		NDJSONQueryFail( aScanner, [NSString stringWithFormat:@"more than %lu paths", (unsigned long)kMaximumSlotCount] );
+		return NSNotFound;
+	}
+	NDJSONQueryInitPath( &self->_paths[self->_slotCount], aComponents );
+	self->_slots[self->_slotCount].isCondition = anIsCondition;
+	self->_slots[self->_slotCount].owner = anOwner;
+	return self->_slotCount++;
+}
+
+/*
+	number of leading components two paths have in common
+ */
+static NSUInteger NDJSONQueryCommonLength( const struct NDJSONQueryPath * aPathA, const struct NDJSONQueryPath * aPathB )
+{
+	NSUInteger		theResult = 0;
+	while( theResult < aPathA->length && theResult < aPathB->length && [[aPathA->components objectAtIndex:theResult] isEqual:[aPathB->components objectAtIndex:theResult]] )
+		theResult++;
+	return theResult;
+}
+
+static BOOL NDJSONQueryParse( NDJSONQuery * self, struct NDJSONQueryScanner * aScanner )
+{
+	do
+	{
+		NSString					* theName = NDJSONQueryScanWord( aScanner );
+		enum NDJSONQueryFunction	theFunction = NDJSONQueryFunctionCount;
+		NSArray						* thePath = nil;
+		NSUInteger					theSlot = NSNotFound;
+		BOOL						theFound = NO;
+
+		for( NSUInteger i = 0; i < sizeof(kFunctionNames)/sizeof(*kFunctionNames) && !theFound; i++ )
+		{
+			if( [theName isEqualToString:kFunctionNames[i]] )
+			{
+				theFunction = (enum NDJSONQueryFunction)i;
+				theFound = YES;
+			}
+		}
+		if( !theFound )
+			return NDJSONQueryFail( aScanner, theName != nil ? [NSString stringWithFormat:@"unknown function '%@'", theName] : @"expected a function" );
+		if( !NDJSONQueryExpectCharacter( aScanner, '(' ) )
+			return NO;
+		if( theFunction == NDJSONQueryFunctionCount && NDJSONQueryScanCharacter( aScanner, '*' ) )
+			thePath = [NSArray array];
+		else if( (thePath = NDJSONQueryScanPath( aScanner )) == nil )
+			return NO;
+		if( !NDJSONQueryExpectCharacter( aScanner, ')' ) )
+			return NO;
+		if( (theSlot = NDJSONQueryAddSlot( self, thePath, NO, self->_aggregateCount, aScanner )) == NSNotFound )
+			return NO;
+		self->_aggregates = realloc( self->_aggregates, (self->_aggregateCount+1)*sizeof(*self->_aggregates) );
+		self->_aggregates[self->_aggregateCount].function = theFunction;
+		self->_aggregates[self->_aggregateCount].slot = theSlot;
+		self->_aggregates[self->_aggregateCount].scopeLength = NSNotFound;
+		self->_aggregateCount++;
+	}
+	while( NDJSONQueryScanCharacter( aScanner, ',' ) );
+
+	if( NDJSONQueryPeek( aScanner ) != 0 )
+	{
+		if( !NDJSONQueryScanKeyword( aScanner, @"where" ) )
+			return NDJSONQueryFail( aScanner, @"expected ',' or where" );
+		do
+		{
+			struct NDJSONQueryCondition		theCondition;
+			NSArray							* thePath = NDJSONQueryScanPath( aScanner );
+			memset( &theCondition, 0, sizeof(theCondition) );
+			if( thePath == nil || !NDJSONQueryScanOperator( aScanner, &theCondition.predicate.comparison ) || !NDJSONQueryScanLiteral( aScanner, &theCondition.predicate.value ) )
+			{
+				NDJSONQueryReleasePredicate( &theCondition.predicate );
+				return NO;
+			}
+			if( (theCondition.slot = NDJSONQueryAddSlot( self, thePath, YES, self->_conditionCount, aScanner )) == NSNotFound )
+			{
+				NDJSONQueryReleasePredicate( &theCondition.predicate );
+				return NO;
+			}
+			self->_conditions = realloc( self->_conditions, (self->_conditionCount+1)*sizeof(*self->_conditions) );
+			self->_conditions[self->_conditionCount++] = theCondition;
+		}
+		while( NDJSONQueryScanKeyword( aScanner, @"and" ) );
+		if( NDJSONQueryPeek( aScanner ) != 0 )
+			return NDJSONQueryFail( aScanner, @"expected and or the end of the query" );
+	}
+
+	for( NSUInteger i = 0; i < self->_aggregateCount; i++ )
+	{
+		for( NSUInteger j = 0; j < self->_conditionCount; j++ )
+		{
+			NSUInteger		theLength = NDJSONQueryCommonLength( &self->_paths[self->_aggregates[i].slot], &self->_paths[self->_conditions[j].slot] );
+			if( self->_aggregates[i].scopeLength == NSNotFound || theLength < self->_aggregates[i].scopeLength )
+				self->_aggregates[i].scopeLength = theLength;
+		}
+	}
+	return YES;
+}
+
+- (id)initWithString:(NSString *)aString error:(NSError **)anError
+{
+	if( (self = [super init]) != nil )
+	{
+		struct NDJSONQueryScanner	theScanner;
+		BOOL						theSuccess = NO;
+
+		NDJSONQueryScannerInit( &theScanner, aString );
+		_string = [aString copy];
+		_paths = calloc( kMaximumSlotCount, sizeof(*_paths) );
+		_slots = calloc( kMaximumSlotCount, sizeof(*_slots) );
+		theSuccess = NDJSONQueryParse( self, &theScanner );
+		NDJSONQueryScannerFree( &theScanner );
+		if( !theSuccess )
+		{
+			if( anError != NULL )
+				*anError = NDJSONQueryError( [NSString stringWithFormat:@"invalid query, %@", theScanner.error] );
+			[self release];
+			return nil;
+		}
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	for( NSUInteger i = 0; i < _slotCount; i++ )
+		NDJSONQueryReleasePath( &_paths[i] );
+	for( NSUInteger i = 0; i < _conditionCount; i++ )
+		NDJSONQueryReleasePredicate( &_conditions[i].predicate );
+	free( _paths );
+	free( _slots );
+	free( _aggregates );
+	free( _conditions );
+	[_string release];
+	[super dealloc];
+}
+
+- (NSArray *)resultsForJSONParser:(NDJSONParser *)aParser options:(NDJSONOptionFlags)anOptions error:(NSError **)anError
+{
+	NDJSONQueryEvaluator	* theEvaluator = [[NDJSONQueryEvaluator alloc] initWithQuery:self];
+	NSArray					* theResult = [[theEvaluator resultsForJSONParser:aParser options:anOptions error:anError] retain];
+	[theEvaluator release];
+	return [theResult autorelease];
+}
+
+#pragma mark - NSObject overridden methods
+
+- (NSString *)description { return [NSString stringWithFormat:@"%@ %@", [super description], _string]; }
+
+@end
+
+#pragma mark - NDJSONQueryEvaluator
+
+/*
+	a value given to an aggregate, strings are reduced to their hash for distinct
+ */
+struct NDJSONQueryItem
+{
+	enum NDJSONQueryValueType	type;
+	long long					integer;
+	double						real;
+	uint64_t					hash;
+};
+
+struct NDJSONQueryAccumulator
+{
+	unsigned long long			count;
+	long long					integerSum;
+	double						realSum;
+	BOOL						isReal;
+	struct NDJSONQueryItem		best;
+	uint8_t						* registers;			// HyperLogLog registers for distinct
+	BOOL						active;					// within the part of the record the conditions apply to
+	uint64_t					conditionsMet;
+	struct NDJSONQueryItem		* pending;				// values waiting for the conditions
+	NSUInteger					pendingCount,
+								pendingSize;
+};
+
+struct NDJSONQueryLevel
+{
+	uint64_t					mask;
+	NSUInteger					index;
+	BOOL						isArray;
+};
+
+@interface NDJSONQueryEvaluator ()
+{
+	NDJSONQuery						* _query;
+	NSArray							* _results;
+	NSError							* _error;
+	struct NDJSONQueryAccumulator	* _accumulators;
+	struct NDJSONQueryLevel			* _levels;
+	NSUInteger						_levelCount,
+									_levelSize;
+	uint64_t						_allSlots,
+									_allConditions,
+									_keyMask;
+	BOOL							_inRootArray,
+									_sawRoot;
+}
+@end
+
+@implementation NDJSONQueryEvaluator
+
+@synthesize		query = _query,
+				results = _results;
+
+#pragma mark - creation and destruction
+
+- (id)initWithQuery:(NDJSONQuery *)aQuery
+{
+	NSParameterAssert( aQuery != nil );
+	if( (self = [super init]) != nil )
+	{
+		_query = [aQuery retain];
+		_accumulators = calloc( aQuery->_aggregateCount, sizeof(*_accumulators) );
+		for( NSUInteger i = 0; i < aQuery->_aggregateCount; i++ )
+		{
+			if( aQuery->_aggregates[i].function == NDJSONQueryFunctionDistinct )
+				_accumulators[i].registers = calloc( 1<<kDistinctRegisterBits, sizeof(uint8_t) );
+		}
+		_allSlots = aQuery->_slotCount < 64 ? (1ULL<<aQuery->_slotCount)-1 : ~0ULL;
+		_allConditions = aQuery->_conditionCount < 64 ? (1ULL<<aQuery->_conditionCount)-1 : ~0ULL;
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	for( NSUInteger i = 0; i < _query->_aggregateCount; i++ )
+	{
+		free( _accumulators[i].registers );
+		free( _accumulators[i].pending );
+	}
+	free( _accumulators );
+	free( _levels );
+	[_query release];
+	[_results release];
+	[_error release];
+	[super dealloc];
+}
+
+- (NSArray *)resultsForJSONParser:(NDJSONParser *)aParser options:(NDJSONOptionFlags)anOptions error:(NSError **)anError
+{
+	NSArray		* theResult = nil;
+	id			theOriginalDelegate = aParser.delegate;
+	aParser.delegate = self;
+	if( [aParser parseWithOptions:anOptions] && _error == nil )
+		theResult = _results;
+	else if( anError != NULL )
+		*anError = _error != nil ? [[_error retain] autorelease] : NDJSONQueryError( @"JSON could not be parsed" );
+	aParser.delegate = theOriginalDelegate;
+	return theResult;
+}
+
+#pragma mark - aggregates
+
+/*
+	64 bit FNV-1a followed by the splitmix64 finalizer so every bit of the hash depends on every byte
+ */
+static uint64_t NDJSONQueryHashBytes( uint64_t aSeed, const void * aBytes, NSUInteger aLength )
+{
+	uint64_t		theResult = 0xcbf29ce484222325ULL ^ aSeed;
+	for( NSUInteger i = 0; i < aLength; i++ )
+		theResult = (theResult ^ ((const uint8_t *)aBytes)[i]) * 0x100000001b3ULL;
+	theResult ^= theResult >> 30;
+	theResult *= 0xbf58476d1ce4e5b9ULL;
+	theResult ^= theResult >> 27;
+	theResult *= 0x94d049bb133111ebULL;
+	theResult ^= theResult >> 31;
+	return theResult;
+}
+
+/*
+	numbers with the same value hash the same whether they were written as integers or floats
+ */
+static uint64_t NDJSONQueryHashValue( const struct NDJSONQueryValue * aValue )
+{
+	uint64_t		theResult = 0;
+	switch( aValue->type )
+	{
+	case NDJSONQueryValueBool:
+		theResult = NDJSONQueryHashBytes( NDJSONQueryValueBool, &aValue->boolean, sizeof(aValue->boolean) );
+		break;
+	case NDJSONQueryValueFloat:
+		if( aValue->real == floor(aValue->real) && fabs(aValue->real) < 9.2e18 )
+		{
+			long long		theInteger = (long long)aValue->real;
+			theResult = NDJSONQueryHashBytes( NDJSONQueryValueInteger, &theInteger, sizeof(theInteger) );
+		}
+		else
+			theResult = NDJSONQueryHashBytes( NDJSONQueryValueFloat, &aValue->real, sizeof(aValue->real) );
+		break;
+	case NDJSONQueryValueInteger:
+		theResult = NDJSONQueryHashBytes( NDJSONQueryValueInteger, &aValue->integer, sizeof(aValue->integer) );
+		break;
+	case NDJSONQueryValueString:
+	{
+		const char		* theBytes = CFStringGetCStringPtr( (CFStringRef)aValue->string, kCFStringEncodingUTF8 );
+		if( theBytes == NULL )
+			theBytes = [aValue->string UTF8String];
+		theResult = NDJSONQueryHashBytes( NDJSONQueryValueString, theBytes, strlen(theBytes) );
+		break;
+	}
+	default:
+		break;
+	}
+	return theResult;
+}
+
+static double NDJSONQueryItemReal( const struct NDJSONQueryItem * anItem ) { return anItem->type == NDJSONQueryValueInteger ? (double)anItem->integer : anItem->real; }
+
+/*
+	the part of a value an aggregate uses, NO if the aggregate ignores values of its type
+ */
+static BOOL NDJSONQueryItemForValue( struct NDJSONQueryItem * anItem, enum NDJSONQueryFunction aFunction, const struct NDJSONQueryValue * aValue, BOOL aCountsNull )
+{
+	anItem->type = aValue->type;
+	anItem->integer = aValue->integer;
+	anItem->real = aValue->real;
+	anItem->hash = 0;
+	switch( aFunction )
+	{
+	case NDJSONQueryFunctionCount:
+		return aCountsNull || aValue->type != NDJSONQueryValueNull;
+	case NDJSONQueryFunctionDistinct:
+		if( aValue->type == NDJSONQueryValueNull || aValue->type == NDJSONQueryValueContainer )
+			return NO;
+		anItem->hash = NDJSONQueryHashValue( aValue );
+		return YES;
+	default:
+		return aValue->type == NDJSONQueryValueInteger || aValue->type == NDJSONQueryValueFloat;
+	}
+}
+
+static void NDJSONQueryAccumulate( struct NDJSONQueryAccumulator * anAccumulator, enum NDJSONQueryFunction aFunction, const struct NDJSONQueryItem * anItem )
+{
+	switch( aFunction )
+	{
+	case NDJSONQueryFunctionCount:
+		anAccumulator->count++;
+		break;
+	case NDJSONQueryFunctionSum:
+	case NDJSONQueryFunctionAvg:
+		if( !anAccumulator->isReal && anItem->type == NDJSONQueryValueInteger
+			&& !((anItem->integer > 0 && anAccumulator->integerSum > LLONG_MAX-anItem->integer) || (anItem->integer < 0 && anAccumulator->integerSum < LLONG_MIN-anItem->integer)) )
+		{
+			anAccumulator->integerSum += anItem->integer;
+		}
+		else
+		{
+			if( !anAccumulator->isReal )
+			{
+				anAccumulator->realSum = (double)anAccumulator->integerSum;
+				anAccumulator->isReal = YES;
+			}
+			anAccumulator->realSum += NDJSONQueryItemReal( anItem );
+		}
+		anAccumulator->count++;
+		break;
+	case NDJSONQueryFunctionMin:
+		if( anAccumulator->count++ == 0 || NDJSONQueryItemReal( anItem ) < NDJSONQueryItemReal( &anAccumulator->best ) )
+			anAccumulator->best = *anItem;
+		break;
+	case NDJSONQueryFunctionMax:
+		if( anAccumulator->count++ == 0 || NDJSONQueryItemReal( anItem ) > NDJSONQueryItemReal( &anAccumulator->best ) )
+			anAccumulator->best = *anItem;
+		break;
+	case NDJSONQueryFunctionDistinct:
+	{
+		NSUInteger		theRegister = (NSUInteger)(anItem->hash >> (64-kDistinctRegisterBits));
+		uint64_t		theRemainder = anItem->hash << kDistinctRegisterBits;
+		uint8_t			theRank = 1;
+		while( theRank <= 64-kDistinctRegisterBits && (theRemainder & (1ULL<<63)) == 0 )
+		{
+			theRemainder <<= 1;
+			theRank++;
+		}
+		if( theRank > anAccumulator->registers[theRegister] )
+			anAccumulator->registers[theRegister] = theRank;
+		break;
+	}
+	}
+}
+
+/*
+	HyperLogLog estimate, with linear counting while registers are still empty
+ */
+static unsigned long long NDJSONQueryDistinctCount( const uint8_t * aRegisters )
+{
+	const NSUInteger	theCount = 1<<kDistinctRegisterBits;
+	double				theSum = 0.0,
+						theEstimate = 0.0;
+	NSUInteger			theEmpty = 0;
+	for( NSUInteger i = 0; i < theCount; i++ )
+	{
+		theSum += ldexp( 1.0, -(int)aRegisters[i] );
+		if( aRegisters[i] == 0 )
+			theEmpty++;
+	}
+	theEstimate = 0.7213/(1.0+1.079/theCount)*theCount*theCount/theSum;
+	if( theEstimate <= 2.5*theCount && theEmpty > 0 )
+		theEstimate = theCount*log( (double)theCount/theEmpty );
+	return (unsigned long long)llround( theEstimate );
+}
+
+static id NDJSONQueryResult( const struct NDJSONQueryAccumulator * anAccumulator, enum NDJSONQueryFunction aFunction )
+{
+	switch( aFunction )
+	{
+	case NDJSONQueryFunctionCount:
+		return [NSNumber numberWithUnsignedLongLong:anAccumulator->count];
+	case NDJSONQueryFunctionSum:
+		return anAccumulator->isReal ? [NSNumber numberWithDouble:anAccumulator->realSum] : [NSNumber numberWithLongLong:anAccumulator->integerSum];
+	case NDJSONQueryFunctionAvg:
+		if( anAccumulator->count == 0 )
+			return [NSNull null];
+		return [NSNumber numberWithDouble:(anAccumulator->isReal ? anAccumulator->realSum : (double)anAccumulator->integerSum)/(double)anAccumulator->count];
+	case NDJSONQueryFunctionMin:
+	case NDJSONQueryFunctionMax:
+		if( anAccumulator->count == 0 )
+			return [NSNull null];
+		return anAccumulator->best.type == NDJSONQueryValueInteger ? [NSNumber numberWithLongLong:anAccumulator->best.integer] : [NSNumber numberWithDouble:anAccumulator->best.real];
+	case NDJSONQueryFunctionDistinct:
+		return [NSNumber numberWithUnsignedLongLong:NDJSONQueryDistinctCount( anAccumulator->registers )];
+	}
+	return [NSNull null];
+}
+
+#pragma mark - conditions
+
+BOOL NDJSONQueryCompare( const struct NDJSONQueryValue * aValue, const struct NDJSONQueryPredicate * aPredicate )
+{
+	const struct NDJSONQueryValue	* theLiteral = &aPredicate->value;
+	NSComparisonResult				theOrder = NSOrderedSame;
+	BOOL							theComparable = YES,
+									theOrdered = YES;
+	BOOL							theIsNumber = aValue->type == NDJSONQueryValueInteger || aValue->type == NDJSONQueryValueFloat,
+									theLiteralIsNumber = theLiteral->type == NDJSONQueryValueInteger || theLiteral->type == NDJSONQueryValueFloat;
+
+	if( theIsNumber && theLiteralIsNumber )
+	{
+		if( aValue->type == NDJSONQueryValueInteger && theLiteral->type == NDJSONQueryValueInteger )
+			theOrder = aValue->integer < theLiteral->integer ? NSOrderedAscending : (aValue->integer > theLiteral->integer ? NSOrderedDescending : NSOrderedSame);
+		else
+		{
+			double	theValue = aValue->type == NDJSONQueryValueInteger ? (double)aValue->integer : aValue->real,
+					theLiteralValue = theLiteral->type == NDJSONQueryValueInteger ? (double)theLiteral->integer : theLiteral->real;
+			theOrder = theValue < theLiteralValue ? NSOrderedAscending : (theValue > theLiteralValue ? NSOrderedDescending : NSOrderedSame);
+		}
+	}
+	else if( aValue->type == NDJSONQueryValueString && theLiteral->type == NDJSONQueryValueString )
+		theOrder = [aValue->string compare:theLiteral->string options:NSLiteralSearch];
+	else if( aValue->type == NDJSONQueryValueBool && theLiteral->type == NDJSONQueryValueBool )
+	{
+		theOrder = aValue->boolean == theLiteral->boolean ? NSOrderedSame : NSOrderedAscending;
+		theOrdered = NO;
+	}
+	else if( aValue->type == NDJSONQueryValueNull && theLiteral->type == NDJSONQueryValueNull )
+		theOrdered = NO;
+	else
+		theComparable = NO;
+
+	switch( aPredicate->comparison )
+	{
+	case NDJSONQueryOperatorEqual:
+		return theComparable && theOrder == NSOrderedSame;
+	case NDJSONQueryOperatorNotEqual:
+		return !theComparable || theOrder != NSOrderedSame;
+	case NDJSONQueryOperatorLess:
+		return theComparable && theOrdered && theOrder == NSOrderedAscending;
+	case NDJSONQueryOperatorLessOrEqual:
+		return theComparable && theOrdered && theOrder != NSOrderedDescending;
+	case NDJSONQueryOperatorGreater:
+		return theComparable && theOrdered && theOrder == NSOrderedDescending;
+	case NDJSONQueryOperatorGreaterOrEqual:
+		return theComparable && theOrdered && theOrder != NSOrderedAscending;
+	}
+	return NO;
+}
+
+#pragma mark - matching
+
+/*
+	the part of the record the conditions of an aggregate apply to starts, or ends, with a value at level
+ */
+static void NDJSONQueryBeginScopes( NDJSONQueryEvaluator * self, NSUInteger aLevel, uint64_t aMask )
+{
+	NDJSONQuery		* theQuery = self->_query;
+	for( NSUInteger i = 0; i < theQuery->_aggregateCount; i++ )
+	{
+		if( theQuery->_aggregates[i].scopeLength == aLevel && (aMask & (1ULL<<theQuery->_aggregates[i].slot)) != 0 )
+		{
+			self->_accumulators[i].active = YES;
+			self->_accumulators[i].conditionsMet = 0;
+			self->_accumulators[i].pendingCount = 0;
+		}
+	}
+}
+
+static void NDJSONQueryEndScopes( NDJSONQueryEvaluator * self, NSUInteger aLevel, uint64_t aMask )
+{
+	NDJSONQuery		* theQuery = self->_query;
+	for( NSUInteger i = 0; i < theQuery->_aggregateCount; i++ )
+	{
+		struct NDJSONQueryAccumulator	* theAccumulator = &self->_accumulators[i];
+		if( theQuery->_aggregates[i].scopeLength == aLevel && (aMask & (1ULL<<theQuery->_aggregates[i].slot)) != 0 && theAccumulator->active )
+		{
+			if( theAccumulator->conditionsMet == self->_allConditions )
+			{
+				for( NSUInteger j = 0; j < theAccumulator->pendingCount; j++ )
+					NDJSONQueryAccumulate( theAccumulator, theQuery->_aggregates[i].function, &theAccumulator->pending[j] );
+			}
+			theAccumulator->pendingCount = 0;
+			theAccumulator->active = NO;
+		}
+	}
+}
+
+/*
+	give a value at level to every slot whose path ends with it
+ */
+static void NDJSONQueryDeliver( NDJSONQueryEvaluator * self, NSUInteger aLevel, uint64_t aMask, const struct NDJSONQueryValue * aValue )
+{
+	NDJSONQuery		* theQuery = self->_query;
+	for( uint64_t theBits = NDJSONQueryEndMask( theQuery->_paths, aMask, aLevel ); theBits != 0; theBits &= theBits-1 )
+	{
+		const struct NDJSONQuerySlot	* theSlot = &theQuery->_slots[__builtin_ctzll( theBits )];
+		if( theSlot->isCondition )
+		{
+			if( NDJSONQueryCompare( aValue, &theQuery->_conditions[theSlot->owner].predicate ) )
+			{
+				for( NSUInteger j = 0; j < theQuery->_aggregateCount; j++ )
+				{
+					if( self->_accumulators[j].active )
+						self->_accumulators[j].conditionsMet |= 1ULL<<theSlot->owner;
+				}
+			}
+		}
+		else
+		{
+			const struct NDJSONQueryAggregate	* theAggregate = &theQuery->_aggregates[theSlot->owner];
+			struct NDJSONQueryAccumulator		* theAccumulator = &self->_accumulators[theSlot->owner];
+			struct NDJSONQueryItem				theItem;
+			if( NDJSONQueryItemForValue( &theItem, theAggregate->function, aValue, aLevel == 0 ) )
+			{
+				if( theAggregate->scopeLength == NSNotFound )
+					NDJSONQueryAccumulate( theAccumulator, theAggregate->function, &theItem );
+				else if( theAccumulator->active )
+				{
+					if( theAccumulator->pendingCount >= theAccumulator->pendingSize )
+					{
+						theAccumulator->pendingSize = theAccumulator->pendingSize > 0 ? theAccumulator->pendingSize*2 : 4;
+						theAccumulator->pending = realloc( theAccumulator->pending, theAccumulator->pendingSize*sizeof(*theAccumulator->pending) );
+					}
+					theAccumulator->pending[theAccumulator->pendingCount++] = theItem;
+				}
+			}
+		}
+	}
+}
+
+/*
+	the slots whose path matches the value starting now, records are at level 0
+ */
+static uint64_t NDJSONQueryMaskForNewValue( NDJSONQueryEvaluator * self )
+{
+	uint64_t		theResult = 0;
+	if( self->_levelCount == 0 )
+		theResult = self->_allSlots;
+	else
+	{
+		struct NDJSONQueryLevel		* theParent = &self->_levels[self->_levelCount-1];
+		if( theParent->isArray )
+			theResult = NDJSONQueryChildMask( self->_query->_paths, theParent->mask, self->_levelCount-1, nil, theParent->index++ );
+		else
+			theResult = self->_keyMask;
+	}
+	return theResult;
+}
+
+static void NDJSONQueryFoundScalar( NDJSONQueryEvaluator * self, const struct NDJSONQueryValue * aValue )
+{
+	NSUInteger		theLevel = self->_levelCount;
+	uint64_t		theMask = 0;
+	if( theLevel == 0 && !self->_inRootArray && self->_sawRoot )
+		return;
+	theMask = NDJSONQueryMaskForNewValue( self );
+	self->_sawRoot = YES;
+	if( theMask != 0 )
+	{
+		NDJSONQueryBeginScopes( self, theLevel, theMask );
+		NDJSONQueryDeliver( self, theLevel, theMask, aValue );
+		NDJSONQueryEndScopes( self, theLevel, theMask );
+	}
+}
+
+static void NDJSONQueryStartContainer( NDJSONQueryEvaluator * self, BOOL anIsArray )
+{
+	NSUInteger		theLevel = self->_levelCount;
+	uint64_t		theMask = 0;
+	if( theLevel == 0 && anIsArray && !self->_sawRoot )
+	{
+		self->_inRootArray = YES;			// records are the elements of the root array
+		self->_sawRoot = YES;
+		return;
+	}
+	theMask = NDJSONQueryMaskForNewValue( self );
+	self->_sawRoot = YES;
+	if( theMask != 0 )
+	{
+		struct NDJSONQueryValue		theValue = { NDJSONQueryValueContainer, NO, 0, 0.0, nil };
+		NDJSONQueryBeginScopes( self, theLevel, theMask );
+		NDJSONQueryDeliver( self, theLevel, theMask, &theValue );
+	}
+	if( self->_levelCount >= self->_levelSize )
+	{
+		self->_levelSize = self->_levelSize > 0 ? self->_levelSize*2 : 16;
+		self->_levels = realloc( self->_levels, self->_levelSize*sizeof(*self->_levels) );
+	}
+	self->_levels[self->_levelCount].mask = theMask;
+	self->_levels[self->_levelCount].index = 0;
+	self->_levels[self->_levelCount].isArray = anIsArray;
+	self->_levelCount++;
+}
+
+static void NDJSONQueryEndContainer( NDJSONQueryEvaluator * self )
+{
+	if( self->_levelCount == 0 )
+		self->_inRootArray = NO;
+	else
+	{
+		uint64_t	theMask = self->_levels[--self->_levelCount].mask;
+		if( theMask != 0 )
+			NDJSONQueryEndScopes( self, self->_levelCount, theMask );
+	}
+}
+
+#pragma mark - NDJSONParserDelegate methods
+
+- (void)jsonParserDidStartDocument:(NDJSONParser *)aJSON
+{
+	NSUInteger		theCount = _query->_aggregateCount;
+	for( NSUInteger i = 0; i < theCount; i++ )
+	{
+		uint8_t		* theRegisters = _accumulators[i].registers;
+		free( _accumulators[i].pending );
+		memset( &_accumulators[i], 0, sizeof(_accumulators[i]) );
+		if( theRegisters != NULL )
+			memset( theRegisters, 0, 1<<kDistinctRegisterBits );
+		_accumulators[i].registers = theRegisters;
+	}
+	_levelCount = 0;
+	_keyMask = 0;
+	_inRootArray = NO;
+	_sawRoot = NO;
+	[_results release], _results = nil;
+	[_error release], _error = nil;
+}
+
+- (void)jsonParserDidEndDocument:(NDJSONParser *)aJSON
+{
+	NSMutableArray		* theResults = [[NSMutableArray alloc] initWithCapacity:_query->_aggregateCount];
+	for( NSUInteger i = 0; i < _query->_aggregateCount; i++ )
+		[theResults addObject:NDJSONQueryResult( &_accumulators[i], _query->_aggregates[i].function )];
+	[_results release], _results = [theResults copy];
+	[theResults release];
+}
+
+- (void)jsonParserDidStartArray:(NDJSONParser *)aJSON { NDJSONQueryStartContainer( self, YES ); }
+- (void)jsonParserDidEndArray:(NDJSONParser *)aJSON { NDJSONQueryEndContainer( self ); }
+- (void)jsonParserDidStartObject:(NDJSONParser *)aJSON { NDJSONQueryStartContainer( self, NO ); }
+- (void)jsonParserDidEndObject:(NDJSONParser *)aJSON { NDJSONQueryEndContainer( self ); }
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundKey:(NSString *)aValue
+{
+	_keyMask = _levelCount > 0 ? NDJSONQueryChildMask( _query->_paths, _levels[_levelCount-1].mask, _levelCount-1, aValue, NSNotFound ) : 0;
+}
+
+/*
+	only values on a path of the query need to be parsed
+ */
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldSkipValueForKey:(NSString *)aKey { return _keyMask == 0; }
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundString:(NSString *)aValue
+{
+	struct NDJSONQueryValue		theValue = { NDJSONQueryValueString, NO, 0, 0.0, aValue };
+	NDJSONQueryFoundScalar( self, &theValue );
+}
+- (void)jsonParser:(NDJSONParser *)aJSON foundInteger:(NSInteger)aValue
+{
+	struct NDJSONQueryValue		theValue = { NDJSONQueryValueInteger, NO, aValue, 0.0, nil };
+	NDJSONQueryFoundScalar( self, &theValue );
+}
+- (void)jsonParser:(NDJSONParser *)aJSON foundFloat:(double)aValue
+{
+	struct NDJSONQueryValue		theValue = { NDJSONQueryValueFloat, NO, 0, aValue, nil };
+	NDJSONQueryFoundScalar( self, &theValue );
+}
+- (void)jsonParser:(NDJSONParser *)aJSON foundBool:(BOOL)aValue
+{
+	struct NDJSONQueryValue		theValue = { NDJSONQueryValueBool, aValue, 0, 0.0, nil };
+	NDJSONQueryFoundScalar( self, &theValue );
+}
+- (void)jsonParserFoundNULL:(NDJSONParser *)aJSON
+{
+	struct NDJSONQueryValue		theValue = { NDJSONQueryValueNull, NO, 0, 0.0, nil };
+	NDJSONQueryFoundScalar( self, &theValue );
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON error:(NSError *)anError
+{
+	if( _error == nil )
+		_error = [anError retain];
+}
+
+@end
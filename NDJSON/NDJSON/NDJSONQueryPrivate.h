@@ -0,0 +1,106 @@
+/*
+	NDJSONQueryPrivate.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "NDJSONQuery.h"
+
+/*
+	Private to NDJSON, the paths and predicates NDJSONQuery compiles, for ndjson-transform to match and compare values
+	exactly as a query does. A path or predicate is compiled from the same syntax as in a query.
+ */
+
+enum NDJSONQueryOperator
+{
+	NDJSONQueryOperatorEqual,
+	NDJSONQueryOperatorNotEqual,
+	NDJSONQueryOperatorLess,
+	NDJSONQueryOperatorLessOrEqual,
+	NDJSONQueryOperatorGreater,
+	NDJSONQueryOperatorGreaterOrEqual
+};
+
+enum NDJSONQueryValueType
+{
+	NDJSONQueryValueNull,
+	NDJSONQueryValueBool,
+	NDJSONQueryValueInteger,
+	NDJSONQueryValueFloat,
+	NDJSONQueryValueString,
+	NDJSONQueryValueContainer
+};
+
+struct NDJSONQueryValue
+{
+	enum NDJSONQueryValueType	type;
+	BOOL						boolean;
+	long long					integer;
+	double						real;
+	NSString					* string;
+};
+
+/*
+	a JSON Pointer in which the component * matches every member of an object or element of an array
+ */
+struct NDJSONQueryPath
+{
+	NSUInteger					length;
+	NSArray						* components;			// NSNull for *
+	NSString					** keys;				// components, nil for *
+	NSUInteger					* indexes;				// array index each component matches, NSNotFound if none
+};
+
+/*
+	the comparison and literal of a condition, integers are compared as integers and with floats as doubles
+ */
+struct NDJSONQueryPredicate
+{
+	enum NDJSONQueryOperator	comparison;
+	struct NDJSONQueryValue		value;
+};
+
+/*
+	compiles the path at the start of aString, anEnd is set to the index of the first character after it, returns NO
+	with a description of the problem in anError if aString does not start with a path
+ */
+BOOL NDJSONQueryCompilePath( struct NDJSONQueryPath * aPath, NSString * aString, NSUInteger * anEnd, NSString ** anError );
+/*
+	compiles a path, comparison and literal, such as /items/0/price >= 10, that make up the whole of aString
+ */
+BOOL NDJSONQueryCompilePredicate( struct NDJSONQueryPath * aPath, struct NDJSONQueryPredicate * aPredicate, NSString * aString, NSString ** anError );
+void NDJSONQueryReleasePath( struct NDJSONQueryPath * aPath );
+void NDJSONQueryReleasePredicate( struct NDJSONQueryPredicate * aPredicate );
+
+BOOL NDJSONQueryCompare( const struct NDJSONQueryValue * aValue, const struct NDJSONQueryPredicate * aPredicate );
+
+/*
+	of the paths in aPaths with a bit set in aMask, the ones the member aKey of an object at aDepth is on, or when aKey is
+	nil the element anIndex of an array at aDepth, records are at depth 0
+ */
+uint64_t NDJSONQueryChildMask( const struct NDJSONQueryPath * aPaths, uint64_t aMask, NSUInteger aDepth, NSString * aKey, NSUInteger anIndex );
+/*
+	of the paths in aPaths with a bit set in aMask, the ones that end at aLength
+ */
+uint64_t NDJSONQueryEndMask( const struct NDJSONQueryPath * aPaths, uint64_t aMask, NSUInteger aLength );
@@ -44,10 +44,16 @@ enum NDJSONHTTPMethod
 extern NSString		* const kNDJSONHTTPMethodStrings[];
 
 @class		NDJSONDeserializer,
-			NDJSONResponse;
+			NDJSONResponse,
+			NDJSONResponseCache,
+			NDJSONRequestScheduler;
 @protocol	NDJSONRequestDelegate;
 
 extern const NSUInteger				kNDJSONDefaultPortNumber;
+/**
+	the most responses parsed at once for requests without a scheduler, and for schedulers created with a maximumConcurrentParses of 0. A response is parsed as it arrives so a parse waiting for data holds one of these until the data comes or the connection ends.
+ */
+extern const NSUInteger				kNDJSONMaximumConcurrentResponseParses;
 
 /**
  NDJSONRequest handles JSON remotes soruces.
@@ -79,7 +85,18 @@ extern const NSUInteger				kNDJSONDefaultPortNumber;
 @property(readonly,nonatomic,strong)	NDJSONDeserializer			* deserializer;
 @property(readonly,nonatomic)			NDJSONOptionFlags			deserializerOptions;
 @property(readonly,nonatomic,weak)	id<NSURLConnectionDelegate>		delegate;
-
+/**
+	Cache used to send GET requests as conditional requests and to return the previous result without parsing on a 304 Not Modified response, the default is nil for no caching.
+ */
+@property(readonly,nonatomic,strong)	NDJSONResponseCache			* responseCache;
+/**
+	Scheduler used to coalesce identical requests and limit the number of connections and parses, the default is nil for the request to be started immediately.
+ */
+@property(readonly,nonatomic,strong)	NDJSONRequestScheduler		* scheduler;
+/**
+	order the request is started in by the scheduler when it has to wait for a connection, the default is NSOperationQueuePriorityNormal.
+ */
+@property(readonly,nonatomic)			NSOperationQueuePriority	priority;
 
 - (id)initWithDeserializer:(NDJSONDeserializer *)deserializer deserializerOptions:(NDJSONOptionFlags)deserializerOptions;
 - (id)initWithDeserializer:(NDJSONDeserializer *)deserializer;
@@ -87,6 +104,9 @@ extern const NSUInteger				kNDJSONDefaultPortNumber;
 - (id)initWithDelegate:(id<NSURLConnectionDelegate>)delegate deserializer:(NDJSONDeserializer *)deserializer deserializerOptions:(NDJSONOptionFlags)deserializerOptions;
 - (id)initWithDelegate:(id<NSURLConnectionDelegate>)delegate deserializer:(NDJSONDeserializer *)deserializer;
 
+/**
+	send the request, the response is parsed as it arrives on a private background queue, that parses no more than kNDJSONMaximumConcurrentResponseParses responses at once, and only the finished NDJSONResponse is delivered on *queue*, or the main queue if nil.
+ */
 - (void)sendAsynchronousWithQueue:(NSOperationQueue *)queue responseCompletionHandler:(void (^)(NDJSONRequest *, NDJSONResponse *))handler;
 - (void)sendAsynchronousWithQueue:(NSOperationQueue *)queue responseHandler:(id<NDJSONRequestDelegate>)handler;
 - (void)sendAsynchronousWithQueue:(NSOperationQueue *)queue responseHandlingSelector:(SEL)responseHandlingSelector handler:(id)handler;
@@ -117,6 +137,9 @@ A subclass of abstract class NDJSONRequest that you can set the values for.
 @property(readwrite,nonatomic,strong)	NSDictionary		* HTTPHeaders;
 
 @property(assign,nonatomic)				NDJSONOptionFlags	deserializerOptions;
+@property(readwrite,nonatomic,strong)	NDJSONResponseCache	* responseCache;
+@property(readwrite,nonatomic,strong)	NDJSONRequestScheduler	* scheduler;
+@property(assign,nonatomic)				NSOperationQueuePriority	priority;
 
 @end
 
@@ -27,8 +27,12 @@
 #import "NDJSONRequest.h"
 #import "NDJSONParser.h"
 #import "NDJSONDeserializer.h"
+#import "NDJSONResponseCache.h"
+#import "NDJSONRequestScheduler.h"
+#import <objc/runtime.h>
 
 const NSUInteger				kNDJSONDefaultPortNumber = NSNotFound;
+const NSUInteger				kNDJSONMaximumConcurrentResponseParses = 4;
 
 static const NSTimeInterval		kNDJSONDefaultTimeoutInterval = 60.0;
 static NSString					* const kNDJSONDefaultScheme = @"http";
@@ -36,6 +40,161 @@ static const NSUInteger			kNDJSONDefaultPort = NSUIntegerMax;			// use NDURLRequ
 
 NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST", @"PUT", @"DELETE", @"TRACE", @"OPTIONS", @"CONNECT", @"PATCH" };				// must match enum NDJSONHTTPMethod
 
+static const NSUInteger			kNDJSONMaximumBufferedResponseLength = 1<<20;		// connection waits for the parser beyond this
+static char						kNDJSONLastParseOperationKey;						// associated with a deserializer
+
+#pragma mark - NDJSONResponseChunks
+/*
+	Bounded queue of received data used to feed the parser on the parse queue as the data arrives on the connection queue.
+ */
+@interface NDJSONResponseChunks : NSObject
+{
+	NSCondition			* __strong _condition;
+	NSMutableArray		* __strong _chunks;
+	NSData				* __strong _currentChunk;
+	NSError				* __strong _error;
+	NSUInteger			_bufferedLength;
+	BOOL				_finished,
+						_closed;
+}
+
+/*
+	returns the number of bytes waiting for the parser
+ */
+- (NSUInteger)appendData:(NSData *)data;
+- (void)finish;
+/*
+	the connection failed, the error is kept for the parser which is the only thing that sets the responses error
+ */
+- (void)finishWithError:(NSError *)error;
+- (void)close;
+- (NSInteger)nextBytes:(uint8_t **)buffer;
+/*
+	the error the connection finished with, or nil
+ */
+@property(readonly)	NSError			* error;
+
+@end
+
+@implementation NDJSONResponseChunks
+
+- (id)init
+{
+	if( (self = [super init]) != nil )
+	{
+		_condition = [[NSCondition alloc] init];
+		_chunks = [[NSMutableArray alloc] init];
+	}
+	return self;
+}
+
+#if !__has_feature(objc_arc)
+- (void)dealloc
+{
+	[_condition release];
+	[_chunks release];
+	[_currentChunk release];
+	[_error release];
+	[super dealloc];
+}
+#endif
+
+- (NSUInteger)appendData:(NSData *)aData
+{
+	NSUInteger		theResult = 0;
+	[_condition lock];
+	while( !_closed && _bufferedLength > kNDJSONMaximumBufferedResponseLength )
+		[_condition wait];
+	if( !_closed )
+	{
+		[_chunks addObject:aData];
+		_bufferedLength += aData.length;
+		[_condition broadcast];
+	}
+	theResult = _bufferedLength;
+	[_condition unlock];
+	return theResult;
+}
+
+- (void)finish
+{
+	[self finishWithError:nil];
+}
+
+- (void)finishWithError:(NSError *)anError
+{
+	[_condition lock];
+	_finished = YES;
+	if( _error == nil )
+	{
+#if __has_feature(objc_arc)
+		_error = anError;
+#else
+		_error = [anError retain];
+#endif
+	}
+	[_condition broadcast];
+	[_condition unlock];
+}
+
+- (NSError *)error
+{
+	NSError		* theResult = nil;
+	[_condition lock];
+#if __has_feature(objc_arc)
+	theResult = _error;
+#else
+	theResult = [[_error retain] autorelease];
+#endif
+	[_condition unlock];
+	return theResult;
+}
+
+/*
+	called once the parser has stopped reading, so the connection never waits on it again
+ */
+- (void)close
+{
+	[_condition lock];
+	_closed = YES;
+	[_chunks removeAllObjects];
+	_bufferedLength = 0;
+	[_condition broadcast];
+	[_condition unlock];
+}
+
+/*
+	the returned bytes belong to the chunk and remain valid until the next call
+ */
+- (NSInteger)nextBytes:(uint8_t **)aBuffer
+{
+	NSInteger		theResult = 0;
+	[_condition lock];
+#if !__has_feature(objc_arc)
+	[_currentChunk release];
+#endif
+	_currentChunk = nil;
+	while( _chunks.count == 0 && !_finished && !_closed )
+		[_condition wait];
+	if( _chunks.count > 0 )
+	{
+#if __has_feature(objc_arc)
+		_currentChunk = [_chunks objectAtIndex:0];
+#else
+		_currentChunk = [[_chunks objectAtIndex:0] retain];
+#endif
+		[_chunks removeObjectAtIndex:0];
+		_bufferedLength -= _currentChunk.length;
+		*aBuffer = (uint8_t*)_currentChunk.bytes;
+		theResult = (NSInteger)_currentChunk.length;
+		[_condition broadcast];
+	}
+	[_condition unlock];
+	return theResult;
+}
+
+@end
+
 #pragma mark - NDJSONRequest
 @interface NDJSONRequest () <NSURLConnectionDataDelegate>
 {
@@ -55,7 +214,19 @@ NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST",
 	NSURLConnection		* __strong _URLConnection;
 	void (__strong ^_responseCompletionHandler)(NDJSONRequest *, NDJSONResponse *);
 	NSInvocation		* __strong _responseInvocation;
-	NSMutableData		* __strong _responseData;
+	NSOperationQueue	* __strong _responseQueue;
+	NSOperationQueue	* __strong _connectionQueue;
+	NDJSONResponseChunks	* __strong _responseChunks;
+	NSUInteger			_responseLength;
+	NSString			* __strong _cacheKey;
+	NSHTTPURLResponse	* __strong _HTTPResponse;
+	NSString			* __strong _bodyPath;
+	NSFileHandle		* __strong _bodyFileHandle;
+	BOOL				_notModified,
+						_parseStarted,
+						_loadFinished,
+						_loadFailed,
+						_parseFinished;
 }
 
 @property(readwrite,nonatomic,strong)				id				result;
@@ -63,11 +234,19 @@ NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST",
 @property(readwrite,nonatomic,strong)			NSURLConnection		* URLConnection;
 @property(copy,nonatomic)	void (^responseCompletionHandler)(NDJSONRequest *, NDJSONResponse *);
 @property(retain,nonatomic)							NSInvocation	* responseInvocation;
-@property(retain,nonatomic,readonly)				NSMutableData	* responseData;
+
++ (NSOperationQueue *)parseQueue;
 
 - (id)initWithRequest:(NDJSONRequest *)request;
 - (void)loadAsynchronousWithQueue:(NSOperationQueue *)queue completionHandler:(void (^)(NDJSONRequest *,NDJSONResponse*))block;
 - (void)loadAsynchronousWithQueue:(NSOperationQueue *)queue invocation:(NSInvocation *)invocation;
+- (void)startConnectionWithResponseQueue:(NSOperationQueue *)queue;
+- (void)addParseOperationWithBlock:(void (^)(void))block;
+- (void)startParsingResponseChunks;
+- (void)parseResponseChunks;
+- (void)parseCachedResponse;
+- (void)storeInResponseCacheIfComplete;
+- (void)finishResponse;
 - (void)returnResponse;
 
 @end
@@ -102,6 +281,12 @@ NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST",
 	}
 
 	[theResult setHTTPMethod:self.HTTPMethodString];
+	if( self.responseCache != nil )
+	{
+		NSString	* theCacheKey = [NDJSONResponseCache cacheKeyForRequest:self URLRequest:theResult];
+		if( theCacheKey != nil )
+			[self.responseCache addValidatorsForKey:theCacheKey toURLRequest:theResult];
+	}
 	return theResult;
 }
 
@@ -195,6 +380,9 @@ NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST",
 	return kNDJSONHTTPMethodStrings[theMethod];
 }
 - (enum NDJSONHTTPMethod)HTTPMethod { return NDJSONHTTPMethodDefault; }
+- (NDJSONResponseCache *)responseCache { return nil; }
+- (NDJSONRequestScheduler *)scheduler { return nil; }
+- (NSOperationQueuePriority)priority { return NSOperationQueuePriorityNormal; }
 
 - (id)initWithDeserializer:(NDJSONDeserializer *)aDeserializer deserializerOptions:(NDJSONOptionFlags)aDeserializerOptions
 {
@@ -285,6 +473,9 @@ NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST",
 	NSString			* __strong _HTTPMethodString;
 	enum NDJSONHTTPMethod		_HTTPMethod;
 	NSDictionary		* __strong _HTTPHeaders;
+	NDJSONResponseCache	* __strong _responseCache;
+	NDJSONRequestScheduler	* __strong _scheduler;
+	NSOperationQueuePriority	_priority;
 }
 
 @end
@@ -304,7 +495,10 @@ NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST",
 				bodyHandler = _bodyHandler,
 				HTTPMethodString = _HTTPMethodString,
 				HTTPMethod = _HTTPMethod,
-				HTTPHeaders = _HTTPHeaders;
+				HTTPHeaders = _HTTPHeaders,
+				responseCache = _responseCache,
+				scheduler = _scheduler,
+				priority = _priority;
 
 - (void)setURL:(NSURL *)aURL
 {
@@ -343,11 +537,21 @@ NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST",
 
 - (BOOL)isSuccessful { return _error != nil; }
 
-- (NSMutableData *)responseData
+/*
+	responses are parsed here, as the data arrives, and not on the queue the response is returned on. A parse blocks its
+	thread while it waits for data, so the queue is limited to kNDJSONMaximumConcurrentResponseParses instead of letting
+	waiting parses take more and more threads from the system
+ */
++ (NSOperationQueue *)parseQueue
 {
-	if( _responseData == nil )
-		_responseData = [[NSMutableData alloc] init];
-	return _responseData;
+	static NSOperationQueue		* kParseQueue = nil;
+	static dispatch_once_t		kOnceToken;
+	dispatch_once(&kOnceToken, ^{
+		kParseQueue = [[NSOperationQueue alloc] init];
+		[kParseQueue setName:@"NDJSONResponse parse queue"];
+		[kParseQueue setMaxConcurrentOperationCount:(NSInteger)kNDJSONMaximumConcurrentResponseParses];
+	});
+	return kParseQueue;
 }
 
 - (id)initWithRequest:(NDJSONRequest *)aRequest
@@ -371,7 +575,13 @@ NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST",
 	[_error release];
 	[_responseCompletionHandler release];
 	[_responseInvocation release];
-	[_responseData release];
+	[_responseQueue release];
+	[_connectionQueue release];
+	[_responseChunks release];
+	[_cacheKey release];
+	[_HTTPResponse release];
+	[_bodyPath release];
+	[_bodyFileHandle release];
 	[super dealloc];
 }
 #endif
@@ -382,14 +592,8 @@ NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST",
 	NSParameterAssert( self.request.URLRequest != nil );
 	NSParameterAssert( aBlock != nil );
 
-	NDJSONRequest		* theRequest = self.request;
 	self.responseCompletionHandler = aBlock;
-	self.URLConnection = [[NSURLConnection alloc] initWithRequest:theRequest.URLRequest delegate:self startImmediately:NO];
-	if( aQueue == nil )
-		[self.URLConnection setDelegateQueue:[NSOperationQueue mainQueue]];
-	else
-		[self.URLConnection setDelegateQueue:aQueue];
-	[self.URLConnection start];
+	[self startConnectionWithResponseQueue:aQueue];
 }
 
 - (void)loadAsynchronousWithQueue:(NSOperationQueue *)aQueue invocation:(NSInvocation *)anInvocation
@@ -402,12 +606,199 @@ NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST",
 	self.responseInvocation = anInvocation;
 	[self.responseInvocation retainArguments];
 	[self.responseInvocation setArgument:(void*)&theRequest atIndex:2];
-	self.URLConnection = [[NSURLConnection alloc] initWithRequest:theRequest.URLRequest delegate:self startImmediately:NO];
-	if( aQueue == nil )
-		[self.URLConnection setDelegateQueue:[NSOperationQueue mainQueue]];
+	[self startConnectionWithResponseQueue:aQueue];
+}
+
+- (void)startConnectionWithResponseQueue:(NSOperationQueue *)aQueue
+{
+#if __has_feature(objc_arc)
+	_responseQueue = aQueue != nil ? aQueue : [NSOperationQueue mainQueue];
+#else
+	_responseQueue = [(aQueue != nil ? aQueue : [NSOperationQueue mainQueue]) retain];
+#endif
+	if( self.request.scheduler != nil )
+		[self.request.scheduler scheduleResponse:self];
+	else
+		[self startConnection];
+}
+
+/*
+	The connection delivers to a private queue, the data is parsed on the parse queue as it arrives and only the finished response is returned on the callers queue. A scheduled response is not parsed until it has finished loading or has buffered as much as the connection is allowed to get ahead of the parser, so slow responses do not hold the schedulers limited parse threads while they wait for the network.
+ */
+- (void)startConnection
+{
+	NSURLRequest		* theURLRequest = self.request.URLRequest;
+	NSURLConnection		* theConnection = [[NSURLConnection alloc] initWithRequest:theURLRequest delegate:self startImmediately:NO];
+	if( self.request.responseCache != nil )
+	{
+#if __has_feature(objc_arc)
+		_cacheKey = [NDJSONResponseCache cacheKeyForRequest:self.request URLRequest:theURLRequest];
+#else
+		_cacheKey = [[NDJSONResponseCache cacheKeyForRequest:self.request URLRequest:theURLRequest] retain];
+#endif
+	}
+	_connectionQueue = [[NSOperationQueue alloc] init];
+	[_connectionQueue setMaxConcurrentOperationCount:1];
+	self.URLConnection = theConnection;
+	[theConnection setDelegateQueue:_connectionQueue];
+#if !__has_feature(objc_arc)
+	[theConnection release];
+#endif
+	[theConnection start];
+}
+
+/*
+	scheduled responses are parsed on the schedulers queue so the number of concurrent parses is limited. A deserializer holds
+	the state of the parse it is doing, so each parse depends on the previous parse with the same deserializer, requests that
+	share a deserializer are parsed one after another while other requests are parsed concurrently
+ */
+- (void)addParseOperationWithBlock:(void (^)(void))aBlock
+{
+	NDJSONRequestScheduler	* theScheduler = self.request.scheduler;
+	NDJSONDeserializer		* theDeserializer = self.request.deserializer;
+	NSBlockOperation		* theOperation = [[NSBlockOperation alloc] init];
+	NSBlockOperation		* __unsafe_unretained theOperationRef = theOperation;		// only compared, the operation is running when it is used
+	[theOperation addExecutionBlock:^{
+		aBlock();
+		@synchronized(theDeserializer)
+		{
+			if( objc_getAssociatedObject( theDeserializer, &kNDJSONLastParseOperationKey ) == theOperationRef )
+				objc_setAssociatedObject( theDeserializer, &kNDJSONLastParseOperationKey, nil, OBJC_ASSOCIATION_RETAIN );
+		}
+	}];
+	@synchronized(theDeserializer)
+	{
+		NSOperation		* thePrevious = objc_getAssociatedObject( theDeserializer, &kNDJSONLastParseOperationKey );
+		if( thePrevious != nil )
+			[theOperation addDependency:thePrevious];
+		objc_setAssociatedObject( theDeserializer, &kNDJSONLastParseOperationKey, theOperation, OBJC_ASSOCIATION_RETAIN );
+	}
+	if( theScheduler != nil )
+	{
+		[theOperation setQueuePriority:self.request.priority];
+		[theScheduler.parseQueue addOperation:theOperation];
+	}
 	else
-		[self.URLConnection setDelegateQueue:aQueue];
-	[self.URLConnection start];
+		[[NDJSONResponse parseQueue] addOperation:theOperation];
+#if !__has_feature(objc_arc)
+	[theOperation release];
+#endif
+}
+
+/*
+	only called from the connection queue
+ */
+- (void)startParsingResponseChunks
+{
+	if( !_parseStarted )
+	{
+		_parseStarted = YES;
+		[self addParseOperationWithBlock:^{ [self parseResponseChunks]; }];
+	}
+}
+
+- (void)parseResponseChunks
+{
+	NDJSONResponseChunks	* theChunks = _responseChunks;
+	NDJSONParser			* theParser = [[NDJSONParser alloc] initWithSourceBlock:^NSInteger(uint8_t ** aBuffer) { return [theChunks nextBytes:aBuffer]; } encoding:NSUTF8StringEncoding];
+	NSError					* theError = nil;
+	id						theResult = [self.request.deserializer objectForJSON:theParser options:self.request.deserializerOptions error:&theError];
+	NSError					* theConnectionError = nil;
+	NSUInteger				theResponseLength = 0;
+
+	[theChunks close];
+	theConnectionError = theChunks.error;
+	@synchronized(self)
+	{
+		theResponseLength = _responseLength;
+	}
+	if( theConnectionError != nil )
+		self.error = theConnectionError;
+	if( theResponseLength > 0 )
+	{
+		self.result = theResult;
+		if( theConnectionError == nil )
+			self.error = theError;
+	}
+	else
+		NSLog( @"NDJSON: Received zero length data" );
+#if !__has_feature(objc_arc)
+	[theParser release];
+#endif
+	@synchronized(self)
+	{
+		_parseFinished = YES;
+		[self storeInResponseCacheIfComplete];
+	}
+
+#ifndef NDJSON_SUPPRESS_ALL_LOGING
+	if( self.result == nil )
+		NSLog( @"Failed to result for URLRequest=%@, error=%@", self.request.URL, self.error );
+	else if( self.error != nil )
+		NSLog( @"NDJSON: Error with result for URLRequest=%@, error=%@", self.request.URL, self.error );
+#endif
+	[self finishResponse];
+}
+
+/*
+	a 304 Not Modified response, the previous result is used if it is still in memory otherwise the body stored on disk is parsed again and the result kept in memory, the stored body is left in place
+ */
+- (void)parseCachedResponse
+{
+	NDJSONResponseCache		* theCache = self.request.responseCache;
+	id						theResult = [theCache resultForKey:_cacheKey];
+	if( theResult == nil )
+	{
+		NSString		* theBodyPath = [theCache bodyPathForKey:_cacheKey];
+		if( theBodyPath != nil )
+		{
+			NDJSONParser	* theParser = [[NDJSONParser alloc] initWithContentsOfFile:theBodyPath encoding:NSUTF8StringEncoding];
+			NSError			* theError = nil;
+			theResult = [self.request.deserializer objectForJSON:theParser options:self.request.deserializerOptions error:&theError];
+			if( theResult != nil && theError == nil )
+				[theCache setResult:theResult forKey:_cacheKey];
+			self.error = theError;
+#if !__has_feature(objc_arc)
+			[theParser release];
+#endif
+		}
+	}
+	self.result = theResult;
+	if( theResult == nil && self.error == nil )
+		self.error = [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorResourceUnavailable userInfo:[NSDictionary dictionaryWithObject:@"Not modified response with no cached result" forKey:NSLocalizedDescriptionKey]];
+	[self finishResponse];
+}
+
+/*
+	the parser can finish before the connection has delivered the whole body to the file, so whichever finishes last stores the result, must be called within @synchronized(self)
+ */
+- (void)storeInResponseCacheIfComplete
+{
+	if( _parseFinished && _loadFinished && _cacheKey != nil )
+	{
+		if( self.result != nil && self.error == nil && !_loadFailed && _HTTPResponse.statusCode == 200 )
+			[self.request.responseCache storeResult:self.result bodyLength:_responseLength bodyPath:_bodyPath HTTPResponse:_HTTPResponse forKey:_cacheKey];
+		else if( _bodyPath != nil )
+			[[NSFileManager defaultManager] removeItemAtPath:_bodyPath error:NULL];
+#if !__has_feature(objc_arc)
+		[_bodyPath release];
+#endif
+		_bodyPath = nil;
+	}
+}
+
+/*
+	responses coalesced with this one by the scheduler get the same result
+ */
+- (void)finishResponse
+{
+	for( NDJSONResponse * theResponse in [self.request.scheduler responseDidFinish:self] )
+	{
+		theResponse.result = self.result;
+		theResponse.error = self.error;
+		[theResponse->_responseQueue addOperationWithBlock:^{ [theResponse returnResponse]; }];
+	}
+	[_responseQueue addOperationWithBlock:^{ [self returnResponse]; }];
 }
 
 - (void)returnResponse
@@ -437,13 +828,53 @@ NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST",
 - (void)connection:(NSURLConnection *)aConnection didReceiveResponse:(NSURLResponse *)aResponse
 {
 	NSParameterAssert( aConnection == self.URLConnection );
-	NSParameterAssert( self.responseData.length == 0 );
+	if( [aResponse isKindOfClass:[NSHTTPURLResponse class]] )
+	{
+#if __has_feature(objc_arc)
+		_HTTPResponse = (NSHTTPURLResponse *)aResponse;
+#else
+		[_HTTPResponse release];
+		_HTTPResponse = (NSHTTPURLResponse *)[aResponse retain];
+#endif
+	}
+	if( _cacheKey != nil && _HTTPResponse.statusCode == 304 )
+		_notModified = YES;
+	else if( _responseChunks == nil )
+	{
+		if( _cacheKey != nil && _HTTPResponse.statusCode == 200 )
+		{
+			NSString	* theBodyPath = [self.request.responseCache temporaryBodyPath];
+			if( theBodyPath != nil && [[NSFileManager defaultManager] createFileAtPath:theBodyPath contents:nil attributes:nil] )
+			{
+#if __has_feature(objc_arc)
+				_bodyPath = theBodyPath;
+				_bodyFileHandle = [NSFileHandle fileHandleForWritingAtPath:theBodyPath];
+#else
+				_bodyPath = [theBodyPath retain];
+				_bodyFileHandle = [[NSFileHandle fileHandleForWritingAtPath:theBodyPath] retain];
+#endif
+			}
+		}
+		_responseChunks = [[NDJSONResponseChunks alloc] init];			// the parse is started once there is data for it
+	}
 }
 
 - (void)connection:(NSURLConnection *)aConnection didReceiveData:(NSData *)aData
 {
 	NSParameterAssert( aConnection == self.URLConnection );
-	[self.responseData appendData:aData];
+	if( !_notModified )
+	{
+		NSUInteger		theBufferedLength = 0;
+		NSParameterAssert( _responseChunks != nil );
+		@synchronized(self)
+		{
+			_responseLength += aData.length;
+		}
+		[_bodyFileHandle writeData:aData];
+		theBufferedLength = [_responseChunks appendData:aData];
+		if( self.request.scheduler == nil || theBufferedLength >= kNDJSONMaximumBufferedResponseLength )
+			[self startParsingResponseChunks];
+	}
 }
 
 //- (NSInputStream *)connection:(NSURLConnection *)aConnection needNewBodyStream:(NSURLRequest *)aRequest
@@ -464,39 +895,50 @@ NSString		* const kNDJSONHTTPMethodStrings[] = { nil, @"GET", @"HEAD", @"POST",
 - (void)connectionDidFinishLoading:(NSURLConnection *)aConnection
 {
 	NSParameterAssert( aConnection == self.URLConnection );
-	if( self.responseData.length > 0 )
+	[self.request.scheduler responseDidFinishLoading:self];
+	if( _notModified )
+		[self addParseOperationWithBlock:^{ [self parseCachedResponse]; }];
+	else
 	{
-		NDJSONParser				* theParser = [[NDJSONParser alloc] initWithJSONData:self.responseData encoding:NSUTF8StringEncoding];
-		NSError					* theError = nil;
-
-		self.result = [self.request.deserializer objectForJSON:theParser options:self.request.deserializerOptions error:&theError];
-		self.error = theError;
-#if !__has_feature(objc_arc)
-		[theParser release];
-#endif
+		[_bodyFileHandle closeFile];
+		@synchronized(self)
+		{
+			_loadFinished = YES;
+			[self storeInResponseCacheIfComplete];
+		}
+		[_responseChunks finish];				// the parser returns the response once it has read everything
+		[self startParsingResponseChunks];
 	}
-	else
-		NSLog( @"NDJSON: Received zero length data" );
-
-#ifndef NDJSON_SUPPRESS_ALL_LOGING
-	if( self.result == nil )
-		NSLog( @"Failed to result for URLRequest=%@, error=%@", self.request.URL, self.error );
-	else if( self.error != nil )
-		NSLog( @"NDJSON: Error with result for URLRequest=%@, error=%@", self.request.URL, self.error );
-#endif
-	[self returnResponse];
 }
 
 #pragma mark - NSURLConnectionDelegate methods
 
+/*
+	once there is a parse the error is handed to it with the chunks, so it is only ever set by the thread returning the response
+ */
 - (void)connection:(NSURLConnection *)aConnection didFailWithError:(NSError *)anError
 {
-	self.error = anError;
 	NSLog( @"NDJSON: Recieved connection error %@", anError );
 	if( [self.request.delegate respondsToSelector:@selector(connection:didFailWithError:)] )
 		[self.request.delegate connection:aConnection didFailWithError:anError];
-	self.error = anError;
-	[self returnResponse];
+	[_bodyFileHandle closeFile];
+	@synchronized(self)
+	{
+		_loadFinished = YES;
+		_loadFailed = YES;
+		[self storeInResponseCacheIfComplete];		// with an error this only removes the partial body
+	}
+	[self.request.scheduler responseDidFinishLoading:self];
+	if( _responseChunks != nil )
+	{
+		[_responseChunks finishWithError:anError];			// parser will see the premature end and return the response
+		[self startParsingResponseChunks];
+	}
+	else
+	{
+		self.error = anError;
+		[self finishResponse];
+	}
 }
 - (BOOL)connectionShouldUseCredentialStorage:(NSURLConnection *)aConnection
 {
@@ -0,0 +1,81 @@
+/*
+	NDJSONRequestScheduler.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class		NDJSONResponse;
+
+/**
+	NDJSONRequestScheduler controls when the connections of the NDJSONRequests that use it are started and parsed.
+
+	Identical GET and HEAD requests, the same method, URL, HTTP headers and deserializer, that are sent while one is already waiting or in flight are coalesced into a single connection and parse and the result is returned to every handler. No more than *maximumConnectionsPerHost* connections are made to a host at once, the rest wait, highest NDJSONRequest priority first, and no more than *maximumConcurrentParses* responses are parsed at once. A connection is given to the next request for the host as soon as it has finished loading, whether or not its response has been parsed, and a scheduled response only starts parsing once it has finished loading or has buffered enough data that it has to be parsed as it arrives.
+
+	Because coalesced requests share the one result object, results of scheduled requests should be treated as immutable.
+ */
+@interface NDJSONRequestScheduler : NSObject
+
+/**
+	shared scheduler allowing 4 connections per host and one parse per processor.
+ */
++ (NDJSONRequestScheduler *)sharedScheduler;
+
+/**
+	a *maximumConcurrentParses* of 0 uses kNDJSONMaximumConcurrentResponseParses, parses wait for their data on the parse threads so they are always limited.
+ */
+- (id)initWithMaximumConnectionsPerHost:(NSUInteger)maximumConnectionsPerHost maximumConcurrentParses:(NSUInteger)maximumConcurrentParses;
+
+@property(readonly,nonatomic)	NSUInteger		maximumConnectionsPerHost;
+@property(readonly,nonatomic)	NSUInteger		maximumConcurrentParses;
+
+@end
+
+/*
+	Private methods used by NDJSONResponse
+ */
+@interface NDJSONRequestScheduler (NDJSONResponse)
+
+@property(readonly,nonatomic)	NSOperationQueue	* parseQueue;
+
+/*
+	the response is either started, queued behind other connections to the same host or coalesced with an identical response
+ */
+- (void)scheduleResponse:(NDJSONResponse *)response;
+/*
+	the connection of the response has finished or failed, its connection is given to the next response waiting for the host
+ */
+- (void)responseDidFinishLoading:(NDJSONResponse *)response;
+/*
+	the response has its result, returns the coalesced responses that should get the same result
+ */
+- (NSArray *)responseDidFinish:(NDJSONResponse *)response;
+
+@end
+
+@interface NDJSONResponse (NDJSONRequestScheduler)
+
+- (void)startConnection;
+
+@end
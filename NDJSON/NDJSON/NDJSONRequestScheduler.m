@@ -0,0 +1,289 @@
+/*
+	NDJSONRequestScheduler.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import "NDJSONRequestScheduler.h"
+#import "NDJSONRequest.h"
+#import "NDJSONResponseCache.h"
+
+static const NSUInteger		kNDJSONDefaultMaximumConnectionsPerHost = 4;
+
+/*
+	a response that has been scheduled together with any responses coalesced with it
+ */
+@interface NDJSONScheduledResponse : NSObject
+{
+@public
+	NDJSONResponse				* __strong response;
+	NSString					* __strong key;
+	NSString					* __strong host;
+	NSMutableArray				* __strong coalescedResponses;
+	NSOperationQueuePriority	priority;
+	BOOL						loading;				// holds one of the connections for host
+}
+@end
+
+@implementation NDJSONScheduledResponse
+
+#if !__has_feature(objc_arc)
+- (void)dealloc
+{
+	[response release];
+	[key release];
+	[host release];
+	[coalescedResponses release];
+	[super dealloc];
+}
+#endif
+
+@end
+
+@interface NDJSONRequestScheduler ()
+{
+	NSUInteger				_maximumConnectionsPerHost;
+	NSOperationQueue		* __strong _parseQueue;
+	NSLock					* __strong _lock;
+	NSMutableArray			* __strong _runningResponses;
+	NSMutableArray			* __strong _waitingResponses;				// highest priority first
+	NSCountedSet			* __strong _connectionsPerHost;
+}
+
+- (NDJSONResponse *)releaseConnectionOfScheduledResponse:(NDJSONScheduledResponse *)scheduled;
+
+@end
+
+/*
+	only requests without side effects are coalesced, the deserializer itself is part of the key since the coalesced
+	requests share the one result it creates
+ */
+static NSString * NDJSONCoalescingKeyForRequest( NDJSONRequest * aRequest, NSURLRequest * aURLRequest )
+{
+	return [NDJSONResponseCache keyForRequest:aRequest URLRequest:aURLRequest sameDeserializer:YES];
+}
+
+@implementation NDJSONRequestScheduler
+
+@synthesize		maximumConnectionsPerHost = _maximumConnectionsPerHost;
+
+- (NSUInteger)maximumConcurrentParses
+{
+	return (NSUInteger)_parseQueue.maxConcurrentOperationCount;
+}
+
++ (NDJSONRequestScheduler *)sharedScheduler
+{
+	static NDJSONRequestScheduler	* kSharedScheduler = nil;
+	static dispatch_once_t			kOnceToken;
+	dispatch_once(&kOnceToken, ^{
+		kSharedScheduler = [[NDJSONRequestScheduler alloc] initWithMaximumConnectionsPerHost:kNDJSONDefaultMaximumConnectionsPerHost maximumConcurrentParses:[[NSProcessInfo processInfo] activeProcessorCount]];
+	});
+	return kSharedScheduler;
+}
+
+- (id)init
+{
+	return [self initWithMaximumConnectionsPerHost:kNDJSONDefaultMaximumConnectionsPerHost maximumConcurrentParses:0];
+}
+
+- (id)initWithMaximumConnectionsPerHost:(NSUInteger)aMaximumConnectionsPerHost maximumConcurrentParses:(NSUInteger)aMaximumConcurrentParses
+{
+	NSParameterAssert( aMaximumConnectionsPerHost > 0 );
+	if( (self = [super init]) != nil )
+	{
+		_maximumConnectionsPerHost = aMaximumConnectionsPerHost;
+		_parseQueue = [[NSOperationQueue alloc] init];
+		[_parseQueue setName:@"NDJSONRequestScheduler parse queue"];
+		[_parseQueue setMaxConcurrentOperationCount:(NSInteger)(aMaximumConcurrentParses > 0 ? aMaximumConcurrentParses : kNDJSONMaximumConcurrentResponseParses)];
+		_lock = [[NSLock alloc] init];
+		_runningResponses = [[NSMutableArray alloc] init];
+		_waitingResponses = [[NSMutableArray alloc] init];
+		_connectionsPerHost = [[NSCountedSet alloc] init];
+	}
+	return self;
+}
+
+#if !__has_feature(objc_arc)
+- (void)dealloc
+{
+	[_parseQueue release];
+	[_lock release];
+	[_runningResponses release];
+	[_waitingResponses release];
+	[_connectionsPerHost release];
+	[super dealloc];
+}
+#endif
+
+- (NSString *)description
+{
+	NSString	* theResult = nil;
+	[_lock lock];
+	theResult = [NSString stringWithFormat:@"%@ {running:%lu, waiting:%lu}", [super description], (unsigned long)_runningResponses.count, (unsigned long)_waitingResponses.count];
+	[_lock unlock];
+	return theResult;
+}
+
+#pragma mark - private
+
+/*
+	the first waiting response for the same host takes the freed connection, must be called with the lock held, the returned response has to be started once the lock is released
+ */
+- (NDJSONResponse *)releaseConnectionOfScheduledResponse:(NDJSONScheduledResponse *)aScheduled
+{
+	NDJSONResponse		* theResult = nil;
+	if( aScheduled->loading )
+	{
+		aScheduled->loading = NO;
+		[_connectionsPerHost removeObject:aScheduled->host];
+		for( NSUInteger i = 0; i < _waitingResponses.count; i++ )
+		{
+			NDJSONScheduledResponse		* theWaiting = [_waitingResponses objectAtIndex:i];
+			if( [theWaiting->host isEqualToString:aScheduled->host] )
+			{
+				[_connectionsPerHost addObject:theWaiting->host];
+				[_runningResponses addObject:theWaiting];
+				theWaiting->loading = YES;
+				theResult = theWaiting->response;
+				[_waitingResponses removeObjectAtIndex:i];
+				break;
+			}
+		}
+	}
+	return theResult;
+}
+
+@end
+
+@implementation NDJSONRequestScheduler (NDJSONResponse)
+
+- (NSOperationQueue *)parseQueue { return _parseQueue; }
+
+- (void)scheduleResponse:(NDJSONResponse *)aResponse
+{
+	NDJSONRequest				* theRequest = aResponse.request;
+	NSURLRequest				* theURLRequest = theRequest.URLRequest;
+	NSString					* theKey = NDJSONCoalescingKeyForRequest( theRequest, theURLRequest ),
+								* theHost = [theURLRequest.URL.host lowercaseString];
+	NDJSONScheduledResponse		* theScheduled = nil;
+	BOOL						theStart = NO;
+
+	[_lock lock];
+	if( theKey != nil )
+	{
+		for( NSArray * theList in [NSArray arrayWithObjects:_runningResponses, _waitingResponses, nil] )
+		{
+			for( NDJSONScheduledResponse * theExisting in theList )
+			{
+				if( [theExisting->key isEqualToString:theKey] )
+				{
+					[theExisting->coalescedResponses addObject:aResponse];
+					[_lock unlock];
+					return;
+				}
+			}
+		}
+	}
+
+	theScheduled = [[NDJSONScheduledResponse alloc] init];
+#if __has_feature(objc_arc)
+	theScheduled->response = aResponse;
+#else
+	theScheduled->response = [aResponse retain];
+#endif
+	theScheduled->key = [theKey copy];
+	theScheduled->host = [(theHost != nil ? theHost : @"") copy];
+	theScheduled->coalescedResponses = [[NSMutableArray alloc] init];
+	theScheduled->priority = theRequest.priority;
+
+	if( [_connectionsPerHost countForObject:theScheduled->host] < _maximumConnectionsPerHost )
+	{
+		[_connectionsPerHost addObject:theScheduled->host];
+		[_runningResponses addObject:theScheduled];
+		theScheduled->loading = YES;
+		theStart = YES;
+	}
+	else
+	{
+		NSUInteger		theIndex = 0;
+		while( theIndex < _waitingResponses.count && ((NDJSONScheduledResponse*)[_waitingResponses objectAtIndex:theIndex])->priority >= theScheduled->priority )
+			theIndex++;
+		[_waitingResponses insertObject:theScheduled atIndex:theIndex];
+	}
+	[_lock unlock];
+#if !__has_feature(objc_arc)
+	[theScheduled release];
+#endif
+
+	if( theStart )
+		[aResponse startConnection];
+}
+
+- (void)responseDidFinishLoading:(NDJSONResponse *)aResponse
+{
+	NDJSONResponse				* theStarting = nil;
+	NDJSONScheduledResponse		* theLoaded = nil;
+	[_lock lock];
+	for( NDJSONScheduledResponse * theScheduled in _runningResponses )
+	{
+		if( theScheduled->response == aResponse )
+		{
+			theLoaded = theScheduled;
+			break;
+		}
+	}
+	if( theLoaded != nil )
+		theStarting = [self releaseConnectionOfScheduledResponse:theLoaded];
+	[_lock unlock];
+	[theStarting startConnection];
+}
+
+- (NSArray *)responseDidFinish:(NDJSONResponse *)aResponse
+{
+	NSArray						* theResult = nil;
+	NDJSONResponse				* theStarting = nil;
+	NDJSONScheduledResponse		* theFinished = nil;
+
+	[_lock lock];
+	for( NDJSONScheduledResponse * theScheduled in _runningResponses )
+	{
+		if( theScheduled->response == aResponse )
+		{
+			theFinished = theScheduled;
+			break;
+		}
+	}
+	if( theFinished != nil )
+	{
+		theResult = [NSArray arrayWithArray:theFinished->coalescedResponses];
+		theStarting = [self releaseConnectionOfScheduledResponse:theFinished];		// in case it never finished loading
+		[_runningResponses removeObjectIdenticalTo:theFinished];
+	}
+	[_lock unlock];
+
+	[theStarting startConnection];
+	return theResult;
+}
+
+@end
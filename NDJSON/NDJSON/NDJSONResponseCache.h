@@ -0,0 +1,92 @@
+/*
+	NDJSONResponseCache.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+
+@class		NDJSONRequest;
+
+@class		NDJSONRequest;
+
+/**
+	NDJSONResponseCache stores the deserialized result of GET requests together with the responses ETag and Last-Modified validators, so that NDJSONRequest can send a conditional request and, on a 304 Not Modified response, return the previous result without parsing anything.
+
+	Results are kept in memory, the response bodies are optionally kept on disk so a result that has been evicted from memory can be rebuilt from disk without downloading it again. Both are limited in size and evicted least recently used first. The size of a result in memory is estimated from the size of its JSON.
+
+	The same result object is returned for every hit, so results returned from the cache should be treated as immutable.
+ */
+@interface NDJSONResponseCache : NSObject
+
+/**
+	initialize with the maximum number of bytes used in memory and on disk, a *diskCapacity* of 0 or a nil *path* means nothing is stored on disk.
+ */
+- (id)initWithMemoryCapacity:(NSUInteger)memoryCapacity diskCapacity:(NSUInteger)diskCapacity diskPath:(NSString *)path;
+
+@property(readonly,nonatomic)	NSUInteger		memoryCapacity;
+@property(readonly,nonatomic)	NSUInteger		diskCapacity;
+@property(readonly,nonatomic)	NSString		* diskPath;
+@property(readonly,nonatomic)	NSUInteger		currentMemoryUsage;
+@property(readonly,nonatomic)	NSUInteger		currentDiskUsage;
+
+- (void)removeAllCachedResults;
+
+@end
+
+/*
+	Private methods used by NDJSONRequest and NDJSONResponse
+ */
+@interface NDJSONResponseCache (NDJSONRequest)
+
+/*
+	the key of a GET request, nil for other requests, see keyForRequest:URLRequest:sameDeserializer:
+ */
++ (NSString *)cacheKeyForRequest:(NDJSONRequest *)request URLRequest:(NSURLRequest *)URLRequest;
+/*
+	the key of a GET or HEAD request without a body, nil for other requests. The key is the method, the URL, every header
+	other than the validators the cache adds, the deserializer options and, with sameDeserializer, the deserializer itself,
+	otherwise its class and root classes so the keys of cached results stay the same between launches
+ */
++ (NSString *)keyForRequest:(NDJSONRequest *)request URLRequest:(NSURLRequest *)URLRequest sameDeserializer:(BOOL)sameDeserializer;
+
+- (void)addValidatorsForKey:(NSString *)key toURLRequest:(NSMutableURLRequest *)request;
+/*
+	the in memory result for a key, if there is one
+ */
+- (id)resultForKey:(NSString *)key;
+/*
+	path to the stored response body for a key, if there is one
+ */
+- (NSString *)bodyPathForKey:(NSString *)key;
+/*
+	path for writing a new response body to, it is moved into the cache by storeResult:...
+ */
+- (NSString *)temporaryBodyPath;
+- (void)storeResult:(id)result bodyLength:(NSUInteger)length bodyPath:(NSString *)bodyPath HTTPResponse:(NSHTTPURLResponse *)response forKey:(NSString *)key;
+/*
+	keeps the result rebuilt from the stored body in memory again, the validators and the body on disk are left as they are
+ */
+- (void)setResult:(id)result forKey:(NSString *)key;
+
+@end
@@ -0,0 +1,433 @@
+/*
+	NDJSONResponseCache.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import "NDJSONResponseCache.h"
+#import "NDJSONRequest.h"
+#import "NDJSONDeserializer.h"
+
+static NSString		* const kETagHTTPHeaderKey = @"ETag",
+					* const kLastModifiedHTTPHeaderKey = @"Last-Modified",
+					* const kIfNoneMatchHTTPHeaderKey = @"If-None-Match",
+					* const kIfModifiedSinceHTTPHeaderKey = @"If-Modified-Since",
+					* const kCacheEntryKeyKey = @"Key",
+					* const kCacheEntryLengthKey = @"Length",
+					* const kBodyPathExtension = @"json",
+					* const kEntryPathExtension = @"plist",
+					* const kTemporaryPathExtension = @"tmp";
+
+@interface NDJSONResponseCacheEntry : NSObject
+{
+@public
+	NSString		* key,
+					* ETag,
+					* lastModified;
+	id				result;
+	NSUInteger		length;
+	BOOL			onDisk;
+}
+@end
+
+@interface NDJSONResponseCache ()
+{
+	NSUInteger				_memoryCapacity,
+							_diskCapacity,
+							_currentMemoryUsage,
+							_currentDiskUsage;
+	NSString				* _diskPath;
+	NSLock					* _lock;
+	NSMutableDictionary		* _entries;
+	NSMutableArray			* _resultsOrder;			// least recently used first
+	BOOL					_loadedDiskEntries;
+}
+
+- (void)loadDiskEntries;
+- (void)removeEntryIfUnused:(NDJSONResponseCacheEntry *)entry;
+- (void)evictResults;
+- (void)evictBodies;
+- (NSString *)pathForKey:(NSString *)key extension:(NSString *)extension;
+
+@end
+
+@implementation NDJSONResponseCache
+
+@synthesize		memoryCapacity = _memoryCapacity,
+				diskCapacity = _diskCapacity,
+				diskPath = _diskPath;
+
+- (NSUInteger)currentMemoryUsage
+{
+	NSUInteger		theResult;
+	[_lock lock];
+	theResult = _currentMemoryUsage;
+	[_lock unlock];
+	return theResult;
+}
+
+- (NSUInteger)currentDiskUsage
+{
+	NSUInteger		theResult;
+	[_lock lock];
+	[self loadDiskEntries];
+	theResult = _currentDiskUsage;
+	[_lock unlock];
+	return theResult;
+}
+
+#pragma mark - creation and destruction
+
+- (id)initWithMemoryCapacity:(NSUInteger)aMemoryCapacity diskCapacity:(NSUInteger)aDiskCapacity diskPath:(NSString *)aPath
+{
+	if( (self = [super init]) != nil )
+	{
+		_memoryCapacity = aMemoryCapacity;
+		_diskCapacity = aPath != nil ? aDiskCapacity : 0;
+		_diskPath = [aPath copy];
+		_lock = [[NSLock alloc] init];
+		_entries = [[NSMutableDictionary alloc] init];
+		_resultsOrder = [[NSMutableArray alloc] init];
+		if( _diskCapacity > 0 )
+			[[NSFileManager defaultManager] createDirectoryAtPath:_diskPath withIntermediateDirectories:YES attributes:nil error:NULL];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[_diskPath release];
+	[_lock release];
+	[_entries release];
+	[_resultsOrder release];
+	[super dealloc];
+}
+
+- (void)removeAllCachedResults
+{
+	[_lock lock];
+	[self loadDiskEntries];
+	for( NDJSONResponseCacheEntry * theEntry in [_entries allValues] )
+	{
+		if( theEntry->onDisk )
+		{
+			[[NSFileManager defaultManager] removeItemAtPath:[self pathForKey:theEntry->key extension:kBodyPathExtension] error:NULL];
+			[[NSFileManager defaultManager] removeItemAtPath:[self pathForKey:theEntry->key extension:kEntryPathExtension] error:NULL];
+		}
+	}
+	[_entries removeAllObjects];
+	[_resultsOrder removeAllObjects];
+	_currentMemoryUsage = 0;
+	_currentDiskUsage = 0;
+	[_lock unlock];
+}
+
+#pragma mark - private
+
+/*
+	The validators for the bodies on disk are read the first time they are needed
+ */
+- (void)loadDiskEntries
+{
+	if( !_loadedDiskEntries && _diskCapacity > 0 )
+	{
+		for( NSString * theName in [[NSFileManager defaultManager] contentsOfDirectoryAtPath:_diskPath error:NULL] )
+		{
+			NSString		* thePath = [_diskPath stringByAppendingPathComponent:theName];
+			if( [[theName pathExtension] isEqualToString:kEntryPathExtension] )
+			{
+				NSDictionary	* theInfo = [NSDictionary dictionaryWithContentsOfFile:thePath];
+				NSString		* theKey = [theInfo objectForKey:kCacheEntryKeyKey];
+				if( theKey != nil && [_entries objectForKey:theKey] == nil )
+				{
+					NDJSONResponseCacheEntry	* theEntry = [[NDJSONResponseCacheEntry alloc] init];
+					theEntry->key = [theKey copy];
+					theEntry->ETag = [[theInfo objectForKey:kETagHTTPHeaderKey] copy];
+					theEntry->lastModified = [[theInfo objectForKey:kLastModifiedHTTPHeaderKey] copy];
+					theEntry->length = [[theInfo objectForKey:kCacheEntryLengthKey] unsignedIntegerValue];
+					theEntry->onDisk = YES;
+					_currentDiskUsage += theEntry->length;
+					[_entries setObject:theEntry forKey:theKey];
+					[theEntry release];
+				}
+			}
+			else if( [[theName pathExtension] isEqualToString:kTemporaryPathExtension] )
+				[[NSFileManager defaultManager] removeItemAtPath:thePath error:NULL];		// left over from an unfinished response
+		}
+		[self evictBodies];
+	}
+	_loadedDiskEntries = YES;
+}
+
+- (NSString *)pathForKey:(NSString *)aKey extension:(NSString *)anExtension
+{
+	const char		* theBytes = [aKey UTF8String];
+	uint64_t		theHash = 14695981039346656037ULL;
+	for( NSUInteger i = 0; theBytes[i] != '\0'; i++ )
+		theHash = (theHash ^ (uint8_t)theBytes[i]) * 1099511628211ULL;
+	return [_diskPath stringByAppendingPathComponent:[NSString stringWithFormat:@"%016llx.%@", (unsigned long long)theHash, anExtension]];
+}
+
+- (void)removeEntryIfUnused:(NDJSONResponseCacheEntry *)anEntry
+{
+	if( anEntry->result == nil && !anEntry->onDisk )
+		[_entries removeObjectForKey:anEntry->key];
+}
+
+- (void)evictResults
+{
+	while( _currentMemoryUsage > _memoryCapacity && _resultsOrder.count > 0 )
+	{
+		NDJSONResponseCacheEntry	* theEntry = [_entries objectForKey:[_resultsOrder objectAtIndex:0]];
+		[_resultsOrder removeObjectAtIndex:0];
+		_currentMemoryUsage -= theEntry->length;
+		[theEntry->result release], theEntry->result = nil;
+		[self removeEntryIfUnused:theEntry];
+	}
+}
+
+/*
+	the modification date of the bodies is used for the least recently used order on disk, see bodyPathForKey:
+ */
+- (void)evictBodies
+{
+	if( _currentDiskUsage > _diskCapacity )
+	{
+		NSMutableArray		* theOnDisk = [NSMutableArray array];
+		for( NDJSONResponseCacheEntry * theEntry in [_entries allValues] )
+		{
+			if( theEntry->onDisk )
+			{
+				NSDate		* theDate = [[[NSFileManager defaultManager] attributesOfItemAtPath:[self pathForKey:theEntry->key extension:kBodyPathExtension] error:NULL] fileModificationDate];
+				[theOnDisk addObject:[NSArray arrayWithObjects:theDate != nil ? theDate : [NSDate distantPast], theEntry, nil]];
+			}
+		}
+		[theOnDisk sortUsingComparator:^NSComparisonResult(NSArray * anA, NSArray * aB) { return [[anA objectAtIndex:0] compare:[aB objectAtIndex:0]]; }];
+		for( NSArray * theItem in theOnDisk )
+		{
+			NDJSONResponseCacheEntry	* theEntry = [theItem objectAtIndex:1];
+			if( _currentDiskUsage <= _diskCapacity )
+				break;
+			[[NSFileManager defaultManager] removeItemAtPath:[self pathForKey:theEntry->key extension:kBodyPathExtension] error:NULL];
+			[[NSFileManager defaultManager] removeItemAtPath:[self pathForKey:theEntry->key extension:kEntryPathExtension] error:NULL];
+			theEntry->onDisk = NO;
+			_currentDiskUsage -= theEntry->length;
+			[self removeEntryIfUnused:theEntry];
+		}
+	}
+}
+
+@end
+
+@implementation NDJSONResponseCache (NDJSONRequest)
+
++ (NSString *)cacheKeyForRequest:(NDJSONRequest *)aRequest URLRequest:(NSURLRequest *)aURLRequest
+{
+	NSString	* theMethod = [aURLRequest HTTPMethod];
+	return theMethod == nil || [theMethod isEqualToString:@"GET"]
+			? [self keyForRequest:aRequest URLRequest:aURLRequest sameDeserializer:NO]
+			: nil;
+}
+
++ (NSString *)keyForRequest:(NDJSONRequest *)aRequest URLRequest:(NSURLRequest *)aURLRequest sameDeserializer:(BOOL)aSameDeserializer
+{
+	NSString			* theResult = nil;
+	NSString			* theMethod = aURLRequest.HTTPMethod;
+	if( (theMethod == nil || [theMethod isEqualToString:@"GET"] || [theMethod isEqualToString:@"HEAD"]) && aURLRequest.HTTPBody == nil && aURLRequest.HTTPBodyStream == nil )
+	{
+		NDJSONDeserializer	* theDeserializer = aRequest.deserializer;
+		NSDictionary		* theHeaders = aURLRequest.allHTTPHeaderFields;
+		NSMutableString		* theKey = [NSMutableString stringWithFormat:@"%@ %@ %lu", theMethod != nil ? theMethod : @"GET", aURLRequest.URL.absoluteString, (unsigned long)aRequest.deserializerOptions];
+		if( aSameDeserializer )
+			[theKey appendFormat:@" %p", (void*)theDeserializer];
+		else if( theDeserializer != nil )
+			[theKey appendFormat:@" %@(%@,%@)", NSStringFromClass([theDeserializer class]), NSStringFromClass(theDeserializer.rootClass), NSStringFromClass(theDeserializer.rootCollectionClass)];
+		for( NSString * theField in [[theHeaders allKeys] sortedArrayUsingSelector:@selector(caseInsensitiveCompare:)] )
+		{
+			if( [theField caseInsensitiveCompare:kIfNoneMatchHTTPHeaderKey] != NSOrderedSame && [theField caseInsensitiveCompare:kIfModifiedSinceHTTPHeaderKey] != NSOrderedSame )
+				[theKey appendFormat:@"\n%@: %@", [theField lowercaseString], [theHeaders objectForKey:theField]];
+		}
+		theResult = theKey;
+	}
+	return theResult;
+}
+
+- (void)addValidatorsForKey:(NSString *)aKey toURLRequest:(NSMutableURLRequest *)aRequest
+{
+	NDJSONResponseCacheEntry		* theEntry = nil;
+	[_lock lock];
+	[self loadDiskEntries];
+	theEntry = [_entries objectForKey:aKey];
+	if( theEntry != nil )
+	{
+		if( theEntry->ETag != nil )
+			[aRequest setValue:theEntry->ETag forHTTPHeaderField:kIfNoneMatchHTTPHeaderKey];
+		if( theEntry->lastModified != nil )
+			[aRequest setValue:theEntry->lastModified forHTTPHeaderField:kIfModifiedSinceHTTPHeaderKey];
+	}
+	[_lock unlock];
+	[aRequest setCachePolicy:NSURLRequestReloadIgnoringLocalCacheData];		// we want to see the 304s ourselves
+}
+
+- (id)resultForKey:(NSString *)aKey
+{
+	id							theResult = nil;
+	NDJSONResponseCacheEntry	* theEntry = nil;
+	[_lock lock];
+	theEntry = [_entries objectForKey:aKey];
+	if( theEntry != nil && theEntry->result != nil )
+	{
+		theResult = [[theEntry->result retain] autorelease];
+		[_resultsOrder removeObject:aKey];
+		[_resultsOrder addObject:aKey];
+	}
+	[_lock unlock];
+	return theResult;
+}
+
+- (NSString *)bodyPathForKey:(NSString *)aKey
+{
+	NSString					* theResult = nil;
+	NDJSONResponseCacheEntry	* theEntry = nil;
+	[_lock lock];
+	[self loadDiskEntries];
+	theEntry = [_entries objectForKey:aKey];
+	if( theEntry != nil && theEntry->onDisk )
+	{
+		theResult = [self pathForKey:aKey extension:kBodyPathExtension];
+		[[NSFileManager defaultManager] setAttributes:[NSDictionary dictionaryWithObject:[NSDate date] forKey:NSFileModificationDate] ofItemAtPath:theResult error:NULL];
+	}
+	[_lock unlock];
+	return theResult;
+}
+
+- (NSString *)temporaryBodyPath
+{
+	return _diskCapacity > 0
+			? [_diskPath stringByAppendingPathComponent:[[[NSProcessInfo processInfo] globallyUniqueString] stringByAppendingPathExtension:kTemporaryPathExtension]]
+			: nil;
+}
+
+- (void)storeResult:(id)aResult bodyLength:(NSUInteger)aLength bodyPath:(NSString *)aBodyPath HTTPResponse:(NSHTTPURLResponse *)aResponse forKey:(NSString *)aKey
+{
+	NSDictionary				* theHeaders = [aResponse allHeaderFields];
+	NSString					* theETag = [theHeaders objectForKey:kETagHTTPHeaderKey],
+								* theLastModified = [theHeaders objectForKey:kLastModifiedHTTPHeaderKey];
+	NDJSONResponseCacheEntry	* theEntry = nil;
+
+	NSParameterAssert( aKey != nil );
+	NSParameterAssert( aResult != nil );
+
+	[_lock lock];
+	[self loadDiskEntries];
+	theEntry = [_entries objectForKey:aKey];
+	if( theEntry != nil )						// replace everything about the old entry
+	{
+		if( theEntry->result != nil )
+		{
+			_currentMemoryUsage -= theEntry->length;
+			[_resultsOrder removeObject:aKey];
+		}
+		if( theEntry->onDisk )
+		{
+			_currentDiskUsage -= theEntry->length;
+			[[NSFileManager defaultManager] removeItemAtPath:[self pathForKey:aKey extension:kBodyPathExtension] error:NULL];
+			[[NSFileManager defaultManager] removeItemAtPath:[self pathForKey:aKey extension:kEntryPathExtension] error:NULL];
+		}
+		[_entries removeObjectForKey:aKey];
+	}
+
+	if( (theETag != nil || theLastModified != nil) && (aLength <= _memoryCapacity || (aBodyPath != nil && aLength <= _diskCapacity)) )
+	{
+		theEntry = [[NDJSONResponseCacheEntry alloc] init];
+		theEntry->key = [aKey copy];
+		theEntry->ETag = [theETag copy];
+		theEntry->lastModified = [theLastModified copy];
+		theEntry->length = aLength;
+		[_entries setObject:theEntry forKey:aKey];
+		[theEntry release];
+
+		if( aLength <= _memoryCapacity )
+		{
+			theEntry->result = [aResult retain];
+			_currentMemoryUsage += aLength;
+			[_resultsOrder addObject:aKey];
+		}
+
+		if( aBodyPath != nil && aLength <= _diskCapacity
+			&& [[NSFileManager defaultManager] moveItemAtPath:aBodyPath toPath:[self pathForKey:aKey extension:kBodyPathExtension] error:NULL] )
+		{
+			NSMutableDictionary		* theInfo = [NSMutableDictionary dictionaryWithObjectsAndKeys:aKey, kCacheEntryKeyKey, [NSNumber numberWithUnsignedInteger:aLength], kCacheEntryLengthKey, nil];
+			if( theETag != nil )
+				[theInfo setObject:theETag forKey:kETagHTTPHeaderKey];
+			if( theLastModified != nil )
+				[theInfo setObject:theLastModified forKey:kLastModifiedHTTPHeaderKey];
+			[theInfo writeToFile:[self pathForKey:aKey extension:kEntryPathExtension] atomically:YES];
+			theEntry->onDisk = YES;
+			_currentDiskUsage += aLength;
+		}
+		[self evictResults];
+		[self evictBodies];
+	}
+	if( aBodyPath != nil && [[NSFileManager defaultManager] fileExistsAtPath:aBodyPath] )
+		[[NSFileManager defaultManager] removeItemAtPath:aBodyPath error:NULL];
+	[_lock unlock];
+}
+
+- (void)setResult:(id)aResult forKey:(NSString *)aKey
+{
+	NDJSONResponseCacheEntry	* theEntry = nil;
+
+	NSParameterAssert( aKey != nil );
+	NSParameterAssert( aResult != nil );
+
+	[_lock lock];
+	theEntry = [_entries objectForKey:aKey];
+	if( theEntry != nil && theEntry->length <= _memoryCapacity )
+	{
+		if( theEntry->result != nil )
+			[_resultsOrder removeObject:aKey];
+		else
+			_currentMemoryUsage += theEntry->length;
+		[theEntry->result release];
+		theEntry->result = [aResult retain];
+		[_resultsOrder addObject:aKey];
+		[self evictResults];
+	}
+	[_lock unlock];
+}
+
+@end
+
+@implementation NDJSONResponseCacheEntry
+
+- (void)dealloc
+{
+	[key release];
+	[ETag release];
+	[lastModified release];
+	[result release];
+	[super dealloc];
+}
+
+@end
@@ -0,0 +1,98 @@
+/*
+	NDJSONSchemaValidator.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "NDJSONParser.h"
+
+extern NSString		* const NDJSONSchemaErrorDomain;
+/**
+	user info key for the JSON Pointer (RFC 6901) of the value that failed validation, or of the schema that failed to compile
+ */
+extern NSString		* const NDJSONSchemaPointerErrorKey;
+/**
+	user info key for the schema keyword that failed
+ */
+extern NSString		* const NDJSONSchemaKeywordErrorKey;
+
+typedef enum
+{
+	NDJSONSchemaInvalidSchemaError,
+	NDJSONSchemaUnsupportedKeywordError,
+	NDJSONSchemaTypeError,
+	NDJSONSchemaEnumError,
+	NDJSONSchemaRangeError,
+	NDJSONSchemaLengthError,
+	NDJSONSchemaPatternError,
+	NDJSONSchemaSizeError,
+	NDJSONSchemaRequiredError,
+	NDJSONSchemaAdditionalPropertiesError,
+	NDJSONSchemaFalseSchemaError
+}		NDJSONSchemaErrorCode;
+
+/**
+	A JSON Schema compiled for NDJSONSchemaValidator, schemas are immutable and can be shared between validators and threads.
+
+	The keywords type, enum, const, minimum, maximum, exclusiveMinimum, exclusiveMaximum, multipleOf, minLength, maxLength, pattern, items, additionalItems, minItems, maxItems, properties, additionalProperties, required, minProperties and maxProperties are checked, enum and const values must be strings, numbers, booleans or null. Keywords that can not be checked in a single pass without keeping the values, $ref, allOf, anyOf, oneOf, not, if, patternProperties, propertyNames, contains, uniqueItems and dependencies, fail to compile with NDJSONSchemaUnsupportedKeywordError, annotations such as title and format are ignored.
+ */
+@interface NDJSONSchema : NSObject
+
++ (NDJSONSchema *)schemaWithJSONObject:(id)object error:(NSError **)error;
+/**
+	initialize with a schema parsed into property list objects, a dictionary or a boolean.
+ */
+- (id)initWithJSONObject:(id)object error:(NSError **)error;
+
+@end
+
+/**
+	NDJSONSchemaValidator checks the events of an NDJSONParser against an NDJSONSchema as they are parsed and forwards them to its own delegate, usually an NDJSONDeserializer, so a document is validated and deserialized in a single pass. Use the schemaValidator property of NDJSONDeserializer, or set the validator as the parsers delegate.
+
+	Each violation is an NSError in NDJSONSchemaErrorDomain with the JSON Pointer of the value, by default the first violation is also sent to the delegate as a parser error and parsing is aborted. Values the delegate skips with jsonParser:shouldSkipValueForKey: are not validated. Base64 values the delegate decodes with jsonParser:shouldDecodeBase64ValueForKey: are validated as strings, except that values whose schema has an enum, minLength, maxLength or pattern are not decoded so their characters can be checked.
+ */
+@interface NDJSONSchemaValidator : NSObject <NDJSONParserDelegate>
+
+- (id)initWithSchema:(NDJSONSchema *)schema;
+
+@property(readonly,nonatomic)	NDJSONSchema				* schema;
+/**
+	The delegate all parser events are forwarded to.
+ */
+@property(assign,nonatomic)		id<NDJSONParserDelegate>	delegate;
+/**
+	Whether the parser is aborted at the first violation, the default is YES, otherwise every violation is collected in errors.
+ */
+@property(assign,nonatomic)		BOOL						abortsOnFirstError;
+/**
+	Whether the schema applies to each element of the root array instead of the root value, for NDJSONOptionJSONLines input.
+ */
+@property(assign,nonatomic)		BOOL						validatesRootArrayElements;
+/**
+	the violations found in the last document parsed.
+ */
+@property(readonly,nonatomic)	NSArray						* errors;
+@property(readonly,nonatomic,getter=isValid)	BOOL		valid;
+
+@end
@@ -0,0 +1,897 @@
+/*
+	NDJSONSchemaValidator.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import "NDJSONSchemaValidator.h"
+#import "NDJSONParserPrivate.h"
+#import <objc/runtime.h>
+#include <math.h>
+#include <stdlib.h>
+
+NSString		* const NDJSONSchemaErrorDomain = @"NDJSONSchemaError";
+NSString		* const NDJSONSchemaPointerErrorKey = @"NDJSONSchemaPointer";
+NSString		* const NDJSONSchemaKeywordErrorKey = @"NDJSONSchemaKeyword";
+
+enum
+{
+	kNDJSONSchemaObjectType = 1<<0,
+	kNDJSONSchemaArrayType = 1<<1,
+	kNDJSONSchemaStringType = 1<<2,
+	kNDJSONSchemaIntegerType = 1<<3,
+	kNDJSONSchemaNumberType = 1<<4,
+	kNDJSONSchemaBooleanType = 1<<5,
+	kNDJSONSchemaNullType = 1<<6
+};
+
+enum
+{
+	kNDJSONSchemaEnumTrue = 1<<0,
+	kNDJSONSchemaEnumFalse = 1<<1,
+	kNDJSONSchemaEnumNull = 1<<2
+};
+
+@interface NDJSONSchema ()
+{
+@package
+	BOOL					_rejectsAll;					// the false schema
+	unsigned int			_types;							// 0 for any type
+	BOOL					_hasEnum;
+	NSSet					* _enumStrings,
+							* _enumNumbers;
+	unsigned int			_enumOthers;
+	struct
+	{
+		unsigned int			minimum				: 1;
+		unsigned int			maximum				: 1;
+		unsigned int			exclusiveMinimum	: 1;
+		unsigned int			exclusiveMaximum	: 1;
+		unsigned int			multipleOf			: 1;
+	}						_has;
+	double					_minimum,
+							_maximum,
+							_exclusiveMinimum,
+							_exclusiveMaximum,
+							_multipleOf;
+	NSUInteger				_minLength,
+							_maxLength,
+							_minItems,
+							_maxItems,
+							_minProperties,
+							_maxProperties;
+	NSRegularExpression		* _pattern;
+	NDJSONSchema			* _items;
+	NSArray					* _tupleItems;
+	NDJSONSchema			* _additionalItems;
+	NSDictionary			* _properties;
+	NDJSONSchema			* _additionalProperties;
+	NSSet					* _required;
+}
+
+- (id)initWithJSONObject:(id)object pointer:(NSString *)pointer error:(NSError **)error;
+
+@end
+
+static NSString * NDJSONSchemaEscapedPointerComponent( NSString * aComponent )
+{
+	return [[aComponent stringByReplacingOccurrencesOfString:@"~" withString:@"~0"] stringByReplacingOccurrencesOfString:@"/" withString:@"~1"];
+}
+
+static NSError * NDJSONSchemaError( NDJSONSchemaErrorCode aCode, NSString * aKeyword, NSString * aPointer, NSString * aDescription )
+{
+	return [NSError errorWithDomain:NDJSONSchemaErrorDomain code:aCode userInfo:[NSDictionary dictionaryWithObjectsAndKeys:aDescription, NSLocalizedDescriptionKey, aPointer, NDJSONSchemaPointerErrorKey, aKeyword, NDJSONSchemaKeywordErrorKey, nil]];
+}
+
+static BOOL NDJSONSchemaIsBoolean( id anObject )
+{
+	return anObject != nil && CFGetTypeID((CFTypeRef)anObject) == CFBooleanGetTypeID();
+}
+
+#pragma mark - NDJSONSchema
+
+@implementation NDJSONSchema
+
++ (NDJSONSchema *)schemaWithJSONObject:(id)anObject error:(NSError **)anError
+{
+	return [[[self alloc] initWithJSONObject:anObject error:anError] autorelease];
+}
+
+- (id)initWithJSONObject:(id)anObject error:(NSError **)anError
+{
+	return [self initWithJSONObject:anObject pointer:@"" error:anError];
+}
+
+static BOOL NDJSONSchemaGetCount( NSDictionary * aSchema, NSString * aKeyword, NSUInteger * aCount, NSString * aPointer, NSError ** anError )
+{
+	BOOL		theResult = YES;
+	id			theValue = [aSchema objectForKey:aKeyword];
+	if( theValue != nil )
+	{
+		if( [theValue isKindOfClass:[NSNumber class]] && !NDJSONSchemaIsBoolean(theValue) && [theValue doubleValue] >= 0.0 )
+			*aCount = [theValue unsignedIntegerValue];
+		else
+		{
+			if( anError != NULL )
+				*anError = NDJSONSchemaError( NDJSONSchemaInvalidSchemaError, aKeyword, aPointer, [NSString stringWithFormat:@"%@ must be a non-negative integer", aKeyword] );
+			theResult = NO;
+		}
+	}
+	return theResult;
+}
+
+static BOOL NDJSONSchemaGetNumber( NSDictionary * aSchema, NSString * aKeyword, double * aNumber, NSString * aPointer, NSError ** anError )
+{
+	id			theValue = [aSchema objectForKey:aKeyword];
+	if( [theValue isKindOfClass:[NSNumber class]] && !NDJSONSchemaIsBoolean(theValue) )
+		*aNumber = [theValue doubleValue];
+	else if( anError != NULL )
+		*anError = NDJSONSchemaError( NDJSONSchemaInvalidSchemaError, aKeyword, aPointer, [NSString stringWithFormat:@"%@ must be a number", aKeyword] );
+	return [theValue isKindOfClass:[NSNumber class]] && !NDJSONSchemaIsBoolean(theValue);
+}
+
+static BOOL NDJSONSchemaGetTypes( NDJSONSchema * self, id aType, NSString * aPointer, NSError ** anError )
+{
+	static NSDictionary		* kTypes = nil;
+	BOOL					theResult = YES;
+	if( kTypes == nil )
+	{
+		kTypes = [[NSDictionary alloc] initWithObjectsAndKeys:[NSNumber numberWithUnsignedInt:kNDJSONSchemaObjectType], @"object",
+																[NSNumber numberWithUnsignedInt:kNDJSONSchemaArrayType], @"array",
+																[NSNumber numberWithUnsignedInt:kNDJSONSchemaStringType], @"string",
+																[NSNumber numberWithUnsignedInt:kNDJSONSchemaIntegerType], @"integer",
+																[NSNumber numberWithUnsignedInt:kNDJSONSchemaNumberType], @"number",
+																[NSNumber numberWithUnsignedInt:kNDJSONSchemaBooleanType], @"boolean",
+																[NSNumber numberWithUnsignedInt:kNDJSONSchemaNullType], @"null", nil];
+	}
+	for( id theName in [aType isKindOfClass:[NSArray class]] ? aType : [NSArray arrayWithObject:aType] )
+	{
+		NSNumber		* theType = [theName isKindOfClass:[NSString class]] ? [kTypes objectForKey:theName] : nil;
+		if( theType == nil )
+		{
+			if( anError != NULL )
+				*anError = NDJSONSchemaError( NDJSONSchemaInvalidSchemaError, @"type", aPointer, [NSString stringWithFormat:@"unknown type %@", theName] );
+			theResult = NO;
+			break;
+		}
+		self->_types |= [theType unsignedIntValue];
+	}
+	return theResult;
+}
+
+/*
+	only scalar values can be compared as they are parsed
+ */
+static BOOL NDJSONSchemaGetEnum( NDJSONSchema * self, NSArray * aValues, NSString * aKeyword, NSString * aPointer, NSError ** anError )
+{
+	NSMutableSet		* theStrings = [NSMutableSet set],
+						* theNumbers = [NSMutableSet set];
+	if( ![aValues isKindOfClass:[NSArray class]] )
+	{
+		if( anError != NULL )
+			*anError = NDJSONSchemaError( NDJSONSchemaInvalidSchemaError, aKeyword, aPointer, @"enum must be an array" );
+		return NO;
+	}
+	for( id theValue in aValues )
+	{
+		if( NDJSONSchemaIsBoolean(theValue) )
+			self->_enumOthers |= [theValue boolValue] ? kNDJSONSchemaEnumTrue : kNDJSONSchemaEnumFalse;
+		else if( theValue == [NSNull null] )
+			self->_enumOthers |= kNDJSONSchemaEnumNull;
+		else if( [theValue isKindOfClass:[NSString class]] )
+			[theStrings addObject:theValue];
+		else if( [theValue isKindOfClass:[NSNumber class]] )
+			[theNumbers addObject:theValue];
+		else
+		{
+			if( anError != NULL )
+				*anError = NDJSONSchemaError( NDJSONSchemaUnsupportedKeywordError, aKeyword, aPointer, [NSString stringWithFormat:@"%@ values must be strings, numbers, booleans or null", aKeyword] );
+			return NO;
+		}
+	}
+	self->_hasEnum = YES;
+	[self->_enumStrings release], self->_enumStrings = [theStrings copy];
+	[self->_enumNumbers release], self->_enumNumbers = [theNumbers copy];
+	return YES;
+}
+
+static BOOL NDJSONSchemaGetSubschemas( NDJSONSchema * self, NSDictionary * aSchema, NSString * aPointer, NSError ** anError )
+{
+	id			theValue = nil;
+
+	if( (theValue = [aSchema objectForKey:@"items"]) != nil )
+	{
+		if( [theValue isKindOfClass:[NSArray class]] )
+		{
+			NSMutableArray		* theItems = [NSMutableArray arrayWithCapacity:[theValue count]];
+			for( NSUInteger i = 0, c = [theValue count]; i < c; i++ )
+			{
+				NDJSONSchema	* theItem = [[NDJSONSchema alloc] initWithJSONObject:[theValue objectAtIndex:i] pointer:[NSString stringWithFormat:@"%@/items/%lu", aPointer, (unsigned long)i] error:anError];
+				if( theItem == nil )
+					return NO;
+				[theItems addObject:theItem];
+				[theItem release];
+			}
+			self->_tupleItems = [theItems copy];
+		}
+		else if( (self->_items = [[NDJSONSchema alloc] initWithJSONObject:theValue pointer:[aPointer stringByAppendingString:@"/items"] error:anError]) == nil )
+			return NO;
+	}
+	if( (theValue = [aSchema objectForKey:@"additionalItems"]) != nil && self->_tupleItems != nil )
+	{
+		if( (self->_additionalItems = [[NDJSONSchema alloc] initWithJSONObject:theValue pointer:[aPointer stringByAppendingString:@"/additionalItems"] error:anError]) == nil )
+			return NO;
+	}
+	if( (theValue = [aSchema objectForKey:@"properties"]) != nil )
+	{
+		NSMutableDictionary		* theProperties = nil;
+		if( ![theValue isKindOfClass:[NSDictionary class]] )
+		{
+			if( anError != NULL )
+				*anError = NDJSONSchemaError( NDJSONSchemaInvalidSchemaError, @"properties", aPointer, @"properties must be an object" );
+			return NO;
+		}
+		theProperties = [NSMutableDictionary dictionaryWithCapacity:[theValue count]];
+		for( NSString * theKey in theValue )
+		{
+			NSString		* thePointer = [NSString stringWithFormat:@"%@/properties/%@", aPointer, NDJSONSchemaEscapedPointerComponent(theKey)];
+			NDJSONSchema	* theProperty = [[NDJSONSchema alloc] initWithJSONObject:[theValue objectForKey:theKey] pointer:thePointer error:anError];
+			if( theProperty == nil )
+				return NO;
+			[theProperties setObject:theProperty forKey:theKey];
+			[theProperty release];
+		}
+		self->_properties = [theProperties copy];
+	}
+	if( (theValue = [aSchema objectForKey:@"additionalProperties"]) != nil )
+	{
+		if( (self->_additionalProperties = [[NDJSONSchema alloc] initWithJSONObject:theValue pointer:[aPointer stringByAppendingString:@"/additionalProperties"] error:anError]) == nil )
+			return NO;
+	}
+	if( (theValue = [aSchema objectForKey:@"required"]) != nil )
+	{
+		if( ![theValue isKindOfClass:[NSArray class]] )
+		{
+			if( anError != NULL )
+				*anError = NDJSONSchemaError( NDJSONSchemaInvalidSchemaError, @"required", aPointer, @"required must be an array of strings" );
+			return NO;
+		}
+		if( [theValue count] > 0 )
+			self->_required = [[NSSet alloc] initWithArray:theValue];
+	}
+	return YES;
+}
+
+static BOOL NDJSONSchemaCompile( NDJSONSchema * self, NSDictionary * aSchema, NSString * aPointer, NSError ** anError )
+{
+	static NSArray		* kUnsupportedKeywords = nil;
+	id					theValue = nil;
+
+	if( kUnsupportedKeywords == nil )
+		kUnsupportedKeywords = [[NSArray alloc] initWithObjects:@"$ref", @"allOf", @"anyOf", @"oneOf", @"not", @"if", @"then", @"else", @"dependencies", @"dependentRequired", @"dependentSchemas", @"patternProperties", @"propertyNames", @"contains", @"uniqueItems", @"prefixItems", @"unevaluatedItems", @"unevaluatedProperties", nil];
+	for( NSString * theKeyword in kUnsupportedKeywords )
+	{
+		if( [aSchema objectForKey:theKeyword] != nil )
+		{
+			if( anError != NULL )
+				*anError = NDJSONSchemaError( NDJSONSchemaUnsupportedKeywordError, theKeyword, aPointer, [NSString stringWithFormat:@"%@ can not be validated while parsing", theKeyword] );
+			return NO;
+		}
+	}
+
+	if( (theValue = [aSchema objectForKey:@"type"]) != nil && !NDJSONSchemaGetTypes( self, theValue, aPointer, anError ) )
+		return NO;
+	if( (theValue = [aSchema objectForKey:@"enum"]) != nil && !NDJSONSchemaGetEnum( self, theValue, @"enum", aPointer, anError ) )
+		return NO;
+	if( (theValue = [aSchema objectForKey:@"const"]) != nil && !NDJSONSchemaGetEnum( self, [NSArray arrayWithObject:theValue], @"const", aPointer, anError ) )
+		return NO;
+
+	if( [aSchema objectForKey:@"minimum"] != nil )
+	{
+		if( !NDJSONSchemaGetNumber( aSchema, @"minimum", &self->_minimum, aPointer, anError ) )
+			return NO;
+		self->_has.minimum = YES;
+	}
+	if( [aSchema objectForKey:@"maximum"] != nil )
+	{
+		if( !NDJSONSchemaGetNumber( aSchema, @"maximum", &self->_maximum, aPointer, anError ) )
+			return NO;
+		self->_has.maximum = YES;
+	}
+	if( (theValue = [aSchema objectForKey:@"exclusiveMinimum"]) != nil )
+	{
+		if( NDJSONSchemaIsBoolean(theValue) )						// draft 4, modifies minimum
+		{
+			if( [theValue boolValue] && self->_has.minimum )
+			{
+				self->_exclusiveMinimum = self->_minimum;
+				self->_has.exclusiveMinimum = YES;
+				self->_has.minimum = NO;
+			}
+		}
+		else if( NDJSONSchemaGetNumber( aSchema, @"exclusiveMinimum", &self->_exclusiveMinimum, aPointer, anError ) )
+			self->_has.exclusiveMinimum = YES;
+		else
+			return NO;
+	}
+	if( (theValue = [aSchema objectForKey:@"exclusiveMaximum"]) != nil )
+	{
+		if( NDJSONSchemaIsBoolean(theValue) )
+		{
+			if( [theValue boolValue] && self->_has.maximum )
+			{
+				self->_exclusiveMaximum = self->_maximum;
+				self->_has.exclusiveMaximum = YES;
+				self->_has.maximum = NO;
+			}
+		}
+		else if( NDJSONSchemaGetNumber( aSchema, @"exclusiveMaximum", &self->_exclusiveMaximum, aPointer, anError ) )
+			self->_has.exclusiveMaximum = YES;
+		else
+			return NO;
+	}
+	if( [aSchema objectForKey:@"multipleOf"] != nil )
+	{
+		if( !NDJSONSchemaGetNumber( aSchema, @"multipleOf", &self->_multipleOf, aPointer, anError ) || self->_multipleOf <= 0.0 )
+		{
+			if( anError != NULL )
+				*anError = NDJSONSchemaError( NDJSONSchemaInvalidSchemaError, @"multipleOf", aPointer, @"multipleOf must be a number greater than 0" );
+			return NO;
+		}
+		self->_has.multipleOf = YES;
+	}
+
+	if( !NDJSONSchemaGetCount( aSchema, @"minLength", &self->_minLength, aPointer, anError )
+		|| !NDJSONSchemaGetCount( aSchema, @"maxLength", &self->_maxLength, aPointer, anError )
+		|| !NDJSONSchemaGetCount( aSchema, @"minItems", &self->_minItems, aPointer, anError )
+		|| !NDJSONSchemaGetCount( aSchema, @"maxItems", &self->_maxItems, aPointer, anError )
+		|| !NDJSONSchemaGetCount( aSchema, @"minProperties", &self->_minProperties, aPointer, anError )
+		|| !NDJSONSchemaGetCount( aSchema, @"maxProperties", &self->_maxProperties, aPointer, anError ) )
+	{
+		return NO;
+	}
+	if( (theValue = [aSchema objectForKey:@"pattern"]) != nil )
+	{
+		if( ![theValue isKindOfClass:[NSString class]] || (self->_pattern = [[NSRegularExpression alloc] initWithPattern:theValue options:0 error:NULL]) == nil )
+		{
+			if( anError != NULL )
+				*anError = NDJSONSchemaError( NDJSONSchemaInvalidSchemaError, @"pattern", aPointer, @"pattern must be a regular expression" );
+			return NO;
+		}
+	}
+	return NDJSONSchemaGetSubschemas( self, aSchema, aPointer, anError );
+}
+
+- (id)initWithJSONObject:(id)anObject pointer:(NSString *)aPointer error:(NSError **)anError
+{
+	if( (self = [super init]) != nil )
+	{
+		_maxLength = NSUIntegerMax;
+		_maxItems = NSUIntegerMax;
+		_maxProperties = NSUIntegerMax;
+		if( NDJSONSchemaIsBoolean(anObject) )
+			_rejectsAll = ![anObject boolValue];
+		else if( ![anObject isKindOfClass:[NSDictionary class]] )
+		{
+			if( anError != NULL )
+				*anError = NDJSONSchemaError( NDJSONSchemaInvalidSchemaError, @"", aPointer, @"a schema must be an object or a boolean" );
+			[self release];
+			self = nil;
+		}
+		else if( !NDJSONSchemaCompile( self, anObject, aPointer, anError ) )
+		{
+			[self release];
+			self = nil;
+		}
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[_enumStrings release];
+	[_enumNumbers release];
+	[_pattern release];
+	[_items release];
+	[_tupleItems release];
+	[_additionalItems release];
+	[_properties release];
+	[_additionalProperties release];
+	[_required release];
+	[super dealloc];
+}
+
+@end
+
+#pragma mark - NDJSONSchemaValidator
+
+/*
+	an object or array being parsed
+ */
+struct NDJSONSchemaFrame
+{
+	NDJSONSchema		* schema;						// nil if unconstrained, owned by the root schema
+	NSString			* key;							// key within the parent object, nil for array elements and the root
+	NSUInteger			index;							// index within the parent array
+	BOOL				isObject;
+	NSUInteger			count;							// properties or elements so far
+	NSString			* currentKey;
+	NDJSONSchema		* valueSchema;					// schema for the value of currentKey
+	NSMutableSet		* foundRequired;
+};
+
+@interface NDJSONSchemaValidator ()
+{
+	NDJSONSchema						* _schema;
+	NDJSONSchema						* _rootArraySchema;
+	id<NDJSONParserDelegate>			__weak _delegate;
+	Class								_delegateClass;
+	BOOL								_abortsOnFirstError,
+										_validatesRootArrayElements,
+										_aborted;
+	NSMutableArray						* _errors;
+	struct
+	{
+		NSUInteger							size,
+											count;
+		struct NDJSONSchemaFrame			* bytes;
+	}									_stack;
+	struct NDJSONDelegateMethods		_delegateMethod;
+}
+
+- (void)setUpRespondsTo;
+
+@end
+
+@implementation NDJSONSchemaValidator
+
+@synthesize		schema = _schema,
+				delegate = _delegate,
+				abortsOnFirstError = _abortsOnFirstError,
+				validatesRootArrayElements = _validatesRootArrayElements,
+				errors = _errors;
+
+- (BOOL)isValid { return _errors.count == 0; }
+
+- (void)setDelegate:(id<NDJSONParserDelegate>)aDelegate
+{
+	_delegate = aDelegate;
+	if( object_getClass(aDelegate) != _delegateClass )
+		[self setUpRespondsTo];
+}
+
+#pragma mark - creation and destruction
+
+- (id)initWithSchema:(NDJSONSchema *)aSchema
+{
+	NSParameterAssert( aSchema != nil );
+	if( (self = [super init]) != nil )
+	{
+		_schema = [aSchema retain];
+		_rootArraySchema = [[NDJSONSchema alloc] initWithJSONObject:[NSDictionary dictionaryWithObject:@"array" forKey:@"type"] error:NULL];
+		_rootArraySchema->_items = [aSchema retain];
+		_abortsOnFirstError = YES;
+		_errors = [[NSMutableArray alloc] init];
+	}
+	return self;
+}
+
+static void NDJSONSchemaPopFrame( NDJSONSchemaValidator * self )
+{
+	struct NDJSONSchemaFrame	* theFrame = &self->_stack.bytes[--self->_stack.count];
+	[theFrame->key release];
+	[theFrame->currentKey release];
+	[theFrame->foundRequired release];
+}
+
+- (void)dealloc
+{
+	while( _stack.count > 0 )
+		NDJSONSchemaPopFrame( self );
+	free( _stack.bytes );
+	[_schema release];
+	[_rootArraySchema release];
+	[_errors release];
+	[super dealloc];
+}
+
+#pragma mark - validation
+
+/*
+	JSON Pointer to the current container, and with aCurrent to the value being parsed within it
+ */
+static NSString * NDJSONSchemaPointer( NDJSONSchemaValidator * self, BOOL aCurrent )
+{
+	NSMutableString		* theResult = [NSMutableString string];
+	for( NSUInteger i = 1; i < self->_stack.count; i++ )
+	{
+		struct NDJSONSchemaFrame	* theFrame = &self->_stack.bytes[i];
+		if( theFrame->key != nil )
+			[theResult appendFormat:@"/%@", NDJSONSchemaEscapedPointerComponent(theFrame->key)];
+		else
+			[theResult appendFormat:@"/%lu", (unsigned long)theFrame->index];
+	}
+	if( aCurrent && self->_stack.count > 0 )
+	{
+		struct NDJSONSchemaFrame	* theTop = &self->_stack.bytes[self->_stack.count-1];
+		if( theTop->isObject )
+			[theResult appendFormat:@"/%@", theTop->currentKey != nil ? NDJSONSchemaEscapedPointerComponent(theTop->currentKey) : @""];
+		else
+			[theResult appendFormat:@"/%lu", (unsigned long)theTop->count];
+	}
+	return theResult;
+}
+
+static void NDJSONSchemaFoundViolation( NDJSONSchemaValidator * self, NDJSONParser * aParser, NDJSONSchemaErrorCode aCode, NSString * aKeyword, BOOL aCurrent, NSString * aDescription )
+{
+	if( !self->_aborted )
+	{
+		NSError		* theError = NDJSONSchemaError( aCode, aKeyword, NDJSONSchemaPointer( self, aCurrent ), aDescription );
+		[self->_errors addObject:theError];
+		if( self->_abortsOnFirstError )
+		{
+			self->_aborted = YES;
+			if( self->_delegateMethod.foundError != NULL )
+				self->_delegateMethod.foundError( self->_delegate, @selector(jsonParser:error:), aParser, theError );
+			[aParser abortParsing];
+		}
+	}
+}
+
+/*
+	schema for the next value in the current container
+ */
+static NDJSONSchema * NDJSONSchemaForNextValue( NDJSONSchemaValidator * self )
+{
+	NDJSONSchema		* theResult = nil;
+	if( self->_stack.count == 0 )
+		theResult = self->_validatesRootArrayElements ? self->_rootArraySchema : self->_schema;
+	else
+	{
+		struct NDJSONSchemaFrame	* theTop = &self->_stack.bytes[self->_stack.count-1];
+		if( theTop->isObject )
+			theResult = theTop->valueSchema;
+		else if( theTop->schema != nil )
+		{
+			if( theTop->schema->_tupleItems != nil )
+				theResult = theTop->count < theTop->schema->_tupleItems.count ? [theTop->schema->_tupleItems objectAtIndex:theTop->count] : theTop->schema->_additionalItems;
+			else
+				theResult = theTop->schema->_items;
+		}
+	}
+	return theResult;
+}
+
+/*
+	returns the schema for the value if its type is valid, otherwise nil so nothing else is checked
+ */
+static NDJSONSchema * NDJSONSchemaCheckType( NDJSONSchemaValidator * self, NDJSONParser * aParser, unsigned int aType, BOOL anIsIntegral )
+{
+	NDJSONSchema		* theResult = NDJSONSchemaForNextValue( self );
+	if( theResult != nil )
+	{
+		if( theResult->_rejectsAll )
+		{
+			if( self->_stack.count == 0 || !self->_stack.bytes[self->_stack.count-1].isObject )	// object values were reported with their key
+				NDJSONSchemaFoundViolation( self, aParser, NDJSONSchemaFalseSchemaError, @"false", YES, @"no value is allowed" );
+			theResult = nil;
+		}
+		else if( theResult->_types != 0 && (theResult->_types&aType) == 0
+				&& !(aType == kNDJSONSchemaNumberType && anIsIntegral && (theResult->_types&kNDJSONSchemaIntegerType) != 0)
+				&& !(aType == kNDJSONSchemaIntegerType && (theResult->_types&kNDJSONSchemaNumberType) != 0) )
+		{
+			NDJSONSchemaFoundViolation( self, aParser, NDJSONSchemaTypeError, @"type", YES, @"value is not of the required type" );
+			theResult = nil;
+		}
+	}
+	return theResult;
+}
+
+static void NDJSONSchemaCheckEnum( NDJSONSchemaValidator * self, NDJSONParser * aParser, NDJSONSchema * aSchema, BOOL aFound )
+{
+	if( aSchema->_hasEnum && !aFound )
+		NDJSONSchemaFoundViolation( self, aParser, NDJSONSchemaEnumError, @"enum", YES, @"value is not one of the allowed values" );
+}
+
+/*
+	an array element has been completely parsed
+ */
+static void NDJSONSchemaDidFinishValue( NDJSONSchemaValidator * self )
+{
+	if( self->_stack.count > 0 && !self->_stack.bytes[self->_stack.count-1].isObject )
+		self->_stack.bytes[self->_stack.count-1].count++;
+}
+
+static void NDJSONSchemaCheckNumber( NDJSONSchemaValidator * self, NDJSONParser * aParser, double aValue, BOOL anIsInteger )
+{
+	NDJSONSchema		* theSchema = NDJSONSchemaCheckType( self, aParser, anIsInteger ? kNDJSONSchemaIntegerType : kNDJSONSchemaNumberType, aValue == floor(aValue) );
+	if( theSchema != nil )
+	{
+		if( theSchema->_hasEnum )
+			NDJSONSchemaCheckEnum( self, aParser, theSchema, [theSchema->_enumNumbers containsObject:[NSNumber numberWithDouble:aValue]] );
+		if( theSchema->_has.minimum && aValue < theSchema->_minimum )
+			NDJSONSchemaFoundViolation( self, aParser, NDJSONSchemaRangeError, @"minimum", YES, [NSString stringWithFormat:@"%g is less than %g", aValue, theSchema->_minimum] );
+		if( theSchema->_has.exclusiveMinimum && aValue <= theSchema->_exclusiveMinimum )
+			NDJSONSchemaFoundViolation( self, aParser, NDJSONSchemaRangeError, @"exclusiveMinimum", YES, [NSString stringWithFormat:@"%g is not greater than %g", aValue, theSchema->_exclusiveMinimum] );
+		if( theSchema->_has.maximum && aValue > theSchema->_maximum )
+			NDJSONSchemaFoundViolation( self, aParser, NDJSONSchemaRangeError, @"maximum", YES, [NSString stringWithFormat:@"%g is greater than %g", aValue, theSchema->_maximum] );
+		if( theSchema->_has.exclusiveMaximum && aValue >= theSchema->_exclusiveMaximum )
+			NDJSONSchemaFoundViolation( self, aParser, NDJSONSchemaRangeError, @"exclusiveMaximum", YES, [NSString stringWithFormat:@"%g is not less than %g", aValue, theSchema->_exclusiveMaximum] );
+		if( theSchema->_has.multipleOf )
+		{
+			double		theQuotient = aValue/theSchema->_multipleOf;
+			if( fabs(theQuotient-round(theQuotient)) > 1.0e-9*fmax(1.0,fabs(theQuotient)) )
+				NDJSONSchemaFoundViolation( self, aParser, NDJSONSchemaRangeError, @"multipleOf", YES, [NSString stringWithFormat:@"%g is not a multiple of %g", aValue, theSchema->_multipleOf] );
+		}
+	}
+	NDJSONSchemaDidFinishValue( self );
+}
+
+static void NDJSONSchemaPushFrame( NDJSONSchemaValidator * self, NDJSONSchema * aSchema, BOOL anIsObject )
+{
+	struct NDJSONSchemaFrame	* theFrame = NULL;
+	if( self->_stack.count >= self->_stack.size )
+	{
+		self->_stack.size = self->_stack.size > 0 ? self->_stack.size*2 : 32;
+		self->_stack.bytes = realloc( self->_stack.bytes, self->_stack.size*sizeof(struct NDJSONSchemaFrame) );
+		NSCAssert( self->_stack.bytes != NULL, @"Memory failure" );
+	}
+	theFrame = &self->_stack.bytes[self->_stack.count];
+	memset( theFrame, 0, sizeof(*theFrame) );
+	if( self->_stack.count > 0 )
+	{
+		struct NDJSONSchemaFrame	* theParent = &self->_stack.bytes[self->_stack.count-1];
+		if( theParent->isObject )
+			theFrame->key = [theParent->currentKey retain];
+		else
+			theFrame->index = theParent->count;
+	}
+	theFrame->schema = aSchema;
+	theFrame->isObject = anIsObject;
+	if( anIsObject && aSchema != nil && aSchema->_required != nil )
+		theFrame->foundRequired = [[NSMutableSet alloc] initWithCapacity:aSchema->_required.count];
+	self->_stack.count++;
+}
+
+#pragma mark - NDJSONParserDelegate methods
+
+- (void)jsonParserDidStartDocument:(NDJSONParser *)aJSON
+{
+	while( _stack.count > 0 )
+		NDJSONSchemaPopFrame( self );
+	[_errors removeAllObjects];
+	_aborted = NO;
+	if( _delegateMethod.didStartDocument != NULL )
+		_delegateMethod.didStartDocument( _delegate, @selector(jsonParserDidStartDocument:), aJSON );
+}
+
+- (void)jsonParserDidEndDocument:(NDJSONParser *)aJSON
+{
+	if( _delegateMethod.didEndDocument != NULL )
+		_delegateMethod.didEndDocument( _delegate, @selector(jsonParserDidEndDocument:), aJSON );
+}
+
+- (void)jsonParserDidStartArray:(NDJSONParser *)aJSON
+{
+	NDJSONSchemaPushFrame( self, NDJSONSchemaCheckType( self, aJSON, kNDJSONSchemaArrayType, NO ), NO );
+	if( _delegateMethod.didStartArray != NULL )
+		_delegateMethod.didStartArray( _delegate, @selector(jsonParserDidStartArray:), aJSON );
+}
+
+- (void)jsonParserDidEndArray:(NDJSONParser *)aJSON
+{
+	if( _stack.count > 0 )
+	{
+		struct NDJSONSchemaFrame	* theFrame = &_stack.bytes[_stack.count-1];
+		if( theFrame->schema != nil && theFrame->count < theFrame->schema->_minItems )
+			NDJSONSchemaFoundViolation( self, aJSON, NDJSONSchemaSizeError, @"minItems", NO, [NSString stringWithFormat:@"fewer than %lu items", (unsigned long)theFrame->schema->_minItems] );
+		if( theFrame->schema != nil && theFrame->count > theFrame->schema->_maxItems )
+			NDJSONSchemaFoundViolation( self, aJSON, NDJSONSchemaSizeError, @"maxItems", NO, [NSString stringWithFormat:@"more than %lu items", (unsigned long)theFrame->schema->_maxItems] );
+		NDJSONSchemaPopFrame( self );
+		NDJSONSchemaDidFinishValue( self );
+	}
+	if( _delegateMethod.didEndArray != NULL )
+		_delegateMethod.didEndArray( _delegate, @selector(jsonParserDidEndArray:), aJSON );
+}
+
+- (void)jsonParserDidStartObject:(NDJSONParser *)aJSON
+{
+	NDJSONSchemaPushFrame( self, NDJSONSchemaCheckType( self, aJSON, kNDJSONSchemaObjectType, NO ), YES );
+	if( _delegateMethod.didStartObject != NULL )
+		_delegateMethod.didStartObject( _delegate, @selector(jsonParserDidStartObject:), aJSON );
+}
+
+- (void)jsonParserDidEndObject:(NDJSONParser *)aJSON
+{
+	if( _stack.count > 0 )
+	{
+		struct NDJSONSchemaFrame	* theFrame = &_stack.bytes[_stack.count-1];
+		NDJSONSchema				* theSchema = theFrame->schema;
+		if( theSchema != nil && theFrame->foundRequired.count < theSchema->_required.count )
+		{
+			for( NSString * theKey in theSchema->_required )
+			{
+				if( ![theFrame->foundRequired containsObject:theKey] )
+					NDJSONSchemaFoundViolation( self, aJSON, NDJSONSchemaRequiredError, @"required", NO, [NSString stringWithFormat:@"required property %@ is missing", theKey] );
+			}
+		}
+		if( theSchema != nil && theFrame->count < theSchema->_minProperties )
+			NDJSONSchemaFoundViolation( self, aJSON, NDJSONSchemaSizeError, @"minProperties", NO, [NSString stringWithFormat:@"fewer than %lu properties", (unsigned long)theSchema->_minProperties] );
+		if( theSchema != nil && theFrame->count > theSchema->_maxProperties )
+			NDJSONSchemaFoundViolation( self, aJSON, NDJSONSchemaSizeError, @"maxProperties", NO, [NSString stringWithFormat:@"more than %lu properties", (unsigned long)theSchema->_maxProperties] );
+		NDJSONSchemaPopFrame( self );
+		NDJSONSchemaDidFinishValue( self );
+	}
+	if( _delegateMethod.didEndObject != NULL )
+		_delegateMethod.didEndObject( _delegate, @selector(jsonParserDidEndObject:), aJSON );
+}
+
+- (NDJSONKeyTable *)jsonParserKeyTableForCurrentObject:(NDJSONParser *)aJSON
+{
+	return _delegateMethod.keyTableForCurrentObject != NULL
+			? ((NDKeyTableMethodIMP)_delegateMethod.keyTableForCurrentObject)( _delegate, @selector(jsonParserKeyTableForCurrentObject:), aJSON )
+			: nil;
+}
+
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldSkipValueForKey:(NSString *)aKey
+{
+	return _delegateMethod.shouldSkipValueForKey != NULL
+			? ((NDReturnBoolMethodIMP)_delegateMethod.shouldSkipValueForKey)( _delegate, @selector(jsonParser:shouldSkipValueForKey:), aJSON, aKey )
+			: NO;
+}
+
+/*
+	values whose schema checks the characters of strings are not decoded, so the string can be checked
+ */
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldDecodeBase64ValueForKey:(NSString *)aKey
+{
+	NDJSONSchema		* theSchema = NDJSONSchemaForNextValue( self );
+	if( theSchema != nil && (theSchema->_hasEnum || theSchema->_minLength > 0 || theSchema->_maxLength != NSUIntegerMax || theSchema->_pattern != nil) )
+		return NO;
+	return _delegateMethod.shouldDecodeBase64ValueForKey != NULL && _delegateMethod.foundData != NULL
+			? ((NDReturnBoolMethodIMP)_delegateMethod.shouldDecodeBase64ValueForKey)( _delegate, @selector(jsonParser:shouldDecodeBase64ValueForKey:), aJSON, aKey )
+			: NO;
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundKey:(NSString *)aValue
+{
+	if( _stack.count > 0 )
+	{
+		struct NDJSONSchemaFrame	* theFrame = &_stack.bytes[_stack.count-1];
+		NDJSONSchema				* theSchema = theFrame->schema;
+		[theFrame->currentKey release], theFrame->currentKey = [aValue copy];
+		theFrame->count++;
+		theFrame->valueSchema = nil;
+		if( theSchema != nil )
+		{
+			BOOL		theIsAdditional = NO;
+			if( (theFrame->valueSchema = [theSchema->_properties objectForKey:aValue]) == nil )
+			{
+				theFrame->valueSchema = theSchema->_additionalProperties;
+				theIsAdditional = YES;
+			}
+			if( theFrame->valueSchema != nil && theFrame->valueSchema->_rejectsAll )
+			{
+				if( theIsAdditional )
+					NDJSONSchemaFoundViolation( self, aJSON, NDJSONSchemaAdditionalPropertiesError, @"additionalProperties", YES, [NSString stringWithFormat:@"property %@ is not allowed", aValue] );
+				else
+					NDJSONSchemaFoundViolation( self, aJSON, NDJSONSchemaFalseSchemaError, @"false", YES, [NSString stringWithFormat:@"property %@ is not allowed", aValue] );
+			}
+			if( theFrame->foundRequired != nil && [theSchema->_required containsObject:aValue] )
+				[theFrame->foundRequired addObject:aValue];
+		}
+	}
+	if( _delegateMethod.foundKey != NULL )
+		_delegateMethod.foundKey( _delegate, @selector(jsonParser:foundKey:), aJSON, aValue );
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundString:(NSString *)aValue
+{
+	NDJSONSchema		* theSchema = NDJSONSchemaCheckType( self, aJSON, kNDJSONSchemaStringType, NO );
+	if( theSchema != nil )
+	{
+		if( theSchema->_hasEnum )
+			NDJSONSchemaCheckEnum( self, aJSON, theSchema, [theSchema->_enumStrings containsObject:aValue] );
+		if( theSchema->_minLength > 0 || theSchema->_maxLength != NSUIntegerMax )
+		{
+			NSUInteger		theLength = [aValue lengthOfBytesUsingEncoding:NSUTF32StringEncoding]/4;		// characters not UTF-16 units
+			if( theLength < theSchema->_minLength )
+				NDJSONSchemaFoundViolation( self, aJSON, NDJSONSchemaLengthError, @"minLength", YES, [NSString stringWithFormat:@"shorter than %lu characters", (unsigned long)theSchema->_minLength] );
+			if( theLength > theSchema->_maxLength )
+				NDJSONSchemaFoundViolation( self, aJSON, NDJSONSchemaLengthError, @"maxLength", YES, [NSString stringWithFormat:@"longer than %lu characters", (unsigned long)theSchema->_maxLength] );
+		}
+		if( theSchema->_pattern != nil && [theSchema->_pattern firstMatchInString:aValue options:0 range:NSMakeRange(0, aValue.length)] == nil )
+			NDJSONSchemaFoundViolation( self, aJSON, NDJSONSchemaPatternError, @"pattern", YES, [NSString stringWithFormat:@"does not match %@", theSchema->_pattern.pattern] );
+	}
+	NDJSONSchemaDidFinishValue( self );
+	if( _delegateMethod.foundString != NULL )
+		_delegateMethod.foundString( _delegate, @selector(jsonParser:foundString:), aJSON, aValue );
+}
+
+/*
+	the data was decoded from a string
+ */
+- (void)jsonParser:(NDJSONParser *)aJSON foundData:(NSData *)aValue
+{
+	NDJSONSchemaCheckType( self, aJSON, kNDJSONSchemaStringType, NO );
+	NDJSONSchemaDidFinishValue( self );
+	if( _delegateMethod.foundData != NULL )
+		_delegateMethod.foundData( _delegate, @selector(jsonParser:foundData:), aJSON, aValue );
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundInteger:(NSInteger)aValue
+{
+	NDJSONSchemaCheckNumber( self, aJSON, (double)aValue, YES );
+	if( _delegateMethod.foundNumber != NULL )
+		_delegateMethod.foundNumber( _delegate, @selector(jsonParser:foundNumber:), aJSON, [NSNumber numberWithInteger:aValue] );
+	else if( _delegateMethod.foundInteger != NULL )
+		_delegateMethod.foundInteger( _delegate, @selector(jsonParser:foundInteger:), aJSON, aValue );
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundFloat:(double)aValue
+{
+	NDJSONSchemaCheckNumber( self, aJSON, aValue, NO );
+	if( _delegateMethod.foundNumber != NULL )
+		_delegateMethod.foundNumber( _delegate, @selector(jsonParser:foundNumber:), aJSON, [NSNumber numberWithDouble:aValue] );
+	else if( _delegateMethod.foundFloat != NULL )
+		_delegateMethod.foundFloat( _delegate, @selector(jsonParser:foundFloat:), aJSON, aValue );
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundBool:(BOOL)aValue
+{
+	NDJSONSchema		* theSchema = NDJSONSchemaCheckType( self, aJSON, kNDJSONSchemaBooleanType, NO );
+	if( theSchema != nil )
+		NDJSONSchemaCheckEnum( self, aJSON, theSchema, (theSchema->_enumOthers&(aValue ? kNDJSONSchemaEnumTrue : kNDJSONSchemaEnumFalse)) != 0 );
+	NDJSONSchemaDidFinishValue( self );
+	if( _delegateMethod.foundNumber != NULL )
+		_delegateMethod.foundNumber( _delegate, @selector(jsonParser:foundNumber:), aJSON, [NSNumber numberWithBool:aValue] );
+	else if( _delegateMethod.foundBool != NULL )
+		_delegateMethod.foundBool( _delegate, @selector(jsonParser:foundBool:), aJSON, aValue );
+}
+
+- (void)jsonParserFoundNULL:(NDJSONParser *)aJSON
+{
+	NDJSONSchema		* theSchema = NDJSONSchemaCheckType( self, aJSON, kNDJSONSchemaNullType, NO );
+	if( theSchema != nil )
+		NDJSONSchemaCheckEnum( self, aJSON, theSchema, (theSchema->_enumOthers&kNDJSONSchemaEnumNull) != 0 );
+	NDJSONSchemaDidFinishValue( self );
+	if( _delegateMethod.foundNULL != NULL )
+		_delegateMethod.foundNULL( _delegate, @selector(jsonParserFoundNULL:), aJSON );
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON error:(NSError *)anError
+{
+	if( _delegateMethod.foundError != NULL )
+		_delegateMethod.foundError( _delegate, @selector(jsonParser:error:), aJSON, anError );
+}
+
+#pragma mark - private
+
+- (void)setUpRespondsTo
+{
+	NSObject		* theDelegate = self.delegate;
+	_delegateClass = object_getClass( theDelegate );
+	NDJSONGetDelegateMethods( &_delegateMethod, theDelegate );
+}
+
+@end
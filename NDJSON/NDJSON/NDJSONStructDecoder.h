@@ -0,0 +1,107 @@
+/*
+	NDJSONStructDecoder.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "NDJSONParser.h"
+
+typedef enum
+{
+	NDJSONFieldInteger,					// signed integer of size 1, 2, 4 or 8 bytes
+	NDJSONFieldUnsigned,				// unsigned integer of size 1, 2, 4 or 8 bytes
+	NDJSONFieldFloat,					// float or double, size 4 or 8, integers are also accepted
+	NDJSONFieldBool,					// BOOL or bool, size 1
+	NDJSONFieldString,					// NUL terminated char array of size bytes within the struct
+	NDJSONFieldStringPointer,			// const char * to a NUL terminated copy in the arena of the decoder
+	NDJSONFieldObject,					// nested struct described by descriptor
+	NDJSONFieldArray					// struct NDJSONFieldArrayValue, elements of elementType and size bytes each in the arena of the decoder
+}		NDJSONFieldType;
+
+struct NDJSONStructDescriptor;
+
+/**
+	A member of a C struct filled from the value for the key name of a JSON object.
+ */
+struct NDJSONFieldDescriptor
+{
+	const char								* name;
+	NDJSONFieldType							type;
+	size_t									offset,				// offsetof the member
+											size;				// sizeof the member, or of each element of an array
+	const struct NDJSONStructDescriptor		* descriptor;		// of a nested struct, or of the elements of an array of structs
+	NDJSONFieldType							elementType;		// of the elements of an array, can not be NDJSONFieldArray
+};
+
+/**
+	A C struct filled from a JSON object, keys that are not the name of a field are skipped without being parsed.
+ */
+struct NDJSONStructDescriptor
+{
+	const char								* name;
+	size_t									size;
+	const struct NDJSONFieldDescriptor		* fields;
+	NSUInteger								fieldCount;
+};
+
+/**
+	The member of a struct for a field of type NDJSONFieldArray.
+ */
+struct NDJSONFieldArrayValue
+{
+	void									* elements;
+	size_t									count;
+};
+
+#define NDJSONField(_STRUCT_,_MEMBER_,_TYPE_)								{ #_MEMBER_, _TYPE_, offsetof(_STRUCT_,_MEMBER_), sizeof(((_STRUCT_*)0)->_MEMBER_), NULL, NDJSONFieldInteger }
+#define NDJSONObjectField(_STRUCT_,_MEMBER_,_DESCRIPTOR_)					{ #_MEMBER_, NDJSONFieldObject, offsetof(_STRUCT_,_MEMBER_), sizeof(((_STRUCT_*)0)->_MEMBER_), _DESCRIPTOR_, NDJSONFieldInteger }
+#define NDJSONArrayField(_STRUCT_,_MEMBER_,_ELEMENT_TYPE_,_ELEMENT_SIZE_,_DESCRIPTOR_)		{ #_MEMBER_, NDJSONFieldArray, offsetof(_STRUCT_,_MEMBER_), _ELEMENT_SIZE_, _DESCRIPTOR_, _ELEMENT_TYPE_ }
+#define NDJSONStructDescriptorInit(_STRUCT_,_FIELDS_)						{ #_STRUCT_, sizeof(_STRUCT_), _FIELDS_, sizeof(_FIELDS_)/sizeof(*(_FIELDS_)) }
+
+/**
+	NDJSONStructDecoder fills plain C structs straight from the events of an NDJSONParser, as described by a table of field descriptors, for code that does not want Objective-C objects at all. Keys are matched with key tables, the values of keys that are not fields are skipped and strings are reported as bytes, so no NSString or NSNumber is created for UTF-8 and ASCII sources, and no runtime introspection is done. Arrays and string pointers are allocated from an arena owned by the decoder, which is reused each time a document or record is decoded, so they are only valid until then.
+
+	Decoding is strict, a value that is not of the type of its field, an integer out of the range of its field, a float with a fraction for an integer field or a string longer than its char array stops parsing with an NDJSONTypeMismatchError. A null leaves its field zero, as does a missing key. Integers above INT64_MAX are decoded exactly into 64 bit unsigned fields. A float without a fraction is accepted for an integer field up to 2^53, beyond that it is out of range as the float may not be the integer that was written.
+
+	A decoder can be reused but must only be used by one thread at a time.
+ */
+@interface NDJSONStructDecoder : NSObject <NDJSONParserDelegate>
+
+/**
+	initialize with the descriptor of the struct of the root object, returns nil if a descriptor is not valid. The descriptors must remain valid for the life of the decoder, usually they are static.
+ */
+- (id)initWithDescriptor:(const struct NDJSONStructDescriptor *)descriptor;
+
+@property(readonly,nonatomic)	const struct NDJSONStructDescriptor		* descriptor;
+
+/**
+	parse the input of parser, which must be a single object, into structure. The struct is zeroed before it is filled.
+ */
+- (BOOL)decodeJSONParser:(NDJSONParser *)parser into:(void *)structure options:(NDJSONOptionFlags)options error:(NSError **)error;
+/**
+	parse the input of parser, a JSON Lines file with NDJSONOptionJSONLines or an array of objects, calling block with each record decoded into a struct. The record and its arena memory are reused for the next record, set stop to YES to stop parsing.
+ */
+- (BOOL)decodeRecordsOfJSONParser:(NDJSONParser *)parser options:(NDJSONOptionFlags)options usingBlock:(void (^)(const void * record, BOOL * stop))block error:(NSError **)error;
+
+@end
@@ -0,0 +1,724 @@
+/*
+	NDJSONStructDecoder.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import "NDJSONStructDecoder.h"
+
+/*
+	Each open object has the struct it is filling and each open array collects its elements in a scratch buffer for its
+	depth, when the array ends the elements are copied into the arena and given to the member of the parent struct. The
+	scratch buffers and the arena are kept between documents so decoding a stream of similar messages allocates nothing
+	once they have grown large enough.
+ */
+
+static const size_t			kArenaAlignment = 16,
+							kArenaMinimumBlockSize = 4096;
+
+struct NDJSONArenaBlock
+{
+	struct NDJSONArenaBlock		* next;
+	size_t						size,
+								used;
+	uint8_t						bytes[] __attribute__((aligned(16)));
+};
+
+struct NDJSONStructLevel
+{
+	const struct NDJSONStructDescriptor		* descriptor;		// of an object, NULL for arrays
+	NDJSONKeyTable							* keyTable;
+	uint8_t									* base;				// of the struct an object fills
+	const struct NDJSONFieldDescriptor		* arrayField;		// of an array, NULL for the root array of records
+	struct NDJSONFieldArrayValue			* arrayValue;		// member given the elements when the array ends
+	size_t									count;
+};
+
+struct NDJSONStructScratch
+{
+	uint8_t									* bytes;
+	size_t									capacity;
+};
+
+@interface NDJSONStructDecoder ()
+{
+	const struct NDJSONStructDescriptor		* _descriptor;
+	CFMutableDictionaryRef					_keyTables;			// descriptor to the key table of its field names
+	struct NDJSONStructLevel				* _levels;
+	struct NDJSONStructScratch				* _scratch;			// for the array at each depth
+	NSUInteger								_levelCount,
+											_levelSize;
+	const struct NDJSONFieldDescriptor		* _currentField;	// field for the value of the current key, NULL to skip the value
+	struct NDJSONArenaBlock					* _arena;
+	uint8_t									* _structure;		// root struct, or the record
+	BOOL									_records,
+											_stopped;
+	void									(^_block)(const void *, BOOL *);
+	NSError									* _error;
+}
+@end
+
+@implementation NDJSONStructDecoder
+
+@synthesize		descriptor = _descriptor;
+
+#pragma mark - arena
+
+static void * NDJSONArenaAllocate( NDJSONStructDecoder * self, size_t aSize )
+{
+	struct NDJSONArenaBlock		* theBlock = self->_arena;
+	void						* theResult = NULL;
+	aSize = (aSize + kArenaAlignment-1) & ~(kArenaAlignment-1);
+	if( theBlock == NULL || theBlock->size-theBlock->used < aSize )
+	{
+		size_t		theSize = theBlock != NULL ? theBlock->size*2 : kArenaMinimumBlockSize;
+		while( theSize < aSize )
+			theSize <<= 1;
+		if( (theBlock = malloc( sizeof(struct NDJSONArenaBlock)+theSize )) == NULL )
+			return NULL;
+		theBlock->next = self->_arena;
+		theBlock->size = theSize;
+		theBlock->used = 0;
+		self->_arena = theBlock;
+	}
+	theResult = theBlock->bytes+theBlock->used;
+	theBlock->used += aSize;
+	return theResult;
+}
+
+/*
+	a grown arena is replaced with a single block of the same total size so the next document fits in one block
+ */
+static void NDJSONArenaReset( NDJSONStructDecoder * self )
+{
+	struct NDJSONArenaBlock		* theBlock = self->_arena;
+	if( theBlock != NULL && theBlock->next != NULL )
+	{
+		size_t		theSize = 0;
+		while( theBlock != NULL )
+		{
+			struct NDJSONArenaBlock	* theNext = theBlock->next;
+			theSize += theBlock->size;
+			free( theBlock );
+			theBlock = theNext;
+		}
+		if( (self->_arena = malloc( sizeof(struct NDJSONArenaBlock)+theSize )) != NULL )
+		{
+			self->_arena->next = NULL;
+			self->_arena->size = theSize;
+		}
+		theBlock = self->_arena;
+	}
+	if( theBlock != NULL )
+		theBlock->used = 0;
+}
+
+#pragma mark - creation and destruction
+
+static BOOL NDJSONStructValidSize( NDJSONFieldType aType, size_t aSize, const struct NDJSONStructDescriptor * aDescriptor )
+{
+	switch( aType )
+	{
+	case NDJSONFieldInteger:
+	case NDJSONFieldUnsigned:
+		return aSize == 1 || aSize == 2 || aSize == 4 || aSize == 8;
+	case NDJSONFieldFloat:
+		return aSize == sizeof(float) || aSize == sizeof(double);
+	case NDJSONFieldBool:
+		return aSize == 1;
+	case NDJSONFieldString:
+		return aSize > 0;
+	case NDJSONFieldStringPointer:
+		return aSize == sizeof(const char *);
+	case NDJSONFieldObject:
+		return aDescriptor != NULL && aSize == aDescriptor->size;
+	default:
+		return NO;
+	}
+}
+
+/*
+	checks every field of aDescriptor and the descriptors it refers to and creates the key table of each, descriptors
+	can refer to themselves through arrays
+ */
+static BOOL NDJSONStructAddDescriptor( NDJSONStructDecoder * self, const struct NDJSONStructDescriptor * aDescriptor )
+{
+	NSMutableArray		* theKeys = nil;
+	NDJSONKeyTable		* theKeyTable = nil;
+	if( CFDictionaryContainsKey( self->_keyTables, aDescriptor ) )
+		return YES;
+	theKeys = [[NSMutableArray alloc] initWithCapacity:aDescriptor->fieldCount];
+	for( NSUInteger i = 0; i < aDescriptor->fieldCount; i++ )
+	{
+		const struct NDJSONFieldDescriptor	* theField = &aDescriptor->fields[i];
+		NSString							* theKey = theField->name != NULL ? [[NSString alloc] initWithUTF8String:theField->name] : nil;
+		if( theKey == nil )
+		{
+			[theKeys release];
+			return NO;
+		}
+		[theKeys addObject:theKey];
+		[theKey release];
+	}
+	theKeyTable = [[NDJSONKeyTable alloc] initWithKeys:theKeys];
+	CFDictionarySetValue( self->_keyTables, aDescriptor, theKeyTable );
+	[theKeyTable release];
+	[theKeys release];
+
+	for( NSUInteger i = 0; i < aDescriptor->fieldCount; i++ )
+	{
+		const struct NDJSONFieldDescriptor	* theField = &aDescriptor->fields[i];
+		if( theField->type == NDJSONFieldArray )
+		{
+			if( theField->offset+sizeof(struct NDJSONFieldArrayValue) > aDescriptor->size || !NDJSONStructValidSize( theField->elementType, theField->size, theField->descriptor ) )
+				return NO;
+		}
+		else if( theField->offset+theField->size > aDescriptor->size || !NDJSONStructValidSize( theField->type, theField->size, theField->descriptor ) )
+			return NO;
+		if( theField->descriptor != NULL && (theField->type == NDJSONFieldObject || (theField->type == NDJSONFieldArray && theField->elementType == NDJSONFieldObject))
+			&& !NDJSONStructAddDescriptor( self, theField->descriptor ) )
+		{
+			return NO;
+		}
+	}
+	return YES;
+}
+
+- (id)initWithDescriptor:(const struct NDJSONStructDescriptor *)aDescriptor
+{
+	NSParameterAssert( aDescriptor != NULL );
+	if( (self = [super init]) != nil )
+	{
+		_descriptor = aDescriptor;
+		_keyTables = CFDictionaryCreateMutable( kCFAllocatorDefault, 0, NULL, &kCFTypeDictionaryValueCallBacks );
+		if( !NDJSONStructAddDescriptor( self, aDescriptor ) )
+		{
+			[self release];
+			return nil;
+		}
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	for( NSUInteger i = 0; i < _levelSize; i++ )
+		free( _scratch[i].bytes );
+	while( _arena != NULL )
+	{
+		struct NDJSONArenaBlock	* theNext = _arena->next;
+		free( _arena );
+		_arena = theNext;
+	}
+	if( _keyTables != NULL )
+		CFRelease( _keyTables );
+	free( _levels );
+	free( _scratch );
+	[_error release];
+	[super dealloc];
+}
+
+#pragma mark - decoding
+
+static BOOL NDJSONStructDecode( NDJSONStructDecoder * self, NDJSONParser * aParser, NDJSONOptionFlags anOptions, NSError ** anError )
+{
+	BOOL		theResult = NO;
+	id			theOriginalDelegate = aParser.delegate;
+	[self->_error release], self->_error = nil;
+	self->_stopped = NO;
+	aParser.delegate = self;
+	theResult = [aParser parseWithOptions:anOptions] || self->_stopped;
+	if( self->_error != nil )
+		theResult = NO;
+	if( !theResult && anError != NULL )
+		*anError = self->_error != nil ? [[self->_error retain] autorelease] : [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONBadFormatError userInfo:[NSDictionary dictionaryWithObject:@"JSON could not be parsed" forKey:NSLocalizedDescriptionKey]];
+	aParser.delegate = theOriginalDelegate;
+	return theResult;
+}
+
+- (BOOL)decodeJSONParser:(NDJSONParser *)aParser into:(void *)aStructure options:(NDJSONOptionFlags)anOptions error:(NSError **)anError
+{
+	NSParameterAssert( aStructure != NULL );
+	_structure = aStructure;
+	_records = NO;
+	memset( aStructure, 0, _descriptor->size );
+	return NDJSONStructDecode( self, aParser, anOptions, anError );
+}
+
+- (BOOL)decodeRecordsOfJSONParser:(NDJSONParser *)aParser options:(NDJSONOptionFlags)anOptions usingBlock:(void (^)(const void * record, BOOL * stop))aBlock error:(NSError **)anError
+{
+	BOOL		theResult = NO;
+	NSParameterAssert( aBlock != nil );
+	_structure = malloc( _descriptor->size > 0 ? _descriptor->size : 1 );
+	if( _structure != NULL )
+	{
+		_records = YES;
+		_block = [aBlock copy];
+		theResult = NDJSONStructDecode( self, aParser, anOptions, anError );
+		[_block release], _block = nil;
+		free( _structure );
+	}
+	_structure = NULL;
+	return theResult;
+}
+
+static void NDJSONStructFail( NDJSONStructDecoder * self, NDJSONParser * aParser, const struct NDJSONFieldDescriptor * aField, NSString * aReason )
+{
+	if( self->_error == nil )
+	{
+		NSString	* theDescription = [NSString stringWithFormat:@"%@ for %s at line %lu column %lu", aReason, aField != NULL && aField->name != NULL ? aField->name : "root", (unsigned long)aParser.lineNumber, (unsigned long)aParser.columnNumber];
+		self->_error = [[NSError alloc] initWithDomain:NDJSONErrorDomain code:NDJSONTypeMismatchError userInfo:[NSDictionary dictionaryWithObject:theDescription forKey:NSLocalizedDescriptionKey]];
+	}
+	[aParser abortParsing];
+}
+
+/*
+	where the value starting now goes and the field describing it, an element of an array is described by a field of the
+	element type, returns NULL with aField NULL for a record of the root array
+ */
+static uint8_t * NDJSONStructTargetForValue( NDJSONStructDecoder * self, NDJSONParser * aParser, const struct NDJSONFieldDescriptor ** aField, struct NDJSONFieldDescriptor * anElement )
+{
+	struct NDJSONStructLevel		* theParent = self->_levelCount > 0 ? &self->_levels[self->_levelCount-1] : NULL;
+	uint8_t							* theResult = NULL;
+	*aField = NULL;
+	if( theParent == NULL )
+		return NULL;
+	if( theParent->descriptor != NULL )
+	{
+		*aField = self->_currentField;
+		self->_currentField = NULL;
+		theResult = *aField != NULL ? theParent->base+(*aField)->offset : NULL;
+	}
+	else if( theParent->arrayField != NULL )
+	{
+		struct NDJSONStructScratch	* theScratch = &self->_scratch[self->_levelCount-1];
+		size_t						theSize = theParent->arrayField->size;
+		if( (theParent->count+1)*theSize > theScratch->capacity )
+		{
+			size_t		theCapacity = theScratch->capacity > 0 ? theScratch->capacity*2 : 16*theSize;
+			uint8_t		* theBytes = NULL;
+			while( theCapacity < (theParent->count+1)*theSize )
+				theCapacity <<= 1;
+			if( (theBytes = realloc( theScratch->bytes, theCapacity )) == NULL )
+			{
+				NDJSONStructFail( self, aParser, theParent->arrayField, @"Memory failure" );
+				return NULL;
+			}
+			theScratch->bytes = theBytes;
+			theScratch->capacity = theCapacity;
+		}
+		theResult = theScratch->bytes+theParent->count*theSize;
+		memset( theResult, 0, theSize );
+		theParent->count++;
+		anElement->name = theParent->arrayField->name;
+		anElement->type = theParent->arrayField->elementType;
+		anElement->offset = 0;
+		anElement->size = theSize;
+		anElement->descriptor = theParent->arrayField->descriptor;
+		anElement->elementType = NDJSONFieldInteger;
+		*aField = anElement;
+	}
+	return theResult;
+}
+
+static struct NDJSONStructLevel * NDJSONStructPushLevel( NDJSONStructDecoder * self, NDJSONParser * aParser )
+{
+	struct NDJSONStructLevel		* theResult = NULL;
+	if( self->_levelCount >= self->_levelSize )
+	{
+		NSUInteger					theSize = self->_levelSize > 0 ? self->_levelSize*2 : 16;
+		struct NDJSONStructLevel	* theLevels = realloc( self->_levels, theSize*sizeof(*theLevels) );
+		struct NDJSONStructScratch	* theScratch = theLevels != NULL ? realloc( self->_scratch, theSize*sizeof(*theScratch) ) : NULL;
+		if( theLevels != NULL )
+			self->_levels = theLevels;
+		if( theScratch == NULL )
+		{
+			NDJSONStructFail( self, aParser, NULL, @"Memory failure" );
+			return NULL;
+		}
+		memset( theScratch+self->_levelSize, 0, (theSize-self->_levelSize)*sizeof(*theScratch) );
+		self->_scratch = theScratch;
+		self->_levelSize = theSize;
+	}
+	theResult = &self->_levels[self->_levelCount++];
+	memset( theResult, 0, sizeof(*theResult) );
+	return theResult;
+}
+
+static void NDJSONStructSetInteger( NDJSONStructDecoder * self, NDJSONParser * aParser, const struct NDJSONFieldDescriptor * aField, uint8_t * aTarget, int64_t aValue )
+{
+	switch( aField->type )
+	{
+	case NDJSONFieldInteger:
+	{
+		int64_t		theLimit = aField->size < 8 ? (int64_t)1<<(aField->size*8-1) : 0;
+		if( theLimit != 0 && (aValue < -theLimit || aValue >= theLimit) )
+			NDJSONStructFail( self, aParser, aField, @"integer out of range" );
+		else if( aField->size == 1 )
+			*(int8_t *)aTarget = (int8_t)aValue;
+		else if( aField->size == 2 )
+		{
+			int16_t		theValue = (int16_t)aValue;
+			memcpy( aTarget, &theValue, sizeof(theValue) );
+		}
+		else if( aField->size == 4 )
+		{
+			int32_t		theValue = (int32_t)aValue;
+			memcpy( aTarget, &theValue, sizeof(theValue) );
+		}
+		else
+			memcpy( aTarget, &aValue, sizeof(aValue) );
+		break;
+	}
+	case NDJSONFieldUnsigned:
+		if( aValue < 0 || (aField->size < 8 && (uint64_t)aValue >= (uint64_t)1<<(aField->size*8)) )
+			NDJSONStructFail( self, aParser, aField, @"integer out of range" );
+		else if( aField->size == 1 )
+			*(uint8_t *)aTarget = (uint8_t)aValue;
+		else if( aField->size == 2 )
+		{
+			uint16_t	theValue = (uint16_t)aValue;
+			memcpy( aTarget, &theValue, sizeof(theValue) );
+		}
+		else if( aField->size == 4 )
+		{
+			uint32_t	theValue = (uint32_t)aValue;
+			memcpy( aTarget, &theValue, sizeof(theValue) );
+		}
+		else
+		{
+			uint64_t	theValue = (uint64_t)aValue;
+			memcpy( aTarget, &theValue, sizeof(theValue) );
+		}
+		break;
+	case NDJSONFieldFloat:
+		if( aField->size == sizeof(float) )
+		{
+			float		theValue = (float)aValue;
+			memcpy( aTarget, &theValue, sizeof(theValue) );
+		}
+		else
+		{
+			double		theValue = (double)aValue;
+			memcpy( aTarget, &theValue, sizeof(theValue) );
+		}
+		break;
+	default:
+		NDJSONStructFail( self, aParser, aField, @"unexpected number" );
+		break;
+	}
+}
+
+static void NDJSONStructFoundInteger( NDJSONStructDecoder * self, NDJSONParser * aParser, int64_t aValue )
+{
+	const struct NDJSONFieldDescriptor	* theField = NULL;
+	struct NDJSONFieldDescriptor		theElement;
+	uint8_t								* theTarget = NDJSONStructTargetForValue( self, aParser, &theField, &theElement );
+	if( theTarget != NULL )
+		NDJSONStructSetInteger( self, aParser, theField, theTarget, aValue );
+	else if( theField == NULL && self->_error == nil )
+		NDJSONStructFail( self, aParser, NULL, @"expected an object" );
+}
+
+/*
+	integers above INT64_MAX are reported exactly by jsonParser:foundUnsignedInteger:
+ */
+static void NDJSONStructFoundUnsigned( NDJSONStructDecoder * self, NDJSONParser * aParser, uint64_t aValue )
+{
+	const struct NDJSONFieldDescriptor	* theField = NULL;
+	struct NDJSONFieldDescriptor		theElement;
+	uint8_t								* theTarget = NDJSONStructTargetForValue( self, aParser, &theField, &theElement );
+	if( theTarget == NULL )
+	{
+		if( theField == NULL && self->_error == nil )
+			NDJSONStructFail( self, aParser, NULL, @"expected an object" );
+	}
+	else if( theField->type == NDJSONFieldUnsigned && theField->size == sizeof(aValue) )
+		memcpy( theTarget, &aValue, sizeof(aValue) );
+	else if( theField->type == NDJSONFieldInteger || theField->type == NDJSONFieldUnsigned )
+		NDJSONStructFail( self, aParser, theField, @"integer out of range" );
+	else if( theField->type == NDJSONFieldFloat && theField->size == sizeof(float) )
+	{
+		float		theValue = (float)aValue;
+		memcpy( theTarget, &theValue, sizeof(theValue) );
+	}
+	else if( theField->type == NDJSONFieldFloat )
+	{
+		double		theValue = (double)aValue;
+		memcpy( theTarget, &theValue, sizeof(theValue) );
+	}
+	else
+		NDJSONStructFail( self, aParser, theField, @"unexpected number" );
+}
+
+/*
+	a float without a fraction is accepted for an integer field as long as every integer up to it can be represented by a
+	double, beyond that the float may not be the integer that was written so it is out of range
+ */
+static void NDJSONStructFoundFloat( NDJSONStructDecoder * self, NDJSONParser * aParser, double aValue )
+{
+	const struct NDJSONFieldDescriptor	* theField = NULL;
+	struct NDJSONFieldDescriptor		theElement;
+	uint8_t								* theTarget = NDJSONStructTargetForValue( self, aParser, &theField, &theElement );
+	if( theTarget == NULL )
+	{
+		if( theField == NULL && self->_error == nil )
+			NDJSONStructFail( self, aParser, NULL, @"expected an object" );
+	}
+	else if( (theField->type == NDJSONFieldInteger || theField->type == NDJSONFieldUnsigned) && aValue == floor(aValue) )
+	{
+		if( aValue >= -9007199254740992.0 && aValue <= 9007199254740992.0 )
+			NDJSONStructSetInteger( self, aParser, theField, theTarget, (int64_t)aValue );
+		else
+			NDJSONStructFail( self, aParser, theField, @"integer out of range" );
+	}
+	else if( theField->type != NDJSONFieldFloat )
+		NDJSONStructFail( self, aParser, theField, theField->type == NDJSONFieldInteger || theField->type == NDJSONFieldUnsigned ? @"unexpected fraction" : @"unexpected number" );
+	else if( theField->size == sizeof(float) )
+	{
+		float		theValue = (float)aValue;
+		memcpy( theTarget, &theValue, sizeof(theValue) );
+	}
+	else
+		memcpy( theTarget, &aValue, sizeof(aValue) );
+}
+
+static void NDJSONStructFoundStringBytes( NDJSONStructDecoder * self, NDJSONParser * aParser, const uint8_t * aBytes, NSUInteger aLength )
+{
+	const struct NDJSONFieldDescriptor	* theField = NULL;
+	struct NDJSONFieldDescriptor		theElement;
+	uint8_t								* theTarget = NDJSONStructTargetForValue( self, aParser, &theField, &theElement );
+	if( theTarget == NULL )
+	{
+		if( theField == NULL && self->_error == nil )
+			NDJSONStructFail( self, aParser, NULL, @"expected an object" );
+	}
+	else if( theField->type == NDJSONFieldString )
+	{
+		if( aLength >= theField->size )
+			NDJSONStructFail( self, aParser, theField, @"string too long" );
+		else
+		{
+			memcpy( theTarget, aBytes, aLength );
+			theTarget[aLength] = '\0';
+		}
+	}
+	else if( theField->type == NDJSONFieldStringPointer )
+	{
+		char		* theString = NDJSONArenaAllocate( self, aLength+1 );
+		if( theString == NULL )
+			NDJSONStructFail( self, aParser, theField, @"Memory failure" );
+		else
+		{
+			memcpy( theString, aBytes, aLength );
+			theString[aLength] = '\0';
+			memcpy( theTarget, &theString, sizeof(theString) );
+		}
+	}
+	else
+		NDJSONStructFail( self, aParser, theField, @"unexpected string" );
+}
+
+#pragma mark - NDJSONParserDelegate methods
+
+- (void)jsonParserDidStartDocument:(NDJSONParser *)aJSON
+{
+	_levelCount = 0;
+	_currentField = NULL;
+	NDJSONArenaReset( self );
+}
+
+- (void)jsonParserDidStartArray:(NDJSONParser *)aJSON
+{
+	const struct NDJSONFieldDescriptor	* theField = NULL;
+	struct NDJSONFieldDescriptor		theElement;
+	uint8_t								* theTarget = NULL;
+	struct NDJSONStructLevel			* theLevel = NULL;
+	if( _levelCount == 0 )
+	{
+		if( !_records )
+			NDJSONStructFail( self, aJSON, NULL, @"expected an object" );
+		else
+			NDJSONStructPushLevel( self, aJSON );			// the records
+	}
+	else if( (theTarget = NDJSONStructTargetForValue( self, aJSON, &theField, &theElement )) != NULL )
+	{
+		if( theField->type != NDJSONFieldArray )
+			NDJSONStructFail( self, aJSON, theField, @"unexpected array" );
+		else if( (theLevel = NDJSONStructPushLevel( self, aJSON )) != NULL )
+		{
+			theLevel->arrayField = theField;
+			theLevel->arrayValue = (struct NDJSONFieldArrayValue *)theTarget;
+		}
+	}
+	else if( _error == nil )
+		NDJSONStructFail( self, aJSON, NULL, @"unexpected array" );
+}
+
+- (void)jsonParserDidEndArray:(NDJSONParser *)aJSON
+{
+	struct NDJSONStructLevel	* theLevel = &_levels[--_levelCount];
+	if( theLevel->arrayField != NULL )
+	{
+		struct NDJSONFieldArrayValue	theValue = { NULL, theLevel->count };
+		size_t							theLength = theLevel->count*theLevel->arrayField->size;
+		if( theLength > 0 && (theValue.elements = NDJSONArenaAllocate( self, theLength )) == NULL )
+			NDJSONStructFail( self, aJSON, theLevel->arrayField, @"Memory failure" );
+		else
+		{
+			if( theLength > 0 )
+				memcpy( theValue.elements, _scratch[_levelCount].bytes, theLength );
+			memcpy( theLevel->arrayValue, &theValue, sizeof(theValue) );
+		}
+	}
+}
+
+- (void)jsonParserDidStartObject:(NDJSONParser *)aJSON
+{
+	const struct NDJSONFieldDescriptor	* theField = NULL;
+	struct NDJSONFieldDescriptor		theElement;
+	uint8_t								* theTarget = NULL;
+	const struct NDJSONStructDescriptor	* theDescriptor = NULL;
+	struct NDJSONStructLevel			* theLevel = NULL;
+	if( _levelCount == 0 && !_records )
+	{
+		theTarget = _structure;
+		theDescriptor = _descriptor;
+	}
+	else if( _levelCount == 1 && _records )
+	{
+		theTarget = _structure;
+		theDescriptor = _descriptor;
+		memset( _structure, 0, _descriptor->size );
+		NDJSONArenaReset( self );
+	}
+	else if( (theTarget = NDJSONStructTargetForValue( self, aJSON, &theField, &theElement )) != NULL )
+	{
+		if( theField->type != NDJSONFieldObject )
+		{
+			NDJSONStructFail( self, aJSON, theField, @"unexpected object" );
+			return;
+		}
+		theDescriptor = theField->descriptor;
+	}
+	else
+	{
+		if( _error == nil )
+			NDJSONStructFail( self, aJSON, NULL, @"unexpected object" );
+		return;
+	}
+	if( (theLevel = NDJSONStructPushLevel( self, aJSON )) != NULL )
+	{
+		theLevel->descriptor = theDescriptor;
+		theLevel->keyTable = (NDJSONKeyTable *)CFDictionaryGetValue( _keyTables, theDescriptor );
+		theLevel->base = theTarget;
+	}
+}
+
+- (void)jsonParserDidEndObject:(NDJSONParser *)aJSON
+{
+	_levelCount--;
+	if( _records && _levelCount == 1 )
+	{
+		BOOL		theStop = NO;
+		_block( _structure, &theStop );
+		if( theStop )
+		{
+			_stopped = YES;
+			[aJSON abortParsing];
+		}
+	}
+}
+
+- (NDJSONKeyTable *)jsonParserKeyTableForCurrentObject:(NDJSONParser *)aJSON
+{
+	return _levelCount > 0 ? _levels[_levelCount-1].keyTable : nil;
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundKey:(NSString *)aValue
+{
+	struct NDJSONStructLevel	* theLevel = &_levels[_levelCount-1];
+	NSUInteger					theIndex = aJSON.currentKeyTable == theLevel->keyTable ? aJSON.currentKeyIndex : NSNotFound;
+	_currentField = NULL;
+	if( theIndex != NSNotFound )
+		_currentField = &theLevel->descriptor->fields[theIndex];
+	else
+	{
+		const char		* theKey = [aValue UTF8String];				// only keys that are not fields or in wider encodings get here
+		for( NSUInteger i = 0; i < theLevel->descriptor->fieldCount && _currentField == NULL; i++ )
+		{
+			if( strcmp( theLevel->descriptor->fields[i].name, theKey ) == 0 )
+				_currentField = &theLevel->descriptor->fields[i];
+		}
+	}
+}
+
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldSkipValueForKey:(NSString *)aKey { return _currentField == NULL; }
+
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldSkipValueForKeyNotInKeyTable:(NDJSONKeyTable *)aKeyTable
+{
+	BOOL		theResult = _levelCount > 0 && aKeyTable == _levels[_levelCount-1].keyTable;		// every field is in the table, so the key is not a field
+	if( theResult )
+		_currentField = NULL;
+	return theResult;
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundStringBytes:(const uint8_t *)aBytes length:(NSUInteger)aLength { NDJSONStructFoundStringBytes( self, aJSON, aBytes, aLength ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundString:(NSString *)aValue
+{
+	const char		* theBytes = [aValue UTF8String];
+	NDJSONStructFoundStringBytes( self, aJSON, (const uint8_t *)theBytes, strlen(theBytes) );
+}
+- (void)jsonParser:(NDJSONParser *)aJSON foundInteger:(NSInteger)aValue { NDJSONStructFoundInteger( self, aJSON, aValue ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundUnsignedInteger:(unsigned long long)aValue { NDJSONStructFoundUnsigned( self, aJSON, aValue ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundFloat:(double)aValue { NDJSONStructFoundFloat( self, aJSON, aValue ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundBool:(BOOL)aValue
+{
+	const struct NDJSONFieldDescriptor	* theField = NULL;
+	struct NDJSONFieldDescriptor		theElement;
+	uint8_t								* theTarget = NDJSONStructTargetForValue( self, aJSON, &theField, &theElement );
+	if( theTarget == NULL )
+	{
+		if( theField == NULL && _error == nil )
+			NDJSONStructFail( self, aJSON, NULL, @"expected an object" );
+	}
+	else if( theField->type != NDJSONFieldBool )
+		NDJSONStructFail( self, aJSON, theField, @"unexpected boolean" );
+	else
+		*theTarget = aValue ? 1 : 0;
+}
+- (void)jsonParserFoundNULL:(NDJSONParser *)aJSON
+{
+	const struct NDJSONFieldDescriptor	* theField = NULL;
+	struct NDJSONFieldDescriptor		theElement;
+	if( NDJSONStructTargetForValue( self, aJSON, &theField, &theElement ) == NULL && theField == NULL && _error == nil )
+		NDJSONStructFail( self, aJSON, NULL, @"expected an object" );
+}
+
+- (void)jsonParser:(NDJSONParser *)aJSON error:(NSError *)anError
+{
+	if( _error == nil )
+		_error = [anError retain];
+}
+
+@end
@@ -0,0 +1,68 @@
+/*
+	NDJSONTapeParser.h
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import <Foundation/Foundation.h>
+#import "NDJSONParser.h"
+
+/**
+	NDJSONTapeParser replays a JSON document that has already been parsed into a tape, a compact binary record of the parser events with strings in a shared string table and numbers stored natively. Replaying a tape sends the delegate the same messages as parsing the original JSON, so it can be given to -[NDJSONDeserializer objectForJSON:options:error:] to create property lists or custom classes, but there is nothing to scan. Tape files are memory mapped, only the pages that are replayed are read, and values the delegate skips with jsonParser:shouldSkipValueForKey: are jumped over. Strings the delegate asks for with jsonParser:shouldDecodeBase64ValueForKey: are decoded from the string table and sent with jsonParser:foundData:.
+
+	Tapes record the size, modification date and a hash of the JSON file they were created from so a stale tape can be detected, parserWithContentsOfFile:encoding:options:tapeFile: uses a tape if it is current and otherwise creates it.
+
+	Tapes are written in the native byte order and are not meant to be moved between machines.
+ */
+@interface NDJSONTapeParser : NDJSONParser
+
+/**
+	parses the input of parser with the given options into a tape, returns nil if the JSON could not be parsed.
+ */
++ (NSData *)tapeDataForJSONParser:(NDJSONParser *)parser options:(NDJSONOptionFlags)options error:(NSError **)error;
+/**
+	parses the JSON file at path and writes its tape to tapePath, along with the size, modification date and hash of the JSON file.
+ */
++ (BOOL)writeTapeFile:(NSString *)tapePath forContentsOfFile:(NSString *)path encoding:(NSStringEncoding)encoding options:(NDJSONOptionFlags)options error:(NSError **)error;
+/**
+	returns a tape parser for tapePath if it is current for the JSON file at path, checking the options, the size and modification date and the hash of the file, otherwise the tape is written first. The file is read to hash it, which is still much faster than parsing it. If the tape can not be written an ordinary NDJSONParser for path is returned.
+ */
++ (NDJSONParser *)parserWithContentsOfFile:(NSString *)path encoding:(NSStringEncoding)encoding options:(NDJSONOptionFlags)options tapeFile:(NSString *)tapePath;
+
+/**
+	initialize with the bytes of a tape, returns nil if data is not a tape.
+ */
+- (id)initWithTapeData:(NSData *)data error:(NSError **)error;
+/**
+	initialize with a tape file, the file is memory mapped.
+ */
+- (id)initWithContentsOfTapeFile:(NSString *)path error:(NSError **)error;
+
+@property(readonly,nonatomic)	NSData			* tapeData;
+
+/**
+	Whether the tape was created from the JSON file at path with the same options, the size and modification date of the file are compared and if verifyHash is YES the file is also read to compare its hash.
+ */
+- (BOOL)isCurrentForContentsOfFile:(NSString *)path options:(NDJSONOptionFlags)options verifyingHash:(BOOL)verifyHash;
+
+@end
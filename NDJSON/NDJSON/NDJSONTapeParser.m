@@ -0,0 +1,646 @@
+/*
+	NDJSONTapeParser.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+#import "NDJSONTapeParser.h"
+#import "NDJSONParserPrivate.h"
+
+/*
+	A tape is a header followed by the tape words and then the string table.
+
+	Each word has a tag in its top byte and a 56 bit payload, containers are a start and end word where the payload of the
+	start is the index of the end so a container can be skipped without looking at its contents, integers and floats are
+	a tag word followed by the value in the next word, keys and strings are the offset of the string in the string table.
+	Strings in the string table are a 32 bit length followed by the UTF-8 bytes, each distinct string is stored once.
+ */
+
+static const uint32_t		kNDJSONTapeMagic = 0x4E444A54;			// NDJT
+static const uint16_t		kNDJSONTapeVersion = 2;
+static const uint64_t		kNDJSONTapePayloadMask = (1ull<<56)-1;
+
+enum NDJSONTapeTag
+{
+	kNDJSONTapeArrayStart = '[',
+	kNDJSONTapeArrayEnd = ']',
+	kNDJSONTapeObjectStart = '{',
+	kNDJSONTapeObjectEnd = '}',
+	kNDJSONTapeKey = 'k',
+	kNDJSONTapeString = 's',
+	kNDJSONTapeInteger = 'i',
+	kNDJSONTapeFloat = 'd',
+	kNDJSONTapeTrue = 't',
+	kNDJSONTapeFalse = 'f',
+	kNDJSONTapeNull = 'n'
+};
+
+struct NDJSONTapeHeader
+{
+	uint32_t		magic;
+	uint16_t		version;
+	uint16_t		reserved;
+	uint64_t		options;						// NDJSONOptionFlags the JSON was parsed with
+	uint64_t		sourceSize;
+	int64_t			sourceModificationTime;			// microseconds since 1970
+	uint64_t		sourceHash;						// FNV-1a of the source bytes
+	uint64_t		wordCount;
+	uint64_t		stringTableLength;
+};
+
+static inline uint64_t NDJSONTapeWord( enum NDJSONTapeTag aTag, uint64_t aPayload ) { return ((uint64_t)aTag<<56) | (aPayload&kNDJSONTapePayloadMask); }
+
+static uint64_t NDJSONTapeHash( const uint8_t * aBytes, NSUInteger aLength )
+{
+	uint64_t		theResult = 0xcbf29ce484222325ull;
+	for( NSUInteger i = 0; i < aLength; i++ )
+	{
+		theResult ^= aBytes[i];
+		theResult *= 0x100000001b3ull;
+	}
+	return theResult;
+}
+
+static NSError * NDJSONTapeError( NDJSONErrorCode aCode, NSString * aDescription )
+{
+	return [NSError errorWithDomain:NDJSONErrorDomain code:aCode userInfo:[NSDictionary dictionaryWithObject:aDescription forKey:NSLocalizedDescriptionKey]];
+}
+
+/*
+	size and modification date of a file, returns NO if the file does not exist
+ */
+static BOOL NDJSONTapeSourceAttributes( NSString * aPath, uint64_t * aSize, int64_t * aModificationTime, NSError ** anError )
+{
+	NSDictionary	* theAttributes = [[NSFileManager defaultManager] attributesOfItemAtPath:aPath error:anError];
+	if( theAttributes == nil )
+		return NO;
+	*aSize = [theAttributes fileSize];
+	*aModificationTime = (int64_t)llround( [[theAttributes fileModificationDate] timeIntervalSince1970]*1.0e6 );
+	return YES;
+}
+
+#pragma mark - NDJSONTapeWriter
+
+/*
+	records the events of a parser
+ */
+@interface NDJSONTapeWriter : NSObject <NDJSONParserDelegate>
+{
+@package
+	NSMutableData				* _words;
+	NSMutableData				* _strings;
+	NSMutableDictionary			* _stringOffsets;
+	struct
+	{
+		NSUInteger					size,
+									count;
+		uint64_t					* bytes;				// word index of each open container
+	}							_containers;
+	NSError						* _error;
+}
+
+- (NSData *)tapeDataWithOptions:(NDJSONOptionFlags)options sourceSize:(uint64_t)size modificationTime:(int64_t)modificationTime hash:(uint64_t)hash;
+
+@end
+
+@implementation NDJSONTapeWriter
+
+- (id)init
+{
+	if( (self = [super init]) != nil )
+	{
+		_words = [[NSMutableData alloc] initWithCapacity:4096];
+		_strings = [[NSMutableData alloc] initWithCapacity:4096];
+		_stringOffsets = [[NSMutableDictionary alloc] init];
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[_words release];
+	[_strings release];
+	[_stringOffsets release];
+	[_error release];
+	free( _containers.bytes );
+	[super dealloc];
+}
+
+static void NDJSONTapeWriterAppend( NDJSONTapeWriter * self, uint64_t aWord )
+{
+	[self->_words appendBytes:&aWord length:sizeof(aWord)];
+}
+
+static void NDJSONTapeWriterAppendString( NDJSONTapeWriter * self, enum NDJSONTapeTag aTag, NSString * aValue )
+{
+	NSNumber		* theOffset = [self->_stringOffsets objectForKey:aValue];
+	if( theOffset == nil )
+	{
+		NSData		* theBytes = [aValue dataUsingEncoding:NSUTF8StringEncoding];
+		uint32_t	theLength = (uint32_t)theBytes.length;
+		theOffset = [NSNumber numberWithUnsignedLongLong:self->_strings.length];
+		[self->_strings appendBytes:&theLength length:sizeof(theLength)];
+		[self->_strings appendData:theBytes];
+		[self->_stringOffsets setObject:theOffset forKey:aValue];
+	}
+	NDJSONTapeWriterAppend( self, NDJSONTapeWord( aTag, [theOffset unsignedLongLongValue] ) );
+}
+
+static void NDJSONTapeWriterStartContainer( NDJSONTapeWriter * self, enum NDJSONTapeTag aTag )
+{
+	if( self->_containers.count >= self->_containers.size )
+	{
+		self->_containers.size = self->_containers.size > 0 ? self->_containers.size*2 : 64;
+		self->_containers.bytes = realloc( self->_containers.bytes, self->_containers.size*sizeof(uint64_t) );
+		NSCAssert( self->_containers.bytes != NULL, @"Memory failure" );
+	}
+	self->_containers.bytes[self->_containers.count++] = self->_words.length/sizeof(uint64_t);
+	NDJSONTapeWriterAppend( self, NDJSONTapeWord( aTag, 0 ) );
+}
+
+static void NDJSONTapeWriterEndContainer( NDJSONTapeWriter * self, enum NDJSONTapeTag aStartTag, enum NDJSONTapeTag anEndTag )
+{
+	uint64_t		theStart = self->_containers.bytes[--self->_containers.count],
+					theEnd = self->_words.length/sizeof(uint64_t);
+	((uint64_t*)self->_words.mutableBytes)[theStart] = NDJSONTapeWord( aStartTag, theEnd );
+	NDJSONTapeWriterAppend( self, NDJSONTapeWord( anEndTag, theStart ) );
+}
+
+- (NSData *)tapeDataWithOptions:(NDJSONOptionFlags)anOptions sourceSize:(uint64_t)aSize modificationTime:(int64_t)aModificationTime hash:(uint64_t)aHash
+{
+	struct NDJSONTapeHeader		theHeader;
+	NSMutableData				* theResult = [NSMutableData dataWithCapacity:sizeof(theHeader)+_words.length+_strings.length];
+	memset( &theHeader, 0, sizeof(theHeader) );
+	theHeader.magic = kNDJSONTapeMagic;
+	theHeader.version = kNDJSONTapeVersion;
+	theHeader.options = (uint64_t)anOptions;
+	theHeader.sourceSize = aSize;
+	theHeader.sourceModificationTime = aModificationTime;
+	theHeader.sourceHash = aHash;
+	theHeader.wordCount = _words.length/sizeof(uint64_t);
+	theHeader.stringTableLength = _strings.length;
+	[theResult appendBytes:&theHeader length:sizeof(theHeader)];
+	[theResult appendData:_words];
+	[theResult appendData:_strings];
+	return theResult;
+}
+
+#pragma mark - NDJSONParserDelegate methods
+
+- (void)jsonParserDidStartArray:(NDJSONParser *)aJSON { NDJSONTapeWriterStartContainer( self, kNDJSONTapeArrayStart ); }
+- (void)jsonParserDidEndArray:(NDJSONParser *)aJSON { NDJSONTapeWriterEndContainer( self, kNDJSONTapeArrayStart, kNDJSONTapeArrayEnd ); }
+- (void)jsonParserDidStartObject:(NDJSONParser *)aJSON { NDJSONTapeWriterStartContainer( self, kNDJSONTapeObjectStart ); }
+- (void)jsonParserDidEndObject:(NDJSONParser *)aJSON { NDJSONTapeWriterEndContainer( self, kNDJSONTapeObjectStart, kNDJSONTapeObjectEnd ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundKey:(NSString *)aValue { NDJSONTapeWriterAppendString( self, kNDJSONTapeKey, aValue ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundString:(NSString *)aValue { NDJSONTapeWriterAppendString( self, kNDJSONTapeString, aValue ); }
+- (void)jsonParser:(NDJSONParser *)aJSON foundInteger:(NSInteger)aValue
+{
+	NDJSONTapeWriterAppend( self, NDJSONTapeWord( kNDJSONTapeInteger, 0 ) );
+	NDJSONTapeWriterAppend( self, (uint64_t)(int64_t)aValue );
+}
+- (void)jsonParser:(NDJSONParser *)aJSON foundFloat:(double)aValue
+{
+	uint64_t	theBits;
+	memcpy( &theBits, &aValue, sizeof(theBits) );
+	NDJSONTapeWriterAppend( self, NDJSONTapeWord( kNDJSONTapeFloat, 0 ) );
+	NDJSONTapeWriterAppend( self, theBits );
+}
+- (void)jsonParser:(NDJSONParser *)aJSON foundBool:(BOOL)aValue { NDJSONTapeWriterAppend( self, NDJSONTapeWord( aValue ? kNDJSONTapeTrue : kNDJSONTapeFalse, 0 ) ); }
+- (void)jsonParserFoundNULL:(NDJSONParser *)aJSON { NDJSONTapeWriterAppend( self, NDJSONTapeWord( kNDJSONTapeNull, 0 ) ); }
+- (void)jsonParser:(NDJSONParser *)aJSON error:(NSError *)anError
+{
+	if( _error == nil )
+		_error = [anError retain];
+}
+
+@end
+
+#pragma mark - NDJSONTapeParser
+
+@interface NDJSONTapeParser ()
+{
+	NSData							* _tapeData;
+	const struct NDJSONTapeHeader	* _header;
+	const uint64_t					* _words;
+	const uint8_t					* _strings;
+	NSString						* _tapeCurrentKey;
+	NSUInteger						_tapeCurrentKeyIndex;
+	NDJSONKeyTable					* _tapeCurrentKeyTable;
+	CFMutableDictionaryRef			_keyStrings;				// string table offset to NSString for keys not in a key table
+	BOOL							_tapeAbort;
+	struct
+	{
+		NSUInteger						size,
+										count;
+		NDJSONKeyTable					** bytes;				// key table of each open object, nil for arrays
+	}								_keyTables;
+	struct NDJSONDelegateMethods	_delegateMethod;
+}
+
++ (NSData *)tapeDataForJSONParser:(NDJSONParser *)parser options:(NDJSONOptionFlags)options sourceSize:(uint64_t)size modificationTime:(int64_t)modificationTime hash:(uint64_t)hash error:(NSError **)error;
+- (void)setUpTapeRespondsTo;
+
+@end
+
+@implementation NDJSONTapeParser
+
+@synthesize		tapeData = _tapeData;
+
+- (NSString *)currentKey { return _tapeCurrentKey; }
+- (NSUInteger)currentKeyIndex { return _tapeCurrentKeyIndex; }
+- (NDJSONKeyTable *)currentKeyTable { return _tapeCurrentKeyTable; }
+
+#pragma mark - creating tapes
+
++ (NSData *)tapeDataForJSONParser:(NDJSONParser *)aParser options:(NDJSONOptionFlags)anOptions error:(NSError **)anError
+{
+	return [self tapeDataForJSONParser:aParser options:anOptions sourceSize:0 modificationTime:0 hash:0 error:anError];
+}
+
++ (NSData *)tapeDataForJSONParser:(NDJSONParser *)aParser options:(NDJSONOptionFlags)anOptions sourceSize:(uint64_t)aSize modificationTime:(int64_t)aModificationTime hash:(uint64_t)aHash error:(NSError **)anError
+{
+	NSData					* theResult = nil;
+	NDJSONTapeWriter		* theWriter = [[NDJSONTapeWriter alloc] init];
+	id						theOriginalDelegate = aParser.delegate;
+	aParser.delegate = theWriter;
+	if( [aParser parseWithOptions:anOptions] && theWriter->_error == nil )
+		theResult = [theWriter tapeDataWithOptions:anOptions sourceSize:aSize modificationTime:aModificationTime hash:aHash];
+	else if( anError != NULL )
+		*anError = theWriter->_error != nil ? [[theWriter->_error retain] autorelease] : NDJSONTapeError( NDJSONBadFormatError, @"JSON could not be parsed" );
+	aParser.delegate = theOriginalDelegate;
+	[theWriter release];
+	return theResult;
+}
+
++ (BOOL)writeTapeFile:(NSString *)aTapePath forContentsOfFile:(NSString *)aPath encoding:(NSStringEncoding)anEncoding options:(NDJSONOptionFlags)anOptions error:(NSError **)anError
+{
+	BOOL			theResult = NO;
+	uint64_t		theSize = 0;
+	int64_t			theModificationTime = 0;
+	if( NDJSONTapeSourceAttributes( aPath, &theSize, &theModificationTime, anError ) )
+	{
+		NSData			* theSource = [[NSData alloc] initWithContentsOfFile:aPath options:NSDataReadingMappedIfSafe error:anError];
+		if( theSource != nil )
+		{
+			NDJSONParser	* theParser = [[NDJSONParser alloc] initWithJSONData:theSource encoding:anEncoding];
+			NSData			* theTape = [self tapeDataForJSONParser:theParser options:anOptions sourceSize:theSize modificationTime:theModificationTime hash:NDJSONTapeHash( theSource.bytes, theSource.length ) error:anError];
+			theResult = theTape != nil && [theTape writeToFile:aTapePath options:NSDataWritingAtomic error:anError];
+			[theParser release];
+			[theSource release];
+		}
+	}
+	return theResult;
+}
+
++ (NDJSONParser *)parserWithContentsOfFile:(NSString *)aPath encoding:(NSStringEncoding)anEncoding options:(NDJSONOptionFlags)anOptions tapeFile:(NSString *)aTapePath
+{
+	NDJSONParser		* theResult = [[self alloc] initWithContentsOfTapeFile:aTapePath error:NULL];
+	if( theResult != nil && ![(NDJSONTapeParser*)theResult isCurrentForContentsOfFile:aPath options:anOptions verifyingHash:YES] )
+		[theResult release], theResult = nil;
+	if( theResult == nil && [self writeTapeFile:aTapePath forContentsOfFile:aPath encoding:anEncoding options:anOptions error:NULL] )
+		theResult = [[self alloc] initWithContentsOfTapeFile:aTapePath error:NULL];
+	if( theResult == nil )
+		theResult = [[NDJSONParser alloc] initWithContentsOfFile:aPath encoding:anEncoding];
+	return [theResult autorelease];
+}
+
+#pragma mark - creation and destruction
+
+- (id)initWithTapeData:(NSData *)aData error:(NSError **)anError
+{
+	if( (self = [super init]) != nil )
+	{
+		const struct NDJSONTapeHeader	* theHeader = (const struct NDJSONTapeHeader *)aData.bytes;
+		NSUInteger						theLength = aData.length;
+		if( theLength < sizeof(*theHeader) || theHeader->magic != kNDJSONTapeMagic || theHeader->version != kNDJSONTapeVersion
+			|| theHeader->wordCount > (theLength-sizeof(*theHeader))/sizeof(uint64_t)
+			|| theHeader->stringTableLength != theLength-sizeof(*theHeader)-theHeader->wordCount*sizeof(uint64_t) )
+		{
+			if( anError != NULL )
+				*anError = NDJSONTapeError( NDJSONBadFormatError, @"not a JSON tape" );
+			[self release];
+			return nil;
+		}
+		_tapeData = [aData retain];
+		_header = theHeader;
+		_words = (const uint64_t *)(theHeader+1);
+		_strings = (const uint8_t *)(_words+theHeader->wordCount);
+		_tapeCurrentKeyIndex = NSNotFound;
+	}
+	return self;
+}
+
+- (id)initWithContentsOfTapeFile:(NSString *)aPath error:(NSError **)anError
+{
+	NSData		* theData = [[NSData alloc] initWithContentsOfFile:aPath options:NSDataReadingMappedAlways error:anError];
+	if( theData != nil )
+	{
+		self = [self initWithTapeData:theData error:anError];
+		[theData release];
+	}
+	else
+	{
+		[self release];
+		self = nil;
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	[_tapeData release];
+	[_tapeCurrentKey release];
+	free( _keyTables.bytes );
+	[super dealloc];
+}
+
+#pragma mark - validation
+
+- (BOOL)isCurrentForContentsOfFile:(NSString *)aPath options:(NDJSONOptionFlags)anOptions verifyingHash:(BOOL)aVerifyHash
+{
+	BOOL			theResult = NO;
+	uint64_t		theSize = 0;
+	int64_t			theModificationTime = 0;
+	if( NDJSONTapeSourceAttributes( aPath, &theSize, &theModificationTime, NULL ) )
+	{
+		theResult = _header->options == (uint64_t)anOptions
+				&& _header->sourceSize == theSize
+				&& _header->sourceModificationTime == theModificationTime;
+		if( theResult && aVerifyHash )
+		{
+			NSData		* theSource = [[NSData alloc] initWithContentsOfFile:aPath options:NSDataReadingMappedIfSafe error:NULL];
+			theResult = theSource != nil && theSource.length == theSize && NDJSONTapeHash( theSource.bytes, theSource.length ) == _header->sourceHash;
+			[theSource release];
+		}
+	}
+	return theResult;
+}
+
+#pragma mark - replaying
+
+static BOOL NDJSONTapeGetString( NDJSONTapeParser * self, uint64_t anOffset, const uint8_t ** aBytes, uint32_t * aLength )
+{
+	uint64_t		theTableLength = self->_header->stringTableLength;
+	if( anOffset > theTableLength || theTableLength-anOffset < sizeof(uint32_t) )
+		return NO;
+	memcpy( aLength, self->_strings+anOffset, sizeof(uint32_t) );
+	if( *aLength > theTableLength-anOffset-sizeof(uint32_t) )
+		return NO;
+	*aBytes = self->_strings+anOffset+sizeof(uint32_t);
+	return YES;
+}
+
+/*
+	index of the word after the value starting at anIndex
+ */
+static uint64_t NDJSONTapeIndexAfterValue( NDJSONTapeParser * self, uint64_t anIndex )
+{
+	switch( self->_words[anIndex]>>56 )
+	{
+	case kNDJSONTapeArrayStart:
+	case kNDJSONTapeObjectStart:
+		return (self->_words[anIndex]&kNDJSONTapePayloadMask) > anIndex ? (self->_words[anIndex]&kNDJSONTapePayloadMask)+1 : UINT64_MAX;
+	case kNDJSONTapeInteger:
+	case kNDJSONTapeFloat:
+		return anIndex+2;
+	default:
+		return anIndex+1;
+	}
+}
+
+static void NDJSONTapePushKeyTable( NDJSONTapeParser * self, NDJSONKeyTable * aKeyTable )
+{
+	if( self->_keyTables.count >= self->_keyTables.size )
+	{
+		self->_keyTables.size = self->_keyTables.size > 0 ? self->_keyTables.size*2 : 64;
+		self->_keyTables.bytes = realloc( self->_keyTables.bytes, self->_keyTables.size*sizeof(NDJSONKeyTable*) );
+		NSCAssert( self->_keyTables.bytes != NULL, @"Memory failure" );
+	}
+	self->_keyTables.bytes[self->_keyTables.count++] = aKeyTable;
+}
+
+static void NDJSONTapeSetCurrentKey( NDJSONTapeParser * self, NSString * aKey, NSUInteger anIndex, NDJSONKeyTable * aKeyTable )
+{
+	if( aKey != self->_tapeCurrentKey )
+	{
+		[self->_tapeCurrentKey release];
+		self->_tapeCurrentKey = [aKey retain];
+	}
+	self->_tapeCurrentKeyIndex = anIndex;
+	self->_tapeCurrentKeyTable = aKeyTable;
+}
+
+/*
+	keys not found in a key table are created once for each distinct key
+ */
+static NSString * NDJSONTapeKeyString( NDJSONTapeParser * self, uint64_t anOffset, const uint8_t * aBytes, uint32_t aLength )
+{
+	NSString		* theResult = (NSString *)CFDictionaryGetValue( self->_keyStrings, (const void *)(uintptr_t)anOffset );
+	if( theResult == nil )
+	{
+		theResult = [[NSString alloc] initWithBytes:aBytes length:aLength encoding:NSUTF8StringEncoding];
+		CFDictionarySetValue( self->_keyStrings, (const void *)(uintptr_t)anOffset, theResult );
+		[theResult release];
+	}
+	return theResult;
+}
+
+static BOOL NDJSONTapeReplay( NDJSONTapeParser * self )
+{
+	const uint64_t		* theWords = self->_words;
+	uint64_t			theCount = self->_header->wordCount,
+						i = 0;
+	while( i < theCount && !self->_tapeAbort )
+	{
+		uint64_t			thePayload = theWords[i]&kNDJSONTapePayloadMask;
+		const uint8_t		* theBytes = NULL;
+		uint32_t			theLength = 0;
+		switch( theWords[i]>>56 )
+		{
+		case kNDJSONTapeArrayStart:
+			if( thePayload <= i || thePayload >= theCount )
+				return NO;
+			NDJSONTapePushKeyTable( self, nil );
+			if( self->_delegateMethod.didStartArray != NULL )
+				((NDVoidMethodIMP)self->_delegateMethod.didStartArray)( self.delegate, @selector(jsonParserDidStartArray:), self );
+			i++;
+			break;
+		case kNDJSONTapeArrayEnd:
+			if( self->_keyTables.count == 0 )
+				return NO;
+			self->_keyTables.count--;
+			if( self->_delegateMethod.didEndArray != NULL )
+				((NDVoidMethodIMP)self->_delegateMethod.didEndArray)( self.delegate, @selector(jsonParserDidEndArray:), self );
+			i++;
+			break;
+		case kNDJSONTapeObjectStart:
+		{
+			NDJSONKeyTable		* theKeyTable = nil;
+			if( thePayload <= i || thePayload >= theCount )
+				return NO;
+			if( self->_delegateMethod.didStartObject != NULL )
+				((NDVoidMethodIMP)self->_delegateMethod.didStartObject)( self.delegate, @selector(jsonParserDidStartObject:), self );
+			if( self->_delegateMethod.keyTableForCurrentObject != NULL )
+				theKeyTable = ((NDKeyTableMethodIMP)self->_delegateMethod.keyTableForCurrentObject)( self.delegate, @selector(jsonParserKeyTableForCurrentObject:), self );
+			NDJSONTapePushKeyTable( self, theKeyTable );
+			i++;
+			break;
+		}
+		case kNDJSONTapeObjectEnd:
+			if( self->_keyTables.count == 0 )
+				return NO;
+			self->_keyTables.count--;
+			if( self->_delegateMethod.didEndObject != NULL )
+				((NDVoidMethodIMP)self->_delegateMethod.didEndObject)( self.delegate, @selector(jsonParserDidEndObject:), self );
+			i++;
+			break;
+		case kNDJSONTapeKey:
+		{
+			NDJSONKeyTable		* theKeyTable = self->_keyTables.count > 0 ? self->_keyTables.bytes[self->_keyTables.count-1] : nil;
+			NSUInteger			theKeyIndex = NSNotFound;
+			BOOL				theSkip = NO;
+			if( !NDJSONTapeGetString( self, thePayload, &theBytes, &theLength ) || i+1 >= theCount )
+				return NO;
+			if( theKeyTable != nil )
+				theKeyIndex = [theKeyTable indexForKeyBytes:theBytes length:theLength];
+			if( theKeyIndex != NSNotFound )
+				NDJSONTapeSetCurrentKey( self, [theKeyTable keyAtIndex:theKeyIndex], theKeyIndex, theKeyTable );
+			else
+				NDJSONTapeSetCurrentKey( self, NDJSONTapeKeyString( self, thePayload, theBytes, theLength ), NSNotFound, theKeyTable );
+			if( self->_delegateMethod.foundKey != NULL )
+				((NDObjectMethodIMP)self->_delegateMethod.foundKey)( self.delegate, @selector(jsonParser:foundKey:), self, self->_tapeCurrentKey );
+			if( self->_delegateMethod.shouldSkipValueForKey != NULL )
+				theSkip = ((NDReturnBoolMethodIMP)self->_delegateMethod.shouldSkipValueForKey)( self.delegate, @selector(jsonParser:shouldSkipValueForKey:), self, self->_tapeCurrentKey );
+			if( theSkip )
+				i = NDJSONTapeIndexAfterValue( self, i+1 );
+			else if( (theWords[i+1]>>56) == kNDJSONTapeString && self->_delegateMethod.shouldDecodeBase64ValueForKey != NULL && self->_delegateMethod.foundData != NULL
+					&& ((NDReturnBoolMethodIMP)self->_delegateMethod.shouldDecodeBase64ValueForKey)( self.delegate, @selector(jsonParser:shouldDecodeBase64ValueForKey:), self, self->_tapeCurrentKey ) )
+			{
+				NSData		* theValue = nil;
+				if( !NDJSONTapeGetString( self, theWords[i+1]&kNDJSONTapePayloadMask, &theBytes, &theLength ) )
+					return NO;
+				if( (theValue = NDJSONCreateDataFromBase64Bytes( theBytes, theLength )) != nil )
+					((NDObjectMethodIMP)self->_delegateMethod.foundData)( self.delegate, @selector(jsonParser:foundData:), self, theValue );
+				else if( self->_delegateMethod.foundError != NULL )
+					((NDObjectMethodIMP)self->_delegateMethod.foundError)( self.delegate, @selector(jsonParser:error:), self, NDJSONTapeError( NDJSONBadBase64Error, @"Bad base64 data" ) );
+				[theValue release];
+				i += 2;
+			}
+			else
+				i++;
+			break;
+		}
+		case kNDJSONTapeString:
+		{
+			NSString		* theValue = nil;
+			if( !NDJSONTapeGetString( self, thePayload, &theBytes, &theLength ) )
+				return NO;
+			theValue = [[NSString alloc] initWithBytes:theBytes length:theLength encoding:NSUTF8StringEncoding];
+			if( self->_delegateMethod.foundString != NULL )
+				((NDObjectMethodIMP)self->_delegateMethod.foundString)( self.delegate, @selector(jsonParser:foundString:), self, theValue );
+			[theValue release];
+			i++;
+			break;
+		}
+		case kNDJSONTapeInteger:
+		{
+			NSInteger		theValue;
+			if( i+1 >= theCount )
+				return NO;
+			theValue = (NSInteger)(int64_t)theWords[i+1];
+			if( self->_delegateMethod.foundNumber != NULL )
+				((NDObjectMethodIMP)self->_delegateMethod.foundNumber)( self.delegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithLongLong:(int64_t)theWords[i+1]] );
+			else if( self->_delegateMethod.foundInteger != NULL )
+				((NDIntegerMethodIMP)self->_delegateMethod.foundInteger)( self.delegate, @selector(jsonParser:foundInteger:), self, theValue );
+			i += 2;
+			break;
+		}
+		case kNDJSONTapeFloat:
+		{
+			double			theValue;
+			if( i+1 >= theCount )
+				return NO;
+			memcpy( &theValue, &theWords[i+1], sizeof(theValue) );
+			if( self->_delegateMethod.foundNumber != NULL )
+				((NDObjectMethodIMP)self->_delegateMethod.foundNumber)( self.delegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithDouble:theValue] );
+			else if( self->_delegateMethod.foundFloat != NULL )
+				((NDFloatMethodIMP)self->_delegateMethod.foundFloat)( self.delegate, @selector(jsonParser:foundFloat:), self, theValue );
+			i += 2;
+			break;
+		}
+		case kNDJSONTapeTrue:
+		case kNDJSONTapeFalse:
+		{
+			BOOL			theValue = (theWords[i]>>56) == kNDJSONTapeTrue;
+			if( self->_delegateMethod.foundNumber != NULL )
+				((NDObjectMethodIMP)self->_delegateMethod.foundNumber)( self.delegate, @selector(jsonParser:foundNumber:), self, [NSNumber numberWithBool:theValue] );
+			else if( self->_delegateMethod.foundBool != NULL )
+				((NDBoolMethodIMP)self->_delegateMethod.foundBool)( self.delegate, @selector(jsonParser:foundBool:), self, theValue );
+			i++;
+			break;
+		}
+		case kNDJSONTapeNull:
+			if( self->_delegateMethod.foundNULL != NULL )
+				((NDVoidMethodIMP)self->_delegateMethod.foundNULL)( self.delegate, @selector(jsonParserFoundNULL:), self );
+			i++;
+			break;
+		default:
+			return NO;
+		}
+	}
+	return self->_keyTables.count == 0 || self->_tapeAbort;
+}
+
+- (BOOL)parseWithOptions:(NDJSONOptionFlags)anOptions
+{
+	BOOL		theResult = NO;
+	[self setUpTapeRespondsTo];
+	_tapeAbort = NO;
+	_keyTables.count = 0;
+	_keyStrings = CFDictionaryCreateMutable( kCFAllocatorDefault, 0, NULL, &kCFTypeDictionaryValueCallBacks );
+	if( _delegateMethod.didStartDocument != NULL )
+		((NDVoidMethodIMP)_delegateMethod.didStartDocument)( self.delegate, @selector(jsonParserDidStartDocument:), self );
+	theResult = NDJSONTapeReplay( self );
+	if( !theResult && !_tapeAbort && _delegateMethod.foundError != NULL )
+		((NDObjectMethodIMP)_delegateMethod.foundError)( self.delegate, @selector(jsonParser:error:), self, NDJSONTapeError( NDJSONBadFormatError, @"JSON tape is corrupt" ) );
+	if( _tapeAbort )
+		theResult = NO;
+	if( theResult && _delegateMethod.didEndDocument != NULL )
+		((NDVoidMethodIMP)_delegateMethod.didEndDocument)( self.delegate, @selector(jsonParserDidEndDocument:), self );
+	CFRelease( _keyStrings ), _keyStrings = NULL;
+	NDJSONTapeSetCurrentKey( self, nil, NSNotFound, nil );
+	return theResult;
+}
+
+- (void)abortParsing
+{
+	_tapeAbort = YES;
+	[super abortParsing];
+}
+
+- (void)setUpTapeRespondsTo
+{
+	NDJSONGetDelegateMethods( &_delegateMethod, self.delegate );
+}
+
+@end
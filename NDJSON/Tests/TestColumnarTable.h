@@ -0,0 +1,14 @@
+//
+//  TestColumnarTable.h
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+#import "TestGroup.h"
+
+@interface TestColumnarTable : TestGroup
+
+@end
@@ -0,0 +1,143 @@
+//
+//  TestColumnarTable.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestColumnarTable.h"
+#import "NDJSONColumnarTable.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+
+@interface TestColumnarTable ()
+- (void)addName:(NSString *)name jsonString:(NSString *)json path:(NSString *)path options:(NDJSONOptionFlags)options expectedResult:(id)expectedResult;
+@end
+
+/*
+	builds a table from the json, the result is the row count followed by a dictionary of the type, values and whether it has mixed types for each column
+ */
+@interface TestColumnar : TestProtocolBase
+{
+	NSString					* jsonString;
+	NSString					* path;
+	NDJSONOptionFlags			options;
+	id							expectedResult;
+}
++ (id)testColumnarWithName:(NSString *)name jsonString:(NSString *)json path:(NSString *)path options:(NDJSONOptionFlags)options expectedResult:(id)expectedResult;
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json path:(NSString *)path options:(NDJSONOptionFlags)options expectedResult:(id)expectedResult;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			NSString			* path;
+@property(readonly)			NDJSONOptionFlags	options;
+@property(readonly)			id					expectedResult;
+@end
+
+@implementation TestColumnarTable
+
+- (NSString *)testDescription { return @"Test decoding arrays of objects into columns"; }
+
+- (void)addName:(NSString *)aName jsonString:(NSString *)aJSON path:(NSString *)aPath options:(NDJSONOptionFlags)anOptions expectedResult:(id)aResult
+{
+	[self addTest:[TestColumnar testColumnarWithName:aName jsonString:aJSON path:aPath options:anOptions expectedResult:aResult]];
+}
+
+- (void)willLoad
+{
+	NSNull		* theNull = [NSNull null];
+	[self addName:@"Column Types" jsonString:@"[{\"id\":1,\"price\":2.5,\"open\":true,\"symbol\":\"ABC\"},{\"id\":2,\"price\":3.25,\"open\":false,\"symbol\":\"XYZ\"}]" path:nil options:NDJSONOptionNone
+		expectedResult:@[@2,@{@"id":@[@(NDJSONColumnInteger),@[@1,@2],@NO],@"price":@[@(NDJSONColumnFloat),@[@2.5,@3.25],@NO],@"open":@[@(NDJSONColumnBool),@[@YES,@NO],@NO],@"symbol":@[@(NDJSONColumnString),@[@"ABC",@"XYZ"],@NO]}]];
+	[self addName:@"Missing and Null" jsonString:@"[{\"a\":1,\"b\":null},{\"b\":\"x\"},{\"a\":3,\"c\":null}]" path:nil options:NDJSONOptionNone
+		expectedResult:@[@3,@{@"a":@[@(NDJSONColumnInteger),@[@1,theNull,@3],@NO],@"b":@[@(NDJSONColumnString),@[theNull,@"x",theNull],@NO],@"c":@[@(NDJSONColumnNull),@[theNull,theNull,theNull],@NO]}]];
+	[self addName:@"Integer to Float" jsonString:@"[{\"v\":1},{\"v\":2.5},{\"v\":3}]" path:nil options:NDJSONOptionNone
+		expectedResult:@[@3,@{@"v":@[@(NDJSONColumnFloat),@[@1.0,@2.5,@3.0],@NO]}]];
+	[self addName:@"Mixed Types" jsonString:@"[{\"v\":1,\"w\":[1,2]},{\"v\":\"two\",\"w\":{\"x\":1}},{\"v\":3,\"w\":\"three\"}]" path:nil options:NDJSONOptionNone
+		expectedResult:@[@3,@{@"v":@[@(NDJSONColumnInteger),@[@1,theNull,@3],@YES],@"w":@[@(NDJSONColumnString),@[theNull,theNull,@"three"],@YES]}]];
+	[self addName:@"Repeated Key" jsonString:@"[{\"v\":1,\"v\":\"x\"},{\"v\":2,\"v\":null},{\"v\":3,\"v\":4}]" path:nil options:NDJSONOptionNone
+		expectedResult:@[@3,@{@"v":@[@(NDJSONColumnInteger),@[theNull,theNull,@4],@YES]}]];
+	[self addName:@"String Dictionary" jsonString:@"[{\"s\":\"b\"},{\"s\":\"a\"},{\"s\":\"b\"},{\"s\":\"b\"},{\"s\":\"a\"}]" path:nil options:NDJSONOptionNone
+		expectedResult:@[@5,@{@"s":@[@(NDJSONColumnString),@[@"b",@"a",@"b",@"b",@"a"],@NO]},@[@"b",@"a"]]];
+	[self addName:@"Path" jsonString:@"{\"meta\":{\"rows\":[{\"x\":0}]},\"data\":{\"rows\":[{\"x\":1},{\"x\":2}]},\"more\":[1,2]}" path:@"/data/rows" options:NDJSONOptionNone
+		expectedResult:@[@2,@{@"x":@[@(NDJSONColumnInteger),@[@1,@2],@NO]}]];
+	[self addName:@"Path with Index" jsonString:@"{\"pages\":[{\"rows\":[{\"x\":1}]},{\"rows\":[{\"x\":2},{\"x\":3}]}]}" path:@"/pages/1/rows" options:NDJSONOptionNone
+		expectedResult:@[@2,@{@"x":@[@(NDJSONColumnInteger),@[@2,@3],@NO]}]];
+	[self addName:@"JSON Lines" jsonString:@"{\"t\":1,\"level\":\"info\"}\n{\"t\":2,\"level\":\"warn\"}\n{\"t\":3,\"level\":\"info\"}\n" path:nil options:NDJSONOptionJSONLines
+		expectedResult:@[@3,@{@"t":@[@(NDJSONColumnInteger),@[@1,@2,@3],@NO],@"level":@[@(NDJSONColumnString),@[@"info",@"warn",@"info"],@NO]}]];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestColumnar
+
+@synthesize		jsonString,
+				path,
+				options,
+				expectedResult;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\npath: %@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString, self.path, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testColumnarWithName:(NSString *)aName jsonString:(NSString *)aJSON path:(NSString *)aPath options:(NDJSONOptionFlags)anOptions expectedResult:(id)aResult
+{
+	return [[self alloc] initWithName:aName jsonString:aJSON path:aPath options:anOptions expectedResult:aResult];
+}
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON path:(NSString *)aPath options:(NDJSONOptionFlags)anOptions expectedResult:(id)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		path = [aPath copy];
+		options = anOptions;
+		expectedResult = aResult;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError					* theError = nil;
+	NDJSONParser			* theParser = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+	NDJSONColumnarTable		* theTable = [NDJSONColumnarTable tableForJSONParser:theParser path:self.path options:self.options error:&theError];
+	if( theTable != nil )
+	{
+		NSMutableDictionary		* theColumns = [NSMutableDictionary dictionary];
+		NSMutableArray			* theResult = [NSMutableArray arrayWithObjects:@(theTable.rowCount), theColumns, nil];
+		for( NDJSONColumn * theColumn in theTable.columns )
+		{
+			NSMutableArray		* theValues = [NSMutableArray arrayWithCapacity:theColumn.count];
+			for( NSUInteger i = 0; i < theColumn.count; i++ )
+				[theValues addObject:[theColumn objectAtRow:i]];
+			[theColumns setObject:@[@(theColumn.type),theValues,@(theColumn.hasMixedTypes)] forKey:theColumn.name];
+			if( theColumn.nullCount != [theValues indexesOfObjectsPassingTest:^BOOL(id anObject, NSUInteger anIndex, BOOL * aStop) { return anObject == [NSNull null]; }].count )
+				theError = [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONGeneralError userInfo:@{NSLocalizedDescriptionKey:@"null count does not match the validity bitmap"}];
+			if( theColumn.values.length != theColumn.count*(theColumn.type == NDJSONColumnNull ? 0 : theColumn.type == NDJSONColumnBool ? sizeof(BOOL) : theColumn.type == NDJSONColumnString ? sizeof(uint32_t) : sizeof(int64_t)) )
+				theError = [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONGeneralError userInfo:@{NSLocalizedDescriptionKey:@"values are not the size of the column"}];
+			for( NSUInteger i = 0, theSize = theColumn.count > 0 ? theColumn.values.length/theColumn.count : 0; i < theColumn.count; i++ )
+			{
+				const uint8_t		* theSlot = (const uint8_t *)theColumn.values.bytes + i*theSize;
+				for( NSUInteger j = 0; j < theSize && ![theColumn isValidAtRow:i]; j++ )
+				{
+					if( theSlot[j] != 0 )
+						theError = [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONGeneralError userInfo:@{NSLocalizedDescriptionKey:@"the value of a null row is not zero"}];
+				}
+			}
+		}
+		if( [self.expectedResult count] > 2 )
+			[theResult addObject:[[theTable columnForName:@"s"] dictionary]];
+		self.lastResult = theResult;
+	}
+	self.error = theError;
+	return self.lastResult;
+}
+
+@end
@@ -0,0 +1,142 @@
+//
+//  TestConcurrentDecoding.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestConcurrentDecoding.h"
+#import "NDJSONDeserializer.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+
+static const NSUInteger		kDocumentCount = 64;
+
+@interface TestConcurrentDecoding ()
+- (void)addName:(NSString *)name rootClass:(Class)rootClass invalidIndexes:(NSIndexSet *)invalidIndexes options:(NDJSONOptionFlags)options;
+@end
+
+@interface TestConcurrentRecord : NSObject
+@property(strong,nonatomic)	NSNumber		* index;
+@property(strong,nonatomic)	NSString		* name;
+@property(strong,nonatomic)	NSArray			* values;
+@end
+
+/*
+	decodes kDocumentCount documents with one shared configuration, the documents at invalidIndexes are not valid JSON, custom objects are converted back to dictionaries to compare them
+ */
+@interface TestBatch : TestProtocolBase
+{
+	Class						rootClass;
+	NSIndexSet					* invalidIndexes;
+	NDJSONOptionFlags			options;
+}
++ (id)testBatchWithName:(NSString *)name rootClass:(Class)rootClass invalidIndexes:(NSIndexSet *)invalidIndexes options:(NDJSONOptionFlags)options;
+- (id)initWithName:(NSString *)name rootClass:(Class)rootClass invalidIndexes:(NSIndexSet *)invalidIndexes options:(NDJSONOptionFlags)options;
+
+@property(readonly)			Class				rootClass;
+@property(readonly)			NSIndexSet			* invalidIndexes;
+@property(readonly)			NDJSONOptionFlags	options;
+@end
+
+@implementation TestConcurrentDecoding
+
+- (NSString *)testDescription { return @"Test decoding many documents concurrently with a shared deserializer configuration"; }
+
+- (void)addName:(NSString *)aName rootClass:(Class)aRootClass invalidIndexes:(NSIndexSet *)anInvalidIndexes options:(NDJSONOptionFlags)anOptions
+{
+	[self addTest:[TestBatch testBatchWithName:aName rootClass:aRootClass invalidIndexes:anInvalidIndexes options:anOptions]];
+}
+
+- (void)willLoad
+{
+	[self addName:@"Property List Batch" rootClass:Nil invalidIndexes:[NSIndexSet indexSet] options:NDJSONOptionNone];
+	[self addName:@"Property List Batch With Errors" rootClass:Nil invalidIndexes:[NSIndexSet indexSetWithIndex:5] options:NDJSONOptionNone];
+	[self addName:@"Custom Class Batch" rootClass:[TestConcurrentRecord class] invalidIndexes:[NSIndexSet indexSet] options:NDJSONOptionNone];
+	[self addName:@"Custom Class Shared Key Tables" rootClass:[TestConcurrentRecord class] invalidIndexes:[NSIndexSet indexSetWithIndex:kDocumentCount-1] options:NDJSONOptionUseKeyTables];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestBatch
+
+@synthesize		rootClass,
+				invalidIndexes,
+				options;
+
+#pragma mark - manually implemented properties
+
+- (id)expectedResult
+{
+	NSMutableArray		* theObjects = [NSMutableArray arrayWithCapacity:kDocumentCount];
+	for( NSUInteger i = 0; i < kDocumentCount; i++ )
+	{
+		if( [self.invalidIndexes containsIndex:i] )
+			[theObjects addObject:[NSNull null]];
+		else
+			[theObjects addObject:@{@"index":@(i),@"name":[NSString stringWithFormat:@"record %lu",(unsigned long)i],@"values":@[@(i),@(i*2)]}];
+	}
+	return @{@"objects":theObjects,@"errors":self.invalidIndexes};
+}
+
+#pragma mark - creation and destruction
+
++ (id)testBatchWithName:(NSString *)aName rootClass:(Class)aRootClass invalidIndexes:(NSIndexSet *)anInvalidIndexes options:(NDJSONOptionFlags)anOptions
+{
+	return [[self alloc] initWithName:aName rootClass:aRootClass invalidIndexes:anInvalidIndexes options:anOptions];
+}
+- (id)initWithName:(NSString *)aName rootClass:(Class)aRootClass invalidIndexes:(NSIndexSet *)anInvalidIndexes options:(NDJSONOptionFlags)anOptions
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		rootClass = aRootClass;
+		invalidIndexes = [anInvalidIndexes copy];
+		options = anOptions;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSMutableArray						* theDataArray = [NSMutableArray arrayWithCapacity:kDocumentCount];
+	NDJSONDeserializerConfiguration		* theConfiguration = [NDJSONDeserializerConfiguration configurationWithRootClass:self.rootClass rootCollectionClass:Nil options:self.options];
+	NSArray								* theErrors = nil;
+	NSMutableArray						* theObjects = [NSMutableArray arrayWithCapacity:kDocumentCount];
+	NSMutableIndexSet					* theErrorIndexes = [NSMutableIndexSet indexSet];
+
+	for( NSUInteger i = 0; i < kDocumentCount; i++ )
+	{
+		NSString	* theJSON = [self.invalidIndexes containsIndex:i]
+								? [NSString stringWithFormat:@"{\"index\":%lu,\"name\":", (unsigned long)i]
+								: [NSString stringWithFormat:@"{\"index\":%lu,\"name\":\"record %lu\",\"values\":[%lu,%lu]}", (unsigned long)i, (unsigned long)i, (unsigned long)i, (unsigned long)i*2];
+		[theDataArray addObject:[theJSON dataUsingEncoding:NSUTF8StringEncoding]];
+	}
+
+	for( id theObject in [theConfiguration objectsForJSONDataArray:theDataArray encoding:NSUTF8StringEncoding errors:&theErrors] )
+	{
+		if( [theObject isKindOfClass:[TestConcurrentRecord class]] )
+			[theObjects addObject:[theObject dictionaryWithValuesForKeys:@[@"index",@"name",@"values"]]];
+		else
+			[theObjects addObject:theObject];
+	}
+	[theErrors enumerateObjectsUsingBlock:^(id anError, NSUInteger anIndex, BOOL * aStop) {
+		if( anError != [NSNull null] )
+			[theErrorIndexes addIndex:anIndex];
+	}];
+	self.lastResult = @{@"objects":theObjects,@"errors":theErrorIndexes};
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestConcurrentRecord
+
+@synthesize		index,
+				name,
+				values;
+
+@end
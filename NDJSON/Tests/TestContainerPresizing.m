@@ -0,0 +1,271 @@
+//
+//  TestContainerPresizing.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestContainerPresizing.h"
+#import "NDJSONDeserializer.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+
+@interface TestContainerPresizing ()
+- (void)addName:(NSString *)name jsonStrings:(NSArray *)jsons options:(NDJSONOptionFlags)options keyPaths:(NSArray *)keyPaths sharesConfiguration:(BOOL)sharesConfiguration expectedResult:(id)expectedResult;
+- (void)addName:(NSString *)name jsonStrings:(NSArray *)jsons collectionClass:(Class)collectionClass expectedResult:(id)expectedResult;
+@end
+
+/*
+	a collection class that records the capacity each instance was created with, 0 for -init
+ */
+@interface TestCapacityRecordingArray : NSObject
+{
+	NSMutableArray		* elements;
+}
++ (NSArray *)capacities;
++ (void)resetCapacities;
+- (id)initWithCapacity:(NSUInteger)capacity;
+- (void)addObject:(id)object;
+- (NSUInteger)count;
+@end
+
+/*
+	responds to initWithCapacity: but not count, so the deserializer can not record its size
+ */
+@interface TestUncountedArray : NSObject
+{
+	NSMutableArray		* elements;
+}
++ (NSArray *)capacities;
++ (void)resetCapacities;
+- (id)initWithCapacity:(NSUInteger)capacity;
+- (void)addObject:(id)object;
+@end
+
+/*
+	deserializes each of jsonStrings in turn, with the same deserializer or a new deserializer from the same configuration, the result is the objects followed by the expected count of the profile for each of keyPaths
+ */
+@interface TestProfiledDeserialization : TestProtocolBase
+{
+	NSArray						* jsonStrings;
+	NDJSONOptionFlags			options;
+	NSArray						* keyPaths;
+	BOOL						sharesConfiguration;
+	id							expectedResult;
+}
++ (id)testProfiledDeserializationWithName:(NSString *)name jsonStrings:(NSArray *)jsons options:(NDJSONOptionFlags)options keyPaths:(NSArray *)keyPaths sharesConfiguration:(BOOL)sharesConfiguration expectedResult:(id)expectedResult;
+- (id)initWithName:(NSString *)name jsonStrings:(NSArray *)jsons options:(NDJSONOptionFlags)options keyPaths:(NSArray *)keyPaths sharesConfiguration:(BOOL)sharesConfiguration expectedResult:(id)expectedResult;
+
+@property(readonly)			NSArray				* jsonStrings;
+@property(readonly)			NDJSONOptionFlags	options;
+@property(readonly)			NSArray				* keyPaths;
+@property(readonly)			BOOL				sharesConfiguration;
+@property(readonly)			id					expectedResult;
+@end
+
+/*
+	deserializes each of jsonStrings in turn with the same deserializer, the root arrays are instances of collectionClass,
+	the result is the capacity each instance was created with
+ */
+@interface TestPresizedCollection : TestProtocolBase
+{
+	NSArray						* jsonStrings;
+	Class						collectionClass;
+	id							expectedResult;
+}
++ (id)testPresizedCollectionWithName:(NSString *)name jsonStrings:(NSArray *)jsons collectionClass:(Class)collectionClass expectedResult:(id)expectedResult;
+- (id)initWithName:(NSString *)name jsonStrings:(NSArray *)jsons collectionClass:(Class)collectionClass expectedResult:(id)expectedResult;
+
+@property(readonly)			NSArray				* jsonStrings;
+@property(readonly)			Class				collectionClass;
+@property(readonly)			id					expectedResult;
+@end
+
+@implementation TestContainerPresizing
+
+- (NSString *)testDescription { return @"Test creating containers with the sizes of earlier documents"; }
+
+- (void)addName:(NSString *)aName jsonStrings:(NSArray *)aJSONs options:(NDJSONOptionFlags)anOptions keyPaths:(NSArray *)aKeyPaths sharesConfiguration:(BOOL)aSharesConfiguration expectedResult:(id)aResult
+{
+	[self addTest:[TestProfiledDeserialization testProfiledDeserializationWithName:aName jsonStrings:aJSONs options:anOptions keyPaths:aKeyPaths sharesConfiguration:aSharesConfiguration expectedResult:aResult]];
+}
+
+- (void)addName:(NSString *)aName jsonStrings:(NSArray *)aJSONs collectionClass:(Class)aCollectionClass expectedResult:(id)aResult
+{
+	[self addTest:[TestPresizedCollection testPresizedCollectionWithName:aName jsonStrings:aJSONs collectionClass:aCollectionClass expectedResult:aResult]];
+}
+
+- (void)willLoad
+{
+	NSString		* theDocument = @"{\"a\":[1,2,3,4],\"b\":{\"x\":1,\"y\":2}}";
+	NSArray			* theDocumentKeyPaths = @[@[],@[@"a"],@[@"b"],@[@"c"]];
+	id				theDocumentObject = @{@"a":@[@1,@2,@3,@4],@"b":@{@"x":@1,@"y":@2}};
+
+	[self addName:@"Object Members" jsonStrings:@[theDocument,theDocument] options:NDJSONOptionPresizeContainers keyPaths:theDocumentKeyPaths sharesConfiguration:NO expectedResult:@[theDocumentObject,theDocumentObject,@2,@4,@2,@0]];
+	[self addName:@"Array Elements" jsonStrings:@[@"[{\"x\":[1,2]},{\"x\":[3,4]}]"] options:NDJSONOptionPresizeContainers keyPaths:@[@[],@[[NSNull null]],@[[NSNull null],@"x"]] sharesConfiguration:NO expectedResult:@[@[@{@"x":@[@1,@2]},@{@"x":@[@3,@4]}],@2,@1,@2]];
+	[self addName:@"Running Average" jsonStrings:@[@"[1,2,3,4,5,6,7,8]",@"[1,2,3,4]"] options:NDJSONOptionPresizeContainers keyPaths:@[@[]] sharesConfiguration:NO expectedResult:@[@[@1,@2,@3,@4,@5,@6,@7,@8],@[@1,@2,@3,@4],@7]];
+	[self addName:@"Shared Configuration" jsonStrings:@[theDocument,@"{\"a\":[]}"] options:NDJSONOptionPresizeContainers keyPaths:theDocumentKeyPaths sharesConfiguration:YES expectedResult:@[theDocumentObject,@{@"a":@[]},@2,@3,@2,@0]];
+	[self addName:@"Not Profiled" jsonStrings:@[theDocument] options:NDJSONOptionNone keyPaths:theDocumentKeyPaths sharesConfiguration:NO expectedResult:@[theDocumentObject,@0,@0,@0,@0]];
+	[self addName:@"Presized Collection Class" jsonStrings:@[@"[1,2,3]",@"[4,5,6]"] collectionClass:[TestCapacityRecordingArray class] expectedResult:@[@0,@3]];
+	[self addName:@"Collection Class Without Count" jsonStrings:@[@"[1,2,3]",@"[4,5,6]"] collectionClass:[TestUncountedArray class] expectedResult:@[@0,@0]];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestProfiledDeserialization
+
+@synthesize		jsonStrings,
+				options,
+				keyPaths,
+				sharesConfiguration,
+				expectedResult;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nkey paths:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", [self.jsonStrings componentsJoinedByString:@"\n"], self.keyPaths, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testProfiledDeserializationWithName:(NSString *)aName jsonStrings:(NSArray *)aJSONs options:(NDJSONOptionFlags)anOptions keyPaths:(NSArray *)aKeyPaths sharesConfiguration:(BOOL)aSharesConfiguration expectedResult:(id)aResult
+{
+	return [[self alloc] initWithName:aName jsonStrings:aJSONs options:anOptions keyPaths:aKeyPaths sharesConfiguration:aSharesConfiguration expectedResult:aResult];
+}
+- (id)initWithName:(NSString *)aName jsonStrings:(NSArray *)aJSONs options:(NDJSONOptionFlags)anOptions keyPaths:(NSArray *)aKeyPaths sharesConfiguration:(BOOL)aSharesConfiguration expectedResult:(id)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonStrings = [aJSONs copy];
+		options = anOptions;
+		keyPaths = [aKeyPaths copy];
+		sharesConfiguration = aSharesConfiguration;
+		expectedResult = aResult;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSMutableArray						* theResult = [NSMutableArray array];
+	NDJSONDeserializerConfiguration		* theConfiguration = [NDJSONDeserializerConfiguration configurationWithRootClass:Nil rootCollectionClass:Nil options:self.options];
+	NDJSONDeserializer					* theDeserializer = [theConfiguration deserializer];
+	NSError								* theError = nil;
+	for( NSString * theJSONString in self.jsonStrings )
+	{
+		NDJSONParser	* theJSON = [[NDJSONParser alloc] initWithJSONString:theJSONString];
+		id				theObject = nil;
+		if( self.sharesConfiguration )
+			theDeserializer = [theConfiguration deserializer];
+		theObject = [theDeserializer objectForJSON:theJSON options:self.options error:&theError];
+		[theResult addObject:theObject != nil ? theObject : [NSNull null]];
+	}
+	if( self.sharesConfiguration && theDeserializer.shapeProfile != theConfiguration.shapeProfile )
+		[theResult addObject:@"deserializer does not use the profile of its configuration"];
+	for( NSArray * theKeyPath in self.keyPaths )
+		[theResult addObject:[NSNumber numberWithUnsignedInteger:[theDeserializer.shapeProfile expectedCountForKeyPath:theKeyPath]]];
+	self.error = theError;
+	self.lastResult = theResult;
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestPresizedCollection
+
+@synthesize		jsonStrings,
+				collectionClass,
+				expectedResult;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\ncollection class:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", [self.jsonStrings componentsJoinedByString:@"\n"], NSStringFromClass(self.collectionClass), [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testPresizedCollectionWithName:(NSString *)aName jsonStrings:(NSArray *)aJSONs collectionClass:(Class)aCollectionClass expectedResult:(id)aResult
+{
+	return [[self alloc] initWithName:aName jsonStrings:aJSONs collectionClass:aCollectionClass expectedResult:aResult];
+}
+- (id)initWithName:(NSString *)aName jsonStrings:(NSArray *)aJSONs collectionClass:(Class)aCollectionClass expectedResult:(id)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonStrings = [aJSONs copy];
+		collectionClass = aCollectionClass;
+		expectedResult = aResult;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NDJSONDeserializer		* theDeserializer = [[NDJSONDeserializer alloc] initWithRootClass:[NSObject class] rootCollectionClass:self.collectionClass];
+	NSError					* theError = nil;
+	[self.collectionClass resetCapacities];
+	for( NSString * theJSONString in self.jsonStrings )
+	{
+		NDJSONParser	* theJSON = [[NDJSONParser alloc] initWithJSONString:theJSONString];
+		if( [theDeserializer objectForJSON:theJSON options:NDJSONOptionPresizeContainers error:&theError] == nil )
+			break;
+	}
+	self.error = theError;
+	self.lastResult = [self.collectionClass capacities];
+	return self.lastResult;
+}
+
+@end
+
+static NSMutableArray		* kRecordedCapacities = nil,
+							* kUncountedCapacities = nil;
+
+@implementation TestCapacityRecordingArray
+
++ (NSArray *)capacities { return [kRecordedCapacities copy]; }
++ (void)resetCapacities { kRecordedCapacities = [[NSMutableArray alloc] init]; }
+
+- (id)init { return [self initWithCapacity:0]; }
+- (id)initWithCapacity:(NSUInteger)aCapacity
+{
+	if( (self = [super init]) != nil )
+	{
+		elements = [[NSMutableArray alloc] initWithCapacity:aCapacity];
+		[kRecordedCapacities addObject:@(aCapacity)];
+	}
+	return self;
+}
+
+- (void)addObject:(id)anObject { [elements addObject:anObject]; }
+- (NSUInteger)count { return elements.count; }
+
+@end
+
+@implementation TestUncountedArray
+
++ (NSArray *)capacities { return [kUncountedCapacities copy]; }
++ (void)resetCapacities { kUncountedCapacities = [[NSMutableArray alloc] init]; }
+
+- (id)init { return [self initWithCapacity:0]; }
+- (id)initWithCapacity:(NSUInteger)aCapacity
+{
+	if( (self = [super init]) != nil )
+	{
+		elements = [[NSMutableArray alloc] initWithCapacity:aCapacity];
+		[kUncountedCapacities addObject:@(aCapacity)];
+	}
+	return self;
+}
+
+- (void)addObject:(id)anObject { [elements addObject:anObject]; }
+
+@end
@@ -7,12 +7,14 @@
 //
 
 #import "TestProtocolBase.h"
+#import "NDJSONParser.h"
 
 @interface TestCustomObjectsSimple : TestProtocolBase
 {
 	NSString	* jsonSourceString;
 	Class		rootClass,
 				rootCollectionClass;
+	NDJSONOptionFlags	options;
 }
 
 + (void)addTestsToTestGroup:(TestGroup *)testGroup;
@@ -24,5 +26,9 @@
 - (id)initWithName:(NSString *)name jsonSourceString:(NSString *)source
 										   rootClass:(Class)rootClass
 								 rootCollectionClass:(Class)aRootCollectionClass;
+- (id)initWithName:(NSString *)name jsonSourceString:(NSString *)source
+										   rootClass:(Class)rootClass
+								 rootCollectionClass:(Class)aRootCollectionClass
+											 options:(NDJSONOptionFlags)options;
 
 @end
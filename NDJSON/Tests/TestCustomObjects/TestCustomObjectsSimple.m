@@ -54,6 +54,14 @@
 														rootClass:kRootClass[i]
 											  rootCollectionClass:kRootCollectionClass[i]]];
 	}
+	for( NSUInteger i = 0; i < sizeof(kJSONSource)/sizeof(*kJSONSource); i++ )
+	{
+		[aTestGroup addTest:[[self alloc] initWithName:[kNames[i] stringByAppendingString:@" (Key Tables)"]
+									  jsonSourceString:kJSONSource[i]
+											 rootClass:kRootClass[i]
+								   rootCollectionClass:kRootCollectionClass[i]
+											   options:NDJSONOptionUseKeyTables]];
+	}
 }
 
 + (id)testCustomObjectsSimpleWithName:(NSString *)aName jsonSourceString:(NSString *)aSource rootClass:(Class)aRootClass rootCollectionClass:(Class)aRootCollectionClass
@@ -61,12 +69,17 @@
 	return [[self alloc] initWithName:(NSString *)aName jsonSourceString:aSource rootClass:aRootClass rootCollectionClass:aRootCollectionClass];
 }
 - (id)initWithName:(NSString *)aName jsonSourceString:(NSString *)aSource rootClass:(Class)aRootClass rootCollectionClass:(Class)aRootCollectionClass
+{
+	return [self initWithName:aName jsonSourceString:aSource rootClass:aRootClass rootCollectionClass:aRootCollectionClass options:NDJSONOptionNone];
+}
+- (id)initWithName:(NSString *)aName jsonSourceString:(NSString *)aSource rootClass:(Class)aRootClass rootCollectionClass:(Class)aRootCollectionClass options:(NDJSONOptionFlags)anOptions
 {
 	if( (self = [super initWithName:aName]) != nil )
 	{
 		rootClass = aRootClass;
 		rootCollectionClass = aRootCollectionClass;
 		jsonSourceString = [aSource copy];
+		options = anOptions;
 	}
 	return self;
 }
@@ -81,7 +94,7 @@
 	NSError					* theError = nil;
 	NDJSONParser			* theJSON = [[NDJSONParser alloc] initWithJSONString:jsonSourceString];
 	NDJSONDeserializer		* theJSONParser = [[NDJSONDeserializer alloc] initWithRootClass:rootClass rootCollectionClass:rootCollectionClass];
-	self.lastResult = [theJSONParser objectForJSON:theJSON options:NDJSONOptionNone error:&theError];
+	self.lastResult = [theJSONParser objectForJSON:theJSON options:options error:&theError];
 	self.error = theError;
 	return lastResult;
 }
@@ -11,9 +11,11 @@
 #import "NDJSONDeserializer.h"
 #import "TestProtocolBase.h"
 #import "NSObject+TestUtilities.h"
+#include <zlib.h>
 
 @interface TestFileInput ()
 - (void)addName:(NSString *)name fileName:(NSString *)path;
+- (void)addName:(NSString *)name fileName:(NSString *)path compressed:(BOOL)compressed;
 
 @end
 
@@ -24,18 +26,36 @@
 
 @property(readonly)	NSString					* path;
 
-+ (id)testFileWithName:(NSString *)aName fileName:(NSString *)aFileName;
-- (id)initWithName:(NSString *)aName fileName:(NSString *)aFileName;
++ (id)testFileWithName:(NSString *)aName fileName:(NSString *)aFileName compressed:(BOOL)compressed;
+- (id)initWithName:(NSString *)aName fileName:(NSString *)aFileName compressed:(BOOL)compressed;
+
+@end
+
+/*
+	zlib compressed JSON Lines with a damaged check value, every line inflates but the parse has to fail with the inflate
+	error instead of returning the lines as if the input had ended cleanly
+ */
+@interface TestCorruptCompressedData : TestProtocolBase
+{
+	NSData						* data;
+}
+
+@property(readonly)	NSData						* data;
 
 @end
 
 @implementation TestFileInput
 
-- (NSString *)testDescription { return @"Test file input, this uses InputStream and therefore parses what is available."; }
+- (NSString *)testDescription { return @"Test file input, this uses InputStream and therefore parses what is available, the same files are also tested gzip compressed."; }
 
 - (void)addName:(NSString *)aName fileName:(NSString *)aFileName
 {
-	[self addTest:[TestFile testFileWithName:aName fileName:aFileName]];
+	[self addName:aName fileName:aFileName compressed:NO];
+}
+
+- (void)addName:(NSString *)aName fileName:(NSString *)aFileName compressed:(BOOL)aCompressed
+{
+	[self addTest:[TestFile testFileWithName:aName fileName:aFileName compressed:aCompressed]];
 }
 
 - (void)willLoad
@@ -46,6 +66,13 @@
 					* theFileName = [NSString stringWithFormat:@"file%lu", i];
 		[self addName:theTestName fileName:theFileName];
 	}
+	for( NSUInteger i = 1; i <= 6; i++ )
+	{
+		NSString	* theTestName = [NSString stringWithFormat:@"Gzip File %lu", i],
+					* theFileName = [NSString stringWithFormat:@"file%lu", i];
+		[self addName:theTestName fileName:theFileName compressed:YES];
+	}
+	[self addTest:[[TestCorruptCompressedData alloc] initWithName:@"Corrupt Compressed JSON Lines"]];
 }
 
 @end
@@ -55,11 +82,11 @@
 @synthesize		path,
 				expectedResult;
 
-+ (id)testFileWithName:(NSString *)aName fileName:(NSString *)aFileName
++ (id)testFileWithName:(NSString *)aName fileName:(NSString *)aFileName compressed:(BOOL)aCompressed
 {
-	return [[self alloc] initWithName:aName fileName:aFileName];
+	return [[self alloc] initWithName:aName fileName:aFileName compressed:aCompressed];
 }
-- (id)initWithName:(NSString *)aName fileName:(NSString *)aFileName
+- (id)initWithName:(NSString *)aName fileName:(NSString *)aFileName compressed:(BOOL)aCompressed
 {
 	if( (self = [super initWithName:aName]) != nil )
 	{
@@ -69,6 +96,17 @@
 		if( theJSONData == nil )
 			NSLog(@"Read Error: %@", theError);
 		path = [[NSBundle mainBundle] pathForResource:aFileName ofType:@"json"];
+		if( aCompressed )
+		{
+			NSString	* theCompressedPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[aFileName stringByAppendingPathExtension:@"json.gz"]];
+			gzFile		theFile = gzopen( [theCompressedPath fileSystemRepresentation], "wb" );
+			if( theFile != NULL )
+			{
+				gzwrite( theFile, theJSONData.bytes, (unsigned)theJSONData.length );
+				gzclose( theFile );
+				path = theCompressedPath;
+			}
+		}
 		expectedResult = [NSJSONSerialization JSONObjectWithData:theJSONData options:NSJSONReadingAllowFragments error:&theError];
 		if( expectedResult == nil )
 			NSLog(@"JSON Error: %@", theError);
@@ -95,3 +133,49 @@
 }
 
 @end
+
+@implementation TestCorruptCompressedData
+
+@synthesize		data;
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"data length:%lu\n\nresult:\n%@\n\nexpected result:\n%@\n\n", (unsigned long)self.data.length, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+- (id)expectedResult { return @(NDJSONInflateError); }
+
+#pragma mark - creation and destruction
+
+- (id)initWithName:(NSString *)aName
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		NSMutableData	* theJSONData = [NSMutableData data];
+		for( NSUInteger i = 0; i < 1000; i++ )
+			[theJSONData appendData:[[NSString stringWithFormat:@"{\"line\":%lu,\"value\":\"some text to compress\"}\n", (unsigned long)i] dataUsingEncoding:NSUTF8StringEncoding]];
+		uLongf			theLength = compressBound( (uLong)theJSONData.length );
+		NSMutableData	* theCompressedData = [NSMutableData dataWithLength:theLength];
+		if( compress2( theCompressedData.mutableBytes, &theLength, theJSONData.bytes, (uLong)theJSONData.length, Z_DEFAULT_COMPRESSION ) == Z_OK )
+		{
+			theCompressedData.length = theLength;
+			((uint8_t*)theCompressedData.mutableBytes)[theLength-1] ^= 0xff;		// the last byte of the adler-32 check value
+			data = theCompressedData;
+		}
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError					* theError = nil;
+	NDJSONParser			* theJSON = [[NDJSONParser alloc] initWithJSONData:self.data encoding:NSUTF8StringEncoding];
+	NDJSONDeserializer		* theJSONToPropertyList = [[NDJSONDeserializer alloc] init];
+	id						theResult = [theJSONToPropertyList objectForJSON:theJSON options:NDJSONOptionJSONLines error:&theError];
+	self.lastResult = theError != nil ? @(theError.code) : theResult;
+	return self.lastResult;
+}
+
+@end
@@ -0,0 +1,110 @@
+//
+//  TestGeneratedDecoders.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestGeneratedDecoders.h"
+#import "NDJSONDeserializer.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+#import "TestGeneratedModel.h"
+
+/*
+	decodes jsonString to a TestGeneratedPerson, the result is its dictionaryRepresentation and the keys that were not set by
+	the decoder ndjson-codegen generated in TestGeneratedModelDecoders.m, those are set with key value coding
+ */
+@interface TestGeneratedDecoder : TestProtocolBase
+{
+	NSString					* jsonString;
+	NSDictionary				* expectedObject;
+	NDJSONOptionFlags			options;
+	NSArray						* keyValueCodingKeys;
+}
++ (id)testGeneratedDecoderWithName:(NSString *)name jsonString:(NSString *)json options:(NDJSONOptionFlags)options expectedObject:(NSDictionary *)expectedObject keyValueCodingKeys:(NSArray *)keyValueCodingKeys;
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json options:(NDJSONOptionFlags)options expectedObject:(NSDictionary *)expectedObject keyValueCodingKeys:(NSArray *)keyValueCodingKeys;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			NSDictionary		* expectedObject;
+@property(readonly)			NDJSONOptionFlags	options;
+@property(readonly)			NSArray				* keyValueCodingKeys;
+@end
+
+@implementation TestGeneratedDecoders
+
+- (NSString *)testDescription { return @"Test decoding model classes with decoders generated ahead of time"; }
+
+- (void)addName:(NSString *)aName jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions expectedObject:(NSDictionary *)anExpectedObject keyValueCodingKeys:(NSArray *)aKeyValueCodingKeys
+{
+	[self addTest:[TestGeneratedDecoder testGeneratedDecoderWithName:aName jsonString:aJSON options:anOptions expectedObject:anExpectedObject keyValueCodingKeys:aKeyValueCodingKeys]];
+}
+
+- (void)willLoad
+{
+	NSString		* theJSON = @"{\"full_name\":\"Ada\",\"age\":36,\"score\":9.5,\"secret\":\"x\",\"address\":{\"street\":\"Main\",\"number\":12},\"tags\":[\"a\",\"b\"]}";
+	NSDictionary	* theObject = @{@"name":@"Ada",@"age":@36,@"score":@9.5,@"secret":[NSNull null],@"address":@{@"street":@"Main",@"number":@12},@"tags":@[@"a",@"b"]};
+	NSArray			* theAllKeys = @[@"address",@"age",@"name",@"score",@"tags"];
+
+	[self addName:@"Generated Decoder" jsonString:theJSON options:NDJSONOptionNone expectedObject:theObject keyValueCodingKeys:@[]];
+	[self addName:@"Generated Decoder With Key Tables" jsonString:theJSON options:NDJSONOptionUseKeyTables expectedObject:theObject keyValueCodingKeys:@[]];
+	[self addName:@"Generated Decoder Disabled" jsonString:theJSON options:NDJSONOptionDontUseGeneratedDecoders expectedObject:theObject keyValueCodingKeys:theAllKeys];
+	[self addName:@"Different Key Options" jsonString:theJSON options:NDJSONOptionConvertKeysToMedialCapitals expectedObject:theObject keyValueCodingKeys:theAllKeys];
+	[self addName:@"Value Of Unexpected Type" jsonString:@"{\"name\":\"Ada\",\"score\":\"9.5\"}" options:NDJSONOptionNone expectedObject:@{@"name":@"Ada",@"age":@0,@"score":@9.5,@"secret":[NSNull null],@"address":[NSNull null],@"tags":[NSNull null]} keyValueCodingKeys:@[@"score"]];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestGeneratedDecoder
+
+@synthesize		jsonString,
+				expectedObject,
+				options,
+				keyValueCodingKeys;
+
+#pragma mark - manually implemented properties
+
+- (id)expectedResult { return @{@"object":self.expectedObject,@"keyValueCodingKeys":self.keyValueCodingKeys}; }
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testGeneratedDecoderWithName:(NSString *)aName jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions expectedObject:(NSDictionary *)anExpectedObject keyValueCodingKeys:(NSArray *)aKeyValueCodingKeys
+{
+	return [[self alloc] initWithName:aName jsonString:aJSON options:anOptions expectedObject:anExpectedObject keyValueCodingKeys:aKeyValueCodingKeys];
+}
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions expectedObject:(NSDictionary *)anExpectedObject keyValueCodingKeys:(NSArray *)aKeyValueCodingKeys
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		expectedObject = [anExpectedObject copy];
+		options = anOptions;
+		keyValueCodingKeys = [aKeyValueCodingKeys copy];
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError					* theError = nil;
+	NDJSONParser			* theJSON = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+	NDJSONDeserializer		* theDeserializer = [[NDJSONDeserializer alloc] initWithRootClass:[TestGeneratedPerson class]];
+	TestGeneratedPerson		* thePerson = nil;
+
+	thePerson = [theDeserializer objectForJSON:theJSON options:self.options error:&theError];
+	if( thePerson != nil )
+		self.lastResult = @{@"object":[thePerson dictionaryRepresentation],@"keyValueCodingKeys":[thePerson keysSetWithKeyValueCoding]};
+	self.error = theError;
+	return self.lastResult;
+}
+
+@end
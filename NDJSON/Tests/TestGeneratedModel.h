@@ -0,0 +1,32 @@
+//
+//  TestGeneratedModel.h
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/*
+	the model classes TestGeneratedModelDecoders.m is generated for, Tools/GNUmakefile builds them into a library for
+	ndjson-codegen, so anything declared here as a property becomes a key of the generated decoders
+ */
+@interface TestGeneratedAddress : NSObject
+@property(copy,nonatomic)		NSString				* street;
+@property(assign,nonatomic)		NSInteger				number;
+@end
+
+@interface TestGeneratedPerson : NSObject
+@property(copy,nonatomic)		NSString				* name;
+@property(assign,nonatomic)		NSInteger				age;
+@property(assign,nonatomic)		double					score;
+@property(strong,nonatomic)		TestGeneratedAddress	* address;
+@property(strong,nonatomic)		NSArray					* tags;
+@property(copy,nonatomic)		NSString				* secret;
+- (NSDictionary *)dictionaryRepresentation;
+/*
+	the keys set with -setValue:forKey:, generated decoders send the setters directly
+ */
+- (NSArray *)keysSetWithKeyValueCoding;
+@end
@@ -0,0 +1,57 @@
+//
+//  TestGeneratedModel.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestGeneratedModel.h"
+#import "NDJSONDeserializer.h"
+
+@implementation TestGeneratedAddress
+
+@synthesize		street,
+				number;
+
+@end
+
+@interface TestGeneratedPerson ()
+{
+	NSMutableArray		* keysSetWithKeyValueCoding;
+}
+@end
+
+@implementation TestGeneratedPerson
+
+@synthesize		name,
+				age,
+				score,
+				address,
+				tags,
+				secret;
+
+NDJSONPropertyNamesForKeys( @"name", @"full_name" )
+NDJSONKeysIgnoreSet( @"secret" )
+
+- (void)setValue:(id)aValue forKey:(NSString *)aKey
+{
+	if( keysSetWithKeyValueCoding == nil )
+		keysSetWithKeyValueCoding = [[NSMutableArray alloc] init];
+	[keysSetWithKeyValueCoding addObject:aKey];
+	[super setValue:aValue forKey:aKey];
+}
+
+- (NSArray *)keysSetWithKeyValueCoding { return [keysSetWithKeyValueCoding sortedArrayUsingSelector:@selector(compare:)] ?: @[]; }
+
+- (NSDictionary *)dictionaryRepresentation
+{
+	return @{@"name":self.name ?: [NSNull null],
+			 @"age":@(self.age),
+			 @"score":@(self.score),
+			 @"secret":self.secret ?: [NSNull null],
+			 @"address":self.address != nil ? [self.address dictionaryWithValuesForKeys:@[@"street",@"number"]] : [NSNull null],
+			 @"tags":self.tags ?: [NSNull null]};
+}
+
+@end
@@ -0,0 +1,194 @@
+//
+//	TestGeneratedModelDecoders.m
+//	generated by ndjson-codegen, do not edit
+//
+
+#import <Foundation/Foundation.h>
+#import <objc/runtime.h>
+#import <objc/message.h>
+#import "NDJSONDeserializer.h"
+#import "TestGeneratedModel.h"
+#include <string.h>
+
+static Class		kGeneratedClasses[3];
+
+static Class NDJSONGeneratedClass( NSUInteger anIndex, const char * aName )
+{
+	if( kGeneratedClasses[anIndex] == Nil )
+		kGeneratedClasses[anIndex] = objc_getClass( aName );
+	return kGeneratedClasses[anIndex];
+}
+
+#pragma mark - TestGeneratedPerson
+
+static NSString * const		kTestGeneratedPersonKeys[] = { @"name", @"age", @"score", @"address", @"tags", @"secret", @"full_name" };
+static NSString * const		kTestGeneratedPersonPropertyNames[] = { @"name", @"age", @"score", @"address", @"tags", @"secret", @"name" };
+static const BOOL				kTestGeneratedPersonSkipValues[] = { NO, NO, NO, NO, NO, YES, NO };
+
+static NSUInteger NDJSONTestGeneratedPersonIndexForKey( const char * aKey, NSUInteger aLength )
+{
+	switch( aLength )
+	{
+	case 3:
+		if( memcmp( aKey, "age", 3 ) == 0 ) return 1;
+		break;
+	case 4:
+		if( memcmp( aKey, "name", 4 ) == 0 ) return 0;
+		if( memcmp( aKey, "tags", 4 ) == 0 ) return 4;
+		break;
+	case 5:
+		if( memcmp( aKey, "score", 5 ) == 0 ) return 2;
+		break;
+	case 6:
+		if( memcmp( aKey, "secret", 6 ) == 0 ) return 5;
+		break;
+	case 7:
+		if( memcmp( aKey, "address", 7 ) == 0 ) return 3;
+		break;
+	case 9:
+		if( memcmp( aKey, "full_name", 9 ) == 0 ) return 6;
+		break;
+	}
+	return NSNotFound;
+}
+
+static BOOL NDJSONTestGeneratedPersonSetValue( id anObject, NSUInteger anIndex, id aValue )
+{
+	BOOL		theResult = NO;
+	switch( anIndex )
+	{
+	case 0:
+		if( (theResult = [aValue isKindOfClass:NDJSONGeneratedClass( 0, "NSString" )]) )
+			((void (*)(id, SEL, id))objc_msgSend)( anObject, @selector(setName:), aValue );
+		break;
+	case 1:
+		if( (theResult = [aValue isKindOfClass:[NSNumber class]]) )
+			((void (*)(id, SEL, long long))objc_msgSend)( anObject, @selector(setAge:), [aValue longLongValue] );
+		break;
+	case 2:
+		if( (theResult = [aValue isKindOfClass:[NSNumber class]]) )
+			((void (*)(id, SEL, double))objc_msgSend)( anObject, @selector(setScore:), [aValue doubleValue] );
+		break;
+	case 3:
+		if( (theResult = [aValue isKindOfClass:NDJSONGeneratedClass( 1, "TestGeneratedAddress" )]) )
+			((void (*)(id, SEL, id))objc_msgSend)( anObject, @selector(setAddress:), aValue );
+		break;
+	case 4:
+		if( (theResult = [aValue isKindOfClass:NDJSONGeneratedClass( 2, "NSArray" )]) )
+			((void (*)(id, SEL, id))objc_msgSend)( anObject, @selector(setTags:), aValue );
+		break;
+	case 5:
+		if( (theResult = [aValue isKindOfClass:NDJSONGeneratedClass( 0, "NSString" )]) )
+			((void (*)(id, SEL, id))objc_msgSend)( anObject, @selector(setSecret:), aValue );
+		break;
+	case 6:
+		if( (theResult = [aValue isKindOfClass:NDJSONGeneratedClass( 0, "NSString" )]) )
+			((void (*)(id, SEL, id))objc_msgSend)( anObject, @selector(setName:), aValue );
+		break;
+	}
+	return theResult;
+}
+
+static Class NDJSONTestGeneratedPersonClassForIndex( NSUInteger anIndex )
+{
+	switch( anIndex )
+	{
+	case 0: return NDJSONGeneratedClass( 0, "NSString" );
+	case 3: return NDJSONGeneratedClass( 1, "TestGeneratedAddress" );
+	case 4: return NDJSONGeneratedClass( 2, "NSArray" );
+	case 5: return NDJSONGeneratedClass( 0, "NSString" );
+	case 6: return NDJSONGeneratedClass( 0, "NSString" );
+	}
+	return Nil;
+}
+
+static Class NDJSONTestGeneratedPersonCollectionClassForIndex( NSUInteger anIndex )
+{
+	switch( anIndex )
+	{
+	case 0: return NDJSONGeneratedClass( 0, "NSString" );
+	case 3: return NDJSONGeneratedClass( 1, "TestGeneratedAddress" );
+	case 4: return NDJSONGeneratedClass( 2, "NSArray" );
+	case 5: return NDJSONGeneratedClass( 0, "NSString" );
+	case 6: return NDJSONGeneratedClass( 0, "NSString" );
+	}
+	return Nil;
+}
+
+static const struct NDJSONGeneratedDecoder	kTestGeneratedPersonDecoder = {
+	7, kTestGeneratedPersonKeys, kTestGeneratedPersonPropertyNames, kTestGeneratedPersonSkipValues, 0,
+	NDJSONTestGeneratedPersonIndexForKey, NDJSONTestGeneratedPersonSetValue, NDJSONTestGeneratedPersonClassForIndex, NDJSONTestGeneratedPersonCollectionClassForIndex
+};
+
+#pragma mark - TestGeneratedAddress
+
+static NSString * const		kTestGeneratedAddressKeys[] = { @"street", @"number" };
+static NSString * const		kTestGeneratedAddressPropertyNames[] = { @"street", @"number" };
+static const BOOL				kTestGeneratedAddressSkipValues[] = { NO, NO };
+
+static NSUInteger NDJSONTestGeneratedAddressIndexForKey( const char * aKey, NSUInteger aLength )
+{
+	switch( aLength )
+	{
+	case 6:
+		if( memcmp( aKey, "street", 6 ) == 0 ) return 0;
+		if( memcmp( aKey, "number", 6 ) == 0 ) return 1;
+		break;
+	}
+	return NSNotFound;
+}
+
+static BOOL NDJSONTestGeneratedAddressSetValue( id anObject, NSUInteger anIndex, id aValue )
+{
+	BOOL		theResult = NO;
+	switch( anIndex )
+	{
+	case 0:
+		if( (theResult = [aValue isKindOfClass:NDJSONGeneratedClass( 0, "NSString" )]) )
+			((void (*)(id, SEL, id))objc_msgSend)( anObject, @selector(setStreet:), aValue );
+		break;
+	case 1:
+		if( (theResult = [aValue isKindOfClass:[NSNumber class]]) )
+			((void (*)(id, SEL, long long))objc_msgSend)( anObject, @selector(setNumber:), [aValue longLongValue] );
+		break;
+	}
+	return theResult;
+}
+
+static Class NDJSONTestGeneratedAddressClassForIndex( NSUInteger anIndex )
+{
+	switch( anIndex )
+	{
+	case 0: return NDJSONGeneratedClass( 0, "NSString" );
+	}
+	return Nil;
+}
+
+static Class NDJSONTestGeneratedAddressCollectionClassForIndex( NSUInteger anIndex )
+{
+	switch( anIndex )
+	{
+	case 0: return NDJSONGeneratedClass( 0, "NSString" );
+	}
+	return Nil;
+}
+
+static const struct NDJSONGeneratedDecoder	kTestGeneratedAddressDecoder = {
+	2, kTestGeneratedAddressKeys, kTestGeneratedAddressPropertyNames, kTestGeneratedAddressSkipValues, 0,
+	NDJSONTestGeneratedAddressIndexForKey, NDJSONTestGeneratedAddressSetValue, NDJSONTestGeneratedAddressClassForIndex, NDJSONTestGeneratedAddressCollectionClassForIndex
+};
+
+#pragma mark - registration
+
+@interface TestGeneratedModelDecoders : NSObject
+@end
+
+@implementation TestGeneratedModelDecoders
+
++ (void)load
+{
+	NDJSONRegisterGeneratedDecoder( objc_getClass( "TestGeneratedPerson" ), &kTestGeneratedPersonDecoder );
+	NDJSONRegisterGeneratedDecoder( objc_getClass( "TestGeneratedAddress" ), &kTestGeneratedAddressDecoder );
+}
+
+@end
@@ -0,0 +1,121 @@
+//
+//  TestIndexedInput.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestIndexedInput.h"
+#import "NDJSONDeserializer.h"
+#import "NDJSONIndex.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+
+@interface TestIndexedInput ()
+- (void)addName:(NSString *)name jsonString:(NSString *)json keyPath:(NSString *)keyPath keyValue:(id)keyValue expectedResult:(id)expectedResult options:(NDJSONOptionFlags)anOptions;
+@end
+
+/*
+	indexes the json, then finds the record with the key value, or the last record if keyValue is nil, and parses it from its offset
+ */
+@interface TestIndexedRecord : TestProtocolBase
+{
+	NSString					* jsonString;
+	NSString					* keyPath;
+	id							keyValue;
+	id							expectedResult;
+	NDJSONOptionFlags			options;
+}
++ (id)testIndexedRecordWithName:(NSString *)name jsonString:(NSString *)json keyPath:(NSString *)keyPath keyValue:(id)keyValue expectedResult:(id)expectedResult options:(NDJSONOptionFlags)options;
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json keyPath:(NSString *)keyPath keyValue:(id)keyValue expectedResult:(id)result options:(NDJSONOptionFlags)options;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			NSString			* keyPath;
+@property(readonly)			id					keyValue;
+@property(readonly)			id					expectedResult;
+@property(readonly)			NDJSONOptionFlags	options;
+@end
+
+@implementation TestIndexedInput
+
+- (NSString *)testDescription { return @"Test indexing the records of JSON and parsing a single record from its offset"; }
+
+- (void)addName:(NSString *)aName jsonString:(NSString *)aJSON keyPath:(NSString *)aKeyPath keyValue:(id)aKeyValue expectedResult:(id)aResult options:(NDJSONOptionFlags)anOptions
+{
+	[self addTest:[TestIndexedRecord testIndexedRecordWithName:aName jsonString:aJSON keyPath:aKeyPath keyValue:aKeyValue expectedResult:aResult options:anOptions]];
+}
+
+- (void)willLoad
+{
+	NSString		* theJSONLines = @"{\"id\":1,\"name\":\"one\"}\n{\"id\":2,\"name\":\"two\",\"tags\":[\"a\",{\"id\":7}]}\n  {\"id\":3,\"name\":\"three\"}\n";
+	[self addName:@"JSON Lines Last Record" jsonString:theJSONLines keyPath:nil keyValue:nil expectedResult:@{@"id":@3,@"name":@"three"} options:NDJSONOptionJSONLines];
+	[self addName:@"JSON Lines Key Value" jsonString:theJSONLines keyPath:@"id" keyValue:@2 expectedResult:@{@"id":@2,@"name":@"two",@"tags":@[@"a",@{@"id":@7}]} options:NDJSONOptionJSONLines];
+	[self addName:@"Root Array Elements" jsonString:@"[ \"zero\", [1,2], {\"a\":{\"b\":\"key\"}}, 4.5 ]" keyPath:@"a.b" keyValue:@"key" expectedResult:@{@"a":@{@"b":@"key"}} options:NDJSONOptionNone];
+	[self addName:@"Root Array Last Element" jsonString:@"[ \"zero\", [1,2], {\"a\":{\"b\":\"key\"}}, 4.5 ]" keyPath:nil keyValue:nil expectedResult:@4.5 options:NDJSONOptionNone];
+	[self addName:@"Missing Key Value" jsonString:theJSONLines keyPath:@"id" keyValue:@7 expectedResult:[NSNull null] options:NDJSONOptionJSONLines];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestIndexedRecord
+
+@synthesize		expectedResult,
+				jsonString,
+				keyPath,
+				keyValue,
+				options;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nkey path: %@ = %@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString, self.keyPath, self.keyValue, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testIndexedRecordWithName:(NSString *)aName jsonString:(NSString *)aJSON keyPath:(NSString *)aKeyPath keyValue:(id)aKeyValue expectedResult:(id)aResult options:(NDJSONOptionFlags)anOptions
+{
+	return [[self alloc] initWithName:aName jsonString:aJSON keyPath:aKeyPath keyValue:aKeyValue expectedResult:aResult options:anOptions];
+}
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON keyPath:(NSString *)aKeyPath keyValue:(id)aKeyValue expectedResult:(id)aResult options:(NDJSONOptionFlags)anOptions
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		keyPath = [aKeyPath copy];
+		keyValue = aKeyValue;
+		expectedResult = aResult;
+		options = anOptions;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError					* theError = nil;
+	NSData					* theData = [self.jsonString dataUsingEncoding:NSUTF8StringEncoding];
+	NDJSONParser			* theJSON = [[NDJSONParser alloc] initWithJSONData:theData encoding:NSUTF8StringEncoding];
+	NDJSONIndex				* theIndex = [[[NDJSONIndexer alloc] initWithKeyPath:self.keyPath] indexForJSONParser:theJSON options:self.options error:&theError];
+	if( theIndex != nil )
+	{
+		theIndex = [[NDJSONIndex alloc] initWithData:[theIndex dataRepresentation] error:&theError];
+		NSUInteger				theRecord = self.keyValue != nil ? [theIndex indexOfRecordWithKeyValue:self.keyValue] : theIndex.count-1;
+		if( theRecord != NSNotFound )
+		{
+			NDJSONParser		* theRecordJSON = [[NDJSONParser alloc] initWithJSONData:theData offset:(NSUInteger)[theIndex offsetOfRecordAtIndex:theRecord] encoding:NSUTF8StringEncoding];
+			NDJSONDeserializer	* theJSONParser = [[NDJSONDeserializer alloc] init];
+			self.lastResult = [theJSONParser objectForJSON:theRecordJSON options:NDJSONOptionNone error:&theError];
+		}
+		else
+			self.lastResult = [NSNull null];
+	}
+	self.error = theError;
+	return self.lastResult;
+}
+
+@end
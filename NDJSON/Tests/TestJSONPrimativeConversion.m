@@ -8,6 +8,8 @@
 
 #import "TestJSONPrimativeConversion.h"
 #import "NDJSONDeserializer.h"
+#import "NDJSONTapeParser.h"
+#import "NDJSONSchemaValidator.h"
 #import "TestProtocolBase.h"
 #import "NSObject+TestUtilities.h"
 
@@ -53,6 +55,25 @@ static NSDate * dateWithObjects( id year, id mon, id day, id hr, id min, id sec)
 
 @end
 
+@interface TestConversionTargetWithDateFormats : TestConversionTarget
+@end
+
+@interface TestDataConversionTarget : NSObject
+
+@property(copy)			NSString		* valueSigma;
+@property(copy)			NSData			* valueBeta;
+
++ (id)testDataConversionTargetWithValueSigma:(NSString *)valueSigma valueBeta:(NSData *)valueBeta;
+- (id)initWithValueSigma:(NSString *)valueSigma valueBeta:(NSData *)valueBeta;
+
+@end
+
+@interface TestDataConversionTargetWithConversion : TestDataConversionTarget
+
+- (void)setValueBetaByConvertingString:(NSString *)string;
+
+@end
+
 @interface TestJSONPrimativeConversion ()
 - (void)addName:(NSString *)name jsonString:(NSString *)json expectedResult:(id)expectedResult options:(NDJSONOptionFlags)anOptions targetClass:(Class)targetClass;
 @end
@@ -73,6 +94,24 @@ static NSDate * dateWithObjects( id year, id mon, id day, id hr, id min, id sec)
 @property(readonly)			Class				targetClass;
 @end
 
+/*
+	parses the json from a stream, so long values span more than one refill of the parsers buffer
+ */
+@interface TestStreamConversion : TestConversion
+@end
+
+/*
+	replays a tape of the json, so base64 strings are decoded from the string table of the tape
+ */
+@interface TestTapeConversion : TestConversion
+@end
+
+/*
+	parses the json through an NDJSONSchemaValidator, which has to forward the base64 data to the deserializer
+ */
+@interface TestValidatedConversion : TestConversion
+@end
+
 @implementation TestJSONPrimativeConversion
 
 - (NSString *)testDescription { return @"Test conversion of JSON primative types"; }
@@ -135,6 +174,84 @@ static NSDate * dateWithObjects( id year, id mon, id day, id hr, id min, id sec)
 		  options:NDJSONOptionCovertPrimitiveJSONTypes|NDJSONOptionConvertToArrayTypeIfRequired
 	  targetClass:[TestConversionTargetWithConversion class]];
 
+	TestConversionTarget	* theDateConversionTarget = [TestConversionTarget testConversionTargetWithValueSigma:nil
+																							   valueIota:0
+																							  valueDelta:[NSDate dateWithTimeIntervalSince1970:-61356600]
+																							  valueAlpha:nil
+																								valueChi:nil];
+	[self addName:@"ISO 8601 String to Date"
+	   jsonString:@"{\"valueDelta\":\"1968-01-21T20:30:00Z\"}"
+   expectedResult:theDateConversionTarget
+		  options:NDJSONOptionCovertPrimitiveJSONTypes
+	  targetClass:[TestConversionTarget class]];
+
+	[self addName:@"ISO 8601 String with fraction and offset to Date"
+	   jsonString:@"{\"valueDelta\":\"1968-01-22T06:30:00.500+10:00\"}"
+   expectedResult:[TestConversionTarget testConversionTargetWithValueSigma:nil
+																 valueIota:0
+																valueDelta:[NSDate dateWithTimeIntervalSince1970:-61356599.5]
+																valueAlpha:nil
+																  valueChi:nil]
+		  options:NDJSONOptionCovertPrimitiveJSONTypes
+	  targetClass:[TestConversionTarget class]];
+
+	[self addName:@"Epoch seconds to Date"
+	   jsonString:@"{\"valueDelta\":-61356600}"
+   expectedResult:theDateConversionTarget
+		  options:NDJSONOptionCovertPrimitiveJSONTypes
+	  targetClass:[TestConversionTarget class]];
+
+	[self addName:@"Epoch milliseconds to Date by date formats"
+	   jsonString:@"{\"valueDelta\":-61356600000}"
+   expectedResult:theDateConversionTarget
+		  options:NDJSONOptionCovertPrimitiveJSONTypes
+	  targetClass:[TestConversionTargetWithDateFormats class]];
+
+	[self addName:@"Base64 String to Data"
+	   jsonString:@"{\"valueSigma\":\"SGVsbG8=\",\"valueBeta\":\"SGVsbG8sIFdvcmxkIQ==\"}"
+   expectedResult:[TestDataConversionTarget testDataConversionTargetWithValueSigma:@"SGVsbG8=" valueBeta:[@"Hello, World!" dataUsingEncoding:NSUTF8StringEncoding]]
+		  options:NDJSONOptionCovertPrimitiveJSONTypes
+	  targetClass:[TestDataConversionTarget class]];
+
+	[self addName:@"Unpadded URL Safe Base64 String to Data"
+	   jsonString:@"{\"valueBeta\":\"-_8\"}"
+   expectedResult:[TestDataConversionTarget testDataConversionTargetWithValueSigma:nil valueBeta:[NSData dataWithBytes:(uint8_t[]){0xFB,0xFF} length:2]]
+		  options:NDJSONOptionCovertPrimitiveJSONTypes
+	  targetClass:[TestDataConversionTarget class]];
+
+	[self addName:@"Base64 String with escaped line breaks to Data"
+	   jsonString:@"{\"valueBeta\":\"SGVsbG8s\\nIFdv\\r\\ncmxk\\/A\"}"
+   expectedResult:[TestDataConversionTarget testDataConversionTargetWithValueSigma:nil valueBeta:[[NSData alloc] initWithBase64EncodedString:@"SGVsbG8sIFdvcmxk/A==" options:0]]
+		  options:NDJSONOptionCovertPrimitiveJSONTypes
+	  targetClass:[TestDataConversionTarget class]];
+
+	[self addName:@"Base64 String to Data by converting method"
+	   jsonString:@"{\"valueBeta\":\"SGVsbG8=\"}"
+   expectedResult:[TestDataConversionTarget testDataConversionTargetWithValueSigma:nil valueBeta:[@"SGVsbG8=" dataUsingEncoding:NSUTF8StringEncoding]]
+		  options:NDJSONOptionCovertPrimitiveJSONTypes
+	  targetClass:[TestDataConversionTargetWithConversion class]];
+
+	NSMutableData		* theLongData = [NSMutableData dataWithLength:10000];
+	for( NSUInteger i = 0; i < theLongData.length; i++ )
+		((uint8_t*)theLongData.mutableBytes)[i] = (uint8_t)(i*7+i/256);
+	[self addTest:[TestStreamConversion testConversionWithName:@"Base64 String spanning buffer refills to Data"
+													jsonString:[NSString stringWithFormat:@"{\"valueSigma\":\"long\",\"valueBeta\":\"%@\"}", [theLongData base64EncodedStringWithOptions:0]]
+												expectedResult:[TestDataConversionTarget testDataConversionTargetWithValueSigma:@"long" valueBeta:theLongData]
+													   options:NDJSONOptionCovertPrimitiveJSONTypes
+												   targetClass:[TestDataConversionTarget class]]];
+
+	[self addTest:[TestTapeConversion testConversionWithName:@"Base64 String to Data from a tape"
+												  jsonString:@"{\"valueSigma\":\"SGVsbG8=\",\"valueBeta\":\"SGVsbG8sIFdvcmxkIQ==\"}"
+											  expectedResult:[TestDataConversionTarget testDataConversionTargetWithValueSigma:@"SGVsbG8=" valueBeta:[@"Hello, World!" dataUsingEncoding:NSUTF8StringEncoding]]
+													 options:NDJSONOptionCovertPrimitiveJSONTypes
+												 targetClass:[TestDataConversionTarget class]]];
+
+	[self addTest:[TestValidatedConversion testConversionWithName:@"Base64 String to Data through a schema validator"
+													   jsonString:@"{\"valueSigma\":\"SGVsbG8=\",\"valueBeta\":\"SGVsbG8sIFdvcmxkIQ==\"}"
+												   expectedResult:[TestDataConversionTarget testDataConversionTargetWithValueSigma:@"SGVsbG8=" valueBeta:[@"Hello, World!" dataUsingEncoding:NSUTF8StringEncoding]]
+														  options:NDJSONOptionCovertPrimitiveJSONTypes
+													  targetClass:[TestDataConversionTarget class]]];
+
 	[super willLoad];
 }
 
@@ -191,6 +308,59 @@ static NSDate * dateWithObjects( id year, id mon, id day, id hr, id min, id sec)
 
 @end
 
+@implementation TestStreamConversion
+
+- (id)run
+{
+	NSError				* theError = nil;
+	NSInputStream		* theStream = [NSInputStream inputStreamWithData:[self.jsonString dataUsingEncoding:NSUTF8StringEncoding]];
+	NDJSONParser		* theJSON = [[NDJSONParser alloc] initWithInputStream:theStream encoding:NSUTF8StringEncoding];
+	NDJSONDeserializer	* theJSONParser = [[NDJSONDeserializer alloc] initWithRootClass:self.targetClass];
+	id				theResult = [theJSONParser objectForJSON:theJSON options:self.options error:&theError];
+	self.lastResult = theResult;
+	self.error = theError;
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestTapeConversion
+
+- (id)run
+{
+	NSError				* theError = nil;
+	NDJSONParser		* theSource = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+	NSData				* theTape = [NDJSONTapeParser tapeDataForJSONParser:theSource options:NDJSONOptionNone error:&theError];
+	NDJSONDeserializer	* theJSONParser = [[NDJSONDeserializer alloc] initWithRootClass:self.targetClass];
+	self.lastResult = nil;
+	if( theTape != nil )
+	{
+		NDJSONTapeParser	* theJSON = [[NDJSONTapeParser alloc] initWithTapeData:theTape error:&theError];
+		if( theJSON != nil )
+			self.lastResult = [theJSONParser objectForJSON:theJSON options:self.options error:&theError];
+	}
+	self.error = theError;
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestValidatedConversion
+
+- (id)run
+{
+	NSError				* theError = nil;
+	NDJSONSchema		* theSchema = [NDJSONSchema schemaWithJSONObject:@{@"type":@"object", @"properties":@{@"valueSigma":@{@"type":@"string"}, @"valueBeta":@{@"type":@"string"}}} error:&theError];
+	NDJSONParser		* theJSON = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+	NDJSONDeserializer	* theJSONParser = [[NDJSONDeserializer alloc] initWithRootClass:self.targetClass];
+	theJSONParser.schemaValidator = [[NDJSONSchemaValidator alloc] initWithSchema:theSchema];
+	self.lastResult = [theJSONParser objectForJSON:theJSON options:self.options error:&theError];
+	self.error = theError;
+	return self.lastResult;
+}
+
+@end
+
 @implementation TestConversionTarget
 
 @synthesize			valueSigma,
@@ -300,4 +470,46 @@ static NSDate * dateWithObjects( id year, id mon, id day, id hr, id min, id sec)
 }
 
 
+@end
+
+@implementation TestConversionTargetWithDateFormats
+
+NDJSONDateFormatsForPropertyNames( @(NDJSONDateFormatEpochMilliseconds), @"valueDelta" )
+
+@end
+
+@implementation TestDataConversionTarget
+
+@synthesize			valueSigma,
+					valueBeta;
+
++ (id)testDataConversionTargetWithValueSigma:(NSString *)aString valueBeta:(NSData *)aData
+{
+	return [[self alloc] initWithValueSigma:aString valueBeta:aData];
+}
+- (id)initWithValueSigma:(NSString *)aString valueBeta:(NSData *)aData
+{
+	if( (self = [super init]) != nil )
+	{
+		valueSigma = [aString copy];
+		valueBeta = [aData copy];
+	}
+	return self;
+}
+
+- (BOOL)isLike:(id)anObject
+{
+	TestDataConversionTarget		* theObj = (TestDataConversionTarget*)anObject;
+	return (self.valueSigma == theObj.valueSigma || [self.valueSigma isEqual:theObj.valueSigma])
+			&& (self.valueBeta == theObj.valueBeta || [self.valueBeta isEqual:theObj.valueBeta]);
+}
+
+- (NSString *)description { return [NSString stringWithFormat:@"valueSigma: %@, valueBeta: %lu bytes", self.valueSigma, self.valueBeta.length]; }
+
+@end
+
+@implementation TestDataConversionTargetWithConversion
+
+- (void)setValueBetaByConvertingString:(NSString *)aString { self.valueBeta = [aString dataUsingEncoding:NSUTF8StringEncoding]; }
+
 @end
@@ -9,6 +9,9 @@
 #import "TestJSONRequest.h"
 #import "NDJSONDeserializer.h"
 #import "NDJSONRequest.h"
+#import "NDJSONResponseCache.h"
+#import "NDJSONRequestScheduler.h"
+#import "TestURLProtocol.h"
 #import "TestProtocolBase.h"
 #import "NSObject+TestUtilities.h"
 
@@ -27,6 +30,82 @@
 @property(readonly)			id				expectedResult;
 @end
 
+/*
+	sends count requests at once that all use the same deserializer, the bodies arrive in small chunks so the parses would overlap
+ */
+@interface TestJSONRequestSharedDeserializer : TestProtocolBase
+{
+	NSUInteger		count;
+}
+- (id)initWithName:(NSString *)aName count:(NSUInteger)count;
+
+@property(readonly)			NSUInteger		count;
+@property(readonly)			id				expectedResult;
+@end
+
+/*
+	requests the URLs with the given indexes one after another through a response cache that holds memoryCount bodies in
+	memory and diskCount on disk, the bodies are all the same length. For each request the result is how it was answered,
+	"200", "304 memory" with the same result object as before or "304 disk" with an equal object parsed from the disk,
+	followed by how many bodies the cache then holds in memory and on disk
+ */
+@interface TestJSONRequestCache : TestProtocolBase
+{
+	NSArray			* indexes;
+	NSUInteger		memoryCount,
+					diskCount;
+	id				expectedResult;
+}
+- (id)initWithName:(NSString *)aName indexes:(NSArray *)indexes memoryCount:(NSUInteger)memoryCount diskCount:(NSUInteger)diskCount expectedResult:(id)expectedResult;
+
+@property(readonly)			NSArray			* indexes;
+@property(readonly)			NSUInteger		memoryCount;
+@property(readonly)			NSUInteger		diskCount;
+@property(readonly)			id				expectedResult;
+@end
+
+/*
+	the cache key of a GET request compared with the keys of the same request with one thing changed, the result is whether
+	each is the same key, the validators the cache adds itself must not change the key and everything else must
+ */
+@interface TestJSONRequestCacheKey : TestProtocolBase
+@property(readonly)			id				expectedResult;
+@end
+
+/*
+	sends a request with each of the priorities at once through a scheduler allowing maximumConnections to the host, the
+	first response is slow so the others have to wait for it. The result is the most requests that were loading at once,
+	the indexes of the requests in the order they were started and whether every request got its own result
+ */
+@interface TestJSONRequestScheduler : TestProtocolBase
+{
+	NSArray			* priorities;
+	NSUInteger		maximumConnections;
+	id				expectedResult;
+}
+- (id)initWithName:(NSString *)aName priorities:(NSArray *)priorities maximumConnections:(NSUInteger)maximumConnections expectedResult:(id)expectedResult;
+
+@property(readonly)			NSArray			* priorities;
+@property(readonly)			NSUInteger		maximumConnections;
+@property(readonly)			id				expectedResult;
+@end
+
+/*
+	sends count identical requests at once through a scheduler, along with one that differs only in its headers and one
+	that differs only in its deserializer, the body is slow so the first connection is still loading when the rest are
+	sent. The result is the number of connections made, whether every identical request got the same result object and
+	whether either of the different requests got that object
+ */
+@interface TestJSONRequestCoalescing : TestProtocolBase
+{
+	NSUInteger		count;
+}
+- (id)initWithName:(NSString *)aName count:(NSUInteger)count;
+
+@property(readonly)			NSUInteger		count;
+@property(readonly)			id				expectedResult;
+@end
+
 @implementation TestJSONRequest
 
 - (NSString *)testDescription { return @"Test \\u escape sequences and how they are converted into utf-8"; }
@@ -41,6 +120,20 @@
 {
 	[super willLoad];
 	[self addName:@"Remote File" URLString:@"http://fakester.biz/json"];
+	[self addTest:[[TestJSONRequestSharedDeserializer alloc] initWithName:@"Shared Deserializer" count:8]];
+	[self addTest:[[TestJSONRequestCache alloc] initWithName:@"Cache Store" indexes:@[@0] memoryCount:2 diskCount:2 expectedResult:@[@"200 m1 d1"]]];
+	[self addTest:[[TestJSONRequestCache alloc] initWithName:@"Cache Not Modified in Memory" indexes:@[@0,@0] memoryCount:2 diskCount:0
+					expectedResult:@[@"200 m1 d0",@"304 memory m1 d0"]]];
+	[self addTest:[[TestJSONRequestCache alloc] initWithName:@"Cache Not Modified from Disk" indexes:@[@0,@1,@0,@0,@1] memoryCount:1 diskCount:2
+					expectedResult:@[@"200 m1 d1",@"200 m1 d2",@"304 disk m1 d2",@"304 memory m1 d2",@"304 disk m1 d2"]]];
+	[self addTest:[[TestJSONRequestCache alloc] initWithName:@"Cache Eviction" indexes:@[@0,@1,@0] memoryCount:1 diskCount:0
+					expectedResult:@[@"200 m1 d0",@"200 m1 d0",@"200 m1 d0"]]];
+	[self addTest:[[TestJSONRequestCacheKey alloc] initWithName:@"Cache Key"]];
+	[self addTest:[[TestJSONRequestScheduler alloc] initWithName:@"Scheduler Host Limit" priorities:@[@(NSOperationQueuePriorityNormal),@(NSOperationQueuePriorityNormal),@(NSOperationQueuePriorityNormal),@(NSOperationQueuePriorityNormal),@(NSOperationQueuePriorityNormal),@(NSOperationQueuePriorityNormal)] maximumConnections:2
+					expectedResult:@[@2,@[@0,@1,@2,@3,@4,@5],@YES]]];
+	[self addTest:[[TestJSONRequestScheduler alloc] initWithName:@"Scheduler Priority" priorities:@[@(NSOperationQueuePriorityNormal),@(NSOperationQueuePriorityLow),@(NSOperationQueuePriorityNormal),@(NSOperationQueuePriorityHigh),@(NSOperationQueuePriorityVeryHigh),@(NSOperationQueuePriorityVeryLow)] maximumConnections:1
+					expectedResult:@[@1,@[@0,@4,@3,@2,@1,@5],@YES]]];
+	[self addTest:[[TestJSONRequestCoalescing alloc] initWithName:@"Scheduler Coalescing" count:5]];
 }
 
 @end
@@ -114,3 +207,362 @@
 
 @end
 
+@implementation TestJSONRequestSharedDeserializer
+
+@synthesize		count;
+
+#pragma mark - manually implemented properties
+
+- (id)expectedResult
+{
+	NSMutableArray		* theResult = [NSMutableArray arrayWithCapacity:self.count];
+	for( NSUInteger i = 0; i < self.count; i++ )
+	{
+		NSMutableArray		* theValues = [NSMutableArray arrayWithCapacity:200];
+		for( NSUInteger j = 0; j < 200; j++ )
+			[theValues addObject:@(i*1000+j)];
+		[theResult addObject:@{@"index":@(i),@"values":theValues}];
+	}
+	return theResult;
+}
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"count: %lu\n\nresult:\n%@\n\nexpected result:\n%@\n\n", (unsigned long)self.count, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
+- (id)initWithName:(NSString *)aName count:(NSUInteger)aCount
+{
+	if( (self = [super initWithName:aName]) != nil )
+		count = aCount;
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSString				* theHost = @"shared.deserializer";
+	NDJSONDeserializer		* theJSONDeserializer = [[NDJSONDeserializer alloc] init];
+	NSMutableArray			* theResults = [NSMutableArray arrayWithCapacity:self.count];
+	NSOperationQueue		* theQueue = [[NSOperationQueue alloc] init];
+	NSConditionLock			* theLock = [[NSConditionLock alloc] initWithCondition:0];
+	[TestURLProtocol removeHost:theHost];
+	for( NSUInteger i = 0; i < self.count; i++ )
+	{
+		NSURL					* theURL = [NSURL URLWithString:[NSString stringWithFormat:@"%@://%@/%lu", kTestURLProtocolScheme, theHost, (unsigned long)i]];
+		NSMutableString			* theBody = [NSMutableString stringWithFormat:@"{\"index\":%lu,\"values\":[", (unsigned long)i];
+		for( NSUInteger j = 0; j < 200; j++ )
+			[theBody appendFormat:@"%@%lu", j > 0 ? @"," : @"", (unsigned long)(i*1000+j)];
+		[theBody appendString:@"]}"];
+		[TestURLProtocol setBody:[theBody dataUsingEncoding:NSUTF8StringEncoding] eTag:nil chunkLength:64 chunkDelay:0.002 forURL:theURL];
+		[theResults addObject:[NSNull null]];
+	}
+	for( NSUInteger i = 0; i < self.count; i++ )
+	{
+		NDJSONMutableRequest	* theRequest = [[NDJSONMutableRequest alloc] initWithDeserializer:theJSONDeserializer];
+		theRequest.URL = [NSURL URLWithString:[NSString stringWithFormat:@"%@://%@/%lu", kTestURLProtocolScheme, theHost, (unsigned long)i]];
+		[theRequest sendAsynchronousWithQueue:theQueue responseCompletionHandler:^(NDJSONRequest * aRequest, NDJSONResponse * aResponse) {
+			[theLock lock];
+			if( aResponse.result != nil )
+				[theResults replaceObjectAtIndex:i withObject:aResponse.result];
+			if( aResponse.error != nil )
+				self.error = aResponse.error;
+			[theLock unlockWithCondition:theLock.condition+1];
+		}];
+	}
+	[theLock lockWhenCondition:(NSInteger)self.count];
+	[theLock unlock];
+	self.lastResult = theResults;
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestJSONRequestCache
+
+@synthesize		indexes,
+				memoryCount,
+				diskCount,
+				expectedResult;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"indexes: %@\nmemory: %lu, disk: %lu\n\nresult:\n%@\n\nexpected result:\n%@\n\n", [self.indexes componentsJoinedByString:@","], (unsigned long)self.memoryCount, (unsigned long)self.diskCount, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
+- (id)initWithName:(NSString *)aName indexes:(NSArray *)anIndexes memoryCount:(NSUInteger)aMemoryCount diskCount:(NSUInteger)aDiskCount expectedResult:(id)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		indexes = [anIndexes copy];
+		memoryCount = aMemoryCount;
+		diskCount = aDiskCount;
+		expectedResult = aResult;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (NSURL *)URLForIndex:(NSUInteger)anIndex
+{
+	return [NSURL URLWithString:[NSString stringWithFormat:@"%@://cache.%@/%lu", kTestURLProtocolScheme, [[self.name lowercaseString] stringByReplacingOccurrencesOfString:@" " withString:@"."], (unsigned long)anIndex]];
+}
+
+- (id)run
+{
+	NSString				* theDiskPath = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSProcessInfo processInfo] globallyUniqueString]];
+	NSUInteger				theBodyLength = 0;
+	NDJSONResponseCache		* theCache = nil;
+	NDJSONDeserializer		* theJSONDeserializer = [[NDJSONDeserializer alloc] init];
+	NSOperationQueue		* theQueue = [[NSOperationQueue alloc] init];
+	NSMutableDictionary		* theLastResults = [NSMutableDictionary dictionary];
+	NSMutableArray			* theResult = [NSMutableArray arrayWithCapacity:self.indexes.count];
+
+	[TestURLProtocol removeHost:[self URLForIndex:0].host];
+	for( NSNumber * theIndex in self.indexes )
+	{
+		NSData		* theBody = [[NSString stringWithFormat:@"{\"index\":%u,\"values\":[\"alpha\",\"beta\",\"gamma\"]}", theIndex.unsignedIntValue%10] dataUsingEncoding:NSUTF8StringEncoding];
+		[TestURLProtocol setBody:theBody eTag:[NSString stringWithFormat:@"\"%@\"", theIndex] chunkLength:0 chunkDelay:0.0 forURL:[self URLForIndex:theIndex.unsignedIntegerValue]];
+		theBodyLength = theBody.length;
+	}
+	theCache = [[NDJSONResponseCache alloc] initWithMemoryCapacity:self.memoryCount*theBodyLength diskCapacity:self.diskCount*theBodyLength diskPath:self.diskCount > 0 ? theDiskPath : nil];
+
+	for( NSNumber * theIndex in self.indexes )
+	{
+		NSURL					* theURL = [self URLForIndex:theIndex.unsignedIntegerValue];
+		NSUInteger				theNotModifiedCount = [TestURLProtocol notModifiedCountForURL:theURL];
+		NDJSONMutableRequest	* theRequest = [[NDJSONMutableRequest alloc] initWithDeserializer:theJSONDeserializer];
+		NSConditionLock			* theLock = [[NSConditionLock alloc] initWithCondition:NO];
+		__block NDJSONResponse	* theResponse = nil;
+		id						thePreviousResult = [theLastResults objectForKey:theIndex];
+		NSString				* theAnswer = nil;
+
+		theRequest.URL = theURL;
+		theRequest.responseCache = theCache;
+		[theRequest sendAsynchronousWithQueue:theQueue responseCompletionHandler:^(NDJSONRequest * aRequest, NDJSONResponse * aResponse) {
+			[theLock lock];
+			theResponse = aResponse;
+			[theLock unlockWithCondition:YES];
+		}];
+		[theLock lockWhenCondition:YES];
+		[theLock unlock];
+
+		if( theResponse.error != nil )
+		{
+			self.error = theResponse.error;
+			theAnswer = @"error";
+		}
+		else if( [TestURLProtocol notModifiedCountForURL:theURL] == theNotModifiedCount )
+			theAnswer = @"200";
+		else if( theResponse.result == thePreviousResult )
+			theAnswer = @"304 memory";
+		else if( [theResponse.result isEqual:thePreviousResult] )
+			theAnswer = @"304 disk";
+		else
+			theAnswer = @"304 wrong result";
+		if( theResponse.result != nil )
+			[theLastResults setObject:theResponse.result forKey:theIndex];
+		[theResult addObject:[NSString stringWithFormat:@"%@ m%lu d%lu", theAnswer, (unsigned long)(theCache.currentMemoryUsage/theBodyLength), (unsigned long)(theCache.currentDiskUsage/theBodyLength)]];
+	}
+	[theCache removeAllCachedResults];
+	[[NSFileManager defaultManager] removeItemAtPath:theDiskPath error:NULL];
+	self.lastResult = theResult;
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestJSONRequestCacheKey
+
+#pragma mark - manually implemented properties
+
+- (id)expectedResult { return @{@"authorization":@NO,@"accept":@NO,@"deserializer class":@NO,@"deserializer options":@NO,@"validators":@YES}; }
+
+#pragma mark - execution
+
+- (NSString *)cacheKeyWithDeserializer:(NDJSONDeserializer *)aDeserializer options:(NDJSONOptionFlags)anOptions headers:(NSDictionary *)aHeaders
+{
+	NDJSONMutableRequest	* theRequest = [[NDJSONMutableRequest alloc] initWithDeserializer:aDeserializer deserializerOptions:anOptions];
+	NSMutableURLRequest		* theURLRequest = [NSMutableURLRequest requestWithURL:[NSURL URLWithString:@"http://cache.key/list"]];
+	[theURLRequest setAllHTTPHeaderFields:aHeaders];
+	return [NDJSONResponseCache cacheKeyForRequest:theRequest URLRequest:theURLRequest];
+}
+
+- (id)run
+{
+	NDJSONDeserializer		* theDeserializer = [[NDJSONDeserializer alloc] init];
+	NSDictionary			* theHeaders = @{@"Accept":@"application/json",@"Authorization":@"Bearer first"};
+	NSString				* theKey = [self cacheKeyWithDeserializer:theDeserializer options:NDJSONOptionNone headers:theHeaders];
+	self.lastResult = @{
+		@"authorization":@([theKey isEqualToString:[self cacheKeyWithDeserializer:theDeserializer options:NDJSONOptionNone headers:@{@"Accept":@"application/json",@"Authorization":@"Bearer second"}]]),
+		@"accept":@([theKey isEqualToString:[self cacheKeyWithDeserializer:theDeserializer options:NDJSONOptionNone headers:@{@"Accept":@"text/plain",@"Authorization":@"Bearer first"}]]),
+		@"deserializer class":@([theKey isEqualToString:[self cacheKeyWithDeserializer:[[NDJSONDeserializer alloc] initWithRootClass:[NSMutableDictionary class]] options:NDJSONOptionNone headers:theHeaders]]),
+		@"deserializer options":@([theKey isEqualToString:[self cacheKeyWithDeserializer:theDeserializer options:NDJSONOptionStrict headers:theHeaders]]),
+		@"validators":@([theKey isEqualToString:[self cacheKeyWithDeserializer:[[NDJSONDeserializer alloc] init] options:NDJSONOptionNone headers:@{@"Accept":@"application/json",@"Authorization":@"Bearer first",@"If-None-Match":@"\"1\"",@"If-Modified-Since":@"Mon, 19 Oct 2026 00:00:00 GMT"}]])
+	};
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestJSONRequestScheduler
+
+@synthesize		priorities,
+				maximumConnections,
+				expectedResult;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"priorities: %@\nmaximum connections: %lu\n\nresult:\n%@\n\nexpected result:\n%@\n\n", [self.priorities componentsJoinedByString:@","], (unsigned long)self.maximumConnections, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
+- (id)initWithName:(NSString *)aName priorities:(NSArray *)aPriorities maximumConnections:(NSUInteger)aMaximumConnections expectedResult:(id)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		priorities = [aPriorities copy];
+		maximumConnections = aMaximumConnections;
+		expectedResult = aResult;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSString				* theHost = [NSString stringWithFormat:@"%@.scheduler", [[self.name lowercaseString] stringByReplacingOccurrencesOfString:@" " withString:@"."]];
+	NDJSONRequestScheduler	* theScheduler = [[NDJSONRequestScheduler alloc] initWithMaximumConnectionsPerHost:self.maximumConnections maximumConcurrentParses:1];
+	NDJSONDeserializer		* theJSONDeserializer = [[NDJSONDeserializer alloc] init];
+	NSOperationQueue		* theQueue = [[NSOperationQueue alloc] init];
+	NSConditionLock			* theLock = [[NSConditionLock alloc] initWithCondition:0];
+	NSMutableArray			* theStarted = [NSMutableArray arrayWithCapacity:self.priorities.count];
+	__block BOOL			theAllResults = YES;
+
+	[TestURLProtocol removeHost:theHost];
+	for( NSUInteger i = 0; i < self.priorities.count; i++ )
+	{
+		NSData		* theBody = [[NSString stringWithFormat:@"{\"index\":%lu,\"padding\":\"%@\"}", (unsigned long)i, [@"" stringByPaddingToLength:256 withString:@"0123456789" startingAtIndex:0]] dataUsingEncoding:NSUTF8StringEncoding];
+		[TestURLProtocol setBody:theBody eTag:nil chunkLength:i == 0 ? 32 : 128 chunkDelay:i == 0 ? 0.02 : 0.005 forURL:[NSURL URLWithString:[NSString stringWithFormat:@"%@://%@/%lu", kTestURLProtocolScheme, theHost, (unsigned long)i]]];
+	}
+	for( NSUInteger i = 0; i < self.priorities.count; i++ )
+	{
+		NDJSONMutableRequest	* theRequest = [[NDJSONMutableRequest alloc] initWithDeserializer:theJSONDeserializer];
+		theRequest.URL = [NSURL URLWithString:[NSString stringWithFormat:@"%@://%@/%lu", kTestURLProtocolScheme, theHost, (unsigned long)i]];
+		theRequest.scheduler = theScheduler;
+		theRequest.priority = [[self.priorities objectAtIndex:i] integerValue];
+		[theRequest sendAsynchronousWithQueue:theQueue responseCompletionHandler:^(NDJSONRequest * aRequest, NDJSONResponse * aResponse) {
+			[theLock lock];
+			if( ![[aResponse.result objectForKey:@"index"] isEqual:@(i)] )
+				theAllResults = NO;
+			if( aResponse.error != nil )
+				self.error = aResponse.error;
+			[theLock unlockWithCondition:theLock.condition+1];
+		}];
+	}
+	[theLock lockWhenCondition:(NSInteger)self.priorities.count];
+	[theLock unlock];
+
+	for( NSURL * theURL in [TestURLProtocol startedURLsForHost:theHost] )
+		[theStarted addObject:@([theURL.lastPathComponent integerValue])];
+	self.lastResult = @[@([TestURLProtocol maximumConcurrentRequestsForHost:theHost]),theStarted,@(theAllResults)];
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestJSONRequestCoalescing
+
+@synthesize		count;
+
+#pragma mark - manually implemented properties
+
+- (id)expectedResult { return @{@"connections":@3,@"same result":@YES,@"different headers coalesced":@NO,@"different deserializer coalesced":@NO}; }
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"count: %lu\n\nresult:\n%@\n\nexpected result:\n%@\n\n", (unsigned long)self.count, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
+- (id)initWithName:(NSString *)aName count:(NSUInteger)aCount
+{
+	if( (self = [super initWithName:aName]) != nil )
+		count = aCount;
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSString				* theHost = @"coalescing.scheduler";
+	NSURL					* theURL = [NSURL URLWithString:[NSString stringWithFormat:@"%@://%@/list", kTestURLProtocolScheme, theHost]];
+	NDJSONRequestScheduler	* theScheduler = [[NDJSONRequestScheduler alloc] initWithMaximumConnectionsPerHost:4 maximumConcurrentParses:1];
+	NDJSONDeserializer		* theJSONDeserializer = [[NDJSONDeserializer alloc] init];
+	NSOperationQueue		* theQueue = [[NSOperationQueue alloc] init];
+	NSConditionLock			* theLock = [[NSConditionLock alloc] initWithCondition:0];
+	NSMutableArray			* theResults = [NSMutableArray arrayWithCapacity:self.count];
+	__block id				theDifferentHeadersResult = nil,
+							theDifferentDeserializerResult = nil;
+	NSMutableArray			* theRequests = [NSMutableArray arrayWithCapacity:self.count+2];
+	BOOL					theSameResult = YES;
+
+	[TestURLProtocol removeHost:theHost];
+	[TestURLProtocol setBody:[[NSString stringWithFormat:@"{\"values\":[\"%@\"]}", [@"" stringByPaddingToLength:512 withString:@"0123456789" startingAtIndex:0]] dataUsingEncoding:NSUTF8StringEncoding] eTag:nil chunkLength:32 chunkDelay:0.01 forURL:theURL];
+	for( NSUInteger i = 0; i < self.count+2; i++ )
+	{
+		NDJSONMutableRequest	* theRequest = [[NDJSONMutableRequest alloc] initWithDeserializer:i == self.count+1 ? [[NDJSONDeserializer alloc] init] : theJSONDeserializer];
+		theRequest.URL = theURL;
+		theRequest.HTTPHeaders = @{@"Accept":i == self.count ? @"text/plain" : @"application/json"};
+		theRequest.scheduler = theScheduler;
+		[theRequests addObject:theRequest];
+	}
+	for( NSUInteger i = 0; i < theRequests.count; i++ )
+	{
+		[[theRequests objectAtIndex:i] sendAsynchronousWithQueue:theQueue responseCompletionHandler:^(NDJSONRequest * aRequest, NDJSONResponse * aResponse) {
+			[theLock lock];
+			if( i == self.count )
+				theDifferentHeadersResult = aResponse.result;
+			else if( i == self.count+1 )
+				theDifferentDeserializerResult = aResponse.result;
+			else if( aResponse.result != nil )
+				[theResults addObject:aResponse.result];
+			if( aResponse.error != nil )
+				self.error = aResponse.error;
+			[theLock unlockWithCondition:theLock.condition+1];
+		}];
+	}
+	[theLock lockWhenCondition:(NSInteger)theRequests.count];
+	[theLock unlock];
+
+	if( theResults.count != self.count )
+		theSameResult = NO;
+	for( id theResult in theResults )
+	{
+		if( theResult != theResults.firstObject )
+			theSameResult = NO;
+	}
+	self.lastResult = @{
+		@"connections":@([TestURLProtocol requestCountForURL:theURL]),
+		@"same result":@(theSameResult),
+		@"different headers coalesced":@(theDifferentHeadersResult == theResults.firstObject),
+		@"different deserializer coalesced":@(theDifferentDeserializerResult == theResults.firstObject)
+	};
+	return self.lastResult;
+}
+
+@end
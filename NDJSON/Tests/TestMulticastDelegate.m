@@ -0,0 +1,245 @@
+//
+//  TestMulticastDelegate.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestMulticastDelegate.h"
+#import "NDJSONDeserializer.h"
+#import "NDJSONMulticastDelegate.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+
+/*
+	records the events it is sent as a space separated string, and skips the values of skipKeys
+ */
+@interface TestEventRecorder : NSObject <NDJSONParserDelegate>
+- (id)initWithSkipKeys:(NSSet *)skipKeys;
+- (void)addEvent:(NSString *)event;
+@property(readonly)			NSSet				* skipKeys;
+@property(readonly)			NSMutableString		* events;
+@end
+
+/*
+	a recorder that takes strings as bytes with jsonParser:foundStringBytes:length:, recorded as b:string
+ */
+@interface TestStringBytesRecorder : TestEventRecorder
+@end
+
+@interface TestMulticastDelegate ()
+- (void)addName:(NSString *)name jsonString:(NSString *)json skipKeys:(NSArray *)skipKeys expectedResult:(id)expectedResult deserialize:(BOOL)deserialize;
+@end
+
+/*
+	parses the json once with a recorder for each set in skipKeys, and an NDJSONDeserializer if deserialize is YES, the result is the events of each recorder followed by the deserialized object
+ */
+@interface TestMulticast : TestProtocolBase
+{
+	NSString					* jsonString;
+	NSArray						* skipKeys;
+	id							expectedResult;
+	BOOL						deserialize;
+}
++ (id)testMulticastWithName:(NSString *)name jsonString:(NSString *)json skipKeys:(NSArray *)skipKeys expectedResult:(id)expectedResult deserialize:(BOOL)deserialize;
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json skipKeys:(NSArray *)skipKeys expectedResult:(id)result deserialize:(BOOL)deserialize;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			NSArray				* skipKeys;
+@property(readonly)			id					expectedResult;
+@property(readonly)			BOOL				deserialize;
+@end
+
+/*
+	parses the json with a TestEventRecorder and a TestStringBytesRecorder, the result is the events of each
+ */
+@interface TestMulticastStringBytes : TestProtocolBase
+{
+	NSString					* jsonString;
+	id							expectedResult;
+}
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json expectedResult:(id)result;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			id					expectedResult;
+@end
+
+@implementation TestMulticastDelegate
+
+- (NSString *)testDescription { return @"Test sending the events of a single parse to several delegates"; }
+
+- (void)addName:(NSString *)aName jsonString:(NSString *)aJSON skipKeys:(NSArray *)aSkipKeys expectedResult:(id)aResult deserialize:(BOOL)aDeserialize
+{
+	[self addTest:[TestMulticast testMulticastWithName:aName jsonString:aJSON skipKeys:aSkipKeys expectedResult:aResult deserialize:aDeserialize]];
+}
+
+- (void)willLoad
+{
+	NSString		* theJSON = @"{\"a\":1,\"b\":[true,null,{\"c\":\"x\"}],\"d\":{\"e\":2.5}}";
+	[self addName:@"Every Delegate Sent Events" jsonString:theJSON skipKeys:@[[NSSet set],[NSSet set]] expectedResult:@[@"{ a 1 b [ T N { c x } ] d { e 2.5 } }",@"{ a 1 b [ T N { c x } ] d { e 2.5 } }"] deserialize:NO];
+	[self addName:@"One Delegate Skipping" jsonString:theJSON skipKeys:@[[NSSet setWithObject:@"b"],[NSSet set]] expectedResult:@[@"{ a 1 b d { e 2.5 } }",@"{ a 1 b [ T N { c x } ] d { e 2.5 } }"] deserialize:NO];
+	[self addName:@"Both Delegates Skipping Different Values" jsonString:theJSON skipKeys:@[[NSSet setWithObjects:@"b",@"e",nil],[NSSet setWithObject:@"d"]] expectedResult:@[@"{ a 1 b d { e } }",@"{ a 1 b [ T N { c x } ] d }"] deserialize:NO];
+	[self addName:@"All Delegates Skipping" jsonString:theJSON skipKeys:@[[NSSet setWithObjects:@"b",@"a",nil],[NSSet setWithObject:@"b"]] expectedResult:@[@"{ a b d { e 2.5 } }",@"{ a 1 b d { e 2.5 } }"] deserialize:NO];
+	[self addName:@"Deserializer With Other Delegates" jsonString:theJSON skipKeys:@[[NSSet setWithObject:@"b"]] expectedResult:@[@"{ a 1 b d { e 2.5 } }",@{@"a":@1,@"b":@[@YES,[NSNull null],@{@"c":@"x"}],@"d":@{@"e":@2.5}}] deserialize:YES];
+	[self addTest:[[TestMulticastStringBytes alloc] initWithName:@"String Bytes and String Delegates" jsonString:@"[\"abc\",{\"k\":\"d\\u00e9f\"}]"
+		expectedResult:@[@"[ abc { k déf } ]",@"[ b:abc { k b:déf } ]"]]];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestMulticast
+
+@synthesize		expectedResult,
+				jsonString,
+				skipKeys,
+				deserialize;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nskip keys: %@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString, self.skipKeys, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testMulticastWithName:(NSString *)aName jsonString:(NSString *)aJSON skipKeys:(NSArray *)aSkipKeys expectedResult:(id)aResult deserialize:(BOOL)aDeserialize
+{
+	return [[self alloc] initWithName:aName jsonString:aJSON skipKeys:aSkipKeys expectedResult:aResult deserialize:aDeserialize];
+}
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON skipKeys:(NSArray *)aSkipKeys expectedResult:(id)aResult deserialize:(BOOL)aDeserialize
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		skipKeys = [aSkipKeys copy];
+		expectedResult = aResult;
+		deserialize = aDeserialize;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError						* theError = nil;
+	NDJSONParser				* theJSON = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+	NSMutableArray				* theRecorders = [NSMutableArray array];
+	NSMutableArray				* theDelegates = [NSMutableArray array];
+	NSMutableArray				* theResult = [NSMutableArray array];
+	NDJSONDeserializer			* theDeserializer = self.deserialize ? [[NDJSONDeserializer alloc] init] : nil;
+	NDJSONMulticastDelegate		* theMulticastDelegate = nil;
+	id							theObject = nil;
+
+	for( NSSet * theSkipKeys in self.skipKeys )
+		[theRecorders addObject:[[TestEventRecorder alloc] initWithSkipKeys:theSkipKeys]];
+	[theDelegates addObjectsFromArray:theRecorders];
+	if( theDeserializer != nil )
+		[theDelegates addObject:theDeserializer];
+	theMulticastDelegate = [[NDJSONMulticastDelegate alloc] initWithDelegates:theDelegates];
+	theJSON.delegate = theMulticastDelegate;
+	if( theDeserializer != nil )
+		theObject = [theDeserializer objectForJSON:theJSON options:NDJSONOptionNone error:&theError];
+	else if( ![theJSON parseWithOptions:NDJSONOptionNone] )
+		theError = [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONGeneralError userInfo:nil];
+
+	for( TestEventRecorder * theRecorder in theRecorders )
+		[theResult addObject:theRecorder.events];
+	if( theObject != nil )
+		[theResult addObject:theObject];
+	self.lastResult = theResult;
+	self.error = theError;
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestMulticastStringBytes
+
+@synthesize		expectedResult,
+				jsonString;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON expectedResult:(id)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		expectedResult = aResult;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NDJSONParser				* theJSON = [[NDJSONParser alloc] initWithJSONData:[self.jsonString dataUsingEncoding:NSUTF8StringEncoding] encoding:NSUTF8StringEncoding];
+	TestEventRecorder			* theStringRecorder = [[TestEventRecorder alloc] initWithSkipKeys:[NSSet set]],
+								* theBytesRecorder = [[TestStringBytesRecorder alloc] initWithSkipKeys:[NSSet set]];
+	NDJSONMulticastDelegate		* theMulticastDelegate = [[NDJSONMulticastDelegate alloc] initWithDelegates:@[theStringRecorder,theBytesRecorder]];
+	theJSON.delegate = theMulticastDelegate;
+	if( ![theJSON parseWithOptions:NDJSONOptionNone] )
+		self.error = [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONGeneralError userInfo:nil];
+	self.lastResult = @[theStringRecorder.events,theBytesRecorder.events];
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestEventRecorder
+
+@synthesize		skipKeys,
+				events;
+
+- (id)initWithSkipKeys:(NSSet *)aSkipKeys
+{
+	if( (self = [super init]) != nil )
+	{
+		skipKeys = [aSkipKeys copy];
+		events = [[NSMutableString alloc] init];
+	}
+	return self;
+}
+
+- (void)addEvent:(NSString *)anEvent
+{
+	if( events.length > 0 )
+		[events appendString:@" "];
+	[events appendString:anEvent];
+}
+
+- (void)jsonParserDidStartArray:(NDJSONParser *)aJSON { [self addEvent:@"["]; }
+- (void)jsonParserDidEndArray:(NDJSONParser *)aJSON { [self addEvent:@"]"]; }
+- (void)jsonParserDidStartObject:(NDJSONParser *)aJSON { [self addEvent:@"{"]; }
+- (void)jsonParserDidEndObject:(NDJSONParser *)aJSON { [self addEvent:@"}"]; }
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldSkipValueForKey:(NSString *)aKey { return [self.skipKeys containsObject:aKey]; }
+- (void)jsonParser:(NDJSONParser *)aJSON foundKey:(NSString *)aValue { [self addEvent:aValue]; }
+- (void)jsonParser:(NDJSONParser *)aJSON foundString:(NSString *)aValue { [self addEvent:aValue]; }
+- (void)jsonParser:(NDJSONParser *)aJSON foundInteger:(NSInteger)aValue { [self addEvent:[NSString stringWithFormat:@"%ld", (long)aValue]]; }
+- (void)jsonParser:(NDJSONParser *)aJSON foundFloat:(double)aValue { [self addEvent:[NSString stringWithFormat:@"%g", aValue]]; }
+- (void)jsonParser:(NDJSONParser *)aJSON foundBool:(BOOL)aValue { [self addEvent:aValue ? @"T" : @"F"]; }
+- (void)jsonParserFoundNULL:(NDJSONParser *)aJSON { [self addEvent:@"N"]; }
+
+@end
+
+@implementation TestStringBytesRecorder
+
+- (void)jsonParser:(NDJSONParser *)aJSON foundStringBytes:(const uint8_t *)aBytes length:(NSUInteger)aLength
+{
+	NSString		* theValue = [[NSString alloc] initWithBytes:aBytes length:aLength encoding:NSUTF8StringEncoding];
+	[self addEvent:[@"b:" stringByAppendingString:theValue]];
+}
+
+@end
@@ -0,0 +1,213 @@
+//
+//  TestParseStatistics.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestParseStatistics.h"
+#import "NDJSONParser.h"
+#import "NDJSONDeserializer.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+
+/*
+	the counters that do not depend on timing or on how the input is buffered
+ */
+static NSDictionary * TestStatisticsCounts( NDJSONParseStatistics * aStatistics, NSArray * aKeys )
+{
+	NSMutableDictionary		* theResult = [NSMutableDictionary dictionaryWithCapacity:aKeys.count];
+	for( NSString * theKey in aKeys )
+		[theResult setObject:[aStatistics valueForKey:theKey] forKey:theKey];
+	return theResult;
+}
+
+/*
+	without NDJSONCollectStatistics nothing is counted, so every counter is expected to stay 0
+ */
+static NSDictionary * TestStatisticsExpectedCounts( NSDictionary * aCounts )
+{
+#ifdef NDJSONCollectStatistics
+	return aCounts;
+#else
+	NSMutableDictionary		* theResult = [NSMutableDictionary dictionaryWithCapacity:aCounts.count];
+	for( NSString * theKey in aCounts )
+		[theResult setObject:@0 forKey:theKey];
+	return theResult;
+#endif
+}
+
+@interface TestParseStatistics ()
+- (void)addName:(NSString *)name jsonString:(NSString *)json options:(NDJSONOptionFlags)options repeat:(NSUInteger)repeat expectedResult:(NSDictionary *)expectedResult;
+@end
+
+/*
+	parses the json repeat times with the same statistics, the values of keys named skip are skipped, the result is the
+	counters of the statistics followed by whether every counter is 0 after reset
+ */
+@interface TestParseStatisticsItem : TestProtocolBase <NDJSONParserDelegate>
+{
+	NSString					* jsonString;
+	NDJSONOptionFlags			options;
+	NSUInteger					repeat;
+	NSDictionary				* expectedCounts;
+}
++ (id)testParseStatisticsItemWithName:(NSString *)name jsonString:(NSString *)json options:(NDJSONOptionFlags)options repeat:(NSUInteger)repeat expectedResult:(NSDictionary *)expectedResult;
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json options:(NDJSONOptionFlags)options repeat:(NSUInteger)repeat expectedResult:(NSDictionary *)expectedResult;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			NDJSONOptionFlags	options;
+@property(readonly)			NSUInteger			repeat;
+@property(readonly)			id					expectedResult;
+@end
+
+/*
+	deserializes the json twice with the statistics set on a NDJSONDeserializer, the result is the counters which are
+	accumulated across both calls to objectForJSON:options:error:
+ */
+@interface TestParseStatisticsDeserializer : TestProtocolBase
+{
+	NSString					* jsonString;
+	NSDictionary				* expectedCounts;
+}
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json expectedResult:(NSDictionary *)expectedResult;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			id					expectedResult;
+@end
+
+@implementation TestParseStatistics
+
+- (NSString *)testDescription { return @"Test the counters collected by NDJSONParseStatistics"; }
+
+- (void)addName:(NSString *)aName jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions repeat:(NSUInteger)aRepeat expectedResult:(NSDictionary *)aResult
+{
+	[self addTest:[TestParseStatisticsItem testParseStatisticsItemWithName:aName jsonString:aJSON options:anOptions repeat:aRepeat expectedResult:aResult]];
+}
+
+- (void)willLoad
+{
+	[self addName:@"Token Counts" jsonString:@"{\"a\":[1,2.5,\"x\",true,false,null],\"b\":{\"c\":\"yz\"}}" options:NDJSONOptionNone repeat:1
+		expectedResult:@{@"objectCount":@2,@"arrayCount":@1,@"keyCount":@3,@"stringCount":@2,@"integerCount":@1,@"floatCount":@1,@"booleanCount":@2,@"nullCount":@1,@"maximumDepth":@2,@"stringsCreated":@5,@"stringBytesCopied":@6,@"skippedKeyCount":@0,@"documentCount":@1}];
+	[self addName:@"Skipped Keys" jsonString:@"{\"skip\":{\"x\":[1,\"s\"]},\"a\":1,\"skip\":\"str\"}" options:NDJSONOptionNone repeat:1
+		expectedResult:@{@"objectCount":@1,@"arrayCount":@0,@"keyCount":@3,@"stringCount":@0,@"integerCount":@1,@"maximumDepth":@1,@"stringsCreated":@3,@"stringBytesCopied":@9,@"skippedKeyCount":@2,@"documentCount":@1}];
+	[self addName:@"JSON Lines" jsonString:@"{\"a\":1}\n{\"a\":2}\n[3]\n" options:NDJSONOptionJSONLines repeat:1
+		expectedResult:@{@"objectCount":@2,@"arrayCount":@1,@"keyCount":@2,@"integerCount":@3,@"maximumDepth":@1,@"stringsCreated":@2,@"stringBytesCopied":@2,@"documentCount":@3}];
+	[self addName:@"Accumulated" jsonString:@"[[[1]],\"a\"]" options:NDJSONOptionNone repeat:3
+		expectedResult:@{@"arrayCount":@9,@"integerCount":@3,@"stringCount":@3,@"maximumDepth":@3,@"stringsCreated":@3,@"stringBytesCopied":@3,@"documentCount":@3}];
+	[self addTest:[[TestParseStatisticsDeserializer alloc] initWithName:@"Deserializer" jsonString:@"{\"a\":1,\"b\":[true,null]}"
+		expectedResult:@{@"objectCount":@2,@"arrayCount":@2,@"keyCount":@4,@"integerCount":@2,@"booleanCount":@2,@"nullCount":@2,@"documentCount":@2}]];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestParseStatisticsItem
+
+@synthesize		jsonString,
+				options,
+				repeat;
+
+#pragma mark - manually implemented properties
+
+- (id)expectedResult { return @[TestStatisticsExpectedCounts(expectedCounts),@YES]; }
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nrepeat: %lu\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString, (unsigned long)self.repeat, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testParseStatisticsItemWithName:(NSString *)aName jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions repeat:(NSUInteger)aRepeat expectedResult:(NSDictionary *)aResult
+{
+	return [[self alloc] initWithName:aName jsonString:aJSON options:anOptions repeat:aRepeat expectedResult:aResult];
+}
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions repeat:(NSUInteger)aRepeat expectedResult:(NSDictionary *)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		options = anOptions;
+		repeat = aRepeat;
+		expectedCounts = [aResult copy];
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NDJSONParseStatistics	* theStatistics = [[NDJSONParseStatistics alloc] init];
+	NSDictionary			* theCounts = nil;
+	BOOL					theReset = YES;
+	for( NSUInteger i = 0; i < self.repeat && self.error == nil; i++ )
+	{
+		NDJSONParser		* theParser = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+		theParser.delegate = self;
+		theParser.statistics = theStatistics;
+		[theParser parseWithOptions:self.options];
+	}
+	theCounts = TestStatisticsCounts( theStatistics, [expectedCounts allKeys] );
+	[theStatistics reset];
+	for( NSNumber * theValue in [[theStatistics dictionaryRepresentation] allValues] )
+	{
+		if( [theValue doubleValue] != 0.0 )
+			theReset = NO;
+	}
+	self.lastResult = @[theCounts,@(theReset)];
+	return self.lastResult;
+}
+
+#pragma mark - NDJSONParserDelegate methods
+
+- (BOOL)jsonParser:(NDJSONParser *)aParser shouldSkipValueForKey:(NSString *)aKey { return [aKey isEqualToString:@"skip"]; }
+- (void)jsonParser:(NDJSONParser *)aParser error:(NSError *)anError { self.error = anError; }
+
+@end
+
+@implementation TestParseStatisticsDeserializer
+
+@synthesize		jsonString;
+
+#pragma mark - manually implemented properties
+
+- (id)expectedResult { return TestStatisticsExpectedCounts(expectedCounts); }
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON expectedResult:(NSDictionary *)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		expectedCounts = [aResult copy];
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError					* theError = nil;
+	NDJSONDeserializer		* theJSONDeserializer = [[NDJSONDeserializer alloc] init];
+	theJSONDeserializer.statistics = [[NDJSONParseStatistics alloc] init];
+	for( NSUInteger i = 0; i < 2 && theError == nil; i++ )
+	{
+		NDJSONParser		* theParser = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+		[theJSONDeserializer objectForJSON:theParser options:NDJSONOptionNone error:&theError];
+	}
+	self.error = theError;
+	self.lastResult = TestStatisticsCounts( theJSONDeserializer.statistics, [expectedCounts allKeys] );
+	return self.lastResult;
+}
+
+@end
@@ -0,0 +1,326 @@
+//
+//  TestPipelinedInput.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestPipelinedInput.h"
+#import "NDJSONDeserializer.h"
+#import "NDJSONPipelinedParser.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+
+@interface TestPipelinedInput ()
+- (void)addName:(NSString *)name jsonString:(NSString *)json expectedResult:(id)expectedResult options:(NDJSONOptionFlags)anOptions;
+@end
+
+/*
+	deserializes the json with the scanning on a second thread, with a ring of capacity records and skippedKeys skipped by the scanner
+ */
+@interface TestPipelined : TestProtocolBase
+{
+	NSString					* jsonString;
+	id							expectedResult;
+	NDJSONOptionFlags			options;
+	NSSet						* skippedKeys;
+	NSUInteger					capacity;
+}
++ (id)testPipelinedWithName:(NSString *)name jsonString:(NSString *)json expectedResult:(id)expectedResult options:(NDJSONOptionFlags)options skippedKeys:(NSSet *)skippedKeys capacity:(NSUInteger)capacity;
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json expectedResult:(id)result options:(NDJSONOptionFlags)options skippedKeys:(NSSet *)skippedKeys capacity:(NSUInteger)capacity;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			id					expectedResult;
+@property(readonly)			NDJSONOptionFlags	options;
+@property(readonly)			NSSet				* skippedKeys;
+@property(readonly)			NSUInteger			capacity;
+@end
+
+/*
+	parses the json with the scanning on a second thread and a delegate that records the events it is sent, skipping the
+	values of skippedKeys itself and aborting parsing when it is sent the integer abortValue
+ */
+@interface TestPipelinedEvents : TestProtocolBase
+{
+	NSString					* jsonString;
+	id							expectedResult;
+	NSSet						* skippedKeys;
+	NSNumber					* abortValue;
+	NSUInteger					capacity;
+}
++ (id)testPipelinedEventsWithName:(NSString *)name jsonString:(NSString *)json expectedResult:(id)expectedResult skippedKeys:(NSSet *)skippedKeys abortValue:(NSNumber *)abortValue capacity:(NSUInteger)capacity;
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json expectedResult:(id)result skippedKeys:(NSSet *)skippedKeys abortValue:(NSNumber *)abortValue capacity:(NSUInteger)capacity;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			id					expectedResult;
+@property(readonly)			NSSet				* skippedKeys;
+@property(readonly)			NSNumber			* abortValue;
+@property(readonly)			NSUInteger			capacity;
+@end
+
+/*
+	like TestPipelinedEvents but the delegate throws an exception when it is sent the integer abortValue, the result is the
+	name of the exception caught, the events and whether the scanning parser has its own delegate back
+ */
+@interface TestPipelinedException : TestPipelinedEvents
+@end
+
+/*
+	containers are recorded as their brackets, keys as key:<key>, values as themselves and nothing is recorded after the
+	first error, when sent the integer abortValue parsing is aborted or with throwsAtAbortValue an exception is thrown
+ */
+@interface TestPipelineRecorder : NSObject <NDJSONParserDelegate>
+{
+	NSMutableArray				* events;
+	NSSet						* skippedKeys;
+	NSNumber					* abortValue;
+	BOOL						foundError,
+								throwsAtAbortValue;
+}
+- (id)initWithSkippedKeys:(NSSet *)skippedKeys abortValue:(NSNumber *)abortValue;
+@property(readonly)			NSArray				* events;
+@property(assign)			BOOL				throwsAtAbortValue;
+@end
+
+@implementation TestPipelinedInput
+
+- (NSString *)testDescription { return @"Test scanning JSON on a second thread while it is deserialized"; }
+
+- (void)addName:(NSString *)aName jsonString:(NSString *)aJSON expectedResult:(id)aResult options:(NDJSONOptionFlags)anOptions
+{
+	[self addTest:[TestPipelined testPipelinedWithName:aName jsonString:aJSON expectedResult:aResult options:anOptions skippedKeys:nil capacity:0]];
+}
+
+- (void)willLoad
+{
+	NSMutableString		* theLargeJSON = [NSMutableString stringWithString:@"["];
+	NSMutableArray		* theLargeResult = [NSMutableArray arrayWithCapacity:5000];
+	for( NSUInteger i = 0; i < 5000; i++ )
+	{
+		[theLargeJSON appendFormat:@"%@{\"index\":%lu,\"name\":\"item %lu\",\"tags\":[true,null,%lu.5]}", i > 0 ? @"," : @"", (unsigned long)i, (unsigned long)i, (unsigned long)i];
+		[theLargeResult addObject:@{@"index":@(i),@"name":[NSString stringWithFormat:@"item %lu", (unsigned long)i],@"tags":@[@YES,[NSNull null],@(i+0.5)]}];
+	}
+	[theLargeJSON appendString:@"]"];
+
+	[self addName:@"Scalar" jsonString:@"\"String Value\"" expectedResult:@"String Value" options:NDJSONOptionNone];
+	[self addName:@"Numbers" jsonString:@"[1,-2,3.5,-0.003,314159265358979e-14]" expectedResult:@[@1,@-2,@3.5,@-0.003,@3.14159265358979] options:NDJSONOptionNone];
+	[self addName:@"Literals" jsonString:@"[true,false,null]" expectedResult:@[@YES,@NO,[NSNull null]] options:NDJSONOptionNone];
+	[self addName:@"Nested" jsonString:@"{\"a\":{\"b\":[1,{\"c\":\"d\"}],\"e\":{}},\"f\":[]}" expectedResult:@{@"a":@{@"b":@[@1,@{@"c":@"d"}],@"e":@{}},@"f":@[]} options:NDJSONOptionNone];
+	[self addName:@"JSON Lines" jsonString:@"{\"a\":1}\n{\"a\":2}\n" expectedResult:@[@{@"a":@1},@{@"a":@2}] options:NDJSONOptionJSONLines];
+	[self addTest:[TestPipelined testPipelinedWithName:@"Skipped Keys" jsonString:@"{\"a\":{\"b\":[1,{\"c\":\"d\"}],\"e\":{}},\"b\":\"skipped\",\"f\":[{\"b\":null,\"g\":2}]}" expectedResult:@{@"a":@{@"e":@{}},@"f":@[@{@"g":@2}]} options:NDJSONOptionNone skippedKeys:[NSSet setWithObject:@"b"] capacity:0]];
+	[self addTest:[TestPipelined testPipelinedWithName:@"Full Ring" jsonString:theLargeJSON expectedResult:theLargeResult options:NDJSONOptionNone skippedKeys:nil capacity:64]];
+
+	NSMutableString		* theIntegersJSON = [NSMutableString stringWithString:@"[0"];
+	for( NSUInteger i = 1; i < 5000; i++ )
+		[theIntegersJSON appendFormat:@",%lu", (unsigned long)i];
+	[theIntegersJSON appendString:@"]"];
+
+	[self addTest:[TestPipelinedEvents testPipelinedEventsWithName:@"Values Skipped by the Delegate"
+														jsonString:@"{\"a\":{\"b\":[1,{\"c\":\"d\"}],\"e\":{}},\"b\":\"skipped\",\"f\":[{\"b\":null,\"g\":2}]}"
+													expectedResult:@{@"result":@YES, @"events":@[@"{",@"key:a",@"{",@"key:b",@"key:e",@"{",@"}",@"}",@"key:b",@"key:f",@"[",@"{",@"key:b",@"key:g",@2,@"}",@"]",@"}",@"end"]}
+													   skippedKeys:[NSSet setWithObject:@"b"]
+														abortValue:nil
+														  capacity:0]];
+	[self addTest:[TestPipelinedEvents testPipelinedEventsWithName:@"Aborted by the Delegate"
+														jsonString:theIntegersJSON
+													expectedResult:@{@"result":@NO, @"events":@[@"[",@0,@1,@2,@3,@"end"]}
+													   skippedKeys:nil
+														abortValue:@3
+														  capacity:64]];
+	[self addTest:[TestPipelinedEvents testPipelinedEventsWithName:@"Parse Error"
+														jsonString:@"{\"a\":1,\"b\":}"
+													expectedResult:@{@"result":@NO, @"events":@[@"{",@"key:a",@1,@"key:b",@"error"]}
+													   skippedKeys:nil
+														abortValue:nil
+														  capacity:0]];
+	[self addTest:[TestPipelinedException testPipelinedEventsWithName:@"Exception Thrown by the Delegate"
+															jsonString:theIntegersJSON
+														expectedResult:@{@"exception":@"TestPipelineException", @"events":@[@"[",@0,@1,@2,@3], @"delegateRestored":@YES}
+														   skippedKeys:nil
+															abortValue:@3
+															  capacity:64]];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestPipelined
+
+@synthesize		expectedResult,
+				jsonString,
+				options,
+				skippedKeys,
+				capacity;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString.length < 1024 ? self.jsonString : [self.jsonString substringToIndex:1024], [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testPipelinedWithName:(NSString *)aName jsonString:(NSString *)aJSON expectedResult:(id)aResult options:(NDJSONOptionFlags)anOptions skippedKeys:(NSSet *)aSkippedKeys capacity:(NSUInteger)aCapacity
+{
+	return [[self alloc] initWithName:aName jsonString:aJSON expectedResult:aResult options:anOptions skippedKeys:aSkippedKeys capacity:aCapacity];
+}
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON expectedResult:(id)aResult options:(NDJSONOptionFlags)anOptions skippedKeys:(NSSet *)aSkippedKeys capacity:(NSUInteger)aCapacity
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		expectedResult = aResult;
+		options = anOptions;
+		skippedKeys = [aSkippedKeys copy];
+		capacity = aCapacity;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError					* theError = nil;
+	NDJSONParser			* theSource = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+	NDJSONPipelinedParser	* theJSON = self.capacity > 0 ? [[NDJSONPipelinedParser alloc] initWithJSONParser:theSource capacity:self.capacity] : [[NDJSONPipelinedParser alloc] initWithJSONParser:theSource];
+	NDJSONDeserializer		* theJSONParser = [[NDJSONDeserializer alloc] init];
+	theJSON.skippedKeys = self.skippedKeys;
+	self.lastResult = [theJSONParser objectForJSON:theJSON options:self.options error:&theError];
+	self.error = theError;
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestPipelinedEvents
+
+@synthesize		expectedResult,
+				jsonString,
+				skippedKeys,
+				abortValue,
+				capacity;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString.length < 1024 ? self.jsonString : [self.jsonString substringToIndex:1024], [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testPipelinedEventsWithName:(NSString *)aName jsonString:(NSString *)aJSON expectedResult:(id)aResult skippedKeys:(NSSet *)aSkippedKeys abortValue:(NSNumber *)anAbortValue capacity:(NSUInteger)aCapacity
+{
+	return [[self alloc] initWithName:aName jsonString:aJSON expectedResult:aResult skippedKeys:aSkippedKeys abortValue:anAbortValue capacity:aCapacity];
+}
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON expectedResult:(id)aResult skippedKeys:(NSSet *)aSkippedKeys abortValue:(NSNumber *)anAbortValue capacity:(NSUInteger)aCapacity
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		expectedResult = aResult;
+		skippedKeys = [aSkippedKeys copy];
+		abortValue = anAbortValue;
+		capacity = aCapacity;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NDJSONParser			* theSource = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+	NDJSONPipelinedParser	* theJSON = self.capacity > 0 ? [[NDJSONPipelinedParser alloc] initWithJSONParser:theSource capacity:self.capacity] : [[NDJSONPipelinedParser alloc] initWithJSONParser:theSource];
+	TestPipelineRecorder	* theRecorder = [[TestPipelineRecorder alloc] initWithSkippedKeys:self.skippedKeys abortValue:self.abortValue];
+	BOOL					theResult = NO;
+	theJSON.delegate = theRecorder;
+	theResult = [theJSON parseWithOptions:NDJSONOptionNone];
+	self.lastResult = @{@"result":@(theResult), @"events":theRecorder.events};
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestPipelinedException
+
+#pragma mark - execution
+
+/*
+	the ring is much smaller than the document so the scanning thread is waiting for space when the exception is thrown
+ */
+- (id)run
+{
+	NDJSONParser			* theSource = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+	NDJSONPipelinedParser	* theJSON = [[NDJSONPipelinedParser alloc] initWithJSONParser:theSource capacity:self.capacity];
+	TestPipelineRecorder	* theRecorder = [[TestPipelineRecorder alloc] initWithSkippedKeys:self.skippedKeys abortValue:self.abortValue];
+	NSString				* theExceptionName = @"none";
+	theRecorder.throwsAtAbortValue = YES;
+	theJSON.delegate = theRecorder;
+	@try
+	{
+		[theJSON parseWithOptions:NDJSONOptionNone];
+	}
+	@catch( NSException * anException )
+	{
+		theExceptionName = anException.name;
+	}
+	self.lastResult = @{@"exception":theExceptionName, @"events":theRecorder.events, @"delegateRestored":@(theSource.delegate == nil)};
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestPipelineRecorder
+
+@synthesize		events,
+				throwsAtAbortValue;
+
+- (id)initWithSkippedKeys:(NSSet *)aSkippedKeys abortValue:(NSNumber *)anAbortValue
+{
+	if( (self = [super init]) != nil )
+	{
+		events = [[NSMutableArray alloc] init];
+		skippedKeys = [aSkippedKeys copy];
+		abortValue = anAbortValue;
+	}
+	return self;
+}
+
+- (void)record:(id)anEvent
+{
+	if( !foundError )
+		[events addObject:anEvent];
+}
+
+- (void)jsonParserDidEndDocument:(NDJSONParser *)aJSON { [self record:@"end"]; }
+- (void)jsonParserDidStartArray:(NDJSONParser *)aJSON { [self record:@"["]; }
+- (void)jsonParserDidEndArray:(NDJSONParser *)aJSON { [self record:@"]"]; }
+- (void)jsonParserDidStartObject:(NDJSONParser *)aJSON { [self record:@"{"]; }
+- (void)jsonParserDidEndObject:(NDJSONParser *)aJSON { [self record:@"}"]; }
+- (BOOL)jsonParser:(NDJSONParser *)aJSON shouldSkipValueForKey:(NSString *)aKey { return [skippedKeys containsObject:aKey]; }
+- (void)jsonParser:(NDJSONParser *)aJSON foundKey:(NSString *)aValue { [self record:[@"key:" stringByAppendingString:aValue]]; }
+- (void)jsonParser:(NDJSONParser *)aJSON foundString:(NSString *)aValue { [self record:aValue]; }
+- (void)jsonParser:(NDJSONParser *)aJSON foundInteger:(NSInteger)aValue
+{
+	[self record:@(aValue)];
+	if( abortValue != nil && aValue == abortValue.integerValue )
+	{
+		if( throwsAtAbortValue )
+			@throw [NSException exceptionWithName:@"TestPipelineException" reason:@"thrown by the test delegate" userInfo:nil];
+		[aJSON abortParsing];
+	}
+}
+- (void)jsonParser:(NDJSONParser *)aJSON foundFloat:(double)aValue { [self record:@(aValue)]; }
+- (void)jsonParser:(NDJSONParser *)aJSON foundBool:(BOOL)aValue { [self record:@(aValue)]; }
+- (void)jsonParserFoundNULL:(NDJSONParser *)aJSON { [self record:[NSNull null]]; }
+- (void)jsonParser:(NDJSONParser *)aJSON error:(NSError *)anError
+{
+	[self record:@"error"];
+	foundError = YES;
+}
+
+@end
@@ -0,0 +1,114 @@
+//
+//  TestQuery.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestQuery.h"
+#import "NDJSONQuery.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+
+@interface TestQuery ()
+- (void)addName:(NSString *)name query:(NSString *)query jsonString:(NSString *)json options:(NDJSONOptionFlags)options expectedResult:(id)expectedResult;
+@end
+
+/*
+	evaluates query over json, the result is the array of aggregate results, or NSNull if the query does not compile
+ */
+@interface TestQueryEvaluation : TestProtocolBase
+{
+	NSString					* query;
+	NSString					* jsonString;
+	NDJSONOptionFlags			options;
+	id							expectedResult;
+}
++ (id)testQueryEvaluationWithName:(NSString *)name query:(NSString *)query jsonString:(NSString *)json options:(NDJSONOptionFlags)options expectedResult:(id)expectedResult;
+- (id)initWithName:(NSString *)name query:(NSString *)query jsonString:(NSString *)json options:(NDJSONOptionFlags)options expectedResult:(id)expectedResult;
+
+@property(readonly)			NSString			* query;
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			NDJSONOptionFlags	options;
+@property(readonly)			id					expectedResult;
+@end
+
+@implementation TestQuery
+
+- (NSString *)testDescription { return @"Test aggregate queries evaluated while parsing"; }
+
+- (void)addName:(NSString *)aName query:(NSString *)aQuery jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions expectedResult:(id)aResult
+{
+	[self addTest:[TestQueryEvaluation testQueryEvaluationWithName:aName query:aQuery jsonString:aJSON options:anOptions expectedResult:aResult]];
+}
+
+- (void)willLoad
+{
+	NSString		* theLines = @"{\"price\":2,\"name\":\"a\"}\n{\"price\":3.5,\"name\":\"b\"}\n{\"name\":\"a\",\"price\":0.5}\n{\"name\":\"c\",\"tags\":[1,2]}\n";
+	NSString		* theOrders = @"[{\"items\":[{\"price\":10,\"currency\":\"EUR\"},{\"currency\":\"USD\",\"price\":5},{\"price\":2,\"currency\":\"EUR\"}]},{\"items\":[{\"currency\":\"EUR\",\"price\":1}],\"currency\":\"USD\"}]";
+	NSString		* thePayments = @"{\"status\":\"paid\",\"total\":12}\n{\"total\":20,\"status\":\"open\"}\n{\"status\":\"paid\",\"total\":5}\n{\"total\":10,\"status\":\"paid\"}\n";
+
+	[self addName:@"Aggregates" query:@"count(*), sum(/price), min(/price), max(/price), avg(/price)" jsonString:theLines options:NDJSONOptionJSONLines expectedResult:@[@4,@6.0,@0.5,@3.5,@2.0]];
+	[self addName:@"Count And Distinct" query:@"count(/name), distinct(/name), count(/tags/*)" jsonString:theLines options:NDJSONOptionJSONLines expectedResult:@[@4,@3,@2]];
+	[self addName:@"Condition On The Same Element" query:@"sum(/items/*/price) where /items/*/currency == \"EUR\"" jsonString:theOrders options:NDJSONOptionNone expectedResult:@[@13]];
+	[self addName:@"Condition On The Record" query:@"sum(/items/*/price) where /currency == \"USD\"" jsonString:theOrders options:NDJSONOptionNone expectedResult:@[@1]];
+	[self addName:@"Several Conditions" query:@"count(*), sum(/total) where /status == \"paid\" and /total >= 10" jsonString:thePayments options:NDJSONOptionJSONLines expectedResult:@[@2,@22]];
+	[self addName:@"Array Index" query:@"sum(/values/1), max(/values/*)" jsonString:@"[{\"values\":[1,2,3]},{\"values\":[4,5]}]" options:NDJSONOptionNone expectedResult:@[@7,@5]];
+	[self addName:@"Single Record" query:@"sum(/a/*), min(/b)" jsonString:@"{\"a\":{\"x\":1,\"y\":2.5}}" options:NDJSONOptionNone expectedResult:@[@3.5,[NSNull null]]];
+	[self addName:@"Invalid Query" query:@"median(/price)" jsonString:theLines options:NDJSONOptionJSONLines expectedResult:[NSNull null]];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestQueryEvaluation
+
+@synthesize		query,
+				jsonString,
+				options,
+				expectedResult;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"query:\n%@\n\njson:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.query, self.jsonString, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testQueryEvaluationWithName:(NSString *)aName query:(NSString *)aQuery jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions expectedResult:(id)aResult
+{
+	return [[self alloc] initWithName:aName query:aQuery jsonString:aJSON options:anOptions expectedResult:aResult];
+}
+- (id)initWithName:(NSString *)aName query:(NSString *)aQuery jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions expectedResult:(id)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		query = [aQuery copy];
+		jsonString = [aJSON copy];
+		options = anOptions;
+		expectedResult = aResult;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError				* theError = nil;
+	NDJSONQuery			* theQuery = [NDJSONQuery queryWithString:self.query error:&theError];
+	if( theQuery != nil )
+	{
+		NDJSONParser	* theJSON = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+		self.lastResult = [theQuery resultsForJSONParser:theJSON options:self.options error:&theError];
+		self.error = theError;
+	}
+	else
+		self.lastResult = [NSNull null];
+	return self.lastResult;
+}
+
+@end
@@ -0,0 +1,236 @@
+//
+//  TestReader.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestReader.h"
+#import "NDJSONParser.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+
+@interface TestReader ()
+- (void)addName:(NSString *)name jsonString:(NSString *)json options:(NDJSONOptionFlags)options expectedResult:(id)expectedResult;
+@end
+
+/*
+	reads every token of the json as a string, the values of keys named skip are skipped with skipValue, the result ends
+	with the error code if reading fails
+ */
+@interface TestReaderTokens : TestProtocolBase
+{
+	NSString					* jsonString;
+	NDJSONOptionFlags			options;
+	id							expectedResult;
+}
++ (id)testReaderTokensWithName:(NSString *)name jsonString:(NSString *)json options:(NDJSONOptionFlags)options expectedResult:(id)expectedResult;
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json options:(NDJSONOptionFlags)options expectedResult:(id)expectedResult;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			NDJSONOptionFlags	options;
+@property(readonly)			id					expectedResult;
+@end
+
+/*
+	decodes an array of objects larger than the stream buffer with enterArray, nextElement, enterObject and nextKeyBytes:,
+	the result is the count of objects, the sum of their ids and the name of the last
+ */
+@interface TestReaderDecoder : TestProtocolBase
+{
+	NSUInteger					count;
+}
++ (id)testReaderDecoderWithName:(NSString *)name count:(NSUInteger)count;
+- (id)initWithName:(NSString *)name count:(NSUInteger)count;
+
+@property(readonly)			NSUInteger			count;
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			id					expectedResult;
+@end
+
+@implementation TestReader
+
+- (NSString *)testDescription { return @"Test reading JSON a token at a time"; }
+
+- (void)addName:(NSString *)aName jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions expectedResult:(id)aResult
+{
+	[self addTest:[TestReaderTokens testReaderTokensWithName:aName jsonString:aJSON options:anOptions expectedResult:aResult]];
+}
+
+- (void)willLoad
+{
+	[self addName:@"Tokens" jsonString:@"{\"a\":1,\"b\":[2.5,\"x\",true,false,null],\"c\":{}}" options:NDJSONOptionNone
+		expectedResult:@[@"{",@"k:a",@"i:1",@"k:b",@"[",@"f:2.5",@"s:x",@"b:1",@"b:0",@"n",@"]",@"k:c",@"{",@"}",@"}"]];
+	[self addName:@"Escaped String" jsonString:@"[\"a\\\"b\\n\",\"\"]" options:NDJSONOptionNone
+		expectedResult:@[@"[",@"s:a\"b\n",@"s:",@"]"]];
+	[self addName:@"Skip Value" jsonString:@"{\"skip\":{\"x\":[1,{\"y\":\"}]\"}]},\"a\":1,\"skip\":\"str\",\"b\":[{\"skip\":[[]]},2],\"skip\":-3}" options:NDJSONOptionNone
+		expectedResult:@[@"{",@"k:a",@"i:1",@"k:b",@"[",@"{",@"}",@"i:2",@"]",@"}"]];
+	[self addName:@"JSON Lines" jsonString:@"{\"a\":1}\n[2]\n\"three\"\n4\n" options:NDJSONOptionJSONLines
+		expectedResult:@[@"{",@"k:a",@"i:1",@"}",@"[",@"i:2",@"]",@"s:three",@"i:4"]];
+	[self addName:@"Trailing Comma" jsonString:@"{\"a\":[1,2,],}" options:NDJSONOptionNone
+		expectedResult:@[@"{",@"k:a",@"[",@"i:1",@"i:2",@"]",@"}"]];
+	[self addName:@"Missing Comma" jsonString:@"[1 2]" options:NDJSONOptionStrict
+		expectedResult:@[@"[",@"i:1",@(NDJSONBadFormatError)]];
+	[self addName:@"Strict White Space in Strings" jsonString:@"{\"a b\":\" c d \"}" options:NDJSONOptionStrict
+		expectedResult:@[@"{",@"k:a b",@"s: c d ",@"}"]];
+	[self addName:@"Strict Control Character in String" jsonString:@"[\"a\tb\"]" options:NDJSONOptionStrict
+		expectedResult:@[@"[",@(NDJSONBadFormatError)]];
+	[self addName:@"Premature End" jsonString:@"{\"a\":[1" options:NDJSONOptionNone
+		expectedResult:@[@"{",@"k:a",@"[",@"i:1",@(NDJSONPrematureEndError)]];
+	[self addTest:[TestReaderDecoder testReaderDecoderWithName:@"Stream Decoder" count:400]];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestReaderTokens
+
+@synthesize		jsonString,
+				options,
+				expectedResult;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testReaderTokensWithName:(NSString *)aName jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions expectedResult:(id)aResult
+{
+	return [[self alloc] initWithName:aName jsonString:aJSON options:anOptions expectedResult:aResult];
+}
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions expectedResult:(id)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		options = anOptions;
+		expectedResult = aResult;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NDJSONReader		* theReader = [[NDJSONReader alloc] initWithJSONData:[self.jsonString dataUsingEncoding:NSUTF8StringEncoding] encoding:NSUTF8StringEncoding];
+	NSMutableArray		* theResult = [NSMutableArray array];
+	NDJSONTokenType		theType = NDJSONTokenNone;
+	[theReader startWithOptions:self.options];
+	while( (theType = [theReader nextToken]) != NDJSONTokenNone )
+	{
+		NSString		* theString = [[NSString alloc] initWithBytes:theReader.stringBytes length:theReader.stringLength encoding:NSUTF8StringEncoding];
+		switch( theType )
+		{
+		case NDJSONTokenStartObject: [theResult addObject:@"{"]; break;
+		case NDJSONTokenEndObject: [theResult addObject:@"}"]; break;
+		case NDJSONTokenStartArray: [theResult addObject:@"["]; break;
+		case NDJSONTokenEndArray: [theResult addObject:@"]"]; break;
+		case NDJSONTokenKey:
+			if( [theString isEqualToString:@"skip"] )
+				[theReader skipValue];
+			else
+				[theResult addObject:[@"k:" stringByAppendingString:theString]];
+			break;
+		case NDJSONTokenString: [theResult addObject:[@"s:" stringByAppendingString:theString]]; break;
+		case NDJSONTokenInteger: [theResult addObject:[NSString stringWithFormat:@"i:%lld", (long long)theReader.integerValue]]; break;
+		case NDJSONTokenFloat: [theResult addObject:[NSString stringWithFormat:@"f:%g", theReader.floatValue]]; break;
+		case NDJSONTokenBool: [theResult addObject:[NSString stringWithFormat:@"b:%d", (int)theReader.boolValue]]; break;
+		case NDJSONTokenNull: [theResult addObject:@"n"]; break;
+		default: break;
+		}
+	}
+	if( theReader.error != nil )
+		[theResult addObject:@(theReader.error.code)];
+	[theReader finish];
+	self.lastResult = theResult;
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestReaderDecoder
+
+@synthesize		count;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)jsonString
+{
+	NSMutableString		* theResult = [NSMutableString stringWithString:@"["];
+	for( NSUInteger i = 0; i < self.count; i++ )
+		[theResult appendFormat:@"%@{\"id\":%lu,\"tags\":[\"a\",{\"b\":[1,2]}],\"name\":\"item %lu\",\"ratio\":%lu.5}", i > 0 ? @"," : @"", (unsigned long)i, (unsigned long)i, (unsigned long)i];
+	[theResult appendString:@"]"];
+	return theResult;
+}
+
+- (id)expectedResult { return @[@(self.count),@(self.count*(self.count-1)/2),[NSString stringWithFormat:@"item %lu", (unsigned long)self.count-1]]; }
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"count: %lu\n\nresult:\n%@\n\nexpected result:\n%@\n\n", (unsigned long)self.count, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testReaderDecoderWithName:(NSString *)aName count:(NSUInteger)aCount
+{
+	return [[self alloc] initWithName:aName count:aCount];
+}
+- (id)initWithName:(NSString *)aName count:(NSUInteger)aCount
+{
+	if( (self = [super initWithName:aName]) != nil )
+		count = aCount;
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSInputStream		* theStream = [NSInputStream inputStreamWithData:[self.jsonString dataUsingEncoding:NSUTF8StringEncoding]];
+	NDJSONReader		* theReader = [[NDJSONReader alloc] initWithInputStream:theStream encoding:NSUTF8StringEncoding];
+	NSUInteger			theCount = 0;
+	int64_t				theSum = 0;
+	NSString			* theName = nil;
+	NSError				* theError = nil;
+	[theReader startWithOptions:NDJSONOptionStrict];
+	if( [theReader enterArray] )
+	{
+		while( [theReader nextElement] )
+		{
+			const uint8_t	* theKey = NULL;
+			NSUInteger		theKeyLength = 0;
+			if( ![theReader enterObject] )
+				break;
+			theCount++;
+			while( (theKey = [theReader nextKeyBytes:&theKeyLength]) != NULL )
+			{
+				int64_t			theIdentifier = 0;
+				const uint8_t	* theBytes = NULL;
+				NSUInteger		theLength = 0;
+				if( theKeyLength == 2 && memcmp( theKey, "id", 2 ) == 0 && [theReader readInt64:&theIdentifier] )
+					theSum += theIdentifier;
+				else if( theKeyLength == 4 && memcmp( theKey, "name", 4 ) == 0 && (theBytes = [theReader readStringBytes:&theLength]) != NULL )
+					theName = [[NSString alloc] initWithBytes:theBytes length:theLength encoding:NSUTF8StringEncoding];
+				else if( ![theReader skipValue] )
+					break;
+			}
+		}
+	}
+	if( [theReader nextToken] != NDJSONTokenNone )
+		theError = [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONTrailingGarbageError userInfo:@{NSLocalizedDescriptionKey:@"tokens after the end of the array"}];
+	if( theReader.error != nil )
+		theError = theReader.error;
+	[theReader finish];
+	self.lastResult = @[@(theCount),@(theSum),theName != nil ? theName : [NSNull null]];
+	self.error = theError;
+	return self.lastResult;
+}
+
+@end
@@ -0,0 +1,130 @@
+//
+//  TestSchemaValidation.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestSchemaValidation.h"
+#import "NDJSONDeserializer.h"
+#import "NDJSONSchemaValidator.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+
+@interface TestSchemaValidation ()
+- (void)addName:(NSString *)name jsonString:(NSString *)json schema:(id)schema expectedResult:(id)expectedResult;
+@end
+
+/*
+	the expected result of an invalid document is the JSON Pointer and keyword of the first violation
+ */
+@interface TestSchemaDocument : TestProtocolBase
+{
+	NSString					* jsonString;
+	id							schema;
+	id							expectedResult;
+}
++ (id)testSchemaDocumentWithName:(NSString *)name jsonString:(NSString *)json schema:(id)schema expectedResult:(id)expectedResult;
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json schema:(id)schema expectedResult:(id)result;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			id					schema;
+@property(readonly)			id					expectedResult;
+@end
+
+@implementation TestSchemaValidation
+
+- (NSString *)testDescription { return @"Test JSON Schema validation while deserializing, invalid documents are aborted at the first violation which is reported with the JSON Pointer of the value."; }
+
+- (void)addName:(NSString *)aName jsonString:(NSString *)aJSON schema:(id)aSchema expectedResult:(id)aResult
+{
+	[self addTest:[TestSchemaDocument testSchemaDocumentWithName:aName jsonString:aJSON schema:aSchema expectedResult:aResult]];
+}
+
+- (void)willLoad
+{
+	NSDictionary		* thePerson = @{@"type":@"object",
+										@"required":@[@"name",@"age"],
+										@"additionalProperties":@NO,
+										@"properties":@{
+											@"name":@{@"type":@"string",@"minLength":@1,@"maxLength":@8},
+											@"age":@{@"type":@"integer",@"minimum":@0,@"maximum":@150},
+											@"role":@{@"enum":@[@"admin",@"user",[NSNull null]]},
+											@"tags":@{@"type":@"array",@"maxItems":@2,@"items":@{@"type":@"string"}}}};
+
+	[self addName:@"Valid" jsonString:@"{\"name\":\"Nathan\",\"age\":42,\"role\":\"admin\",\"tags\":[\"a\",\"b\"]}" schema:thePerson expectedResult:@{@"name":@"Nathan",@"age":@42,@"role":@"admin",@"tags":@[@"a",@"b"]}];
+	[self addName:@"Wrong Type" jsonString:@"{\"name\":7,\"age\":42}" schema:thePerson expectedResult:@"/name type"];
+	[self addName:@"Missing Required" jsonString:@"{\"name\":\"Nathan\"}" schema:thePerson expectedResult:@" required"];
+	[self addName:@"Additional Property" jsonString:@"{\"name\":\"Nathan\",\"age\":42,\"email\":\"x\"}" schema:thePerson expectedResult:@"/email additionalProperties"];
+	[self addName:@"Maximum" jsonString:@"{\"name\":\"Nathan\",\"age\":420}" schema:thePerson expectedResult:@"/age maximum"];
+	[self addName:@"Integer Type" jsonString:@"{\"name\":\"Nathan\",\"age\":4.5}" schema:thePerson expectedResult:@"/age type"];
+	[self addName:@"Enum" jsonString:@"{\"name\":\"Nathan\",\"age\":42,\"role\":\"root\"}" schema:thePerson expectedResult:@"/role enum"];
+	[self addName:@"Max Length" jsonString:@"{\"name\":\"Nathan Day\",\"age\":42}" schema:thePerson expectedResult:@"/name maxLength"];
+	[self addName:@"Max Items" jsonString:@"{\"name\":\"Nathan\",\"age\":42,\"tags\":[\"a\",\"b\",\"c\"]}" schema:thePerson expectedResult:@"/tags maxItems"];
+	[self addName:@"Array Item" jsonString:@"{\"name\":\"Nathan\",\"age\":42,\"tags\":[\"a\",true]}" schema:thePerson expectedResult:@"/tags/1 type"];
+	[self addName:@"Pointer Escaping" jsonString:@"[{\"a/b\":{\"c~d\":-1}}]" schema:@{@"items":@{@"properties":@{@"a/b":@{@"properties":@{@"c~d":@{@"exclusiveMinimum":@0}}}}}} expectedResult:@"/0/a~1b/c~0d exclusiveMinimum"];
+	[self addName:@"Unsupported Keyword" jsonString:@"{}" schema:@{@"anyOf":@[@{@"type":@"object"}]} expectedResult:@"anyOf"];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestSchemaDocument
+
+@synthesize		expectedResult,
+				jsonString,
+				schema;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nschema:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString, self.schema, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testSchemaDocumentWithName:(NSString *)aName jsonString:(NSString *)aJSON schema:(id)aSchema expectedResult:(id)aResult
+{
+	return [[self alloc] initWithName:aName jsonString:aJSON schema:aSchema expectedResult:aResult];
+}
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON schema:(id)aSchema expectedResult:(id)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		schema = aSchema;
+		expectedResult = aResult;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError					* theError = nil;
+	NDJSONSchema			* theSchema = [NDJSONSchema schemaWithJSONObject:self.schema error:&theError];
+	if( theSchema != nil )
+	{
+		NDJSONParser			* theJSON = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+		NDJSONDeserializer		* theJSONParser = [[NDJSONDeserializer alloc] init];
+		id						theResult = nil;
+		theJSONParser.schemaValidator = [[NDJSONSchemaValidator alloc] initWithSchema:theSchema];
+		theResult = [theJSONParser objectForJSON:theJSON options:NDJSONOptionNone error:&theError];
+		if( theResult != nil )
+			self.lastResult = theResult;
+		else if( [theError.domain isEqualToString:NDJSONSchemaErrorDomain] )
+			self.lastResult = [NSString stringWithFormat:@"%@ %@", [theError.userInfo objectForKey:NDJSONSchemaPointerErrorKey], [theError.userInfo objectForKey:NDJSONSchemaKeywordErrorKey]];
+		else
+			self.error = theError;
+	}
+	else if( theError.code == NDJSONSchemaUnsupportedKeywordError )
+		self.lastResult = [theError.userInfo objectForKey:NDJSONSchemaKeywordErrorKey];
+	else
+		self.error = theError;
+	return self.lastResult;
+}
+
+@end
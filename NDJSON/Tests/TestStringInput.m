@@ -29,6 +29,21 @@
 @property(readonly)			NDJSONOptionFlags	options;
 @end
 
+/*
+	parses each string in turn with the same parser and deserializer
+ */
+@interface TestReusedParser : TestProtocolBase
+{
+	NSArray						* jsonStrings;
+	id							expectedResult;
+}
++ (id)testReusedParserWithName:(NSString *)name jsonStrings:(NSArray *)jsons expectedResult:(id)expectedResult;
+- (id)initWithName:(NSString *)name jsonStrings:(NSArray *)jsons expectedResult:(id)result;
+
+@property(readonly)			NSArray				* jsonStrings;
+@property(readonly)			id					expectedResult;
+@end
+
 @implementation TestStringInput
 
 - (NSString *)testDescription { return @"Test input with string, all bytes are available, tests ability to recongnize all kinds of JSON"; }
@@ -81,10 +96,16 @@
 
 	[self addName:@"2 deep array within object" jsonString:@"[{\"a\":{\"b\":1},\"c\":2},3]" expectedResult:@[@{@"a":@{@"b":@1},@"c":@2},@3] options:NDJSONOptionNone];
 
+	[self addName:@"JSON Lines" jsonString:@"{\"a\":1}\n{\"a\":2,\"b\":[3]}\n[4]\n\"five\"\n" expectedResult:@[@{@"a":@1},@{@"a":@2,@"b":@[@3]},@[@4],@"five"] options:NDJSONOptionJSONLines];
+	[self addName:@"JSON Lines Single Value" jsonString:@"{\"a\":1}" expectedResult:@[@{@"a":@1}] options:NDJSONOptionJSONLines];
+	[self addName:@"JSON Lines Blank Lines" jsonString:@"\n1\n\n\t2 3\r\n" expectedResult:@[@1,@2,@3] options:NDJSONOptionJSONLines];
+	[self addName:@"JSON Lines Empty" jsonString:@"\n\n" expectedResult:@[] options:NDJSONOptionJSONLines];
+
 	[self addName:@"Comments single line" jsonString:@"//\ta\n[//\tbc\n1//\td\n,//\te\n{//ab\n\"two\"//cde\n://fghi\n2//jk\n}//\n,//\tf/gh\n\"three\"//\tij*klm\n//\tsecond in a row\n,//\top\n-4//\tqr\n,-5.5,true,false,null//\tstw\n]//\txyz\n" expectedResult:@[@1,@{@"two":@2},@"three",@-4,@-5.5,@YES,@NO,[NSNull null]] options:NDJSONOptionNone];
 	[self addName:@"Comments multi line" jsonString:@"/*\na\n*/[/*\nbc\n*/1/*\nd\n*/,/*\ne\n*/{/*ab*/\"two\"/*cde*/:/*fghi*/2/*jk*/}/**/,/*\nf/gh\n*/\"three\"/*\nij*klm\n*//*\nsecond in a row\n*/,/*\nop\n*/-4/*\nqr\n*/,-5.5,true,false,null/*\nstw\n*/]/*\nxyz\n*/" expectedResult:@[@1,@{@"two":@2},@"three",@-4,@-5.5,@YES,@NO,[NSNull null]] options:NDJSONOptionNone];
 	[self addName:@"UnBalanced Nested Object, Shallower End" jsonString:@"{\"one\":1,\"two\":2,\"three\":{\"four\":4}" expectedResult:@{@"one":@1,@"two":@2,@"three":@{@"four":@4}} options:NDJSONOptionNone];
 	[self addName:@"UnBalanced Nested Object, Deeper End" jsonString:@"{\"one\":1,\"two\":2},\"three\":3,\"four\":4}" expectedResult:@{@"one":@1,@"two":@2} options:NDJSONOptionNone];
+	[self addTest:[TestReusedParser testReusedParserWithName:@"Reused Parser" jsonStrings:@[@"{\"a\":1}",@"[1,[2,[3]]]",@"\"three\"",@"{\"a\":{\"b\":{\"c\":{\"d\":[4]}}}}",@"{\"a\":1"] expectedResult:@[@{@"a":@1},@[@1,@[@2,@[@3]]],@"three",@{@"a":@{@"b":@{@"c":@{@"d":@[@4]}}}},@{@"a":@1}]]];
 	[super willLoad];
 }
 
@@ -143,3 +164,56 @@
 
 @end
 
+@implementation TestReusedParser
+
+@synthesize		expectedResult,
+				jsonStrings;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonStrings, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testReusedParserWithName:(NSString *)aName jsonStrings:(NSArray *)aJSONs expectedResult:(id)aResult
+{
+	return [[self alloc] initWithName:aName jsonStrings:aJSONs expectedResult:aResult];
+}
+- (id)initWithName:(NSString *)aName jsonStrings:(NSArray *)aJSONs expectedResult:(id)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonStrings = [aJSONs copy];
+		expectedResult = aResult;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSMutableArray			* theResult = [NSMutableArray arrayWithCapacity:self.jsonStrings.count];
+	NDJSONParser			* theJSON = [[NDJSONParser alloc] init];
+	NDJSONDeserializer		* theJSONParser = [[NDJSONDeserializer alloc] init];
+	for( NSString * theString in self.jsonStrings )
+	{
+		NSError			* theError = nil;
+		id				theValue = nil;
+		if( theResult.count&1 )
+			[theJSON setJSONData:[theString dataUsingEncoding:NSUTF8StringEncoding] encoding:NSUTF8StringEncoding];
+		else
+			[theJSON setJSONString:theString];
+		theValue = [theJSONParser objectForJSON:theJSON options:NDJSONOptionNone error:&theError];
+		if( theError != nil )
+			self.error = theError;
+		[theResult addObject:theValue != nil ? theValue : [NSNull null]];
+	}
+	self.lastResult = theResult;
+	return self.lastResult;
+}
+
+@end
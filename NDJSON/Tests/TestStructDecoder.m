@@ -0,0 +1,253 @@
+//
+//  TestStructDecoder.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestStructDecoder.h"
+#import "NDJSONStructDecoder.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+
+struct TestPoint
+{
+	int32_t							x;
+	double							y;
+};
+
+struct TestRecord
+{
+	int64_t							identifier;
+	uint8_t							small;
+	uint64_t						total;
+	float							price;
+	BOOL							open;
+	char							symbol[8];
+	const char						* note;
+	struct TestPoint				origin;
+	struct NDJSONFieldArrayValue	values;
+	struct NDJSONFieldArrayValue	points;
+};
+
+static const struct NDJSONFieldDescriptor		kTestPointFields[] = {
+	NDJSONField(struct TestPoint, x, NDJSONFieldInteger),
+	NDJSONField(struct TestPoint, y, NDJSONFieldFloat)
+};
+static const struct NDJSONStructDescriptor		kTestPointDescriptor = NDJSONStructDescriptorInit(struct TestPoint, kTestPointFields);
+
+static const struct NDJSONFieldDescriptor		kTestRecordFields[] = {
+	NDJSONField(struct TestRecord, identifier, NDJSONFieldInteger),
+	NDJSONField(struct TestRecord, small, NDJSONFieldUnsigned),
+	NDJSONField(struct TestRecord, total, NDJSONFieldUnsigned),
+	NDJSONField(struct TestRecord, price, NDJSONFieldFloat),
+	NDJSONField(struct TestRecord, open, NDJSONFieldBool),
+	NDJSONField(struct TestRecord, symbol, NDJSONFieldString),
+	NDJSONField(struct TestRecord, note, NDJSONFieldStringPointer),
+	NDJSONObjectField(struct TestRecord, origin, &kTestPointDescriptor),
+	NDJSONArrayField(struct TestRecord, values, NDJSONFieldInteger, sizeof(int32_t), NULL),
+	NDJSONArrayField(struct TestRecord, points, NDJSONFieldObject, sizeof(struct TestPoint), &kTestPointDescriptor)
+};
+static const struct NDJSONStructDescriptor		kTestRecordDescriptor = NDJSONStructDescriptorInit(struct TestRecord, kTestRecordFields);
+
+static NSDictionary * TestPointDictionary( const struct TestPoint * aPoint )
+{
+	return @{@"x":@(aPoint->x),@"y":@(aPoint->y)};
+}
+
+/*
+	the members of the record that are not zero
+ */
+static NSDictionary * TestRecordDictionary( const struct TestRecord * aRecord )
+{
+	NSMutableDictionary		* theResult = [NSMutableDictionary dictionary];
+	if( aRecord->identifier != 0 )
+		theResult[@"identifier"] = @(aRecord->identifier);
+	if( aRecord->small != 0 )
+		theResult[@"small"] = @(aRecord->small);
+	if( aRecord->total != 0 )
+		theResult[@"total"] = @(aRecord->total);
+	if( aRecord->price != 0.0 )
+		theResult[@"price"] = @(aRecord->price);
+	if( aRecord->open )
+		theResult[@"open"] = @YES;
+	if( aRecord->symbol[0] != '\0' )
+		theResult[@"symbol"] = @(aRecord->symbol);
+	if( aRecord->note != NULL )
+		theResult[@"note"] = @(aRecord->note);
+	if( aRecord->origin.x != 0 || aRecord->origin.y != 0.0 )
+		theResult[@"origin"] = TestPointDictionary( &aRecord->origin );
+	if( aRecord->values.count > 0 )
+	{
+		NSMutableArray		* theValues = [NSMutableArray arrayWithCapacity:aRecord->values.count];
+		for( size_t i = 0; i < aRecord->values.count; i++ )
+			[theValues addObject:@(((int32_t *)aRecord->values.elements)[i])];
+		theResult[@"values"] = theValues;
+	}
+	if( aRecord->points.count > 0 )
+	{
+		NSMutableArray		* thePoints = [NSMutableArray arrayWithCapacity:aRecord->points.count];
+		for( size_t i = 0; i < aRecord->points.count; i++ )
+			[thePoints addObject:TestPointDictionary( &((struct TestPoint *)aRecord->points.elements)[i] )];
+		theResult[@"points"] = thePoints;
+	}
+	return theResult;
+}
+
+@interface TestStructDecoder ()
+- (void)addName:(NSString *)name jsonString:(NSString *)json options:(NDJSONOptionFlags)options expectedResult:(id)expectedResult;
+@end
+
+/*
+	decodes the json into a TestRecord, or with NDJSONOptionJSONLines each record, the result is the members of each record
+	that are not zero or the error code if decoding fails
+ */
+@interface TestStructDecoding : TestProtocolBase
+{
+	NSString					* jsonString;
+	NDJSONOptionFlags			options;
+	id							expectedResult;
+}
++ (id)testStructDecodingWithName:(NSString *)name jsonString:(NSString *)json options:(NDJSONOptionFlags)options expectedResult:(id)expectedResult;
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json options:(NDJSONOptionFlags)options expectedResult:(id)expectedResult;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			NDJSONOptionFlags	options;
+@property(readonly)			id					expectedResult;
+@end
+
+/*
+	decodes the json as UTF-8 data with NDJSONOptionJSONLines and statistics, the result is the records and the number of
+	strings the parser created, which should be none as the values of unknown keys are skipped and strings are sent as bytes
+ */
+@interface TestStructStringsCreated : TestStructDecoding
+@end
+
+@implementation TestStructDecoder
+
+- (NSString *)testDescription { return @"Test decoding JSON into C structs with field descriptors"; }
+
+- (void)addName:(NSString *)aName jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions expectedResult:(id)aResult
+{
+	[self addTest:[TestStructDecoding testStructDecodingWithName:aName jsonString:aJSON options:anOptions expectedResult:aResult]];
+}
+
+- (void)willLoad
+{
+	NSNumber		* theMismatch = @(NDJSONTypeMismatchError);
+	[self addName:@"Fields" jsonString:@"{\"identifier\":9000000000,\"small\":200,\"price\":2.5,\"open\":true,\"symbol\":\"ABC\",\"note\":\"a longer note than the symbol\"}" options:NDJSONOptionNone
+		expectedResult:@{@"identifier":@9000000000,@"small":@200,@"price":@2.5,@"open":@YES,@"symbol":@"ABC",@"note":@"a longer note than the symbol"}];
+	[self addName:@"Nested Struct and Arrays" jsonString:@"{\"origin\":{\"x\":-3,\"y\":4},\"values\":[1,2,3,4,5],\"points\":[{\"x\":1,\"y\":0.5},{\"y\":1.5,\"x\":2}]}" options:NDJSONOptionNone
+		expectedResult:@{@"origin":@{@"x":@-3,@"y":@4.0},@"values":@[@1,@2,@3,@4,@5],@"points":@[@{@"x":@1,@"y":@0.5},@{@"x":@2,@"y":@1.5}]}];
+	[self addName:@"Unknown Keys" jsonString:@"{\"extra\":{\"symbol\":\"XYZ\",\"list\":[1,\"a\",null]},\"identifier\":7,\"origin\":{\"z\":[true],\"x\":1}}" options:NDJSONOptionNone
+		expectedResult:@{@"identifier":@7,@"origin":@{@"x":@1,@"y":@0.0}}];
+	[self addName:@"Null and Missing" jsonString:@"{\"identifier\":null,\"symbol\":null,\"values\":[],\"price\":1}" options:NDJSONOptionNone
+		expectedResult:@{@"price":@1.0}];
+	[self addName:@"String Too Long" jsonString:@"{\"symbol\":\"ABCDEFGH\"}" options:NDJSONOptionNone expectedResult:theMismatch];
+	[self addName:@"Type Mismatch" jsonString:@"{\"identifier\":\"7\"}" options:NDJSONOptionNone expectedResult:theMismatch];
+	[self addName:@"Fraction for Integer" jsonString:@"{\"values\":[1,2.5]}" options:NDJSONOptionNone expectedResult:theMismatch];
+	[self addName:@"Integer Range" jsonString:@"{\"small\":256}" options:NDJSONOptionNone expectedResult:theMismatch];
+	[self addName:@"Negative Unsigned" jsonString:@"{\"small\":-1}" options:NDJSONOptionNone expectedResult:theMismatch];
+	[self addName:@"Unsigned Beyond Int64" jsonString:@"{\"total\":9223372036854775809}" options:NDJSONOptionNone expectedResult:@{@"total":@9223372036854775809ULL}];
+	[self addName:@"Unsigned Maximum" jsonString:@"{\"total\":18446744073709551615}" options:NDJSONOptionNone expectedResult:@{@"total":@18446744073709551615ULL}];
+	[self addName:@"Unsigned Exponent" jsonString:@"{\"total\":1.5e19}" options:NDJSONOptionNone expectedResult:theMismatch];
+	[self addName:@"Integral Float for Integer" jsonString:@"{\"identifier\":1e3}" options:NDJSONOptionNone expectedResult:@{@"identifier":@1000}];
+	[self addName:@"Unsigned Beyond UInt64" jsonString:@"{\"total\":18446744073709551616}" options:NDJSONOptionNone expectedResult:theMismatch];
+	[self addName:@"Integer Beyond Int64" jsonString:@"{\"identifier\":10000000000000000000}" options:NDJSONOptionNone expectedResult:theMismatch];
+	[self addName:@"JSON Lines" jsonString:@"{\"identifier\":1,\"note\":\"first\",\"values\":[1]}\n{\"identifier\":2,\"points\":[{\"x\":5}]}\n{\"identifier\":3}\n" options:NDJSONOptionJSONLines
+		expectedResult:@[@{@"identifier":@1,@"note":@"first",@"values":@[@1]},@{@"identifier":@2,@"points":@[@{@"x":@5,@"y":@0.0}]},@{@"identifier":@3}]];
+	[self addTest:[TestStructStringsCreated testStructDecodingWithName:@"No Strings Created" jsonString:@"{\"identifier\":1,\"extra\":\"skipped\",\"symbol\":\"ABC\",\"origin\":{\"z\":{\"a\":\"b\"},\"x\":2}}\n{\"unknown\":[\"c\",{\"d\":1}],\"identifier\":2,\"note\":\"second\"}\n" options:NDJSONOptionJSONLines
+		expectedResult:@{@"records":@[@{@"identifier":@1,@"symbol":@"ABC",@"origin":@{@"x":@2,@"y":@0.0}},@{@"identifier":@2,@"note":@"second"}],@"stringsCreated":@0}]];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestStructDecoding
+
+@synthesize		jsonString,
+				options,
+				expectedResult;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testStructDecodingWithName:(NSString *)aName jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions expectedResult:(id)aResult
+{
+	return [[self alloc] initWithName:aName jsonString:aJSON options:anOptions expectedResult:aResult];
+}
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON options:(NDJSONOptionFlags)anOptions expectedResult:(id)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		options = anOptions;
+		expectedResult = aResult;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError					* theError = nil;
+	NDJSONParser			* theParser = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+	NDJSONStructDecoder		* theDecoder = [[NDJSONStructDecoder alloc] initWithDescriptor:&kTestRecordDescriptor];
+	BOOL					theSucceeded = NO;
+	if( (self.options & NDJSONOptionJSONLines) != 0 )
+	{
+		NSMutableArray		* theRecords = [NSMutableArray array];
+		theSucceeded = [theDecoder decodeRecordsOfJSONParser:theParser options:self.options usingBlock:^(const void * aRecord, BOOL * aStop) {
+			[theRecords addObject:TestRecordDictionary( aRecord )];
+		} error:&theError];
+		self.lastResult = theRecords;
+	}
+	else
+	{
+		struct TestRecord	theRecord;
+		memset( &theRecord, 0xFF, sizeof(theRecord) );			// the decoder should zero it
+		theSucceeded = [theDecoder decodeJSONParser:theParser into:&theRecord options:self.options error:&theError];
+		if( theSucceeded )
+			self.lastResult = TestRecordDictionary( &theRecord );
+	}
+	if( !theSucceeded && theError != nil && [self.expectedResult isKindOfClass:[NSNumber class]] )
+	{
+		self.lastResult = @(theError.code);
+		theError = nil;
+	}
+	self.error = theError;
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestStructStringsCreated
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError					* theError = nil;
+	NDJSONParser			* theParser = [[NDJSONParser alloc] initWithJSONData:[self.jsonString dataUsingEncoding:NSUTF8StringEncoding] encoding:NSUTF8StringEncoding];
+	NDJSONStructDecoder		* theDecoder = [[NDJSONStructDecoder alloc] initWithDescriptor:&kTestRecordDescriptor];
+	NSMutableArray			* theRecords = [NSMutableArray array];
+	theParser.statistics = [[NDJSONParseStatistics alloc] init];
+	if( [theDecoder decodeRecordsOfJSONParser:theParser options:self.options usingBlock:^(const void * aRecord, BOOL * aStop) {
+			[theRecords addObject:TestRecordDictionary( aRecord )];
+		} error:&theError] )
+	{
+		self.lastResult = @{@"records":theRecords,@"stringsCreated":@(theParser.statistics.stringsCreated)};
+	}
+	self.error = theError;
+	return self.lastResult;
+}
+
+@end
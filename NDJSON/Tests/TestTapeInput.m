@@ -0,0 +1,208 @@
+//
+//  TestTapeInput.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestTapeInput.h"
+#import "NDJSONDeserializer.h"
+#import "NDJSONTapeParser.h"
+#import "TestProtocolBase.h"
+#import "NSObject+TestUtilities.h"
+
+@interface TestTapeInput ()
+- (void)addName:(NSString *)name jsonString:(NSString *)json expectedResult:(id)expectedResult options:(NDJSONOptionFlags)anOptions;
+@end
+
+/*
+	parses the json into a tape and deserializes the tape, with a file the tape is used the second time the file is loaded
+ */
+@interface TestTape : TestProtocolBase
+{
+	NSString					* jsonString;
+	id							expectedResult;
+	NDJSONOptionFlags			options;
+	BOOL						useFile;
+}
++ (id)testTapeWithName:(NSString *)name jsonString:(NSString *)json expectedResult:(id)expectedResult options:(NDJSONOptionFlags)options useFile:(BOOL)useFile;
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json expectedResult:(id)result options:(NDJSONOptionFlags)options useFile:(BOOL)useFile;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			id					expectedResult;
+@property(readonly)			NDJSONOptionFlags	options;
+@property(readonly)			BOOL				useFile;
+@end
+
+/*
+	writes the json to a file with its tape, then replaces it with changedJSON of the same length and modification date,
+	the result is whether the tape is current for other options and what the file deserializes to afterwards
+ */
+@interface TestTapeStale : TestProtocolBase
+{
+	NSString					* jsonString,
+								* changedJSONString;
+	id							expectedResult;
+}
+- (id)initWithName:(NSString *)name jsonString:(NSString *)json changedJSONString:(NSString *)changedJSON expectedResult:(id)result;
+
+@property(readonly)			NSString			* jsonString;
+@property(readonly)			NSString			* changedJSONString;
+@property(readonly)			id					expectedResult;
+@end
+
+@implementation TestTapeInput
+
+- (NSString *)testDescription { return @"Test replaying JSON that has been parsed into a binary tape"; }
+
+- (void)addName:(NSString *)aName jsonString:(NSString *)aJSON expectedResult:(id)aResult options:(NDJSONOptionFlags)anOptions
+{
+	[self addTest:[TestTape testTapeWithName:aName jsonString:aJSON expectedResult:aResult options:anOptions useFile:NO]];
+}
+
+- (void)willLoad
+{
+	[self addName:@"Scalar" jsonString:@"\"String Value\"" expectedResult:@"String Value" options:NDJSONOptionNone];
+	[self addName:@"Numbers" jsonString:@"[1,-2,3.5,-0.003,314159265358979e-14]" expectedResult:@[@1,@-2,@3.5,@-0.003,@3.14159265358979] options:NDJSONOptionNone];
+	[self addName:@"Literals" jsonString:@"[true,false,null]" expectedResult:@[@YES,@NO,[NSNull null]] options:NDJSONOptionNone];
+	[self addName:@"Nested" jsonString:@"{\"a\":{\"b\":[1,{\"c\":\"d\"}],\"e\":{}},\"f\":[]}" expectedResult:@{@"a":@{@"b":@[@1,@{@"c":@"d"}],@"e":@{}},@"f":@[]} options:NDJSONOptionNone];
+	[self addName:@"Repeated Keys" jsonString:@"[{\"name\":\"one\",\"value\":1},{\"name\":\"two\",\"value\":2},{\"name\":\"one\",\"value\":3}]" expectedResult:@[@{@"name":@"one",@"value":@1},@{@"name":@"two",@"value":@2},@{@"name":@"one",@"value":@3}] options:NDJSONOptionNone];
+	[self addName:@"Unicode" jsonString:@"{\"\\u00e9t\\u00e9\":\"\\ud83d\\ude00 caf\\u00e9\"}" expectedResult:@{@"été":@"\U0001F600 café"} options:NDJSONOptionNone];
+	[self addName:@"JSON Lines" jsonString:@"{\"a\":1}\n{\"a\":2}\n" expectedResult:@[@{@"a":@1},@{@"a":@2}] options:NDJSONOptionJSONLines];
+	[self addTest:[TestTape testTapeWithName:@"Tape File" jsonString:@"{\"catalog\":[{\"id\":1,\"title\":\"first\"},{\"id\":2,\"title\":\"second\"}]}" expectedResult:@{@"catalog":@[@{@"id":@1,@"title":@"first"},@{@"id":@2,@"title":@"second"}]} options:NDJSONOptionNone useFile:YES]];
+	[self addTest:[[TestTapeStale alloc] initWithName:@"Stale Tape File" jsonString:@"{\"id\":1,\"title\":\"first\"}" changedJSONString:@"{\"id\":2,\"title\":\"other\"}" expectedResult:@[@NO,@{@"id":@2,@"title":@"other"}]]];
+	[super willLoad];
+}
+
+@end
+
+@implementation TestTape
+
+@synthesize		expectedResult,
+				jsonString,
+				options,
+				useFile;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
++ (id)testTapeWithName:(NSString *)aName jsonString:(NSString *)aJSON expectedResult:(id)aResult options:(NDJSONOptionFlags)anOptions useFile:(BOOL)aUseFile
+{
+	return [[self alloc] initWithName:aName jsonString:aJSON expectedResult:aResult options:anOptions useFile:aUseFile];
+}
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON expectedResult:(id)aResult options:(NDJSONOptionFlags)anOptions useFile:(BOOL)aUseFile
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		expectedResult = aResult;
+		options = anOptions;
+		useFile = aUseFile;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError					* theError = nil;
+	NDJSONParser			* theJSON = nil;
+	NDJSONDeserializer		* theJSONParser = [[NDJSONDeserializer alloc] init];
+	if( self.useFile )
+	{
+		NSString		* thePath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"TestTapeInput.json"],
+						* theTapePath = [thePath stringByAppendingPathExtension:@"tape"];
+		[[NSFileManager defaultManager] removeItemAtPath:theTapePath error:NULL];
+		if( [self.jsonString writeToFile:thePath atomically:YES encoding:NSUTF8StringEncoding error:&theError] )
+		{
+			[NDJSONTapeParser parserWithContentsOfFile:thePath encoding:NSUTF8StringEncoding options:self.options tapeFile:theTapePath];
+			theJSON = [NDJSONTapeParser parserWithContentsOfFile:thePath encoding:NSUTF8StringEncoding options:self.options tapeFile:theTapePath];
+			if( ![theJSON isKindOfClass:[NDJSONTapeParser class]] || ![(NDJSONTapeParser*)theJSON isCurrentForContentsOfFile:thePath options:self.options verifyingHash:YES] )
+				theError = [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONGeneralError userInfo:@{NSLocalizedDescriptionKey:@"tape file was not used"}];
+		}
+	}
+	else
+	{
+		NDJSONParser	* theSource = [[NDJSONParser alloc] initWithJSONString:self.jsonString];
+		NSData			* theTape = [NDJSONTapeParser tapeDataForJSONParser:theSource options:self.options error:&theError];
+		if( theTape != nil )
+			theJSON = [[NDJSONTapeParser alloc] initWithTapeData:theTape error:&theError];
+	}
+	if( theJSON != nil && theError == nil )
+		self.lastResult = [theJSONParser objectForJSON:theJSON options:NDJSONOptionNone error:&theError];
+	self.error = theError;
+	return self.lastResult;
+}
+
+@end
+
+@implementation TestTapeStale
+
+@synthesize		jsonString,
+				changedJSONString,
+				expectedResult;
+
+#pragma mark - manually implemented properties
+
+- (NSString *)details
+{
+	return [NSString stringWithFormat:@"json:\n%@\n\nchanged json:\n%@\n\nresult:\n%@\n\nexpected result:\n%@\n\n", self.jsonString, self.changedJSONString, [self.lastResult detailedDescription], [self.expectedResult detailedDescription]];
+}
+
+#pragma mark - creation and destruction
+
+- (id)initWithName:(NSString *)aName jsonString:(NSString *)aJSON changedJSONString:(NSString *)aChangedJSON expectedResult:(id)aResult
+{
+	if( (self = [super initWithName:aName]) != nil )
+	{
+		jsonString = [aJSON copy];
+		changedJSONString = [aChangedJSON copy];
+		expectedResult = aResult;
+	}
+	return self;
+}
+
+#pragma mark - execution
+
+- (id)run
+{
+	NSError					* theError = nil;
+	NSFileManager			* theFileManager = [NSFileManager defaultManager];
+	NSString				* thePath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"TestTapeStale.json"],
+							* theTapePath = [thePath stringByAppendingPathExtension:@"tape"];
+	NDJSONDeserializer		* theJSONParser = [[NDJSONDeserializer alloc] init];
+	NSDate					* theModificationDate = nil;
+	BOOL					theCurrentForOtherOptions = NO;
+	id						theResult = nil;
+
+	[theFileManager removeItemAtPath:theTapePath error:NULL];
+	if( [self.jsonString writeToFile:thePath atomically:NO encoding:NSUTF8StringEncoding error:&theError] )
+	{
+		NDJSONParser	* theJSON = [NDJSONTapeParser parserWithContentsOfFile:thePath encoding:NSUTF8StringEncoding options:NDJSONOptionNone tapeFile:theTapePath];
+		if( [theJSON isKindOfClass:[NDJSONTapeParser class]] )
+			theCurrentForOtherOptions = [(NDJSONTapeParser*)theJSON isCurrentForContentsOfFile:thePath options:NDJSONOptionUseKeyTables verifyingHash:NO];
+		else
+			theError = [NSError errorWithDomain:NDJSONErrorDomain code:NDJSONGeneralError userInfo:@{NSLocalizedDescriptionKey:@"tape file was not written"}];
+		theModificationDate = [[theFileManager attributesOfItemAtPath:thePath error:&theError] fileModificationDate];
+	}
+	if( theError == nil && theModificationDate != nil
+		&& [self.changedJSONString writeToFile:thePath atomically:NO encoding:NSUTF8StringEncoding error:&theError]
+		&& [theFileManager setAttributes:@{NSFileModificationDate:theModificationDate} ofItemAtPath:thePath error:&theError] )
+	{
+		NDJSONParser	* theJSON = [NDJSONTapeParser parserWithContentsOfFile:thePath encoding:NSUTF8StringEncoding options:NDJSONOptionNone tapeFile:theTapePath];
+		theResult = [theJSONParser objectForJSON:theJSON options:NDJSONOptionNone error:&theError];
+	}
+	self.error = theError;
+	self.lastResult = theResult != nil ? @[@(theCurrentForOtherOptions),theResult] : nil;
+	return self.lastResult;
+}
+
+@end
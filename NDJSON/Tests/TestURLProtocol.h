@@ -0,0 +1,37 @@
+//
+//  TestURLProtocol.h
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+extern NSString		* const kTestURLProtocolScheme;
+
+/*
+	serves the bodies set with +setBody:... for URLs with the kTestURLProtocolScheme scheme, so NDJSONRequest can be tested
+	without a network. A request with an If-None-Match header matching the ETag of the body gets a 304 Not Modified
+	response, otherwise the body is sent chunkLength bytes at a time, chunkDelay seconds apart.
+ */
+@interface TestURLProtocol : NSURLProtocol
+
++ (void)setBody:(NSData *)body eTag:(NSString *)eTag chunkLength:(NSUInteger)chunkLength chunkDelay:(NSTimeInterval)chunkDelay forURL:(NSURL *)url;
+/*
+	forgets the body, the counts and the started URLs for every URL with the host
+ */
++ (void)removeHost:(NSString *)host;
+
++ (NSUInteger)requestCountForURL:(NSURL *)url;
++ (NSUInteger)notModifiedCountForURL:(NSURL *)url;
+/*
+	the most requests to the host that were loading at the same time
+ */
++ (NSUInteger)maximumConcurrentRequestsForHost:(NSString *)host;
+/*
+	the URLs of the host in the order they were started
+ */
++ (NSArray *)startedURLsForHost:(NSString *)host;
+
+@end
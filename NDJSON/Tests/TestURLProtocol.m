@@ -0,0 +1,218 @@
+//
+//  TestURLProtocol.m
+//  NDJSON
+//
+//  Created by the NDJSON contributors on 19/10/2026.
+//  Copyright (c) 2026 the NDJSON contributors. All rights reserved.
+//
+
+#import "TestURLProtocol.h"
+
+NSString		* const kTestURLProtocolScheme = @"ndjsontest";
+
+static NSMutableDictionary		* kBodies = nil;
+static NSCountedSet				* kRequestCounts = nil,
+								* kNotModifiedCounts = nil,
+								* kLoadingHosts = nil;
+static NSMutableDictionary		* kMaximumConcurrentRequests = nil;
+static NSMutableArray			* kStartedURLs = nil;
+
+@interface TestURLProtocol ()
+{
+	NSData				* body;
+	NSUInteger			offset,
+						chunkLength;
+	NSTimeInterval		chunkDelay;
+	NSString			* runLoopMode;
+	BOOL				loading;
+}
+- (void)sendNextChunk;
+- (void)finishLoading;
+@end
+
+@implementation TestURLProtocol
+
++ (void)initialize
+{
+	if( self == [TestURLProtocol class] )
+	{
+		kBodies = [[NSMutableDictionary alloc] init];
+		kRequestCounts = [[NSCountedSet alloc] init];
+		kNotModifiedCounts = [[NSCountedSet alloc] init];
+		kLoadingHosts = [[NSCountedSet alloc] init];
+		kMaximumConcurrentRequests = [[NSMutableDictionary alloc] init];
+		kStartedURLs = [[NSMutableArray alloc] init];
+		[NSURLProtocol registerClass:self];
+	}
+}
+
++ (void)setBody:(NSData *)aBody eTag:(NSString *)anETag chunkLength:(NSUInteger)aChunkLength chunkDelay:(NSTimeInterval)aChunkDelay forURL:(NSURL *)aURL
+{
+	NSMutableDictionary		* theEntry = [NSMutableDictionary dictionaryWithObjectsAndKeys:aBody, @"body", @(aChunkLength > 0 ? aChunkLength : aBody.length), @"chunkLength", @(aChunkDelay), @"chunkDelay", nil];
+	if( anETag != nil )
+		[theEntry setObject:anETag forKey:@"eTag"];
+	@synchronized(self)
+	{
+		[kBodies setObject:theEntry forKey:aURL.absoluteString];
+	}
+}
+
++ (void)removeHost:(NSString *)aHost
+{
+	@synchronized(self)
+	{
+		for( NSString * theURLString in [kBodies allKeys] )
+		{
+			if( [[NSURL URLWithString:theURLString].host isEqualToString:aHost] )
+			{
+				[kBodies removeObjectForKey:theURLString];
+				while( [kRequestCounts countForObject:theURLString] > 0 )
+					[kRequestCounts removeObject:theURLString];
+				while( [kNotModifiedCounts countForObject:theURLString] > 0 )
+					[kNotModifiedCounts removeObject:theURLString];
+			}
+		}
+		[kMaximumConcurrentRequests removeObjectForKey:aHost];
+		for( NSUInteger i = kStartedURLs.count; i > 0; i-- )
+		{
+			if( [((NSURL*)[kStartedURLs objectAtIndex:i-1]).host isEqualToString:aHost] )
+				[kStartedURLs removeObjectAtIndex:i-1];
+		}
+	}
+}
+
++ (NSUInteger)requestCountForURL:(NSURL *)aURL
+{
+	@synchronized(self)
+	{
+		return [kRequestCounts countForObject:aURL.absoluteString];
+	}
+}
+
++ (NSUInteger)notModifiedCountForURL:(NSURL *)aURL
+{
+	@synchronized(self)
+	{
+		return [kNotModifiedCounts countForObject:aURL.absoluteString];
+	}
+}
+
++ (NSUInteger)maximumConcurrentRequestsForHost:(NSString *)aHost
+{
+	@synchronized(self)
+	{
+		return [[kMaximumConcurrentRequests objectForKey:aHost] unsignedIntegerValue];
+	}
+}
+
++ (NSArray *)startedURLsForHost:(NSString *)aHost
+{
+	NSMutableArray		* theResult = [NSMutableArray array];
+	@synchronized(self)
+	{
+		for( NSURL * theURL in kStartedURLs )
+		{
+			if( [theURL.host isEqualToString:aHost] )
+				[theResult addObject:theURL];
+		}
+	}
+	return theResult;
+}
+
+#pragma mark - NSURLProtocol methods
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)aRequest { return [aRequest.URL.scheme isEqualToString:kTestURLProtocolScheme]; }
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)aRequest { return aRequest; }
+
+/*
+	the response is sent from the run loop of the thread the loading was started on
+ */
+- (void)startLoading
+{
+	NSURL				* theURL = self.request.URL;
+	NSString			* theHost = theURL.host;
+	NSDictionary		* theEntry = nil;
+	NSString			* theETag = nil;
+	NSInteger			theStatusCode = 404;
+	NSMutableDictionary	* theHeaders = [NSMutableDictionary dictionaryWithObject:@"application/json" forKey:@"Content-Type"];
+
+	@synchronized([TestURLProtocol class])
+	{
+		NSUInteger		theLoading = 0;
+		theEntry = [kBodies objectForKey:theURL.absoluteString];
+		[kRequestCounts addObject:theURL.absoluteString];
+		[kStartedURLs addObject:theURL];
+		[kLoadingHosts addObject:theHost];
+		theLoading = [kLoadingHosts countForObject:theHost];
+		if( theLoading > [[kMaximumConcurrentRequests objectForKey:theHost] unsignedIntegerValue] )
+			[kMaximumConcurrentRequests setObject:@(theLoading) forKey:theHost];
+		theETag = [theEntry objectForKey:@"eTag"];
+		if( theEntry != nil && theETag != nil && [[self.request valueForHTTPHeaderField:@"If-None-Match"] isEqualToString:theETag] )
+		{
+			[kNotModifiedCounts addObject:theURL.absoluteString];
+			theStatusCode = 304;
+		}
+		else if( theEntry != nil )
+			theStatusCode = 200;
+	}
+	loading = YES;
+	if( theETag != nil )
+		[theHeaders setObject:theETag forKey:@"ETag"];
+	[self.client URLProtocol:self didReceiveResponse:[[NSHTTPURLResponse alloc] initWithURL:theURL statusCode:theStatusCode HTTPVersion:@"HTTP/1.1" headerFields:theHeaders] cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+	if( theStatusCode == 200 )
+	{
+		body = [theEntry objectForKey:@"body"];
+		chunkLength = [[theEntry objectForKey:@"chunkLength"] unsignedIntegerValue];
+		chunkDelay = [[theEntry objectForKey:@"chunkDelay"] doubleValue];
+		runLoopMode = [[NSRunLoop currentRunLoop] currentMode];
+		if( runLoopMode == nil )
+			runLoopMode = NSDefaultRunLoopMode;
+		[self sendNextChunk];
+	}
+	else
+		[self finishLoading];
+}
+
+- (void)stopLoading
+{
+	[NSObject cancelPreviousPerformRequestsWithTarget:self];
+	if( loading )
+	{
+		loading = NO;
+		@synchronized([TestURLProtocol class])
+		{
+			[kLoadingHosts removeObject:self.request.URL.host];
+		}
+	}
+}
+
+- (void)sendNextChunk
+{
+	if( loading )
+	{
+		NSUInteger		theLength = MIN( chunkLength, body.length-offset );
+		if( theLength > 0 )
+			[self.client URLProtocol:self didLoadData:[body subdataWithRange:NSMakeRange(offset, theLength)]];
+		offset += theLength;
+		if( offset < body.length )
+			[self performSelector:@selector(sendNextChunk) withObject:nil afterDelay:chunkDelay inModes:@[runLoopMode]];
+		else
+			[self finishLoading];
+	}
+}
+
+- (void)finishLoading
+{
+	if( loading )
+	{
+		loading = NO;
+		@synchronized([TestURLProtocol class])
+		{
+			[kLoadingHosts removeObject:self.request.URL.host];
+		}
+		[self.client URLProtocolDidFinishLoading:self];
+	}
+}
+
+@end
@@ -0,0 +1,470 @@
+/*
+	NDJSONCodegen.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+//	Generates an NDJSONGeneratedDecoder for each of the given model classes, the classes are loaded from a bundle or
+//	library they have been compiled into and the answers NDJSONDeserializer would get from the Objective-C runtime and the
+//	NSObject+NDJSONDeserializer methods, including those implemented with the NDJSONPropertyNamesForKeys,
+//	NDJSONClassesForPropertyNames, NDJSONCollectionClassesForPropertyNames, NDJSONKeysIgnoreSet and NDJSONKeysConsiderSet
+//	macros, are written out as C functions.
+//
+//	usage:	ndjson-codegen [-c] [-i] [-o output] [-n name] [-h header ...] bundle-or-library class ...
+//
+//	-c and -i generate for NDJSONOptionConvertKeysToMedialCapitals and NDJSONOptionConvertRemoveIsAdjective, the decoders
+//	are only used when the deserializer options match. -n is the name of the class whose +load registers the decoders,
+//	-h adds an import of a model header to the generated file.
+//
+
+#import <Foundation/Foundation.h>
+#import <objc/runtime.h>
+#import "NDJSONDeserializer.h"
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static NSString * const		kDefaultRegistrationName = @"NDJSONGeneratedDecoders";
+
+/*
+	the cast of objc_msgSend and the NSNumber accessor used to set a property of each scalar type
+ */
+static const struct NDJSONCodegenScalarType
+{
+	char			encoding;
+	const char		* typeName,
+					* accessor;
+}		kScalarTypes[] = {
+	{ 'c', "char", "charValue" },
+	{ 'C', "unsigned char", "unsignedCharValue" },
+	{ 's', "short", "shortValue" },
+	{ 'S', "unsigned short", "unsignedShortValue" },
+	{ 'i', "int", "intValue" },
+	{ 'I', "unsigned int", "unsignedIntValue" },
+	{ 'l', "long", "longValue" },
+	{ 'L', "unsigned long", "unsignedLongValue" },
+	{ 'q', "long long", "longLongValue" },
+	{ 'Q', "unsigned long long", "unsignedLongLongValue" },
+	{ 'f', "float", "floatValue" },
+	{ 'd', "double", "doubleValue" },
+	{ 'B', "bool", "boolValue" }
+};
+
+#pragma mark - source text
+
+static NSString * NDJSONCodegenCString( NSString * aString )
+{
+	NSMutableString		* theResult = [NSMutableString stringWithString:@"\""];
+	const char			* theBytes = [aString UTF8String];
+	for( NSUInteger i = 0; theBytes[i] != '\0'; i++ )
+	{
+		unsigned char	theByte = (unsigned char)theBytes[i];
+		if( theByte == '"' || theByte == '\\' )
+			[theResult appendFormat:@"\\%c", theByte];
+		else if( theByte < 0x20 || theByte >= 0x7F )
+			[theResult appendFormat:@"\\%03o", theByte];
+		else
+			[theResult appendFormat:@"%c", theByte];
+	}
+	[theResult appendString:@"\""];
+	return theResult;
+}
+
+static NSString * NDJSONCodegenNSString( NSString * aString ) { return [@"@" stringByAppendingString:NDJSONCodegenCString(aString)]; }
+
+#pragma mark - introspection
+
+/*
+	the value of attribute in the comma separated property attributes, nil if the property does not have it
+ */
+static NSString * NDJSONCodegenAttribute( objc_property_t aProperty, char anAttribute )
+{
+	NSString	* theResult = nil;
+	for( NSString * theAttribute in [[NSString stringWithUTF8String:property_getAttributes(aProperty)] componentsSeparatedByString:@","] )
+	{
+		if( theAttribute.length > 0 && [theAttribute characterAtIndex:0] == (unichar)anAttribute )
+		{
+			theResult = [theAttribute substringFromIndex:1];
+			break;
+		}
+	}
+	return theResult;
+}
+
+/*
+	the class name of a property declared as a pointer to a class, nil for id, blocks and non object types
+ */
+static NSString * NDJSONCodegenPropertyClassName( objc_property_t aProperty )
+{
+	NSString	* theResult = nil;
+	NSString	* theType = aProperty != NULL ? NDJSONCodegenAttribute( aProperty, 'T' ) : nil;
+	if( [theType hasPrefix:@"@\""] && theType.length > 3 )
+	{
+		NSRange		theEnd = [theType rangeOfCharacterFromSet:[NSCharacterSet characterSetWithCharactersInString:@"\"<"] options:0 range:NSMakeRange(2, theType.length-2)];
+		if( theEnd.location != NSNotFound && theEnd.location > 2 )
+			theResult = [theType substringWithRange:NSMakeRange(2, theEnd.location-2)];
+	}
+	return theResult;
+}
+
+static const struct NDJSONCodegenScalarType * NDJSONCodegenScalarTypeForProperty( objc_property_t aProperty )
+{
+	const struct NDJSONCodegenScalarType	* theResult = NULL;
+	NSString								* theType = NDJSONCodegenAttribute( aProperty, 'T' );
+	if( theType.length == 1 )
+	{
+		for( NSUInteger i = 0; i < sizeof(kScalarTypes)/sizeof(*kScalarTypes) && theResult == NULL; i++ )
+		{
+			if( kScalarTypes[i].encoding == (char)[theType characterAtIndex:0] )
+				theResult = &kScalarTypes[i];
+		}
+	}
+	return theResult;
+}
+
+/*
+	the setter of a writable property the class implements, nil if the value has to be set with key value coding
+ */
+static NSString * NDJSONCodegenSetterName( Class aClass, NSString * aPropertyName, objc_property_t aProperty )
+{
+	NSString	* theResult = nil;
+	if( aProperty != NULL && NDJSONCodegenAttribute( aProperty, 'R' ) == nil )
+	{
+		theResult = NDJSONCodegenAttribute( aProperty, 'S' );
+		if( theResult == nil )
+			theResult = [NSString stringWithFormat:@"set%@%@:", [[aPropertyName substringToIndex:1] uppercaseString], [aPropertyName substringFromIndex:1]];
+		if( ![aClass instancesRespondToSelector:NSSelectorFromString(theResult)] )
+			theResult = nil;
+	}
+	return theResult;
+}
+
+/*
+	whether the class implements one of the set<Property>ByConverting<Type>: methods, values are then left to NDJSONDeserializer
+ */
+static BOOL NDJSONCodegenHasConversionMethods( Class aClass, NSString * aPropertyName )
+{
+	BOOL		theResult = NO;
+	NSString	* thePrefix = [NSString stringWithFormat:@"set%@%@ByConverting", [[aPropertyName substringToIndex:1] uppercaseString], [aPropertyName substringFromIndex:1]];
+	for( Class theClass = aClass; theClass != Nil && !theResult; theClass = class_getSuperclass(theClass) )
+	{
+		unsigned int	theCount = 0;
+		Method			* theMethods = class_copyMethodList( theClass, &theCount );
+		for( unsigned int i = 0; i < theCount && !theResult; i++ )
+			theResult = [NSStringFromSelector(method_getName(theMethods[i])) hasPrefix:thePrefix];
+		free( theMethods );
+	}
+	return theResult;
+}
+
+#pragma mark - generation
+
+/*
+	index of a class in the table of classes looked up by the generated code
+ */
+static NSUInteger NDJSONCodegenClassSlot( NSMutableArray * aClassNames, NSString * aClassName )
+{
+	NSUInteger		theResult = [aClassNames indexOfObject:aClassName];
+	if( theResult == NSNotFound )
+	{
+		theResult = aClassNames.count;
+		[aClassNames addObject:aClassName];
+	}
+	return theResult;
+}
+
+/*
+	writes the decoder for a class, the keys are the same, in the same order, as NDJSONDeserializer would put in a key table for the class
+ */
+static BOOL NDJSONCodegenWriteDecoder( NSMutableString * anOutput, NSMutableArray * aClassNames, Class aClass, NSUInteger aKeyOptions )
+{
+	NDJSONDeserializer		* theDeserializer = [[[NDJSONDeserializer alloc] init] autorelease];
+	NSString				* theName = NSStringFromClass(aClass);
+	NSMutableOrderedSet		* theKeys = [NSMutableOrderedSet orderedSet];
+	NSDictionary			* thePropertyNames = nil,
+							* theClasses = nil,
+							* theCollectionClasses = nil;
+	NSSet					* theIgnoreSet = nil,
+							* theConsiderSet = nil;
+	NSMutableArray			* thePropertyNamesForKeys = [NSMutableArray array];
+	NSMutableDictionary		* theKeysForLength = [NSMutableDictionary dictionary];
+	NSMutableString			* theSetValueCases = [NSMutableString string],
+							* theClassCases = [NSMutableString string],
+							* theCollectionClassCases = [NSMutableString string];
+
+	for( Class theClass = aClass; theClass != Nil && theClass != [NSObject class]; theClass = class_getSuperclass(theClass) )
+	{
+		unsigned int		theCount = 0;
+		objc_property_t		* theProperties = class_copyPropertyList( theClass, &theCount );
+		for( unsigned int i = 0; i < theCount; i++ )
+			[theKeys addObject:[NSString stringWithUTF8String:property_getName(theProperties[i])]];
+		free( theProperties );
+	}
+	if( [aClass respondsToSelector:@selector(propertyNamesWithJSONDeserializer:)] )
+	{
+		thePropertyNames = [aClass propertyNamesWithJSONDeserializer:theDeserializer];
+		[theKeys addObjectsFromArray:[thePropertyNames allKeys]];
+	}
+	if( [aClass respondsToSelector:@selector(keysIgnoreSetWithJSONDeserializer:)] )
+	{
+		theIgnoreSet = [aClass keysIgnoreSetWithJSONDeserializer:theDeserializer];
+		[theKeys addObjectsFromArray:[theIgnoreSet allObjects]];
+	}
+	else if( [aClass respondsToSelector:@selector(keysConsiderSetWithJSONDeserializer:)] )
+	{
+		theConsiderSet = [aClass keysConsiderSetWithJSONDeserializer:theDeserializer];
+		[theKeys addObjectsFromArray:[theConsiderSet allObjects]];
+	}
+	if( [aClass respondsToSelector:@selector(classesForPropertyNamesWithJSONDeserializer:)] )
+		theClasses = [aClass classesForPropertyNamesWithJSONDeserializer:theDeserializer];
+	if( [aClass respondsToSelector:@selector(collectionClassesForPropertyNamesWithJSONDeserializer:)] )
+		theCollectionClasses = [aClass collectionClassesForPropertyNamesWithJSONDeserializer:theDeserializer];
+
+	if( theKeys.count == 0 )
+	{
+		fprintf( stderr, "ndjson-codegen: %s has no properties\n", [theName UTF8String] );
+		return NO;
+	}
+
+	[anOutput appendFormat:@"#pragma mark - %@\n\n", theName];
+
+	[anOutput appendFormat:@"static NSString * const\t\tk%@Keys[] = {", theName];
+	for( NSUInteger i = 0; i < theKeys.count; i++ )
+	{
+		NSString	* theKey = [theKeys objectAtIndex:i],
+					* thePropertyName = [thePropertyNames objectForKey:theKey];
+		NSNumber	* theLength = [NSNumber numberWithUnsignedInteger:strlen([theKey UTF8String])];
+		if( thePropertyName == nil )
+			thePropertyName = NDJSONStringByConvertingPropertyName( theKey, (aKeyOptions&NDJSONOptionConvertRemoveIsAdjective) != 0, (aKeyOptions&NDJSONOptionConvertKeysToMedialCapitals) != 0 );
+		[thePropertyNamesForKeys addObject:thePropertyName];
+		if( [theKeysForLength objectForKey:theLength] == nil )
+			[theKeysForLength setObject:[NSMutableArray array] forKey:theLength];
+		[[theKeysForLength objectForKey:theLength] addObject:[NSNumber numberWithUnsignedInteger:i]];
+		[anOutput appendFormat:@"%@%@", i > 0 ? @", " : @" ", NDJSONCodegenNSString(theKey)];
+	}
+	[anOutput appendString:@" };\n"];
+
+	[anOutput appendFormat:@"static NSString * const\t\tk%@PropertyNames[] = {", theName];
+	for( NSUInteger i = 0; i < thePropertyNamesForKeys.count; i++ )
+		[anOutput appendFormat:@"%@%@", i > 0 ? @", " : @" ", NDJSONCodegenNSString([thePropertyNamesForKeys objectAtIndex:i])];
+	[anOutput appendString:@" };\n"];
+
+	[anOutput appendFormat:@"static const BOOL\t\t\t\tk%@SkipValues[] = {", theName];
+	for( NSUInteger i = 0; i < theKeys.count; i++ )
+	{
+		NSString	* theKey = [theKeys objectAtIndex:i];
+		BOOL		theSkip = theIgnoreSet != nil ? [theIgnoreSet containsObject:theKey] : (theConsiderSet != nil && ![theConsiderSet containsObject:theKey]);
+		[anOutput appendFormat:@"%@%@", i > 0 ? @", " : @" ", theSkip ? @"YES" : @"NO"];
+	}
+	[anOutput appendString:@" };\n\n"];
+
+	/*
+		the key is matched by its length and then its bytes
+	 */
+	[anOutput appendFormat:@"static NSUInteger NDJSON%@IndexForKey( const char * aKey, NSUInteger aLength )\n{\n\tswitch( aLength )\n\t{\n", theName];
+	for( NSNumber * theLength in [[theKeysForLength allKeys] sortedArrayUsingSelector:@selector(compare:)] )
+	{
+		[anOutput appendFormat:@"\tcase %@:\n", theLength];
+		for( NSNumber * theIndex in [theKeysForLength objectForKey:theLength] )
+			[anOutput appendFormat:@"\t\tif( memcmp( aKey, %@, %@ ) == 0 ) return %@;\n", NDJSONCodegenCString([theKeys objectAtIndex:theIndex.unsignedIntegerValue]), theLength, theIndex];
+		[anOutput appendString:@"\t\tbreak;\n"];
+	}
+	[anOutput appendString:@"\t}\n\treturn NSNotFound;\n}\n\n"];
+
+	for( NSUInteger i = 0; i < thePropertyNamesForKeys.count; i++ )
+	{
+		NSString								* thePropertyName = [thePropertyNamesForKeys objectAtIndex:i];
+		objc_property_t							theProperty = class_getProperty( aClass, [thePropertyName UTF8String] );
+		NSString								* theSetter = NDJSONCodegenSetterName( aClass, thePropertyName, theProperty ),
+												* thePropertyClassName = NDJSONCodegenPropertyClassName( theProperty ),
+												* theClassName = nil,
+												* theCollectionClassName = nil;
+		const struct NDJSONCodegenScalarType	* theScalarType = theProperty != NULL ? NDJSONCodegenScalarTypeForProperty( theProperty ) : NULL;
+
+		if( theSetter != nil && !NDJSONCodegenHasConversionMethods( aClass, thePropertyName ) )
+		{
+			if( thePropertyClassName != nil )
+			{
+				[theSetValueCases appendFormat:@"\tcase %lu:\n\t\tif( (theResult = [aValue isKindOfClass:NDJSONGeneratedClass( %lu, %@ )]) )\n", (unsigned long)i, (unsigned long)NDJSONCodegenClassSlot( aClassNames, thePropertyClassName ), NDJSONCodegenCString(thePropertyClassName)];
+				[theSetValueCases appendFormat:@"\t\t\t((void (*)(id, SEL, id))objc_msgSend)( anObject, @selector(%@), aValue );\n\t\tbreak;\n", theSetter];
+			}
+			else if( [NDJSONCodegenAttribute( theProperty, 'T' ) isEqualToString:@"@"] )
+			{
+				[theSetValueCases appendFormat:@"\tcase %lu:\n\t\t((void (*)(id, SEL, id))objc_msgSend)( anObject, @selector(%@), aValue );\n\t\ttheResult = YES;\n\t\tbreak;\n", (unsigned long)i, theSetter];
+			}
+			else if( theScalarType != NULL )
+			{
+				[theSetValueCases appendFormat:@"\tcase %lu:\n\t\tif( (theResult = [aValue isKindOfClass:[NSNumber class]]) )\n", (unsigned long)i];
+				[theSetValueCases appendFormat:@"\t\t\t((void (*)(id, SEL, %s))objc_msgSend)( anObject, @selector(%@), [aValue %s] );\n\t\tbreak;\n", theScalarType->typeName, theSetter, theScalarType->accessor];
+			}
+		}
+
+		theClassName = NSStringFromClass([theClasses objectForKey:thePropertyName]);
+		if( theClassName == nil )
+			theClassName = thePropertyClassName;
+		if( theClassName != nil )
+			[theClassCases appendFormat:@"\tcase %lu: return NDJSONGeneratedClass( %lu, %@ );\n", (unsigned long)i, (unsigned long)NDJSONCodegenClassSlot( aClassNames, theClassName ), NDJSONCodegenCString(theClassName)];
+
+		theCollectionClassName = NSStringFromClass([theCollectionClasses objectForKey:thePropertyName]);
+		if( theCollectionClassName == nil )
+			theCollectionClassName = thePropertyClassName;
+		if( theCollectionClassName != nil )
+			[theCollectionClassCases appendFormat:@"\tcase %lu: return NDJSONGeneratedClass( %lu, %@ );\n", (unsigned long)i, (unsigned long)NDJSONCodegenClassSlot( aClassNames, theCollectionClassName ), NDJSONCodegenCString(theCollectionClassName)];
+	}
+
+	[anOutput appendFormat:@"static BOOL NDJSON%@SetValue( id anObject, NSUInteger anIndex, id aValue )\n{\n\tBOOL\t\ttheResult = NO;\n", theName];
+	if( theSetValueCases.length > 0 )
+		[anOutput appendFormat:@"\tswitch( anIndex )\n\t{\n%@\t}\n", theSetValueCases];
+	[anOutput appendString:@"\treturn theResult;\n}\n\n"];
+
+	[anOutput appendFormat:@"static Class NDJSON%@ClassForIndex( NSUInteger anIndex )\n{\n", theName];
+	if( theClassCases.length > 0 )
+		[anOutput appendFormat:@"\tswitch( anIndex )\n\t{\n%@\t}\n", theClassCases];
+	[anOutput appendString:@"\treturn Nil;\n}\n\n"];
+
+	[anOutput appendFormat:@"static Class NDJSON%@CollectionClassForIndex( NSUInteger anIndex )\n{\n", theName];
+	if( theCollectionClassCases.length > 0 )
+		[anOutput appendFormat:@"\tswitch( anIndex )\n\t{\n%@\t}\n", theCollectionClassCases];
+	[anOutput appendString:@"\treturn Nil;\n}\n\n"];
+
+	[anOutput appendFormat:@"static const struct NDJSONGeneratedDecoder\tk%@Decoder = {\n", theName];
+	[anOutput appendFormat:@"\t%lu, k%@Keys, k%@PropertyNames, k%@SkipValues, %lu,\n", (unsigned long)theKeys.count, theName, theName, theName, (unsigned long)aKeyOptions];
+	[anOutput appendFormat:@"\tNDJSON%@IndexForKey, NDJSON%@SetValue, NDJSON%@ClassForIndex, NDJSON%@CollectionClassForIndex\n};\n\n", theName, theName, theName, theName];
+	return YES;
+}
+
+static BOOL NDJSONCodegenLoad( NSString * aPath )
+{
+	BOOL	theIsDirectory = NO,
+			theResult = NO;
+	if( [[NSFileManager defaultManager] fileExistsAtPath:aPath isDirectory:&theIsDirectory] )
+	{
+		if( theIsDirectory )
+			theResult = [[NSBundle bundleWithPath:aPath] load];
+		else if( dlopen( [aPath fileSystemRepresentation], RTLD_NOW|RTLD_GLOBAL ) != NULL )
+			theResult = YES;
+		else
+			fprintf( stderr, "ndjson-codegen: %s\n", dlerror() );
+	}
+	return theResult;
+}
+
+static void NDJSONCodegenUsage( void )
+{
+	fprintf( stderr, "usage: ndjson-codegen [-c] [-i] [-o output] [-n name] [-h header ...] bundle-or-library class ...\n" );
+	exit( 2 );
+}
+
+int main( int argc, char * argv[] )
+{
+	int		theStatus = 0;
+	@autoreleasepool
+	{
+		NSUInteger			theKeyOptions = 0;
+		NSString			* theOutputPath = nil,
+							* theRegistrationName = kDefaultRegistrationName;
+		NSMutableArray		* theHeaders = [NSMutableArray array],
+							* theClassNames = [NSMutableArray array],
+							* theGeneratedClasses = [NSMutableArray array];
+		NSMutableString		* theDecoders = [NSMutableString string],
+							* theOutput = [NSMutableString string];
+		int					theOption;
+
+		while( (theOption = getopt( argc, argv, "cio:n:h:" )) != -1 )
+		{
+			switch( theOption )
+			{
+			case 'c':
+				theKeyOptions |= NDJSONOptionConvertKeysToMedialCapitals;
+				break;
+			case 'i':
+				theKeyOptions |= NDJSONOptionConvertRemoveIsAdjective;
+				break;
+			case 'o':
+				theOutputPath = [NSString stringWithUTF8String:optarg];
+				break;
+			case 'n':
+				theRegistrationName = [NSString stringWithUTF8String:optarg];
+				break;
+			case 'h':
+				[theHeaders addObject:[NSString stringWithUTF8String:optarg]];
+				break;
+			default:
+				NDJSONCodegenUsage();
+				break;
+			}
+		}
+		if( argc - optind < 2 )
+			NDJSONCodegenUsage();
+
+		if( !NDJSONCodegenLoad( [NSString stringWithUTF8String:argv[optind]] ) )
+		{
+			fprintf( stderr, "ndjson-codegen: could not load %s\n", argv[optind] );
+			return 1;
+		}
+		for( int i = optind+1; i < argc; i++ )
+		{
+			Class		theClass = objc_getClass( argv[i] );
+			if( theClass == Nil )
+			{
+				fprintf( stderr, "ndjson-codegen: no class named %s\n", argv[i] );
+				theStatus = 1;
+			}
+			else if( NDJSONCodegenWriteDecoder( theDecoders, theClassNames, theClass, theKeyOptions ) )
+				[theGeneratedClasses addObject:NSStringFromClass(theClass)];
+			else
+				theStatus = 1;
+		}
+
+		[theOutput appendFormat:@"//\n//\t%@\n//\tgenerated by ndjson-codegen, do not edit\n//\n\n", theOutputPath != nil ? [theOutputPath lastPathComponent] : @"NDJSON generated decoders"];
+		[theOutput appendString:@"#import <Foundation/Foundation.h>\n#import <objc/runtime.h>\n#import <objc/message.h>\n#import \"NDJSONDeserializer.h\"\n"];
+		for( NSString * theHeader in theHeaders )
+			[theOutput appendFormat:@"#import \"%@\"\n", theHeader];
+		[theOutput appendString:@"#include <string.h>\n\n"];
+		if( theClassNames.count > 0 )
+		{
+			[theOutput appendFormat:@"static Class\t\tkGeneratedClasses[%lu];\n\n", (unsigned long)theClassNames.count];
+			[theOutput appendString:@"static Class NDJSONGeneratedClass( NSUInteger anIndex, const char * aName )\n{\n\tif( kGeneratedClasses[anIndex] == Nil )\n\t\tkGeneratedClasses[anIndex] = objc_getClass( aName );\n\treturn kGeneratedClasses[anIndex];\n}\n\n"];
+		}
+		[theOutput appendString:theDecoders];
+		[theOutput appendFormat:@"#pragma mark - registration\n\n@interface %@ : NSObject\n@end\n\n@implementation %@\n\n+ (void)load\n{\n", theRegistrationName, theRegistrationName];
+		for( NSString * theName in theGeneratedClasses )
+			[theOutput appendFormat:@"\tNDJSONRegisterGeneratedDecoder( objc_getClass( %@ ), &k%@Decoder );\n", NDJSONCodegenCString(theName), theName];
+		[theOutput appendString:@"}\n\n@end\n"];
+
+		if( theOutputPath != nil )
+		{
+			NSError		* theError = nil;
+			if( ![theOutput writeToFile:theOutputPath atomically:YES encoding:NSUTF8StringEncoding error:&theError] )
+			{
+				fprintf( stderr, "ndjson-codegen: %s\n", [[theError localizedDescription] UTF8String] );
+				theStatus = 1;
+			}
+		}
+		else
+			fputs( [theOutput UTF8String], stdout );
+	}
+	return theStatus;
+}
@@ -0,0 +1,847 @@
+/*
+	NDJSONTransform.m
+	NDJSON
+
+	Created by the NDJSON contributors on 19.10.26 under a MIT-style license.
+	Copyright (c) 2026 the NDJSON contributors
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in
+	all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+	THE SOFTWARE.
+ */
+
+//	Streams JSON Lines records from files or the standard input, either of which may be gzip compressed, keeps the
+//	records that pass every filter, projects the values given by path and writes the result as JSON Lines. Values that
+//	are not on the path of a projection or filter are skipped by NDJSONParser without being parsed.
+//
+//	usage:	ndjson-transform [-f filter ...] [-p path ...] [-r path=name ...] [-t threads] [-o output] [file ...]
+//
+//	paths are JSON Pointers (RFC 6901) in which the component * matches every member of an object or element of an
+//	array. -f keeps the records with a value on its path that satisfies a comparison, such as '/status == "paid"', with
+//	==, !=, <, <=, > or >= and a string, number, true, false or null. Paths and comparisons are compiled and evaluated
+//	as in the where clause of an NDJSONQuery, so integers are compared as integers. -p keeps only the values on the
+//	given paths, without it the whole record is kept, -r writes the member at path with a new name. With -t the input
+//	is split into chunks of whole lines that are transformed on that many threads, 0 for one per processor, the output
+//	is in the same order as the input. Files named - and no files at all read the standard input.
+//
+
+#import <Foundation/Foundation.h>
+#import "NDJSONParser.h"
+#import "NDJSONQueryPrivate.h"
+#include <dispatch/dispatch.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define kMaximumPathCount		64										// one bit per path in a uint64_t mask
+
+static const NSUInteger		kChunkSize = 4*1024*1024;				// bytes of input given to each parse
+
+enum NDJSONTransformPathKind
+{
+	NDJSONTransformProjection,
+	NDJSONTransformFilter,
+	NDJSONTransformRename
+};
+
+/*
+	the paths of every option, shared by all of the threads once parsed
+ */
+struct NDJSONTransformProgram
+{
+	NSUInteger						count;
+	struct NDJSONQueryPath			paths[kMaximumPathCount];
+	struct NDJSONQueryPredicate		filters[kMaximumPathCount];			// of the filter paths
+	char							* names[kMaximumPathCount];			// of the rename paths, as quoted JSON strings
+	uint64_t						projectionMask,
+									filterMask,
+									renameMask;
+};
+
+struct NDJSONTransformBuffer
+{
+	char							* bytes;
+	size_t							length,
+									size;
+};
+
+/*
+	an open container, its mask has a bit set for every path the container is on
+ */
+struct NDJSONTransformFrame
+{
+	uint64_t						mask;
+	NSUInteger						index,						// of the next element of an array
+									count;						// members or elements written
+	NSString						* key;
+	const char						* name;
+	BOOL							isObject,
+									included,					// within a projection, so everything in it is written
+									opened;						// the start of the container has been written
+};
+
+#pragma mark - buffers
+
+static void NDJSONTransformReserve( struct NDJSONTransformBuffer * aBuffer, size_t aLength )
+{
+	if( aBuffer->length + aLength > aBuffer->size )
+	{
+		aBuffer->size = MAX( aBuffer->size*2, aBuffer->length + aLength + 256 );
+		aBuffer->bytes = realloc( aBuffer->bytes, aBuffer->size );
+		NSCAssert( aBuffer->bytes != NULL, @"Malloc failure" );
+	}
+}
+
+static inline void NDJSONTransformAppend( struct NDJSONTransformBuffer * aBuffer, const char * aBytes, size_t aLength )
+{
+	NDJSONTransformReserve( aBuffer, aLength );
+	memcpy( aBuffer->bytes + aBuffer->length, aBytes, aLength );
+	aBuffer->length += aLength;
+}
+
+static inline void NDJSONTransformAppendChar( struct NDJSONTransformBuffer * aBuffer, char aChar )
+{
+	NDJSONTransformReserve( aBuffer, 1 );
+	aBuffer->bytes[aBuffer->length++] = aChar;
+}
+
+/*
+	aScratch holds the UTF-8 bytes of aString while they are escaped into aBuffer
+ */
+static void NDJSONTransformAppendString( struct NDJSONTransformBuffer * aBuffer, struct NDJSONTransformBuffer * aScratch, NSString * aString )
+{
+	static const char		kHexDigits[] = "0123456789abcdef";
+	NSUInteger				theLength = 0;
+	aScratch->length = 0;
+	NDJSONTransformReserve( aScratch, [aString maximumLengthOfBytesUsingEncoding:NSUTF8StringEncoding] );
+	[aString getBytes:aScratch->bytes maxLength:aScratch->size usedLength:&theLength encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, aString.length) remainingRange:NULL];
+
+	NDJSONTransformReserve( aBuffer, theLength+2 );
+	aBuffer->bytes[aBuffer->length++] = '"';
+	for( NSUInteger i = 0, theStart = 0; i <= theLength; i++ )
+	{
+		unsigned char	theChar = i < theLength ? (unsigned char)aScratch->bytes[i] : '\0';
+		if( i == theLength || theChar < 0x20 || theChar == '"' || theChar == '\\' )
+		{
+			NDJSONTransformAppend( aBuffer, aScratch->bytes + theStart, i - theStart );
+			theStart = i+1;
+			if( i < theLength )
+			{
+				char	theEscape[6] = { '\\', (char)theChar, 0, 0, 0, 0 };
+				size_t	theEscapeLength = 2;
+				switch( theChar )
+				{
+				case '"': case '\\':	break;
+				case '\n':				theEscape[1] = 'n'; break;
+				case '\r':				theEscape[1] = 'r'; break;
+				case '\t':				theEscape[1] = 't'; break;
+				case '\b':				theEscape[1] = 'b'; break;
+				case '\f':				theEscape[1] = 'f'; break;
+				default:
+					theEscape[1] = 'u';
+					theEscape[2] = '0';
+					theEscape[3] = '0';
+					theEscape[4] = kHexDigits[theChar >> 4];
+					theEscape[5] = kHexDigits[theChar & 0xF];
+					theEscapeLength = 6;
+					break;
+				}
+				NDJSONTransformAppend( aBuffer, theEscape, theEscapeLength );
+			}
+		}
+	}
+	NDJSONTransformAppendChar( aBuffer, '"' );
+}
+
+static void NDJSONTransformAppendValue( struct NDJSONTransformBuffer * aBuffer, struct NDJSONTransformBuffer * aScratch, const struct NDJSONQueryValue * aValue )
+{
+	char		theNumber[32];
+	switch( aValue->type )
+	{
+	case NDJSONQueryValueString:
+		NDJSONTransformAppendString( aBuffer, aScratch, aValue->string );
+		break;
+	case NDJSONQueryValueInteger:
+		NDJSONTransformAppend( aBuffer, theNumber, (size_t)snprintf( theNumber, sizeof(theNumber), "%lld", aValue->integer ) );
+		break;
+	case NDJSONQueryValueFloat:
+		if( !isfinite(aValue->real) )
+			NDJSONTransformAppend( aBuffer, "null", 4 );
+		else
+		{
+			int		theLength = snprintf( theNumber, sizeof(theNumber), "%.15g", aValue->real );
+			if( strtod( theNumber, NULL ) != aValue->real )					// the shortest form that reads back the same
+				theLength = snprintf( theNumber, sizeof(theNumber), "%.17g", aValue->real );
+			NDJSONTransformAppend( aBuffer, theNumber, (size_t)theLength );
+		}
+		break;
+	case NDJSONQueryValueBool:
+		if( aValue->boolean )
+			NDJSONTransformAppend( aBuffer, "true", 4 );
+		else
+			NDJSONTransformAppend( aBuffer, "false", 5 );
+		break;
+	case NDJSONQueryValueNull:
+	case NDJSONQueryValueContainer:
+		NDJSONTransformAppend( aBuffer, "null", 4 );
+		break;
+	}
+}
+
+#pragma mark - options
+
+static void NDJSONTransformUsage( void )
+{
+	fprintf( stderr, "usage: ndjson-transform [-f filter ...] [-p path ...] [-r path=name ...] [-t threads] [-o output] [file ...]\n" );
+	exit( 2 );
+}
+
+static BOOL NDJSONTransformAddPath( struct NDJSONTransformProgram * aProgram, enum NDJSONTransformPathKind aKind, NSString * aString, NSUInteger * anEnd )
+{
+	NSString		* theError = nil;
+	BOOL			theCompiled = NO;
+	if( aProgram->count >= kMaximumPathCount )
+	{
+		fprintf( stderr, "ndjson-transform: more than %lu paths\n", (unsigned long)kMaximumPathCount );
+		return NO;
+	}
+	if( aKind == NDJSONTransformFilter )
+		theCompiled = NDJSONQueryCompilePredicate( &aProgram->paths[aProgram->count], &aProgram->filters[aProgram->count], aString, &theError );
+	else
+		theCompiled = NDJSONQueryCompilePath( &aProgram->paths[aProgram->count], aString, anEnd, &theError );
+	if( !theCompiled )
+	{
+		fprintf( stderr, "ndjson-transform: bad %s '%s', %s\n", aKind == NDJSONTransformFilter ? "filter" : "path", [aString UTF8String], [theError UTF8String] );
+		return NO;
+	}
+	switch( aKind )
+	{
+	case NDJSONTransformProjection:		aProgram->projectionMask |= 1ULL << aProgram->count; break;
+	case NDJSONTransformFilter:			aProgram->filterMask |= 1ULL << aProgram->count; break;
+	case NDJSONTransformRename:			aProgram->renameMask |= 1ULL << aProgram->count; break;
+	}
+	aProgram->count++;
+	return YES;
+}
+
+static BOOL NDJSONTransformAddProjection( struct NDJSONTransformProgram * aProgram, const char * aProjection )
+{
+	NSString		* theString = [NSString stringWithUTF8String:aProjection];
+	NSUInteger		theEnd = 0;
+	if( !NDJSONTransformAddPath( aProgram, NDJSONTransformProjection, theString, &theEnd ) )
+		return NO;
+	if( theEnd != theString.length )
+	{
+		fprintf( stderr, "ndjson-transform: bad path '%s'\n", aProjection );
+		return NO;
+	}
+	return YES;
+}
+
+static BOOL NDJSONTransformAddRename( struct NDJSONTransformProgram * aProgram, const char * aRename )
+{
+	NSString						* theString = [NSString stringWithUTF8String:aRename];
+	NSUInteger						theEnd = 0;
+	struct NDJSONTransformBuffer	theName = { NULL, 0, 0 },
+									theScratch = { NULL, 0, 0 };
+	if( !NDJSONTransformAddPath( aProgram, NDJSONTransformRename, theString, &theEnd ) )
+		return NO;
+	if( aProgram->paths[aProgram->count-1].length == 0 || theEnd >= theString.length || [theString characterAtIndex:theEnd] != '=' )
+	{
+		fprintf( stderr, "ndjson-transform: bad rename '%s', expected path=name\n", aRename );
+		return NO;
+	}
+	NDJSONTransformAppendString( &theName, &theScratch, [theString substringFromIndex:theEnd+1] );
+	NDJSONTransformAppendChar( &theName, '\0' );
+	aProgram->names[aProgram->count-1] = theName.bytes;
+	free( theScratch.bytes );
+	return YES;
+}
+
+#pragma mark - NDJSONTransformer
+
+/*
+	writes the records of one chunk of input to its output, the top level array NDJSONOptionJSONLines reports is frame 0
+	and each record is frame 1, a frame at index i is on paths of length i-1. The containers that lead to a projection
+	are only written once something within them is.
+ */
+@interface NDJSONTransformer : NSObject <NDJSONParserDelegate>
+{
+	const struct NDJSONTransformProgram		* _program;
+	struct NDJSONTransformBuffer			* _output,
+											_record,
+											_scratch;
+	struct NDJSONTransformFrame				* _frames;
+	NSUInteger								_frameCount,
+											_frameSize,
+											_openedCount;
+	struct
+	{
+		uint64_t								mask;
+		NSString								* key;
+		const char								* name;
+		BOOL									included;
+	}										_next;								// the value about to be parsed
+	uint64_t								_satisfied;							// the filters the current record has passed
+	NSError									* _error;
+}
+- (id)initWithProgram:(const struct NDJSONTransformProgram *)program output:(struct NDJSONTransformBuffer *)output;
+@property(readonly,nonatomic)	NSError		* error;
+@end
+
+/*
+	works out the paths of the next value in the container on top of the stack
+ */
+static void NDJSONTransformerNext( NDJSONTransformer * self, NSString * aKey )
+{
+	const struct NDJSONTransformProgram		* theProgram = self->_program;
+	NSUInteger								theLength = self->_frameCount-1;		// of the paths of the next value
+	if( theLength == 0 )															// a new record
+	{
+		self->_next.mask = theProgram->count < 64 ? (1ULL << theProgram->count)-1 : ~0ULL;
+		self->_next.included = theProgram->projectionMask == 0 || NDJSONQueryEndMask( theProgram->paths, theProgram->projectionMask, 0 ) != 0;
+		self->_satisfied = 0;
+		self->_record.length = 0;
+	}
+	else
+	{
+		struct NDJSONTransformFrame		* theParent = &self->_frames[theLength];
+		self->_next.mask = NDJSONQueryChildMask( theProgram->paths, theParent->mask, theLength-1, aKey, theParent->index );
+		self->_next.included = theParent->included || NDJSONQueryEndMask( theProgram->paths, self->_next.mask & theProgram->projectionMask, theLength ) != 0;
+	}
+	self->_next.key = aKey;
+	self->_next.name = NULL;
+	if( aKey != nil && (self->_next.mask & theProgram->renameMask) != 0 )
+	{
+		uint64_t	theRenames = NDJSONQueryEndMask( theProgram->paths, self->_next.mask & theProgram->renameMask, theLength );
+		if( theRenames != 0 )
+			self->_next.name = theProgram->names[__builtin_ctzll(theRenames)];
+	}
+}
+
+/*
+	the paths of an array element are only known when it starts
+ */
+static void NDJSONTransformerBeginValue( NDJSONTransformer * self )
+{
+	if( self->_frameCount == 1 )
+		NDJSONTransformerNext( self, nil );
+	else if( !self->_frames[self->_frameCount-1].isObject )
+	{
+		NDJSONTransformerNext( self, nil );
+		self->_frames[self->_frameCount-1].index++;
+	}
+}
+
+/*
+	the separator and key before a value in aParent
+ */
+static void NDJSONTransformerWritePrefix( NDJSONTransformer * self, struct NDJSONTransformFrame * aParent, NSString * aKey, const char * aName )
+{
+	if( aParent->count > 0 )
+		NDJSONTransformAppendChar( &self->_record, ',' );
+	if( aParent->isObject )
+	{
+		if( aName != NULL )
+			NDJSONTransformAppend( &self->_record, aName, strlen(aName) );
+		else
+			NDJSONTransformAppendString( &self->_record, &self->_scratch, aKey );
+		NDJSONTransformAppendChar( &self->_record, ':' );
+	}
+	aParent->count++;
+}
+
+/*
+	writes the start of every container on the stack that has not been written yet
+ */
+static void NDJSONTransformerOpenFrames( NDJSONTransformer * self )
+{
+	for( NSUInteger i = self->_openedCount; i < self->_frameCount; i++ )
+	{
+		struct NDJSONTransformFrame		* theFrame = &self->_frames[i];
+		if( i > 1 )
+			NDJSONTransformerWritePrefix( self, &self->_frames[i-1], theFrame->key, theFrame->name );
+		NDJSONTransformAppendChar( &self->_record, theFrame->isObject ? '{' : '[' );
+		theFrame->opened = YES;
+	}
+	self->_openedCount = self->_frameCount;
+}
+
+static void NDJSONTransformerEndRecord( NDJSONTransformer * self )
+{
+	if( (self->_satisfied & self->_program->filterMask) == self->_program->filterMask && self->_record.length > 0 )
+	{
+		NDJSONTransformAppend( self->_output, self->_record.bytes, self->_record.length );
+		NDJSONTransformAppendChar( self->_output, '\n' );
+	}
+	self->_record.length = 0;
+}
+
+static void NDJSONTransformerFoundValue( NDJSONTransformer * self, const struct NDJSONQueryValue * aValue )
+{
+	const struct NDJSONTransformProgram		* theProgram = self->_program;
+	NSUInteger								theLength = self->_frameCount-1;
+	uint64_t								theFilters = 0;
+	NDJSONTransformerBeginValue( self );
+	theFilters = self->_next.mask & theProgram->filterMask;
+	if( theFilters != 0 )
+	{
+		for( uint64_t theBits = NDJSONQueryEndMask( theProgram->paths, theFilters, theLength ); theBits != 0; theBits &= theBits-1 )
+		{
+			unsigned int	i = (unsigned int)__builtin_ctzll( theBits );
+			if( NDJSONQueryCompare( aValue, &theProgram->filters[i] ) )
+				self->_satisfied |= 1ULL << i;
+		}
+	}
+	if( self->_next.included )
+	{
+		NDJSONTransformerOpenFrames( self );
+		if( theLength > 0 )
+			NDJSONTransformerWritePrefix( self, &self->_frames[theLength], self->_next.key, self->_next.name );
+		NDJSONTransformAppendValue( &self->_record, &self->_scratch, aValue );
+	}
+	if( theLength == 0 )
+		NDJSONTransformerEndRecord( self );
+}
+
+static void NDJSONTransformerStartContainer( NDJSONTransformer * self, BOOL anIsObject )
+{
+	struct NDJSONTransformFrame		* theFrame = NULL;
+	if( self->_frameCount > 0 )
+		NDJSONTransformerBeginValue( self );
+	if( self->_frameCount >= self->_frameSize )
+	{
+		self->_frameSize = self->_frameSize > 0 ? self->_frameSize*2 : 32;
+		self->_frames = realloc( self->_frames, self->_frameSize*sizeof(struct NDJSONTransformFrame) );
+		NSCAssert( self->_frames != NULL, @"Malloc failure" );
+	}
+	theFrame = &self->_frames[self->_frameCount];
+	memset( theFrame, 0, sizeof(*theFrame) );
+	theFrame->isObject = anIsObject;
+	if( self->_frameCount == 0 )								// the top level array of NDJSONOptionJSONLines
+	{
+		theFrame->opened = YES;
+		self->_frameCount = self->_openedCount = 1;
+		return;
+	}
+	theFrame->mask = self->_next.mask;
+	theFrame->included = self->_next.included;
+	theFrame->key = [self->_next.key retain];
+	theFrame->name = self->_next.name;
+	self->_frameCount++;
+	if( self->_frameCount == 2 || theFrame->included )			// records are always written, even if nothing in them is
+		NDJSONTransformerOpenFrames( self );
+}
+
+static void NDJSONTransformerEndContainer( NDJSONTransformer * self )
+{
+	struct NDJSONTransformFrame		* theFrame = NULL;
+	if( self->_frameCount == 0 )
+		return;
+	theFrame = &self->_frames[--self->_frameCount];
+	if( theFrame->opened && self->_frameCount > 0 )
+		NDJSONTransformAppendChar( &self->_record, theFrame->isObject ? '}' : ']' );
+	if( self->_openedCount > self->_frameCount )
+		self->_openedCount = self->_frameCount;
+	[theFrame->key release], theFrame->key = nil;
+	if( self->_frameCount == 1 )
+		NDJSONTransformerEndRecord( self );
+}
+
+@implementation NDJSONTransformer
+
+@synthesize		error = _error;
+
+- (id)initWithProgram:(const struct NDJSONTransformProgram *)aProgram output:(struct NDJSONTransformBuffer *)anOutput
+{
+	if( (self = [super init]) != nil )
+	{
+		_program = aProgram;
+		_output = anOutput;
+	}
+	return self;
+}
+
+- (void)dealloc
+{
+	for( NSUInteger i = 0; i < _frameCount; i++ )
+		[_frames[i].key release];
+	free( _frames );
+	free( _record.bytes );
+	free( _scratch.bytes );
+	[_error release];
+	[super dealloc];
+}
+
+#pragma mark - NDJSONParserDelegate methods
+
+- (void)jsonParserDidStartArray:(NDJSONParser *)aParser { NDJSONTransformerStartContainer( self, NO ); }
+- (void)jsonParserDidEndArray:(NDJSONParser *)aParser { NDJSONTransformerEndContainer( self ); }
+- (void)jsonParserDidStartObject:(NDJSONParser *)aParser { NDJSONTransformerStartContainer( self, YES ); }
+- (void)jsonParserDidEndObject:(NDJSONParser *)aParser { NDJSONTransformerEndContainer( self ); }
+
+- (void)jsonParser:(NDJSONParser *)aParser foundKey:(NSString *)aKey { NDJSONTransformerNext( self, aKey ); }
+
+/*
+	values that are not on a path are only needed when the whole container they are in is being written
+ */
+- (BOOL)jsonParser:(NDJSONParser *)aParser shouldSkipValueForKey:(NSString *)aKey
+{
+	return !_next.included && (_next.mask & (_program->projectionMask|_program->filterMask)) == 0;
+}
+
+- (void)jsonParser:(NDJSONParser *)aParser foundString:(NSString *)aValue
+{
+	struct NDJSONQueryValue		theValue = { NDJSONQueryValueString, NO, 0, 0.0, aValue };
+	NDJSONTransformerFoundValue( self, &theValue );
+}
+- (void)jsonParser:(NDJSONParser *)aParser foundInteger:(NSInteger)aValue
+{
+	struct NDJSONQueryValue		theValue = { NDJSONQueryValueInteger, NO, (long long)aValue, 0.0, nil };
+	NDJSONTransformerFoundValue( self, &theValue );
+}
+- (void)jsonParser:(NDJSONParser *)aParser foundFloat:(double)aValue
+{
+	struct NDJSONQueryValue		theValue = { NDJSONQueryValueFloat, NO, 0, aValue, nil };
+	NDJSONTransformerFoundValue( self, &theValue );
+}
+- (void)jsonParser:(NDJSONParser *)aParser foundBool:(BOOL)aValue
+{
+	struct NDJSONQueryValue		theValue = { NDJSONQueryValueBool, aValue, 0, 0.0, nil };
+	NDJSONTransformerFoundValue( self, &theValue );
+}
+- (void)jsonParserFoundNULL:(NDJSONParser *)aParser
+{
+	struct NDJSONQueryValue		theValue = { NDJSONQueryValueNull, NO, 0, 0.0, nil };
+	NDJSONTransformerFoundValue( self, &theValue );
+}
+
+- (void)jsonParser:(NDJSONParser *)aParser error:(NSError *)anError
+{
+	if( _error == nil )
+		_error = [anError retain];
+}
+
+@end
+
+#pragma mark - input
+
+/*
+	the input files are read one after another, gzread reads compressed and uncompressed files alike
+ */
+struct NDJSONTransformInput
+{
+	char							** paths;
+	NSUInteger						count,
+									next;
+	gzFile							file;
+	const char						* currentPath;
+	NSMutableData					* remainder;				// bytes after the last new line of the previous chunk
+	BOOL							failed;
+};
+
+static BOOL NDJSONTransformOpenNext( struct NDJSONTransformInput * anInput )
+{
+	while( anInput->file == NULL && anInput->next < MAX(anInput->count, 1) )
+	{
+		const char		* thePath = anInput->count > 0 ? anInput->paths[anInput->next] : "-";
+		anInput->next++;
+		anInput->currentPath = thePath;
+		anInput->file = strcmp( thePath, "-" ) == 0 ? gzdopen( dup(STDIN_FILENO), "rb" ) : gzopen( thePath, "rb" );
+		if( anInput->file == NULL )
+		{
+			fprintf( stderr, "ndjson-transform: could not open %s\n", thePath );
+			anInput->failed = YES;
+			return NO;
+		}
+		gzbuffer( anInput->file, 256*1024 );
+	}
+	return anInput->file != NULL;
+}
+
+/*
+	the next run of whole lines of at least kChunkSize bytes, or all that is left, nil at the end of the input
+ */
+static NSData * NDJSONTransformNextChunk( struct NDJSONTransformInput * anInput )
+{
+	NSMutableData		* theResult = [NSMutableData dataWithCapacity:kChunkSize + anInput->remainder.length];
+	NSUInteger			theWanted = kChunkSize;
+	[theResult appendData:anInput->remainder];
+	[anInput->remainder setLength:0];
+	for( ;; )
+	{
+		while( theResult.length < theWanted && NDJSONTransformOpenNext( anInput ) )
+		{
+			NSUInteger		theLength = theResult.length;
+			int				theRead = 0;
+			[theResult setLength:theWanted];
+			theRead = gzread( anInput->file, (uint8_t*)theResult.mutableBytes + theLength, (unsigned int)(theWanted - theLength) );
+			[theResult setLength:theLength + (NSUInteger)MAX(theRead, 0)];
+			if( theRead <= 0 )
+			{
+				if( theRead < 0 )
+				{
+					int		theErrorNumber = 0;
+					fprintf( stderr, "ndjson-transform: could not read %s: %s\n", anInput->currentPath, gzerror( anInput->file, &theErrorNumber ) );
+					anInput->failed = YES;
+				}
+				gzclose( anInput->file );
+				anInput->file = NULL;
+				if( theResult.length > 0 && ((const char*)theResult.bytes)[theResult.length-1] != '\n' )
+					[theResult appendBytes:"\n" length:1];					// the last line of a file without a new line
+				if( anInput->failed )
+					return nil;
+			}
+		}
+		if( anInput->failed )
+			return nil;
+		if( theResult.length == 0 )
+			return nil;
+		else
+		{
+			const char		* theBytes = theResult.bytes;
+			NSUInteger		theEnd = theResult.length;
+			while( theEnd > 0 && theBytes[theEnd-1] != '\n' )
+				theEnd--;
+			if( theEnd > 0 )
+			{
+				[anInput->remainder appendBytes:theBytes + theEnd length:theResult.length - theEnd];
+				[theResult setLength:theEnd];
+				return theResult;
+			}
+			if( anInput->file == NULL && anInput->next >= MAX(anInput->count, 1) )
+				return theResult;
+			theWanted = theResult.length*2;										// a line longer than a chunk
+		}
+	}
+}
+
+#pragma mark - transforming chunks
+
+struct NDJSONTransformChunk
+{
+	NSData							* input;
+	NSUInteger						firstLine;
+	struct NDJSONTransformBuffer	output;
+	NSString						* error;
+	dispatch_semaphore_t			done;
+	BOOL							inUse;
+};
+
+static void NDJSONTransformChunkRun( const struct NDJSONTransformProgram * aProgram, struct NDJSONTransformChunk * aChunk )
+{
+	@autoreleasepool
+	{
+		NDJSONParser		* theParser = [[NDJSONParser alloc] initWithJSONData:aChunk->input encoding:NSUTF8StringEncoding];
+		NDJSONTransformer	* theTransformer = [[NDJSONTransformer alloc] initWithProgram:aProgram output:&aChunk->output];
+		theParser.delegate = theTransformer;
+		if( ![theParser parseWithOptions:NDJSONOptionJSONLines] || theTransformer.error != nil )
+		{
+			NSString	* theDescription = theTransformer.error != nil ? theTransformer.error.localizedDescription : @"could not parse";
+			aChunk->error = [[NSString alloc] initWithFormat:@"line %lu: %@", (unsigned long)(aChunk->firstLine + theParser.lineNumber - 1), theDescription];
+		}
+		[theTransformer release];
+		[theParser release];
+	}
+}
+
+static BOOL NDJSONTransformWrite( int aFileDescriptor, const char * aBytes, size_t aLength )
+{
+	while( aLength > 0 )
+	{
+		ssize_t		theWritten = write( aFileDescriptor, aBytes, aLength );
+		if( theWritten < 0 )
+		{
+			if( errno == EINTR )
+				continue;
+			perror( "ndjson-transform: could not write" );
+			return NO;
+		}
+		aBytes += theWritten;
+		aLength -= (size_t)theWritten;
+	}
+	return YES;
+}
+
+/*
+	writes the output of a finished chunk, returns NO if it or an earlier chunk failed
+ */
+static BOOL NDJSONTransformFinishChunk( struct NDJSONTransformChunk * aChunk, int anOutput, BOOL aFailed )
+{
+	dispatch_semaphore_wait( aChunk->done, DISPATCH_TIME_FOREVER );
+	if( !aFailed )
+	{
+		if( !NDJSONTransformWrite( anOutput, aChunk->output.bytes, aChunk->output.length ) )
+			aFailed = YES;
+		else if( aChunk->error != nil )
+		{
+			fprintf( stderr, "ndjson-transform: %s\n", [aChunk->error UTF8String] );
+			aFailed = YES;
+		}
+	}
+	[aChunk->input release], aChunk->input = nil;
+	[aChunk->error release], aChunk->error = nil;
+	aChunk->output.length = 0;
+	aChunk->inUse = NO;
+	return !aFailed;
+}
+
+int main( int argc, char * argv[] )
+{
+	int		theStatus = 0;
+	@autoreleasepool
+	{
+		static struct NDJSONTransformProgram	theProgram;
+		static const struct option				kLongOptions[] = {
+			{ "filter", required_argument, NULL, 'f' },
+			{ "project", required_argument, NULL, 'p' },
+			{ "rename", required_argument, NULL, 'r' },
+			{ "threads", required_argument, NULL, 't' },
+			{ "output", required_argument, NULL, 'o' },
+			{ NULL, 0, NULL, 0 }
+		};
+		struct NDJSONTransformInput		theInput;
+		struct NDJSONTransformChunk		* theChunks = NULL;
+		NSUInteger						theThreadCount = 1,
+										theChunkCount = 0,
+										theLine = 1;
+		const char						* theOutputPath = NULL;
+		int								theOutput = STDOUT_FILENO,
+										theOption;
+		BOOL							theFailed = NO;
+		dispatch_queue_t				theQueue = dispatch_get_global_queue( DISPATCH_QUEUE_PRIORITY_DEFAULT, 0 );
+
+		while( (theOption = getopt_long( argc, argv, "f:p:r:t:o:", kLongOptions, NULL )) != -1 )
+		{
+			switch( theOption )
+			{
+			case 'f':
+				if( !NDJSONTransformAddPath( &theProgram, NDJSONTransformFilter, [NSString stringWithUTF8String:optarg], NULL ) )
+					return 2;
+				break;
+			case 'p':
+				if( !NDJSONTransformAddProjection( &theProgram, optarg ) )
+					return 2;
+				break;
+			case 'r':
+				if( !NDJSONTransformAddRename( &theProgram, optarg ) )
+					return 2;
+				break;
+			case 't':
+			{
+				char		* theEnd = NULL;
+				errno = 0;
+				theThreadCount = (NSUInteger)strtoul( optarg, &theEnd, 10 );
+				if( optarg[0] < '0' || optarg[0] > '9' || *theEnd != '\0' || errno == ERANGE )
+				{
+					fprintf( stderr, "ndjson-transform: bad thread count '%s', expected a number, 0 for one thread per processor\n", optarg );
+					return 2;
+				}
+				if( theThreadCount == 0 )
+					theThreadCount = [[NSProcessInfo processInfo] activeProcessorCount];
+				break;
+			}
+			case 'o':
+				theOutputPath = optarg;
+				break;
+			default:
+				NDJSONTransformUsage();
+				break;
+			}
+		}
+
+		if( theOutputPath != NULL && (theOutput = open( theOutputPath, O_WRONLY|O_CREAT|O_TRUNC, 0666 )) < 0 )
+		{
+			fprintf( stderr, "ndjson-transform: could not create %s\n", theOutputPath );
+			return 1;
+		}
+
+		memset( &theInput, 0, sizeof(theInput) );
+		theInput.paths = argv + optind;
+		theInput.count = (NSUInteger)(argc - optind);
+		theInput.remainder = [NSMutableData data];
+
+		/*
+			a ring of twice as many chunks as threads, so the next chunks are read while the oldest is waited for
+		 */
+		theChunkCount = theThreadCount > 1 ? theThreadCount*2 : 1;
+		theChunks = calloc( theChunkCount, sizeof(struct NDJSONTransformChunk) );
+		for( NSUInteger i = 0; i < theChunkCount; i++ )
+			theChunks[i].done = dispatch_semaphore_create( 0 );
+
+		for( NSUInteger i = 0; ; i++ )
+		{
+			struct NDJSONTransformChunk		* theChunk = &theChunks[i % theChunkCount];
+			NSData							* theData = nil;
+			if( theChunk->inUse && !NDJSONTransformFinishChunk( theChunk, theOutput, theFailed ) )
+				theFailed = YES;
+			@autoreleasepool
+			{
+				if( !theFailed )
+					theData = [NDJSONTransformNextChunk( &theInput ) retain];
+			}
+			if( theData == nil )
+			{
+				for( NSUInteger j = 1; j < theChunkCount; j++ )				// the chunks still being transformed, oldest first
+				{
+					struct NDJSONTransformChunk		* theRemaining = &theChunks[(i+j) % theChunkCount];
+					if( theRemaining->inUse && !NDJSONTransformFinishChunk( theRemaining, theOutput, theFailed ) )
+						theFailed = YES;
+				}
+				break;
+			}
+			theChunk->input = theData;
+			theChunk->firstLine = theLine;
+			theChunk->inUse = YES;
+			for( const char * theBytes = theData.bytes, * theEnd = theBytes + theData.length; (theBytes = memchr( theBytes, '\n', (size_t)(theEnd - theBytes) )) != NULL; theBytes++ )
+				theLine++;
+			if( theThreadCount > 1 )
+			{
+				dispatch_async( theQueue, ^{
+					NDJSONTransformChunkRun( &theProgram, theChunk );
+					dispatch_semaphore_signal( theChunk->done );
+				});
+			}
+			else
+			{
+				NDJSONTransformChunkRun( &theProgram, theChunk );
+				dispatch_semaphore_signal( theChunk->done );
+			}
+		}
+		if( theInput.failed )
+			theFailed = YES;
+
+		for( NSUInteger i = 0; i < theChunkCount; i++ )
+		{
+			free( theChunks[i].output.bytes );
+			dispatch_release( theChunks[i].done );
+		}
+		free( theChunks );
+		if( theInput.file != NULL )
+			gzclose( theInput.file );
+		if( theOutput != STDOUT_FILENO && close( theOutput ) != 0 )
+			theFailed = YES;
+		theStatus = theFailed ? 1 : 0;
+	}
+	return theStatus;
+}